@@ -490,6 +490,7 @@ static status_t runEncoder(const sp<MediaCodec>& encoder,
         AMediaMuxer *muxer, FILE* rawFp, const sp<IBinder>& display,
         const sp<IBinder>& virtualDpy, ui::Rotation orientation) {
     static int kTimeout = 250000;   // be responsive on signal
+    static const int64_t kOrientationPollNsec = milliseconds_to_nanoseconds(500);
     status_t err;
     ssize_t trackIdx = -1;
     ssize_t metaLegacyTrackIdx = -1;
@@ -497,6 +498,7 @@ static status_t runEncoder(const sp<MediaCodec>& encoder,
     uint32_t debugNumFrames = 0;
     int64_t startWhenNsec = systemTime(CLOCK_MONOTONIC);
     int64_t endWhenNsec = startWhenNsec + seconds_to_nanoseconds(gTimeLimitSec);
+    int64_t nextOrientationCheckNsec = startWhenNsec + kOrientationPollNsec;
     Vector<int64_t> timestampsMonotonicUs;
     bool firstFrame = true;
 
@@ -547,12 +549,18 @@ static status_t runEncoder(const sp<MediaCodec>& encoder,
                 ALOGV("Got data in buffer %zu, size=%zu, pts=%" PRId64,
                         bufIndex, size, ptsUsec);
 
-                { // scope
+                int64_t nowNsec = systemTime(CLOCK_MONOTONIC);
+                if (nowNsec >= nextOrientationCheckNsec) { // scope
                     ATRACE_NAME("orientation");
                     // Check orientation, update if it has changed.
                     //
                     // Polling for changes is inefficient and wrong, but the
                     // useful stuff is hard to get at without a Dalvik VM.
+                    // Checking on every encoded frame costs a binder round
+                    // trip per frame at full frame rate, so space the polls
+                    // out; a rotation picked up a few frames late is not
+                    // noticeable.
+                    nextOrientationCheckNsec = nowNsec + kOrientationPollNsec;
                     ui::DisplayState displayState;
                     err = SurfaceComposerClient::getDisplayState(display, &displayState);
                     if (err != NO_ERROR) {
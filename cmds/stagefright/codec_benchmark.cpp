@@ -0,0 +1,654 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "codec_benchmark"
+#include <inttypes.h>
+#include <sys/resource.h>
+#include <utils/Log.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <binder/ProcessState.h>
+#include <media/MediaCodecBuffer.h>
+#include <media/stagefright/foundation/ABuffer.h>
+#include <media/stagefright/foundation/ADebug.h>
+#include <media/stagefright/foundation/AHandler.h>
+#include <media/stagefright/foundation/ALooper.h>
+#include <media/stagefright/foundation/AMessage.h>
+#include <media/stagefright/foundation/AString.h>
+#include <media/stagefright/MediaCodec.h>
+#include <media/stagefright/MediaCodecConstants.h>
+#include <media/stagefright/MediaDefs.h>
+#include <media/stagefright/NuMediaExtractor.h>
+
+static void usage(const char *me) {
+    fprintf(stderr, "usage: %s [options] [input_filename]\n", me);
+    fprintf(stderr, "benchmarks MediaCodec and reports per-frame latency and throughput\n");
+    fprintf(stderr, "       -s scenario: decode (default, needs input file) or encode\n");
+    fprintf(stderr, "       -A drive the codec in asynchronous (callback) mode\n");
+    fprintf(stderr, "       -a benchmark the audio track instead of the video track\n");
+    fprintf(stderr, "       -m mime type to encode (default: %s)\n",
+            android::MEDIA_MIMETYPE_VIDEO_AVC);
+    fprintf(stderr, "       -w warmup frames excluded from the statistics (default: 30)\n");
+    fprintf(stderr, "       -n max number of frames to process (default: all; 600 for encode)\n");
+    fprintf(stderr, "       -W -H frame size for encode (default: 1280x720)\n");
+    fprintf(stderr, "       -b bitrate in bps for encode (default: 8000000)\n");
+    fprintf(stderr, "       -f report format: csv (default) or json\n");
+    fprintf(stderr, "       -o write the report to a file instead of stdout\n");
+    fprintf(stderr, "       -l label recorded in the report (default: scenario name)\n");
+    exit(1);
+}
+
+namespace android {
+
+static const int64_t kDequeueTimeoutUs = 500ll;
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Supplies compressed samples (decode) or synthetic raw frames (encode) to
+// the codec under test.
+struct InputSource : public RefBase {
+    // Fills |buffer| with the next frame. Returns true while frames remain;
+    // when it returns false the caller must queue an empty EOS buffer.
+    virtual bool fill(const sp<MediaCodecBuffer> &buffer, int64_t *timeUs) = 0;
+
+    // Format to configure the codec with.
+    virtual sp<AMessage> getFormat() = 0;
+
+  protected:
+    virtual ~InputSource() {}
+};
+
+struct ExtractorSource : public InputSource {
+    ExtractorSource(const sp<NuMediaExtractor> &extractor, const sp<AMessage> &format,
+            int64_t maxFrames)
+        : mExtractor(extractor), mFormat(format), mFramesLeft(maxFrames) {}
+
+    virtual bool fill(const sp<MediaCodecBuffer> &buffer, int64_t *timeUs) {
+        if (mFramesLeft == 0) {
+            return false;
+        }
+        size_t trackIndex;
+        if (mExtractor->getSampleTrackIndex(&trackIndex) != OK) {
+            return false;  // input EOS
+        }
+        sp<ABuffer> abuffer = new ABuffer(buffer->base(), buffer->capacity());
+        CHECK_EQ(mExtractor->readSampleData(abuffer), (status_t)OK);
+        buffer->setRange(abuffer->offset(), abuffer->size());
+        CHECK_EQ(mExtractor->getSampleTime(timeUs), (status_t)OK);
+        mExtractor->advance();
+        if (mFramesLeft > 0) {
+            --mFramesLeft;
+        }
+        return true;
+    }
+
+    virtual sp<AMessage> getFormat() { return mFormat; }
+
+  private:
+    sp<NuMediaExtractor> mExtractor;
+    sp<AMessage> mFormat;
+    int64_t mFramesLeft;
+};
+
+struct SyntheticYuvSource : public InputSource {
+    SyntheticYuvSource(const char *mime, int32_t width, int32_t height,
+            int32_t bitRate, int32_t frameRate, int64_t numFrames)
+        : mMime(mime), mWidth(width), mHeight(height), mBitRate(bitRate),
+          mFrameRate(frameRate), mFramesLeft(numFrames), mFrameIndex(0) {}
+
+    virtual bool fill(const sp<MediaCodecBuffer> &buffer, int64_t *timeUs) {
+        if (mFramesLeft == 0) {
+            return false;
+        }
+        --mFramesLeft;
+        size_t size = (size_t)mWidth * mHeight * 3 / 2;
+        CHECK_LE(size, buffer->capacity());
+        // A fill value that changes per frame keeps the encoder from
+        // collapsing every frame into a skip while staying cheap to generate.
+        memset(buffer->base(), (mFrameIndex * 8) & 0xff, size);
+        buffer->setRange(0, size);
+        *timeUs = mFrameIndex * 1000000ll / mFrameRate;
+        ++mFrameIndex;
+        return true;
+    }
+
+    virtual sp<AMessage> getFormat() {
+        sp<AMessage> format = new AMessage;
+        format->setString(KEY_MIME, mMime.c_str());
+        format->setInt32(KEY_WIDTH, mWidth);
+        format->setInt32(KEY_HEIGHT, mHeight);
+        format->setInt32(KEY_BIT_RATE, mBitRate);
+        format->setFloat(KEY_FRAME_RATE, mFrameRate);
+        format->setInt32(KEY_I_FRAME_INTERVAL, 1);
+        format->setInt32(KEY_COLOR_FORMAT, COLOR_FormatYUV420Flexible);
+        return format;
+    }
+
+  private:
+    std::string mMime;
+    int32_t mWidth, mHeight, mBitRate, mFrameRate;
+    int64_t mFramesLeft;
+    int64_t mFrameIndex;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Per-frame latency from queueInputBuffer to dequeueOutputBuffer, matched by
+// presentation timestamp, with the first |warmupFrames| outputs discarded.
+struct LatencyTracker {
+    explicit LatencyTracker(int64_t warmupFrames) : mWarmupLeft(warmupFrames) {}
+
+    void recordQueued(int64_t ptsUs) {
+        mQueuedAtUs[ptsUs] = ALooper::GetNowUs();
+    }
+
+    void recordOutput(int64_t ptsUs) {
+        auto it = mQueuedAtUs.find(ptsUs);
+        if (it == mQueuedAtUs.end()) {
+            return;  // codec-generated timestamp (e.g. CSD); ignore
+        }
+        int64_t latencyUs = ALooper::GetNowUs() - it->second;
+        mQueuedAtUs.erase(it);
+        if (mWarmupLeft > 0) {
+            --mWarmupLeft;
+            return;
+        }
+        mLatenciesUs.push_back(latencyUs);
+    }
+
+    std::map<int64_t, int64_t> mQueuedAtUs;
+    std::vector<int64_t> mLatenciesUs;
+    int64_t mWarmupLeft;
+};
+
+struct Result {
+    std::string label;
+    std::string scenario;
+    std::string mode;
+    std::string mime;
+    int64_t frames = 0;
+    int64_t bytes = 0;
+    int64_t elapsedUs = 0;
+    std::vector<int64_t> latenciesUs;  // sorted
+    int64_t cpuUserUs = 0;
+    int64_t cpuSystemUs = 0;
+    long peakRssKb = 0;
+};
+
+static int64_t percentileUs(const std::vector<int64_t> &sorted, int p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t idx = (size_t)(sorted.size() * p / 100);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+static int64_t timevalToUs(const struct timeval &tv) {
+    return tv.tv_sec * 1000000ll + tv.tv_usec;
+}
+
+static void writeReport(FILE *out, bool json, const Result &r) {
+    double fps = r.elapsedUs > 0 ? r.frames * 1E6 / r.elapsedUs : 0;
+    int64_t meanUs = 0;
+    for (int64_t l : r.latenciesUs) {
+        meanUs += l;
+    }
+    if (!r.latenciesUs.empty()) {
+        meanUs /= (int64_t)r.latenciesUs.size();
+    }
+    int64_t minUs = r.latenciesUs.empty() ? 0 : r.latenciesUs.front();
+    int64_t maxUs = r.latenciesUs.empty() ? 0 : r.latenciesUs.back();
+
+    if (json) {
+        fprintf(out,
+                "{\"label\":\"%s\",\"scenario\":\"%s\",\"mode\":\"%s\",\"mime\":\"%s\","
+                "\"frames\":%" PRId64 ",\"bytes\":%" PRId64 ",\"elapsed_ms\":%.3f,"
+                "\"fps\":%.2f,\"latency_mean_us\":%" PRId64 ",\"latency_min_us\":%" PRId64 ","
+                "\"latency_p50_us\":%" PRId64 ",\"latency_p90_us\":%" PRId64 ","
+                "\"latency_p95_us\":%" PRId64 ",\"latency_p99_us\":%" PRId64 ","
+                "\"latency_max_us\":%" PRId64 ",\"cpu_user_ms\":%.1f,\"cpu_system_ms\":%.1f,"
+                "\"peak_rss_kb\":%ld}\n",
+                r.label.c_str(), r.scenario.c_str(), r.mode.c_str(), r.mime.c_str(),
+                r.frames, r.bytes, r.elapsedUs / 1E3,
+                fps, meanUs, minUs,
+                percentileUs(r.latenciesUs, 50), percentileUs(r.latenciesUs, 90),
+                percentileUs(r.latenciesUs, 95), percentileUs(r.latenciesUs, 99),
+                maxUs, r.cpuUserUs / 1E3, r.cpuSystemUs / 1E3,
+                r.peakRssKb);
+    } else {
+        fprintf(out,
+                "label,scenario,mode,mime,frames,bytes,elapsed_ms,fps,"
+                "latency_mean_us,latency_min_us,latency_p50_us,latency_p90_us,"
+                "latency_p95_us,latency_p99_us,latency_max_us,"
+                "cpu_user_ms,cpu_system_ms,peak_rss_kb\n");
+        fprintf(out,
+                "%s,%s,%s,%s,%" PRId64 ",%" PRId64 ",%.3f,%.2f,"
+                "%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ","
+                "%" PRId64 ",%" PRId64 ",%" PRId64 ",%.1f,%.1f,%ld\n",
+                r.label.c_str(), r.scenario.c_str(), r.mode.c_str(), r.mime.c_str(),
+                r.frames, r.bytes, r.elapsedUs / 1E3, fps,
+                meanUs, minUs, percentileUs(r.latenciesUs, 50), percentileUs(r.latenciesUs, 90),
+                percentileUs(r.latenciesUs, 95), percentileUs(r.latenciesUs, 99), maxUs,
+                r.cpuUserUs / 1E3, r.cpuSystemUs / 1E3, r.peakRssKb);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Synchronous (polling) drive loop, in the shape of codec.cpp's decode loop.
+static status_t runSync(
+        const sp<MediaCodec> &codec, const sp<InputSource> &source,
+        LatencyTracker *tracker, Result *result) {
+    Vector<sp<MediaCodecBuffer> > inBuffers, outBuffers;
+    CHECK_EQ((status_t)OK, codec->getInputBuffers(&inBuffers));
+    CHECK_EQ((status_t)OK, codec->getOutputBuffers(&outBuffers));
+
+    bool signalledInputEOS = false;
+    bool sawOutputEOS = false;
+    while (!sawOutputEOS) {
+        if (!signalledInputEOS) {
+            size_t index;
+            status_t err = codec->dequeueInputBuffer(&index, kDequeueTimeoutUs);
+            if (err == OK) {
+                const sp<MediaCodecBuffer> &buffer = inBuffers.itemAt(index);
+                int64_t timeUs = 0;
+                if (source->fill(buffer, &timeUs)) {
+                    tracker->recordQueued(timeUs);
+                    CHECK_EQ((status_t)OK, codec->queueInputBuffer(
+                            index, 0 /* offset */, buffer->size(), timeUs, 0 /* flags */));
+                } else {
+                    CHECK_EQ((status_t)OK, codec->queueInputBuffer(
+                            index, 0 /* offset */, 0 /* size */, 0ll /* timeUs */,
+                            MediaCodec::BUFFER_FLAG_EOS));
+                    signalledInputEOS = true;
+                }
+            } else {
+                CHECK_EQ(err, -EAGAIN);
+            }
+        }
+
+        size_t index, offset, size;
+        int64_t presentationTimeUs;
+        uint32_t flags;
+        status_t err = codec->dequeueOutputBuffer(
+                &index, &offset, &size, &presentationTimeUs, &flags, kDequeueTimeoutUs);
+        if (err == OK) {
+            if (size != 0 && !(flags & MediaCodec::BUFFER_FLAG_CODECCONFIG)) {
+                tracker->recordOutput(presentationTimeUs);
+                ++result->frames;
+                result->bytes += size;
+            }
+            CHECK_EQ((status_t)OK, codec->releaseOutputBuffer(index));
+            if (flags & MediaCodec::BUFFER_FLAG_EOS) {
+                sawOutputEOS = true;
+            }
+        } else if (err == INFO_OUTPUT_BUFFERS_CHANGED) {
+            CHECK_EQ((status_t)OK, codec->getOutputBuffers(&outBuffers));
+        } else if (err == INFO_FORMAT_CHANGED) {
+            sp<AMessage> format;
+            CHECK_EQ((status_t)OK, codec->getOutputFormat(&format));
+            ALOGV("format changed: %s", format->debugString().c_str());
+        } else {
+            CHECK_EQ(err, -EAGAIN);
+        }
+    }
+    return OK;
+}
+
+// Asynchronous (callback) drive loop: the codec pushes buffer availability to
+// this handler, matching how production apps use MediaCodec's async mode.
+struct AsyncDriver : public AHandler {
+    AsyncDriver(const sp<MediaCodec> &codec, const sp<InputSource> &source,
+            LatencyTracker *tracker, Result *result)
+        : mCodec(codec), mSource(source), mTracker(tracker), mResult(result),
+          mSignalledInputEOS(false), mDone(false), mErr(OK) {}
+
+    sp<AMessage> getNotify() {
+        return new AMessage(kWhatCodecNotify, this);
+    }
+
+    status_t waitForEOS() {
+        Mutex::Autolock _l(mLock);
+        while (!mDone) {
+            mCondition.wait(mLock);
+        }
+        return mErr;
+    }
+
+  protected:
+    virtual void onMessageReceived(const sp<AMessage> &msg) {
+        CHECK_EQ(msg->what(), (uint32_t)kWhatCodecNotify);
+        int32_t cbID;
+        CHECK(msg->findInt32("callbackID", &cbID));
+        switch (cbID) {
+            case MediaCodec::CB_INPUT_AVAILABLE:
+            {
+                int32_t index;
+                CHECK(msg->findInt32("index", &index));
+                if (mSignalledInputEOS) {
+                    break;
+                }
+                sp<MediaCodecBuffer> buffer;
+                CHECK_EQ((status_t)OK, mCodec->getInputBuffer(index, &buffer));
+                int64_t timeUs = 0;
+                if (mSource->fill(buffer, &timeUs)) {
+                    mTracker->recordQueued(timeUs);
+                    CHECK_EQ((status_t)OK, mCodec->queueInputBuffer(
+                            index, 0 /* offset */, buffer->size(), timeUs, 0 /* flags */));
+                } else {
+                    CHECK_EQ((status_t)OK, mCodec->queueInputBuffer(
+                            index, 0 /* offset */, 0 /* size */, 0ll /* timeUs */,
+                            MediaCodec::BUFFER_FLAG_EOS));
+                    mSignalledInputEOS = true;
+                }
+                break;
+            }
+
+            case MediaCodec::CB_OUTPUT_AVAILABLE:
+            {
+                int32_t index;
+                size_t size;
+                int64_t timeUs;
+                int32_t flags;
+                CHECK(msg->findInt32("index", &index));
+                CHECK(msg->findSize("size", &size));
+                CHECK(msg->findInt64("timeUs", &timeUs));
+                CHECK(msg->findInt32("flags", &flags));
+                if (size != 0 && !(flags & MediaCodec::BUFFER_FLAG_CODECCONFIG)) {
+                    mTracker->recordOutput(timeUs);
+                    ++mResult->frames;
+                    mResult->bytes += size;
+                }
+                CHECK_EQ((status_t)OK, mCodec->releaseOutputBuffer(index));
+                if (flags & MediaCodec::BUFFER_FLAG_EOS) {
+                    signalDone(OK);
+                }
+                break;
+            }
+
+            case MediaCodec::CB_OUTPUT_FORMAT_CHANGED:
+            {
+                sp<AMessage> format;
+                CHECK(msg->findMessage("format", &format));
+                ALOGV("format changed: %s", format->debugString().c_str());
+                break;
+            }
+
+            case MediaCodec::CB_ERROR:
+            {
+                status_t err;
+                CHECK(msg->findInt32("err", &err));
+                fprintf(stderr, "codec reported error 0x%x\n", err);
+                signalDone(err);
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+  private:
+    enum {
+        kWhatCodecNotify = 'noti',
+    };
+
+    void signalDone(status_t err) {
+        Mutex::Autolock _l(mLock);
+        mErr = err;
+        mDone = true;
+        mCondition.signal();
+    }
+
+    sp<MediaCodec> mCodec;
+    sp<InputSource> mSource;
+    LatencyTracker *mTracker;
+    Result *mResult;
+    bool mSignalledInputEOS;
+
+    Mutex mLock;
+    Condition mCondition;
+    bool mDone;
+    status_t mErr;
+};
+
+}  // namespace android
+
+int main(int argc, char **argv) {
+    using namespace android;
+
+    const char *me = argv[0];
+
+    bool scenarioEncode = false;
+    bool asyncMode = false;
+    bool useAudio = false;
+    const char *encodeMime = MEDIA_MIMETYPE_VIDEO_AVC;
+    int64_t warmupFrames = 30;
+    int64_t maxFrames = -1;
+    int32_t encodeWidth = 1280;
+    int32_t encodeHeight = 720;
+    int32_t encodeBitRate = 8000000;
+    bool jsonOutput = false;
+    const char *outputPath = NULL;
+    const char *label = NULL;
+
+    int res;
+    while ((res = getopt(argc, argv, "s:Aam:w:n:W:H:b:f:o:l:h")) >= 0) {
+        switch (res) {
+            case 's':
+            {
+                if (!strcmp(optarg, "encode")) {
+                    scenarioEncode = true;
+                } else if (strcmp(optarg, "decode")) {
+                    usage(me);
+                }
+                break;
+            }
+            case 'A':
+            {
+                asyncMode = true;
+                break;
+            }
+            case 'a':
+            {
+                useAudio = true;
+                break;
+            }
+            case 'm':
+            {
+                encodeMime = optarg;
+                break;
+            }
+            case 'w':
+            {
+                warmupFrames = atoll(optarg);
+                break;
+            }
+            case 'n':
+            {
+                maxFrames = atoll(optarg);
+                break;
+            }
+            case 'W':
+            {
+                encodeWidth = atoi(optarg);
+                break;
+            }
+            case 'H':
+            {
+                encodeHeight = atoi(optarg);
+                break;
+            }
+            case 'b':
+            {
+                encodeBitRate = atoi(optarg);
+                break;
+            }
+            case 'f':
+            {
+                if (!strcmp(optarg, "json")) {
+                    jsonOutput = true;
+                } else if (strcmp(optarg, "csv")) {
+                    usage(me);
+                }
+                break;
+            }
+            case 'o':
+            {
+                outputPath = optarg;
+                break;
+            }
+            case 'l':
+            {
+                label = optarg;
+                break;
+            }
+            case '?':
+            case 'h':
+            default:
+            {
+                usage(me);
+            }
+        }
+    }
+
+    argc -= optind;
+    argv += optind;
+
+    if (scenarioEncode ? argc != 0 : argc != 1) {
+        usage(me);
+    }
+
+    ProcessState::self()->startThreadPool();
+
+    sp<android::ALooper> looper = new android::ALooper;
+    looper->start();
+
+    sp<InputSource> source;
+    AString mime;
+    if (scenarioEncode) {
+        mime = encodeMime;
+        source = new SyntheticYuvSource(
+                encodeMime, encodeWidth, encodeHeight, encodeBitRate,
+                30 /* frameRate */, maxFrames < 0 ? 600 : maxFrames);
+    } else {
+        sp<NuMediaExtractor> extractor =
+                new NuMediaExtractor(NuMediaExtractor::EntryPoint::OTHER);
+        if (extractor->setDataSource(NULL /* httpService */, argv[0]) != OK) {
+            fprintf(stderr, "unable to instantiate extractor.\n");
+            return 1;
+        }
+        sp<AMessage> format;
+        for (size_t i = 0; i < extractor->countTracks(); ++i) {
+            sp<AMessage> trackFormat;
+            CHECK_EQ(extractor->getTrackFormat(i, &trackFormat), (status_t)OK);
+            AString trackMime;
+            CHECK(trackFormat->findString("mime", &trackMime));
+            bool isAudio = !strncasecmp(trackMime.c_str(), "audio/", 6);
+            bool isVideo = !strncasecmp(trackMime.c_str(), "video/", 6);
+            if ((useAudio && isAudio) || (!useAudio && isVideo)) {
+                CHECK_EQ(extractor->selectTrack(i), (status_t)OK);
+                format = trackFormat;
+                mime = trackMime;
+                break;
+            }
+        }
+        if (format == NULL) {
+            fprintf(stderr, "no %s track found.\n", useAudio ? "audio" : "video");
+            return 1;
+        }
+        source = new ExtractorSource(extractor, format, maxFrames);
+    }
+
+    sp<MediaCodec> codec = MediaCodec::CreateByType(
+            looper, mime.c_str(), scenarioEncode /* encoder */);
+    if (codec == NULL) {
+        fprintf(stderr, "unable to create codec for %s.\n", mime.c_str());
+        return 1;
+    }
+
+    LatencyTracker tracker(warmupFrames);
+    Result result;
+    result.scenario = scenarioEncode ? "encode" : "decode";
+    result.mode = asyncMode ? "async" : "sync";
+    result.mime = mime.c_str();
+    result.label = label != NULL ? label : result.scenario;
+
+    sp<AsyncDriver> driver;
+    if (asyncMode) {
+        driver = new AsyncDriver(codec, source, &tracker, &result);
+        looper->registerHandler(driver);
+        CHECK_EQ((status_t)OK, codec->setCallback(driver->getNotify()));
+    }
+
+    status_t err = codec->configure(
+            source->getFormat(), NULL /* surface */, NULL /* crypto */,
+            scenarioEncode ? MediaCodec::CONFIGURE_FLAG_ENCODE : 0);
+    if (err != OK) {
+        fprintf(stderr, "unable to configure codec (err=%d).\n", err);
+        codec->release();
+        return 1;
+    }
+
+    struct rusage usageBefore;
+    getrusage(RUSAGE_SELF, &usageBefore);
+    int64_t startTimeUs = android::ALooper::GetNowUs();
+
+    CHECK_EQ((status_t)OK, codec->start());
+    if (asyncMode) {
+        err = driver->waitForEOS();
+    } else {
+        err = runSync(codec, source, &tracker, &result);
+    }
+
+    result.elapsedUs = android::ALooper::GetNowUs() - startTimeUs;
+    struct rusage usageAfter;
+    getrusage(RUSAGE_SELF, &usageAfter);
+    result.cpuUserUs = timevalToUs(usageAfter.ru_utime) - timevalToUs(usageBefore.ru_utime);
+    result.cpuSystemUs = timevalToUs(usageAfter.ru_stime) - timevalToUs(usageBefore.ru_stime);
+    result.peakRssKb = usageAfter.ru_maxrss;
+
+    codec->release();
+    looper->stop();
+
+    if (err != OK) {
+        fprintf(stderr, "benchmark run failed (err=%d).\n", err);
+        return 1;
+    }
+
+    result.latenciesUs = tracker.mLatenciesUs;
+    std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+
+    FILE *out = stdout;
+    if (outputPath != NULL) {
+        out = fopen(outputPath, "w");
+        if (out == NULL) {
+            fprintf(stderr, "unable to open '%s' for writing.\n", outputPath);
+            return 1;
+        }
+    }
+    writeReport(out, jsonOutput, result);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return 0;
+}
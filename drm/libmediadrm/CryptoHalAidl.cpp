@@ -304,12 +304,10 @@ ssize_t CryptoHalAidl::decrypt(const uint8_t keyId[16], const uint8_t iv[16],
     aPattern.encryptBlocks = pattern.mEncryptBlocks;
     aPattern.skipBlocks = pattern.mSkipBlocks;
 
-    std::vector<SubSample> stdSubSamples;
+    std::vector<SubSample> stdSubSamples(numSubSamples);
     for (size_t i = 0; i < numSubSamples; i++) {
-        SubSample subSample;
-        subSample.numBytesOfClearData = subSamples[i].mNumBytesOfClearData;
-        subSample.numBytesOfEncryptedData = subSamples[i].mNumBytesOfEncryptedData;
-        stdSubSamples.push_back(subSample);
+        stdSubSamples[i].numBytesOfClearData = subSamples[i].mNumBytesOfClearData;
+        stdSubSamples[i].numBytesOfEncryptedData = subSamples[i].mNumBytesOfEncryptedData;
     }
 
     bool secure;
@@ -334,13 +332,12 @@ ssize_t CryptoHalAidl::decrypt(const uint8_t keyId[16], const uint8_t iv[16],
     status_t err = UNKNOWN_ERROR;
     mLock.unlock();
 
-    std::vector<uint8_t> keyIdAidl(toStdVec(keyId, 16));
-    std::vector<uint8_t> ivAidl(toStdVec(iv, 16));
-
+    // Build the key and IV in place; the intermediate vectors were copied a
+    // second time into the args struct on every access unit.
     DecryptArgs args;
     args.secure = secure;
-    args.keyId = keyIdAidl;
-    args.iv = ivAidl;
+    args.keyId = toStdVec(keyId, 16);
+    args.iv = toStdVec(iv, 16);
     args.mode = aMode;
     args.pattern = aPattern;
     args.subSamples = std::move(stdSubSamples);
@@ -306,14 +306,15 @@ ssize_t CryptoHalHidl::decrypt(const uint8_t keyId[16], const uint8_t iv[16],
     hPattern.encryptBlocks = pattern.mEncryptBlocks;
     hPattern.skipBlocks = pattern.mSkipBlocks;
 
-    std::vector<SubSample> stdSubSamples;
+    // Fill the hidl_vec directly instead of going through an intermediate
+    // std::vector; decrypt runs once per access unit so the extra allocation
+    // and copy add up on high-rate streams.
+    hidl_vec<SubSample> hSubSamples;
+    hSubSamples.resize(numSubSamples);
     for (size_t i = 0; i < numSubSamples; i++) {
-        SubSample subSample;
-        subSample.numBytesOfClearData = subSamples[i].mNumBytesOfClearData;
-        subSample.numBytesOfEncryptedData = subSamples[i].mNumBytesOfEncryptedData;
-        stdSubSamples.push_back(subSample);
+        hSubSamples[i].numBytesOfClearData = subSamples[i].mNumBytesOfClearData;
+        hSubSamples[i].numBytesOfEncryptedData = subSamples[i].mNumBytesOfEncryptedData;
     }
-    auto hSubSamples = hidl_vec<SubSample>(stdSubSamples);
 
     bool secure;
     if (hDestination.type == BufferType::SHARED_MEMORY) {
@@ -598,9 +598,16 @@ status_t DrmHalAidl::getKeyRequest(Vector<uint8_t> const& sessionId,
     std::vector<uint8_t> initDataAidl = toStdVec(initData);
     KeyRequest keyRequest;
 
+    // Generating a key request can be a long plugin operation, and mLock is
+    // shared between Drm instances. Drop it around the transaction so
+    // concurrent sessions can build their key requests in parallel instead
+    // of paying the license round trips in sequence.
+    std::shared_ptr<IDrmPluginAidl> plugin = mPlugin;
+    mLock.unlock();
     ::ndk::ScopedAStatus status =
-            mPlugin->getKeyRequest(sessionIdAidl, initDataAidl, toStdString(mimeType), aKeyType,
+            plugin->getKeyRequest(sessionIdAidl, initDataAidl, toStdString(mimeType), aKeyType,
                                    toKeyValueVector(optionalParameters), &keyRequest);
+    mLock.lock();
     if (status.isOk()) {
         request = toVector(keyRequest.request);
         defaultUrl = toString8(keyRequest.defaultUrl);
@@ -626,8 +633,14 @@ status_t DrmHalAidl::provideKeyResponse(Vector<uint8_t> const& sessionId,
     std::vector<uint8_t> sessionIdAidl = toStdVec(sessionId);
     std::vector<uint8_t> responseAidl = toStdVec(response);
     KeySetId keySetIdsAidl;
+
+    // As with getKeyRequest, run the plugin transaction outside the shared
+    // lock so concurrent sessions can install their licenses in parallel.
+    std::shared_ptr<IDrmPluginAidl> plugin = mPlugin;
+    mLock.unlock();
     ::ndk::ScopedAStatus status =
-            mPlugin->provideKeyResponse(sessionIdAidl, responseAidl, &keySetIdsAidl);
+            plugin->provideKeyResponse(sessionIdAidl, responseAidl, &keySetIdsAidl);
+    mLock.lock();
 
     if (status.isOk()) keySetId = toVector(keySetIdsAidl.keySetId);
     err = statusAidlToStatusT(status);
@@ -742,8 +742,17 @@ status_t DrmHalHidl::getKeyRequest(Vector<uint8_t> const& sessionId,
     status_t err = UNKNOWN_ERROR;
     Return<void> hResult;
 
-    if (mPluginV1_2 != NULL) {
-        hResult = mPluginV1_2->getKeyRequest_1_2(
+    // Generating a key request can be a long plugin operation, and mLock is
+    // shared between Drm instances. Drop it around the transaction so
+    // concurrent sessions can build their key requests in parallel instead
+    // of paying the license round trips in sequence.
+    sp<IDrmPlugin> plugin = mPlugin;
+    sp<drm::V1_1::IDrmPlugin> pluginV1_1 = mPluginV1_1;
+    sp<drm::V1_2::IDrmPlugin> pluginV1_2 = mPluginV1_2;
+    mLock.unlock();
+
+    if (pluginV1_2 != NULL) {
+        hResult = pluginV1_2->getKeyRequest_1_2(
                 toHidlVec(sessionId), toHidlVec(initData), toHidlString(mimeType), hKeyType,
                 hOptionalParameters,
                 [&](Status_V1_2 status, const hidl_vec<uint8_t>& hRequest,
@@ -755,8 +764,8 @@ status_t DrmHalHidl::getKeyRequest(Vector<uint8_t> const& sessionId,
                     }
                     err = toStatusT(status);
                 });
-    } else if (mPluginV1_1 != NULL) {
-        hResult = mPluginV1_1->getKeyRequest_1_1(
+    } else if (pluginV1_1 != NULL) {
+        hResult = pluginV1_1->getKeyRequest_1_1(
                 toHidlVec(sessionId), toHidlVec(initData), toHidlString(mimeType), hKeyType,
                 hOptionalParameters,
                 [&](Status status, const hidl_vec<uint8_t>& hRequest,
@@ -769,7 +778,7 @@ status_t DrmHalHidl::getKeyRequest(Vector<uint8_t> const& sessionId,
                     err = toStatusT(status);
                 });
     } else {
-        hResult = mPlugin->getKeyRequest(
+        hResult = plugin->getKeyRequest(
                 toHidlVec(sessionId), toHidlVec(initData), toHidlString(mimeType), hKeyType,
                 hOptionalParameters,
                 [&](Status status, const hidl_vec<uint8_t>& hRequest,
@@ -782,6 +791,7 @@ status_t DrmHalHidl::getKeyRequest(Vector<uint8_t> const& sessionId,
                     err = toStatusT(status);
                 });
     }
+    mLock.lock();
 
     err = hResult.isOk() ? err : DEAD_OBJECT;
     keyRequestTimer.SetAttribute(err);
@@ -799,14 +809,19 @@ status_t DrmHalHidl::provideKeyResponse(Vector<uint8_t> const& sessionId,
 
     status_t err = UNKNOWN_ERROR;
 
+    // As with getKeyRequest, run the plugin transaction outside the shared
+    // lock so concurrent sessions can install their licenses in parallel.
+    sp<IDrmPlugin> plugin = mPlugin;
+    mLock.unlock();
     Return<void> hResult =
-            mPlugin->provideKeyResponse(toHidlVec(sessionId), toHidlVec(response),
+            plugin->provideKeyResponse(toHidlVec(sessionId), toHidlVec(response),
                                         [&](Status status, const hidl_vec<uint8_t>& hKeySetId) {
                                             if (status == Status::OK) {
                                                 keySetId = toVector(hKeySetId);
                                             }
                                             err = toStatusT(status);
                                         });
+    mLock.lock();
     err = hResult.isOk() ? err : DEAD_OBJECT;
     keyResponseTimer.SetAttribute(err);
     return err;
@@ -28,11 +28,20 @@
 #include <mediadrm/DrmSessionManager.h>
 #include <unistd.h>
 #include <utils/String8.h>
+#include <utils/Timers.h>
 
+#include <thread>
 #include <vector>
 
 namespace android {
 
+// Ranked eviction tuning. A session is an eviction candidate once it has
+// been idle this long:
+static const int64_t kPreemptMinIdleNs = 30000000000LL;  // 30 secs
+// and each recorded use pushes its rank up by this much, so frequently used
+// sessions outlive one-shot ones of the same age.
+static const int64_t kPreemptUseBonusNs = 5000000000LL;  // 5 secs
+
 using aidl::android::media::MediaResourceParcel;
 
 namespace {
@@ -100,6 +109,8 @@ DrmSessionManager::DrmSessionManager()
 
 DrmSessionManager::DrmSessionManager(const std::shared_ptr<IResourceManagerService> &service)
     : mService(service),
+      mObservedCapacity(0),
+      mPreemptiveReclaimBusy(false),
       mInitialized(false),
       mDeathRecipient(AIBinder_DeathRecipient_new(ResourceManagerServiceDied)) {
     if (mService == NULL) {
@@ -136,8 +147,11 @@ void DrmSessionManager::addSession(int pid,
     }
 
     static int64_t clientId = 0;
-    mSessionMap[toStdVec(sessionId)] = (SessionInfo){pid, uid, clientId};
+    mSessionMap[toStdVec(sessionId)] = SessionInfo{
+            pid, uid, clientId, drm, 0 /* useCount */,
+            systemTime(SYSTEM_TIME_MONOTONIC)};
     mService->addResource(pid, uid, clientId++, drm, toResourceVec(sessionId, INT64_MAX));
+    preemptiveReclaimIfNeeded();
 }
 
 void DrmSessionManager::useSession(const Vector<uint8_t> &sessionId) {
@@ -149,7 +163,9 @@ void DrmSessionManager::useSession(const Vector<uint8_t> &sessionId) {
         return;
     }
 
-    auto info = it->second;
+    SessionInfo &info = it->second;
+    info.useCount++;
+    info.lastUseTimeNs = systemTime(SYSTEM_TIME_MONOTONIC);
     mService->addResource(info.pid, info.uid, info.clientId, NULL, toResourceVec(sessionId, -1));
 }
 
@@ -174,6 +190,12 @@ bool DrmSessionManager::reclaimSession(int callingPid) {
     // unlock early because reclaimResource might callback into removeSession
     mLock.lock();
     std::shared_ptr<IResourceManagerService> service(mService);
+    // The plugin just reported session exhaustion, so the current session
+    // count approximates the device limit; remember it so addSession can
+    // start evicting idle sessions before the next open hits the wall.
+    if (mSessionMap.size() > mObservedCapacity) {
+        mObservedCapacity = mSessionMap.size();
+    }
     mLock.unlock();
 
     if (service == NULL) {
@@ -188,6 +210,55 @@ bool DrmSessionManager::reclaimSession(int callingPid) {
     return status.isOk() && success;
 }
 
+void DrmSessionManager::preemptiveReclaimIfNeeded() {
+    if (mObservedCapacity == 0 || mSessionMap.size() + 1 < mObservedCapacity) {
+        // Either the device limit has never been hit, or there is still
+        // headroom below it.
+        return;
+    }
+    if (mPreemptiveReclaimBusy.exchange(true)) {
+        return;
+    }
+
+    // Rank sessions by last use plus a per-use grace bonus and pick the
+    // lowest; sessions used recently are not candidates at all.
+    const int64_t nowNs = systemTime(SYSTEM_TIME_MONOTONIC);
+    std::shared_ptr<IResourceManagerClient> victim;
+    int64_t victimRankNs = INT64_MAX;
+    for (auto &entry : mSessionMap) {
+        const SessionInfo &info = entry.second;
+        if (nowNs - info.lastUseTimeNs < kPreemptMinIdleNs) {
+            continue;
+        }
+        int64_t rankNs = info.lastUseTimeNs + info.useCount * kPreemptUseBonusNs;
+        if (rankNs >= victimRankNs) {
+            continue;
+        }
+        std::shared_ptr<IResourceManagerClient> client = info.client.lock();
+        if (client == NULL) {
+            continue;
+        }
+        victim = client;
+        victimRankNs = rankNs;
+    }
+    if (victim == NULL) {
+        mPreemptiveReclaimBusy = false;
+        return;
+    }
+
+    ALOGV("preemptively reclaiming an idle session (%zu of ~%zu in use)",
+            mSessionMap.size(), mObservedCapacity);
+    // Tear the victim down off the caller's thread; its reclaimResource
+    // calls back into removeSession once the owner has closed the session.
+    sp<DrmSessionManager> keepAlive(this);
+    std::thread([keepAlive, victim] {
+        bool success = false;
+        victim->reclaimResource(&success);
+        ALOGV("preemptive reclaim %s", success ? "succeeded" : "failed");
+        keepAlive->mPreemptiveReclaimBusy = false;
+    }).detach();
+}
+
 size_t DrmSessionManager::getSessionCount() const {
     Mutex::Autolock lock(mLock);
     return mSessionMap.size();
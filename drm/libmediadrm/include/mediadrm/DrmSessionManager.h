@@ -27,6 +27,7 @@
 #include <utils/threads.h>
 #include <utils/Vector.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <utility>
@@ -45,6 +46,12 @@ struct SessionInfo {
     pid_t pid;
     uid_t uid;
     int64_t clientId;
+    // Held weakly so the session's lifetime stays owned by the Drm
+    // instance; used to tear down ranked eviction victims directly.
+    std::weak_ptr<IResourceManagerClient> client;
+    // Usage statistics feeding the eviction ranking.
+    int64_t useCount;
+    int64_t lastUseTimeNs;
 };
 
 typedef std::map<std::vector<uint8_t>, SessionInfo> SessionInfoMap;
@@ -75,9 +82,19 @@ protected:
 private:
     void init();
 
+    // Called with mLock held. Once the session count is about to reach the
+    // observed device limit, evicts the lowest-ranked idle session on a
+    // background thread so the next openSession doesn't stall on a
+    // synchronous reclaim.
+    void preemptiveReclaimIfNeeded();
+
     std::shared_ptr<IResourceManagerService> mService;
     mutable Mutex mLock;
     SessionInfoMap mSessionMap;
+    // Largest session count at which a plugin reported resource exhaustion;
+    // 0 until the limit has been hit once.
+    size_t mObservedCapacity;
+    std::atomic_bool mPreemptiveReclaimBusy;
     bool mInitialized;
     ::ndk::ScopedAIBinder_DeathRecipient mDeathRecipient;
 
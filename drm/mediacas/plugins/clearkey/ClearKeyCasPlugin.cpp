@@ -22,11 +22,13 @@
 #include "ClearKeyLicenseFetcher.h"
 #include "ClearKeyCasPlugin.h"
 #include "ClearKeySessionLibrary.h"
+#include "ClearKeyWorkerPool.h"
 #include <media/stagefright/foundation/ABuffer.h>
 #include <media/stagefright/foundation/ADebug.h>
 #include <media/stagefright/foundation/hexdump.h>
 #include <media/stagefright/MediaErrors.h>
 #include <utils/Log.h>
+#include <vector>
 
 android::CasFactory* createCasFactory() {
     return new android::clearkeycas::ClearKeyCasFactory();
@@ -397,6 +399,10 @@ status_t ClearKeyCasSession::updateECM(
     return OK;
 }
 
+// A descramble call with at least this many scrambled subsamples is split
+// across the worker pool; smaller calls aren't worth the dispatch overhead.
+const static size_t kMinSubSamplesForParallelDecrypt = 8;
+
 // Decryption of a set of sub-samples
 ssize_t ClearKeyCasSession::decrypt(
         bool secure, DescramblerPlugin::ScramblingControl scramblingControl,
@@ -423,31 +429,53 @@ ssize_t ClearKeyCasSession::decrypt(
         contentKey = mKeyInfo[keyIndex].contentKey;
     }
 
+    // Each subsample is a TS packet payload decrypted with a zero IV, so the
+    // subsamples are independent of each other. Precompute the byte offset of
+    // each subsample so contiguous ranges of them can be processed in
+    // parallel; per-stream sample order is preserved because this call does
+    // not return until the whole batch is done.
+    std::vector<size_t> offsets(numSubSamples + 1);
+    offsets[0] = 0;
+    for (size_t i = 0; i < numSubSamples; i++) {
+        offsets[i + 1] = offsets[i] + subSamples[i].mNumBytesOfClearData
+                + subSamples[i].mNumBytesOfEncryptedData;
+    }
+
     uint8_t *src = (uint8_t*)srcPtr;
     uint8_t *dst = (uint8_t*)dstPtr;
 
-    for (size_t i = 0; i < numSubSamples; i++) {
-        size_t numBytesinSubSample = subSamples[i].mNumBytesOfClearData
-                + subSamples[i].mNumBytesOfEncryptedData;
-        if (src != dst) {
-            memcpy(dst, src, numBytesinSubSample);
+    auto processSubSamples = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            size_t numBytesinSubSample = offsets[i + 1] - offsets[i];
+            if (src != dst) {
+                memcpy(dst + offsets[i], src + offsets[i], numBytesinSubSample);
+            }
+            // Don't decrypt if len < AES_BLOCK_SIZE.
+            // The last chunk shorter than AES_BLOCK_SIZE is not encrypted.
+            if (scramblingControl != DescramblerPlugin::kScrambling_Unscrambled
+                    && subSamples[i].mNumBytesOfEncryptedData >= AES_BLOCK_SIZE) {
+                decryptPayload(
+                        contentKey,
+                        numBytesinSubSample,
+                        subSamples[i].mNumBytesOfClearData,
+                        (char *)dst + offsets[i]);
+            }
         }
-        status_t err = OK;
-        // Don't decrypt if len < AES_BLOCK_SIZE.
-        // The last chunk shorter than AES_BLOCK_SIZE is not encrypted.
-        if (scramblingControl != DescramblerPlugin::kScrambling_Unscrambled
-                && subSamples[i].mNumBytesOfEncryptedData >= AES_BLOCK_SIZE) {
-            err = decryptPayload(
-                    contentKey,
-                    numBytesinSubSample,
-                    subSamples[i].mNumBytesOfClearData,
-                    (char *)dst);
-        }
-
-        dst += numBytesinSubSample;
-        src += numBytesinSubSample;
+    };
+
+    ClearKeyWorkerPool *pool = ClearKeyWorkerPool::get();
+    if (scramblingControl != DescramblerPlugin::kScrambling_Unscrambled
+            && numSubSamples >= kMinSubSamplesForParallelDecrypt
+            && pool->workerCount() > 0) {
+        const size_t numChunks = pool->workerCount() + 1;
+        pool->runParallel(numChunks, [&](size_t chunk) {
+            processSubSamples(chunk * numSubSamples / numChunks,
+                              (chunk + 1) * numSubSamples / numChunks);
+        });
+    } else {
+        processSubSamples(0, numSubSamples);
     }
-    return dst - (uint8_t *)dstPtr;
+    return offsets[numSubSamples];
 }
 
 // Decryption of a TS payload
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "ClearKeyWorkerPool"
+
+#include "ClearKeyWorkerPool.h"
+
+#include <utils/Log.h>
+
+#include <algorithm>
+
+namespace android {
+namespace clearkeycas {
+
+// Descrambling is memory-bandwidth bound well before this many cores.
+static const size_t kMaxWorkerThreads = 4;
+
+Mutex ClearKeyWorkerPool::sSingletonLock;
+ClearKeyWorkerPool* ClearKeyWorkerPool::sSingleton = NULL;
+
+ClearKeyWorkerPool* ClearKeyWorkerPool::get() {
+    Mutex::Autolock lock(sSingletonLock);
+
+    if (sSingleton == NULL) {
+        ALOGV("Instantiating Worker Pool Singleton.");
+        sSingleton = new ClearKeyWorkerPool();
+    }
+
+    return sSingleton;
+}
+
+ClearKeyWorkerPool::ClearKeyWorkerPool() : mExit(false) {
+    // The calling thread processes chunks too, so on a single core no worker
+    // threads are spawned and runParallel degenerates to a serial loop.
+    const size_t numCores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t numThreads = std::min(numCores - 1, kMaxWorkerThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        mThreads.emplace_back(&ClearKeyWorkerPool::threadLoop, this);
+    }
+    ALOGV("CTOR: %zu worker thread(s)", mThreads.size());
+}
+
+ClearKeyWorkerPool::~ClearKeyWorkerPool() {
+    {
+        Mutex::Autolock lock(mQueueLock);
+        mExit = true;
+        mWorkCondition.broadcast();
+    }
+    for (std::thread &thread : mThreads) {
+        thread.join();
+    }
+}
+
+void ClearKeyWorkerPool::runParallel(
+        size_t count, const std::function<void(size_t)> &task) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || mThreads.empty()) {
+        for (size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    std::shared_ptr<Batch> batch(new Batch());
+    batch->task = &task;
+    batch->count = count;
+    batch->nextIndex = 0;
+    batch->doneCount = 0;
+
+    {
+        Mutex::Autolock lock(mQueueLock);
+        mBatches.push_back(batch);
+        mWorkCondition.broadcast();
+    }
+
+    // Process chunks on the calling thread as well instead of just waiting.
+    while (true) {
+        size_t index;
+        {
+            Mutex::Autolock lock(mQueueLock);
+            if (batch->nextIndex >= batch->count) {
+                break;
+            }
+            index = batch->nextIndex++;
+            if (batch->nextIndex == batch->count) {
+                mBatches.remove(batch);
+            }
+        }
+        runChunk(batch, index);
+    }
+
+    Mutex::Autolock lock(batch->doneLock);
+    while (batch->doneCount < batch->count) {
+        batch->doneCondition.wait(batch->doneLock);
+    }
+}
+
+void ClearKeyWorkerPool::runChunk(
+        const std::shared_ptr<Batch> &batch, size_t index) {
+    (*batch->task)(index);
+
+    Mutex::Autolock lock(batch->doneLock);
+    if (++batch->doneCount == batch->count) {
+        batch->doneCondition.broadcast();
+    }
+}
+
+void ClearKeyWorkerPool::threadLoop() {
+    while (true) {
+        std::shared_ptr<Batch> batch;
+        size_t index;
+        {
+            Mutex::Autolock lock(mQueueLock);
+            while (!mExit && mBatches.empty()) {
+                mWorkCondition.wait(mQueueLock);
+            }
+            if (mExit) {
+                return;
+            }
+            batch = mBatches.front();
+            index = batch->nextIndex++;
+            if (batch->nextIndex == batch->count) {
+                mBatches.pop_front();
+            }
+        }
+        runChunk(batch, index);
+    }
+}
+
+} // namespace clearkeycas
+} // namespace android
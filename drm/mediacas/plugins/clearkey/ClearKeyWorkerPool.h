@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CLEARKEY_WORKER_POOL_H_
+#define CLEARKEY_WORKER_POOL_H_
+
+#include <media/stagefright/foundation/ADebug.h>
+#include <utils/Condition.h>
+#include <utils/Mutex.h>
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace android {
+namespace clearkeycas {
+
+// Pool of descrambling worker threads shared by all clear key sessions.
+// A descramble call splits its subsamples into chunks and runs the chunks
+// across the pool, blocking until the whole batch is done, so one call keeps
+// its synchronous contract while calls from multiple channels scale across
+// the available cores.
+class ClearKeyWorkerPool {
+public:
+    static ClearKeyWorkerPool* get();
+
+    // Number of worker threads in the pool, not counting the calling thread.
+    size_t workerCount() const { return mThreads.size(); }
+
+    // Runs task(i) for every i in [0, count), distributed over the worker
+    // threads and the calling thread, and returns once all of them completed.
+    void runParallel(size_t count, const std::function<void(size_t)> &task);
+
+private:
+    // One runParallel call in flight. The chunk indices are handed out under
+    // the pool queue lock; completion is tracked under the batch's own lock so
+    // finished batches don't contend on the queue.
+    struct Batch {
+        const std::function<void(size_t)> *task;
+        size_t count;
+        size_t nextIndex;
+        Mutex doneLock;
+        Condition doneCondition;
+        size_t doneCount;
+    };
+
+    static Mutex sSingletonLock;
+    static ClearKeyWorkerPool* sSingleton;
+
+    Mutex mQueueLock;
+    Condition mWorkCondition;
+    std::list<std::shared_ptr<Batch>> mBatches;
+    std::vector<std::thread> mThreads;
+    bool mExit;
+
+    ClearKeyWorkerPool();
+    ~ClearKeyWorkerPool();
+    void threadLoop();
+    void runChunk(const std::shared_ptr<Batch> &batch, size_t index);
+
+    DISALLOW_EVIL_CONSTRUCTORS(ClearKeyWorkerPool);
+};
+
+} // namespace clearkeycas
+} // namespace android
+
+#endif // CLEARKEY_WORKER_POOL_H_
@@ -92,6 +92,34 @@ class MmapStreamInterface : public virtual RefBase
     virtual status_t createMmapBuffer(int32_t minSizeFrames,
                                       struct audio_mmap_buffer_info *info) = 0;
 
+    /**
+     * Renegotiate the mmap buffer (and with it the HAL burst size) on an
+     * already open stream, without tearing down the stream, its routing
+     * or its effect chains.  Allows latency/power tradeoffs to track the
+     * application mode (e.g. small bursts while tracking, large bursts
+     * while mixing).
+     *
+     * All clients must be stopped when this is called: the expected
+     * sequence is stop() - resizeMmapBuffer() - remap - start(), which
+     * cycles the HAL through standby but keeps the stream open so the
+     * gap is bounded by one standby/start cycle rather than a full
+     * close/reopen renegotiation.
+     *
+     * \param[in] min_size_frames minimum buffer size requested. The actual buffer
+     *        size returned in struct audio_mmap_buffer_info can be larger.
+     * \param[out] info address at which the new mmap buffer information should be returned.
+     *
+     * \return OK if the buffer was reallocated.
+     *         NO_INIT in case of initialization error
+     *         BAD_VALUE if the requested buffer size is too large
+     *         INVALID_OPERATION if a client is still active, or the
+     *                           implementation does not support resizing
+     */
+    virtual status_t resizeMmapBuffer(int32_t minSizeFrames __unused,
+                                      struct audio_mmap_buffer_info *info __unused) {
+        return INVALID_OPERATION;
+    }
+
     /**
      * Read current read/write position in the mmap buffer with associated time stamp.
      *
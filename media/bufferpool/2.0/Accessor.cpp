@@ -165,6 +165,14 @@ ResultStatus Accessor::flush() {
     return ResultStatus::CRITICAL_ERROR;
 }
 
+ResultStatus Accessor::setEvictionPolicy(
+        size_t maxUnusedBufferCount, int64_t cleanUpDurationUs) {
+    if (mImpl) {
+        return mImpl->setEvictionPolicy(maxUnusedBufferCount, cleanUpDurationUs);
+    }
+    return ResultStatus::CRITICAL_ERROR;
+}
+
 ResultStatus Accessor::allocate(
         ConnectionId connectionId,
         const std::vector<uint8_t> &params,
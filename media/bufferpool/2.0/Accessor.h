@@ -98,6 +98,16 @@ struct Accessor : public IAccessor {
     /** Invalidates all buffers which are owned by bufferpool */
     ResultStatus flush();
 
+    /**
+     * Adjusts the cache eviction watermarks of the buffer pool.
+     *
+     * @param maxUnusedBufferCount  # of unused buffers that triggers an
+     *                              eviction scan.
+     * @param cleanUpDurationUs     interval between periodic eviction scans.
+     */
+    ResultStatus setEvictionPolicy(
+            size_t maxUnusedBufferCount, int64_t cleanUpDurationUs);
+
     /** Allocates a buffer from a buffer pool.
      *
      * @param connectionId  the connection id of the client.
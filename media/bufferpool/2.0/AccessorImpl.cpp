@@ -22,6 +22,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <utils/Log.h>
+#include <algorithm>
 #include <thread>
 #include "AccessorImpl.h"
 #include "Connection.h"
@@ -274,6 +275,16 @@ void Accessor::Impl::flush() {
     mBufferPool.flush(shared_from_this());
 }
 
+ResultStatus Accessor::Impl::setEvictionPolicy(
+        size_t maxUnusedBufferCount, int64_t cleanUpDurationUs) {
+    if (maxUnusedBufferCount == 0 || cleanUpDurationUs < 0) {
+        return ResultStatus::CRITICAL_ERROR;
+    }
+    std::lock_guard<std::mutex> lock(mBufferPool.mMutex);
+    mBufferPool.setEvictionPolicy(maxUnusedBufferCount, cleanUpDurationUs);
+    return ResultStatus::OK;
+}
+
 void Accessor::Impl::handleInvalidateAck() {
     std::map<ConnectionId, const sp<IObserver>> observers;
     uint32_t invalidationId;
@@ -306,6 +317,9 @@ Accessor::Impl::Impl::BufferPool::BufferPool()
     : mTimestampUs(getTimestampNow()),
       mLastCleanUpUs(mTimestampUs),
       mLastLogUs(mTimestampUs),
+      mMaxUnusedBufferCount(kMaxUnusedBufferCount),
+      mUnusedBufferCountTarget(kUnusedBufferCountTarget),
+      mCleanUpDurationUs(kCleanUpDurationUs),
       mSeq(0),
       mStartSeq(0) {
     mValid = mInvalidationChannel.isValid();
@@ -725,12 +739,24 @@ ResultStatus Accessor::Impl::BufferPool::addNewBuffer(
     return ResultStatus::NO_MEMORY;
 }
 
+void Accessor::Impl::BufferPool::setEvictionPolicy(
+        size_t maxUnusedBufferCount, int64_t cleanUpDurationUs) {
+    ALOGV("bufferpool2 %p : eviction policy %zu unused buffers / %lldus",
+          this, maxUnusedBufferCount, (long long)cleanUpDurationUs);
+    mMaxUnusedBufferCount = maxUnusedBufferCount;
+    // Keep the same hysteresis gap as the defaults, without underflowing.
+    mUnusedBufferCountTarget = maxUnusedBufferCount
+            - std::min(maxUnusedBufferCount,
+                       kMaxUnusedBufferCount - kUnusedBufferCountTarget);
+    mCleanUpDurationUs = cleanUpDurationUs;
+}
+
 void Accessor::Impl::BufferPool::cleanUp(bool clearCache) {
-    if (clearCache || mTimestampUs > mLastCleanUpUs + kCleanUpDurationUs ||
-            mStats.buffersNotInUse() > kMaxUnusedBufferCount) {
+    if (clearCache || mTimestampUs > mLastCleanUpUs + mCleanUpDurationUs ||
+            mStats.buffersNotInUse() > mMaxUnusedBufferCount) {
         mLastCleanUpUs = mTimestampUs;
         if (mTimestampUs > mLastLogUs + kLogDurationUs ||
-                mStats.buffersNotInUse() > kMaxUnusedBufferCount) {
+                mStats.buffersNotInUse() > mMaxUnusedBufferCount) {
             mLastLogUs = mTimestampUs;
             ALOGD("bufferpool2 %p : %zu(%zu size) total buffers - "
                   "%zu(%zu size) used buffers - %zu/%zu (recycle/alloc) - "
@@ -741,7 +767,7 @@ void Accessor::Impl::BufferPool::cleanUp(bool clearCache) {
                   mStats.mTotalFetches, mStats.mTotalTransfers);
         }
         for (auto freeIt = mFreeBuffers.begin(); freeIt != mFreeBuffers.end();) {
-            if (!clearCache && mStats.buffersNotInUse() <= kUnusedBufferCountTarget &&
+            if (!clearCache && mStats.buffersNotInUse() <= mUnusedBufferCountTarget &&
                     (mStats.mSizeCached < kMinAllocBytesForEviction ||
                      mBuffers.size() < kMinBufferCountForEviction)) {
                 break;
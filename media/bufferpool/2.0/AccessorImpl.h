@@ -66,6 +66,9 @@ public:
 
     void cleanUp(bool clearCache);
 
+    ResultStatus setEvictionPolicy(
+            size_t maxUnusedBufferCount, int64_t cleanUpDurationUs);
+
     bool isValid();
 
     void handleInvalidateAck();
@@ -95,6 +98,11 @@ private:
         int64_t mTimestampUs;
         int64_t mLastCleanUpUs;
         int64_t mLastLogUs;
+        // Eviction watermarks; initialized to the default constants and
+        // adjustable per pool via setEvictionPolicy().
+        size_t mMaxUnusedBufferCount;
+        size_t mUnusedBufferCountTarget;
+        int64_t mCleanUpDurationUs;
         BufferId mSeq;
         BufferId mStartSeq;
         bool mValid;
@@ -379,6 +387,17 @@ private:
          */
         void flush(const std::shared_ptr<Accessor::Impl> &impl);
 
+        /**
+         * Adjusts the cache eviction watermarks of the pool.
+         *
+         * @param maxUnusedBufferCount  # of unused buffers that triggers an
+         *                              eviction scan on cleanUp().
+         * @param cleanUpDurationUs     interval between periodic eviction
+         *                              scans.
+         */
+        void setEvictionPolicy(
+                size_t maxUnusedBufferCount, int64_t cleanUpDurationUs);
+
         friend class Accessor::Impl;
     } mBufferPool;
 
@@ -64,6 +64,9 @@ public:
 
     ResultStatus flush();
 
+    ResultStatus setEvictionPolicy(
+            size_t maxUnusedBufferCount, int64_t cleanUpDurationUs);
+
     ResultStatus allocate(const std::vector<uint8_t> &params,
                           native_handle_t **handle,
                           std::shared_ptr<BufferPoolData> *buffer);
@@ -353,6 +356,17 @@ ResultStatus BufferPoolClient::Impl::flush() {
     }
 }
 
+ResultStatus BufferPoolClient::Impl::setEvictionPolicy(
+        size_t maxUnusedBufferCount, int64_t cleanUpDurationUs) {
+    // Only the connection that owns the pool may reconfigure it; the wire
+    // interface to remote pools does not carry eviction policy.
+    if (!mLocal || !mLocalConnection || !mValid) {
+        return ResultStatus::CRITICAL_ERROR;
+    }
+    return mLocalConnection->setEvictionPolicy(
+            maxUnusedBufferCount, cleanUpDurationUs);
+}
+
 ResultStatus BufferPoolClient::Impl::allocate(
         const std::vector<uint8_t> &params,
         native_handle_t **pHandle,
@@ -836,6 +850,14 @@ ResultStatus BufferPoolClient::flush() {
     return ResultStatus::CRITICAL_ERROR;
 }
 
+ResultStatus BufferPoolClient::setEvictionPolicy(
+        size_t maxUnusedBufferCount, int64_t cleanUpDurationUs) {
+    if (isValid()) {
+        return mImpl->setEvictionPolicy(maxUnusedBufferCount, cleanUpDurationUs);
+    }
+    return ResultStatus::CRITICAL_ERROR;
+}
+
 ResultStatus BufferPoolClient::allocate(
         const std::vector<uint8_t> &params,
         native_handle_t **handle,
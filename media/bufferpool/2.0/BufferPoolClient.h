@@ -79,6 +79,9 @@ private:
 
     ResultStatus flush();
 
+    ResultStatus setEvictionPolicy(
+            size_t maxUnusedBufferCount, int64_t cleanUpDurationUs);
+
     ResultStatus allocate(const std::vector<uint8_t> &params,
                           native_handle_t **handle,
                           std::shared_ptr<BufferPoolData> *buffer);
@@ -133,21 +133,28 @@ void BufferStatusChannel::postBufferRelease(
     if (mValid && pending.size() > 0) {
         size_t avail = mBufferStatusQueue->availableToWrite();
         avail = std::min(avail, pending.size());
-        BufferStatusMessage message;
+        if (avail == 0) {
+            return;
+        }
+        // Batch the release messages into a single FMQ write; each write has
+        // its own synchronization cost, which adds up per buffer.
+        std::vector<BufferStatusMessage> messages(avail);
+        auto it = pending.begin();
+        for (size_t i = 0 ; i < avail; ++i, ++it) {
+            messages[i].newStatus = BufferStatus::NOT_USED;
+            messages[i].bufferId = *it;
+            messages[i].connectionId = connectionId;
+        }
+        if (!mBufferStatusQueue->write(messages.data(), avail)) {
+            // Since avaliable # of writes are already confirmed,
+            // this should not happen.
+            // TODO: error handing?
+            ALOGW("FMQ message cannot be sent from %lld", (long long)connectionId);
+            return;
+        }
         for (size_t i = 0 ; i < avail; ++i) {
-            BufferId id = pending.front();
-            message.newStatus = BufferStatus::NOT_USED;
-            message.bufferId = id;
-            message.connectionId = connectionId;
-            if (!mBufferStatusQueue->write(&message, 1)) {
-                // Since avaliable # of writes are already confirmed,
-                // this should not happen.
-                // TODO: error handing?
-                ALOGW("FMQ message cannot be sent from %lld", (long long)connectionId);
-                return;
-            }
+            posted.push_back(pending.front());
             pending.pop_front();
-            posted.push_back(id);
         }
     }
 }
@@ -183,22 +190,16 @@ bool BufferStatusChannel::postBufferStatusMessage(
         size_t avail = mBufferStatusQueue->availableToWrite();
         size_t numPending = pending.size();
         if (avail >= numPending + 1) {
-            BufferStatusMessage release, message;
-            for (size_t i = 0; i < numPending; ++i) {
-                BufferId id = pending.front();
-                release.newStatus = BufferStatus::NOT_USED;
-                release.bufferId = id;
-                release.connectionId = connectionId;
-                if (!mBufferStatusQueue->write(&release, 1)) {
-                    // Since avaliable # of writes are already confirmed,
-                    // this should not happen.
-                    // TODO: error handling?
-                    ALOGW("FMQ message cannot be sent from %lld", (long long)connectionId);
-                    return false;
-                }
-                pending.pop_front();
-                posted.push_back(id);
+            // Submit the pending releases and the transfer message with a
+            // single FMQ write instead of one write per message.
+            std::vector<BufferStatusMessage> messages(numPending + 1);
+            auto it = pending.begin();
+            for (size_t i = 0; i < numPending; ++i, ++it) {
+                messages[i].newStatus = BufferStatus::NOT_USED;
+                messages[i].bufferId = *it;
+                messages[i].connectionId = connectionId;
             }
+            BufferStatusMessage &message = messages[numPending];
             message.transactionId = transactionId;
             message.bufferId = bufferId;
             message.newStatus = status;
@@ -206,12 +207,16 @@ bool BufferStatusChannel::postBufferStatusMessage(
             message.targetConnectionId = targetId;
             // TODO : timesatamp
             message.timestampUs = 0;
-            if (!mBufferStatusQueue->write(&message, 1)) {
+            if (!mBufferStatusQueue->write(messages.data(), numPending + 1)) {
                 // Since avaliable # of writes are already confirmed,
                 // this should not happen.
                 ALOGW("FMQ message cannot be sent from %lld", (long long)connectionId);
                 return false;
             }
+            for (size_t i = 0; i < numPending; ++i) {
+                posted.push_back(pending.front());
+                pending.pop_front();
+            }
             return true;
         }
     }
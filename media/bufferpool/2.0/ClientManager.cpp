@@ -110,6 +110,10 @@ public:
 
     ResultStatus flush(ConnectionId connectionId);
 
+    ResultStatus setEvictionPolicy(ConnectionId connectionId,
+                                   size_t maxUnusedBufferCount,
+                                   int64_t cleanUpDurationUs);
+
     ResultStatus allocate(ConnectionId connectionId,
                           const std::vector<uint8_t> &params,
                           native_handle_t **handle,
@@ -339,6 +343,21 @@ ResultStatus ClientManager::Impl::flush(ConnectionId connectionId) {
     return client->flush();
 }
 
+ResultStatus ClientManager::Impl::setEvictionPolicy(
+        ConnectionId connectionId, size_t maxUnusedBufferCount,
+        int64_t cleanUpDurationUs) {
+    std::shared_ptr<BufferPoolClient> client;
+    {
+        std::lock_guard<std::mutex> lock(mActive.mMutex);
+        auto it = mActive.mClients.find(connectionId);
+        if (it == mActive.mClients.end()) {
+            return ResultStatus::NOT_FOUND;
+        }
+        client = it->second;
+    }
+    return client->setEvictionPolicy(maxUnusedBufferCount, cleanUpDurationUs);
+}
+
 ResultStatus ClientManager::Impl::allocate(
         ConnectionId connectionId, const std::vector<uint8_t> &params,
         native_handle_t **handle, std::shared_ptr<BufferPoolData> *buffer) {
@@ -526,6 +545,16 @@ ResultStatus ClientManager::flush(ConnectionId connectionId) {
     return ResultStatus::CRITICAL_ERROR;
 }
 
+ResultStatus ClientManager::setEvictionPolicy(
+        ConnectionId connectionId, size_t maxUnusedBufferCount,
+        int64_t cleanUpDurationUs) {
+    if (mImpl) {
+        return mImpl->setEvictionPolicy(
+                connectionId, maxUnusedBufferCount, cleanUpDurationUs);
+    }
+    return ResultStatus::CRITICAL_ERROR;
+}
+
 ResultStatus ClientManager::allocate(
         ConnectionId connectionId, const std::vector<uint8_t> &params,
         native_handle_t **handle, std::shared_ptr<BufferPoolData> *buffer) {
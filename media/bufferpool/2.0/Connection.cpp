@@ -75,6 +75,14 @@ ResultStatus Connection::flush() {
     return ResultStatus::CRITICAL_ERROR;
 }
 
+ResultStatus Connection::setEvictionPolicy(
+        size_t maxUnusedBufferCount, int64_t cleanUpDurationUs) {
+    if (mInitialized && mAccessor) {
+        return mAccessor->setEvictionPolicy(maxUnusedBufferCount, cleanUpDurationUs);
+    }
+    return ResultStatus::CRITICAL_ERROR;
+}
+
 ResultStatus Connection::allocate(
         const std::vector<uint8_t> &params, BufferId *bufferId,
         const native_handle_t **handle) {
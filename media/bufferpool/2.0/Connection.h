@@ -48,6 +48,16 @@ struct Connection : public IConnection {
      */
     ResultStatus flush();
 
+    /**
+     * Adjusts the cache eviction watermarks of the attached buffer pool.
+     *
+     * @param maxUnusedBufferCount  # of unused buffers that triggers an
+     *                              eviction scan.
+     * @param cleanUpDurationUs     interval between periodic eviction scans.
+     */
+    ResultStatus setEvictionPolicy(
+            size_t maxUnusedBufferCount, int64_t cleanUpDurationUs);
+
     /**
      * Allocates a buffer using the specified parameters. Recycles a buffer if
      * it is possible. The returned buffer can be transferred to other remote
@@ -103,6 +103,25 @@ struct ClientManager : public IClientManager {
      */
     ResultStatus flush(ConnectionId connectionId);
 
+    /**
+     * Adjusts the cache eviction watermarks of the buffer pool that the
+     * specified connection owns. Only applicable to local connections made
+     * with create(); the wire interface to remote pools does not carry
+     * eviction policy.
+     *
+     * @param connectionId          The id of the connection.
+     * @param maxUnusedBufferCount  # of unused buffers that triggers an
+     *                              eviction scan.
+     * @param cleanUpDurationUs     interval between periodic eviction scans.
+     *
+     * @return OK when the eviction policy is applied.
+     *         NOT_FOUND when the specified connection was not found.
+     *         CRITICAL_ERROR otherwise.
+     */
+    ResultStatus setEvictionPolicy(ConnectionId connectionId,
+                                   size_t maxUnusedBufferCount,
+                                   int64_t cleanUpDurationUs);
+
     /**
      * Allocates a buffer from the specified connection. The output parameter
      * handle is cloned from the internal handle. So it is safe to use directly,
@@ -202,6 +202,13 @@ public:
                 .withConstValue(new C2StreamPixelFormatInfo::output(
                                      0u, HAL_PIXEL_FORMAT_YCBCR_420_888))
                 .build());
+
+        addParameter(
+                DefineParam(mThreadCount, C2_PARAMKEY_THREAD_COUNT)
+                .withDefault(new C2GlobalThreadCountTuning(0u))
+                .withFields({C2F(mThreadCount, value).inRange(0, MAX_NUM_CORES)})
+                .withSetter(Setter<decltype(*mThreadCount)>::StrictValueWithNoDeps)
+                .build());
     }
     static C2R SizeSetter(bool mayBlock, const C2P<C2StreamPictureSizeInfo::output> &oldMe,
                           C2P<C2StreamPictureSizeInfo::output> &me) {
@@ -296,6 +303,10 @@ public:
         return mColorAspects;
     }
 
+    uint32_t getThreadCount_l() const {
+        return mThreadCount->value;
+    }
+
 private:
     std::shared_ptr<C2StreamProfileLevelInfo::input> mProfileLevel;
     std::shared_ptr<C2StreamPictureSizeInfo::output> mSize;
@@ -306,6 +317,7 @@ private:
     std::shared_ptr<C2StreamColorAspectsTuning::output> mDefaultColorAspects;
     std::shared_ptr<C2StreamColorAspectsInfo::output> mColorAspects;
     std::shared_ptr<C2StreamPixelFormatInfo::output> mPixelFormat;
+    std::shared_ptr<C2GlobalThreadCountTuning> mThreadCount;
 };
 
 static size_t getCpuCoreCount() {
@@ -439,6 +451,12 @@ status_t C2SoftAvcDec::createDecoder() {
 }
 
 status_t C2SoftAvcDec::setNumCores() {
+    // A non-zero thread-count tuning overrides the core-count based default.
+    uint32_t requestedThreads = mIntf->getThreadCount_l();
+    mNumCores = requestedThreads > 0
+            ? MIN(requestedThreads, MAX_NUM_CORES)
+            : MIN(getCpuCoreCount(), MAX_NUM_CORES);
+
     ivdext_ctl_set_num_cores_ip_t s_set_num_cores_ip = {};
     ivdext_ctl_set_num_cores_op_t s_set_num_cores_op = {};
 
@@ -510,7 +528,6 @@ void C2SoftAvcDec::getVersion() {
 
 status_t C2SoftAvcDec::initDecoder() {
     if (OK != createDecoder()) return UNKNOWN_ERROR;
-    mNumCores = MIN(getCpuCoreCount(), MAX_NUM_CORES);
     mStride = ALIGN128(mWidth);
     mSignalledError = false;
     resetPlugin();
@@ -104,6 +104,13 @@ public:
                     C2Component::ATTRIB_IS_TEMPORAL))
                 .build());
 
+        addParameter(
+                DefineParam(mThreadCount, C2_PARAMKEY_THREAD_COUNT)
+                .withDefault(new C2GlobalThreadCountTuning(0u))
+                .withFields({C2F(mThreadCount, value).inRange(0, CODEC_MAX_CORES)})
+                .withSetter(Setter<decltype(*mThreadCount)>::StrictValueWithNoDeps)
+                .build());
+
         addParameter(
                 DefineParam(mSize, C2_PARAMKEY_PICTURE_SIZE)
                 .withDefault(new C2StreamPictureSizeInfo::input(0u, 16, 16))
@@ -543,6 +550,7 @@ public:
     std::shared_ptr<C2StreamColorAspectsInfo::output> getCodedColorAspects_l() const {
         return mCodedColorAspects;
     }
+    uint32_t getThreadCount_l() const { return mThreadCount->value; }
 
 private:
     std::shared_ptr<C2StreamUsageTuning::input> mUsage;
@@ -557,6 +565,7 @@ private:
     std::shared_ptr<C2StreamPictureQuantizationTuning::output> mPictureQuantization;
     std::shared_ptr<C2StreamColorAspectsInfo::input> mColorAspects;
     std::shared_ptr<C2StreamColorAspectsInfo::output> mCodedColorAspects;
+    std::shared_ptr<C2GlobalThreadCountTuning> mThreadCount;
 };
 
 #define ive_api_function  ih264e_api_function
@@ -1160,6 +1169,11 @@ c2_status_t C2SoftAvcEnc::initEncoder() {
         mIDRInterval = mIntf->getSyncFramePeriod_l();
         gop = mIntf->getGop_l();
         mColorAspects = mIntf->getCodedColorAspects_l();
+        // A non-zero thread-count tuning overrides the core-count default.
+        uint32_t requestedThreads = mIntf->getThreadCount_l();
+        if (requestedThreads > 0) {
+            mNumCores = requestedThreads;
+        }
     }
     if (gop && gop->flexCount() > 0) {
         uint32_t syncInterval = 1;
@@ -1182,6 +1196,16 @@ c2_status_t C2SoftAvcEnc::initEncoder() {
     uint32_t width = mSize->width;
     uint32_t height = mSize->height;
 
+    uint32_t numCores = MIN(mNumCores, CODEC_MAX_CORES);
+    if (numCores > 1 && mSliceMode == IVE_SLICE_MODE_NONE) {
+        // Cut the frame into one slice per core so the library's
+        // slice-parallel encode and deblock jobs can run concurrently
+        // instead of serializing on a single-slice frame.
+        uint32_t totalMbs = ((width + 15) >> 4) * ((height + 15) >> 4);
+        mSliceMode = IVE_SLICE_MODE_BLOCKS;
+        mSliceParam = (totalMbs + numCores - 1) / numCores;
+    }
+
     mStride = width;
 
     // Assume worst case output buffer size to be equal to number of bytes in input
@@ -180,6 +180,19 @@ SimpleInterface<void>::BaseParams::BaseParams(
             .withSetter(Setter<C2PortAllocatorsTuning::output>::NonStrictValuesWithNoDeps)
             .build());
 
+    // Decoders with graphic output advertise the bufferqueue allocator for
+    // surface output, so that when the client renders to a surface the
+    // framework hands out blocks dequeued straight from it and rendering a
+    // frame is a queueBuffer with no copy.
+    if (!isEncoder && rawBufferType == C2BufferData::GRAPHIC
+            && ((poolMask >> C2PlatformAllocatorStore::BUFFERQUEUE) & 1)) {
+        addParameter(
+                DefineParam(mOutputSurfaceAllocator, C2_PARAMKEY_OUTPUT_SURFACE_ALLOCATOR)
+                .withConstValue(new C2PortSurfaceAllocatorTuning::output(
+                        C2PlatformAllocatorStore::BUFFERQUEUE))
+                .build());
+    }
+
     addParameter(
             DefineParam(mOutputPoolIds, C2_PARAMKEY_OUTPUT_BLOCK_POOLS)
             .withDefault(C2PortBlockPoolsTuning::output::AllocShared(outputPoolIds))
@@ -168,6 +168,7 @@ public:
 
         std::shared_ptr<C2PortAllocatorsTuning::input> mInputAllocators;
         std::shared_ptr<C2PortAllocatorsTuning::output> mOutputAllocators;
+        std::shared_ptr<C2PortSurfaceAllocatorTuning::output> mOutputSurfaceAllocator;
         std::shared_ptr<C2PrivateAllocatorsTuning> mPrivateAllocators;
         std::shared_ptr<C2PortBlockPoolsTuning::output> mOutputPoolIds;
         std::shared_ptr<C2PrivateBlockPoolsTuning> mPrivatePoolIds;
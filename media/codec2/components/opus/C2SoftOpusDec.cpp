@@ -374,10 +374,15 @@ void C2SoftOpusDec::process(
     // other timestamp).
     if (work->input.ordinal.timestamp.peeku() == 0) mSamplesToDiscard = mCodecDelay;
 
+    // Batch decode: a work may carry several Opus packets, one per input
+    // buffer. Decoding them back to back into a single output block
+    // amortizes the per-work block allocation, mapping and completion
+    // overhead over the batch; a single-packet work behaves as before.
+    const size_t numPackets = work->input.buffers.size();
     std::shared_ptr<C2LinearBlock> block;
     C2MemoryUsage usage = { C2MemoryUsage::CPU_READ, C2MemoryUsage::CPU_WRITE };
     c2_status_t err = pool->fetchLinearBlock(
-                          kMaxNumSamplesPerBuffer * kMaxChannels * sizeof(int16_t),
+                          numPackets * kMaxNumSamplesPerBuffer * kMaxChannels * sizeof(int16_t),
                           usage, &block);
     if (err != C2_OK) {
         ALOGE("fetchLinearBlock for Output failed with status %d", err);
@@ -391,18 +396,38 @@ void C2SoftOpusDec::process(
         return;
     }
 
-    int numSamples = opus_multistream_decode(mDecoder,
-                                             data,
-                                             inSize,
-                                             reinterpret_cast<int16_t *> (wView.data()),
-                                             kMaxOpusOutputPacketSizeSamples,
-                                             0);
-    if (numSamples < 0) {
-        ALOGE("opus_multistream_decode returned numSamples %d", numSamples);
-        numSamples = 0;
-        mSignalledError = true;
-        work->result = C2_CORRUPTED;
-        return;
+    int numSamples = 0;
+    for (size_t i = 0; i < numPackets; ++i) {
+        C2ReadView pktView = mDummyReadView;
+        const uint8_t *pktData = data;
+        size_t pktSize = inSize;
+        if (i > 0) {
+            pktView = work->input.buffers[i]->data().linearBlocks().front().map().get();
+            pktSize = pktView.capacity();
+            if (pktSize == 0) {
+                continue;
+            }
+            if (pktView.error()) {
+                ALOGE("read view map failed %d", pktView.error());
+                work->result = C2_CORRUPTED;
+                return;
+            }
+            pktData = pktView.data();
+        }
+        int ret = opus_multistream_decode(
+                mDecoder,
+                pktData,
+                pktSize,
+                reinterpret_cast<int16_t *> (wView.data()) + numSamples * mHeader.channels,
+                kMaxOpusOutputPacketSizeSamples,
+                0);
+        if (ret < 0) {
+            ALOGE("opus_multistream_decode returned %d", ret);
+            mSignalledError = true;
+            work->result = C2_CORRUPTED;
+            return;
+        }
+        numSamples += ret;
     }
 
     int outOffset = 0;
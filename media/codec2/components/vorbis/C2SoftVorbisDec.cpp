@@ -350,41 +350,13 @@ void C2SoftVorbisDec::process(
         return;
     }
 
-    int32_t numPageFrames = 0;
-    if (inSize < sizeof(numPageFrames)) {
-        ALOGE("input header has size %zu, expected %zu", inSize, sizeof(numPageFrames));
-        mSignalledError = true;
-        work->result = C2_CORRUPTED;
-        return;
-    }
-    memcpy(&numPageFrames, data + inSize - sizeof(numPageFrames), sizeof(numPageFrames));
-    inSize -= sizeof(numPageFrames);
-    if (numPageFrames >= 0) {
-        mNumFramesLeftOnPage = numPageFrames;
-    }
-
-    ogg_buffer buf;
-    buf.data = const_cast<unsigned char*>(data);
-    buf.size = inSize;
-    buf.refcount = 1;
-    buf.ptr.owner = nullptr;
-
-    ogg_reference ref;
-    ref.buffer = &buf;
-    ref.begin = 0;
-    ref.length = buf.size;
-    ref.next = nullptr;
-
-    ogg_packet pack;
-    pack.packet = &ref;
-    pack.bytes = ref.length;
-    pack.b_o_s = 0;
-    pack.e_o_s = 0;
-    pack.granulepos = 0;
-    pack.packetno = 0;
-
-    size_t maxSamplesInBuffer = kMaxNumSamplesPerChannel * mVi->channels;
-    size_t outCapacity =  maxSamplesInBuffer * sizeof(int16_t);
+    // Batch decode: a work may carry several Vorbis packets, one per input
+    // buffer, each with its own numPageFrames trailer. Decoding them back to
+    // back into a single output block amortizes the per-work block
+    // allocation, mapping and completion overhead over the batch; a
+    // single-packet work behaves as before.
+    const size_t numPackets = work->input.buffers.size();
+    size_t outCapacity = numPackets * kMaxNumSamplesPerChannel * mVi->channels * sizeof(int16_t);
     std::shared_ptr<C2LinearBlock> block;
     C2MemoryUsage usage = { C2MemoryUsage::CPU_READ, C2MemoryUsage::CPU_WRITE };
     c2_status_t err = pool->fetchLinearBlock(outCapacity, usage, &block);
@@ -400,30 +372,85 @@ void C2SoftVorbisDec::process(
         return;
     }
 
-    int numFrames = 0;
-    int ret = vorbis_dsp_synthesis(mState, &pack, 1);
-    if (0 != ret) {
-        ALOGD("vorbis_dsp_synthesis returned %d; ignored", ret);
-    } else {
-        numFrames = vorbis_dsp_pcmout(
-                mState,  reinterpret_cast<int16_t *> (wView.data()),
-                kMaxNumSamplesPerChannel);
-        if (numFrames < 0) {
-            ALOGD("vorbis_dsp_pcmout returned %d", numFrames);
-            numFrames = 0;
+    int totalFrames = 0;
+    for (size_t i = 0; i < numPackets; ++i) {
+        C2ReadView pktView = mDummyReadView;
+        const uint8_t *pktData = data;
+        size_t pktSize = inSize;
+        if (i > 0) {
+            pktView = work->input.buffers[i]->data().linearBlocks().front().map().get();
+            pktSize = pktView.capacity();
+            if (pktSize == 0) {
+                continue;
+            }
+            if (pktView.error()) {
+                ALOGE("read view map failed %d", pktView.error());
+                work->result = pktView.error();
+                return;
+            }
+            pktData = pktView.data();
         }
-    }
 
-    if (mNumFramesLeftOnPage >= 0) {
-        if (numFrames > mNumFramesLeftOnPage) {
-            ALOGV("discarding %d frames at end of page", numFrames - mNumFramesLeftOnPage);
-            numFrames = mNumFramesLeftOnPage;
+        int32_t numPageFrames = 0;
+        if (pktSize < sizeof(numPageFrames)) {
+            ALOGE("input header has size %zu, expected %zu", pktSize, sizeof(numPageFrames));
+            mSignalledError = true;
+            work->result = C2_CORRUPTED;
+            return;
+        }
+        memcpy(&numPageFrames, pktData + pktSize - sizeof(numPageFrames), sizeof(numPageFrames));
+        pktSize -= sizeof(numPageFrames);
+        if (numPageFrames >= 0) {
+            mNumFramesLeftOnPage = numPageFrames;
+        }
+
+        ogg_buffer buf;
+        buf.data = const_cast<unsigned char*>(pktData);
+        buf.size = pktSize;
+        buf.refcount = 1;
+        buf.ptr.owner = nullptr;
+
+        ogg_reference ref;
+        ref.buffer = &buf;
+        ref.begin = 0;
+        ref.length = buf.size;
+        ref.next = nullptr;
+
+        ogg_packet pack;
+        pack.packet = &ref;
+        pack.bytes = ref.length;
+        pack.b_o_s = 0;
+        pack.e_o_s = 0;
+        pack.granulepos = 0;
+        pack.packetno = 0;
+
+        int numFrames = 0;
+        int ret = vorbis_dsp_synthesis(mState, &pack, 1);
+        if (0 != ret) {
+            ALOGD("vorbis_dsp_synthesis returned %d; ignored", ret);
+        } else {
+            numFrames = vorbis_dsp_pcmout(
+                    mState,
+                    reinterpret_cast<int16_t *> (wView.data()) + totalFrames * mVi->channels,
+                    kMaxNumSamplesPerChannel);
+            if (numFrames < 0) {
+                ALOGD("vorbis_dsp_pcmout returned %d", numFrames);
+                numFrames = 0;
+            }
+        }
+
+        if (mNumFramesLeftOnPage >= 0) {
+            if (numFrames > mNumFramesLeftOnPage) {
+                ALOGV("discarding %d frames at end of page", numFrames - mNumFramesLeftOnPage);
+                numFrames = mNumFramesLeftOnPage;
+            }
+            mNumFramesLeftOnPage -= numFrames;
         }
-        mNumFramesLeftOnPage -= numFrames;
+        totalFrames += numFrames;
     }
 
-    if (numFrames) {
-        int outSize = numFrames * sizeof(int16_t) * mVi->channels;
+    if (totalFrames) {
+        int outSize = totalFrames * sizeof(int16_t) * mVi->channels;
 
         work->worklets.front()->output.flags = work->input.flags;
         work->worklets.front()->output.buffers.clear();
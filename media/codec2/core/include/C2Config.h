@@ -284,6 +284,9 @@ enum C2ParamIndexKind : C2Param::type_index_t {
 
     // allow tunnel peek behavior to be unspecified for app compatibility
     kParamIndexTunnelPeekMode, // tunnel mode, enum
+
+    // number of worker threads used by software codecs
+    kParamIndexThreadCount, // uint32
 };
 
 }
@@ -890,6 +893,17 @@ typedef C2GlobalParam<C2Tuning, C2EasyBoolValue, kParamIndexLowLatencyMode>
         C2GlobalLowLatencyModeTuning;
 constexpr char C2_PARAMKEY_LOW_LATENCY_MODE[] = "algo.low-latency";
 
+/**
+ * Number of worker threads used by software codecs.
+ *
+ * A value of 0 (the default) lets the component scale to the number of online
+ * CPU cores, capped by whatever limit the underlying codec library has.
+ * Hardware components ignore this tuning.
+ */
+typedef C2GlobalParam<C2Tuning, C2Uint32Value, kParamIndexThreadCount>
+        C2GlobalThreadCountTuning;
+constexpr char C2_PARAMKEY_THREAD_COUNT[] = "algo.thread-count";
+
 /**
  * Reference characteristics.
  *
@@ -94,6 +94,16 @@ struct Component::Listener : public C2Component::Listener {
     virtual void onWorkDone_nb(
             std::weak_ptr<C2Component> /* c2component */,
             std::list<std::unique_ptr<C2Work>> c2workItems) override {
+        sp<Component> strongComponent = mComponent.promote();
+        if (strongComponent) {
+            int64_t nowNs = systemTime(SYSTEM_TIME_MONOTONIC);
+            for (const std::unique_ptr<C2Work>& work : c2workItems) {
+                if (work) {
+                    strongComponent->mWorkTimingRing.recordDone(
+                            work->input.ordinal.frameIndex.peeku(), nowNs);
+                }
+            }
+        }
         for (const std::unique_ptr<C2Work>& work : c2workItems) {
             if (work) {
                 if (work->worklets.empty()
@@ -110,7 +120,6 @@ struct Component::Listener : public C2Component::Listener {
         if (listener) {
             WorkBundle workBundle;
 
-            sp<Component> strongComponent = mComponent.promote();
             beginTransferBufferQueueBlocks(c2workItems, true);
             if (!objcpy(&workBundle, c2workItems, strongComponent ?
                     &strongComponent->mBufferPoolSender : nullptr)) {
@@ -238,7 +247,24 @@ Return<Status> Component::queue(const WorkBundle& workBundle) {
         }
     }
 
-    return static_cast<Status>(mComponent->queue_nb(&c2works));
+    // Record HAL ingress times before the component consumes the list.
+    std::vector<size_t> timingTokens;
+    timingTokens.reserve(c2works.size());
+    int64_t nowNs = systemTime(SYSTEM_TIME_MONOTONIC);
+    for (const std::unique_ptr<C2Work>& work : c2works) {
+        if (work) {
+            timingTokens.push_back(mWorkTimingRing.recordQueued(
+                    work->input.ordinal.frameIndex.peeku(), nowNs));
+        }
+    }
+
+    Status status = static_cast<Status>(mComponent->queue_nb(&c2works));
+
+    nowNs = systemTime(SYSTEM_TIME_MONOTONIC);
+    for (size_t token : timingTokens) {
+        mWorkTimingRing.recordAccepted(token, nowNs);
+    }
+    return status;
 }
 
 Return<void> Component::flush(flush_cb _hidl_cb) {
@@ -466,7 +466,9 @@ Return<void> ComponentStore::debug(
                 out << indent << indent << "NONE" << std::endl << std::endl;
             } else {
                 for (auto& pair : mComponentRoster) {
-                    dump(out, pair.second) << std::endl;
+                    dump(out, pair.second);
+                    pair.first->mWorkTimingRing.dump(out, "    ");
+                    out << std::endl;
                 }
             }
         }
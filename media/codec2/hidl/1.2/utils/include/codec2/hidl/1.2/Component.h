@@ -31,6 +31,7 @@
 
 #include <C2Component.h>
 #include <C2Buffer.h>
+#include <C2WorkTimingRing.h>
 #include <C2.h>
 
 #include <map>
@@ -125,6 +126,10 @@ protected:
     ::android::hardware::media::c2::V1_2::utils::DefaultBufferPoolSender
             mBufferPoolSender;
 
+    // Per-work lifecycle timestamps (HAL ingress, component accept,
+    // work done); dumped by ComponentStore::debug().
+    C2WorkTimingRing mWorkTimingRing;
+
     struct Sink;
     std::mutex mSinkMutex;
     sp<Sink> mSink;
@@ -48,6 +48,7 @@
 #include <media/stagefright/foundation/ADebug.h> // for asString(status_t)
 
 
+#include <chrono>
 #include <deque>
 #include <iterator>
 #include <limits>
@@ -1284,6 +1285,14 @@ Codec2Client::Component::Component(const sp<Base1_2>& base)
 }
 
 Codec2Client::Component::~Component() {
+    {
+        std::unique_lock<std::mutex> lock(mQueueMutex);
+        mQueueFlusherStop = true;
+        mQueueCondition.notify_all();
+    }
+    if (mQueueFlusher.joinable()) {
+        mQueueFlusher.join();
+    }
 }
 
 c2_status_t Codec2Client::Component::createBlockPool(
@@ -1331,7 +1340,16 @@ void Codec2Client::Component::handleOnWorkDone(
     mOutputBufferQueue->holdBufferQueueBlocks(workItems);
 }
 
-c2_status_t Codec2Client::Component::queue(
+namespace {
+
+int64_t GetMonotonicTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // unnamed namespace
+
+c2_status_t Codec2Client::Component::queueToComponent(
         std::list<std::unique_ptr<C2Work>>* const items) {
     WorkBundle workBundle;
     if (!objcpy(&workBundle, *items, mBufferPoolSender.get())) {
@@ -1351,10 +1369,86 @@ c2_status_t Codec2Client::Component::queue(
     return status;
 }
 
+c2_status_t Codec2Client::Component::queue(
+        std::list<std::unique_ptr<C2Work>>* const items) {
+    {
+        std::unique_lock<std::mutex> lock(mQueueMutex);
+        if (mQueueBatchMaxWorks > 1) {
+            if (mPendingWorks.empty()) {
+                mQueueBatchDeadlineNs =
+                        GetMonotonicTimeNs() + mQueueBatchTimeoutUs * 1000;
+            }
+            mPendingWorks.splice(mPendingWorks.end(), *items);
+            if (mPendingWorks.size() < mQueueBatchMaxWorks) {
+                // The flusher thread sends the batch once the deadline
+                // passes. Transaction errors for batched works surface
+                // through the component's onError() callback.
+                mQueueCondition.notify_all();
+                return C2_OK;
+            }
+            items->splice(items->end(), mPendingWorks);
+        }
+    }
+    return queueToComponent(items);
+}
+
+void Codec2Client::Component::setWorkBatching(
+        size_t maxWorks, int64_t timeoutUs) {
+    std::list<std::unique_ptr<C2Work>> pending;
+    {
+        std::unique_lock<std::mutex> lock(mQueueMutex);
+        mQueueBatchMaxWorks = maxWorks;
+        mQueueBatchTimeoutUs = timeoutUs;
+        if (maxWorks > 1 && !mQueueFlusher.joinable()) {
+            mQueueFlusher = std::thread([this]() { queueFlusherLoop(); });
+        }
+        pending.splice(pending.end(), mPendingWorks);
+    }
+    if (!pending.empty()) {
+        (void)queueToComponent(&pending);
+    }
+}
+
+void Codec2Client::Component::queuePendingWorks() {
+    std::list<std::unique_ptr<C2Work>> pending;
+    {
+        std::unique_lock<std::mutex> lock(mQueueMutex);
+        if (mPendingWorks.empty()) {
+            return;
+        }
+        pending.splice(pending.end(), mPendingWorks);
+    }
+    (void)queueToComponent(&pending);
+}
+
+void Codec2Client::Component::queueFlusherLoop() {
+    std::unique_lock<std::mutex> lock(mQueueMutex);
+    while (!mQueueFlusherStop) {
+        if (mPendingWorks.empty()) {
+            mQueueCondition.wait(lock);
+            continue;
+        }
+        int64_t nowNs = GetMonotonicTimeNs();
+        if (nowNs < mQueueBatchDeadlineNs) {
+            mQueueCondition.wait_for(
+                    lock,
+                    std::chrono::nanoseconds(mQueueBatchDeadlineNs - nowNs));
+            continue;
+        }
+        std::list<std::unique_ptr<C2Work>> pending;
+        pending.splice(pending.end(), mPendingWorks);
+        lock.unlock();
+        (void)queueToComponent(&pending);
+        lock.lock();
+    }
+}
+
 c2_status_t Codec2Client::Component::flush(
         C2Component::flush_mode_t mode,
         std::list<std::unique_ptr<C2Work>>* const flushedWork) {
     (void)mode; // Flush mode isn't supported in HIDL yet.
+    // Submit batched works first so that they are flushed as well.
+    queuePendingWorks();
     c2_status_t status;
     Return<void> transStatus = mBase1_0->flush(
             [&status, flushedWork](
@@ -1397,6 +1491,8 @@ c2_status_t Codec2Client::Component::flush(
 }
 
 c2_status_t Codec2Client::Component::drain(C2Component::drain_mode_t mode) {
+    // Submit batched works first so that draining covers them.
+    queuePendingWorks();
     Return<Status> transStatus = mBase1_0->drain(
             mode == C2Component::DRAIN_COMPONENT_WITH_EOS);
     if (!transStatus.isOk()) {
@@ -1426,6 +1522,7 @@ c2_status_t Codec2Client::Component::start() {
 }
 
 c2_status_t Codec2Client::Component::stop() {
+    queuePendingWorks();
     Return<Status> transStatus = mBase1_0->stop();
     if (!transStatus.isOk()) {
         LOG(ERROR) << "stop -- transaction failed.";
@@ -1440,6 +1537,7 @@ c2_status_t Codec2Client::Component::stop() {
 }
 
 c2_status_t Codec2Client::Component::reset() {
+    queuePendingWorks();
     Return<Status> transStatus = mBase1_0->reset();
     if (!transStatus.isOk()) {
         LOG(ERROR) << "reset -- transaction failed.";
@@ -1454,6 +1552,11 @@ c2_status_t Codec2Client::Component::reset() {
 }
 
 c2_status_t Codec2Client::Component::release() {
+    {
+        // Works batched but not yet submitted are dropped on release.
+        std::unique_lock<std::mutex> lock(mQueueMutex);
+        mPendingWorks.clear();
+    }
     Return<Status> transStatus = mBase1_0->release();
     if (!transStatus.isOk()) {
         LOG(ERROR) << "release -- transaction failed.";
@@ -27,10 +27,13 @@
 #include <hidl/HidlSupport.h>
 #include <utils/StrongPointer.h>
 
+#include <condition_variable>
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 /**
  * This file contains minimal interfaces for the framework to access Codec2.0.
@@ -345,6 +348,17 @@ struct Codec2Client::Component : public Codec2Client::Configurable {
     c2_status_t queue(
             std::list<std::unique_ptr<C2Work>>* const items);
 
+    // Configure client-side coalescing of queue() calls.
+    //
+    // While enabled, works handed to queue() are accumulated and sent to the
+    // component as a single WorkBundle once maxWorks items are pending or the
+    // batch is timeoutUs old, whichever comes first, amortizing the
+    // per-transaction cost of crossing the HAL boundary in high-rate
+    // sessions. flush(), drain() and component state changes submit any
+    // pending works first, so work ordering is preserved. Batching is off by
+    // default; maxWorks of 0 or 1 turns it off.
+    void setWorkBatching(size_t maxWorks, int64_t timeoutUs);
+
     c2_status_t flush(
             C2Component::flush_mode_t mode,
             std::list<std::unique_ptr<C2Work>>* const flushedWork);
@@ -455,6 +469,24 @@ protected:
     // In order to prevent the race condition mutex is added.
     std::mutex mOutputMutex;
 
+    // Work batching state; see setWorkBatching().
+    std::mutex mQueueMutex;
+    std::condition_variable mQueueCondition;
+    std::list<std::unique_ptr<C2Work>> mPendingWorks;
+    size_t mQueueBatchMaxWorks{0};
+    int64_t mQueueBatchTimeoutUs{0};
+    int64_t mQueueBatchDeadlineNs{0};
+    bool mQueueFlusherStop{false};
+    std::thread mQueueFlusher;
+
+    // Sends works to the component without batching.
+    c2_status_t queueToComponent(
+            std::list<std::unique_ptr<C2Work>>* const items);
+    // Submits any batched works immediately.
+    void queuePendingWorks();
+    // Deadline watcher for batched works.
+    void queueFlusherLoop();
+
     static c2_status_t setDeathListener(
             const std::shared_ptr<Component>& component,
             const std::shared_ptr<Listener>& listener);
@@ -26,6 +26,7 @@
 #include <C2BlockInternal.h>
 #include <C2Component.h>
 #include <C2Config.h>
+#include <C2FenceFactory.h>
 #include <C2PlatformSupport.h>
 
 #include <OMX_Component.h>
@@ -131,7 +132,13 @@ protected:
                 }
 
                 jobs.unlock();
+                // fences attached to buffers travel with the work; only fds
+                // that had no buffer to carry them (EOS-only work) are left
+                // to wait on here
                 for (int fenceFd : fenceFds) {
+                    if (fenceFd < 0) {
+                        continue;
+                    }
                     sp<Fence> fence(new Fence(fenceFd));
                     fence->waitForever(LOG_TAG);
                 }
@@ -463,9 +470,17 @@ status_t C2OMXNode::emptyBuffer(
     work->input.ordinal.frameIndex = mFrameIndex++;
     work->input.buffers.clear();
     if (block) {
+        C2Fence c2Fence;
+        if (fenceFd >= 0) {
+            // Forward the acquire fence with the buffer instead of blocking the
+            // queuing thread on it; the component waits only when it actually
+            // accesses the buffer.
+            c2Fence = _C2FenceFactory::CreateSyncFence(fenceFd);
+            fenceFd = -1;
+        }
         std::shared_ptr<C2Buffer> c2Buffer(
                 new Buffer2D(block->share(
-                        C2Rect(block->width(), block->height()), ::C2Fence())));
+                        C2Rect(block->width(), block->height()), c2Fence)));
         work->input.buffers.push_back(c2Buffer);
         std::shared_ptr<C2StreamHdrStaticInfo::input> staticInfo;
         std::shared_ptr<C2StreamHdrDynamicMetadataInfo::input> dynamicInfo;
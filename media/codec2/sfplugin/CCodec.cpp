@@ -888,6 +888,20 @@ void CCodec::configure(const sp<AMessage> &msg) {
         ALOGD("[%s] buffers are %sbound to CCodec for this session",
               comp->getName().c_str(), config->mBuffersBoundToCodec ? "" : "not ");
 
+        // Client-side coalescing of work submissions across the HAL boundary,
+        // tunable separately per component kind for high-rate sessions.
+        {
+            int32_t batchWorks = property_get_int32(
+                    encoder ? "debug.stagefright.ccodec_batch_works_enc"
+                            : "debug.stagefright.ccodec_batch_works_dec", 0);
+            int32_t batchTimeoutUs = property_get_int32(
+                    encoder ? "debug.stagefright.ccodec_batch_timeout_us_enc"
+                            : "debug.stagefright.ccodec_batch_timeout_us_dec", 1000);
+            if (batchWorks > 1 && batchTimeoutUs > 0) {
+                comp->setWorkBatching(batchWorks, batchTimeoutUs);
+            }
+        }
+
         // Enforce required parameters
         int32_t i32;
         float flt;
@@ -346,10 +346,9 @@ status_t CCodecBufferChannel::queueInputBufferInternal(
         ScopedTrace trace(ATRACE_TAG, android::base::StringPrintf(
                 "CCodecBufferChannel::queue(%s@ts=%lld)", mName, (long long)timeUs).c_str());
         {
-            Mutexed<PipelineWatcher>::Locked watcher(mPipelineWatcher);
             PipelineWatcher::Clock::time_point now = PipelineWatcher::Clock::now();
             for (const std::unique_ptr<C2Work> &work : items) {
-                watcher->onWorkQueued(
+                mPipelineWatcher.onWorkQueued(
                         work->input.ordinal.frameIndex.peeku(),
                         std::vector(work->input.buffers),
                         now);
@@ -358,9 +357,8 @@ status_t CCodecBufferChannel::queueInputBufferInternal(
         err = mComponent->queue(&items);
     }
     if (err != C2_OK) {
-        Mutexed<PipelineWatcher>::Locked watcher(mPipelineWatcher);
         for (const std::unique_ptr<C2Work> &work : items) {
-            watcher->onWorkDone(work->input.ordinal.frameIndex.peeku());
+            mPipelineWatcher.onWorkDone(work->input.ordinal.frameIndex.peeku());
         }
     } else {
         Mutexed<Input>::Locked input(mInput);
@@ -767,7 +765,7 @@ void CCodecBufferChannel::feedInputBufferIfAvailableInternal() {
     size_t numActiveSlots = 0;
     size_t pipelineRoom = 0;
     size_t numInputBuffersAvailable = 0;
-    while (!mPipelineWatcher.lock()->pipelineFull(&pipelineRoom)) {
+    while (!mPipelineWatcher.pipelineFull(&pipelineRoom)) {
         sp<MediaCodecBuffer> inBuffer;
         size_t index;
         {
@@ -1326,6 +1324,10 @@ status_t CCodecBufferChannel::start(
         int maxDequeueCount = 0;
         {
             Mutexed<OutputSurface>::Locked output(mOutputSurface);
+            output->lastOutputAtNs = 0;
+            output->avgIntervalNs = 0;
+            output->avgJitterNs = 0;
+            output->tunedExtraDequeueBuffers = 0;
             maxDequeueCount = output->maxDequeueBuffers = numOutputSlots +
                     reorderDepth.value + kRenderingDepth;
             outputSurface = output->surface ?
@@ -1528,12 +1530,11 @@ status_t CCodecBufferChannel::start(
     // newly initialized pipeline capacity.
 
     if (inputFormat || outputFormat) {
-        Mutexed<PipelineWatcher>::Locked watcher(mPipelineWatcher);
-        watcher->inputDelay(inputDelayValue)
+        mPipelineWatcher.inputDelay(inputDelayValue)
                 .pipelineDelay(pipelineDelayValue)
                 .outputDelay(outputDelayValue)
                 .smoothnessFactor(kSmoothnessFactor);
-        watcher->flush();
+        mPipelineWatcher.flush();
     }
 
     mInputMetEos = false;
@@ -1587,10 +1588,9 @@ status_t CCodecBufferChannel::requestInitialInputBuffers(
     mFlushedConfigs.lock()->swap(flushedConfigs);
     if (!flushedConfigs.empty()) {
         {
-            Mutexed<PipelineWatcher>::Locked watcher(mPipelineWatcher);
             PipelineWatcher::Clock::time_point now = PipelineWatcher::Clock::now();
             for (const std::unique_ptr<C2Work> &work : flushedConfigs) {
-                watcher->onWorkQueued(
+                mPipelineWatcher.onWorkQueued(
                         work->input.ordinal.frameIndex.peeku(),
                         std::vector(work->input.buffers),
                         now);
@@ -1662,7 +1662,7 @@ void CCodecBufferChannel::reset() {
     if (mInputSurface != nullptr) {
         mInputSurface.reset();
     }
-    mPipelineWatcher.lock()->flush();
+    mPipelineWatcher.flush();
     {
         Mutexed<Input>::Locked input(mInput);
         input->buffers.reset(new DummyInputBuffers(""));
@@ -1691,41 +1691,39 @@ void CCodecBufferChannel::flush(const std::list<std::unique_ptr<C2Work>> &flushe
     ALOGV("[%s] flush", mName);
     std::list<std::unique_ptr<C2Work>> configs;
     mInput.lock()->lastFlushIndex = mFrameIndex.load(std::memory_order_relaxed);
-    {
-        Mutexed<PipelineWatcher>::Locked watcher(mPipelineWatcher);
-        for (const std::unique_ptr<C2Work> &work : flushedWork) {
-            uint64_t frameIndex = work->input.ordinal.frameIndex.peeku();
-            if (!(work->input.flags & C2FrameData::FLAG_CODEC_CONFIG)) {
-                watcher->onWorkDone(frameIndex);
-                continue;
-            }
-            if (work->input.buffers.empty()
-                    || work->input.buffers.front() == nullptr
-                    || work->input.buffers.front()->data().linearBlocks().empty()) {
-                ALOGD("[%s] no linear codec config data found", mName);
-                watcher->onWorkDone(frameIndex);
-                continue;
-            }
-            std::unique_ptr<C2Work> copy(new C2Work);
-            copy->input.flags = C2FrameData::flags_t(
-                    work->input.flags | C2FrameData::FLAG_DROP_FRAME);
-            copy->input.ordinal = work->input.ordinal;
-            copy->input.ordinal.frameIndex = mFrameIndex++;
-            for (size_t i = 0; i < work->input.buffers.size(); ++i) {
-                copy->input.buffers.push_back(watcher->onInputBufferReleased(frameIndex, i));
-            }
-            for (const std::unique_ptr<C2Param> &param : work->input.configUpdate) {
-                copy->input.configUpdate.push_back(C2Param::Copy(*param));
-            }
-            copy->input.infoBuffers.insert(
-                    copy->input.infoBuffers.begin(),
-                    work->input.infoBuffers.begin(),
-                    work->input.infoBuffers.end());
-            copy->worklets.emplace_back(new C2Worklet);
-            configs.push_back(std::move(copy));
-            watcher->onWorkDone(frameIndex);
-            ALOGV("[%s] stashed flushed codec config data", mName);
-        }
+    for (const std::unique_ptr<C2Work> &work : flushedWork) {
+        uint64_t frameIndex = work->input.ordinal.frameIndex.peeku();
+        if (!(work->input.flags & C2FrameData::FLAG_CODEC_CONFIG)) {
+            mPipelineWatcher.onWorkDone(frameIndex);
+            continue;
+        }
+        if (work->input.buffers.empty()
+                || work->input.buffers.front() == nullptr
+                || work->input.buffers.front()->data().linearBlocks().empty()) {
+            ALOGD("[%s] no linear codec config data found", mName);
+            mPipelineWatcher.onWorkDone(frameIndex);
+            continue;
+        }
+        std::unique_ptr<C2Work> copy(new C2Work);
+        copy->input.flags = C2FrameData::flags_t(
+                work->input.flags | C2FrameData::FLAG_DROP_FRAME);
+        copy->input.ordinal = work->input.ordinal;
+        copy->input.ordinal.frameIndex = mFrameIndex++;
+        for (size_t i = 0; i < work->input.buffers.size(); ++i) {
+            copy->input.buffers.push_back(
+                    mPipelineWatcher.onInputBufferReleased(frameIndex, i));
+        }
+        for (const std::unique_ptr<C2Param> &param : work->input.configUpdate) {
+            copy->input.configUpdate.push_back(C2Param::Copy(*param));
+        }
+        copy->input.infoBuffers.insert(
+                copy->input.infoBuffers.begin(),
+                work->input.infoBuffers.begin(),
+                work->input.infoBuffers.end());
+        copy->worklets.emplace_back(new C2Worklet);
+        configs.push_back(std::move(copy));
+        mPipelineWatcher.onWorkDone(frameIndex);
+        ALOGV("[%s] stashed flushed codec config data", mName);
     }
     mFlushedConfigs.lock()->swap(configs);
     {
@@ -1756,7 +1754,7 @@ void CCodecBufferChannel::onInputBufferDone(
         return;
     }
     std::shared_ptr<C2Buffer> buffer =
-            mPipelineWatcher.lock()->onInputBufferReleased(frameIndex, arrayIndex);
+            mPipelineWatcher.onInputBufferReleased(frameIndex, arrayIndex);
     bool newInputSlotAvailable = false;
     {
         Mutexed<Input>::Locked input(mInput);
@@ -1816,7 +1814,7 @@ bool CCodecBufferChannel::handleWork(
             || !work->worklets.front()
             || !(work->worklets.front()->output.flags &
                  C2FrameData::FLAG_INCOMPLETE))) {
-        mPipelineWatcher.lock()->onWorkDone(
+        mPipelineWatcher.onWorkDone(
                 work->input.ordinal.frameIndex.peeku());
     }
 
@@ -1847,6 +1845,40 @@ bool CCodecBufferChannel::handleWork(
     std::optional<uint32_t> newInputDelay, newPipelineDelay, newOutputDelay, newReorderDepth;
     std::optional<C2Config::ordinal_key_t> newReorderKey;
     bool needMaxDequeueBufferCountUpdate = false;
+    if (buffer && buffer->data().type() == C2BufferData::GRAPHIC) {
+        // Autotune the max dequeued buffer count from measured decode jitter:
+        // when outputs arrive in bursts relative to the mean output interval,
+        // that many extra dequeued buffers are needed for the bursts to be
+        // absorbed without blocking the component in the block pool. Only ever
+        // grows within a session; reset on the next configure.
+        Mutexed<OutputSurface>::Locked output(mOutputSurface);
+        nsecs_t nowNs = systemTime(SYSTEM_TIME_MONOTONIC);
+        if (output->lastOutputAtNs != 0) {
+            int64_t intervalNs = nowNs - output->lastOutputAtNs;
+            if (output->avgIntervalNs == 0) {
+                output->avgIntervalNs = intervalNs;
+            }
+            int64_t deviationNs = intervalNs > output->avgIntervalNs
+                    ? intervalNs - output->avgIntervalNs
+                    : output->avgIntervalNs - intervalNs;
+            output->avgIntervalNs += (intervalNs - output->avgIntervalNs) / 8;
+            output->avgJitterNs += (deviationNs - output->avgJitterNs) / 8;
+            if (output->avgIntervalNs > 0) {
+                int extra = int(c2_min<int64_t>(
+                        (output->avgJitterNs + output->avgIntervalNs - 1) / output->avgIntervalNs,
+                        kSmoothnessFactor));
+                if (extra > output->tunedExtraDequeueBuffers) {
+                    ALOGV("[%s] onWorkDone: raising extra dequeue buffers to %d "
+                          "(avg interval %lldns, avg jitter %lldns)",
+                          mName, extra,
+                          (long long)output->avgIntervalNs, (long long)output->avgJitterNs);
+                    output->tunedExtraDequeueBuffers = extra;
+                    needMaxDequeueBufferCountUpdate = true;
+                }
+            }
+        }
+        output->lastOutputAtNs = nowNs;
+    }
     while (!worklet->output.configUpdate.empty()) {
         std::unique_ptr<C2Param> param;
         worklet->output.configUpdate.back().swap(param);
@@ -1883,7 +1915,7 @@ bool CCodecBufferChannel::handleWork(
                         ALOGV("[%s] onWorkDone: updating pipeline delay %u",
                               mName, pipelineDelay.value);
                         newPipelineDelay = pipelineDelay.value;
-                        (void)mPipelineWatcher.lock()->pipelineDelay(
+                        (void)mPipelineWatcher.pipelineDelay(
                                 pipelineDelay.value);
                     }
                 }
@@ -1893,7 +1925,7 @@ bool CCodecBufferChannel::handleWork(
                         ALOGV("[%s] onWorkDone: updating input delay %u",
                               mName, inputDelay.value);
                         newInputDelay = inputDelay.value;
-                        (void)mPipelineWatcher.lock()->inputDelay(
+                        (void)mPipelineWatcher.inputDelay(
                                 inputDelay.value);
                     }
                 }
@@ -1902,7 +1934,7 @@ bool CCodecBufferChannel::handleWork(
                     if (outputDelay.updateFrom(*param)) {
                         ALOGV("[%s] onWorkDone: updating output delay %u",
                               mName, outputDelay.value);
-                        (void)mPipelineWatcher.lock()->outputDelay(outputDelay.value);
+                        (void)mPipelineWatcher.outputDelay(outputDelay.value);
                         newOutputDelay = outputDelay.value;
                         needMaxDequeueBufferCountUpdate = true;
 
@@ -1996,7 +2028,8 @@ bool CCodecBufferChannel::handleWork(
         {
             Mutexed<OutputSurface>::Locked output(mOutputSurface);
             maxDequeueCount = output->maxDequeueBuffers =
-                    numOutputSlots + reorderDepth + kRenderingDepth;
+                    numOutputSlots + reorderDepth + kRenderingDepth
+                    + output->tunedExtraDequeueBuffers;
             if (output->surface) {
                 output->surface->setMaxDequeuedBufferCount(output->maxDequeueBuffers);
             }
@@ -2230,7 +2263,7 @@ PipelineWatcher::Clock::duration CCodecBufferChannel::elapsed() {
         Mutexed<Input>::Locked input(mInput);
         n = input->inputDelay + input->pipelineDelay + outputDelay + kSmoothnessFactor;
     }
-    return mPipelineWatcher.lock()->elapsed(PipelineWatcher::Clock::now(), n);
+    return mPipelineWatcher.elapsed(PipelineWatcher::Clock::now(), n);
 }
 
 void CCodecBufferChannel::setMetaMode(MetaMode mode) {
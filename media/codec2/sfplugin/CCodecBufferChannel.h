@@ -30,6 +30,7 @@
 #include <codec2/hidl/client.h>
 #include <media/stagefright/foundation/Mutexed.h>
 #include <media/stagefright/CodecBase.h>
+#include <utils/Timers.h>
 
 #include "CCodecBuffers.h"
 #include "FrameReassembler.h"
@@ -323,6 +324,13 @@ private:
         uint32_t generation;
         int maxDequeueBuffers;
         std::map<uint64_t, int> rotation;
+        // Decode jitter tracking used to autotune maxDequeueBuffers; outputs
+        // arriving in bursts need extra dequeued buffers to be absorbed
+        // without blocking the component. See handleWork().
+        nsecs_t lastOutputAtNs = 0;
+        int64_t avgIntervalNs = 0;
+        int64_t avgJitterNs = 0;
+        int tunedExtraDequeueBuffers = 0;
     };
     Mutexed<OutputSurface> mOutputSurface;
 
@@ -339,7 +347,8 @@ private:
 
     MetaMode mMetaMode;
 
-    Mutexed<PipelineWatcher> mPipelineWatcher;
+    // Internally thread safe; see the class comment on event ordering.
+    PipelineWatcher mPipelineWatcher;
 
     std::atomic_bool mInputMetEos;
     std::once_flag mRenderWarningFlag;
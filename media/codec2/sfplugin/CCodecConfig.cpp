@@ -18,6 +18,8 @@
 #define LOG_TAG "CCodecConfig"
 
 #include <initializer_list>
+#include <map>
+#include <mutex>
 
 #include <cutils/properties.h>
 #include <log/log.h>
@@ -1033,6 +1035,24 @@ void CCodecConfig::initializeStandardParams() {
     */
 }
 
+namespace {
+
+// Reflection results are stable for a given component within a process: the
+// supported param descriptors and the field maps derived from them only
+// change with the component store itself. Cache them per component name so
+// that repeated instances of the same codec skip the querySupportedParams
+// and per-param reflection round trips on configure. Entries are shared
+// read-only; a ReflectedParamUpdater is never mutated once built.
+struct ReflectionCacheEntry {
+    std::vector<std::shared_ptr<C2ParamDescriptor>> paramDescs;
+    std::shared_ptr<ReflectedParamUpdater> paramUpdater;
+};
+
+std::mutex gReflectionCacheMutex;
+std::map<std::string, ReflectionCacheEntry> gReflectionCache;
+
+}  // namespace
+
 status_t CCodecConfig::initialize(
         const std::shared_ptr<C2ParamReflector> &reflector,
         const std::shared_ptr<Codec2Client::Configurable> &configurable) {
@@ -1088,32 +1108,51 @@ status_t CCodecConfig::initialize(
         mCodingMediaType = "";
     }
 
-    c2err = configurable->querySupportedParams(&mParamDescs);
-    if (c2err != C2_OK) {
-        ALOGD("Query supported params failed after returning %zu values => %s",
-                mParamDescs.size(), asString(c2err));
-        return UNKNOWN_ERROR;
-    }
-    for (const std::shared_ptr<C2ParamDescriptor> &desc : mParamDescs) {
-        mSupportedIndices.emplace(desc->index());
-    }
-
     mReflector = reflector;
     if (mReflector == nullptr) {
         ALOGE("Null param reflector");
         return UNKNOWN_ERROR;
     }
 
-    // enumerate all fields
-    mParamUpdater = std::make_shared<ReflectedParamUpdater>();
-    mParamUpdater->clear();
-    mParamUpdater->supportWholeParam(
-            C2_PARAMKEY_TEMPORAL_LAYERING, C2StreamTemporalLayeringTuning::CORE_INDEX);
-    mParamUpdater->addParamDesc(mReflector, mParamDescs);
+    const std::string componentName = configurable->getName();
+    bool reflectionCached = false;
+    {
+        std::lock_guard<std::mutex> lock(gReflectionCacheMutex);
+        auto it = gReflectionCache.find(componentName);
+        if (it != gReflectionCache.end()) {
+            mParamDescs = it->second.paramDescs;
+            mParamUpdater = it->second.paramUpdater;
+            reflectionCached = true;
+        }
+    }
+
+    if (!reflectionCached) {
+        c2err = configurable->querySupportedParams(&mParamDescs);
+        if (c2err != C2_OK) {
+            ALOGD("Query supported params failed after returning %zu values => %s",
+                    mParamDescs.size(), asString(c2err));
+            return UNKNOWN_ERROR;
+        }
+
+        // enumerate all fields
+        mParamUpdater = std::make_shared<ReflectedParamUpdater>();
+        mParamUpdater->clear();
+        mParamUpdater->supportWholeParam(
+                C2_PARAMKEY_TEMPORAL_LAYERING, C2StreamTemporalLayeringTuning::CORE_INDEX);
+        mParamUpdater->addParamDesc(mReflector, mParamDescs);
 
-    // TEMP: add some standard fields even if not reflected
-    if (kind.value == C2Component::KIND_ENCODER) {
-        mParamUpdater->addStandardParam<C2StreamInitDataInfo::output>(C2_PARAMKEY_INIT_DATA);
+        // TEMP: add some standard fields even if not reflected
+        if (kind.value == C2Component::KIND_ENCODER) {
+            mParamUpdater->addStandardParam<C2StreamInitDataInfo::output>(C2_PARAMKEY_INIT_DATA);
+        }
+
+        std::lock_guard<std::mutex> lock(gReflectionCacheMutex);
+        gReflectionCache.emplace(componentName,
+                                 ReflectionCacheEntry{mParamDescs, mParamUpdater});
+    }
+
+    for (const std::shared_ptr<C2ParamDescriptor> &desc : mParamDescs) {
+        mSupportedIndices.emplace(desc->index());
     }
     if (domain.value == C2Component::DOMAIN_IMAGE || domain.value == C2Component::DOMAIN_VIDEO) {
         if (kind.value != C2Component::KIND_ENCODER) {
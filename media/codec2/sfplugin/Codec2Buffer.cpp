@@ -43,6 +43,7 @@
 #include <C2AllocatorGralloc.h>
 #include <C2BlockInternal.h>
 #include <C2Debug.h>
+#include <C2FenceFactory.h>
 
 #include "Codec2Buffer.h"
 
@@ -806,14 +807,14 @@ std::shared_ptr<C2Buffer> GraphicMetadataBuffer::asC2Buffer() {
     std::shared_ptr<C2GraphicBlock> block = _C2BlockFactory::CreateGraphicBlock(alloc);
 
     meta->pBuffer = 0;
-    // TODO: wrap this in C2Fence so that the component can wait when it
-    //       actually starts processing.
+    // wrap the acquire fence in a C2Fence so that the component waits when it
+    // actually starts processing instead of stalling this thread here
+    C2Fence fence;
     if (meta->nFenceFd >= 0) {
-        sp<Fence> fence(new Fence(meta->nFenceFd));
-        fence->waitForever(LOG_TAG);
+        fence = _C2FenceFactory::CreateSyncFence(meta->nFenceFd);
     }
     return C2Buffer::CreateGraphicBuffer(
-            block->share(C2Rect(buffer->width, buffer->height), C2Fence()));
+            block->share(C2Rect(buffer->width, buffer->height), fence));
 }
 
 // ConstGraphicBlockBuffer
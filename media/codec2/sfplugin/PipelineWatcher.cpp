@@ -17,7 +17,8 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "PipelineWatcher"
 
-#include <numeric>
+#include <algorithm>
+#include <functional>
 
 #include <log/log.h>
 
@@ -26,25 +27,45 @@
 namespace android {
 
 PipelineWatcher &PipelineWatcher::inputDelay(uint32_t value) {
-    mInputDelay = value;
+    mInputDelay.store(value, std::memory_order_relaxed);
+    ALOGW_IF(value + mPipelineDelay + mOutputDelay + mSmoothnessFactor >= kNumSlots,
+             "delays exceed the work table capacity (%zu)", kNumSlots);
     return *this;
 }
 
 PipelineWatcher &PipelineWatcher::pipelineDelay(uint32_t value) {
-    mPipelineDelay = value;
+    mPipelineDelay.store(value, std::memory_order_relaxed);
     return *this;
 }
 
 PipelineWatcher &PipelineWatcher::outputDelay(uint32_t value) {
-    mOutputDelay = value;
+    mOutputDelay.store(value, std::memory_order_relaxed);
     return *this;
 }
 
 PipelineWatcher &PipelineWatcher::smoothnessFactor(uint32_t value) {
-    mSmoothnessFactor = value;
+    mSmoothnessFactor.store(value, std::memory_order_relaxed);
     return *this;
 }
 
+PipelineWatcher::Slot *PipelineWatcher::slotFor(uint64_t frameIndex) {
+    return &mSlots[frameIndex & (kNumSlots - 1)];
+}
+
+const PipelineWatcher::Slot *PipelineWatcher::slotFor(uint64_t frameIndex) const {
+    return &mSlots[frameIndex & (kNumSlots - 1)];
+}
+
+// Called with mMutex held.
+void PipelineWatcher::retireSlot(Slot *slot) {
+    slot->mBuffers.clear();
+    if (slot->mPendingInputs.exchange(0, std::memory_order_relaxed) > 0) {
+        (void)mNumInputsPending.fetch_sub(1, std::memory_order_relaxed);
+    }
+    (void)mNumInPipeline.fetch_sub(1, std::memory_order_relaxed);
+    slot->mSeq.store(kEmpty, std::memory_order_release);
+}
+
 void PipelineWatcher::onWorkQueued(
         uint64_t frameIndex,
         std::vector<std::shared_ptr<C2Buffer>> &&buffers,
@@ -53,104 +74,133 @@ void PipelineWatcher::onWorkQueued(
           (unsigned long long)frameIndex,
           buffers.size(),
           (long long)queuedAt.time_since_epoch().count());
-    auto it = mFramesInPipeline.find(frameIndex);
-    if (it != mFramesInPipeline.end()) {
-        ALOGD("onWorkQueued: Duplicate frame index (%llu); previous entry removed",
-              (unsigned long long)frameIndex);
-        (void)mFramesInPipeline.erase(it);
+    std::lock_guard<std::mutex> lock(mMutex);
+    Slot *slot = slotFor(frameIndex);
+    uint64_t seq = slot->mSeq.load(std::memory_order_acquire);
+    if (seq != kEmpty) {
+        // Either a duplicate frame index or more than kNumSlots frames in
+        // flight; reclaim the slot as if the previous occupant completed.
+        ALOGD("onWorkQueued: slot for frame index %llu still occupied by %llu; "
+              "previous entry removed",
+              (unsigned long long)frameIndex, (unsigned long long)(seq - 1));
+        retireSlot(slot);
     }
-    (void)mFramesInPipeline.try_emplace(frameIndex, std::move(buffers), queuedAt);
+    size_t pendingInputs = std::count_if(
+            buffers.begin(), buffers.end(),
+            [](const std::shared_ptr<C2Buffer> &buffer) { return bool(buffer); });
+    slot->mBuffers = std::move(buffers);
+    slot->mQueuedAtNs.store(
+            queuedAt.time_since_epoch().count(), std::memory_order_relaxed);
+    slot->mPendingInputs.store(pendingInputs, std::memory_order_relaxed);
+    if (pendingInputs > 0) {
+        (void)mNumInputsPending.fetch_add(1, std::memory_order_relaxed);
+    }
+    (void)mNumInPipeline.fetch_add(1, std::memory_order_relaxed);
+    slot->mSeq.store(frameIndex + 1, std::memory_order_release);
 }
 
 std::shared_ptr<C2Buffer> PipelineWatcher::onInputBufferReleased(
         uint64_t frameIndex, size_t arrayIndex) {
     ALOGV("onInputBufferReleased(frameIndex=%llu, arrayIndex=%zu)",
           (unsigned long long)frameIndex, arrayIndex);
-    auto it = mFramesInPipeline.find(frameIndex);
-    if (it == mFramesInPipeline.end()) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Slot *slot = slotFor(frameIndex);
+    if (slot->mSeq.load(std::memory_order_acquire) != frameIndex + 1) {
         ALOGD("onInputBufferReleased: frameIndex not found (%llu); ignored",
               (unsigned long long)frameIndex);
         return nullptr;
     }
-    if (it->second.buffers.size() <= arrayIndex) {
+    if (slot->mBuffers.size() <= arrayIndex) {
         ALOGD("onInputBufferReleased: buffers at %llu: size %zu, requested index: %zu",
-              (unsigned long long)frameIndex, it->second.buffers.size(), arrayIndex);
+              (unsigned long long)frameIndex, slot->mBuffers.size(), arrayIndex);
         return nullptr;
     }
-    std::shared_ptr<C2Buffer> buffer(std::move(it->second.buffers[arrayIndex]));
+    std::shared_ptr<C2Buffer> buffer(std::move(slot->mBuffers[arrayIndex]));
     ALOGD_IF(!buffer, "onInputBufferReleased: buffer already released (%llu:%zu)",
              (unsigned long long)frameIndex, arrayIndex);
+    if (buffer
+            && slot->mPendingInputs.fetch_sub(1, std::memory_order_relaxed) == 1) {
+        (void)mNumInputsPending.fetch_sub(1, std::memory_order_relaxed);
+    }
     return buffer;
 }
 
 void PipelineWatcher::onWorkDone(uint64_t frameIndex) {
     ALOGV("onWorkDone(frameIndex=%llu)", (unsigned long long)frameIndex);
-    auto it = mFramesInPipeline.find(frameIndex);
-    if (it == mFramesInPipeline.end()) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Slot *slot = slotFor(frameIndex);
+    if (slot->mSeq.load(std::memory_order_acquire) != frameIndex + 1) {
         ALOGV("onWorkDone: frameIndex not found (%llu); ignored",
               (unsigned long long)frameIndex);
         return;
     }
-    (void)mFramesInPipeline.erase(it);
+    retireSlot(slot);
 }
 
 void PipelineWatcher::flush() {
     ALOGV("flush");
-    mFramesInPipeline.clear();
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (Slot &slot : mSlots) {
+        if (slot.mSeq.load(std::memory_order_acquire) != kEmpty) {
+            retireSlot(&slot);
+        }
+    }
 }
 
 bool PipelineWatcher::pipelineFull(size_t *pipelineRoom) const {
-    if (mFramesInPipeline.size() >=
-            mInputDelay + mPipelineDelay + mOutputDelay + mSmoothnessFactor) {
-        ALOGV("pipelineFull: too many frames in pipeline (%zu)", mFramesInPipeline.size());
+    const uint32_t inputDelay = mInputDelay.load(std::memory_order_relaxed);
+    const uint32_t pipelineDelay = mPipelineDelay.load(std::memory_order_relaxed);
+    const uint32_t outputDelay = mOutputDelay.load(std::memory_order_relaxed);
+    const uint32_t smoothnessFactor = mSmoothnessFactor.load(std::memory_order_relaxed);
+    const size_t sizeInPipeline = mNumInPipeline.load(std::memory_order_relaxed);
+    const size_t sizeWithInputsPending = mNumInputsPending.load(std::memory_order_relaxed);
+    if (sizeInPipeline >=
+            inputDelay + pipelineDelay + outputDelay + smoothnessFactor) {
+        ALOGV("pipelineFull: too many frames in pipeline (%zu)", sizeInPipeline);
         return true;
     }
-    size_t sizeWithInputReleased = std::count_if(
-            mFramesInPipeline.begin(),
-            mFramesInPipeline.end(),
-            [](const decltype(mFramesInPipeline)::value_type &value) {
-                for (const std::shared_ptr<C2Buffer> &buffer : value.second.buffers) {
-                    if (buffer) {
-                        return false;
-                    }
-                }
-                return true;
-            });
+    size_t sizeWithInputReleased = sizeInPipeline - std::min(sizeInPipeline, sizeWithInputsPending);
     if (sizeWithInputReleased >=
-            mPipelineDelay + mOutputDelay + mSmoothnessFactor) {
+            pipelineDelay + outputDelay + smoothnessFactor) {
         ALOGV("pipelineFull: too many frames in pipeline, with input released (%zu)",
               sizeWithInputReleased);
         return true;
     }
 
-    size_t sizeWithInputsPending = mFramesInPipeline.size() - sizeWithInputReleased;
-    if (sizeWithInputsPending > mPipelineDelay + mInputDelay + mSmoothnessFactor) {
+    if (sizeWithInputsPending > pipelineDelay + inputDelay + smoothnessFactor) {
         ALOGV("pipelineFull: too many inputs pending (%zu) in pipeline, with inputs released (%zu)",
               sizeWithInputsPending, sizeWithInputReleased);
         return true;
     }
     ALOGV("pipeline has room (total: %zu, input released: %zu)",
-          mFramesInPipeline.size(), sizeWithInputReleased);
+          sizeInPipeline, sizeWithInputReleased);
     if (pipelineRoom) {
-        *pipelineRoom = mInputDelay + mPipelineDelay + mOutputDelay + mSmoothnessFactor
-                                - mFramesInPipeline.size();
+        *pipelineRoom = inputDelay + pipelineDelay + outputDelay + smoothnessFactor
+                                - sizeInPipeline;
     }
     return false;
 }
 
 PipelineWatcher::Clock::duration PipelineWatcher::elapsed(
         const PipelineWatcher::Clock::time_point &now, size_t n) const {
-    if (mFramesInPipeline.size() <= n) {
-        return Clock::duration::zero();
-    }
     std::vector<Clock::duration> durations;
-    for (const decltype(mFramesInPipeline)::value_type &value : mFramesInPipeline) {
-        Clock::duration elapsed = now - value.second.queuedAt;
+    for (const Slot &slot : mSlots) {
+        const uint64_t seq = slot.mSeq.load(std::memory_order_acquire);
+        if (seq == kEmpty) {
+            continue;
+        }
+        // A slot retired between the two loads yields a slightly stale
+        // duration, which is acceptable for this watchdog heuristic.
+        Clock::duration elapsed = now - Clock::time_point(Clock::duration(
+                slot.mQueuedAtNs.load(std::memory_order_relaxed)));
         ALOGV("elapsed: frameIndex = %llu elapsed = %lldms",
-              (unsigned long long)value.first,
+              (unsigned long long)(seq - 1),
               std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
         durations.push_back(elapsed);
     }
+    if (durations.size() <= n) {
+        return Clock::duration::zero();
+    }
     std::nth_element(durations.begin(), durations.begin() + n, durations.end(),
                      std::greater<Clock::duration>());
     return durations[n];
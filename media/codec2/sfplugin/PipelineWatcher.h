@@ -17,9 +17,11 @@
 #ifndef PIPELINE_WATCHER_H_
 #define PIPELINE_WATCHER_H_
 
+#include <atomic>
 #include <chrono>
-#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <C2Work.h>
 
@@ -28,6 +30,14 @@ namespace android {
 /**
  * PipelineWatcher watches the pipeline and infers the status of work items from
  * events.
+ *
+ * Thread safety: in-flight work is tracked in a fixed-size table of slots
+ * indexed by frame index. The mutating events (onWorkQueued, onWorkDone,
+ * onInputBufferReleased, flush) are serialized by an internal lock, as they
+ * arrive on different threads (the CCodec looper and the codec2 client
+ * listener thread) and may race for the same frame index. The hot queries
+ * (pipelineFull, elapsed) only read atomics and take no lock, so the
+ * queuing thread's full-check never contends with event delivery.
  */
 class PipelineWatcher {
 public:
@@ -37,7 +47,9 @@ public:
         : mInputDelay(0),
           mPipelineDelay(0),
           mOutputDelay(0),
-          mSmoothnessFactor(0) {}
+          mSmoothnessFactor(0),
+          mNumInPipeline(0),
+          mNumInputsPending(0) {}
     ~PipelineWatcher() = default;
 
     /**
@@ -120,20 +132,40 @@ public:
     Clock::duration elapsed(const Clock::time_point &now, size_t n) const;
 
 private:
-    uint32_t mInputDelay;
-    uint32_t mPipelineDelay;
-    uint32_t mOutputDelay;
-    uint32_t mSmoothnessFactor;
-
-    struct Frame {
-        Frame(std::vector<std::shared_ptr<C2Buffer>> &&b,
-              const Clock::time_point &q)
-            : buffers(b),
-              queuedAt(q) {}
-        std::vector<std::shared_ptr<C2Buffer>> buffers;
-        const Clock::time_point queuedAt;
+    std::atomic_uint32_t mInputDelay;
+    std::atomic_uint32_t mPipelineDelay;
+    std::atomic_uint32_t mOutputDelay;
+    std::atomic_uint32_t mSmoothnessFactor;
+
+    // Number of slots in the work table; bounds the number of frames that can
+    // be tracked at once and must exceed the sum of the delay values plus the
+    // smoothness factor. Power of two so that frame indices map to slots with
+    // a mask.
+    static constexpr size_t kNumSlots = 1024;
+    // mSeq value of an unoccupied slot; occupied slots hold frameIndex + 1.
+    static constexpr uint64_t kEmpty = 0;
+
+    struct Slot {
+        // mBuffers is only touched with mMutex held. The atomics are written
+        // with mMutex held and additionally read without it by pipelineFull()
+        // and elapsed().
+        std::atomic_uint64_t mSeq{kEmpty};
+        std::atomic_int64_t mQueuedAtNs{0};
+        std::atomic_size_t mPendingInputs{0};
+        std::vector<std::shared_ptr<C2Buffer>> mBuffers;
     };
-    std::map<uint64_t, Frame> mFramesInPipeline;
+    Slot mSlots[kNumSlots];
+
+    // Serializes the mutating events; not taken by pipelineFull()/elapsed().
+    mutable std::mutex mMutex;
+
+    // Running totals so that pipelineFull() does not need to scan the table.
+    std::atomic_size_t mNumInPipeline;
+    std::atomic_size_t mNumInputsPending;
+
+    Slot *slotFor(uint64_t frameIndex);
+    const Slot *slotFor(uint64_t frameIndex) const;
+    void retireSlot(Slot *slot);
 };
 
 }  // namespace android
@@ -0,0 +1,422 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Codec2 software component microbenchmarks.
+ *
+ * Drives the c2.android.* components directly (no HIDL hop) with the canned
+ * elementary streams used by the codec2 VTS tests, and reports decoded
+ * frames/sec, the per-work queue-to-done latency distribution and heap growth
+ * per frame, so software codecs can be compared quantitatively against each
+ * other and against vendor implementations across releases.
+ *
+ * How to run:
+ *
+ * 1. Push the VTS media assets to the device:
+ *      $ adb push media/codec2/hidl/1.0/vts/functional/res /data/local/tmp/media
+ *
+ * 2. Compile the benchmark and sync to device:
+ *      $ mm -j && adb sync
+ *
+ * 3. Run:
+ *      $ adb shell /data/nativetest64/C2ComponentBenchmark/C2ComponentBenchmark
+ *
+ * The asset directory can be overridden with the C2_BENCHMARK_RES_DIR
+ * environment variable.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "C2ComponentBenchmark"
+
+#include <malloc.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <C2Buffer.h>
+#include <C2Component.h>
+#include <C2Config.h>
+#include <C2PlatformSupport.h>
+#include <C2Work.h>
+
+namespace {
+
+using namespace android;
+
+constexpr size_t kNumPreparedWorks = 8;
+constexpr uint32_t kPageSize = 4096;
+
+std::string resourceDir() {
+    const char *dir = getenv("C2_BENCHMARK_RES_DIR");
+    return dir != nullptr ? dir : "/data/local/tmp/media/";
+}
+
+struct FrameInfo {
+    int size;
+    uint32_t flags;
+    int64_t timestamp;
+};
+
+// Reads the VTS-style .info frame index: one "<size> <flags> <timestamp>"
+// triplet per work item.
+bool readFrameInfos(const std::string &infoPath, std::vector<FrameInfo> *infos) {
+    std::ifstream eleInfo(infoPath);
+    if (!eleInfo.is_open()) {
+        return false;
+    }
+    int size = 0;
+    uint32_t flags = 0;
+    int64_t timestamp = 0;
+    while (eleInfo >> size) {
+        eleInfo >> flags;
+        eleInfo >> timestamp;
+        infos->push_back({size, flags, timestamp});
+    }
+    return !infos->empty();
+}
+
+class LinearBuffer : public C2Buffer {
+public:
+    LinearBuffer(const std::shared_ptr<C2LinearBlock> &block, size_t size)
+        : C2Buffer({block->share(block->offset(), size, ::C2Fence())}) {}
+};
+
+// Collects work completion times and returns finished works to the prepared
+// queue, keyed by input frame index.
+class BenchmarkListener : public C2Component::Listener {
+public:
+    void onWorkDone_nb(std::weak_ptr<C2Component> component,
+                       std::list<std::unique_ptr<C2Work>> workItems) override {
+        (void)component;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> l(mLock);
+        for (std::unique_ptr<C2Work> &work : workItems) {
+            if (!work) {
+                continue;
+            }
+            uint64_t frameIndex = work->input.ordinal.frameIndex.peeku();
+            auto it = mQueuedAt.find(frameIndex);
+            if (it != mQueuedAt.end()) {
+                mLatenciesUs.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                        now - it->second).count());
+                mQueuedAt.erase(it);
+            }
+            if ((work->worklets.size() == 1u && work->worklets.front()
+                    && (work->worklets.front()->output.flags
+                            & C2FrameData::FLAG_END_OF_STREAM))
+                    || (work->input.flags & C2FrameData::FLAG_END_OF_STREAM)) {
+                mSawEOS = true;
+            }
+            work->input.buffers.clear();
+            work->worklets.clear();
+            work->worklets.emplace_back(new C2Worklet);
+            mWorkQueue.push_back(std::move(work));
+        }
+        mCondition.notify_all();
+    }
+
+    void onTripped_nb(std::weak_ptr<C2Component> component,
+                      std::vector<std::shared_ptr<C2SettingResult>> settingResult) override {
+        (void)component;
+        (void)settingResult;
+    }
+
+    void onError_nb(std::weak_ptr<C2Component> component, uint32_t errorCode) override {
+        (void)component;
+        std::unique_lock<std::mutex> l(mLock);
+        mError = errorCode;
+        mSawEOS = true;  // unblock the driver
+        mCondition.notify_all();
+    }
+
+    void prepareWorks() {
+        std::unique_lock<std::mutex> l(mLock);
+        for (size_t i = 0; i < kNumPreparedWorks; ++i) {
+            std::unique_ptr<C2Work> work(new C2Work);
+            work->worklets.emplace_back(new C2Worklet);
+            mWorkQueue.push_back(std::move(work));
+        }
+    }
+
+    std::unique_ptr<C2Work> obtainWork() {
+        std::unique_lock<std::mutex> l(mLock);
+        while (mWorkQueue.empty() && mError == 0) {
+            mCondition.wait(l);
+        }
+        if (mWorkQueue.empty()) {
+            return nullptr;
+        }
+        std::unique_ptr<C2Work> work = std::move(mWorkQueue.front());
+        mWorkQueue.pop_front();
+        return work;
+    }
+
+    void recordQueued(uint64_t frameIndex) {
+        std::unique_lock<std::mutex> l(mLock);
+        mQueuedAt[frameIndex] = std::chrono::steady_clock::now();
+    }
+
+    bool waitForEOS() {
+        std::unique_lock<std::mutex> l(mLock);
+        while (!mSawEOS) {
+            mCondition.wait(l);
+        }
+        return mError == 0;
+    }
+
+    void reset() {
+        std::unique_lock<std::mutex> l(mLock);
+        mWorkQueue.clear();
+        mQueuedAt.clear();
+        mLatenciesUs.clear();
+        mSawEOS = false;
+        mError = 0;
+    }
+
+    std::vector<int64_t> takeLatenciesUs() {
+        std::unique_lock<std::mutex> l(mLock);
+        return std::move(mLatenciesUs);
+    }
+
+private:
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    std::list<std::unique_ptr<C2Work>> mWorkQueue;
+    std::map<uint64_t, std::chrono::steady_clock::time_point> mQueuedAt;
+    std::vector<int64_t> mLatenciesUs;
+    bool mSawEOS = false;
+    uint32_t mError = 0;
+};
+
+int64_t percentileUs(std::vector<int64_t> &latencies, int p) {
+    if (latencies.empty()) {
+        return 0;
+    }
+    size_t idx = std::min(latencies.size() - 1, latencies.size() * p / 100);
+    std::nth_element(latencies.begin(), latencies.begin() + idx, latencies.end());
+    return latencies[idx];
+}
+
+size_t currentHeapBytes() {
+    struct mallinfo info = mallinfo();
+    return info.uordblks;
+}
+
+// Decodes the whole elementary stream once through the named component,
+// counting one benchmark item per input frame. With |batchFrames| > 1, runs
+// of consecutive flag-less frames are packed as multiple input buffers into
+// a single work (supported by the audio soft decoders), so per-work overhead
+// amortizes across the batch; frames with flags (codec config, EOS) are
+// always queued alone.
+void runDecode(benchmark::State &state, const char *componentName,
+               const char *streamFile, const char *infoFile,
+               size_t batchFrames = 1) {
+    std::string streamPath = resourceDir() + streamFile;
+    std::vector<FrameInfo> infos;
+    if (!readFrameInfos(resourceDir() + infoFile, &infos)) {
+        state.SkipWithError((std::string("cannot read ") + infoFile
+                + "; push the VTS res directory (see file comment)").c_str());
+        return;
+    }
+
+    std::shared_ptr<C2ComponentStore> store = GetCodec2PlatformComponentStore();
+    std::vector<int64_t> latenciesUs;
+    int64_t framesDecoded = 0;
+    int64_t heapGrowth = 0;
+
+    for (auto _ : state) {
+        std::shared_ptr<C2Component> component;
+        if (store->createComponent(componentName, &component) != C2_OK || !component) {
+            state.SkipWithError("component not found");
+            return;
+        }
+        std::shared_ptr<BenchmarkListener> listener =
+                std::make_shared<BenchmarkListener>();
+        listener->reset();
+        listener->prepareWorks();
+        if (component->setListener_vb(listener, C2_MAY_BLOCK) != C2_OK
+                || component->start() != C2_OK) {
+            state.SkipWithError("component failed to start");
+            return;
+        }
+        std::shared_ptr<C2BlockPool> linearPool;
+        if (GetCodec2BlockPool(C2BlockPool::BASIC_LINEAR, component, &linearPool) != C2_OK) {
+            state.SkipWithError("no linear block pool");
+            return;
+        }
+
+        std::ifstream eleStream(streamPath, std::ifstream::binary);
+        if (!eleStream.is_open()) {
+            state.SkipWithError("cannot open elementary stream");
+            return;
+        }
+
+        size_t heapBefore = currentHeapBytes();
+        for (size_t frameID = 0; frameID < infos.size();) {
+            std::unique_ptr<C2Work> work = listener->obtainWork();
+            if (!work) {
+                state.SkipWithError("component reported an error");
+                return;
+            }
+
+            size_t batch = 1;
+            if (batchFrames > 1 && infos[frameID].flags == 0) {
+                while (batch < batchFrames
+                        && frameID + batch < infos.size()
+                        && infos[frameID + batch].flags == 0) {
+                    ++batch;
+                }
+            }
+
+            uint32_t flags = 0;
+            if (infos[frameID].flags) {
+                flags = 1u << (infos[frameID].flags - 1);
+            }
+            if (frameID + batch == infos.size()) {
+                flags |= C2FrameData::FLAG_END_OF_STREAM;
+            }
+            work->input.flags = (C2FrameData::flags_t)flags;
+            work->input.ordinal.timestamp = infos[frameID].timestamp;
+            work->input.ordinal.frameIndex = frameID;
+
+            work->input.buffers.clear();
+            for (size_t i = 0; i < batch; ++i) {
+                int size = infos[frameID + i].size;
+                if (size <= 0) {
+                    continue;
+                }
+                std::vector<char> data(size);
+                eleStream.read(data.data(), size);
+                if (eleStream.gcount() != size) {
+                    state.SkipWithError("truncated elementary stream");
+                    return;
+                }
+                std::shared_ptr<C2LinearBlock> block;
+                size_t alignedSize = (size + kPageSize - 1) & ~(kPageSize - 1);
+                if (linearPool->fetchLinearBlock(
+                        alignedSize,
+                        {C2MemoryUsage::CPU_READ, C2MemoryUsage::CPU_WRITE},
+                        &block) != C2_OK) {
+                    state.SkipWithError("input block allocation failed");
+                    return;
+                }
+                C2WriteView view = block->map().get();
+                if (view.error() != C2_OK) {
+                    state.SkipWithError("input block map failed");
+                    return;
+                }
+                memcpy(view.base(), data.data(), size);
+                work->input.buffers.emplace_back(new LinearBuffer(block, size));
+            }
+
+            listener->recordQueued(frameID);
+            std::list<std::unique_ptr<C2Work>> items;
+            items.push_back(std::move(work));
+            if (component->queue_nb(&items) != C2_OK) {
+                state.SkipWithError("queue_nb failed");
+                return;
+            }
+            frameID += batch;
+        }
+
+        if (!listener->waitForEOS()) {
+            state.SkipWithError("component reported an error");
+            return;
+        }
+        int64_t growth = (int64_t)currentHeapBytes() - (int64_t)heapBefore;
+        if (growth > 0) {
+            heapGrowth += growth;
+        }
+        framesDecoded += infos.size();
+        std::vector<int64_t> iterLatencies = listener->takeLatenciesUs();
+        latenciesUs.insert(latenciesUs.end(), iterLatencies.begin(), iterLatencies.end());
+
+        component->stop();
+        component->release();
+    }
+
+    state.SetItemsProcessed(framesDecoded);
+    state.counters["latency_p50_us"] = percentileUs(latenciesUs, 50);
+    state.counters["latency_p90_us"] = percentileUs(latenciesUs, 90);
+    state.counters["latency_p99_us"] = percentileUs(latenciesUs, 99);
+    state.counters["latency_max_us"] =
+            latenciesUs.empty() ? 0 : *std::max_element(latenciesUs.begin(), latenciesUs.end());
+    state.counters["heap_bytes_per_frame"] =
+            framesDecoded > 0 ? (double)heapGrowth / framesDecoded : 0;
+}
+
+void BM_C2SoftAvcDec(benchmark::State &state) {
+    runDecode(state, "c2.android.avc.decoder",
+              "bbb_avc_640x360_768kbps_30fps.h264", "bbb_avc_640x360_768kbps_30fps.info");
+}
+
+void BM_C2SoftHevcDec(benchmark::State &state) {
+    runDecode(state, "c2.android.hevc.decoder",
+              "bbb_hevc_640x360_1600kbps_30fps.hevc", "bbb_hevc_640x360_1600kbps_30fps.info");
+}
+
+void BM_C2SoftVp8Dec(benchmark::State &state) {
+    runDecode(state, "c2.android.vp8.decoder",
+              "bbb_vp8_640x360_2mbps_30fps.vp8", "bbb_vp8_640x360_2mbps_30fps.info");
+}
+
+void BM_C2SoftVp9Dec(benchmark::State &state) {
+    runDecode(state, "c2.android.vp9.decoder",
+              "bbb_vp9_640x360_1600kbps_30fps.vp9", "bbb_vp9_640x360_1600kbps_30fps.info");
+}
+
+void BM_C2SoftAacDec(benchmark::State &state) {
+    runDecode(state, "c2.android.aac.decoder",
+              "bbb_aac_stereo_128kbps_48000hz.aac", "bbb_aac_stereo_128kbps_48000hz.info");
+}
+
+// The argument is the number of packets batched into each work; 1 is the
+// conventional one-packet-per-work operation the framework uses today, so
+// the higher counts quantify what batch submission buys on these decoders.
+void BM_C2SoftOpusDec(benchmark::State &state) {
+    runDecode(state, "c2.android.opus.decoder",
+              "bbb_opus_stereo_128kbps_48000hz.opus", "bbb_opus_stereo_128kbps_48000hz.info",
+              state.range(0));
+}
+
+void BM_C2SoftVorbisDec(benchmark::State &state) {
+    runDecode(state, "c2.android.vorbis.decoder",
+              "bbb_vorbis_stereo_128kbps_48000hz.vorbis", "bbb_vorbis_stereo_128kbps_48000hz.info",
+              state.range(0));
+}
+
+BENCHMARK(BM_C2SoftAvcDec)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_C2SoftHevcDec)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_C2SoftVp8Dec)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_C2SoftVp9Dec)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_C2SoftAacDec)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_C2SoftOpusDec)->Arg(1)->Arg(4)->Arg(8)
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_C2SoftVorbisDec)->Arg(1)->Arg(4)->Arg(8)
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
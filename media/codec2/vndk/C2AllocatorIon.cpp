@@ -19,10 +19,13 @@
 #include <utils/Log.h>
 
 #include <list>
+#include <mutex>
 
 #include <ion/ion.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <unistd.h> // getpagesize, size_t, close, dup
+#include <utils/Timers.h>
 
 #include <C2AllocatorIon.h>
 #include <C2Buffer.h>
@@ -40,6 +43,14 @@ namespace {
 
     // max padding after ion/dmabuf allocations in bytes
     constexpr uint32_t MAX_PADDING = 0x8000; // 32KB
+
+    // freed ion allocations are parked briefly keyed by their allocation
+    // parameters so resolution changes and codec restarts reuse them instead
+    // of hitting the kernel allocator; the park is bounded by count, total
+    // bytes and age
+    constexpr size_t MAX_PARKED_ALLOCATIONS = 16;
+    constexpr size_t MAX_PARKED_BYTES = 32 * 1048576; // 32MB
+    constexpr nsecs_t PARK_TIMEOUT_NS = 1000000000; // 1s
 }
 
 /* size_t <=> int(lo), int(hi) conversions */
@@ -178,6 +189,20 @@ public:
      */
     static Impl *Alloc(int ionFd, size_t size, size_t align, unsigned heapMask, unsigned flags, C2Allocator::id_t id);
 
+    /**
+     * Disposes of an implementation that is no longer referenced by an allocation.
+     *
+     * Successful allocations made by Alloc are parked in a process-wide,
+     * size-bucketed pool for a short while instead of being freed, so that the
+     * allocation bursts caused by resolution switches and codec restarts are
+     * served from recently retired buffers. The pool serves every session in
+     * the codec process, so a buffer is zeroed before parking - a reused
+     * allocation must never expose another app's media data the way a fresh
+     * kernel allocation never would. Imported allocations, failed allocations
+     * and buffers that cannot be mapped for zeroing are destroyed immediately.
+     */
+    static void Recycle(Impl *impl);
+
     c2_status_t map(size_t offset, size_t size, C2MemoryUsage usage, C2Fence *fence, void **addr) {
         (void)fence; // TODO: wait for fence
         *addr = nullptr;
@@ -324,6 +349,72 @@ protected:
         size_t size;
     };
     Mutexed<std::list<Mapping>> mMappings;
+
+private:
+    /**
+     * Returns a parked implementation matching the allocation parameters, or
+     * nullptr if none is available. A returned implementation is re-tagged
+     * with |id| as if it had been allocated anew.
+     */
+    static Impl *ObtainParked(
+            size_t allocSize, size_t align, unsigned heapMask, unsigned flags,
+            C2Allocator::id_t id);
+
+    // Marks this as eligible for parking and records the key it is parked
+    // under; only called by Alloc on successfully allocated (not imported)
+    // buffers.
+    void markRecyclable(size_t allocSize, size_t align, unsigned heapMask, unsigned flags) {
+        mAllocSize = allocSize;
+        mAlign = align;
+        mHeapMask = heapMask;
+        mFlags = flags;
+        mRecyclable = (mInit == C2_OK);
+    }
+
+    // Drops mappings left behind by the previous owner (block views do not
+    // reliably unmap, see map()) so a reused buffer starts out unmapped.
+    // The cached mMapFd is kept; remapping through it is cheap.
+    void prepareForReuse() {
+        Mutexed<std::list<Mapping>>::Locked mappings(mMappings);
+        for (const Mapping &map : *mappings) {
+            (void)munmap(map.addr, map.size);
+        }
+        mappings->clear();
+    }
+
+    // Zeroes the whole allocation through a transient CPU mapping, matching
+    // the zero-fill a fresh kernel allocation would get. Returns false if the
+    // buffer cannot be mapped; such a buffer must not be parked.
+    bool zeroForReuse() {
+        void *base = nullptr;
+        void *addr = nullptr;
+        if (mapInternal(mAllocSize, 0 /* mapOffset */, 0 /* alignmentBytes */,
+                        PROT_READ | PROT_WRITE, MAP_SHARED, &base, &addr) != C2_OK
+                || base == nullptr) {
+            return false;
+        }
+        memset(base, 0, mAllocSize);
+        (void)munmap(base, mAllocSize);
+        return true;
+    }
+
+    bool mRecyclable{false};
+    size_t mAllocSize{0};
+    size_t mAlign{0};
+    unsigned mHeapMask{0};
+    unsigned mFlags{0};
+
+    struct Parked {
+        Impl *impl;
+        nsecs_t whenNs;
+    };
+    static std::mutex sParkedLock;
+    static std::list<Parked> sParked; // oldest first
+    static size_t sParkedBytes;
+
+    // Evicts expired entries and enforces the park bounds, oldest first.
+    // Must be called with sParkedLock held.
+    static void trimParkedLocked(nsecs_t nowNs);
 };
 
 class C2AllocationIon::ImplV2 : public C2AllocationIon::Impl {
@@ -369,6 +460,63 @@ protected:
 
 };
 
+std::mutex C2AllocationIon::Impl::sParkedLock;
+std::list<C2AllocationIon::Impl::Parked> C2AllocationIon::Impl::sParked;
+size_t C2AllocationIon::Impl::sParkedBytes = 0;
+
+void C2AllocationIon::Impl::trimParkedLocked(nsecs_t nowNs) {
+    while (!sParked.empty()
+            && (nowNs - sParked.front().whenNs > PARK_TIMEOUT_NS
+                    || sParked.size() > MAX_PARKED_ALLOCATIONS
+                    || sParkedBytes > MAX_PARKED_BYTES)) {
+        Impl *impl = sParked.front().impl;
+        sParkedBytes -= impl->mAllocSize;
+        sParked.pop_front();
+        delete impl;
+    }
+}
+
+C2AllocationIon::Impl *C2AllocationIon::Impl::ObtainParked(
+        size_t allocSize, size_t align, unsigned heapMask, unsigned flags,
+        C2Allocator::id_t id) {
+    std::lock_guard<std::mutex> lock(sParkedLock);
+    trimParkedLocked(systemTime(SYSTEM_TIME_MONOTONIC));
+    for (auto it = sParked.begin(); it != sParked.end(); ++it) {
+        Impl *impl = it->impl;
+        if (impl->mAllocSize == allocSize && impl->mAlign == align
+                && impl->mHeapMask == heapMask && impl->mFlags == flags) {
+            sParkedBytes -= impl->mAllocSize;
+            sParked.erase(it);
+            impl->mId = id;
+            return impl;
+        }
+    }
+    return nullptr;
+}
+
+// static
+void C2AllocationIon::Impl::Recycle(Impl *impl) {
+    if (impl == nullptr) {
+        return;
+    }
+    if (!impl->mRecyclable) {
+        delete impl;
+        return;
+    }
+    impl->prepareForReuse();
+    // Scrub the previous session's contents on the way into the pool; the
+    // next occupant may be a different app and maps the block for CPU reads.
+    if (!impl->zeroForReuse()) {
+        delete impl;
+        return;
+    }
+    nsecs_t nowNs = systemTime(SYSTEM_TIME_MONOTONIC);
+    std::lock_guard<std::mutex> lock(sParkedLock);
+    sParked.push_back({ impl, nowNs });
+    sParkedBytes += impl->mAllocSize;
+    trimParkedLocked(nowNs);
+}
+
 C2AllocationIon::Impl *C2AllocationIon::Impl::Import(int ionFd, size_t capacity, int bufferFd,
         C2Allocator::id_t id) {
     int ret = 0;
@@ -406,7 +554,19 @@ C2AllocationIon::Impl *C2AllocationIon::Impl::Alloc(int ionFd, size_t size, size
         allocSize += align - 1;
         allocSize &= ~(align - 1);
     }
+
+    // serve the request from a recently parked allocation of the same shape
+    // if one is available, skipping the kernel allocator entirely
+    Impl *parked = ObtainParked(allocSize, align, heapMask, flags, id);
+    if (parked != nullptr) {
+        ALOGV("reusing parked allocation (size = %zu, align = %zu, heapMask = %d, flags = %d)",
+              allocSize, align, heapMask, flags);
+        close(ionFd);
+        return parked;
+    }
+
     int ret;
+    Impl *impl;
 
     if (ion_is_legacy(ionFd)) {
         ret = ion_alloc(ionFd, allocSize, align, heapMask, flags, &buffer);
@@ -422,7 +582,7 @@ C2AllocationIon::Impl *C2AllocationIon::Impl::Alloc(int ionFd, size_t size, size
             }
         }
         // the padding is not usable so deduct it from the advertised capacity
-        return new Impl(ionFd, allocSize - sPadding, bufferFd, buffer, id, ret);
+        impl = new Impl(ionFd, allocSize - sPadding, bufferFd, buffer, id, ret);
     } else {
         ret = ion_alloc_fd(ionFd, allocSize, align, heapMask, flags, &bufferFd);
         ALOGV("ion_alloc_fd(ionFd = %d, size = %zu, align = %zu, prot = %d, flags = %d) "
@@ -430,8 +590,10 @@ C2AllocationIon::Impl *C2AllocationIon::Impl::Alloc(int ionFd, size_t size, size
               ionFd, allocSize, align, heapMask, flags, ret, bufferFd);
 
         // the padding is not usable so deduct it from the advertised capacity
-        return new ImplV2(ionFd, allocSize - sPadding, bufferFd, id, ret);
+        impl = new ImplV2(ionFd, allocSize - sPadding, bufferFd, id, ret);
     }
+    impl->markRecyclable(allocSize, align, heapMask, flags);
+    return impl;
 }
 
 c2_status_t C2AllocationIon::map(
@@ -465,7 +627,7 @@ const C2Handle *C2AllocationIon::handle() const {
 }
 
 C2AllocationIon::~C2AllocationIon() {
-    delete mImpl;
+    Impl::Recycle(mImpl);
 }
 
 C2AllocationIon::C2AllocationIon(int ionFd, size_t size, size_t align,
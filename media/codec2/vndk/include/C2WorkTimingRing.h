@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAGEFRIGHT_CODEC2_WORK_TIMING_RING_H_
+#define STAGEFRIGHT_CODEC2_WORK_TIMING_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <inttypes.h>
+#include <ostream>
+
+/**
+ * Lock-free per-component ring of C2Work lifecycle timestamps.
+ *
+ * Records, for the last kCapacity work items, when the work entered the HAL
+ * (IComponent::queue), when the component accepted it (queue_nb returned) and
+ * when the component finished it (onWorkDone). The split between the
+ * accepted and done timestamps attributes intermittent latency to either the
+ * component's queue or its processing without attaching a profiler.
+ *
+ * Writers never block: the queue side claims slots with a single fetch_add
+ * and publishes them seqlock-style, and the work-done side only stores into
+ * an atomic field of an already published slot. Readers (the debug dump)
+ * discard slots that change under them. Per-work cost is a few atomic
+ * operations, so the ring can stay enabled in production.
+ */
+class C2WorkTimingRing {
+public:
+    static constexpr size_t kCapacity = 256;  // must be a power of two
+
+    C2WorkTimingRing() = default;
+
+    /**
+     * Records a work item entering the HAL. Returns a token identifying the
+     * claimed slot, to be passed to recordAccepted().
+     */
+    size_t recordQueued(uint64_t frameIndex, int64_t nowNs) {
+        size_t token = mNextSlot.fetch_add(1u, std::memory_order_relaxed);
+        Slot &slot = mSlots[token & (kCapacity - 1)];
+        uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_release);  // odd: in flux
+        slot.frameIndex = frameIndex;
+        slot.queuedAtNs = nowNs;
+        slot.acceptedAtNs.store(0, std::memory_order_relaxed);
+        slot.doneAtNs.store(0, std::memory_order_relaxed);
+        slot.seq.store(seq + 2, std::memory_order_release);  // even: stable
+        return token;
+    }
+
+    /**
+     * Records the component having accepted the work item claimed by |token|
+     * (i.e. queue_nb returned).
+     */
+    void recordAccepted(size_t token, int64_t nowNs) {
+        mSlots[token & (kCapacity - 1)].acceptedAtNs.store(
+                nowNs, std::memory_order_release);
+    }
+
+    /**
+     * Records the work item for |frameIndex| having been finished by the
+     * component. The record is dropped if the slot has since been reused.
+     */
+    void recordDone(uint64_t frameIndex, int64_t nowNs) {
+        for (Slot &slot : mSlots) {
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if ((seq & 1) != 0 || slot.frameIndex != frameIndex) {
+                continue;
+            }
+            slot.doneAtNs.store(nowNs, std::memory_order_release);
+            return;
+        }
+    }
+
+    /** Dumps the ring, oldest first, followed by aggregate latencies. */
+    void dump(std::ostream &out, const char *indent) const {
+        size_t next = mNextSlot.load(std::memory_order_relaxed);
+        size_t count = next < kCapacity ? next : kCapacity;
+        out << indent << "Work timing (last " << count << " work items):"
+            << std::endl;
+        if (count == 0) {
+            out << indent << "  NONE" << std::endl;
+            return;
+        }
+        out << indent << "  frameIndex queue-us component-us" << std::endl;
+        uint64_t completed = 0;
+        int64_t totalUs = 0;
+        int64_t maxUs = 0;
+        uint64_t maxFrameIndex = 0;
+        for (size_t i = next - count; i != next; ++i) {
+            const Slot &slot = mSlots[i & (kCapacity - 1)];
+            uint64_t seqBefore = slot.seq.load(std::memory_order_acquire);
+            uint64_t frameIndex = slot.frameIndex;
+            int64_t queuedAtNs = slot.queuedAtNs;
+            int64_t acceptedAtNs = slot.acceptedAtNs.load(std::memory_order_acquire);
+            int64_t doneAtNs = slot.doneAtNs.load(std::memory_order_acquire);
+            if ((seqBefore & 1) != 0
+                    || slot.seq.load(std::memory_order_acquire) != seqBefore) {
+                continue;  // slot changed under us; skip
+            }
+            char line[128];
+            int64_t queueUs = acceptedAtNs != 0 ? (acceptedAtNs - queuedAtNs) / 1000 : -1;
+            int64_t componentUs = (acceptedAtNs != 0 && doneAtNs != 0)
+                    ? (doneAtNs - acceptedAtNs) / 1000 : -1;
+            snprintf(line, sizeof(line), "  %10" PRIu64 " %8" PRId64 " %12" PRId64,
+                     frameIndex, queueUs, componentUs);
+            out << indent << line << std::endl;
+            if (doneAtNs != 0) {
+                int64_t latencyUs = (doneAtNs - queuedAtNs) / 1000;
+                ++completed;
+                totalUs += latencyUs;
+                if (latencyUs > maxUs) {
+                    maxUs = latencyUs;
+                    maxFrameIndex = frameIndex;
+                }
+            }
+        }
+        if (completed > 0) {
+            out << indent << "  completed: " << completed
+                << ", avg queue-to-done: " << totalUs / (int64_t)completed
+                << "us, max: " << maxUs
+                << "us (frameIndex " << maxFrameIndex << ")" << std::endl;
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};  // odd while being (re)written
+        uint64_t frameIndex{0};
+        int64_t queuedAtNs{0};
+        std::atomic<int64_t> acceptedAtNs{0};
+        std::atomic<int64_t> doneAtNs{0};
+    };
+
+    std::atomic<size_t> mNextSlot{0};
+    Slot mSlots[kCapacity];
+
+    C2WorkTimingRing(const C2WorkTimingRing &) = delete;
+    C2WorkTimingRing &operator=(const C2WorkTimingRing &) = delete;
+};
+
+#endif  // STAGEFRIGHT_CODEC2_WORK_TIMING_RING_H_
@@ -148,6 +148,23 @@ extern "C"
      */
     void GSMDecodeFrameExit(void **state_data);
 
+    /*
+     * This function decodes a buffer of concatenated MIME/IETF (RFC 4867)
+     * storage frames in a single call, writing L_FRAME samples per frame to
+     * pcm_out. At most max_frames frames are decoded (pass a negative value
+     * for no limit); a truncated trailing frame is left unconsumed. On
+     * return, frames_decoded and bytes_consumed describe how far the call
+     * got. This function returns zero. It will return negative one if an
+     * illegal frame type or a decoder error is encountered.
+     */
+    Word16 GSMAMRDecodeBatch(void *state_data,
+                             const UWord8 *stream,
+                             Word32 stream_bytes,
+                             Word32 max_frames,
+                             Word16 *pcm_out,
+                             Word32 *frames_decoded,
+                             Word32 *bytes_consumed);
+
 
 #ifdef __cplusplus
 }
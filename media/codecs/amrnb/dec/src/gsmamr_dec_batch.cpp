@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Batch entry point for the GSM AMR decoder. Offline transcoders decode
+ * long streams one 20 ms frame per AMRDecode() call, paying call and
+ * state-reload overhead per frame; this walks a whole buffer of
+ * concatenated MIME/IETF (RFC 4867) storage frames in one call with the
+ * decoder state kept hot.
+ */
+
+#include "gsmamr_dec.h"
+
+/*
+ * Data bytes per AMR-NB MIME/IETF frame type, not counting the leading
+ * TOC byte. Entries of -1 mark frame types that cannot appear in the
+ * storage format.
+ */
+static const Word16 kNbFrameDataBytes[16] =
+{
+    12, 13, 15, 17, 19, 20, 26, 31,  /* 4.75 ... 12.2 kbps speech */
+    5, 6, 5, 5,                      /* SID variants              */
+    -1, -1, -1,                      /* reserved                  */
+    0                                /* no data                   */
+};
+
+Word16 GSMAMRDecodeBatch(
+    void *state_data,
+    const UWord8 *stream,
+    Word32 stream_bytes,
+    Word32 max_frames,
+    Word16 *pcm_out,
+    Word32 *frames_decoded,
+    Word32 *bytes_consumed)
+{
+    Word32 pos = 0;
+    Word32 frames = 0;
+
+    if (state_data == NULL || stream == NULL || pcm_out == NULL ||
+            frames_decoded == NULL || bytes_consumed == NULL)
+    {
+        return -1;
+    }
+    *frames_decoded = 0;
+    *bytes_consumed = 0;
+
+    while (pos < stream_bytes && (max_frames < 0 || frames < max_frames))
+    {
+        enum Frame_Type_3GPP frame_type =
+            (enum Frame_Type_3GPP)((stream[pos] >> 3) & 0x0f);
+        Word16 data_bytes = kNbFrameDataBytes[frame_type];
+
+        if (data_bytes < 0)
+        {
+            /* illegal frame type: report what was decoded so far */
+            *frames_decoded = frames;
+            *bytes_consumed = pos;
+            return -1;
+        }
+        if (pos + 1 + data_bytes > stream_bytes)
+        {
+            /* truncated trailing frame: stop cleanly */
+            break;
+        }
+
+        Word16 bytes_read = AMRDecode(state_data,
+                                      frame_type,
+                                      (UWord8 *)(stream + pos + 1),
+                                      pcm_out + frames * L_FRAME,
+                                      MIME_IETF);
+        if (bytes_read < 0)
+        {
+            *frames_decoded = frames;
+            *bytes_consumed = pos;
+            return -1;
+        }
+
+        pos += 1 + data_bytes;
+        frames += 1;
+    }
+
+    *frames_decoded = frames;
+    *bytes_consumed = pos;
+    return 0;
+}
@@ -22,6 +22,7 @@
 
 #include <audio_utils/sndfile.h>
 #include <stdio.h>
+#include <vector>
 
 #include "gsmamr_dec.h"
 
@@ -158,6 +159,66 @@ TEST_P(AmrnbDecoderTest, ResetDecodeTest) {
     ASSERT_EQ(amrHandle, nullptr) << "Error deleting AMR-NB decoder";
 }
 
+TEST_P(AmrnbDecoderTest, BatchDecodeTest) {
+    string inputFile = gEnv->getRes() + GetParam();
+    mFpInput = fopen(inputFile.c_str(), "rb");
+    ASSERT_NE(mFpInput, nullptr) << "Error opening input file " << inputFile;
+
+    // Read the whole stream into memory.
+    fseek(mFpInput, 0, SEEK_END);
+    long fileSize = ftell(mFpInput);
+    fseek(mFpInput, 0, SEEK_SET);
+    ASSERT_GT(fileSize, 0) << "Empty input file " << inputFile;
+    vector<uint8_t> stream(fileSize);
+    ASSERT_EQ(fread(stream.data(), 1, fileSize, mFpInput), (size_t)fileSize)
+            << "Error reading input file " << inputFile;
+
+    // Count the frames in the stream.
+    int32_t numFrames = 0;
+    for (long pos = 0; pos < fileSize;) {
+        int32_t frameSize = kFrameSizes[(stream[pos] >> 3) & 0x0f];
+        ASSERT_GE(frameSize, 0) << "Illegal frame type";
+        if (pos + 1 + frameSize > fileSize) break;
+        pos += 1 + frameSize;
+        numFrames++;
+    }
+    ASSERT_GT(numFrames, 0) << "No complete frames in " << inputFile;
+
+    // Decode frame by frame.
+    void *amrHandle;
+    int32_t status = GSMInitDecode(&amrHandle, (Word8 *)"AMRNBDecoder");
+    ASSERT_EQ(status, 0) << "Error creating AMR-NB decoder";
+
+    vector<int16_t> refOutput(numFrames * kSamplesPerFrame);
+    long pos = 0;
+    for (int32_t frame = 0; frame < numFrames; frame++) {
+        Frame_Type_3GPP frameType = (Frame_Type_3GPP)((stream[pos] >> 3) & 0x0f);
+        int32_t bytesDecoded = AMRDecode(amrHandle, frameType, &stream[pos + 1],
+                                         &refOutput[frame * kSamplesPerFrame], MIME_IETF);
+        ASSERT_NE(bytesDecoded, -1) << "Failed to decode the input file";
+        pos += 1 + kFrameSizes[frameType];
+    }
+    GSMDecodeFrameExit(&amrHandle);
+
+    // Decode the same stream in one batch call.
+    status = GSMInitDecode(&amrHandle, (Word8 *)"AMRNBDecoder");
+    ASSERT_EQ(status, 0) << "Error creating AMR-NB decoder";
+
+    vector<int16_t> batchOutput(numFrames * kSamplesPerFrame);
+    Word32 framesDecoded = 0;
+    Word32 bytesConsumed = 0;
+    status = GSMAMRDecodeBatch(amrHandle, stream.data(), fileSize, -1, batchOutput.data(),
+                               &framesDecoded, &bytesConsumed);
+    ASSERT_EQ(status, 0) << "GSMAMRDecodeBatch returned error";
+    ASSERT_EQ(framesDecoded, numFrames) << "Batch decode produced wrong frame count";
+    ASSERT_EQ(bytesConsumed, pos) << "Batch decode consumed wrong byte count";
+
+    EXPECT_EQ(refOutput, batchOutput) << "Batch decode output differs from per-frame decode";
+
+    GSMDecodeFrameExit(&amrHandle);
+    ASSERT_EQ(amrHandle, nullptr) << "Error deleting AMR-NB decoder";
+}
+
 INSTANTIATE_TEST_SUITE_P(AmrnbDecoderTestAll, AmrnbDecoderTest,
                          ::testing::Values(("bbb_8000hz_1ch_8kbps_amrnb_30sec.amrnb"),
                                            ("sine_amrnb_1ch_12kbps_8000hz.amrnb")));
@@ -184,6 +184,26 @@ extern "C"
         Word16 output_format
     );
 
+    /*
+     * AMREncodeBatch encodes num_frames contiguous frames of L_FRAME samples
+     * each from pEncInput in a single call, packing the encoded frames back
+     * to back into pEncOutput. On return, p_bytes_used holds the number of
+     * output bytes produced. A zero is returned on success; a negative one
+     * is returned if the output buffer may not fit another frame or the
+     * encoder reports an error.
+     */
+    int AMREncodeBatch(
+        void *pEncState,
+        void *pSidSyncState,
+        enum Mode mode,
+        Word16 *pEncInput,
+        Word32 num_frames,
+        unsigned char *pEncOutput,
+        Word32 output_capacity,
+        Word32 *p_bytes_used,
+        Word16 output_format
+    );
+
 #ifdef __cplusplus
 }
 #endif
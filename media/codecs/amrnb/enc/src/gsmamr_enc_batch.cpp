@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Batch entry point for the GSM AMR encoder. Offline transcoders encode
+ * long captures one 20 ms frame per AMREncode() call; this encodes a
+ * buffer of num_frames contiguous frames in one call with the encoder
+ * and SID sync state kept hot, packing the output frames back to back.
+ */
+
+#include "gsmamr_enc.h"
+
+/* Largest packed frame any output format can produce (12.2 kbps, WMF). */
+#define MAX_PACKED_FRAME_BYTES 32
+
+int AMREncodeBatch(
+    void *pEncState,
+    void *pSidSyncState,
+    enum Mode mode,
+    Word16 *pEncInput,
+    Word32 num_frames,
+    unsigned char *pEncOutput,
+    Word32 output_capacity,
+    Word32 *p_bytes_used,
+    Word16 output_format)
+{
+    Word32 frame;
+    Word32 bytes_used = 0;
+
+    if (pEncState == NULL || pSidSyncState == NULL || pEncInput == NULL ||
+            pEncOutput == NULL || p_bytes_used == NULL)
+    {
+        return -1;
+    }
+    *p_bytes_used = 0;
+
+    for (frame = 0; frame < num_frames; frame++)
+    {
+        enum Frame_Type_3GPP frame_type;
+        int enc_bytes;
+
+        if (output_capacity - bytes_used < MAX_PACKED_FRAME_BYTES)
+        {
+            /* not enough room guaranteed for another frame */
+            *p_bytes_used = bytes_used;
+            return -1;
+        }
+
+        enc_bytes = AMREncode(pEncState,
+                              pSidSyncState,
+                              mode,
+                              pEncInput + frame * L_FRAME,
+                              pEncOutput + bytes_used,
+                              &frame_type,
+                              output_format);
+        if (enc_bytes < 0)
+        {
+            *p_bytes_used = bytes_used;
+            return -1;
+        }
+
+        bytes_used += enc_bytes;
+    }
+
+    *p_bytes_used = bytes_used;
+    return 0;
+}
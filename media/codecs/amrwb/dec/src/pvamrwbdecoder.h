@@ -143,6 +143,26 @@ typedef struct
                         uint8 q,
                         RX_State_wb *st);
 
+    /*
+     * Decodes a buffer of concatenated MIME/IETF (RFC 4867) storage frames
+     * in a single call, writing 320 samples per frame to pcm_out. At most
+     * max_frames frames are decoded (pass a negative value for no limit);
+     * a truncated trailing frame is left unconsumed. On return,
+     * frames_decoded and bytes_consumed describe how far the call got.
+     * Returns zero on success, negative one on an illegal frame type or a
+     * decoder error.
+     */
+    int32 pvDecoder_AmrWb_Batch(
+        const uint8 *stream,
+        int32 stream_bytes,
+        int32 max_frames,
+        int16 *pcm_out,
+        int32 *frames_decoded,
+        int32 *bytes_consumed,
+        void *spd_state,
+        int16 ScratchMem[],
+        RX_State_wb *rx_state);
+
 
     /*----------------------------------------------------------------------------
     ; END
@@ -0,0 +1,126 @@
+/* ------------------------------------------------------------------
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ * -------------------------------------------------------------------
+ */
+
+/*
+ * Batch entry point for the AMR-WB decoder. Offline transcoders decode
+ * long streams one 20 ms frame per pvDecoder_AmrWb() call, paying call
+ * and unsorting setup overhead per frame; this walks a whole buffer of
+ * concatenated MIME/IETF (RFC 4867) storage frames in one call with the
+ * decoder state kept hot.
+ */
+
+#include <string.h>
+
+#include "pv_amr_wb_type_defs.h"
+#include "pvamrwbdecoder_api.h"
+#include "pvamrwbdecoder.h"
+
+#define SAMPLES_PER_FRAME 320
+
+/*
+ * Data bytes per AMR-WB MIME/IETF frame type, not counting the leading
+ * TOC byte. Entries of -1 mark frame types that cannot appear in the
+ * storage format.
+ */
+static const int16 kWbFrameDataBytes[16] =
+{
+    17, 23, 32, 36, 40, 46, 50, 58, 60,  /* 6.60 ... 23.85 kbps speech */
+    5,                                   /* SID                        */
+    -1, -1, -1, -1,                      /* reserved                   */
+    0, 0                                 /* speech lost, no data       */
+};
+
+int32 pvDecoder_AmrWb_Batch(
+    const uint8 *stream,
+    int32 stream_bytes,
+    int32 max_frames,
+    int16 *pcm_out,
+    int32 *frames_decoded,
+    int32 *bytes_consumed,
+    void *spd_state,
+    int16 ScratchMem[],
+    RX_State_wb *rx_state)
+{
+    int32 pos = 0;
+    int32 frames = 0;
+    int16 prms[KAMRWB_NB_BITS_MAX];
+
+    if (stream == NULL || pcm_out == NULL || frames_decoded == NULL ||
+            bytes_consumed == NULL || spd_state == NULL ||
+            ScratchMem == NULL || rx_state == NULL)
+    {
+        return -1;
+    }
+    *frames_decoded = 0;
+    *bytes_consumed = 0;
+
+    while (pos < stream_bytes && (max_frames < 0 || frames < max_frames))
+    {
+        int16 mode = (int16)((stream[pos] >> 3) & 0x0f);
+        int16 data_bytes = kWbFrameDataBytes[mode];
+        int16 *synth = pcm_out + frames * SAMPLES_PER_FRAME;
+
+        if (data_bytes < 0)
+        {
+            /* illegal frame type: report what was decoded so far */
+            *frames_decoded = frames;
+            *bytes_consumed = pos;
+            return -1;
+        }
+        if (pos + 1 + data_bytes > stream_bytes)
+        {
+            /* truncated trailing frame: stop cleanly */
+            break;
+        }
+
+        if (mode >= 9)
+        {
+            /* Produce silence for comfort noise, speech lost and no data. */
+            memset(synth, 0, SAMPLES_PER_FRAME * sizeof(int16));
+        }
+        else
+        {
+            int16 frame_type;
+            int16 frame_length;
+            int16 i;
+
+            mime_unsorting((uint8 *)(stream + pos + 1), prms,
+                           &frame_type, &mode, 1, rx_state);
+            pvDecoder_AmrWb(mode, prms, synth, &frame_length,
+                            spd_state, frame_type, ScratchMem);
+            if (frame_length != SAMPLES_PER_FRAME)
+            {
+                *frames_decoded = frames;
+                *bytes_consumed = pos;
+                return -1;
+            }
+            /* Delete the 2 LSBs (14-bit output) */
+            for (i = 0; i < frame_length; i++)
+            {
+                synth[i] &= 0xfffc;
+            }
+        }
+
+        pos += 1 + data_bytes;
+        frames += 1;
+    }
+
+    *frames_decoded = frames;
+    *bytes_consumed = pos;
+    return 0;
+}
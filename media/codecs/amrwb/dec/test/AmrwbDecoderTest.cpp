@@ -22,6 +22,7 @@
 
 #include <audio_utils/sndfile.h>
 #include <stdio.h>
+#include <vector>
 
 #include "pvamrwbdecoder.h"
 #include "pvamrwbdecoder_api.h"
@@ -206,6 +207,97 @@ TEST_P(AmrwbDecoderTest, ResetDecoderTest) {
     }
 }
 
+TEST_P(AmrwbDecoderTest, BatchDecodeTest) {
+    // Data bytes per frame type as consumed by pvDecoder_AmrWb_Batch: SID,
+    // speech lost and no data frames still advance through the stream.
+    static const int32_t kBatchFrameSizes[16] = {17, 23, 32, 36, 40, 46, 50, 58, 60,
+                                                 5,  -1, -1, -1, -1, 0,  0};
+
+    string inputFile = gEnv->getRes() + GetParam();
+    mFpInput = fopen(inputFile.c_str(), "rb");
+    ASSERT_NE(mFpInput, nullptr) << "Error opening input file " << inputFile;
+
+    // Read the whole stream into memory.
+    fseek(mFpInput, 0, SEEK_END);
+    long fileSize = ftell(mFpInput);
+    fseek(mFpInput, 0, SEEK_SET);
+    ASSERT_GT(fileSize, 0) << "Empty input file " << inputFile;
+    vector<uint8_t> stream(fileSize);
+    ASSERT_EQ(fread(stream.data(), 1, fileSize, mFpInput), (size_t)fileSize)
+            << "Error reading input file " << inputFile;
+
+    // Count the frames in the stream.
+    int32_t numFrames = 0;
+    long streamEnd = 0;
+    for (long pos = 0; pos < fileSize;) {
+        int32_t frameSize = kBatchFrameSizes[(stream[pos] >> 3) & 0x0f];
+        ASSERT_GE(frameSize, 0) << "Illegal frame mode";
+        if (pos + 1 + frameSize > fileSize) break;
+        pos += 1 + frameSize;
+        streamEnd = pos;
+        numFrames++;
+    }
+    ASSERT_GT(numFrames, 0) << "No complete frames in " << inputFile;
+
+    uint32_t memRequirements = pvDecoder_AmrWbMemRequirements();
+    void *decoderBuf = malloc(memRequirements);
+    ASSERT_NE(decoderBuf, nullptr)
+            << "Failed to allocate decoder memory of size " << memRequirements;
+
+    // Decode frame by frame.
+    void *amrHandle = nullptr;
+    int16_t *decoderCookie;
+    pvDecoder_AmrWb_Init(&amrHandle, decoderBuf, &decoderCookie);
+    ASSERT_NE(amrHandle, nullptr) << "Failed to initialize decoder";
+
+    int16_t inputSampleBuf[kMaxSourceDataUnitSize];
+    RX_State_wb rx_state{};
+    vector<int16_t> refOutput(numFrames * kSamplesPerFrame);
+    long pos = 0;
+    for (int32_t frame = 0; frame < numFrames; frame++) {
+        int16 mode = ((stream[pos] >> 3) & 0x0f);
+        int16_t *output = &refOutput[frame * kSamplesPerFrame];
+        if (mode >= 9) {
+            memset(output, 0, kSamplesPerFrame * sizeof(int16_t));
+        } else {
+            int16 frameType;
+            mime_unsorting(&stream[pos + 1], inputSampleBuf, &frameType, &mode, 1, &rx_state);
+
+            int16_t numSamplesOutput;
+            pvDecoder_AmrWb(mode, inputSampleBuf, output, &numSamplesOutput, decoderBuf,
+                            frameType, decoderCookie);
+            ASSERT_EQ(numSamplesOutput, kSamplesPerFrame) << "Failed to decode the input file";
+            for (int count = 0; count < kSamplesPerFrame; ++count) {
+                /* Delete the 2 LSBs (14-bit output) */
+                output[count] &= 0xfffc;
+            }
+        }
+        pos += 1 + kBatchFrameSizes[(stream[pos] >> 3) & 0x0f];
+    }
+
+    // Decode the same stream in one batch call on a fresh decoder.
+    pvDecoder_AmrWb_Init(&amrHandle, decoderBuf, &decoderCookie);
+    ASSERT_NE(amrHandle, nullptr) << "Failed to initialize decoder";
+
+    vector<int16_t> batchOutput(numFrames * kSamplesPerFrame);
+    RX_State_wb batchRxState{};
+    int32_t framesDecoded = 0;
+    int32_t bytesConsumed = 0;
+    int32_t status = pvDecoder_AmrWb_Batch(stream.data(), fileSize, -1, batchOutput.data(),
+                                           &framesDecoded, &bytesConsumed, decoderBuf,
+                                           decoderCookie, &batchRxState);
+    ASSERT_EQ(status, 0) << "pvDecoder_AmrWb_Batch returned error";
+    ASSERT_EQ(framesDecoded, numFrames) << "Batch decode produced wrong frame count";
+    ASSERT_EQ(bytesConsumed, streamEnd) << "Batch decode consumed wrong byte count";
+
+    EXPECT_EQ(refOutput, batchOutput) << "Batch decode output differs from per-frame decode";
+
+    if (decoderBuf) {
+        free(decoderBuf);
+        decoderBuf = nullptr;
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(AmrwbDecoderTestAll, AmrwbDecoderTest,
                          ::testing::Values(("bbb_amrwb_1ch_14kbps_16000hz.amrwb"),
                                            ("bbb_16000hz_1ch_9kbps_amrwb_30sec.amrwb")));
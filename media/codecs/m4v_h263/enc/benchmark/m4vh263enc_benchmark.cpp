@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Encoder throughput benchmark so that regressions in the SAD / DCT /
+ * interpolation kernels are visible. Frames are synthesized in memory:
+ * a smooth gradient with pseudo-random noise and a moving rectangle, so
+ * motion estimation has real work to do without needing input files.
+ *
+ * Run with: m4vh263enc_benchmark
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "mp4enc_api.h"
+
+namespace {
+
+constexpr int32_t kFrameRate = 30;
+constexpr int32_t kBitrateKbps = 512;
+constexpr int32_t kNumFrames = 32;
+constexpr size_t kOutputBufferSize = 250 * 1024;
+
+void fillFrame(uint8_t *frame, int32_t width, int32_t height, int32_t n) {
+    uint8_t *y = frame;
+    uint8_t *u = y + width * height;
+    uint8_t *v = u + (width * height) / 4;
+    uint32_t seed = 0x12345678u + n;
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
+            seed = seed * 1664525u + 1013904223u;
+            y[i * width + j] = ((i + j) & 0xFF) ^ (seed >> 29);
+        }
+    }
+    // moving rectangle, 2 pixels per frame
+    int32_t x0 = (2 * n) % (width - 32);
+    int32_t y0 = (n) % (height - 32);
+    for (int32_t i = y0; i < y0 + 32; i++) {
+        memset(&y[i * width + x0], 0xD0, 32);
+    }
+    memset(u, 0x80, (width * height) / 4);
+    memset(v, 0x80, (width * height) / 4);
+}
+
+void encodeFrames(benchmark::State &state, bool isH263mode,
+                  int32_t width, int32_t height) {
+    const int32_t frameSize = (width * height * 3) / 2;
+    std::vector<uint8_t> frames(frameSize * kNumFrames);
+    for (int32_t n = 0; n < kNumFrames; n++) {
+        fillFrame(&frames[n * frameSize], width, height, n);
+    }
+    std::vector<uint8_t> outputBuf(kOutputBufferSize);
+
+    for (auto _ : state) {
+        tagvideoEncOptions encParams;
+        memset(&encParams, 0, sizeof(tagvideoEncOptions));
+        if (!PVGetDefaultEncOption(&encParams, 0)) {
+            state.SkipWithError("PVGetDefaultEncOption failed");
+            return;
+        }
+        encParams.encMode = isH263mode ? H263_MODE : COMBINE_MODE_WITH_ERR_RES;
+        encParams.encWidth[0] = width;
+        encParams.encHeight[0] = height;
+        encParams.encFrameRate[0] = kFrameRate;
+        encParams.rcType = VBR_1;
+        encParams.vbvDelay = 5.0f;
+        encParams.profile_level = CORE_PROFILE_LEVEL2;
+        encParams.packetSize = 32;
+        encParams.rvlcEnable = PV_OFF;
+        encParams.numLayers = 1;
+        encParams.timeIncRes = 1000;
+        encParams.tickPerSrc = encParams.timeIncRes / kFrameRate;
+        encParams.bitRate[0] = kBitrateKbps * 1024;
+        encParams.iQuant[0] = 15;
+        encParams.pQuant[0] = 12;
+        encParams.quantType[0] = 0;
+        encParams.noFrameSkipped = PV_OFF;
+        encParams.intraPeriod = kFrameRate; // one I frame per second
+        encParams.numIntraMB = 0;
+        encParams.sceneDetect = PV_ON;
+        encParams.searchRange = 16;
+        encParams.mv8x8Enable = PV_OFF;
+        encParams.gobHeaderInterval = 0;
+        encParams.useACPred = PV_ON;
+        encParams.intraDCVlcTh = 0;
+
+        tagvideoEncControls handle;
+        memset(&handle, 0, sizeof(tagvideoEncControls));
+        if (!PVInitVideoEncoder(&handle, &encParams)) {
+            state.SkipWithError("PVInitVideoEncoder failed");
+            return;
+        }
+
+        for (int32_t n = 0; n < kNumFrames; n++) {
+            VideoEncFrameIO vin, vout;
+            memset(&vin, 0, sizeof(vin));
+            memset(&vout, 0, sizeof(vout));
+            vin.height = height;
+            vin.pitch = width;
+            vin.timestamp = (n * 1000) / kFrameRate; // in ms
+            vin.yChan = &frames[n * frameSize];
+            vin.uChan = vin.yChan + height * width;
+            vin.vChan = vin.uChan + ((height * width) >> 2);
+
+            uint32_t modTimeMs = 0;
+            int32_t nLayer = 0;
+            int32_t dataLength = kOutputBufferSize;
+            if (!PVEncodeVideoFrame(&handle, &vin, &vout, &modTimeMs,
+                                    outputBuf.data(), &dataLength, &nLayer)) {
+                state.SkipWithError("PVEncodeVideoFrame failed");
+                PVCleanUpVideoEncoder(&handle);
+                return;
+            }
+            benchmark::DoNotOptimize(dataLength);
+        }
+
+        PVCleanUpVideoEncoder(&handle);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * kNumFrames);
+}
+
+void BM_Mpeg4Encode(benchmark::State &state) {
+    encodeFrames(state, false /* isH263mode */, state.range(0), state.range(1));
+}
+
+void BM_H263Encode(benchmark::State &state) {
+    encodeFrames(state, true /* isH263mode */, state.range(0), state.range(1));
+}
+
+BENCHMARK(BM_Mpeg4Encode)
+    ->Args({176, 144})
+    ->Args({352, 288})
+    ->Args({720, 480})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_H263Encode)
+    ->Args({176, 144})
+    ->Args({352, 288})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
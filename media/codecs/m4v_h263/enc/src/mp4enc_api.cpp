@@ -20,6 +20,7 @@
 #include "bitstream_io.h"
 #include "rate_control.h"
 #include "m4venc_oscl.h"
+#include "sad_simd.h"
 
 #ifndef INT32_MAX
 #define INT32_MAX 0x7fffffff
@@ -1087,6 +1088,13 @@ OSCL_EXPORT_REF Bool    PVInitVideoEncoder(VideoEncControls *encoderControl, Vid
     video->functionPointer->SAD_Block = &SAD_Block_C;
 #endif
     video->functionPointer->SAD_Macroblock = &SAD_Macroblock_C;
+#ifdef M4VENC_SIMD
+    /* vector kernels for the motion estimation hot path, see sad_simd.h */
+    video->functionPointer->SAD_MB_HalfPel[1] = &SAD_MB_HalfPel_SIMDxh;
+    video->functionPointer->SAD_MB_HalfPel[2] = &SAD_MB_HalfPel_SIMDyh;
+    video->functionPointer->SAD_MB_HalfPel[3] = &SAD_MB_HalfPel_SIMDxhyh;
+    video->functionPointer->SAD_Macroblock = &SAD_Macroblock_SIMD;
+#endif
     video->functionPointer->ChooseMode = &ChooseMode_C;
     video->functionPointer->GetHalfPelMBRegion = &GetHalfPelMBRegion_C;
 //  video->functionPointer->SAD_MB_PADDING = &SAD_MB_PADDING; /* 4/21/01 */
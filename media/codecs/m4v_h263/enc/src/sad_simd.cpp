@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mp4def.h"
+#include "mp4enc_api.h"  /* for OSCL_UNUSED_ARG */
+#include "sad_simd.h"
+
+#ifdef M4VENC_SIMD
+
+/* In all kernels below ref has stride lx (or rx) and may be unaligned;
+   blk is the current macroblock with a fixed stride of 16 (see
+   simd_sad_mb() in sad_inline.h and SAD_MB_HalfPel_C* in sad_halfpel.cpp
+   for the layout the scalar code assumes). */
+
+#if defined(__ARM_NEON__) || defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    static inline Int sum_u16x8(uint16x8_t v)
+    {
+#if defined(__aarch64__)
+        return (Int)vaddvq_u16(v);
+#else
+        uint32x4_t x = vpaddlq_u16(v);
+        uint64x2_t y = vpaddlq_u32(x);
+        return (Int)(vgetq_lane_u64(y, 0) + vgetq_lane_u64(y, 1));
+#endif
+    }
+
+    Int SAD_Macroblock_SIMD(UChar *ref, UChar *blk, Int dmin_lx, void *extra_info)
+    {
+        Int dmin = (ULong)dmin_lx >> 16;
+        Int lx = dmin_lx & 0xFFFF;
+        Int sad = 0;
+        Int i, j;
+
+        OSCL_UNUSED_ARG(extra_info);
+
+        for (i = 0; i < 4; i++)
+        {
+            /* each lane accumulates at most 4*2*255, so u16 cannot overflow */
+            uint16x8_t acc = vdupq_n_u16(0);
+            for (j = 0; j < 4; j++)
+            {
+                uint8x16_t r = vld1q_u8(ref);
+                uint8x16_t b = vld1q_u8(blk);
+                acc = vabal_u8(acc, vget_low_u8(r), vget_low_u8(b));
+                acc = vabal_u8(acc, vget_high_u8(r), vget_high_u8(b));
+                ref += lx;
+                blk += 16;
+            }
+            sad += sum_u16x8(acc);
+            if (sad > dmin)
+                return sad;
+        }
+        return sad;
+    }
+
+    /* One component is half-pel: p2 is either ref+1 or ref+rx. */
+    static Int sad_mb_halfpel1(UChar *p1, UChar *p2, UChar *blk, Int dmin, Int rx)
+    {
+        Int sad = 0;
+        Int i, j;
+
+        for (i = 0; i < 4; i++)
+        {
+            uint16x8_t acc = vdupq_n_u16(0);
+            for (j = 0; j < 4; j++)
+            {
+                /* vrhaddq rounds like the scalar (a+b+1)>>1 */
+                uint8x16_t avg = vrhaddq_u8(vld1q_u8(p1), vld1q_u8(p2));
+                uint8x16_t b = vld1q_u8(blk);
+                acc = vabal_u8(acc, vget_low_u8(avg), vget_low_u8(b));
+                acc = vabal_u8(acc, vget_high_u8(avg), vget_high_u8(b));
+                p1 += rx;
+                p2 += rx;
+                blk += 16;
+            }
+            sad += sum_u16x8(acc);
+            if (sad > dmin)
+                return sad;
+        }
+        return sad;
+    }
+
+    Int SAD_MB_HalfPel_SIMDxh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info)
+    {
+        Int rx = dmin_rx & 0xFFFF;
+
+        OSCL_UNUSED_ARG(extra_info);
+
+        return sad_mb_halfpel1(ref, ref + 1, blk, (Int)((ULong)dmin_rx >> 16), rx);
+    }
+
+    Int SAD_MB_HalfPel_SIMDyh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info)
+    {
+        Int rx = dmin_rx & 0xFFFF;
+
+        OSCL_UNUSED_ARG(extra_info);
+
+        return sad_mb_halfpel1(ref, ref + rx, blk, (Int)((ULong)dmin_rx >> 16), rx);
+    }
+
+    /* Two components are half-pel; widen to 16 bits so the rounding matches
+       the scalar (p1+p2+p3+p4+2)>>2 exactly. */
+    Int SAD_MB_HalfPel_SIMDxhyh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info)
+    {
+        Int dmin = (ULong)dmin_rx >> 16;
+        Int rx = dmin_rx & 0xFFFF;
+        Int sad = 0;
+        Int i, j;
+
+        OSCL_UNUSED_ARG(extra_info);
+
+        for (i = 0; i < 4; i++)
+        {
+            uint16x8_t acc = vdupq_n_u16(0);
+            for (j = 0; j < 4; j++)
+            {
+                uint8x16_t p1 = vld1q_u8(ref);
+                uint8x16_t p2 = vld1q_u8(ref + 1);
+                uint8x16_t p3 = vld1q_u8(ref + rx);
+                uint8x16_t p4 = vld1q_u8(ref + rx + 1);
+                uint8x16_t b = vld1q_u8(blk);
+
+                uint16x8_t lo = vaddl_u8(vget_low_u8(p1), vget_low_u8(p2));
+                lo = vaddw_u8(lo, vget_low_u8(p3));
+                lo = vaddw_u8(lo, vget_low_u8(p4));
+                uint16x8_t hi = vaddl_u8(vget_high_u8(p1), vget_high_u8(p2));
+                hi = vaddw_u8(hi, vget_high_u8(p3));
+                hi = vaddw_u8(hi, vget_high_u8(p4));
+
+                /* vrshrn adds the rounding constant 2 before shifting */
+                acc = vabal_u8(acc, vrshrn_n_u16(lo, 2), vget_low_u8(b));
+                acc = vabal_u8(acc, vrshrn_n_u16(hi, 2), vget_high_u8(b));
+
+                ref += rx;
+                blk += 16;
+            }
+            sad += sum_u16x8(acc);
+            if (sad > dmin)
+                return sad;
+        }
+        return sad;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    static inline Int sum_sad(__m128i v)
+    {
+        /* _mm_sad_epu8 leaves two partial sums in the low words of each
+           64-bit half */
+        return _mm_cvtsi128_si32(v) + _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    }
+
+    Int SAD_Macroblock_SIMD(UChar *ref, UChar *blk, Int dmin_lx, void *extra_info)
+    {
+        Int dmin = (ULong)dmin_lx >> 16;
+        Int lx = dmin_lx & 0xFFFF;
+        Int sad = 0;
+        Int i, j;
+
+        OSCL_UNUSED_ARG(extra_info);
+
+        for (i = 0; i < 4; i++)
+        {
+            __m128i acc = _mm_setzero_si128();
+            for (j = 0; j < 4; j++)
+            {
+                __m128i r = _mm_loadu_si128((const __m128i*)ref);
+                __m128i b = _mm_loadu_si128((const __m128i*)blk);
+                acc = _mm_add_epi32(acc, _mm_sad_epu8(r, b));
+                ref += lx;
+                blk += 16;
+            }
+            sad += sum_sad(acc);
+            if (sad > dmin)
+                return sad;
+        }
+        return sad;
+    }
+
+    /* One component is half-pel: p2 is either ref+1 or ref+rx. */
+    static Int sad_mb_halfpel1(UChar *p1, UChar *p2, UChar *blk, Int dmin, Int rx)
+    {
+        Int sad = 0;
+        Int i, j;
+
+        for (i = 0; i < 4; i++)
+        {
+            __m128i acc = _mm_setzero_si128();
+            for (j = 0; j < 4; j++)
+            {
+                /* _mm_avg_epu8 rounds like the scalar (a+b+1)>>1 */
+                __m128i avg = _mm_avg_epu8(
+                        _mm_loadu_si128((const __m128i*)p1),
+                        _mm_loadu_si128((const __m128i*)p2));
+                __m128i b = _mm_loadu_si128((const __m128i*)blk);
+                acc = _mm_add_epi32(acc, _mm_sad_epu8(avg, b));
+                p1 += rx;
+                p2 += rx;
+                blk += 16;
+            }
+            sad += sum_sad(acc);
+            if (sad > dmin)
+                return sad;
+        }
+        return sad;
+    }
+
+    Int SAD_MB_HalfPel_SIMDxh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info)
+    {
+        Int rx = dmin_rx & 0xFFFF;
+
+        OSCL_UNUSED_ARG(extra_info);
+
+        return sad_mb_halfpel1(ref, ref + 1, blk, (Int)((ULong)dmin_rx >> 16), rx);
+    }
+
+    Int SAD_MB_HalfPel_SIMDyh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info)
+    {
+        Int rx = dmin_rx & 0xFFFF;
+
+        OSCL_UNUSED_ARG(extra_info);
+
+        return sad_mb_halfpel1(ref, ref + rx, blk, (Int)((ULong)dmin_rx >> 16), rx);
+    }
+
+    /* Two components are half-pel; widen to 16 bits so the rounding matches
+       the scalar (p1+p2+p3+p4+2)>>2 exactly. */
+    Int SAD_MB_HalfPel_SIMDxhyh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info)
+    {
+        Int dmin = (ULong)dmin_rx >> 16;
+        Int rx = dmin_rx & 0xFFFF;
+        Int sad = 0;
+        Int i, j;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+
+        OSCL_UNUSED_ARG(extra_info);
+
+        for (i = 0; i < 4; i++)
+        {
+            __m128i acc = _mm_setzero_si128();
+            for (j = 0; j < 4; j++)
+            {
+                __m128i p1 = _mm_loadu_si128((const __m128i*)ref);
+                __m128i p2 = _mm_loadu_si128((const __m128i*)(ref + 1));
+                __m128i p3 = _mm_loadu_si128((const __m128i*)(ref + rx));
+                __m128i p4 = _mm_loadu_si128((const __m128i*)(ref + rx + 1));
+                __m128i b = _mm_loadu_si128((const __m128i*)blk);
+
+                __m128i lo = _mm_add_epi16(
+                        _mm_add_epi16(_mm_unpacklo_epi8(p1, zero),
+                                      _mm_unpacklo_epi8(p2, zero)),
+                        _mm_add_epi16(_mm_unpacklo_epi8(p3, zero),
+                                      _mm_unpacklo_epi8(p4, zero)));
+                __m128i hi = _mm_add_epi16(
+                        _mm_add_epi16(_mm_unpackhi_epi8(p1, zero),
+                                      _mm_unpackhi_epi8(p2, zero)),
+                        _mm_add_epi16(_mm_unpackhi_epi8(p3, zero),
+                                      _mm_unpackhi_epi8(p4, zero)));
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+
+                __m128i avg = _mm_packus_epi16(lo, hi);
+                acc = _mm_add_epi32(acc, _mm_sad_epu8(avg, b));
+
+                ref += rx;
+                blk += 16;
+            }
+            sad += sum_sad(acc);
+            if (sad > dmin)
+                return sad;
+        }
+        return sad;
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* instruction set */
+
+#endif /* M4VENC_SIMD */
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _SAD_SIMD_H_
+#define _SAD_SIMD_H_
+
+#include "mp4def.h"
+
+/* Vector SAD kernels for the motion estimation hot path.
+ *
+ * The kernels compute the same SAD values as the C versions in sad.cpp and
+ * sad_halfpel.cpp; the only difference is that the early dropout against
+ * dmin is checked every four rows instead of every row, which can change
+ * the partial sum returned for rejected candidates but never the search
+ * decision.
+ *
+ * They are selected at encoder initialization through the platform function
+ * pointer table (see PVInitVideoEncoder()). M4VENC_SIMD is defined when the
+ * build target guarantees the instruction set, which is the case for NEON
+ * on ARM targets and SSE2 on x86 targets, so no cpu probing is needed. */
+
+#if defined(__ARM_NEON__) || defined(__aarch64__) || defined(__SSE2__)
+#define M4VENC_SIMD 1
+#endif
+
+#ifdef M4VENC_SIMD
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    Int SAD_Macroblock_SIMD(UChar *ref, UChar *blk, Int dmin_lx, void *extra_info);
+
+    Int SAD_MB_HalfPel_SIMDxh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info);
+    Int SAD_MB_HalfPel_SIMDyh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info);
+    Int SAD_MB_HalfPel_SIMDxhyh(UChar *ref, UChar *blk, Int dmin_rx, void *extra_info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* M4VENC_SIMD */
+
+#endif /* _SAD_SIMD_H_ */
@@ -38,7 +38,8 @@ public:
     AACSource(
             DataSourceHelper *source,
             AMediaFormat *meta,
-            const Vector<uint64_t> &offset_vector,
+            const sp<AdtsFrameIndex> &frameIndex,
+            off64_t firstFrameOffset,
             int64_t frame_duration_us);
 
     virtual media_status_t start();
@@ -61,7 +62,8 @@ private:
     int64_t mCurrentTimeUs;
     bool mStarted;
 
-    Vector<uint64_t> mOffsetVector;
+    sp<AdtsFrameIndex> mFrameIndex;
+    off64_t mFirstFrameOffset;
     int64_t mFrameDurationUs;
 
     AACSource(const AACSource &);
@@ -131,6 +133,53 @@ static size_t getAdtsFrameLength(DataSourceHelper *source, off64_t offset, size_
     return frameSize;
 }
 
+AdtsFrameIndex::AdtsFrameIndex(DataSourceHelper *source, off64_t firstFrameOffset)
+    : mSource(source),
+      mNextFrame(0),
+      mNextOffset(firstFrameOffset),
+      mEos(false) {
+}
+
+bool AdtsFrameIndex::offsetForFrame(int64_t frameIndex, off64_t *offset) {
+    Mutex::Autolock autoLock(mLock);
+
+    if (frameIndex < 0) {
+        return false;
+    }
+
+    // Extend the index when the target lies beyond the scanned region.
+    while (frameIndex >= mNextFrame) {
+        if (mEos) {
+            return false;
+        }
+        size_t frameSize = getAdtsFrameLength(mSource, mNextOffset, NULL);
+        if (frameSize == 0) {
+            mEos = true;
+            return false;
+        }
+        if ((mNextFrame % kFramesPerAnchor) == 0) {
+            mAnchors.push(mNextOffset);
+        }
+        mNextOffset += frameSize;
+        ++mNextFrame;
+    }
+
+    // Local scan from the nearest preceding anchor.
+    int64_t frame = (frameIndex / kFramesPerAnchor) * kFramesPerAnchor;
+    off64_t pos = mAnchors.itemAt(frameIndex / kFramesPerAnchor);
+    while (frame < frameIndex) {
+        size_t frameSize = getAdtsFrameLength(mSource, pos, NULL);
+        if (frameSize == 0) {
+            return false;
+        }
+        pos += frameSize;
+        ++frame;
+    }
+
+    *offset = pos;
+    return true;
+}
+
 AACExtractor::AACExtractor(
         DataSourceHelper *source, off64_t offset)
     : mDataSource(source),
@@ -155,35 +204,44 @@ AACExtractor::AACExtractor(
     MakeAACCodecSpecificData(mMeta, profile, sf_index, channel);
     AMediaFormat_setInt32(mMeta, AMEDIAFORMAT_KEY_AAC_PROFILE, profile + 1);
 
-    off64_t streamSize, numFrames = 0;
-    size_t frameSize = 0;
-    int64_t duration = 0;
+    mFirstFrameOffset = offset;
+    mFrameIndex = new AdtsFrameIndex(mDataSource, offset);
+
+    // Round up and get the per-frame duration
+    mFrameDurationUs = (1024 * 1000000ll + (sr - 1)) / sr;
 
+    // Scan a bounded prefix and estimate the duration from the mean frame
+    // size instead of walking every header in the file; the index fills in
+    // lazily as playback and seeks progress.
+    off64_t streamSize;
     if (mDataSource->getSize(&streamSize) == OK) {
-         while (offset < streamSize) {
-            if ((frameSize = getAdtsFrameLength(source, offset, NULL)) == 0) {
-                ALOGW("prematured AAC stream (%lld vs %lld)",
-                        (long long)offset, (long long)streamSize);
+        const int64_t kDurationScanFrames = 64;
+        off64_t pos = offset;
+        int64_t scannedFrames = 0;
+        size_t frameSize;
+        while (scannedFrames < kDurationScanFrames && pos < streamSize) {
+            if ((frameSize = getAdtsFrameLength(source, pos, NULL)) == 0) {
                 break;
             }
-
-            mOffsetVector.push(offset);
-
-            offset += frameSize;
-            numFrames ++;
+            pos += frameSize;
+            ++scannedFrames;
         }
 
-        // Round up and get the duration
-        mFrameDurationUs = (1024 * 1000000ll + (sr - 1)) / sr;
-        duration = numFrames * mFrameDurationUs;
-        AMediaFormat_setInt64(mMeta, AMEDIAFORMAT_KEY_DURATION, duration);
+        if (scannedFrames > 0) {
+            off64_t avgFrameSize = (pos - offset) / scannedFrames;
+            int64_t numFrames = scannedFrames;
+            if (pos < streamSize && avgFrameSize > 0) {
+                numFrames = (streamSize - offset + avgFrameSize / 2) / avgFrameSize;
+            }
+            AMediaFormat_setInt64(
+                    mMeta, AMEDIAFORMAT_KEY_DURATION, numFrames * mFrameDurationUs);
+        }
     }
 
     mInitCheck = OK;
 }
 
 AACExtractor::~AACExtractor() {
-    mOffsetVector.clear();
     delete mDataSource;
     if (mMeta != nullptr) {
         AMediaFormat_delete(mMeta);
@@ -208,7 +266,7 @@ MediaTrackHelper *AACExtractor::getTrack(size_t index) {
         return NULL;
     }
 
-    return new AACSource(mDataSource, mMeta, mOffsetVector, mFrameDurationUs);
+    return new AACSource(mDataSource, mMeta, mFrameIndex, mFirstFrameOffset, mFrameDurationUs);
 }
 
 media_status_t AACExtractor::getTrackMetaData(AMediaFormat *meta, size_t index, uint32_t /* flags */) {
@@ -227,14 +285,16 @@ const size_t AACSource::kMaxFrameSize = 8192;
 AACSource::AACSource(
         DataSourceHelper *source,
         AMediaFormat *meta,
-        const Vector<uint64_t> &offset_vector,
+        const sp<AdtsFrameIndex> &frameIndex,
+        off64_t firstFrameOffset,
         int64_t frame_duration_us)
     : mDataSource(source),
       mMeta(meta),
       mOffset(0),
       mCurrentTimeUs(0),
       mStarted(false),
-      mOffsetVector(offset_vector),
+      mFrameIndex(frameIndex),
+      mFirstFrameOffset(firstFrameOffset),
       mFrameDurationUs(frame_duration_us) {
 }
 
@@ -247,11 +307,7 @@ AACSource::~AACSource() {
 media_status_t AACSource::start() {
     CHECK(!mStarted);
 
-    if (mOffsetVector.empty()) {
-        mOffset = 0;
-    } else {
-        mOffset = mOffsetVector.itemAt(0);
-    }
+    mOffset = mFirstFrameOffset;
 
     mCurrentTimeUs = 0;
     mBufferGroup->add_buffer(kMaxFrameSize);
@@ -295,13 +351,14 @@ media_status_t AACSource::read(
                     seekFrame = seekTimeUs / mFrameDurationUs;
                     break;
             }
-            if (seekFrame < 0 || seekFrame >= (int64_t)mOffsetVector.size()) {
+            off64_t seekOffset;
+            if (seekFrame < 0 || !mFrameIndex->offsetForFrame(seekFrame, &seekOffset)) {
                 android_errorWriteLog(0x534e4554, "70239507");
                 return AMEDIA_ERROR_MALFORMED;
             }
             mCurrentTimeUs = seekFrame * mFrameDurationUs;
 
-            mOffset = mOffsetVector.itemAt(seekFrame);
+            mOffset = seekOffset;
         }
     }
 
@@ -22,13 +22,48 @@
 #include <media/MediaExtractorPluginHelper.h>
 #include <media/NdkMediaFormat.h>
 
+#include <utils/RefBase.h>
 #include <utils/Vector.h>
+#include <utils/threads.h>
 
 namespace android {
 
 struct AMessage;
 class String8;
 
+// Lazily built sparse index over an ADTS stream, shared by the extractor and
+// its sources. The offset of every kFramesPerAnchor'th frame is recorded as
+// the stream is scanned; a seek jumps to the nearest preceding anchor and
+// walks at most kFramesPerAnchor - 1 headers. The scan only ever extends as
+// far as the latest frame actually asked for, so opening a long file no
+// longer walks every frame in it.
+struct AdtsFrameIndex : public RefBase {
+    // |source| stays owned by the extractor and must outlive this index.
+    AdtsFrameIndex(DataSourceHelper *source, off64_t firstFrameOffset);
+
+    // Stores the byte offset of frame |frameIndex| in |offset|, extending
+    // the index as needed; returns false once the stream ends before the
+    // requested frame.
+    bool offsetForFrame(int64_t frameIndex, off64_t *offset);
+
+private:
+    enum {
+        kFramesPerAnchor = 64,
+    };
+
+    Mutex mLock;
+    DataSourceHelper *mSource;
+    Vector<off64_t> mAnchors;
+    // Scan cursor: frames [0, mNextFrame) are validated and mNextOffset is
+    // where frame mNextFrame would start.
+    int64_t mNextFrame;
+    off64_t mNextOffset;
+    bool mEos;
+
+    AdtsFrameIndex(const AdtsFrameIndex &);
+    AdtsFrameIndex &operator=(const AdtsFrameIndex &);
+};
+
 class AACExtractor : public MediaExtractorPluginHelper {
 public:
     AACExtractor(DataSourceHelper *source, off64_t offset);
@@ -48,7 +83,8 @@ private:
     AMediaFormat *mMeta;
     status_t mInitCheck;
 
-    Vector<uint64_t> mOffsetVector;
+    sp<AdtsFrameIndex> mFrameIndex;
+    off64_t mFirstFrameOffset;
     int64_t mFrameDurationUs;
 
     AACExtractor(const AACExtractor &);
@@ -167,11 +167,26 @@ AMRExtractor::AMRExtractor(DataSourceHelper *source)
     int64_t duration = 0;
 
     if (mDataSource->getSize(&streamSize) == OK) {
+        // Walk the frame headers through a read buffer instead of issuing a
+        // one byte read per 20ms frame; long recordings have tens of
+        // thousands of frames.
+        uint8_t headerBuf[8192];
+        off64_t bufOffset = 0;
+        ssize_t bufFilled = 0;
         while (offset < streamSize) {
-            status_t status = getFrameSizeByOffset(source, offset, mIsWide, &frameSize);
-            if (status == ERROR_END_OF_STREAM) {
-                break;
-            } else if (status != OK) {
+            if (offset < bufOffset || offset >= bufOffset + bufFilled) {
+                bufFilled = mDataSource->readAt(offset, headerBuf, sizeof(headerBuf));
+                if (bufFilled == 0) {
+                    break;
+                } else if (bufFilled < 0) {
+                    return;
+                }
+                bufOffset = offset;
+            }
+
+            unsigned FT = (headerBuf[offset - bufOffset] >> 3) & 0x0f;
+            frameSize = getFrameSize(mIsWide, FT);
+            if (frameSize == 0) {
                 return;
             }
 
@@ -319,18 +334,30 @@ media_status_t AMRSource::read(
         }
     }
 
-    uint8_t header;
-    ssize_t n = mDataSource->readAt(mOffset, &header, 1);
+    MediaBufferHelper *buffer = nullptr;
+    status_t err = mBufferGroup->acquire_buffer(&buffer);
+    if (err != OK || buffer == nullptr) {
+        return AMEDIA_ERROR_UNKNOWN;
+    }
+
+    // A single read covers both the header byte and the frame payload;
+    // the largest frame (AMR-WB frame type 8) is 61 bytes.
+    static const size_t kMaxFrameSize = 61;
+    ssize_t n = mDataSource->readAt(mOffset, buffer->data(), kMaxFrameSize);
 
     if (n < 1) {
+        buffer->release();
         return AMEDIA_ERROR_END_OF_STREAM;
     }
 
+    uint8_t header = ((const uint8_t *)buffer->data())[0];
+
     if (header & 0x83) {
         // Padding bits must be 0.
 
         ALOGE("padding bits must be 0, header is 0x%02x", header);
 
+        buffer->release();
         return AMEDIA_ERROR_MALFORMED;
     }
 
@@ -338,28 +365,15 @@ media_status_t AMRSource::read(
 
     size_t frameSize = getFrameSize(mIsWide, FT);
     if (frameSize == 0) {
+        buffer->release();
         return AMEDIA_ERROR_MALFORMED;
     }
 
-    MediaBufferHelper *buffer = nullptr;
-    status_t err = mBufferGroup->acquire_buffer(&buffer);
-    if (err != OK || buffer == nullptr) {
-        return AMEDIA_ERROR_UNKNOWN;
-    }
-
-    n = mDataSource->readAt(mOffset, buffer->data(), frameSize);
-
-    if (n != (ssize_t)frameSize) {
+    if (n < (ssize_t)frameSize) {
+        // only partial frame is available, treat it as EOS.
         buffer->release();
-        buffer = NULL;
-
-        if (n < 0) {
-            return AMEDIA_ERROR_IO;
-        } else {
-            // only partial frame is available, treat it as EOS.
-            mOffset += n;
-            return AMEDIA_ERROR_END_OF_STREAM;
-        }
+        mOffset += n;
+        return AMEDIA_ERROR_END_OF_STREAM;
     }
 
     buffer->set_range(0, frameSize);
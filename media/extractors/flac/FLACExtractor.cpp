@@ -93,6 +93,10 @@ class FLACParser {
 public:
     enum {
         kMaxChannels = FCC_8,
+        // Decode up to this many consecutive frames per readBuffer() so that
+        // sequential consumers pay the libFLAC callback and MediaBuffer
+        // round-trip once per batch instead of once per frame.
+        kMaxFramesPerBuffer = 4,
     };
 
     explicit FLACParser(
@@ -169,6 +173,7 @@ private:
 
     status_t init();
     MediaBufferHelper *readBuffer(bool doSeek, FLAC__uint64 sample);
+    void copyBlock(void *dst, unsigned blocksize);
 
     // no copy constructor or assignment
     FLACParser(const FLACParser &);
@@ -412,16 +417,36 @@ static void copyTo16Signed(
         unsigned bitsPerSample) {
     const int leftShift = 16 - (int)bitsPerSample; // cast to int to prevent unsigned overflow.
     if (leftShift >= 0) {
-        for (unsigned i = 0; i < nSamples; ++i) {
-            for (unsigned c = 0; c < nChannels; ++c) {
-                *dst++ = src[c][i] << leftShift;
+        // Stereo dominates real content; a dedicated loop with a known trip
+        // count lets the compiler vectorize the shift and interleave.
+        if (nChannels == 2) {
+            const int *left = src[0];
+            const int *right = src[1];
+            for (unsigned i = 0; i < nSamples; ++i) {
+                *dst++ = left[i] << leftShift;
+                *dst++ = right[i] << leftShift;
+            }
+        } else {
+            for (unsigned i = 0; i < nSamples; ++i) {
+                for (unsigned c = 0; c < nChannels; ++c) {
+                    *dst++ = src[c][i] << leftShift;
+                }
             }
         }
     } else {
         const int rightShift = -leftShift;
-        for (unsigned i = 0; i < nSamples; ++i) {
-            for (unsigned c = 0; c < nChannels; ++c) {
-                *dst++ = src[c][i] >> rightShift;
+        if (nChannels == 2) {
+            const int *left = src[0];
+            const int *right = src[1];
+            for (unsigned i = 0; i < nSamples; ++i) {
+                *dst++ = left[i] >> rightShift;
+                *dst++ = right[i] >> rightShift;
+            }
+        } else {
+            for (unsigned i = 0; i < nSamples; ++i) {
+                for (unsigned c = 0; c < nChannels; ++c) {
+                    *dst++ = src[c][i] >> rightShift;
+                }
             }
         }
     }
@@ -434,9 +459,18 @@ static void copyToFloat(
         unsigned nChannels,
         unsigned bitsPerSample) {
     const unsigned leftShift = 32 - bitsPerSample;
-    for (unsigned i = 0; i < nSamples; ++i) {
-        for (unsigned c = 0; c < nChannels; ++c) {
-            *dst++ = float_from_i32(src[c][i] << leftShift);
+    if (nChannels == 2) {
+        const int *left = src[0];
+        const int *right = src[1];
+        for (unsigned i = 0; i < nSamples; ++i) {
+            *dst++ = float_from_i32(left[i] << leftShift);
+            *dst++ = float_from_i32(right[i] << leftShift);
+        }
+    } else {
+        for (unsigned i = 0; i < nSamples; ++i) {
+            for (unsigned c = 0; c < nChannels; ++c) {
+                *dst++ = float_from_i32(src[c][i] << leftShift);
+            }
         }
     }
 }
@@ -561,7 +595,8 @@ status_t FLACParser::init()
         AMediaFormat_setString(mFileMetadata,
                 AMEDIAFORMAT_KEY_MIME, MEDIA_MIMETYPE_AUDIO_FLAC);
     }
-    mMaxBufferSize = getMaxBlockSize() * getChannels() * getOutputSampleSize();
+    mMaxBufferSize = getMaxBlockSize() * getChannels() * getOutputSampleSize()
+            * kMaxFramesPerBuffer;
     AMediaFormat_setInt32(mTrackMetadata, AMEDIAFORMAT_KEY_MAX_INPUT_SIZE, mMaxBufferSize);
     return OK;
 }
@@ -577,6 +612,25 @@ void FLACParser::releaseBuffers()
 {
 }
 
+// copy PCM from FLAC write buffer to our media buffer, with interleaving
+void FLACParser::copyBlock(void *dst, unsigned blocksize)
+{
+    const unsigned bitsPerSample = getBitsPerSample();
+    if (mOutputFloat) {
+        copyToFloat(reinterpret_cast<float*>(dst),
+                    mWriteBuffer,
+                    blocksize,
+                    getChannels(),
+                    bitsPerSample);
+    } else {
+        copyTo16Signed(reinterpret_cast<short*>(dst),
+                       mWriteBuffer,
+                       blocksize,
+                       getChannels(),
+                       bitsPerSample);
+    }
+}
+
 MediaBufferHelper *FLACParser::readBuffer(bool doSeek, FLAC__uint64 sample)
 {
     mWriteRequested = true;
@@ -612,6 +666,9 @@ MediaBufferHelper *FLACParser::readBuffer(bool doSeek, FLAC__uint64 sample)
                 mWriteHeader.sample_rate, mWriteHeader.channels, mWriteHeader.bits_per_sample);
         return NULL;
     }
+    // the buffer takes its timestamp from the first frame of the batch
+    CHECK(mWriteHeader.number_type == FLAC__FRAME_NUMBER_TYPE_SAMPLE_NUMBER);
+    FLAC__uint64 sampleNumber = mWriteHeader.number.sample_number;
     // acquire a media buffer
     CHECK(mGroup != NULL);
     MediaBufferHelper *buffer = nullptr;
@@ -619,27 +676,32 @@ MediaBufferHelper *FLACParser::readBuffer(bool doSeek, FLAC__uint64 sample)
     if (err != OK || buffer == nullptr) {
         return NULL;
     }
-    const size_t bufferSize = blocksize * getChannels() * getOutputSampleSize();
+    const size_t frameSize = getChannels() * getOutputSampleSize();
+    size_t bufferSize = blocksize * frameSize;
     CHECK(bufferSize <= mMaxBufferSize);
-    buffer->set_range(0, bufferSize);
-    // copy PCM from FLAC write buffer to our media buffer, with interleaving
-    const unsigned bitsPerSample = getBitsPerSample();
-    if (mOutputFloat) {
-        copyToFloat(reinterpret_cast<float*>(buffer->data()),
-                    mWriteBuffer,
-                    blocksize,
-                    getChannels(),
-                    bitsPerSample);
-    } else {
-        copyTo16Signed(reinterpret_cast<short*>(buffer->data()),
-                       mWriteBuffer,
-                       blocksize,
-                       getChannels(),
-                       bitsPerSample);
+    copyBlock(buffer->data(), blocksize);
+    // batch further consecutive frames into the same buffer, so that
+    // sequential readers do one MediaBuffer round-trip per batch.
+    // Stop quietly on a decode problem; the next readBuffer reports it.
+    for (unsigned frames = 1; frames < kMaxFramesPerBuffer; ++frames) {
+        mWriteRequested = true;
+        mWriteCompleted = false;
+        if (!FLAC__stream_decoder_process_single(mDecoder) || !mWriteCompleted) {
+            break;
+        }
+        blocksize = mWriteHeader.blocksize;
+        if (blocksize == 0 || blocksize > getMaxBlockSize() ||
+            mWriteHeader.sample_rate != getSampleRate() ||
+            mWriteHeader.channels != getChannels() ||
+            mWriteHeader.bits_per_sample != getBitsPerSample()) {
+            break;
+        }
+        CHECK(bufferSize + blocksize * frameSize <= mMaxBufferSize);
+        copyBlock((char *) buffer->data() + bufferSize, blocksize);
+        bufferSize += blocksize * frameSize;
     }
+    buffer->set_range(0, bufferSize);
     // fill in buffer metadata
-    CHECK(mWriteHeader.number_type == FLAC__FRAME_NUMBER_TYPE_SAMPLE_NUMBER);
-    FLAC__uint64 sampleNumber = mWriteHeader.number.sample_number;
     int64_t timeUs = (1000000LL * sampleNumber) / getSampleRate();
     AMediaFormat *meta = buffer->meta_data();
     AMediaFormat_setInt64(meta, AMEDIAFORMAT_KEY_TIME_US, timeUs);
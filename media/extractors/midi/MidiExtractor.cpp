@@ -26,6 +26,7 @@
 #include <media/stagefright/MediaDefs.h>
 #include <media/stagefright/MediaErrors.h>
 #include <libsonivox/eas_reverb.h>
+#include <utils/Mutex.h>
 #include <watchdog/Watchdog.h>
 
 namespace android {
@@ -144,6 +145,42 @@ status_t MidiSource::init()
 using namespace std::chrono_literals;
 static constexpr auto kTimeout = 10s;
 
+// An EAS engine instance is expensive to initialize (EAS_Init sets up the
+// synth's voice and mix state, ~tens of ms), and preview UIs open MIDI files
+// back to back - sniffing alone constructs a MidiEngine per candidate file.
+// Idle instances are therefore cached and handed to the next MidiEngine
+// instead of being shut down. An instance is only ever owned by one engine
+// at a time; per-file state is torn down with EAS_CloseFile before an
+// instance goes back to the cache, and rendering parameters (reverb) are
+// re-applied in allocateBuffers().
+static const size_t kMaxCachedEasInstances = 2;
+
+static Mutex gEasCacheLock;
+static EAS_DATA_HANDLE gCachedEasInstances[kMaxCachedEasInstances];
+static size_t gCachedEasInstanceCount = 0;
+
+static EAS_RESULT acquireEasInstance(EAS_DATA_HANDLE *easData) {
+    {
+        Mutex::Autolock autoLock(gEasCacheLock);
+        if (gCachedEasInstanceCount > 0) {
+            *easData = gCachedEasInstances[--gCachedEasInstanceCount];
+            return EAS_SUCCESS;
+        }
+    }
+    return EAS_Init(easData);
+}
+
+static void releaseEasInstance(EAS_DATA_HANDLE easData) {
+    {
+        Mutex::Autolock autoLock(gEasCacheLock);
+        if (gCachedEasInstanceCount < kMaxCachedEasInstances) {
+            gCachedEasInstances[gCachedEasInstanceCount++] = easData;
+            return;
+        }
+    }
+    EAS_Shutdown(easData);
+}
+
 MidiEngine::MidiEngine(CDataSource *dataSource,
         AMediaFormat *fileMetadata,
         AMediaFormat *trackMetadata) :
@@ -154,9 +191,9 @@ MidiEngine::MidiEngine(CDataSource *dataSource,
     Watchdog watchdog(kTimeout);
 
     mIoWrapper = new MidiIoWrapper(dataSource);
-    // spin up a new EAS engine
+    // grab a cached EAS engine, or spin up a new one
     EAS_I32 temp;
-    EAS_RESULT result = EAS_Init(&mEasData);
+    EAS_RESULT result = acquireEasInstance(&mEasData);
 
     if (result == EAS_SUCCESS) {
         result = EAS_OpenFile(mEasData, mIoWrapper->getLocator(), &mEasHandle);
@@ -198,7 +235,7 @@ MidiEngine::~MidiEngine() {
         EAS_CloseFile(mEasData, mEasHandle);
     }
     if (mEasData) {
-        EAS_Shutdown(mEasData);
+        releaseEasInstance(mEasData);
     }
     delete mIoWrapper;
 }
@@ -584,7 +584,28 @@ int64_t BlockIterator::blockTimeUs() const {
 }
 
 void BlockIterator::seekwithoutcue_l(int64_t seekTimeUs, int64_t *actualFrameTimeUs) {
-    mCluster = mExtractor->mSegment->FindCluster(seekTimeUs * 1000ll);
+    mkvparser::Segment* const pSegment = mExtractor->mSegment;
+
+    // The cluster index is only built as far as playback has reached. Extend
+    // it up to the seek target before searching, one cluster header at a time,
+    // so FindCluster() can binary search instead of this seek landing on the
+    // last indexed cluster and walking block by block from there.
+    const mkvparser::Cluster* pLast = pSegment->GetLast();
+    while (pLast == NULL || pLast->EOS() || pLast->GetTime() < seekTimeUs * 1000ll) {
+        long long pos;
+        long len;
+        if (pSegment->LoadCluster(pos, len) != 0) {
+            // No more clusters, or an I/O error; search what we have.
+            break;
+        }
+        const mkvparser::Cluster* pCluster = pSegment->GetLast();
+        if (pCluster == pLast) {
+            break;
+        }
+        pLast = pCluster;
+    }
+
+    mCluster = pSegment->FindCluster(seekTimeUs * 1000ll);
     const long status = mCluster->GetFirst(mBlockEntry);
     if (status < 0) {  // error
         ALOGE("get last blockenry failed!");
@@ -1406,8 +1427,18 @@ MatroskaExtractor::MatroskaExtractor(DataSourceHelper *source)
                 ret = mSegment->LoadCluster(pos, len);
                 ALOGV("has Cue data, Cluster num=%ld", mSegment->GetCount());
             } else  {
-                long status_Load = mSegment->Load();
-                ALOGW("no Cue data,Segment Load status:%ld",status_Load);
+                // Without Cues, Segment::Load() would walk every cluster header
+                // in the file before the extractor is usable, which makes open
+                // time proportional to file size on slow sources. Load just the
+                // first cluster instead; seekwithoutcue_l() extends the cluster
+                // index on demand up to the requested time.
+                long len;
+                ret = mSegment->LoadCluster(pos, len);
+                if (ret >= 1) {
+                    // no more clusters
+                    ret = 0;
+                }
+                ALOGV("no Cue data, deferring cluster indexing to seek time");
             }
         } else if (ret > 0) {
             ret = mkvparser::E_BUFFER_NOT_FULL;
@@ -133,6 +133,19 @@ static bool Resync(
             }
         }
 
+        // Every MPEG audio sync word starts with 0xff, so jump straight to the
+        // next candidate byte instead of testing a full header at every
+        // offset. memchr gives us a vectorized scan of the buffer for free.
+        if (*tmp != 0xff) {
+            const uint8_t *sync =
+                    (const uint8_t *)memchr(tmp + 1, 0xff, remainingBytes - 1);
+            ssize_t skipped = (sync != NULL) ? (sync - tmp) : remainingBytes;
+            pos += skipped;
+            tmp += skipped;
+            remainingBytes -= skipped;
+            continue;
+        }
+
         uint32_t header = U32_AT(tmp);
 
         if (match_header != 0 && (header & kMask) != (match_header & kMask)) {
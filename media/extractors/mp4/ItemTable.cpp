@@ -47,7 +47,7 @@ struct ImageItem {
     ImageItem(uint32_t _type, uint32_t _id, bool _hidden) :
             type(_type), itemId(_id), hidden(_hidden),
             rows(0), columns(0), width(0), height(0), rotation(0),
-            offset(0), size(0), nextTileIndex(0) {}
+            offset(0), size(0), locationResolved(false), nextTileIndex(0) {}
 
     bool isGrid() const {
         return type == FOURCC("grid");
@@ -74,6 +74,9 @@ struct ImageItem {
     int32_t rotation;
     off64_t offset;
     size_t size;
+    // Whether offset/size (or rows/columns for grids) have been resolved
+    // from the item location box. Resolution is done lazily on first access.
+    bool locationResolved;
     sp<ABuffer> hvcc;
     sp<ABuffer> icc;
     sp<ABuffer> av1c;
@@ -1437,15 +1440,13 @@ status_t ItemTable::buildImageItemsIfPossible(uint32_t type) {
             ALOGE("iloc missing for image item id %d", info.itemId);
             continue;
         }
-        const ItemLoc &iloc = mItemLocs[ilocIndex];
-
-        off64_t offset;
-        size_t size;
-        if (iloc.getLoc(&offset, &size, mIdatOffset, mIdatSize) != OK) {
-            return ERROR_MALFORMED;
-        }
 
         if (info.isExif() || info.isXmp()) {
+            off64_t offset;
+            size_t size;
+            if (mItemLocs[ilocIndex].getLoc(&offset, &size, mIdatOffset, mIdatSize) != OK) {
+                return ERROR_MALFORMED;
+            }
             // Only add if the meta is non-empty. For Exif, the first 4 bytes contain
             // the offset to TIFF header, which the Exif parser doesn't use.
             ALOGV("adding meta to mItemIdToMetaMap: isExif %d, offset %lld, size %lld",
@@ -1465,24 +1466,10 @@ status_t ItemTable::buildImageItemsIfPossible(uint32_t type) {
 
         ALOGV("adding %s: itemId %d", image.isGrid() ? "grid" : "image", info.itemId);
 
-        if (image.isGrid()) {
-            // ImageGrid struct is at least 8-byte, at most 12-byte (if flags&1)
-            if (size < 8 || size > 12) {
-                return ERROR_MALFORMED;
-            }
-            uint8_t buf[12];
-            if (!mDataSource->readAt(offset, buf, size)) {
-                return ERROR_IO;
-            }
-
-            image.rows = buf[2] + 1;
-            image.columns = buf[3] + 1;
-
-            ALOGV("rows %d, columans %d", image.rows, image.columns);
-        } else {
-            image.offset = offset;
-            image.size = size;
-        }
+        // The item's location (and grid config for grids) is resolved lazily
+        // in resolveItemLocation() on first access, so that thumbnail-only
+        // extraction doesn't pay for resolving every tile of the
+        // full-resolution grid.
         mItemIdToItemMap.add(info.itemId, image);
     }
 
@@ -1541,6 +1528,45 @@ void ItemTable::attachProperty(const AssociationEntry &association) {
     mItemProperties[propertyIndex]->attachTo(mItemIdToItemMap.editValueAt(itemIndex));
 }
 
+status_t ItemTable::resolveItemLocation(ImageItem &image) {
+    if (image.locationResolved) {
+        return OK;
+    }
+
+    ssize_t ilocIndex = mItemLocs.indexOfKey(image.itemId);
+    if (ilocIndex < 0) {
+        return ERROR_MALFORMED;
+    }
+
+    off64_t offset;
+    size_t size;
+    if (mItemLocs[ilocIndex].getLoc(&offset, &size, mIdatOffset, mIdatSize) != OK) {
+        return ERROR_MALFORMED;
+    }
+
+    if (image.isGrid()) {
+        // ImageGrid struct is at least 8-byte, at most 12-byte (if flags&1)
+        if (size < 8 || size > 12) {
+            return ERROR_MALFORMED;
+        }
+        uint8_t buf[12];
+        if (!mDataSource->readAt(offset, buf, size)) {
+            return ERROR_IO;
+        }
+
+        image.rows = buf[2] + 1;
+        image.columns = buf[3] + 1;
+
+        ALOGV("rows %d, columans %d", image.rows, image.columns);
+    } else {
+        image.offset = offset;
+        image.size = size;
+    }
+
+    image.locationResolved = true;
+    return OK;
+}
+
 uint32_t ItemTable::countImages() const {
     return mImageItemsValid ? mDisplayables.size() : 0;
 }
@@ -1557,6 +1583,11 @@ AMediaFormat *ItemTable::getImageMeta(const uint32_t imageIndex) {
     const uint32_t itemIndex = mDisplayables[imageIndex];
     ALOGV("image[%u]: item index %u", imageIndex, itemIndex);
 
+    if (resolveItemLocation(mItemIdToItemMap.editValueAt(itemIndex)) != OK) {
+        ALOGE("%s: failed to resolve location for image[%u]!", __FUNCTION__, imageIndex);
+        return NULL;
+    }
+
     const ImageItem *image = &mItemIdToItemMap[itemIndex];
 
     ssize_t tileItemIndex = -1;
@@ -1740,16 +1771,25 @@ status_t ItemTable::getImageOffsetAndSize(
         if (tileItemIndex < 0) {
             return ERROR_END_OF_STREAM;
         }
-        *offset = mItemIdToItemMap[tileItemIndex].offset;
-        *size = mItemIdToItemMap[tileItemIndex].size;
+        ImageItem &tile = mItemIdToItemMap.editValueAt(tileItemIndex);
+        err = resolveItemLocation(tile);
+        if (err != OK) {
+            return err;
+        }
+        *offset = tile.offset;
+        *size = tile.size;
     } else {
         if (itemIndex == NULL) {
             // For single images, we only allow it to be read once, after that
             // it's EOS.  New item index must be requested each time.
             return ERROR_END_OF_STREAM;
         }
-        *offset = mItemIdToItemMap[mCurrentItemIndex].offset;
-        *size = mItemIdToItemMap[mCurrentItemIndex].size;
+        status_t err = resolveItemLocation(image);
+        if (err != OK) {
+            return err;
+        }
+        *offset = image.offset;
+        *size = image.size;
     }
 
     return OK;
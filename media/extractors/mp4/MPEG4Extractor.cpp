@@ -5467,6 +5467,101 @@ status_t MPEG4Source::parseChunk(off64_t *offset) {
     return OK;
 }
 
+namespace {
+
+// Serves the many small sequential reads of a fragment's encryption metadata
+// (saio entry table, senc/saiz sample tables) from a block cache filled with
+// large DataSource reads. A typical fragment's entire table fits in one read,
+// so steady-state DRM demux no longer issues per-sample metadata I/O.
+//
+// |expectedSize| bounds how much is prefetched per fill; reads past it are
+// still honored (with a fresh fill) in case the expectation was short.
+struct CencTableReader {
+    CencTableReader(DataSourceHelper *source, off64_t offset, off64_t expectedSize)
+        : mSource(source),
+          mOffset(offset),
+          mExpectedEnd(offset + expectedSize),
+          mCacheOffset(0),
+          mCacheLength(0) {
+    }
+
+    bool readBytes(void *data, size_t size) {
+        static_assert(kCacheSize >= 64, "cache too small for field reads");
+        if (size > kCacheSize) {
+            return false;
+        }
+        if (mOffset < mCacheOffset
+                || mOffset + (off64_t)size > mCacheOffset + (off64_t)mCacheLength) {
+            if (mCache == nullptr) {
+                mCache.reset(new (std::nothrow) uint8_t[kCacheSize]);
+                if (mCache == nullptr) {
+                    return false;
+                }
+            }
+            off64_t fill = mExpectedEnd - mOffset;
+            if (fill < (off64_t)size) {
+                fill = size;
+            }
+            if (fill > (off64_t)kCacheSize) {
+                fill = kCacheSize;
+            }
+            ssize_t n = mSource->readAt(mOffset, mCache.get(), fill);
+            if (n < (ssize_t)size) {
+                return false;
+            }
+            mCacheOffset = mOffset;
+            mCacheLength = n;
+        }
+        memcpy(data, &mCache[mOffset - mCacheOffset], size);
+        mOffset += size;
+        return true;
+    }
+
+    bool getUInt16(uint16_t *value) {
+        uint8_t bytes[2];
+        if (!readBytes(bytes, 2)) {
+            return false;
+        }
+        *value = (bytes[0] << 8) | bytes[1];
+        return true;
+    }
+
+    bool getUInt32(uint32_t *value) {
+        uint8_t bytes[4];
+        if (!readBytes(bytes, 4)) {
+            return false;
+        }
+        *value = ((uint32_t)bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+        return true;
+    }
+
+    bool getUInt64(uint64_t *value) {
+        uint8_t bytes[8];
+        if (!readBytes(bytes, 8)) {
+            return false;
+        }
+        *value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            *value = (*value << 8) | bytes[i];
+        }
+        return true;
+    }
+
+private:
+    enum {
+        kCacheSize = 65536,
+    };
+
+    DataSourceHelper *mSource;
+    off64_t mOffset;
+    off64_t mExpectedEnd;
+    std::unique_ptr<uint8_t[]> mCache;
+    off64_t mCacheOffset;
+    size_t mCacheLength;
+};
+
+}  // namespace
+
 status_t MPEG4Source::parseSampleAuxiliaryInformationSizes(
         off64_t offset, off64_t size) {
     ALOGV("parseSampleAuxiliaryInformationSizes");
@@ -5601,34 +5696,32 @@ status_t MPEG4Source::parseSampleAuxiliaryInformationOffsets(
         return OK;
     }
 
+    off64_t entrySize = version == 0 ? 4 : 8;
+    off64_t expectedSize = (off64_t)entrycount * entrySize;
+    if (expectedSize > size) {
+        expectedSize = size;
+    }
+    CencTableReader reader(mDataSource, offset, expectedSize);
     for (size_t i = 0; i < entrycount; i++) {
+        if (size < entrySize) {
+            ALOGW("b/124526959");
+            android_errorWriteLog(0x534e4554, "124526959");
+            return -EINVAL;
+        }
         if (version == 0) {
-            if (size < 4) {
-                ALOGW("b/124526959");
-                android_errorWriteLog(0x534e4554, "124526959");
-                return -EINVAL;
-            }
             uint32_t tmp;
-            if (!mDataSource->getUInt32(offset, &tmp)) {
+            if (!reader.getUInt32(&tmp)) {
                 return ERROR_IO;
             }
             mCurrentSampleInfoOffsets[i] = tmp;
-            offset += 4;
-            size -= 4;
         } else {
-            if (size < 8) {
-                ALOGW("b/124526959");
-                android_errorWriteLog(0x534e4554, "124526959");
-                return -EINVAL;
-            }
             uint64_t tmp;
-            if (!mDataSource->getUInt64(offset, &tmp)) {
+            if (!reader.getUInt64(&tmp)) {
                 return ERROR_IO;
             }
             mCurrentSampleInfoOffsets[i] = tmp;
-            offset += 8;
-            size -= 8;
         }
+        size -= entrySize;
     }
 
     // parse clear/encrypted data
@@ -5656,15 +5749,35 @@ status_t MPEG4Source::parseClearEncryptedSizes(
         return ERROR_MALFORMED;
     }
 
+    // Parse the whole table through a block cache: the senc payload size is
+    // its box size, and the saiz-described table size is known up front, so
+    // a typical fragment's table is loaded with a single read. The mdat path
+    // passes the remainder of the chunk as |size|; without the expected size
+    // the prefetch would over-read.
+    off64_t expectedSize = size;
+    if (!isSampleEncryption) {
+        if (mCurrentDefaultSampleInfoSize != 0) {
+            expectedSize = (off64_t)mCurrentSampleInfoCount * mCurrentDefaultSampleInfoSize;
+        } else if (mCurrentSampleInfoSizes != NULL) {
+            expectedSize = 0;
+            for (uint32_t i = 0; i < mCurrentSampleInfoCount; ++i) {
+                expectedSize += mCurrentSampleInfoSizes[i];
+            }
+        }
+        if (expectedSize > size) {
+            expectedSize = size;
+        }
+    }
+    CencTableReader reader(mDataSource, offset, expectedSize);
+
     uint32_t sampleCount = mCurrentSampleInfoCount;
     if (isSampleEncryption) {
         if (size < 4) {
             return ERROR_MALFORMED;
         }
-        if (!mDataSource->getUInt32(offset, &sampleCount)) {
+        if (!reader.getUInt32(&sampleCount)) {
             return ERROR_IO;
         }
-        offset += 4;
         size -= 4;
     }
 
@@ -5683,11 +5796,10 @@ status_t MPEG4Source::parseClearEncryptedSizes(
         if (size < ivlength) {
             return ERROR_MALFORMED;
         }
-        if (mDataSource->readAt(offset, smpl->iv, ivlength) != ivlength) {
+        if (!reader.readBytes(smpl->iv, ivlength)) {
             return ERROR_IO;
         }
 
-        offset += ivlength;
         size -= ivlength;
 
         bool readSubsamples;
@@ -5706,10 +5818,9 @@ status_t MPEG4Source::parseClearEncryptedSizes(
             if (size < 2) {
                 return ERROR_MALFORMED;
             }
-            if (!mDataSource->getUInt16(offset, &numsubsamples)) {
+            if (!reader.getUInt16(&numsubsamples)) {
                 return ERROR_IO;
             }
-            offset += 2;
             size -= 2;
             for (size_t j = 0; j < numsubsamples; j++) {
                 uint16_t numclear;
@@ -5717,14 +5828,12 @@ status_t MPEG4Source::parseClearEncryptedSizes(
                 if (size < 6) {
                     return ERROR_MALFORMED;
                 }
-                if (!mDataSource->getUInt16(offset, &numclear)) {
+                if (!reader.getUInt16(&numclear)) {
                     return ERROR_IO;
                 }
-                offset += 2;
-                if (!mDataSource->getUInt32(offset, &numencrypted)) {
+                if (!reader.getUInt32(&numencrypted)) {
                     return ERROR_IO;
                 }
-                offset += 4;
                 size -= 6;
                 smpl->clearsizes.add(numclear);
                 smpl->encryptedsizes.add(numencrypted);
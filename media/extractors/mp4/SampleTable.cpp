@@ -18,7 +18,10 @@
 //#define LOG_NDEBUG 0
 #include <utils/Log.h>
 
+#include <algorithm>
 #include <limits>
+#include <thread>
+#include <vector>
 
 #include "SampleTable.h"
 #include "SampleIterator.h"
@@ -616,19 +619,6 @@ uint32_t abs_difference(uint64_t time1, uint64_t time2) {
 }
 
 // static
-int SampleTable::CompareIncreasingTime(const void *_a, const void *_b) {
-    const SampleTimeEntry *a = (const SampleTimeEntry *)_a;
-    const SampleTimeEntry *b = (const SampleTimeEntry *)_b;
-
-    if (a->mCompositionTime < b->mCompositionTime) {
-        return -1;
-    } else if (a->mCompositionTime > b->mCompositionTime) {
-        return 1;
-    }
-
-    return 0;
-}
-
 void SampleTable::buildSampleEntriesTable() {
     Mutex::Autolock autoLock(mLock);
 
@@ -663,6 +653,12 @@ void SampleTable::buildSampleEntriesTable() {
     uint32_t sampleIndex = 0;
     uint64_t sampleTime = 0;
 
+    // Samples are visited in increasing order, so resolve composition time
+    // offsets with a local cursor over the ctts entries instead of paying a
+    // mutex acquisition per sample in CompositionDeltaLookup.
+    size_t cttsEntry = 0;
+    uint32_t cttsEntryStart = 0;
+
     for (uint32_t i = 0; i < mTimeToSampleCount; ++i) {
         uint32_t n = mTimeToSample[2 * i];
         uint32_t delta = mTimeToSample[2 * i + 1];
@@ -675,9 +671,18 @@ void SampleTable::buildSampleEntriesTable() {
 
                 mSampleTimeEntries[sampleIndex].mSampleIndex = sampleIndex;
 
-                int32_t compTimeDelta =
-                    mCompositionDeltaLookup->getCompositionTimeOffset(
-                            sampleIndex);
+                int32_t compTimeDelta = 0;
+                while (cttsEntry < mNumCompositionTimeDeltaEntries) {
+                    const uint32_t sampleCount =
+                            mCompositionTimeDeltaEntries[2 * cttsEntry];
+                    if (sampleIndex < cttsEntryStart + sampleCount) {
+                        compTimeDelta =
+                                mCompositionTimeDeltaEntries[2 * cttsEntry + 1];
+                        break;
+                    }
+                    cttsEntryStart += sampleCount;
+                    ++cttsEntry;
+                }
 
                 if ((compTimeDelta < 0 && sampleTime <
                         (compTimeDelta == INT32_MIN ?
@@ -710,8 +715,55 @@ void SampleTable::buildSampleEntriesTable() {
         }
     }
 
-    qsort(mSampleTimeEntries, mNumSampleSizes, sizeof(SampleTimeEntry),
-          CompareIncreasingTime);
+    sortSampleEntries();
+}
+
+// Sorting by composition time dominates the index build for long recordings
+// with millions of samples, so large tables are sorted as parallel partitions
+// on a few worker threads and then merged.
+void SampleTable::sortSampleEntries() {
+    const auto compare = [](const SampleTimeEntry &a, const SampleTimeEntry &b) {
+        return a.mCompositionTime < b.mCompositionTime;
+    };
+
+    // Below this size the spawn/join overhead outweighs the parallel sort.
+    static constexpr uint32_t kMinEntriesPerThread = 256 * 1024;
+
+    uint32_t numThreads = std::min<uint32_t>(
+            std::max(1u, std::thread::hardware_concurrency()),
+            mNumSampleSizes / kMinEntriesPerThread);
+    numThreads = std::min(numThreads, 4u);
+
+    if (numThreads <= 1) {
+        std::sort(mSampleTimeEntries, mSampleTimeEntries + mNumSampleSizes, compare);
+        return;
+    }
+
+    uint32_t bounds[4 + 1] = {};
+    for (uint32_t i = 0; i <= numThreads; ++i) {
+        bounds[i] = (uint64_t)mNumSampleSizes * i / numThreads;
+    }
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        workers.emplace_back([this, &compare, begin = bounds[i], end = bounds[i + 1]] {
+            std::sort(mSampleTimeEntries + begin, mSampleTimeEntries + end, compare);
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    // Merge pairwise so the final merge is the only full-length pass.
+    for (uint32_t width = 1; width < numThreads; width *= 2) {
+        for (uint32_t i = 0; i + width < numThreads; i += 2 * width) {
+            std::inplace_merge(
+                    mSampleTimeEntries + bounds[i],
+                    mSampleTimeEntries + bounds[i + width],
+                    mSampleTimeEntries + bounds[std::min(i + 2 * width, numThreads)],
+                    compare);
+        }
+    }
 }
 
 status_t SampleTable::findSampleAtTime(
@@ -97,6 +97,7 @@ private:
 
     void attachProperty(const AssociationEntry &association);
     status_t buildImageItemsIfPossible(uint32_t type);
+    status_t resolveItemLocation(ImageItem &image);
 
     DISALLOW_EVIL_CONSTRUCTORS(ItemTable);
 };
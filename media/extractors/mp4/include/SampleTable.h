@@ -166,9 +166,8 @@ private:
     status_t getSampleSize_l(uint32_t sample_index, size_t *sample_size);
     int32_t getCompositionTimeOffset(uint32_t sampleIndex);
 
-    static int CompareIncreasingTime(const void *, const void *);
-
     void buildSampleEntriesTable();
+    void sortSampleEntries();
 
     SampleTable(const SampleTable &);
     SampleTable &operator=(const SampleTable &);
@@ -18,6 +18,7 @@
 #define LOG_TAG "MPEG2TSExtractor"
 
 #include <inttypes.h>
+#include <sys/prctl.h>
 #include <utils/Log.h>
 
 #include <android-base/macros.h>
@@ -250,7 +251,9 @@ MPEG2TSExtractor::MPEG2TSExtractor(DataSourceHelper *source)
     : mDataSource(source),
       mParser(new ATSParser),
       mLastSyncEvent(0),
-      mOffset(0) {
+      mOffset(0),
+      mParseAheadStarted(false),
+      mParseAheadStop(false) {
     char header;
     if (source->readAt(0, &header, 1) == 1 && header == 0x47) {
         mHeaderSkip = 0;
@@ -258,12 +261,89 @@ MPEG2TSExtractor::MPEG2TSExtractor(DataSourceHelper *source)
         mHeaderSkip = 4;
     }
     init();
+
+    if (!mSourceImpls.isEmpty()) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+        pthread_create(&mParseAheadThread, &attr, ParseAheadThreadWrapper, this);
+        pthread_attr_destroy(&attr);
+        mParseAheadStarted = true;
+    }
 }
 
 MPEG2TSExtractor::~MPEG2TSExtractor() {
+    if (mParseAheadStarted) {
+        {
+            Mutex::Autolock autoLock(mLock);
+            mParseAheadStop = true;
+            mParseAheadCondition.signal();
+        }
+        void *dummy;
+        pthread_join(mParseAheadThread, &dummy);
+    }
+
     delete mDataSource;
 }
 
+// static
+void *MPEG2TSExtractor::ParseAheadThreadWrapper(void *me) {
+    static_cast<MPEG2TSExtractor *>(me)->parseAheadLoop();
+    return NULL;
+}
+
+void MPEG2TSExtractor::parseAheadLoop() {
+    prctl(PR_SET_NAME, (unsigned long)"TSParseAhead", 0, 0, 0);
+
+    // How much each track is buffered up to before the feeder backs off.
+    static const int64_t kParseAheadMarginUs = 500000LL;
+
+    for (;;) {
+        {
+            Mutex::Autolock autoLock(mLock);
+            if (mParseAheadStop) {
+                break;
+            }
+        }
+
+        // Keep feeding while any track that hasn't ended is below the
+        // margin; when every track is either saturated or done, back off.
+        bool needMore = false;
+        for (size_t i = 0; i < mSourceImpls.size(); ++i) {
+            const sp<AnotherPacketSource> &impl = mSourceImpls[i];
+            status_t finalResult;
+            if (!impl->hasBufferAvailable(&finalResult)) {
+                if (finalResult == OK) {
+                    needMore = true;
+                    break;
+                }
+                continue;
+            }
+            if (impl->getBufferedDurationUs(&finalResult) < kParseAheadMarginUs) {
+                needMore = true;
+                break;
+            }
+        }
+
+        status_t err = OK;
+        if (needMore) {
+            Mutex::Autolock feedGate(mFeedGateLock);
+            err = feedMore();
+        }
+
+        if (!needMore || err != OK) {
+            // Saturated, or at end of stream until a seek rewinds; timed
+            // wait doubles as the retry tick so no wakeup can be missed.
+            Mutex::Autolock autoLock(mLock);
+            if (mParseAheadStop) {
+                break;
+            }
+            mParseAheadCondition.waitRelative(
+                    mLock, (err != OK ? 100000000LL : 10000000LL) /* ns */);
+        }
+    }
+}
+
 size_t MPEG2TSExtractor::countTracks() {
     return mSourceImpls.size();
 }
@@ -634,6 +714,10 @@ uint32_t MPEG2TSExtractor::flags() const {
 
 status_t MPEG2TSExtractor::seek(int64_t seekTimeUs,
         const MediaTrackHelper::ReadOptions::SeekMode &seekMode) {
+    // Keep the parse-ahead thread out of the parser while discontinuities
+    // are queued and drained.
+    Mutex::Autolock feedGate(mFeedGateLock);
+
     if (mSeekSyncPoints == NULL || mSeekSyncPoints->isEmpty()) {
         ALOGW("No sync point to seek to.");
         // ... and therefore we have nothing useful to do here.
@@ -24,6 +24,7 @@
 #include <media/MediaExtractorPluginHelper.h>
 #include <media/stagefright/MetaDataBase.h>
 #include <mpeg2ts/ATSParser.h>
+#include <pthread.h>
 #include <utils/threads.h>
 #include <utils/KeyedVector.h>
 #include <utils/Vector.h>
@@ -101,6 +102,22 @@ private:
 
     status_t  estimateDurationsFromTimesUsAtEnd();
 
+    // Parse-ahead: a dedicated thread keeps the parser fed so read() can
+    // usually dequeue an already-parsed access unit instead of demuxing on
+    // the caller's thread. The per-track AnotherPacketSource queues act as
+    // the bounded AU queues; feeding pauses while every track has at least
+    // kParseAheadMarginUs buffered. mFeedGateLock serializes the feeder
+    // with seek(), which must not observe packets queued while it drains
+    // discontinuities.
+    static void *ParseAheadThreadWrapper(void *me);
+    void parseAheadLoop();
+
+    pthread_t mParseAheadThread;
+    bool mParseAheadStarted;
+    bool mParseAheadStop;  // guarded by mLock
+    Condition mParseAheadCondition;
+    Mutex mFeedGateLock;
+
     size_t mHeaderSkip;
     DISALLOW_EVIL_CONSTRUCTORS(MPEG2TSExtractor);
 };
@@ -21,6 +21,7 @@
 #include "OggExtractor.h"
 
 #include <cutils/properties.h>
+#include <utils/KeyedVector.h>
 #include <utils/Vector.h>
 #include <media/stagefright/DataSourceBase.h>
 #include <media/ExtractorUtils.h>
@@ -138,6 +139,16 @@ protected:
 
     Vector<TOCEntry> mTableOfContents;
 
+    // Page index recorded on the fly while playing sources for which no
+    // table of contents was built (e.g. caching data sources), used to seed
+    // later seeks into regions that have already been played.
+    Vector<TOCEntry> mSeekIndex;
+
+    // Remembers the preceding page's granule position for page offsets we
+    // have already seeked to, so repeat seeks to the same pages skip the
+    // backward scan in findPrevGranulePosition().
+    KeyedVector<off64_t, uint64_t> mPrevGranuleCache;
+
     int32_t mHapticChannelCount;
 
     ssize_t readPage(off64_t offset, Page *page);
@@ -170,6 +181,8 @@ protected:
 
     void buildTableOfContents();
 
+    void recordSeekIndexEntry(off64_t pageOffset, int64_t timeUs);
+
     void setChannelMask(int channelCount);
 
     MyOggExtractor(const MyOggExtractor &);
@@ -502,6 +515,26 @@ status_t MyOggExtractor::seekToTime(int64_t timeUs) {
 
         off64_t pos = timeUs * bps / 8000000ll;
 
+        // If playback already went through this region, the on-the-fly seek
+        // index knows a page at or before the target, which is both cheaper
+        // and more accurate than the bitrate estimate.
+        size_t left = 0;
+        size_t right_plus_one = mSeekIndex.size();
+        while (left < right_plus_one) {
+            size_t center = left + (right_plus_one - left) / 2;
+            if (timeUs < mSeekIndex.itemAt(center).mTimeUs) {
+                right_plus_one = center;
+            } else {
+                left = center + 1;
+            }
+        }
+        if (left > 0) {
+            const TOCEntry &entry = mSeekIndex.itemAt(left - 1);
+            if (left < mSeekIndex.size() || entry.mPageOffset > pos) {
+                pos = entry.mPageOffset;
+            }
+        }
+
         ALOGV("seeking to offset %lld", (long long)pos);
         return seekToOffset(pos);
     }
@@ -551,8 +584,18 @@ status_t MyOggExtractor::seekToOffset(off64_t offset) {
 
     // We found the page we wanted to seek to, but we'll also need
     // the page preceding it to determine how many valid samples are on
-    // this page.
-    findPrevGranulePosition(pageOffset, &mPrevGranulePosition);
+    // this page. Seeks keep landing on the same table of contents pages,
+    // so remember the scan result per page offset.
+    ssize_t cacheIndex = mPrevGranuleCache.indexOfKey(pageOffset);
+    if (cacheIndex >= 0) {
+        mPrevGranulePosition = mPrevGranuleCache.valueAt(cacheIndex);
+    } else if (findPrevGranulePosition(pageOffset, &mPrevGranulePosition) == OK) {
+        static const size_t kMaxPrevGranuleCacheSize = 64;
+        if (mPrevGranuleCache.size() >= kMaxPrevGranuleCacheSize) {
+            mPrevGranuleCache.clear();
+        }
+        mPrevGranuleCache.add(pageOffset, mPrevGranulePosition);
+    }
 
     mOffset = pageOffset;
 
@@ -954,6 +997,16 @@ media_status_t MyOggExtractor::_readNextPacket(MediaBufferHelper **out, bool cal
         mCurrentPageSize = n;
         mNextLaceIndex = 0;
 
+        // Once past the headers (granule timestamps are meaningless before),
+        // index the pages of sources without a table of contents as they
+        // stream by, so later seeks into this region are exact.
+        if (mTableOfContents.isEmpty()
+                && mFirstDataOffset >= 0 && mOffset >= mFirstDataOffset
+                && mCurrentPage.mGranulePosition != ~(uint64_t)0) {
+            recordSeekIndexEntry(
+                    mOffset, getTimeUsOfGranule(mCurrentPage.mGranulePosition));
+        }
+
         if (buffer != NULL) {
             if ((mCurrentPage.mFlags & 1) == 0) {
                 // This page does not continue the packet, i.e. the packet
@@ -1066,6 +1119,32 @@ void MyOggExtractor::buildTableOfContents() {
     }
 }
 
+// Called with pages in stream order. Keep entries a couple of seconds apart
+// and cap the total count, so an endless live stream cannot grow the index
+// without bound.
+void MyOggExtractor::recordSeekIndexEntry(off64_t pageOffset, int64_t timeUs) {
+    static const int64_t kMinSeekIndexIntervalUs = 2000000ll;
+    static const size_t kMaxNumSeekIndexEntries = 2048;
+
+    if (!mSeekIndex.isEmpty()) {
+        const TOCEntry &last = mSeekIndex.itemAt(mSeekIndex.size() - 1);
+        if (pageOffset <= last.mPageOffset
+                || timeUs < last.mTimeUs + kMinSeekIndexIntervalUs) {
+            // Replaying an already indexed region, or too close to the
+            // previous entry.
+            return;
+        }
+    }
+    if (mSeekIndex.size() >= kMaxNumSeekIndexEntries) {
+        return;
+    }
+
+    mSeekIndex.push();
+    TOCEntry &entry = mSeekIndex.editItemAt(mSeekIndex.size() - 1);
+    entry.mPageOffset = pageOffset;
+    entry.mTimeUs = timeUs;
+}
+
 int32_t MyOggExtractor::getPacketBlockSize(MediaBufferHelper *buffer) {
     const uint8_t *data =
         (const uint8_t *)buffer->data() + buffer->range_offset();
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "ExtractorPerformanceTest"
+#include <utils/Log.h>
+
+#include <malloc.h>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include <datasource/FileSource.h>
+#include <media/stagefright/MediaBufferGroup.h>
+
+#include <FLACExtractor.h>
+#include <MatroskaExtractor.h>
+#include <MPEG4Extractor.h>
+#include <MPEG2TSExtractor.h>
+
+#include "ExtractorUnitTestEnvironment.h"
+
+/*
+ * Replays a corpus of representative container files through the
+ * extractors and reports, per file, demux throughput (MB/s), heap
+ * growth per demuxed sample and random-seek latency.  Each result is
+ * printed as one JSON line, so a run's output can be saved as a
+ * baseline; when a baseline file named extractor_perf_baseline.json is
+ * present next to the corpus (one JSON object per line, same shape as
+ * the output plus threshold keys), the measured values are checked
+ * against its thresholds and the test fails on regression.  Without a
+ * baseline the test is informational only, since absolute throughput
+ * varies between devices.
+ *
+ * Baseline threshold keys per file: "min_mb_per_sec",
+ * "max_heap_bytes_per_sample", "max_seek_avg_us".
+ */
+
+using namespace android;
+
+constexpr int32_t kSeekCount = 10;
+constexpr int32_t kSeekRandomSeed = 700;
+
+static ExtractorUnitTestEnvironment *gEnv = nullptr;
+
+struct PerfResult {
+    double mbPerSec;
+    double heapBytesPerSample;
+    int64_t seekAvgUs;
+    int64_t seekMaxUs;
+    size_t sampleCount;
+    size_t byteCount;
+};
+
+// Thresholds parsed from the baseline file; negative means "not checked".
+struct PerfBaseline {
+    double minMbPerSec = -1;
+    double maxHeapBytesPerSample = -1;
+    int64_t maxSeekAvgUs = -1;
+};
+
+static int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+}
+
+// Extracts the numeric value following "<key>": from a JSON object
+// line.  The baseline format is flat, so a full JSON parser is not
+// needed here.
+static bool findJsonNumber(const std::string &line, const std::string &key, double *value) {
+    const std::string needle = "\"" + key + "\":";
+    size_t pos = line.find(needle);
+    if (pos == std::string::npos) return false;
+    pos += needle.size();
+    while (pos < line.size() && line[pos] == ' ') ++pos;
+    char *end = nullptr;
+    const double parsed = strtod(line.c_str() + pos, &end);
+    if (end == line.c_str() + pos) return false;
+    *value = parsed;
+    return true;
+}
+
+// Loads the baseline for inputFile from the corpus directory, if any.
+static bool loadBaseline(const std::string &inputFile, PerfBaseline *baseline) {
+    std::ifstream stream(gEnv->getRes() + "extractor_perf_baseline.json");
+    if (!stream.is_open()) return false;
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.find("\"" + inputFile + "\"") == std::string::npos) continue;
+        double value;
+        if (findJsonNumber(line, "min_mb_per_sec", &value)) {
+            baseline->minMbPerSec = value;
+        }
+        if (findJsonNumber(line, "max_heap_bytes_per_sample", &value)) {
+            baseline->maxHeapBytesPerSample = value;
+        }
+        if (findJsonNumber(line, "max_seek_avg_us", &value)) {
+            baseline->maxSeekAvgUs = (int64_t)value;
+        }
+        return true;
+    }
+    return false;
+}
+
+class ExtractorPerformanceTest
+    : public ::testing::TestWithParam<std::pair<std::string /* container */,
+                                                std::string /* inputFile */>> {
+  public:
+    ~ExtractorPerformanceTest() {
+        if (mInputFp) fclose(mInputFp);
+        if (mDataSource) mDataSource.clear();
+        if (mExtractor) delete mExtractor;
+    }
+
+    void SetUp() override {
+        std::string inputFileName = gEnv->getRes() + GetParam().second;
+        mInputFp = fopen(inputFileName.c_str(), "rb");
+        ASSERT_NE(mInputFp, nullptr) << "Unable to open input file " << inputFileName;
+        struct stat buf;
+        ASSERT_EQ(stat(inputFileName.c_str(), &buf), 0);
+        mFileSize = buf.st_size;
+        mDataSource = new FileSource(dup(fileno(mInputFp)), 0, buf.st_size);
+        ASSERT_NE(mDataSource, nullptr);
+
+        const std::string &container = GetParam().first;
+        if (container == "mp4") {
+            mExtractor = new MPEG4Extractor(new DataSourceHelper(mDataSource->wrap()));
+        } else if (container == "mkv" || container == "webm") {
+            mExtractor = new MatroskaExtractor(new DataSourceHelper(mDataSource->wrap()));
+        } else if (container == "ts") {
+            mExtractor = new MPEG2TSExtractor(new DataSourceHelper(mDataSource->wrap()));
+        } else if (container == "flac") {
+            mExtractor = new FLACExtractor(new DataSourceHelper(mDataSource->wrap()));
+        }
+        ASSERT_NE(mExtractor, nullptr) << "No extractor for container " << container;
+    }
+
+    FILE *mInputFp = nullptr;
+    off64_t mFileSize = 0;
+    sp<DataSource> mDataSource = nullptr;
+    MediaExtractorPluginHelper *mExtractor = nullptr;
+};
+
+TEST_P(ExtractorPerformanceTest, DemuxAndSeekPerf) {
+    const std::string &inputFile = GetParam().second;
+    int32_t numTracks = mExtractor->countTracks();
+    ASSERT_GT(numTracks, 0) << "Extractor found no tracks in " << inputFile;
+
+    PerfResult result{};
+    int64_t demuxElapsedUs = 0;
+    int64_t clipDurationUs = 0;
+
+    // Demux every track end to end, timing the read loop and tracking
+    // heap growth across it.
+    const size_t heapBefore = mallinfo().uordblks;
+    for (int32_t idx = 0; idx < numTracks; idx++) {
+        MediaTrackHelper *track = mExtractor->getTrack(idx);
+        ASSERT_NE(track, nullptr) << "Failed to get track for index " << idx;
+
+        CMediaTrack *cTrack = wrap(track);
+        ASSERT_NE(cTrack, nullptr) << "Failed to get track wrapper for index " << idx;
+
+        AMediaFormat *trackFormat = AMediaFormat_new();
+        ASSERT_NE(trackFormat, nullptr);
+        ASSERT_EQ(OK, (media_status_t)track->getFormat(trackFormat));
+        int64_t durationUs = 0;
+        if (AMediaFormat_getInt64(trackFormat, AMEDIAFORMAT_KEY_DURATION, &durationUs) &&
+                durationUs > clipDurationUs) {
+            clipDurationUs = durationUs;
+        }
+        AMediaFormat_delete(trackFormat);
+
+        MediaBufferGroup *bufferGroup = new MediaBufferGroup();
+        int32_t status = cTrack->start(track, bufferGroup->wrap());
+        ASSERT_EQ(OK, (media_status_t)status) << "Failed to start the track";
+
+        const int64_t startUs = nowUs();
+        while (status != AMEDIA_ERROR_END_OF_STREAM) {
+            MediaBufferHelper *buffer = nullptr;
+            status = track->read(&buffer);
+            if (buffer) {
+                result.byteCount += buffer->range_length();
+                result.sampleCount++;
+                buffer->release();
+            }
+        }
+        demuxElapsedUs += nowUs() - startUs;
+
+        status = cTrack->stop(track);
+        ASSERT_EQ(OK, status) << "Failed to stop the track";
+        delete bufferGroup;
+        delete track;
+    }
+    const size_t heapAfter = mallinfo().uordblks;
+    ASSERT_GT(result.sampleCount, 0u) << "No samples demuxed from " << inputFile;
+    ASSERT_GT(demuxElapsedUs, 0);
+    result.mbPerSec = (double)result.byteCount / demuxElapsedUs; // bytes/us == MB/s
+    result.heapBytesPerSample =
+            heapAfter > heapBefore ? (double)(heapAfter - heapBefore) / result.sampleCount : 0;
+
+    // Random seeks on track 0, timed individually.
+    if (clipDurationUs > 0) {
+        MediaTrackHelper *track = mExtractor->getTrack(0);
+        ASSERT_NE(track, nullptr);
+        CMediaTrack *cTrack = wrap(track);
+        ASSERT_NE(cTrack, nullptr);
+        MediaBufferGroup *bufferGroup = new MediaBufferGroup();
+        ASSERT_EQ(OK, (media_status_t)cTrack->start(track, bufferGroup->wrap()));
+
+        int64_t totalSeekUs = 0;
+        srand(kSeekRandomSeed);
+        for (int32_t i = 0; i < kSeekCount; i++) {
+            int64_t seekPts = ((double)rand() / RAND_MAX) * clipDurationUs;
+            MediaTrackHelper::ReadOptions options(
+                    CMediaTrackReadOptions::SEEK_CLOSEST_SYNC | CMediaTrackReadOptions::SEEK,
+                    seekPts);
+            const int64_t startUs = nowUs();
+            MediaBufferHelper *buffer = nullptr;
+            track->read(&buffer, &options);
+            const int64_t seekUs = nowUs() - startUs;
+            if (buffer) buffer->release();
+            totalSeekUs += seekUs;
+            if (seekUs > result.seekMaxUs) result.seekMaxUs = seekUs;
+        }
+        result.seekAvgUs = totalSeekUs / kSeekCount;
+
+        ASSERT_EQ(OK, (media_status_t)cTrack->stop(track));
+        delete bufferGroup;
+        delete track;
+    }
+
+    // One JSON line per file; a full run's output is a valid baseline.
+    std::ostringstream json;
+    json << "{\"file\": \"" << inputFile << "\", \"samples\": " << result.sampleCount
+         << ", \"bytes\": " << result.byteCount << ", \"mb_per_sec\": " << result.mbPerSec
+         << ", \"heap_bytes_per_sample\": " << result.heapBytesPerSample
+         << ", \"seek_avg_us\": " << result.seekAvgUs
+         << ", \"seek_max_us\": " << result.seekMaxUs << "}";
+    printf("%s\n", json.str().c_str());
+
+    PerfBaseline baseline;
+    if (!loadBaseline(inputFile, &baseline)) {
+        ALOGI("No baseline for %s, reporting only", inputFile.c_str());
+        return;
+    }
+    if (baseline.minMbPerSec >= 0) {
+        EXPECT_GE(result.mbPerSec, baseline.minMbPerSec)
+                << "Demux throughput regressed for " << inputFile;
+    }
+    if (baseline.maxHeapBytesPerSample >= 0) {
+        EXPECT_LE(result.heapBytesPerSample, baseline.maxHeapBytesPerSample)
+                << "Heap growth per sample regressed for " << inputFile;
+    }
+    if (baseline.maxSeekAvgUs >= 0) {
+        EXPECT_LE(result.seekAvgUs, baseline.maxSeekAvgUs)
+                << "Seek latency regressed for " << inputFile;
+    }
+}
+
+// Long-GOP MP4, MKV, webm, TS and FLAC from the extractor test corpus.
+// The corpus has no fragmented MP4; add one here when it grows one.
+INSTANTIATE_TEST_SUITE_P(
+        ExtractorPerfAll, ExtractorPerformanceTest,
+        ::testing::Values(std::make_pair("mp4", "crowd_508x240_25fps_hevc.mp4"),
+                          std::make_pair("mkv", "bbb_cif_768kbps_30fps_mpeg4.mkv"),
+                          std::make_pair("webm", "bbb_340x280_30fps_vp9.webm"),
+                          std::make_pair("ts", "bbb_cif_768kbps_30fps_mpeg2.ts"),
+                          std::make_pair("flac", "bbb_stereo_48kHz_flac.flac")));
+
+int main(int argc, char **argv) {
+    gEnv = new ExtractorUnitTestEnvironment();
+    ::testing::AddGlobalTestEnvironment(gEnv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int status = gEnv->initFromOptions(argc, argv);
+    if (status == 0) {
+        status = RUN_ALL_TESTS();
+        ALOGV("Test result = %d\n", status);
+    }
+    return status;
+}
@@ -364,7 +364,9 @@ status_t WAVExtractor::init() {
     return NO_INIT;
 }
 
-const size_t WAVSource::kMaxFrameSize = 32768;
+// Larger output buffers amortize the per-read overhead for bulk consumers;
+// PCM conversion still happens in place within the buffer.
+const size_t WAVSource::kMaxFrameSize = 65536;
 
 WAVSource::WAVSource(
         DataSourceHelper *dataSource,
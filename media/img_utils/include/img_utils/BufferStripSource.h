@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IMG_UTILS_BUFFER_STRIP_SOURCE_H
+#define IMG_UTILS_BUFFER_STRIP_SOURCE_H
+
+#include <img_utils/StripSource.h>
+
+#include <cutils/compiler.h>
+#include <utils/Errors.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace android {
+namespace img_utils {
+
+/**
+ * A StripSource backed by a locked pixel buffer, such as a mapped
+ * GraphicBuffer plane.  Rows are written directly from the buffer, with
+ * pixel and row stride padding packed out on the fly, so no intermediate
+ * copy of the frame is needed to produce TIFF strip data.
+ */
+class ANDROID_API BufferStripSource : public StripSource {
+    public:
+        /**
+         * Create a strip source for the given IFD over the given pixel
+         * buffer.  The buffer must stay locked and valid until the last
+         * call to writeToStream has returned.
+         *
+         * width and height are given in pixels, bytesPerPixel is the size
+         * of one packed pixel, and pixelStride/rowStride are the distances
+         * in bytes between the starts of adjacent pixels/rows in the
+         * buffer.
+         */
+        BufferStripSource(uint32_t ifd, const uint8_t* pixels, uint32_t width, uint32_t height,
+                size_t bytesPerPixel, size_t pixelStride, size_t rowStride);
+
+        virtual ~BufferStripSource();
+
+        /**
+         * Write count bytes of packed pixel data to the stream.  count must
+         * match the packed size of the buffer (width * height *
+         * bytesPerPixel).
+         *
+         * Returns OK on success, or a negative error code.
+         */
+        virtual status_t writeToStream(Output& stream, uint32_t count);
+
+        /**
+         * Return the source IFD.
+         */
+        virtual uint32_t getIfd() const;
+
+    protected:
+        uint32_t mIfd;
+        const uint8_t* mPixels;
+        uint32_t mWidth;
+        uint32_t mHeight;
+        size_t mBytesPerPixel;
+        size_t mPixelStride;
+        size_t mRowStride;
+};
+
+} /*namespace img_utils*/
+} /*namespace android*/
+
+#endif /*IMG_UTILS_BUFFER_STRIP_SOURCE_H*/
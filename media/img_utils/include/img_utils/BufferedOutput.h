@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IMG_UTILS_BUFFERED_OUTPUT_H
+#define IMG_UTILS_BUFFERED_OUTPUT_H
+
+#include <img_utils/Output.h>
+
+#include <utils/Errors.h>
+
+#include <cutils/compiler.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace android {
+namespace img_utils {
+
+/**
+ * Utility class that accumulates written bytes into a block buffer and
+ * forwards them to a wrapped Output in large writes.  This reduces the
+ * per-call overhead of the wrapped Output for writers that emit many
+ * small fields, such as TiffWriter.
+ */
+class ANDROID_API BufferedOutput : public Output {
+    public:
+        /**
+         * Wrap the given Output.  Buffered bytes are forwarded to this
+         * output whenever the internal buffer fills up, and on flush or
+         * close.
+         *
+         * The wrapped Output is owned by the caller, and must stay alive
+         * for the lifespan of this BufferedOutput object.
+         */
+        explicit BufferedOutput(Output* out, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+        virtual ~BufferedOutput();
+
+        /**
+         * Open the wrapped Output.
+         *
+         * Returns OK on success, or a negative error code.
+         */
+        virtual status_t open();
+
+        /**
+         * Write bytes from the given buffer.  The number of bytes given in the count
+         * argument will be written.  Bytes will be written from the given buffer starting
+         * at the index given in the offset argument.
+         *
+         * Returns OK on success, or a negative error code.
+         */
+        virtual status_t write(const uint8_t* buf, size_t offset, size_t count);
+
+        /**
+         * Forward any buffered bytes to the wrapped Output.
+         *
+         * Returns OK on success, or a negative error code.
+         */
+        virtual status_t flush();
+
+        /**
+         * Flush buffered bytes and close the wrapped Output.
+         *
+         * Returns OK on success, or a negative error code.
+         */
+        virtual status_t close();
+
+    protected:
+        enum {
+            DEFAULT_BUFFER_SIZE = 64 * 1024,
+        };
+
+        Output* mOutput;
+        uint8_t* mBuffer;
+        size_t mBufferSize;
+        size_t mBuffered;
+};
+
+} /*namespace img_utils*/
+} /*namespace android*/
+
+#endif /*IMG_UTILS_BUFFERED_OUTPUT_H*/
@@ -120,6 +120,12 @@ class ANDROID_API EndianOutput : public Output {
         virtual status_t write(const double* buf, size_t offset, size_t count);
 
     protected:
+        enum {
+            // Size in bytes of the stack block used to batch endian-swapped
+            // elements before handing them to the wrapped Output.
+            WRITE_BLOCK_SIZE = 4096,
+        };
+
         template<typename T>
         inline status_t writeHelper(const T* buf, size_t offset, size_t count);
 
@@ -132,33 +138,42 @@ template<typename T>
 inline status_t EndianOutput::writeHelper(const T* buf, size_t offset, size_t count) {
     assert(offset <= count);
     status_t res = OK;
-    size_t size = sizeof(T);
-    switch(mEndian) {
-        case BIG: {
-            for (size_t i = offset; i < count; ++i) {
-                T tmp = convertToBigEndian<T>(buf[offset + i]);
-                if ((res = mOutput->write(reinterpret_cast<uint8_t*>(&tmp), 0, size))
-                        != OK) {
-                    return res;
+    const size_t size = sizeof(T);
+    const size_t blockElements = WRITE_BLOCK_SIZE / size;
+
+    // Swap elements into a local block and issue one write to the wrapped
+    // Output per block, rather than one write per element.  The swap loops
+    // over a block are trivially auto-vectorizable.
+    T block[WRITE_BLOCK_SIZE / sizeof(T)];
+    size_t index = offset;
+    while (index < count) {
+        size_t blockCount = count - index;
+        if (blockCount > blockElements) {
+            blockCount = blockElements;
+        }
+        switch(mEndian) {
+            case BIG: {
+                for (size_t i = 0; i < blockCount; ++i) {
+                    block[i] = convertToBigEndian<T>(buf[index + i]);
                 }
-                mOffset += size;
+                break;
             }
-            break;
-        }
-        case LITTLE: {
-            for (size_t i = offset; i < count; ++i) {
-                T tmp = convertToLittleEndian<T>(buf[offset + i]);
-                if ((res = mOutput->write(reinterpret_cast<uint8_t*>(&tmp), 0, size))
-                        != OK) {
-                    return res;
+            case LITTLE: {
+                for (size_t i = 0; i < blockCount; ++i) {
+                    block[i] = convertToLittleEndian<T>(buf[index + i]);
                 }
-                mOffset += size;
+                break;
+            }
+            default: {
+                return BAD_VALUE;
             }
-            break;
         }
-        default: {
-            return BAD_VALUE;
+        if ((res = mOutput->write(reinterpret_cast<uint8_t*>(block), 0, blockCount * size))
+                != OK) {
+            return res;
         }
+        mOffset += blockCount * size;
+        index += blockCount;
     }
     return res;
 }
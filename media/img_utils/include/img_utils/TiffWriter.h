@@ -265,6 +265,13 @@ class ANDROID_API TiffWriter : public LightRefBase<TiffWriter> {
         KeyedVector<uint16_t, const TagDefinition_t*>* mTagMaps;
         size_t mNumTagMaps;
 
+        // Strip layout computed by the first write with strip sources, reused
+        // by subsequent writes on the same writer (e.g. for burst captures
+        // where only the entry values change between frames).  Maps the IFD ID
+        // to the word-aligned end offset of its strip data.
+        KeyedVector<uint32_t, uint32_t> mCachedStripLayout;
+        uint32_t mCachedHeaderSize;
+
         static KeyedVector<uint16_t, const TagDefinition_t*> sTagMaps[];
 };
 
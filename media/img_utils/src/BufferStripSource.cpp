@@ -0,0 +1,88 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <img_utils/BufferStripSource.h>
+
+#include <utils/Log.h>
+
+#include <inttypes.h>
+#include <string.h>
+
+namespace android {
+namespace img_utils {
+
+BufferStripSource::BufferStripSource(uint32_t ifd, const uint8_t* pixels, uint32_t width,
+        uint32_t height, size_t bytesPerPixel, size_t pixelStride, size_t rowStride)
+        : mIfd(ifd), mPixels(pixels), mWidth(width), mHeight(height),
+          mBytesPerPixel(bytesPerPixel), mPixelStride(pixelStride), mRowStride(rowStride) {}
+
+BufferStripSource::~BufferStripSource() {}
+
+status_t BufferStripSource::writeToStream(Output& stream, uint32_t count) {
+    uint64_t packedSize = static_cast<uint64_t>(mWidth) * mHeight * mBytesPerPixel;
+    if (count != packedSize) {
+        ALOGE("%s: Requested strip size %u does not match packed buffer size %" PRIu64 ".",
+                __FUNCTION__, count, packedSize);
+        return BAD_VALUE;
+    }
+
+    status_t res = OK;
+    size_t packedRowSize = mWidth * mBytesPerPixel;
+
+    if (mPixelStride == mBytesPerPixel) {
+        if (mRowStride == packedRowSize) {
+            // Fully packed buffer, write it in one go.
+            return stream.write(mPixels, 0, packedSize);
+        }
+        // Packed rows with row padding, write each row directly from the
+        // buffer without copying.
+        for (uint32_t row = 0; row < mHeight; ++row) {
+            if ((res = stream.write(mPixels + row * mRowStride, 0, packedRowSize)) != OK) {
+                ALOGE("%s: Failed to write row %u, received %d.", __FUNCTION__, row, res);
+                return res;
+            }
+        }
+        return OK;
+    }
+
+    // Padded pixels, pack one row at a time through a local buffer.
+    uint8_t* rowBuf = new uint8_t[packedRowSize];
+    if (rowBuf == NULL) {
+        ALOGE("%s: Could not allocate %zu byte row buffer.", __FUNCTION__, packedRowSize);
+        return NO_MEMORY;
+    }
+
+    for (uint32_t row = 0; row < mHeight; ++row) {
+        const uint8_t* src = mPixels + row * mRowStride;
+        for (uint32_t pixel = 0; pixel < mWidth; ++pixel) {
+            memcpy(rowBuf + pixel * mBytesPerPixel, src + pixel * mPixelStride, mBytesPerPixel);
+        }
+        if ((res = stream.write(rowBuf, 0, packedRowSize)) != OK) {
+            ALOGE("%s: Failed to write row %u, received %d.", __FUNCTION__, row, res);
+            break;
+        }
+    }
+
+    delete[] rowBuf;
+    return res;
+}
+
+uint32_t BufferStripSource::getIfd() const {
+    return mIfd;
+}
+
+} /*namespace img_utils*/
+} /*namespace android*/
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <img_utils/BufferedOutput.h>
+
+#include <utils/Log.h>
+
+#include <string.h>
+
+namespace android {
+namespace img_utils {
+
+BufferedOutput::BufferedOutput(Output* out, size_t bufferSize)
+        : mOutput(out), mBuffer(NULL), mBufferSize(bufferSize), mBuffered(0) {}
+
+BufferedOutput::~BufferedOutput() {
+    if (mBuffered > 0) {
+        ALOGW("%s: Destructor called with %zu bytes still buffered.", __FUNCTION__, mBuffered);
+    }
+    delete[] mBuffer;
+}
+
+status_t BufferedOutput::open() {
+    if (mBuffer == NULL) {
+        mBuffer = new uint8_t[mBufferSize];
+        if (mBuffer == NULL) {
+            ALOGE("%s: Could not allocate %zu byte buffer.", __FUNCTION__, mBufferSize);
+            return NO_MEMORY;
+        }
+    }
+    mBuffered = 0;
+    return mOutput->open();
+}
+
+status_t BufferedOutput::write(const uint8_t* buf, size_t offset, size_t count) {
+    if (mBuffer == NULL) {
+        ALOGE("%s: Could not write, BufferedOutput not open.", __FUNCTION__);
+        return BAD_VALUE;
+    }
+
+    // Large writes bypass the buffer entirely to avoid an extra copy.
+    if (count >= mBufferSize) {
+        status_t res = flush();
+        if (res != OK) {
+            return res;
+        }
+        return mOutput->write(buf, offset, count);
+    }
+
+    if (mBuffered + count > mBufferSize) {
+        status_t res = flush();
+        if (res != OK) {
+            return res;
+        }
+    }
+
+    memcpy(mBuffer + mBuffered, buf + offset, count);
+    mBuffered += count;
+    return OK;
+}
+
+status_t BufferedOutput::flush() {
+    if (mBuffered == 0) {
+        return OK;
+    }
+    status_t res = mOutput->write(mBuffer, 0, mBuffered);
+    if (res != OK) {
+        ALOGE("%s: Failed to write %zu buffered bytes, received %d.", __FUNCTION__, mBuffered,
+                res);
+        return res;
+    }
+    mBuffered = 0;
+    return OK;
+}
+
+status_t BufferedOutput::close() {
+    status_t res = flush();
+    status_t closeRes = mOutput->close();
+    return (res != OK) ? res : closeRes;
+}
+
+} /*namespace img_utils*/
+} /*namespace android*/
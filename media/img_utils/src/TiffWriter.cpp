@@ -49,10 +49,12 @@ KeyedVector<uint16_t, const TagDefinition_t*> TiffWriter::sTagMaps[] = {
     buildTagMap(TIFF_6_TAG_DEFINITIONS, ARRAY_SIZE(TIFF_6_TAG_DEFINITIONS))
 };
 
-TiffWriter::TiffWriter() : mTagMaps(sTagMaps), mNumTagMaps(DEFAULT_NUM_TAG_MAPS) {}
+TiffWriter::TiffWriter() : mTagMaps(sTagMaps), mNumTagMaps(DEFAULT_NUM_TAG_MAPS),
+        mCachedHeaderSize(0) {}
 
 TiffWriter::TiffWriter(KeyedVector<uint16_t, const TagDefinition_t*>* enabledDefinitions,
-        size_t length) : mTagMaps(enabledDefinitions), mNumTagMaps(length) {}
+        size_t length) : mTagMaps(enabledDefinitions), mNumTagMaps(length),
+        mCachedHeaderSize(0) {}
 
 TiffWriter::~TiffWriter() {}
 
@@ -66,7 +68,8 @@ status_t TiffWriter::write(Output* out, StripSource** sources, size_t sourcesCou
         return BAD_VALUE;
     }
 
-    uint32_t totalSize = getTotalSize();
+    uint32_t headerSize = getTotalSize();
+    uint32_t totalSize = headerSize;
 
     KeyedVector<uint32_t, uint32_t> offsetVector;
 
@@ -83,6 +86,22 @@ status_t TiffWriter::write(Output* out, StripSource** sources, size_t sourcesCou
         }
     }
 
+    if (offsetVector.size() == 0 && mCachedStripLayout.size() != 0) {
+        // Reusable-writer mode: the strip offsets were laid out by a previous
+        // write on this writer.  Reuse the cached layout so that a burst of
+        // frames sharing one IFD structure only needs entry values updated
+        // between writes, instead of rebuilding the whole writer per frame.
+        if (headerSize != mCachedHeaderSize) {
+            ALOGE("%s: IFD layout changed since the last write (header size %u vs %u),"
+                    " strip offsets are stale.", __FUNCTION__, headerSize, mCachedHeaderSize);
+            return BAD_VALUE;
+        }
+        offsetVector = mCachedStripLayout;
+    } else {
+        mCachedStripLayout = offsetVector;
+        mCachedHeaderSize = headerSize;
+    }
+
     size_t offVecSize = offsetVector.size();
     if (offVecSize != sourcesCount) {
         ALOGE("%s: Mismatch between number of IFDs with uninitialized strips (%zu) and"
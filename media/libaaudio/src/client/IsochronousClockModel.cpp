@@ -61,6 +61,11 @@ void IsochronousClockModel::start(int64_t nanoTime) {
     ALOGV("start(nanos = %lld)\n", (long long) nanoTime);
     mMarkerNanoTime = nanoTime;
     mState = STATE_STARTING;
+    // Positions restart from zero but the measured drift is a property of the
+    // hardware clock, so only the rate baseline is discarded.
+    mRateNanoTime = 0;
+    mRateFramePosition = 0;
+    mRateBestPartsPerBillion = INT64_MAX;
     if (mHistogramMicros) {
         mHistogramMicros->clear();
     }
@@ -131,6 +136,7 @@ void IsochronousClockModel::processTimestamp(int64_t framePosition, int64_t nano
         }
         // Modify estimated position based on lateness.
         // This affects the "early" side of the window, which controls output glitches.
+        measureClockRate(framePosition, nanoTime);
         if (latenessNanos < 0) {
             // Earlier than expected timestamp.
             // This data is probably more accurate, so use it.
@@ -191,9 +197,58 @@ void IsochronousClockModel::processTimestamp(int64_t framePosition, int64_t nano
 
 void IsochronousClockModel::setSampleRate(int32_t sampleRate) {
     mSampleRate = sampleRate;
+    mRateNanoTime = 0;
+    mRateFramePosition = 0;
+    mRateBestPartsPerBillion = INT64_MAX;
+    mDriftPartsPerBillion = 0;
     update();
 }
 
+void IsochronousClockModel::measureClockRate(int64_t framePosition, int64_t nanoTime) {
+    if (mRateNanoTime == 0) {
+        mRateFramePosition = framePosition;
+        mRateNanoTime = nanoTime;
+        return;
+    }
+    int64_t framesDelta = framePosition - mRateFramePosition;
+    int64_t nanosDelta = nanoTime - mRateNanoTime;
+    if (nanosDelta < kMinRateBaselineNanos) {
+        return;
+    }
+    // Compare against the NOMINAL rate, not the corrected conversion,
+    // so this is an absolute measurement and not a relative one.
+    int64_t nominalNanosDelta = (AAUDIO_NANOS_PER_SECOND * framesDelta) / mSampleRate;
+    if (nominalNanosDelta < AAUDIO_NANOS_PER_MILLISECOND) {
+        return;
+    }
+    // Scale down before multiplying so the intermediate cannot overflow.
+    int64_t driftPpb = ((nanosDelta - nominalNanosDelta) * 1000)
+            / (nominalNanosDelta / 1000000);
+    // Scheduling delay only ever makes a timestamp LATER, so the least-late
+    // candidate in the window is the closest to the true hardware clock.
+    if (driftPpb < mRateBestPartsPerBillion) {
+        mRateBestPartsPerBillion = driftPpb;
+        mRateBestFramePosition = framePosition;
+        mRateBestNanoTime = nanoTime;
+    }
+    if (nanosDelta < kMaxRateBaselineNanos) {
+        return;
+    }
+    driftPpb = std::max(-kMaxDriftPartsPerBillion,
+            std::min(kMaxDriftPartsPerBillion, mRateBestPartsPerBillion));
+    // Smooth the estimate; even the best candidate carries some noise.
+    mDriftPartsPerBillion = ((3 * mDriftPartsPerBillion) + driftPpb) / 4;
+#if ICM_LOG_DRIFT
+    ALOGD("%s() - measured drift = %d ppb, smoothed = %d ppb",
+            __func__, (int) driftPpb, (int) mDriftPartsPerBillion);
+#endif
+    // Restart the baseline at the least-late pair so the next window
+    // starts from an accurate sample.
+    mRateFramePosition = mRateBestFramePosition;
+    mRateNanoTime = mRateBestNanoTime;
+    mRateBestPartsPerBillion = INT64_MAX;
+}
+
 void IsochronousClockModel::setFramesPerBurst(int32_t framesPerBurst) {
     mFramesPerBurst = framesPerBurst;
     update();
@@ -205,11 +260,15 @@ void IsochronousClockModel::update() {
 }
 
 int64_t IsochronousClockModel::convertDeltaPositionToTime(int64_t framesDelta) const {
-    return (AAUDIO_NANOS_PER_SECOND * framesDelta) / mSampleRate;
+    int64_t nanosDelta = (AAUDIO_NANOS_PER_SECOND * framesDelta) / mSampleRate;
+    // A slower DSP clock (positive drift) takes longer to advance the frames.
+    return nanosDelta + ((nanosDelta * mDriftPartsPerBillion) / AAUDIO_NANOS_PER_SECOND);
 }
 
 int64_t IsochronousClockModel::convertDeltaTimeToPosition(int64_t nanosDelta) const {
-    return (mSampleRate * nanosDelta) / AAUDIO_NANOS_PER_SECOND;
+    int64_t framesDelta = (mSampleRate * nanosDelta) / AAUDIO_NANOS_PER_SECOND;
+    // First order inverse of the correction in convertDeltaPositionToTime().
+    return framesDelta - ((framesDelta * mDriftPartsPerBillion) / AAUDIO_NANOS_PER_SECOND);
 }
 
 int64_t IsochronousClockModel::convertPositionToTime(int64_t framePosition) const {
@@ -262,6 +321,7 @@ void IsochronousClockModel::dump() const {
     ALOGD("mSampleRate          = %6d", mSampleRate);
     ALOGD("mFramesPerBurst      = %6d", mFramesPerBurst);
     ALOGD("mMaxMeasuredLatenessNanos = %6d", mMaxMeasuredLatenessNanos);
+    ALOGD("mDriftPartsPerBillion = %6d", (int) mDriftPartsPerBillion);
     ALOGD("mState               = %6d", mState);
 }
 
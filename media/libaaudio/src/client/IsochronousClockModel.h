@@ -132,6 +132,16 @@ private:
     int32_t getLateTimeOffsetNanos() const;
     void update();
 
+    /**
+     * Update the measured DSP clock rate from a timestamp.
+     * Timestamps are delayed by scheduling noise but never arrive before the
+     * hardware reached the position, so the least-late sample over a long
+     * baseline tracks the true clock. The measured rate is folded into the
+     * position/time conversions so the model follows a drifting hardware
+     * clock instead of repeatedly lurching after it with marker adjustments.
+     */
+    void measureClockRate(int64_t framePosition, int64_t nanoTime);
+
     enum clock_model_state_t {
         STATE_STOPPED,
         STATE_STARTING,
@@ -149,6 +159,15 @@ private:
     static constexpr int32_t   kHistogramBinWidthMicros = 50;
     static constexpr int32_t   kHistogramBinCount = 128;
 
+    // Minimum baseline for a clock rate measurement. Shorter intervals are
+    // dominated by scheduling jitter rather than actual drift.
+    static constexpr int64_t   kMinRateBaselineNanos = 10 * AAUDIO_NANOS_PER_SECOND;
+    // Fold the best candidate into the estimate and start a fresh baseline
+    // after this long, so old measurements age out.
+    static constexpr int64_t   kMaxRateBaselineNanos = 60 * AAUDIO_NANOS_PER_SECOND;
+    // Limit the correction to +/- 200 ppm, generous for a crystal oscillator.
+    static constexpr int64_t   kMaxDriftPartsPerBillion = 200 * 1000;
+
     int64_t             mMarkerFramePosition{0}; // Estimated HW position.
     int64_t             mMarkerNanoTime{0};      // Estimated HW time.
     int32_t             mSampleRate{48000};
@@ -162,6 +181,17 @@ private:
 
     int32_t             mTimestampCount = 0;  // For logging.
 
+    // Baseline timestamp pair for measuring the actual DSP clock rate.
+    int64_t             mRateFramePosition{0};
+    int64_t             mRateNanoTime{0};
+    // Least-late rate candidate seen in the current measurement window.
+    int64_t             mRateBestPartsPerBillion{INT64_MAX};
+    int64_t             mRateBestFramePosition{0};
+    int64_t             mRateBestNanoTime{0};
+    // Measured deviation of the DSP clock from nominal, in parts per billion.
+    // Positive means the DSP clock is slower than nominal.
+    int64_t             mDriftPartsPerBillion{0};
+
     // distribution of timestamps relative to earliest
     std::unique_ptr<android::audio_utils::Histogram>   mHistogramMicros;
 
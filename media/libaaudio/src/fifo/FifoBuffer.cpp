@@ -95,19 +95,30 @@ void FifoBuffer::fillWrappingBuffer(WrappingBuffer *wrappingBuffer,
 }
 
 fifo_frames_t FifoBuffer::getFullDataAvailable(WrappingBuffer *wrappingBuffer) {
+    // Take a single snapshot of each counter so that the frame count and the
+    // start index agree even if the writer advances between loads.
+    fifo_counter_t readCounter = mFifo->getReadCounter();
+    fifo_counter_t writeCounter = mFifo->getWriteCounter();
+    fifo_frames_t framesAvailable = 0;
+    __builtin_sub_overflow(writeCounter, readCounter, &framesAvailable);
     // The FIFO might be overfull so clip to capacity.
-    fifo_frames_t framesAvailable = std::min(mFifo->getFullFramesAvailable(),
-                                             mFifo->getCapacity());
-    fifo_frames_t startIndex = mFifo->getReadIndex();
+    framesAvailable = std::min(framesAvailable, mFifo->getCapacity());
+    fifo_frames_t startIndex = (fifo_frames_t) ((uint64_t) readCounter % mFifo->getCapacity());
     fillWrappingBuffer(wrappingBuffer, framesAvailable, startIndex);
     return framesAvailable;
 }
 
 fifo_frames_t FifoBuffer::getEmptyRoomAvailable(WrappingBuffer *wrappingBuffer) {
+    // Take a single snapshot of each counter so that the frame count and the
+    // start index agree even if the reader advances between loads.
+    fifo_counter_t writeCounter = mFifo->getWriteCounter();
+    fifo_counter_t readCounter = mFifo->getReadCounter();
+    fifo_frames_t fullFrames = 0;
+    __builtin_sub_overflow(writeCounter, readCounter, &fullFrames);
     // The FIFO might have underrun so clip to capacity.
-    fifo_frames_t framesAvailable = std::min(mFifo->getEmptyFramesAvailable(),
+    fifo_frames_t framesAvailable = std::min((fifo_frames_t) (mFifo->getThreshold() - fullFrames),
                                              mFifo->getCapacity());
-    fifo_frames_t startIndex = mFifo->getWriteIndex();
+    fifo_frames_t startIndex = (fifo_frames_t) ((uint64_t) writeCounter % mFifo->getCapacity());
     fillWrappingBuffer(wrappingBuffer, framesAvailable, startIndex);
     return framesAvailable;
 }
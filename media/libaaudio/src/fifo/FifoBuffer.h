@@ -58,6 +58,12 @@ public:
      * Return pointer to available full frames in data1 and set size in numFrames1.
      * if the data is split across the end of the FIFO then set data2 and numFrames2.
      * Other wise set them to null
+     *
+     * Together with advanceReadIndex() this forms a zero-copy claim/commit
+     * pair: read directly from the returned regions and then commit the
+     * frames consumed with advanceReadIndex(). That avoids the intermediate
+     * copy done by read().
+     *
      * @param wrappingBuffer
      * @return total full frames available
      */
@@ -67,6 +73,12 @@ public:
      * Return pointer to available empty frames in data1 and set size in numFrames1.
      * if the room is split across the end of the FIFO then set data2 and numFrames2.
      * Other wise set them to null
+     *
+     * Together with advanceWriteIndex() this forms a zero-copy claim/commit
+     * pair: write directly into the returned regions and then commit the
+     * frames written with advanceWriteIndex(). That avoids the intermediate
+     * copy done by write().
+     *
      * @param wrappingBuffer
      * @return total empty frames available
      */
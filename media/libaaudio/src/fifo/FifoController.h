@@ -53,8 +53,11 @@ public:
     }
 
 private:
-    std::atomic<fifo_counter_t> mReadCounter;
-    std::atomic<fifo_counter_t> mWriteCounter;
+    // Each counter is written by a different thread, so keep them on separate
+    // cache lines to avoid false sharing between the reader and writer cores.
+    static constexpr size_t kCacheLineSize = 64;
+    alignas(kCacheLineSize) std::atomic<fifo_counter_t> mReadCounter;
+    alignas(kCacheLineSize) std::atomic<fifo_counter_t> mWriteCounter;
 };
 
 }  // namespace android
@@ -2090,6 +2090,7 @@ ConversionResult<media::AudioPatch> legacy2aidl_audio_patch_AudioPatch(
     if (legacy.num_sinks > AUDIO_PATCH_PORTS_MAX) {
         return unexpected(BAD_VALUE);
     }
+    aidl.sinks.reserve(legacy.num_sinks);
     for (unsigned int i = 0; i < legacy.num_sinks; ++i) {
         aidl.sinks.push_back(
                 VALUE_OR_RETURN(legacy2aidl_audio_port_config_AudioPortConfig(legacy.sinks[i])));
@@ -2097,6 +2098,7 @@ ConversionResult<media::AudioPatch> legacy2aidl_audio_patch_AudioPatch(
     if (legacy.num_sources > AUDIO_PATCH_PORTS_MAX) {
         return unexpected(BAD_VALUE);
     }
+    aidl.sources.reserve(legacy.num_sources);
     for (unsigned int i = 0; i < legacy.num_sources; ++i) {
         aidl.sources.push_back(
                 VALUE_OR_RETURN(legacy2aidl_audio_port_config_AudioPortConfig(legacy.sources[i])));
@@ -2104,6 +2106,32 @@ ConversionResult<media::AudioPatch> legacy2aidl_audio_patch_AudioPatch(
     return aidl;
 }
 
+ConversionResult<std::vector<audio_port_config>>
+aidl2legacy_AudioPortConfigs_audio_port_configs(
+        const std::vector<media::AudioPortConfig>& aidl) {
+    return convertContainer<std::vector<audio_port_config>>(
+            aidl, aidl2legacy_AudioPortConfig_audio_port_config);
+}
+
+ConversionResult<std::vector<media::AudioPortConfig>>
+legacy2aidl_audio_port_configs_AudioPortConfigs(
+        const std::vector<audio_port_config>& legacy) {
+    return convertContainer<std::vector<media::AudioPortConfig>>(
+            legacy, legacy2aidl_audio_port_config_AudioPortConfig);
+}
+
+ConversionResult<std::vector<struct audio_patch>>
+aidl2legacy_AudioPatches_audio_patches(const std::vector<media::AudioPatch>& aidl) {
+    return convertContainer<std::vector<struct audio_patch>>(
+            aidl, aidl2legacy_AudioPatch_audio_patch);
+}
+
+ConversionResult<std::vector<media::AudioPatch>>
+legacy2aidl_audio_patches_AudioPatches(const std::vector<struct audio_patch>& legacy) {
+    return convertContainer<std::vector<media::AudioPatch>>(
+            legacy, legacy2aidl_audio_patch_AudioPatch);
+}
+
 ConversionResult<sp<AudioIoDescriptor>> aidl2legacy_AudioIoDescriptor_AudioIoDescriptor(
         const media::AudioIoDescriptor& aidl) {
     const audio_io_handle_t io_handle = VALUE_OR_RETURN(
@@ -2927,6 +2955,20 @@ legacy2aidl_audio_profile_AudioProfile(const audio_profile& legacy, bool isInput
     return aidl;
 }
 
+ConversionResult<std::vector<audio_profile>>
+aidl2legacy_AudioProfiles_audio_profiles(
+        const std::vector<AudioProfile>& aidl, bool isInput) {
+    return convertContainer<std::vector<audio_profile>>(
+            aidl, aidl2legacy_AudioProfile_audio_profile, isInput);
+}
+
+ConversionResult<std::vector<AudioProfile>>
+legacy2aidl_audio_profiles_AudioProfiles(
+        const std::vector<audio_profile>& legacy, bool isInput) {
+    return convertContainer<std::vector<AudioProfile>>(
+            legacy, legacy2aidl_audio_profile_AudioProfile, isInput);
+}
+
 ConversionResult<audio_gain>
 aidl2legacy_AudioGain_audio_gain(const AudioGain& aidl, bool isInput) {
     audio_gain legacy;
@@ -1324,6 +1324,77 @@ ssize_t AudioRecord::read(void* buffer, size_t userSize, bool blocking)
     return read;
 }
 
+ssize_t AudioRecord::readBatch(void* buffer, size_t userSize, ExtendedTimestamp* timestamp)
+{
+    if (mTransfer != TRANSFER_SYNC) {
+        return INVALID_OPERATION;
+    }
+
+    if (ssize_t(userSize) < 0 || (buffer == NULL && userSize != 0)) {
+        ALOGE("%s(%d) (buffer=%p, size=%zu (%zu)",
+                __func__, mPortId, buffer, userSize, userSize);
+        return BAD_VALUE;
+    }
+
+    ssize_t read = 0;
+    Buffer audioBuffer;
+
+    while (userSize >= mFrameSize) {
+        audioBuffer.frameCount = userSize / mFrameSize;
+
+        // drain without blocking; when the ring runs dry we sleep for the
+        // capture time of the missing frames instead of waking per period.
+        status_t err = obtainBuffer(&audioBuffer, &ClientProxy::kNonBlocking);
+        if (err == WOULD_BLOCK || err == TIMED_OUT || err == -EINTR) {
+            bool active;
+            {
+                AutoMutex lock(mLock);
+                active = mActive;
+            }
+            if (!active) {
+                // stopped mid-batch; return what we have, as read() does.
+                if (read > 0) {
+                    break;
+                }
+                return ssize_t(WOULD_BLOCK);
+            }
+            const size_t remainingFrames = userSize / mFrameSize;
+            const int64_t sleepNs = (int64_t)remainingFrames * 1000000000LL / mSampleRate;
+            const struct timespec ts = {
+                    .tv_sec = (time_t)(sleepNs / 1000000000LL),
+                    .tv_nsec = (long)(sleepNs % 1000000000LL),
+            };
+            nanosleep(&ts, NULL);
+            continue;
+        }
+        if (err < 0) {
+            if (read > 0) {
+                break;
+            }
+            return ssize_t(err);
+        }
+
+        size_t bytesRead = audioBuffer.frameCount * mFrameSize;
+        memcpy_by_audio_format(buffer, mFormat, audioBuffer.raw, mServerConfig.format,
+                               audioBuffer.mSize / mServerSampleSize);
+        buffer = ((char *) buffer) + bytesRead;
+        userSize -= bytesRead;
+        read += bytesRead;
+
+        releaseBuffer(&audioBuffer);
+    }
+    if (read > 0) {
+        mFramesRead += read / mFrameSize;
+    }
+
+    // One coherent timestamp for the batch: after accounting the frames
+    // above, LOCATION_CLIENT is the frame one past the returned span.
+    if (timestamp != nullptr && read > 0) {
+        (void)getTimestamp(timestamp);
+    }
+    return read;
+}
+
 // -------------------------------------------------------------------------
 
 nsecs_t AudioRecord::processAudioBuffer()
@@ -20,6 +20,7 @@
 
 #include <inttypes.h>
 #include <math.h>
+#include <sched.h>
 #include <sys/resource.h>
 #include <thread>
 
@@ -29,6 +30,7 @@
 #include <audio_utils/clock.h>
 #include <audio_utils/primitives.h>
 #include <binder/IPCThreadState.h>
+#include <cutils/properties.h>
 #include <media/AudioTrack.h>
 #include <utils/Log.h>
 #include <private/media/AudioTrackShared.h>
@@ -557,6 +559,7 @@ status_t AudioTrack::set(
     uid_t uid = VALUE_OR_FATAL(aidl2legacy_int32_t_uid_t(attributionSource.uid));
     pid_t pid = VALUE_OR_FATAL(aidl2legacy_int32_t_pid_t(attributionSource.pid));
     std::string errorMessage;
+    bool directFromNativeRate = false;
     // Note mPortId is not valid until the track is created, so omit mPortId in ALOG for set.
     ALOGV("%s(): streamType %d, sampleRate %u, format %#x, channelMask %#x, frameCount %zu, "
           "flags #%x, notificationFrames %d, sessionId %d, transferType %d, uid %d, pid %d",
@@ -611,6 +614,29 @@ status_t AudioTrack::set(
         flags = (audio_output_flags_t)(flags | AUDIO_OUTPUT_FLAG_DIRECT);
     }
 
+    // When the device declares a direct PCM profile for this exact
+    // configuration (e.g. a HAL-side sample rate converter), deliver the
+    // client's native rate straight through instead of resampling in the
+    // mixer. Opt-in per device since direct outputs bypass mixer effects.
+    if (flags == AUDIO_OUTPUT_FLAG_NONE
+            && sampleRate != 0
+            && sharedBuffer == 0
+            && audio_is_linear_pcm(format)
+            && property_get_bool("audio.direct_pcm_output.enabled", false)) {
+        const audio_config_base_t config = {
+                .sample_rate = sampleRate,
+                .channel_mask = channelMask,
+                .format = format,
+        };
+        const audio_attributes_t attributes =
+                pAttributes != nullptr ? *pAttributes : AUDIO_ATTRIBUTES_INITIALIZER;
+        if (isDirectOutputSupported(config, attributes)) {
+            ALOGV("%s(): using direct output for native rate %u", __func__, sampleRate);
+            flags = AUDIO_OUTPUT_FLAG_DIRECT;
+            directFromNativeRate = true;
+        }
+    }
+
     mFormat = format;
     mOrigFlags = mFlags = flags;
 
@@ -793,6 +819,13 @@ status_t AudioTrack::set(
     {
         AutoMutex lock(mLock);
         status = createTrack_l();
+        if (status != NO_ERROR && directFromNativeRate) {
+            // The direct open was negotiated opportunistically; fall back to
+            // the mixed output rather than failing the track.
+            ALOGV("%s(): direct output refused, falling back to mixer", __func__);
+            mOrigFlags = mFlags = AUDIO_OUTPUT_FLAG_NONE;
+            status = createTrack_l();
+        }
     }
     if (status != NO_ERROR) {
         if (mAudioTrackThread != 0) {
@@ -959,7 +992,12 @@ status_t AudioTrack::start()
             mFramesWrittenServerOffset -= mStartEts.mPosition[ExtendedTimestamp::LOCATION_SERVER];
         }
         mFramesWritten = 0;
+        // exclude the lock-free fast path poller from the proxy timestamp cache.
+        while (mTimestampPollerLock.test_and_set(std::memory_order_acquire)) {
+            sched_yield();
+        }
         mProxy->clearTimestamp(); // need new server push for valid timestamp
+        mTimestampPollerLock.clear(std::memory_order_release);
         mMarkerReached = false;
 
         // For offloaded tracks, we don't know if the hardware counters are really zero here,
@@ -1891,6 +1929,7 @@ status_t AudioTrack::createTrack_l()
 {
     status_t status;
     bool callbackAdded = false;
+    bool timestampFastPathQuiesced = false;
     std::string errorMessage;
 
     const sp<IAudioFlinger>& audioFlinger = AudioSystem::get_audio_flinger();
@@ -2030,6 +2069,14 @@ status_t AudioTrack::createTrack_l()
         mDeathNotifier.clear();
     }
     mAudioTrack = output.audioTrack;
+    // Quiesce the lock-free timestamp fast path before the control block and
+    // proxy are replaced; re-enabled at exit once the new proxy is in place.
+    mTimestampFastPathEnabled.store(false, std::memory_order_release);
+    while (mTimestampPollerLock.test_and_set(std::memory_order_acquire)) {
+        sched_yield();
+    }
+    timestampFastPathQuiesced = true;
+
     mCblkMemory = iMem;
     IPCThreadState::self()->flushCommands();
 
@@ -2181,6 +2228,13 @@ status_t AudioTrack::createTrack_l()
     }
 
 exit:
+    if (timestampFastPathQuiesced) {
+        mTimestampPollerLock.clear(std::memory_order_release);
+        // the fast path supports only normal PCM tracks, matching getTimestamp_l().
+        if (status == NO_ERROR && !isOffloadedOrDirect_l()) {
+            mTimestampFastPathEnabled.store(true, std::memory_order_release);
+        }
+    }
     if (status != NO_ERROR) {
         if (callbackAdded) {
             // note: mOutput is always valid is callbackAdded is true
@@ -3028,7 +3082,7 @@ retry:
         }
         // server resets to zero so we offset
         mFramesWrittenServerOffset =
-                mStaticProxy.get() != nullptr ? staticPosition : mFramesWritten;
+                mStaticProxy.get() != nullptr ? staticPosition : mFramesWritten.load();
         mFramesWrittenAtRestore = mFramesWrittenServerOffset;
     }
     if (result != NO_ERROR) {
@@ -3172,10 +3226,80 @@ status_t AudioTrack::getTimestamp(ExtendedTimestamp *timestamp)
     if (timestamp == nullptr) {
         return BAD_VALUE;
     }
+    status_t status;
+    if (getTimestampLockFree(timestamp, &status)) {
+        return status;
+    }
     AutoMutex lock(mLock);
     return getTimestamp_l(timestamp);
 }
 
+bool AudioTrack::getTimestampLockFree(ExtendedTimestamp *timestamp, status_t *status)
+{
+    // The server publishes its ExtendedTimestamp through the single state
+    // queue in the shared control block, so a query needs no IPC; what it
+    // needed until now was mLock, which a writing thread may hold across
+    // obtainBuffer() for milliseconds.  Low latency clients poll position on
+    // the order of every couple of milliseconds, so we avoid mLock entirely
+    // here when the track is in a steady state.
+    if (!mTimestampFastPathEnabled.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (!mTimestampPollerLock.test_and_set(std::memory_order_acquire)) {
+        // We are the poller.  createTrack_l() cannot swap the control block
+        // or proxy while we hold the flag, and it disables the fast path
+        // before taking it, so re-check after winning the flag.
+        if (!mTimestampFastPathEnabled.load(std::memory_order_acquire)
+                || (mCblk->mFlags & CBLK_INVALID)) {
+            mTimestampPollerLock.clear(std::memory_order_release);
+            return false;  // the locked path restores the track.
+        }
+        ExtendedTimestamp ets;
+        (void) mProxy->getTimestamp(&ets);  // never fails with non-null argument.
+        ets.mPosition[ExtendedTimestamp::LOCATION_CLIENT] =
+                mFramesWritten.load(std::memory_order_relaxed);
+        ets.mTimeNs[ExtendedTimestamp::LOCATION_CLIENT] = 0;
+        // server side frame offset in case AudioTrack has been restored.
+        const int64_t serverOffset = mFramesWrittenServerOffset.load(std::memory_order_relaxed);
+        bool found = false;
+        for (int i = ExtendedTimestamp::LOCATION_SERVER;
+                i < ExtendedTimestamp::LOCATION_MAX; ++i) {
+            if (ets.mTimeNs[i] >= 0) {
+                ets.mPosition[i] += serverOffset;
+                found = true;
+            }
+        }
+        // republish for callers that lose the poller flag.
+        const uint32_t seq = mTimestampPublishSeq.load(std::memory_order_relaxed) + 1;
+        mTimestampPublishSeq.store(seq, std::memory_order_relaxed);  // odd
+        std::atomic_thread_fence(std::memory_order_release);
+        mPublishedTimestamp = ets;
+        mPublishedTimestampStatus = found ? OK : WOULD_BLOCK;
+        mTimestampPublishSeq.store(seq + 1, std::memory_order_release);  // even
+        mTimestampPollerLock.clear(std::memory_order_release);
+        *timestamp = ets;
+        *status = found ? (status_t) OK : (status_t) WOULD_BLOCK;
+        return true;
+    }
+    // Another thread is polling; read the copy it published, which is at
+    // most one poll old.
+    for (int tries = 0; tries < 3; ++tries) {
+        const uint32_t seq = mTimestampPublishSeq.load(std::memory_order_acquire);
+        if (seq == 0 || (seq & 1) != 0) {
+            continue;  // nothing published yet, or a publish is in flight.
+        }
+        const ExtendedTimestamp ets = mPublishedTimestamp;
+        const status_t publishedStatus = mPublishedTimestampStatus;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (mTimestampPublishSeq.load(std::memory_order_relaxed) == seq) {
+            *timestamp = ets;
+            *status = publishedStatus;
+            return true;
+        }
+    }
+    return false;  // contended; take the locked path.
+}
+
 status_t AudioTrack::getTimestamp_l(ExtendedTimestamp *timestamp)
 {
     if (mCblk->mFlags & CBLK_INVALID) {
@@ -3190,7 +3314,14 @@ status_t AudioTrack::getTimestamp_l(ExtendedTimestamp *timestamp)
     if (isOffloadedOrDirect_l()) {
         return INVALID_OPERATION; // not supported
     }
+    // exclude the lock-free fast path poller (see getTimestampLockFree());
+    // the proxy timestamp cache is not reentrant.  The poller never blocks
+    // while holding the flag, so this spin is bounded by one queue poll.
+    while (mTimestampPollerLock.test_and_set(std::memory_order_acquire)) {
+        sched_yield();
+    }
     status_t status = mProxy->getTimestamp(timestamp);
+    mTimestampPollerLock.clear(std::memory_order_release);
     LOG_ALWAYS_FATAL_IF(status != OK, "%s(%d): status %d not allowed from proxy getTimestamp",
             __func__, mPortId, status);
     bool found = false;
@@ -3262,8 +3393,13 @@ status_t AudioTrack::getTimestamp_l(AudioTimestamp& timestamp)
         }
     } else {
         // read timestamp from shared memory
+        // exclude the lock-free fast path poller from the proxy timestamp cache.
         ExtendedTimestamp ets;
+        while (mTimestampPollerLock.test_and_set(std::memory_order_acquire)) {
+            sched_yield();
+        }
         status = mProxy->getTimestamp(&ets);
+        mTimestampPollerLock.clear(std::memory_order_release);
         if (status == OK) {
             ExtendedTimestamp::Location location;
             status = ets.getBestTimestamp(&timestamp, &location);
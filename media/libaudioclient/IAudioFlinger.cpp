@@ -235,6 +235,17 @@ status_t AudioFlingerClientAdapter::createTrack(const media::CreateTrackRequest&
     return statusTFromBinderStatus(mDelegate->createTrack(input, &output));
 }
 
+status_t AudioFlingerClientAdapter::createTracks(
+        const std::vector<media::CreateTrackRequest>& inputs,
+        std::vector<media::CreateTrackResponse>* outputs,
+        std::vector<status_t>* statuses) {
+    std::vector<int32_t> statusesAidl;
+    status_t status = statusTFromBinderStatus(
+            mDelegate->createTracks(inputs, &statusesAidl, outputs));
+    statuses->assign(statusesAidl.begin(), statusesAidl.end());
+    return status;
+}
+
 status_t AudioFlingerClientAdapter::createRecord(const media::CreateRecordRequest& input,
                                                  media::CreateRecordResponse& output) {
     return statusTFromBinderStatus(mDelegate->createRecord(input, &output));
@@ -891,6 +902,16 @@ Status AudioFlingerServerAdapter::createTrack(const media::CreateTrackRequest& r
     return Status::fromStatusT(mDelegate->createTrack(request, *_aidl_return));
 }
 
+Status AudioFlingerServerAdapter::createTracks(
+        const std::vector<media::CreateTrackRequest>& requests,
+        std::vector<int32_t>* statuses,
+        std::vector<media::CreateTrackResponse>* _aidl_return) {
+    std::vector<status_t> statusesLegacy;
+    status_t status = mDelegate->createTracks(requests, _aidl_return, &statusesLegacy);
+    statuses->assign(statusesLegacy.begin(), statusesLegacy.end());
+    return Status::fromStatusT(status);
+}
+
 Status AudioFlingerServerAdapter::createRecord(const media::CreateRecordRequest& request,
                                                media::CreateRecordResponse* _aidl_return) {
     return Status::fromStatusT(mDelegate->createRecord(request, *_aidl_return));
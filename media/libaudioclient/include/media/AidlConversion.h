@@ -18,6 +18,7 @@
 
 #include <limits>
 #include <type_traits>
+#include <vector>
 
 #include <system/audio.h>
 
@@ -245,6 +246,21 @@ ConversionResult<struct audio_patch> aidl2legacy_AudioPatch_audio_patch(
 ConversionResult<media::AudioPatch> legacy2aidl_audio_patch_AudioPatch(
         const struct audio_patch& legacy);
 
+// Bulk variants for the conversions that audio policy performs in batches
+// (e.g. listAudioPatches / listAudioPorts round trips). The output vector is
+// preallocated to the input size and filled in a single pass.
+ConversionResult<std::vector<audio_port_config>>
+aidl2legacy_AudioPortConfigs_audio_port_configs(
+        const std::vector<media::AudioPortConfig>& aidl);
+ConversionResult<std::vector<media::AudioPortConfig>>
+legacy2aidl_audio_port_configs_AudioPortConfigs(
+        const std::vector<audio_port_config>& legacy);
+
+ConversionResult<std::vector<struct audio_patch>>
+aidl2legacy_AudioPatches_audio_patches(const std::vector<media::AudioPatch>& aidl);
+ConversionResult<std::vector<media::AudioPatch>>
+legacy2aidl_audio_patches_AudioPatches(const std::vector<struct audio_patch>& legacy);
+
 ConversionResult<sp<AudioIoDescriptor>> aidl2legacy_AudioIoDescriptor_AudioIoDescriptor(
         const media::AudioIoDescriptor& aidl);
 ConversionResult<media::AudioIoDescriptor> legacy2aidl_AudioIoDescriptor_AudioIoDescriptor(
@@ -375,6 +391,12 @@ aidl2legacy_AudioProfile_audio_profile(
 ConversionResult<media::audio::common::AudioProfile>
 legacy2aidl_audio_profile_AudioProfile(const audio_profile& legacy, bool isInput);
 
+ConversionResult<std::vector<audio_profile>>
+aidl2legacy_AudioProfiles_audio_profiles(
+        const std::vector<media::audio::common::AudioProfile>& aidl, bool isInput);
+ConversionResult<std::vector<media::audio::common::AudioProfile>>
+legacy2aidl_audio_profiles_AudioProfiles(const std::vector<audio_profile>& legacy, bool isInput);
+
 ConversionResult<audio_gain>
 aidl2legacy_AudioGain_audio_gain(const media::audio::common::AudioGain& aidl, bool isInput);
 ConversionResult<media::audio::common::AudioGain>
@@ -97,6 +97,22 @@ status_t convertRangeWithLimit(InputIterator start,
     return OK;
 }
 
+/**
+ * Reserves capacity in the output container upfront when the container supports
+ * it (e.g. std::vector), so that batch conversions allocate once instead of
+ * growing element by element. A no-op for containers without reserve().
+ */
+template<typename Container, typename = void>
+struct ContainerCapacity {
+    static void reserve(Container&, size_t) {}
+};
+
+template<typename Container>
+struct ContainerCapacity<Container,
+        std::void_t<decltype(std::declval<Container&>().reserve(size_t{}))>> {
+    static void reserve(Container& container, size_t size) { container.reserve(size); }
+};
+
 /**
  * A generic template that helps convert containers of convertible types.
  */
@@ -104,6 +120,7 @@ template<typename OutputContainer, typename InputContainer, typename Func>
 ConversionResult<OutputContainer>
 convertContainer(const InputContainer& input, const Func& itemConversion) {
     OutputContainer output;
+    ContainerCapacity<OutputContainer>::reserve(output, input.size());
     auto ins = std::inserter(output, output.begin());
     for (const auto& item : input) {
         *ins = VALUE_OR_RETURN(itemConversion(item));
@@ -119,6 +136,7 @@ template<typename OutputContainer, typename InputContainer, typename Func, typen
 ConversionResult<OutputContainer>
 convertContainer(const InputContainer& input, const Func& itemConversion, const Parameter& param) {
     OutputContainer output;
+    ContainerCapacity<OutputContainer>::reserve(output, input.size());
     auto ins = std::inserter(output, output.begin());
     for (const auto& item : input) {
         *ins = VALUE_OR_RETURN(itemConversion(item, param));
@@ -138,6 +156,7 @@ convertContainers(const InputContainer1& input1, const InputContainer2& input2,
         const Func& itemConversion) {
     auto iter2 = input2.begin();
     OutputContainer output;
+    ContainerCapacity<OutputContainer>::reserve(output, input1.size());
     auto ins = std::inserter(output, output.begin());
     for (const auto& item1 : input1) {
         RETURN_IF_ERROR(iter2 != input2.end() ? OK : BAD_VALUE);
@@ -157,6 +176,8 @@ ConversionResult<std::pair<OutputContainer1, OutputContainer2>>
 convertContainerSplit(const InputContainer& input, const Func& itemConversion) {
     OutputContainer1 output1;
     OutputContainer2 output2;
+    ContainerCapacity<OutputContainer1>::reserve(output1, input.size());
+    ContainerCapacity<OutputContainer2>::reserve(output2, input.size());
     auto ins1 = std::inserter(output1, output1.begin());
     auto ins2 = std::inserter(output2, output2.begin());
     for (const auto& item : input) {
@@ -623,6 +623,21 @@ public:
      */
             ssize_t     read(void* buffer, size_t size, bool blocking = true);
 
+    /* Bulk-capture variant of read() returning the whole batch and its
+     * matching ExtendedTimestamp in one call.  Instead of waking on every
+     * server period as the blocking read() does, readBatch() drains what
+     * has accumulated, then sleeps the capture time of the frames still
+     * missing and claims them in one span - one wakeup per batch rather
+     * than one per period.  On success, timestamp (may be NULL) is filled
+     * such that mPosition[LOCATION_CLIENT] is the frame index one past
+     * the last returned frame, so the span maps exactly onto the server
+     * and kernel timeline.  Only valid in TRANSFER_SYNC mode; size the
+     * record buffer (frameCount) to cover at least one batch.  Returns
+     * the number of bytes read >= 0, or a negative status code as read().
+     */
+            ssize_t     readBatch(void* buffer, size_t size,
+                                  ExtendedTimestamp* timestamp = nullptr);
+
     /* Return the number of input frames lost in the audio driver since the last call of this
      * function.  Audio driver is expected to reset the value to 0 and restart counting upon
      * returning the current value by this function call.  Such loss typically occurs when the
@@ -28,6 +28,7 @@
 #include <utils/threads.h>
 #include <android/content/AttributionSourceState.h>
 
+#include <atomic>
 #include <chrono>
 #include <string>
 
@@ -1111,6 +1112,15 @@ public:
             status_t getTimestamp(ExtendedTimestamp *timestamp);
 private:
             status_t getTimestamp_l(ExtendedTimestamp *timestamp);
+
+    /* Lock-free fast path for getTimestamp(ExtendedTimestamp *): reads the
+     * server timestamp published through the shared-memory control block
+     * without taking mLock or performing IPC.  Returns true and fills
+     * timestamp/status on success; returns false if the caller must take the
+     * locked path (fast path disabled, control block invalidated, or nothing
+     * published yet).
+     */
+            bool getTimestampLockFree(ExtendedTimestamp *timestamp, status_t *status);
 public:
 
     /* Add an AudioDeviceCallback. The caller will be notified when the audio device to which this
@@ -1450,13 +1460,15 @@ public:
 
     uint32_t                mUnderrunCountOffset;   // updated when restoring tracks
 
-    int64_t                 mFramesWritten;         // total frames written. reset to zero after
+    std::atomic<int64_t>    mFramesWritten;         // total frames written. reset to zero after
                                                     // the start() following stop(). It is not
                                                     // changed after restoring the track or
-                                                    // after flush.
-    int64_t                 mFramesWrittenServerOffset; // An offset to server frames due to
+                                                    // after flush.  Atomic so the lock-free
+                                                    // timestamp poller can read it untorn.
+    std::atomic<int64_t>    mFramesWrittenServerOffset; // An offset to server frames due to
                                                     // restoring AudioTrack, or stop/start.
                                                     // This offset is also used for static tracks.
+                                                    // Atomic for the lock-free timestamp poller.
     int64_t                 mFramesWrittenAtRestore; // Frames written at restore point (or frames
                                                     // delivered for static tracks).
                                                     // -1 indicates no previous restore point.
@@ -1500,6 +1512,21 @@ public:
     sp<StaticAudioTrackClientProxy> mStaticProxy;   // for type safety only
     sp<AudioTrackClientProxy>       mProxy;         // primary owner of the memory
 
+    // State for the lock-free timestamp fast path, see getTimestampLockFree().
+    // One caller at a time wins mTimestampPollerLock, polls the shared-memory
+    // timestamp queue through mProxy and republishes the adjusted result under
+    // the mTimestampPublishSeq seqlock; concurrent callers read the published
+    // copy.  createTrack_l() disables the fast path and holds the poller flag
+    // while the control block and proxy are swapped, so the poller never
+    // dereferences a stale mapping.  getTimestamp_l() also takes the poller
+    // flag around its proxy poll, as the proxy timestamp cache is not
+    // reentrant.
+    std::atomic<bool>       mTimestampFastPathEnabled{false};
+    std::atomic_flag        mTimestampPollerLock = ATOMIC_FLAG_INIT;
+    std::atomic<uint32_t>   mTimestampPublishSeq{0};    // seqlock: odd while publishing
+    ExtendedTimestamp       mPublishedTimestamp;        // guarded by mTimestampPublishSeq
+    status_t                mPublishedTimestampStatus = WOULD_BLOCK; // guarded likewise
+
     bool                    mInUnderrun;            // whether track is currently in underrun state
     uint32_t                mPausedPosition;
 
@@ -183,6 +183,15 @@ public:
     virtual status_t createTrack(const media::CreateTrackRequest& input,
                                  media::CreateTrackResponse& output) = 0;
 
+    /* Batched variant of createTrack(): creates all tracks in one binder
+     * transaction.  outputs and statuses are resized to match inputs; entry i
+     * of statuses reflects the result of creating track i, so one failed
+     * track does not fail the whole batch.
+     */
+    virtual status_t createTracks(const std::vector<media::CreateTrackRequest>& inputs,
+                                  std::vector<media::CreateTrackResponse>* outputs,
+                                  std::vector<status_t>* statuses) = 0;
+
     /* create an audio record and registers it with AudioFlinger.
      * The audioRecord field will be null if the track cannot be created and the status will reflect
      * failure.
@@ -386,6 +395,9 @@ public:
 
     status_t createTrack(const media::CreateTrackRequest& input,
                          media::CreateTrackResponse& output) override;
+    status_t createTracks(const std::vector<media::CreateTrackRequest>& inputs,
+                          std::vector<media::CreateTrackResponse>* outputs,
+                          std::vector<status_t>* statuses) override;
     status_t createRecord(const media::CreateRecordRequest& input,
                           media::CreateRecordResponse& output) override;
     uint32_t sampleRate(audio_io_handle_t ioHandle) const override;
@@ -506,6 +518,7 @@ public:
         // expose the TransactionCode enum for TimeCheck purposes.
         enum class TransactionCode {
             CREATE_TRACK = media::BnAudioFlingerService::TRANSACTION_createTrack,
+            CREATE_TRACKS = media::BnAudioFlingerService::TRANSACTION_createTracks,
             CREATE_RECORD = media::BnAudioFlingerService::TRANSACTION_createRecord,
             SAMPLE_RATE = media::BnAudioFlingerService::TRANSACTION_sampleRate,
             FORMAT = media::BnAudioFlingerService::TRANSACTION_format,
@@ -614,6 +627,9 @@ public:
 
     Status createTrack(const media::CreateTrackRequest& request,
                        media::CreateTrackResponse* _aidl_return) override;
+    Status createTracks(const std::vector<media::CreateTrackRequest>& requests,
+                        std::vector<int32_t>* statuses,
+                        std::vector<media::CreateTrackResponse>* _aidl_return) override;
     Status createRecord(const media::CreateRecordRequest& request,
                         media::CreateRecordResponse* _aidl_return) override;
     Status sampleRate(int32_t ioHandle, int32_t* _aidl_return) override;
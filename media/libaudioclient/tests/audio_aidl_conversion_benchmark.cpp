@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <media/AidlConversion.h>
+
+// Benchmarks for the conversions that audio policy performs in batches on
+// every routing change: port configs, patches and profiles. Each benchmark
+// round-trips a vector of state.range(0) elements through the bulk APIs.
+
+using namespace android;
+
+namespace {
+
+audio_port_config makeMixPortConfig(int id) {
+    audio_port_config config{};
+    config.id = id;
+    config.role = AUDIO_PORT_ROLE_SOURCE;
+    config.type = AUDIO_PORT_TYPE_MIX;
+    config.config_mask = AUDIO_PORT_CONFIG_SAMPLE_RATE | AUDIO_PORT_CONFIG_CHANNEL_MASK |
+            AUDIO_PORT_CONFIG_FORMAT;
+    config.sample_rate = 48000;
+    config.channel_mask = AUDIO_CHANNEL_OUT_STEREO;
+    config.format = AUDIO_FORMAT_PCM_16_BIT;
+    config.ext.mix.handle = id;
+    config.ext.mix.usecase.stream = AUDIO_STREAM_MUSIC;
+    return config;
+}
+
+audio_port_config makeDevicePortConfig(int id) {
+    audio_port_config config{};
+    config.id = id;
+    config.role = AUDIO_PORT_ROLE_SINK;
+    config.type = AUDIO_PORT_TYPE_DEVICE;
+    config.config_mask = AUDIO_PORT_CONFIG_SAMPLE_RATE | AUDIO_PORT_CONFIG_CHANNEL_MASK |
+            AUDIO_PORT_CONFIG_FORMAT;
+    config.sample_rate = 48000;
+    config.channel_mask = AUDIO_CHANNEL_OUT_STEREO;
+    config.format = AUDIO_FORMAT_PCM_16_BIT;
+    config.ext.device.type = AUDIO_DEVICE_OUT_SPEAKER;
+    return config;
+}
+
+std::vector<audio_port_config> makePortConfigs(size_t count) {
+    std::vector<audio_port_config> configs;
+    configs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        configs.push_back(i % 2 == 0 ? makeMixPortConfig(i + 1) : makeDevicePortConfig(i + 1));
+    }
+    return configs;
+}
+
+std::vector<struct audio_patch> makePatches(size_t count) {
+    std::vector<struct audio_patch> patches;
+    patches.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        struct audio_patch patch{};
+        patch.id = i + 1;
+        patch.num_sources = 1;
+        patch.sources[0] = makeMixPortConfig(i + 1);
+        patch.num_sinks = 1;
+        patch.sinks[0] = makeDevicePortConfig(i + 1);
+        patches.push_back(patch);
+    }
+    return patches;
+}
+
+std::vector<audio_profile> makeProfiles(size_t count) {
+    std::vector<audio_profile> profiles;
+    profiles.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        audio_profile profile{};
+        profile.format = AUDIO_FORMAT_PCM_16_BIT;
+        profile.sample_rates[0] = 44100;
+        profile.sample_rates[1] = 48000;
+        profile.num_sample_rates = 2;
+        profile.channel_masks[0] = AUDIO_CHANNEL_OUT_MONO;
+        profile.channel_masks[1] = AUDIO_CHANNEL_OUT_STEREO;
+        profile.num_channel_masks = 2;
+        profiles.push_back(profile);
+    }
+    return profiles;
+}
+
+void BM_AudioPortConfigRoundTrip(benchmark::State& state) {
+    const std::vector<audio_port_config> legacy = makePortConfigs(state.range(0));
+    for (auto _ : state) {
+        auto aidl = legacy2aidl_audio_port_configs_AudioPortConfigs(legacy);
+        auto roundTrip = aidl2legacy_AudioPortConfigs_audio_port_configs(aidl.value());
+        benchmark::DoNotOptimize(roundTrip);
+    }
+}
+
+void BM_AudioPatchRoundTrip(benchmark::State& state) {
+    const std::vector<struct audio_patch> legacy = makePatches(state.range(0));
+    for (auto _ : state) {
+        auto aidl = legacy2aidl_audio_patches_AudioPatches(legacy);
+        auto roundTrip = aidl2legacy_AudioPatches_audio_patches(aidl.value());
+        benchmark::DoNotOptimize(roundTrip);
+    }
+}
+
+void BM_AudioProfileRoundTrip(benchmark::State& state) {
+    const std::vector<audio_profile> legacy = makeProfiles(state.range(0));
+    for (auto _ : state) {
+        auto aidl = legacy2aidl_audio_profiles_AudioProfiles(legacy, false /*isInput*/);
+        auto roundTrip = aidl2legacy_AudioProfiles_audio_profiles(aidl.value(),
+                false /*isInput*/);
+        benchmark::DoNotOptimize(roundTrip);
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_AudioPortConfigRoundTrip)->Arg(2)->Arg(16)->Arg(64);
+BENCHMARK(BM_AudioPatchRoundTrip)->Arg(2)->Arg(16)->Arg(64);
+BENCHMARK(BM_AudioProfileRoundTrip)->Arg(2)->Arg(16)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -77,7 +77,12 @@ status_t CoreConversionHelperHidl::keysFromHal(
 // static
 status_t CoreConversionHelperHidl::parametersFromHal(
         const String8& kvPairs, hidl_vec<ParameterValue> *hidlParams) {
-    AudioParameter params(kvPairs);
+    return parametersFromHal(AudioParameter(kvPairs), hidlParams);
+}
+
+// static
+status_t CoreConversionHelperHidl::parametersFromHal(
+        const AudioParameter& params, hidl_vec<ParameterValue> *hidlParams) {
     if (params.size() == 0) return BAD_VALUE;
     hidlParams->resize(params.size());
     for (size_t i = 0; i < params.size(); ++i) {
@@ -32,10 +32,14 @@ using ::android::hardware::hidl_vec;
 
 namespace android {
 
+class AudioParameter;
+
 class CoreConversionHelperHidl : public ConversionHelperHidl<CoreResult> {
   protected:
     static status_t keysFromHal(const String8& keys, hidl_vec<hidl_string> *hidlKeys);
     static status_t parametersFromHal(const String8& kvPairs, hidl_vec<ParameterValue> *hidlParams);
+    static status_t parametersFromHal(
+            const AudioParameter& params, hidl_vec<ParameterValue> *hidlParams);
     static void parametersToHal(const hidl_vec<ParameterValue>& parameters, String8 *values);
     static void argsFromHal(const Vector<String16>& args, hidl_vec<hidl_string> *hidlArgs);
 
@@ -168,12 +168,16 @@ status_t DeviceHalHidl::getMasterMute(bool *state) {
 }
 
 status_t DeviceHalHidl::setParameters(const String8& kvPairs) {
+    return setParameters(AudioParameter(kvPairs));
+}
+
+status_t DeviceHalHidl::setParameters(const AudioParameter& params) {
     TIME_CHECK();
     if (mDevice == 0) return NO_INIT;
     hidl_vec<ParameterValue> hidlParams;
-    status_t status = parametersFromHal(kvPairs, &hidlParams);
+    status_t status = parametersFromHal(params, &hidlParams);
     if (status != OK) return status;
-    // TODO: change the API so that context and kvPairs are separated
+    // TODO: change the API so that context and parameters are separated
     return processReturn("setParameters",
                          utils::setParameters(mDevice, {} /* context */, hidlParams));
 }
@@ -56,6 +56,9 @@ class DeviceHalHidl : public DeviceHalInterface, public CoreConversionHelperHidl
     // Set global audio parameters.
     virtual status_t setParameters(const String8& kvPairs);
 
+    // Typed variant, converted straight to the HIDL parameter list.
+    virtual status_t setParameters(const AudioParameter& params);
+
     // Get global audio parameters.
     virtual status_t getParameters(const String8& keys, String8 *values);
 
@@ -111,10 +111,14 @@ status_t StreamHalHidl::getAudioProperties(audio_config_base_t *configBase) {
 }
 
 status_t StreamHalHidl::setParameters(const String8& kvPairs) {
+    return setParameters(AudioParameter(kvPairs));
+}
+
+status_t StreamHalHidl::setParameters(const AudioParameter& params) {
     TIME_CHECK();
     if (!mStream) return NO_INIT;
     hidl_vec<ParameterValue> hidlParams;
-    status_t status = parametersFromHal(kvPairs, &hidlParams);
+    status_t status = parametersFromHal(params, &hidlParams);
     if (status != OK) return status;
     return processReturn("setParameters",
                          utils::setParameters(mStream, {} /* context */, hidlParams));
@@ -306,14 +310,14 @@ status_t StreamHalHidl::legacyCreateAudioPatch(const struct audio_port_config& p
     if (source.has_value()) {
         param.addInt(String8(AudioParameter::keyInputSource), (int)source.value());
     }
-    return setParameters(param.toString());
+    return setParameters(param);
 }
 
 status_t StreamHalHidl::legacyReleaseAudioPatch() {
     TIME_CHECK();
     AudioParameter param;
     param.addInt(String8(AudioParameter::keyRouting), 0);
-    return setParameters(param.toString());
+    return setParameters(param);
 }
 
 namespace {
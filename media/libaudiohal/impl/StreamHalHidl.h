@@ -60,6 +60,9 @@ class StreamHalHidl : public virtual StreamHalInterface, public CoreConversionHe
     // Set audio stream parameters.
     virtual status_t setParameters(const String8& kvPairs);
 
+    // Typed variant, converted straight to the HIDL parameter list.
+    virtual status_t setParameters(const AudioParameter& params);
+
     // Get audio stream parameters.
     virtual status_t getParameters(const String8& keys, String8 *values);
 
@@ -21,6 +21,7 @@
 #include <android/media/audio/common/AudioMMapPolicyType.h>
 #include <error/Result.h>
 #include <media/audiohal/EffectHalInterface.h>
+#include <media/AudioParameter.h>
 #include <media/MicrophoneInfo.h>
 #include <system/audio.h>
 #include <utils/Errors.h>
@@ -62,6 +63,13 @@ class DeviceHalInterface : public RefBase
     // Set global audio parameters.
     virtual status_t setParameters(const String8& kvPairs) = 0;
 
+    // Set global audio parameters from an already parsed bundle. HAL wrappers
+    // that can forward the typed form override this to skip building and
+    // re-parsing the key/value string on hot paths such as routing updates.
+    virtual status_t setParameters(const AudioParameter& params) {
+        return setParameters(params.toString());
+    }
+
     // Get global audio parameters.
     virtual status_t getParameters(const String8& keys, String8 *values) = 0;
 
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include <media/audiohal/EffectHalInterface.h>
+#include <media/AudioParameter.h>
 #include <media/MicrophoneInfo.h>
 #include <system/audio.h>
 #include <utils/Errors.h>
@@ -57,6 +58,13 @@ class StreamHalInterface : public virtual RefBase
     // Set audio stream parameters.
     virtual status_t setParameters(const String8& kvPairs) = 0;
 
+    // Set audio stream parameters from an already parsed bundle. HAL wrappers
+    // that can forward the typed form override this to skip building and
+    // re-parsing the key/value string on hot paths such as routing updates.
+    virtual status_t setParameters(const AudioParameter& params) {
+        return setParameters(params.toString());
+    }
+
     // Get audio stream parameters.
     virtual status_t getParameters(const String8& keys, String8 *values) = 0;
 
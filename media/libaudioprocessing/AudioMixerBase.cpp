@@ -1094,6 +1094,24 @@ void AudioMixerBase::process__genericNoResampling()
             t->mIn = t->buffer.raw;
         }
 
+        // Tracks in the float stereo steady state (no resampling, no aux send,
+        // settled volumes, full block available) are accumulated by a single
+        // fused pass over the block instead of one pass per track.  This is
+        // the common case for multi-track game mixes.
+        std::vector<const float *> fusedIn;
+        std::vector<const float *> fusedVol;
+        fusedIn.reserve(group.size());
+        fusedVol.reserve(group.size());
+        const auto canFuse = [](const std::shared_ptr<TrackBase> &t, size_t frameCount) {
+            return t->mMixerInFormat == AUDIO_FORMAT_PCM_FLOAT
+                    && t->mMixerChannelCount == FCC_2
+                    && t->channelCount == FCC_2
+                    && !t->needsRamp()
+                    && (t->needs & (NEEDS_MUTE | NEEDS_RESAMPLE | NEEDS_AUX)) == 0
+                    && t->mIn != nullptr
+                    && t->frameCount >= frameCount;
+        };
+
         int32_t *out = (int *)pair.first;
         size_t numFrames = 0;
         do {
@@ -1101,6 +1119,9 @@ void AudioMixerBase::process__genericNoResampling()
             memset(outTemp, 0, sizeof(outTemp));
             for (const int name : group) {
                 const std::shared_ptr<TrackBase> &t = mTracks[name];
+                if (canFuse(t, frameCount)) {
+                    continue; // handled by the fused multi-track pass below.
+                }
                 int32_t *aux = NULL;
                 if (CC_UNLIKELY(t->needs & NEEDS_AUX)) {
                     aux = t->auxBuffer + numFrames;
@@ -1136,6 +1157,24 @@ void AudioMixerBase::process__genericNoResampling()
                 }
             }
 
+            fusedIn.clear();
+            fusedVol.clear();
+            for (const int name : group) {
+                const std::shared_ptr<TrackBase> &t = mTracks[name];
+                if (!canFuse(t, frameCount)) {
+                    continue;
+                }
+                fusedIn.push_back(reinterpret_cast<const float *>(t->mIn));
+                fusedVol.push_back(t->mVolume);
+                t->mIn = reinterpret_cast<const float *>(t->mIn) + frameCount * FCC_2;
+                t->frameCount -= frameCount;
+            }
+            if (!fusedIn.empty()) {
+                volumeMultiTrack<FCC_2, float /*TO*/, float /*TI*/, float /*TV*/>(
+                        reinterpret_cast<float *>(outTemp), frameCount,
+                        fusedIn.data(), fusedVol.data(), fusedIn.size());
+            }
+
             const std::shared_ptr<TrackBase> &t1 = mTracks[group[0]];
             convertMixerFormat(out, t1->mMixerFormat, outTemp, t1->mMixerInFormat,
                     frameCount * t1->mMixerChannelCount);
@@ -17,6 +17,8 @@
 #ifndef ANDROID_AUDIO_MIXER_OPS_H
 #define ANDROID_AUDIO_MIXER_OPS_H
 
+#include <type_traits>
+
 #include <audio_utils/channels.h>
 #include <audio_utils/primitives.h>
 #include <system/audio.h>
@@ -480,6 +482,60 @@ inline void volumeRampMulti(TO* out, size_t frameCount,
             *aux++ += MixMul<TA, TA, TAV>(auxaccum, *vola);
             vola[0] += volainc;
         } while (--frameCount);
+    } else if constexpr (std::is_floating_point_v<TV>) {
+        // Compute the ramp as vol + n * volinc instead of accumulating the
+        // increment serially across frames. Without the loop carried
+        // dependency the compiler can evaluate the ramp vector wide and
+        // vectorize the volume multiplies in the same pass. The fused form
+        // is at least as accurate as summing the increments.
+        for (size_t n = 0; n < frameCount; ++n) {
+            const TV scale = (TV)n;
+            if constexpr (MIXTYPE == MIXTYPE_MULTI) {
+                static_assert(NCHAN <= 2);
+                for (int i = 0; i < NCHAN; ++i) {
+                    *out++ += MixMul<TO, TI, TV>(*in++, vol[i] + scale * volinc[i]);
+                }
+            } else if constexpr (MIXTYPE == MIXTYPE_MULTI_SAVEONLY) {
+                static_assert(NCHAN <= 2);
+                for (int i = 0; i < NCHAN; ++i) {
+                    *out++ = MixMul<TO, TI, TV>(*in++, vol[i] + scale * volinc[i]);
+                }
+            } else if constexpr (MIXTYPE == MIXTYPE_MULTI_MONOVOL) {
+                const TV v = vol[0] + scale * volinc[0];
+                for (int i = 0; i < NCHAN; ++i) {
+                    *out++ += MixMul<TO, TI, TV>(*in++, v);
+                }
+            } else if constexpr (MIXTYPE == MIXTYPE_MULTI_SAVEONLY_MONOVOL) {
+                const TV v = vol[0] + scale * volinc[0];
+                for (int i = 0; i < NCHAN; ++i) {
+                    *out++ = MixMul<TO, TI, TV>(*in++, v);
+                }
+            } else if constexpr (MIXTYPE == MIXTYPE_MULTI_STEREOVOL
+                    || MIXTYPE == MIXTYPE_MULTI_SAVEONLY_STEREOVOL
+                    || MIXTYPE == MIXTYPE_MONOEXPAND
+                    || MIXTYPE == MIXTYPE_STEREOEXPAND) {
+                const TV v[2] = { vol[0] + scale * volinc[0], vol[1] + scale * volinc[1] };
+                stereoVolumeHelper<MIXTYPE, NCHAN>(out, in, v, [] (auto &a, const auto &b) {
+                    return MixMul<TO, TI, TV>(a, b);
+                });
+                if constexpr (MIXTYPE == MIXTYPE_MONOEXPAND) in += 1;
+                if constexpr (MIXTYPE == MIXTYPE_STEREOEXPAND) in += 2;
+            } else /* constexpr */ {
+                static_assert(dependent_false<MIXTYPE>, "invalid mixtype");
+            }
+        }
+        // Advance the caller visible volumes past the ramp.
+        if constexpr (MIXTYPE == MIXTYPE_MULTI || MIXTYPE == MIXTYPE_MULTI_SAVEONLY) {
+            for (int i = 0; i < NCHAN; ++i) {
+                vol[i] += volinc[i] * (TV)frameCount;
+            }
+        } else if constexpr (MIXTYPE == MIXTYPE_MULTI_MONOVOL
+                || MIXTYPE == MIXTYPE_MULTI_SAVEONLY_MONOVOL) {
+            vol[0] += volinc[0] * (TV)frameCount;
+        } else {
+            vol[0] += volinc[0] * (TV)frameCount;
+            vol[1] += volinc[1] * (TV)frameCount;
+        }
     } else {
         do {
             if constexpr (MIXTYPE == MIXTYPE_MULTI) {
@@ -604,6 +660,69 @@ inline void volumeMulti(TO* out, size_t frameCount,
     }
 }
 
+/*
+ * The volumeMultiTrack functions accumulate a batch of same-format tracks
+ * into the output buffer in a single fused pass.
+ *
+ * All tracks must share the same interleaved channel count NCHAN, require
+ * no resampling or aux send, and have settled (non-ramping) per-channel
+ * volumes.  Keeping the output sample in a register across every track load
+ * turns N passes over the output block into one, which matters once the
+ * block no longer fits in L1 with many active tracks.
+ *
+ * The inner loops are expressed so that the compiler auto-vectorizes them
+ * (NEON on arm/arm64, SSE on x86); explicit intrinsics are not needed here.
+ *
+ * TO: int32_t (Q4.27) or float
+ * TI: int32_t (Q4.27) or int16_t (Q0.15) or float
+ * TV: int32_t (U4.28) or int16_t (U4.12) or float
+ */
+
+template <int NCHAN, int NTRACK, typename TO, typename TI, typename TV>
+inline void volumeMultiTrackBatch(TO* out, size_t frameCount,
+        const TI* const* in, const TV* const* vol)
+{
+    static_assert(NCHAN > 0 && NCHAN <= FCC_LIMIT);
+    static_assert(NTRACK > 0);
+    const size_t sampleCount = frameCount * NCHAN;
+    for (size_t s = 0; s < sampleCount; ++s) {
+        TO sum = out[s];
+        #pragma unroll
+        for (int t = 0; t < NTRACK; ++t) {
+            sum += MixMul<TO, TI, TV>(in[t][s], vol[t][s % NCHAN]);
+        }
+        out[s] = sum;
+    }
+}
+
+template <int NCHAN, typename TO, typename TI, typename TV>
+inline void volumeMultiTrack(TO* out, size_t frameCount,
+        const TI* const* in, const TV* const* vol, size_t trackCount)
+{
+#ifdef ALOGVV
+    ALOGVV("volumeMultiTrack, trackCount:%zu\n", trackCount);
+#endif
+    while (trackCount >= 4) {
+        volumeMultiTrackBatch<NCHAN, 4, TO, TI, TV>(out, frameCount, in, vol);
+        in += 4;
+        vol += 4;
+        trackCount -= 4;
+    }
+    switch (trackCount) {
+    case 3:
+        volumeMultiTrackBatch<NCHAN, 3, TO, TI, TV>(out, frameCount, in, vol);
+        break;
+    case 2:
+        volumeMultiTrackBatch<NCHAN, 2, TO, TI, TV>(out, frameCount, in, vol);
+        break;
+    case 1:
+        volumeMultiTrackBatch<NCHAN, 1, TO, TI, TV>(out, frameCount, in, vol);
+        break;
+    default:
+        break;
+    }
+}
+
 };
 
 #endif /* ANDROID_AUDIO_MIXER_OPS_H */
@@ -23,6 +23,10 @@
 #include <dlfcn.h>
 #include <math.h>
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include <cutils/compiler.h>
 #include <cutils/properties.h>
 #include <utils/Log.h>
@@ -181,8 +185,7 @@ template<typename TC, typename TI, typename TO>
 AudioResamplerDyn<TC, TI, TO>::AudioResamplerDyn(
         int inChannelCount, int32_t sampleRate, src_quality quality)
     : AudioResampler(inChannelCount, sampleRate, quality),
-      mResampleFunc(0), mFilterSampleRate(0), mFilterQuality(DEFAULT_QUALITY),
-    mCoefBuffer(NULL)
+      mResampleFunc(0), mFilterSampleRate(0), mFilterQuality(DEFAULT_QUALITY)
 {
     mVolumeSimd[0] = mVolumeSimd[1] = 0;
     // The AudioResampler base class assumes we are always ready for 1:1 resampling.
@@ -207,7 +210,6 @@ AudioResamplerDyn<TC, TI, TO>::AudioResamplerDyn(
 template<typename TC, typename TI, typename TO>
 AudioResamplerDyn<TC, TI, TO>::~AudioResamplerDyn()
 {
-    free(mCoefBuffer);
 }
 
 template<typename TC, typename TI, typename TO>
@@ -256,31 +258,57 @@ void AudioResamplerDyn<TC, TI, TO>::createKaiserFir(Constants &c,
 }
 
 template<typename TC, typename TI, typename TO>
-void AudioResamplerDyn<TC, TI, TO>::createKaiserFir(Constants &c,
-        double stopBandAtten, double fcr) {
-    // compute the normalized transition bandwidth
-    const double tbw = firKaiserTbw(c.mHalfNumCoefs, stopBandAtten);
-    const int phases = c.mL;
-    const int halfLength = c.mHalfNumCoefs;
+std::shared_ptr<const TC> AudioResamplerDyn<TC, TI, TO>::getCachedFir(
+        int phases, int halfLength, double stopBandAtten, double fcr, double attenuation)
+{
+    // The table is fully determined by these parameters (attenuation derives
+    // from stopBandAtten), so identical rate pairs and qualities share one
+    // immutable filter bank. The number of distinct designs in a process is
+    // small - quality levels times rate pairs - so the cache is unbounded.
+    using Key = std::tuple<int, int, double, double>;
+    static std::mutex cacheLock;
+    static std::map<Key, std::shared_ptr<const TC>> cache;
+
+    const Key key(phases, halfLength, stopBandAtten, fcr);
+    {
+        std::lock_guard<std::mutex> _l(cacheLock);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+    }
 
-    // create buffer
+    // design the filter without holding the cache lock.
     TC *coefs = nullptr;
     int ret = posix_memalign(
             reinterpret_cast<void **>(&coefs),
             CACHE_LINE_SIZE /* alignment */,
             (phases + 1) * halfLength * sizeof(TC));
     LOG_ALWAYS_FATAL_IF(ret != 0, "Cannot allocate buffer memory, ret %d", ret);
-    c.mFirCoefs = coefs;
-    free(mCoefBuffer);
-    mCoefBuffer = coefs;
+    firKaiserGen(coefs, phases, halfLength, stopBandAtten, fcr, attenuation);
+    std::shared_ptr<const TC> table(coefs, [](const TC *p) { free(const_cast<TC *>(p)); });
+
+    std::lock_guard<std::mutex> _l(cacheLock);
+    // if another thread designed the same filter concurrently, keep the winner.
+    return cache.emplace(key, table).first->second;
+}
+
+template<typename TC, typename TI, typename TO>
+void AudioResamplerDyn<TC, TI, TO>::createKaiserFir(Constants &c,
+        double stopBandAtten, double fcr) {
+    // compute the normalized transition bandwidth
+    const double tbw = firKaiserTbw(c.mHalfNumCoefs, stopBandAtten);
+    const int phases = c.mL;
+    const int halfLength = c.mHalfNumCoefs;
 
     // square the computed minimum passband value (extra safety).
     double attenuation =
             computeWindowedSincMinimumPassbandValue(stopBandAtten);
     attenuation *= attenuation;
 
-    // design filter
-    firKaiserGen(coefs, phases, halfLength, stopBandAtten, fcr, attenuation);
+    // fetch (or design on first use) the shared filter bank for this design
+    mCoefBuffer = getCachedFir(phases, halfLength, stopBandAtten, fcr, attenuation);
+    c.mFirCoefs = mCoefBuffer.get();
 
     // update the design criteria
     mNormalizedCutoffFrequency = fcr;
@@ -19,6 +19,8 @@
 
 #include <stdint.h>
 #include <sys/types.h>
+#include <memory>
+
 #include <android/log.h>
 
 #include <media/AudioResampler.h>
@@ -152,6 +154,13 @@ private:
 
     void createKaiserFir(Constants &c, double stopBandAtten, double fcr);
 
+    // Returns the polyphase filter bank for the given design from a process-wide
+    // cache of immutable tables, generating it on first use. Identical designs
+    // (same rate pair and quality) share one table, so burst track creation pays
+    // for coefficient generation only once per distinct design.
+    static std::shared_ptr<const TC> getCachedFir(int phases, int halfLength,
+            double stopBandAtten, double fcr, double attenuation);
+
     template<int CHANNELS, bool LOCKED, int STRIDE>
     size_t resample(TO* out, size_t outFrameCount, AudioBufferProvider* provider);
 
@@ -166,7 +175,7 @@ private:
      resample_ABP_t mResampleFunc;     // called function for resampling
             int32_t mFilterSampleRate; // designed filter sample rate.
         src_quality mFilterQuality;    // designed filter quality.
-              void* mCoefBuffer;       // if a filter is created, this is not null
+    std::shared_ptr<const TC> mCoefBuffer; // shared ownership of the current filter bank
 
     // Property selected design parameters.
               // This will enable fixed high quality resampling.
@@ -159,6 +159,110 @@ struct InterpNull {
     }
 };
 
+#if USE_NEON || USE_SSE
+
+/*
+ * Multichannel (CHANNELS > 2) FIR dot product for float data.
+ *
+ * The mono and stereo cases are covered by hand specializations in
+ * AudioResamplerFirProcessNeon.h / AudioResamplerFirProcessSSE.h which
+ * vectorize along the filter taps.  For higher channel counts the samples of
+ * one tap are already contiguous in the interleaved input, so we vectorize
+ * across the channels instead: one accumulator register per group of four
+ * channels, with the leftover channels (CHANNELS & 3) kept in scalar
+ * accumulators.  This handles any channel count up to FCC_LIMIT without a
+ * per-count specialization.
+ *
+ * Multichannel processing applies a single volume to all channels, matching
+ * the Accumulator path in ProcessBase().
+ */
+template <int CHANNELS, typename TFUNC, typename TINTERP>
+static inline
+void ProcessBaseMulti(float* const out,
+        size_t count,
+        const float* coefsP,
+        const float* coefsN,
+        const float* sP,
+        const float* sN,
+        TINTERP lerpP,
+        const float* const volumeLR)
+{
+    static_assert(CHANNELS > 2, "CHANNELS must be > 2");
+    constexpr int VECS = CHANNELS >> 2;  // channel groups of 4
+    constexpr int TAIL = CHANNELS & 3;   // leftover channels
+
+#if USE_NEON
+    float32x4_t accum[VECS > 0 ? VECS : 1];
+    for (int j = 0; j < VECS; ++j) {
+        accum[j] = vdupq_n_f32(0);
+    }
+#else // USE_SSE
+    __m128 accum[VECS > 0 ? VECS : 1];
+    for (int j = 0; j < VECS; ++j) {
+        accum[j] = _mm_setzero_ps();
+    }
+#endif
+    float tail[TAIL > 0 ? TAIL : 1] = {};
+
+    for (size_t i = 0; i < count; ++i) {
+        const float cP = TFUNC::interpolatep(coefsP[0], coefsP[count], lerpP);
+        const float cN = TFUNC::interpolaten(coefsN[count], coefsN[0], lerpP);
+#if USE_NEON
+        const float32x4_t cPv = vdupq_n_f32(cP);
+        const float32x4_t cNv = vdupq_n_f32(cN);
+        for (int j = 0; j < VECS; ++j) {
+            accum[j] = vmlaq_f32(accum[j], cPv, vld1q_f32(sP + (j << 2)));
+            accum[j] = vmlaq_f32(accum[j], cNv, vld1q_f32(sN + (j << 2)));
+        }
+#else // USE_SSE
+        const __m128 cPv = _mm_set1_ps(cP);
+        const __m128 cNv = _mm_set1_ps(cN);
+        for (int j = 0; j < VECS; ++j) {
+#if USE_AVX2
+            accum[j] = _mm_fmadd_ps(cPv, _mm_loadu_ps(sP + (j << 2)), accum[j]);
+            accum[j] = _mm_fmadd_ps(cNv, _mm_loadu_ps(sN + (j << 2)), accum[j]);
+#else
+            accum[j] = _mm_add_ps(accum[j], _mm_mul_ps(cPv, _mm_loadu_ps(sP + (j << 2))));
+            accum[j] = _mm_add_ps(accum[j], _mm_mul_ps(cNv, _mm_loadu_ps(sN + (j << 2))));
+#endif
+        }
+#endif
+        for (int j = 0; j < TAIL; ++j) {
+            tail[j] += cP * sP[(VECS << 2) + j] + cN * sN[(VECS << 2) + j];
+        }
+        coefsP++;
+        coefsN++;
+        sP -= CHANNELS;
+        sN += CHANNELS;
+    }
+
+    // multiply by volume and accumulate into the output frame
+#if USE_NEON
+    const float32x4_t vol = vdupq_n_f32(volumeLR[0]);
+    for (int j = 0; j < VECS; ++j) {
+        float32x4_t o = vld1q_f32(out + (j << 2));
+        o = vmlaq_f32(o, accum[j], vol);
+        vst1q_f32(out + (j << 2), o);
+    }
+#else // USE_SSE
+    const __m128 vol = _mm_set1_ps(volumeLR[0]);
+    for (int j = 0; j < VECS; ++j) {
+        __m128 o = _mm_loadu_ps(out + (j << 2));
+#if USE_AVX2
+        o = _mm_fmadd_ps(accum[j], vol, o);
+#else
+        o = _mm_add_ps(o, _mm_mul_ps(accum[j], vol));
+#endif
+        _mm_storeu_ps(out + (j << 2), o);
+    }
+#endif
+    for (int j = 0; j < TAIL; ++j) {
+        out[(VECS << 2) + j] += tail[j] * volumeLR[0];
+    }
+}
+
+#endif // USE_NEON || USE_SSE
+
 /*
  * Calculates a single output frame (two samples).
  *
@@ -189,6 +293,19 @@ void ProcessBase(TO* const out,
     static_assert(CHANNELS > 0, "CHANNELS must be > 0");
 
     if (CHANNELS > 2) {
+#if USE_NEON || USE_SSE
+        // Vectorize across the interleaved channels for the float path.
+        // 3 channels have at most one SIMD group's worth of work and stay on
+        // the Accumulator path below.
+        if constexpr (CHANNELS >= 4
+                && is_same<TC, float>::value
+                && is_same<TI, float>::value
+                && is_same<TO, float>::value) {
+            ProcessBaseMulti<CHANNELS, TFUNC>(out, count, coefsP, coefsN, sP, sN, lerpP,
+                    volumeLR);
+            return;
+        }
+#endif
         // TO accum[CHANNELS];
         Accumulator<CHANNELS, TO> accum;
 
@@ -37,6 +37,61 @@ static inline T max(const T& a, const T& b)
 
 namespace android {
 
+// Fused channel remix + format conversion.
+//
+// memcpy_by_index_array() followed by memcpy_by_audio_format() walks the
+// capture buffer twice; for multichannel mic arrays at high sample rates the
+// extra pass is measurable. The kernel below gathers the destination channels
+// and converts the sample format in a single pass. It is written as a simple
+// per-frame loop so the compiler can vectorize it.
+
+template <typename TO, typename TI>
+static inline TO convertSample(TI in);
+
+template <>
+inline float convertSample<float, int16_t>(int16_t in)
+{
+    return float_from_i16(in);
+}
+
+template <>
+inline int16_t convertSample<int16_t, float>(float in)
+{
+    return clamp16_from_float(in);
+}
+
+template <typename TO, typename TI>
+static void remixAndConvert(TO *dst, size_t dstChannels,
+        const TI *src, size_t srcChannels, const int8_t *idxAry, size_t frames)
+{
+    for (size_t i = 0; i < frames; ++i) {
+        for (size_t c = 0; c < dstChannels; ++c) {
+            const int8_t idx = idxAry[c];
+            dst[c] = idx < 0 ? TO(0) : convertSample<TO, TI>(src[idx]);
+        }
+        dst += dstChannels;
+        src += srcChannels;
+    }
+}
+
+// Returns false for format pairs without a fused kernel; the caller then
+// falls back to the two-pass remix + convert path.
+static bool remixAndConvertByIndex(void *dst, audio_format_t dstFormat, size_t dstChannels,
+        const void *src, audio_format_t srcFormat, size_t srcChannels,
+        const int8_t *idxAry, size_t frames)
+{
+    if (srcFormat == AUDIO_FORMAT_PCM_FLOAT && dstFormat == AUDIO_FORMAT_PCM_16_BIT) {
+        remixAndConvert((int16_t *)dst, dstChannels,
+                (const float *)src, srcChannels, idxAry, frames);
+    } else if (srcFormat == AUDIO_FORMAT_PCM_16_BIT && dstFormat == AUDIO_FORMAT_PCM_FLOAT) {
+        remixAndConvert((float *)dst, dstChannels,
+                (const int16_t *)src, srcChannels, idxAry, frames);
+    } else {
+        return false;
+    }
+    return true;
+}
+
 RecordBufferConverter::RecordBufferConverter(
         audio_channel_mask_t srcChannelMask, audio_format_t srcFormat,
         uint32_t srcSampleRate,
@@ -248,6 +303,12 @@ void RecordBufferConverter::convertNoResampler(
     }
     // do we need to do channel mask conversion?
     if (mSrcChannelMask != mDstChannelMask) {
+        // remix and convert the format in one pass when a fused kernel exists.
+        if (mSrcFormat != mDstFormat
+                && remixAndConvertByIndex(dst, mDstFormat, mDstChannelCount,
+                        src, mSrcFormat, mSrcChannelCount, mIdxAry, frames)) {
+            return;
+        }
         void *dstBuf = mBuf != NULL ? mBuf : dst;
         memcpy_by_index_array(dstBuf, mDstChannelCount,
                 src, mSrcChannelCount, mIdxAry, audio_bytes_per_sample(mSrcFormat), frames);
@@ -280,6 +341,11 @@ void RecordBufferConverter::convertResampler(
             downmix_to_mono_float_from_stereo_float((float *)src,
                 (const float *)src, frames);
         }
+        // remix and convert the format in one pass when a fused kernel exists.
+        if (remixAndConvertByIndex(dst, mDstFormat, mDstChannelCount,
+                src, AUDIO_FORMAT_PCM_FLOAT, mSrcChannelCount, mIdxAry, frames)) {
+            return;
+        }
         // convert to destination format (in place, OK as float is larger than other types)
         if (mDstFormat != AUDIO_FORMAT_PCM_FLOAT) {
             memcpy_by_audio_format(src, mDstFormat, src, AUDIO_FORMAT_PCM_FLOAT,
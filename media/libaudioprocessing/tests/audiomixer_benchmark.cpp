@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <media/AudioBufferProvider.h>
+#include <media/AudioMixer.h>
+
+/*
+ * AudioMixer benchmark with production-shaped track mixes.
+ *
+ * Unlike mixerops_benchmark, which measures the innermost volume/mix
+ * primitives in isolation, this benchmark drives the full AudioMixer
+ * with many simultaneous tracks of mixed formats and sample rates,
+ * active volume ramps, and aux (effect send) buffers - the shape of a
+ * busy game mix - at both FastMixer-sized and normal-mixer-sized
+ * buffers.  SetItemsProcessed() counts output frames, so the reported
+ * items/s is mixed frames per second; divide the CPU frequency by it
+ * for cycles/frame.
+ */
+
+using namespace android;
+
+namespace {
+
+// An AudioBufferProvider that loops over one second of a precomputed
+// sine wave, so tracks never run dry however long the benchmark runs.
+class LoopingProvider : public AudioBufferProvider {
+public:
+    void init(uint32_t channels, audio_format_t format, uint32_t sampleRate) {
+        mFrameSize = channels * audio_bytes_per_sample(format);
+        mFrames = sampleRate;
+        mData.resize(mFrames * mFrameSize);
+        constexpr double kFrequency = 440.;
+        if (format == AUDIO_FORMAT_PCM_FLOAT) {
+            float *p = reinterpret_cast<float *>(mData.data());
+            for (size_t i = 0; i < mFrames; ++i) {
+                const float v = sin(2. * M_PI * kFrequency * i / sampleRate);
+                for (uint32_t c = 0; c < channels; ++c) {
+                    *p++ = v;
+                }
+            }
+        } else { // AUDIO_FORMAT_PCM_16_BIT
+            int16_t *p = reinterpret_cast<int16_t *>(mData.data());
+            for (size_t i = 0; i < mFrames; ++i) {
+                const int16_t v = sin(2. * M_PI * kFrequency * i / sampleRate) * 32767.;
+                for (uint32_t c = 0; c < channels; ++c) {
+                    *p++ = v;
+                }
+            }
+        }
+    }
+
+    status_t getNextBuffer(Buffer* buffer) override {
+        const size_t avail = mFrames - mPos;
+        if (buffer->frameCount > avail) {
+            buffer->frameCount = avail;
+        }
+        buffer->raw = mData.data() + mPos * mFrameSize;
+        return NO_ERROR;
+    }
+
+    void releaseBuffer(Buffer* buffer) override {
+        mPos += buffer->frameCount;
+        if (mPos >= mFrames) {
+            mPos = 0;
+        }
+        buffer->frameCount = 0;
+        buffer->raw = nullptr;
+    }
+
+private:
+    std::vector<uint8_t> mData;
+    size_t mFrameSize = 0;
+    size_t mFrames = 0;
+    size_t mPos = 0;
+};
+
+// Track shapes are assigned round robin, modeling a game mix: float
+// stereo music at the device rate, 16 bit stereo and mono sound effects
+// authored at 44.1 kHz (hence resampled), and a float mono voice track.
+struct TrackShape {
+    uint32_t channels;
+    audio_format_t format;
+    uint32_t sampleRate;
+};
+
+constexpr uint32_t kOutputSampleRate = 48000;
+
+constexpr TrackShape kTrackShapes[] = {
+    { 2, AUDIO_FORMAT_PCM_FLOAT,  kOutputSampleRate },
+    { 2, AUDIO_FORMAT_PCM_16_BIT, 44100 },
+    { 1, AUDIO_FORMAT_PCM_16_BIT, 44100 },
+    { 1, AUDIO_FORMAT_PCM_FLOAT,  kOutputSampleRate },
+};
+
+// Mix trackCount tracks into a float stereo output of frameCount frames
+// per process() call.  Every fourth track carries an aux (effect send)
+// buffer, and the track volumes are re-ramped each mix so the per-frame
+// volume ramp path stays engaged, as it does while the app is animating
+// volumes.
+void BM_AudioMixer(benchmark::State& state) {
+    const size_t trackCount = state.range(0);
+    const size_t frameCount = state.range(1);
+    constexpr uint32_t kOutputChannels = 2;
+    const audio_channel_mask_t outputChannelMask =
+            audio_channel_out_mask_from_count(kOutputChannels);
+
+    AudioMixer mixer(frameCount, kOutputSampleRate);
+    std::vector<LoopingProvider> providers(trackCount);
+    std::vector<float> mainBuffer(frameCount * kOutputChannels);
+    std::vector<float> auxBuffer(frameCount);
+
+    static float zero;
+    float gain = AudioMixer::UNITY_GAIN_FLOAT / trackCount;
+    for (size_t i = 0; i < trackCount; ++i) {
+        const TrackShape& shape = kTrackShapes[i % std::size(kTrackShapes)];
+        providers[i].init(shape.channels, shape.format, shape.sampleRate);
+        const audio_channel_mask_t channelMask =
+                audio_channel_out_mask_from_count(shape.channels);
+        const int name = i;
+        const status_t status = mixer.create(
+                name, channelMask, shape.format, AUDIO_SESSION_OUTPUT_MIX);
+        LOG_ALWAYS_FATAL_IF(status != OK);
+        mixer.setBufferProvider(name, &providers[i]);
+        mixer.setParameter(name, AudioMixer::TRACK, AudioMixer::MAIN_BUFFER,
+                mainBuffer.data());
+        mixer.setParameter(name, AudioMixer::TRACK, AudioMixer::MIXER_FORMAT,
+                (void *)(uintptr_t)AUDIO_FORMAT_PCM_FLOAT);
+        mixer.setParameter(name, AudioMixer::TRACK, AudioMixer::FORMAT,
+                (void *)(uintptr_t)shape.format);
+        mixer.setParameter(name, AudioMixer::TRACK, AudioMixer::MIXER_CHANNEL_MASK,
+                (void *)(uintptr_t)outputChannelMask);
+        mixer.setParameter(name, AudioMixer::TRACK, AudioMixer::CHANNEL_MASK,
+                (void *)(uintptr_t)channelMask);
+        mixer.setParameter(name, AudioMixer::RESAMPLE, AudioMixer::SAMPLE_RATE,
+                (void *)(uintptr_t)shape.sampleRate);
+        mixer.setParameter(name, AudioMixer::VOLUME, AudioMixer::VOLUME0, &zero);
+        mixer.setParameter(name, AudioMixer::VOLUME, AudioMixer::VOLUME1, &zero);
+        if (i % 4 == 0) {
+            mixer.setParameter(name, AudioMixer::TRACK, AudioMixer::AUX_BUFFER,
+                    auxBuffer.data());
+            mixer.setParameter(name, AudioMixer::VOLUME, AudioMixer::AUXLEVEL, &gain);
+        }
+        mixer.enable(name);
+    }
+
+    float targets[2] = { gain, gain * 0.25f };
+    size_t sel = 0;
+    for (auto _ : state) {
+        float v = targets[sel ^= 1];
+        for (size_t i = 0; i < trackCount; ++i) {
+            mixer.setParameter(i, AudioMixer::RAMP_VOLUME, AudioMixer::VOLUME0, &v);
+            mixer.setParameter(i, AudioMixer::RAMP_VOLUME, AudioMixer::VOLUME1, &v);
+        }
+        mixer.process();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frameCount);
+}
+
+// First argument is the track count, second the frames per process().
+// 192 frames is a typical FastMixer HAL buffer at 48 kHz; 960 frames is
+// the normal mixer's 20 ms period.  24 tracks of mixed shapes at
+// FastMixer-sized buffers is the worst-case game audio profile.
+BENCHMARK(BM_AudioMixer)
+        ->Args({1, 192})
+        ->Args({4, 192})
+        ->Args({12, 192})
+        ->Args({24, 192})
+        ->Args({4, 960})
+        ->Args({12, 960})
+        ->Args({24, 960});
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -49,6 +49,35 @@ static void BM_VolumeRampMulti(benchmark::State& state) {
     }
 }
 
+// The common mixer case has no aux buffer, which takes the vectorizable
+// computed-ramp path for floating point volumes; compare with the
+// serial ramp exercised by BM_VolumeRampMulti above.
+template <int MIXTYPE, int NCHAN>
+static void BM_VolumeRampMultiNoAux(benchmark::State& state) {
+    constexpr size_t FRAME_COUNT = 1000;
+    constexpr size_t SAMPLE_COUNT = FRAME_COUNT * NCHAN;
+
+    // data inialized to 0.
+    float out[SAMPLE_COUNT]{};
+    float in[SAMPLE_COUNT]{};
+
+    // volume initialized to 0
+    float vola = 0.f;
+    float vol[2] = {0.f, 0.f};
+
+    // some volume increment
+    float volainc = 0.01f;
+    float volinc[2] = {0.01f, 0.01f};
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(out);
+        benchmark::DoNotOptimize(in);
+        volumeRampMulti<MIXTYPE, NCHAN>(
+                out, FRAME_COUNT, in, (float *)nullptr /* aux */, vol, volinc, &vola, volainc);
+        benchmark::ClobberMemory();
+    }
+}
+
 template <int MIXTYPE, int NCHAN>
 static void BM_VolumeMulti(benchmark::State& state) {
     constexpr size_t FRAME_COUNT = 1000;
@@ -96,6 +125,16 @@ BENCHMARK_TEMPLATE(BM_VolumeRampMulti, MIXTYPE_MULTI_SAVEONLY_MONOVOL, 8);
 BENCHMARK_TEMPLATE(BM_VolumeRampMulti, MIXTYPE_MULTI_STEREOVOL, 8);
 BENCHMARK_TEMPLATE(BM_VolumeRampMulti, MIXTYPE_MULTI_SAVEONLY_STEREOVOL, 8);
 
+BENCHMARK_TEMPLATE(BM_VolumeRampMultiNoAux, MIXTYPE_MULTI_MONOVOL, 2);
+BENCHMARK_TEMPLATE(BM_VolumeRampMultiNoAux, MIXTYPE_MULTI_SAVEONLY_MONOVOL, 2);
+BENCHMARK_TEMPLATE(BM_VolumeRampMultiNoAux, MIXTYPE_MULTI_STEREOVOL, 2);
+BENCHMARK_TEMPLATE(BM_VolumeRampMultiNoAux, MIXTYPE_MULTI_SAVEONLY_STEREOVOL, 2);
+
+BENCHMARK_TEMPLATE(BM_VolumeRampMultiNoAux, MIXTYPE_MULTI_MONOVOL, 8);
+BENCHMARK_TEMPLATE(BM_VolumeRampMultiNoAux, MIXTYPE_MULTI_SAVEONLY_MONOVOL, 8);
+BENCHMARK_TEMPLATE(BM_VolumeRampMultiNoAux, MIXTYPE_MULTI_STEREOVOL, 8);
+BENCHMARK_TEMPLATE(BM_VolumeRampMultiNoAux, MIXTYPE_MULTI_SAVEONLY_STEREOVOL, 8);
+
 BENCHMARK_TEMPLATE(BM_VolumeMulti, MIXTYPE_MULTI_MONOVOL, 8);
 BENCHMARK_TEMPLATE(BM_VolumeMulti, MIXTYPE_MULTI_SAVEONLY_MONOVOL, 8);
 BENCHMARK_TEMPLATE(BM_VolumeMulti, MIXTYPE_MULTI_STEREOVOL, 8);
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <media/RecordBufferConverter.h>
+
+// Benchmarks the capture-side conversion chain (channel remix, format
+// conversion, resampling), in particular the fused remix + format kernels
+// used for multichannel mic array capture.
+
+using namespace android;
+
+namespace {
+
+constexpr size_t kFrameCount = 1024;
+
+// Loops endlessly over a prefilled buffer.
+class LoopBufferProvider : public AudioBufferProvider {
+  public:
+    LoopBufferProvider(void *data, size_t frames, size_t frameSize)
+        : mData(data), mFrames(frames), mFrameSize(frameSize) {}
+
+    status_t getNextBuffer(Buffer *buffer) override {
+        if (mPos == mFrames) {
+            mPos = 0;
+        }
+        buffer->frameCount = std::min(buffer->frameCount, mFrames - mPos);
+        buffer->raw = (int8_t *)mData + mPos * mFrameSize;
+        mPos += buffer->frameCount;
+        return OK;
+    }
+
+    void releaseBuffer(Buffer *buffer) override {
+        buffer->frameCount = 0;
+        buffer->raw = nullptr;
+    }
+
+    void rewind() { mPos = 0; }
+
+  private:
+    void * const mData;
+    const size_t mFrames;
+    const size_t mFrameSize;
+    size_t mPos = 0;
+};
+
+void BM_RecordBufferConvert(benchmark::State& state,
+        audio_channel_mask_t srcMask, audio_format_t srcFormat, uint32_t srcRate,
+        audio_channel_mask_t dstMask, audio_format_t dstFormat, uint32_t dstRate) {
+    const size_t srcChannels = audio_channel_count_from_in_mask(srcMask);
+    const size_t dstChannels = audio_channel_count_from_in_mask(dstMask);
+    const size_t srcFrameSize = srcChannels * audio_bytes_per_sample(srcFormat);
+
+    std::vector<int8_t> src(kFrameCount * srcFrameSize);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = i & 0x7f;
+    }
+    std::vector<int8_t> dst(kFrameCount * dstChannels * audio_bytes_per_sample(dstFormat));
+
+    LoopBufferProvider provider(src.data(), kFrameCount, srcFrameSize);
+    RecordBufferConverter converter(srcMask, srcFormat, srcRate, dstMask, dstFormat, dstRate);
+
+    for (auto _ : state) {
+        provider.rewind();
+        converter.convert(dst.data(), &provider, kFrameCount);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kFrameCount);
+}
+
+}  // namespace
+
+// 4-mic array capture remixed to stereo, with and without format conversion.
+BENCHMARK_CAPTURE(BM_RecordBufferConvert, quad_float_to_stereo_i16,
+        AUDIO_CHANNEL_INDEX_MASK_4, AUDIO_FORMAT_PCM_FLOAT, 96000,
+        AUDIO_CHANNEL_INDEX_MASK_2, AUDIO_FORMAT_PCM_16_BIT, 96000);
+BENCHMARK_CAPTURE(BM_RecordBufferConvert, quad_i16_to_stereo_float,
+        AUDIO_CHANNEL_INDEX_MASK_4, AUDIO_FORMAT_PCM_16_BIT, 96000,
+        AUDIO_CHANNEL_INDEX_MASK_2, AUDIO_FORMAT_PCM_FLOAT, 96000);
+BENCHMARK_CAPTURE(BM_RecordBufferConvert, quad_i16_to_stereo_i16,
+        AUDIO_CHANNEL_INDEX_MASK_4, AUDIO_FORMAT_PCM_16_BIT, 96000,
+        AUDIO_CHANNEL_INDEX_MASK_2, AUDIO_FORMAT_PCM_16_BIT, 96000);
+
+// 8-channel capture remixed to quad.
+BENCHMARK_CAPTURE(BM_RecordBufferConvert, oct_float_to_quad_i16,
+        AUDIO_CHANNEL_INDEX_MASK_8, AUDIO_FORMAT_PCM_FLOAT, 96000,
+        AUDIO_CHANNEL_INDEX_MASK_4, AUDIO_FORMAT_PCM_16_BIT, 96000);
+
+// Resampled capture; the remix + format stage runs after the resampler.
+BENCHMARK_CAPTURE(BM_RecordBufferConvert, quad_float_96k_to_stereo_i16_48k,
+        AUDIO_CHANNEL_INDEX_MASK_4, AUDIO_FORMAT_PCM_FLOAT, 96000,
+        AUDIO_CHANNEL_INDEX_MASK_2, AUDIO_FORMAT_PCM_16_BIT, 48000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "resampler_benchmark"
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <media/AudioBufferProvider.h>
+#include <media/AudioResampler.h>
+
+#include "test_utils.h"
+
+using namespace android;
+
+/*
+ * Benchmarks the resampler at a fixed quality over the supported channel
+ * counts.  The multichannel (CHANNELS > 2) float path is the primary subject:
+ * spatializer and surround content run through it with 6 to 24 channels.
+ */
+template <int CHANNELS>
+static void BM_Resample(benchmark::State& state) {
+    constexpr size_t OUTPUT_FRAMES = 1000;
+    constexpr uint32_t INPUT_FREQ = 44100;
+    constexpr uint32_t OUTPUT_FREQ = 48000;
+    const AudioResampler::src_quality quality =
+            (AudioResampler::src_quality)state.range(0);
+
+    SignalProvider provider;
+    provider.setChirp<float>(CHANNELS, 0., INPUT_FREQ / 2., INPUT_FREQ, 1. /* time (s) */);
+
+    std::unique_ptr<AudioResampler> resampler(
+            AudioResampler::create(AUDIO_FORMAT_PCM_FLOAT, CHANNELS, OUTPUT_FREQ, quality));
+    resampler->setSampleRate(INPUT_FREQ);
+    resampler->setVolume(AudioResampler::UNITY_GAIN_FLOAT, AudioResampler::UNITY_GAIN_FLOAT);
+
+    // the resampler accumulates into the output buffer.
+    std::vector<float> out(OUTPUT_FRAMES * (CHANNELS == 1 ? 2 : CHANNELS));
+
+    while (state.KeepRunning()) {
+        provider.reset();
+        benchmark::DoNotOptimize(out.data());
+        resampler->resample(reinterpret_cast<int32_t*>(out.data()), OUTPUT_FRAMES, &provider);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * OUTPUT_FRAMES * CHANNELS);
+}
+
+// The DYN_* resamplers are the ones used for tracks; cover the classic
+// configurations plus the multichannel counts that exercise the vectorized
+// CHANNELS > 2 path (5.1, 7.1, 7.1.4 and FCC_LIMIT).
+BENCHMARK_TEMPLATE(BM_Resample, 1)->Arg(AudioResampler::DYN_HIGH_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 2)->Arg(AudioResampler::DYN_HIGH_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 3)->Arg(AudioResampler::DYN_HIGH_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 4)->Arg(AudioResampler::DYN_HIGH_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 6)->Arg(AudioResampler::DYN_HIGH_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 8)->Arg(AudioResampler::DYN_HIGH_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 12)->Arg(AudioResampler::DYN_HIGH_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 24)->Arg(AudioResampler::DYN_HIGH_QUALITY);
+
+BENCHMARK_TEMPLATE(BM_Resample, 2)->Arg(AudioResampler::DYN_LOW_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 6)->Arg(AudioResampler::DYN_LOW_QUALITY);
+BENCHMARK_TEMPLATE(BM_Resample, 12)->Arg(AudioResampler::DYN_LOW_QUALITY);
+
+BENCHMARK_MAIN();
@@ -90,10 +90,14 @@ sp<DataSource> DataSourceFactory::CreateFromURI(
             *contentType = mediaHTTP->getMIMEType();
         }
 
+        // Only let the cache be retained for reuse by a later source when
+        // the request carries no caller-specific headers; a response that
+        // depended on them must not be replayed for another caller.
         source = NuCachedSource2::Create(
                 mediaHTTP,
                 cacheConfig.isEmpty() ? NULL : cacheConfig.string(),
-                disconnectAtHighwatermark);
+                disconnectAtHighwatermark,
+                nonCacheSpecificHeaders.isEmpty() /* allowRetainedCache */);
     } else if (!strncasecmp("data:", uri, 5)) {
         source = DataURISource::Create(uri);
     } else {
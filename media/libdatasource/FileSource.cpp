@@ -25,6 +25,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 
 namespace android {
@@ -33,7 +34,9 @@ FileSource::FileSource(const char *filename)
     : mFd(-1),
       mOffset(0),
       mLength(-1),
-      mName("<null>") {
+      mName("<null>"),
+      mMap(NULL),
+      mMapLength(0) {
 
     if (filename) {
         mName = String8::format("FileSource(%s)", filename);
@@ -43,6 +46,7 @@ FileSource::FileSource(const char *filename)
 
     if (mFd >= 0) {
         mLength = lseek64(mFd, 0, SEEK_END);
+        tryMap();
     } else {
         ALOGE("Failed to open file '%s'. (%s)", filename, strerror(errno));
     }
@@ -52,7 +56,9 @@ FileSource::FileSource(int fd, int64_t offset, int64_t length)
     : mFd(fd),
       mOffset(offset),
       mLength(length),
-      mName("<null>") {
+      mName("<null>"),
+      mMap(NULL),
+      mMapLength(0) {
     ALOGV("fd=%d (%s), offset=%lld, length=%lld",
             fd, nameForFd(fd).c_str(), (long long) offset, (long long) length);
 
@@ -87,15 +93,43 @@ FileSource::FileSource(int fd, int64_t offset, int64_t length)
             (long long) mOffset,
             (long long) mLength);
 
+    tryMap();
 }
 
 FileSource::~FileSource() {
+    if (mMap != NULL) {
+        munmap(mMap, mMapLength);
+        mMap = NULL;
+        mMapLength = 0;
+    }
     if (mFd >= 0) {
         ::close(mFd);
         mFd = -1;
     }
 }
 
+// Try to map the file region once; on any failure (e.g. address space
+// exhaustion on 32-bit processes for long-form content, or a special file
+// that does not support mmap) we silently keep the pread() path.
+void FileSource::tryMap() {
+    if (mFd < 0 || mLength <= 0) {
+        return;
+    }
+    const off64_t pageMask = (off64_t)sysconf(_SC_PAGE_SIZE) - 1;
+    const off64_t mapStart = mOffset & ~pageMask;
+    const uint64_t mapLength = (uint64_t)(mOffset - mapStart) + (uint64_t)mLength;
+    if (mapLength > SIZE_MAX) {
+        return;
+    }
+    void *map = mmap(NULL, mapLength, PROT_READ, MAP_SHARED, mFd, mapStart);
+    if (map == MAP_FAILED) {
+        ALOGV("mmap failed, falling back to pread (%s)", strerror(errno));
+        return;
+    }
+    mMap = map;
+    mMapLength = mapLength;
+}
+
 status_t FileSource::initCheck() const {
     return mFd >= 0 ? OK : NO_INIT;
 }
@@ -122,6 +156,14 @@ ssize_t FileSource::readAt(off64_t offset, void *data, size_t size) {
 }
 
 ssize_t FileSource::readAt_l(off64_t offset, void *data, size_t size) {
+    if (mMap != NULL) {
+        // Serve from the mapping: no syscall per read, and warm pages are a
+        // plain copy out of the page cache.
+        const off64_t pageMask = (off64_t)sysconf(_SC_PAGE_SIZE) - 1;
+        memcpy(data, (const uint8_t *)mMap + (mOffset & pageMask) + offset, size);
+        return size;
+    }
+
     off64_t result = lseek64(mFd, offset + mOffset, SEEK_SET);
     if (result == -1) {
         ALOGE("seek to %lld failed", (long long)(offset + mOffset));
@@ -179,10 +179,29 @@ void PageCache::copy(size_t from, void *data, size_t size) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Caches retained from recently destroyed instances, keyed by URI, so that
+// reopening the same URL (prefetch-then-play, replay) adopts the pages the
+// previous instance already downloaded instead of fetching them again. The
+// content length recorded at retain time must still match on adoption; it is
+// the closest thing to a validator the native layer can see, since response
+// headers stay on the far side of the MediaHTTPConnection boundary.
+struct RetainedCache {
+    String8 mUri;
+    off64_t mSourceSize;
+    off64_t mCacheOffset;
+    PageCache *mCache;
+};
+
+static Mutex sRetainedCachesLock;
+static List<RetainedCache> sRetainedCaches;
+// Each entry is already bounded by the instance's highwater mark.
+static const size_t kMaxRetainedCaches = 2;
+
 NuCachedSource2::NuCachedSource2(
         const sp<DataSource> &source,
         const char *cacheConfig,
-        bool disconnectAtHighwatermark)
+        bool disconnectAtHighwatermark,
+        bool allowRetainedCache)
     : mSource(source),
       mReflector(new AHandlerReflector<NuCachedSource2>(this)),
       mLooper(new ALooper),
@@ -191,13 +210,15 @@ NuCachedSource2::NuCachedSource2(
       mFinalStatus(OK),
       mLastAccessPos(0),
       mFetching(true),
+      mFetchGeneration(0),
       mDisconnecting(false),
       mLastFetchTimeUs(-1),
       mNumRetriesLeft(kMaxNumRetries),
       mHighwaterThresholdBytes(kDefaultHighWaterThreshold),
       mLowwaterThresholdBytes(kDefaultLowWaterThreshold),
       mKeepAliveIntervalUs(kDefaultKeepAliveIntervalUs),
-      mDisconnectAtHighwatermark(disconnectAtHighwatermark) {
+      mDisconnectAtHighwatermark(disconnectAtHighwatermark),
+      mAllowRetainedCache(allowRetainedCache) {
     // We are NOT going to support disconnect-at-highwatermark indefinitely
     // and we are not guaranteeing support for client-specified cache
     // parameters. Both of these are temporary measures to solve a specific
@@ -226,25 +247,111 @@ NuCachedSource2::NuCachedSource2(
     mLooper->start(false /* runOnCallingThread */, true /* canCallJava */);
 
     mName = String8::format("NuCachedSource2(%s)", mSource->toString().string());
+
+    if (mAllowRetainedCache) {
+        adoptRetainedCache();
+    }
 }
 
 NuCachedSource2::~NuCachedSource2() {
     mLooper->stop();
     mLooper->unregisterHandler(mReflector->id());
 
+    if (mAllowRetainedCache) {
+        retainCache();
+    }
+
     delete mCache;
     mCache = NULL;
 }
 
+void NuCachedSource2::adoptRetainedCache() {
+    if (!(mSource->flags() & kIsHTTPBasedSource)) {
+        return;
+    }
+
+    String8 uri = mSource->getUri();
+    off64_t sourceSize;
+    if (uri.isEmpty()
+            || mSource->getSize(&sourceSize) != OK || sourceSize <= 0) {
+        // unsized streams (live) don't describe reopenable content
+        return;
+    }
+
+    Mutex::Autolock autoLock(sRetainedCachesLock);
+    for (List<RetainedCache>::iterator it = sRetainedCaches.begin();
+            it != sRetainedCaches.end(); ++it) {
+        if (it->mUri == uri) {
+            if (it->mSourceSize == sourceSize) {
+                delete mCache;
+                mCache = it->mCache;
+                mCacheOffset = it->mCacheOffset;
+
+                ALOGI("adopted %zu retained bytes at offset %lld for '%s'",
+                        mCache->totalSize(), (long long)mCacheOffset,
+                        uri.string());
+            } else {
+                // same URL, but not the same resource anymore
+                delete it->mCache;
+            }
+
+            sRetainedCaches.erase(it);
+            return;
+        }
+    }
+}
+
+void NuCachedSource2::retainCache() {
+    if (!(mSource->flags() & kIsHTTPBasedSource) || mCache->totalSize() == 0) {
+        return;
+    }
+
+    // MediaHTTP keeps the URI and the content length cached, so both remain
+    // available after the source has been disconnected.
+    String8 uri = mSource->getUri();
+    off64_t sourceSize;
+    if (uri.isEmpty()
+            || mSource->getSize(&sourceSize) != OK || sourceSize <= 0) {
+        return;
+    }
+
+    Mutex::Autolock autoLock(sRetainedCachesLock);
+    for (List<RetainedCache>::iterator it = sRetainedCaches.begin();
+            it != sRetainedCaches.end(); ++it) {
+        if (it->mUri == uri) {
+            delete it->mCache;
+            sRetainedCaches.erase(it);
+            break;
+        }
+    }
+
+    if (sRetainedCaches.size() >= kMaxRetainedCaches) {
+        delete sRetainedCaches.begin()->mCache;
+        sRetainedCaches.erase(sRetainedCaches.begin());
+    }
+
+    RetainedCache entry;
+    entry.mUri = uri;
+    entry.mSourceSize = sourceSize;
+    entry.mCacheOffset = mCacheOffset;
+    entry.mCache = mCache;
+    sRetainedCaches.push_back(entry);
+
+    ALOGV("retained %zu cached bytes for '%s'",
+            mCache->totalSize(), uri.string());
+    mCache = NULL;
+}
+
 // static
 sp<NuCachedSource2> NuCachedSource2::Create(
         const sp<DataSource> &source,
         const char *cacheConfig,
-        bool disconnectAtHighwatermark) {
+        bool disconnectAtHighwatermark,
+        bool allowRetainedCache) {
     sp<NuCachedSource2> instance = new NuCachedSource2(
-            source, cacheConfig, disconnectAtHighwatermark);
+            source, cacheConfig, disconnectAtHighwatermark, allowRetainedCache);
     Mutex::Autolock autoLock(instance->mLock);
-    (new AMessage(kWhatFetchMore, instance->mReflector))->post();
+    instance->scheduleFetch(0);
     return instance;
 }
 
@@ -307,6 +414,13 @@ void NuCachedSource2::onMessageReceived(const sp<AMessage> &msg) {
     switch (msg->what()) {
         case kWhatFetchMore:
         {
+            // Only honor the most recently scheduled fetch; an immediate
+            // wakeup makes any still-pending delayed poll stale.
+            int32_t generation;
+            CHECK(msg->findInt32("generation", &generation));
+            if (generation != mFetchGeneration.load()) {
+                break;
+            }
             onFetch();
             break;
         }
@@ -416,7 +530,18 @@ void NuCachedSource2::onFetch() {
             ALOGI("Keep alive");
         }
 
-        fetchInternal();
+        // Issue several page reads back to back before returning to the
+        // looper, so a prefetch burst pays one message round trip instead of
+        // one per page and the source sees long sequential reads.
+        size_t numFetches = 0;
+        do {
+            fetchInternal();
+            ++numFetches;
+        } while (!keepAlive
+                && mFetching
+                && mFinalStatus == OK
+                && numFetches < kMaxFetchesPerIteration
+                && mCache->totalSize() < mHighwaterThresholdBytes);
 
         mLastFetchTimeUs = ALooper::GetNowUs();
 
@@ -448,7 +573,13 @@ void NuCachedSource2::onFetch() {
         delayUs = 100000LL;
     }
 
-    (new AMessage(kWhatFetchMore, mReflector))->post(delayUs);
+    scheduleFetch(delayUs);
+}
+
+void NuCachedSource2::scheduleFetch(int64_t delayUs) {
+    sp<AMessage> msg = new AMessage(kWhatFetchMore, mReflector);
+    msg->setInt32("generation", ++mFetchGeneration);
+    msg->post(delayUs);
 }
 
 void NuCachedSource2::onRead(const sp<AMessage> &msg) {
@@ -513,6 +644,10 @@ void NuCachedSource2::restartPrefetcherIfNecessary_l(
 
     ALOGI("restarting prefetcher, totalSize = %zu", mCache->totalSize());
     mFetching = true;
+
+    // Kick the fetch loop right away rather than waiting out the idle poll
+    // interval; this is what stalls readers that cross the high-water mark.
+    scheduleFetch(0);
 }
 
 ssize_t NuCachedSource2::readAt(off64_t offset, void *data, size_t size) {
@@ -58,6 +58,13 @@ protected:
 private:
     String8 mName;
 
+    // mmap-backed read mode: when the file region can be mapped, readAt()
+    // is served from the page cache mapping instead of a pread() per call.
+    void *mMap;
+    size_t mMapLength;
+
+    void tryMap();
+
     FileSource(const FileSource &);
     FileSource &operator=(const FileSource &);
 };
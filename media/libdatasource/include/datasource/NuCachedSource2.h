@@ -20,6 +20,8 @@
 
 #include <media/DataSource.h>
 #include <media/stagefright/foundation/ABase.h>
+#include <atomic>
+
 #include <media/stagefright/foundation/AHandlerReflector.h>
 
 namespace android {
@@ -28,10 +30,16 @@ struct ALooper;
 struct PageCache;
 
 struct NuCachedSource2 : public DataSource {
+    // With "allowRetainedCache" set, the pages this instance has downloaded
+    // are kept in a small process-level registry, keyed by URI, when the
+    // instance is destroyed, and a later instance for the same URI starts
+    // out with them instead of re-downloading. Callers must only enable
+    // this for requests that carry no caller-specific headers.
     static sp<NuCachedSource2> Create(
             const sp<DataSource> &source,
             const char *cacheConfig = NULL,
-            bool disconnectAtHighwatermark = false);
+            bool disconnectAtHighwatermark = false,
+            bool allowRetainedCache = false);
 
     virtual status_t initCheck() const;
 
@@ -81,7 +89,8 @@ private:
     NuCachedSource2(
             const sp<DataSource> &source,
             const char *cacheConfig,
-            bool disconnectAtHighwatermark);
+            bool disconnectAtHighwatermark,
+            bool allowRetainedCache);
 
     enum {
         kPageSize                       = 65536,
@@ -102,6 +111,11 @@ private:
         kMaxNumRetries = 10,
     };
 
+    enum {
+        // Pages fetched back to back per looper iteration while prefetching.
+        kMaxFetchesPerIteration = 4,
+    };
+
     sp<DataSource> mSource;
     sp<AHandlerReflector<NuCachedSource2> > mReflector;
     sp<ALooper> mLooper;
@@ -117,6 +131,9 @@ private:
     off64_t mLastAccessPos;
     sp<AMessage> mAsyncResult;
     bool mFetching;
+    // Identifies the live kWhatFetchMore message; scheduleFetch() bumps it so
+    // an immediate wakeup supersedes an already scheduled delayed poll.
+    std::atomic<int32_t> mFetchGeneration;
     bool mDisconnecting;
     int64_t mLastFetchTimeUs;
 
@@ -129,9 +146,14 @@ private:
     int64_t mKeepAliveIntervalUs;
 
     bool mDisconnectAtHighwatermark;
+    bool mAllowRetainedCache;
+
+    void adoptRetainedCache();
+    void retainCache();
 
     void onMessageReceived(const sp<AMessage> &msg);
     void onFetch();
+    void scheduleFetch(int64_t delayUs);
     void onRead(const sp<AMessage> &msg);
 
     void fetchInternal();
@@ -34,6 +34,9 @@ typedef enum {
     DOWNMIX_STATE_ACTIVE,
 } downmix_state_t;
 
+// maximum number of input channels the fold matrix covers (up to 22.2 + wide fronts)
+static constexpr size_t kMaxFoldChannels = 26;
+
 /* parameters for each downmixer */
 struct downmix_object_t {
     downmix_state_t state;
@@ -41,6 +44,10 @@ struct downmix_object_t {
     bool apply_volume_correction;
     uint8_t input_channel_count;
     android::audio_utils::channels::ChannelMix channelMix;
+    // Precomputed {left, right} gain per input channel, built once at configure
+    // time from the input channel mask. Used by Downmix_foldByMatrix() for
+    // layouts that ChannelMix does not handle.
+    float fold_matrix[kMaxFoldChannels][2];
 };
 
 typedef struct downmix_module_s {
@@ -183,6 +190,79 @@ void Downmix_testIndexComputation(uint32_t mask) {
 }
 #endif
 
+// {left, right} fold gain for each channel bit of the input mask, in mask bit
+// order (see the audio_channel_mask bits in system/audio.h). Left-side channels
+// fold to left at -3 dB, right-side symmetrically; center and LFE channels are
+// split between both outputs.
+static const float kFoldGains[][2] = {
+    {1.f, 0.f},                                  // FRONT_LEFT
+    {0.f, 1.f},                                  // FRONT_RIGHT
+    {MINUS_3_DB_IN_FLOAT, MINUS_3_DB_IN_FLOAT},  // FRONT_CENTER
+    {0.5f, 0.5f},                                // LOW_FREQUENCY
+    {MINUS_3_DB_IN_FLOAT, 0.f},                  // BACK_LEFT
+    {0.f, MINUS_3_DB_IN_FLOAT},                  // BACK_RIGHT
+    {MINUS_3_DB_IN_FLOAT, 0.f},                  // FRONT_LEFT_OF_CENTER
+    {0.f, MINUS_3_DB_IN_FLOAT},                  // FRONT_RIGHT_OF_CENTER
+    {0.5f, 0.5f},                                // BACK_CENTER
+    {MINUS_3_DB_IN_FLOAT, 0.f},                  // SIDE_LEFT
+    {0.f, MINUS_3_DB_IN_FLOAT},                  // SIDE_RIGHT
+    {0.5f, 0.5f},                                // TOP_CENTER
+    {MINUS_3_DB_IN_FLOAT, 0.f},                  // TOP_FRONT_LEFT
+    {0.5f, 0.5f},                                // TOP_FRONT_CENTER
+    {0.f, MINUS_3_DB_IN_FLOAT},                  // TOP_FRONT_RIGHT
+    {MINUS_3_DB_IN_FLOAT, 0.f},                  // TOP_BACK_LEFT
+    {0.5f, 0.5f},                                // TOP_BACK_CENTER
+    {0.f, MINUS_3_DB_IN_FLOAT},                  // TOP_BACK_RIGHT
+    {MINUS_3_DB_IN_FLOAT, 0.f},                  // TOP_SIDE_LEFT
+    {0.f, MINUS_3_DB_IN_FLOAT},                  // TOP_SIDE_RIGHT
+    {MINUS_3_DB_IN_FLOAT, 0.f},                  // BOTTOM_FRONT_LEFT
+    {0.5f, 0.5f},                                // BOTTOM_FRONT_CENTER
+    {0.f, MINUS_3_DB_IN_FLOAT},                  // BOTTOM_FRONT_RIGHT
+    {0.5f, 0.5f},                                // LOW_FREQUENCY_2
+    {MINUS_3_DB_IN_FLOAT, 0.f},                  // FRONT_WIDE_LEFT
+    {0.f, MINUS_3_DB_IN_FLOAT},                  // FRONT_WIDE_RIGHT
+};
+
+// Builds the stereo fold matrix for an arbitrary input layout. Computed once
+// per configuration; Downmix_foldByMatrix() then covers every valid channel
+// mask through one code path.
+static void Downmix_computeFoldMatrix(uint32_t mask, float (*matrix)[2])
+{
+    size_t ch = 0;
+    constexpr size_t numFoldGains = sizeof(kFoldGains) / sizeof(kFoldGains[0]);
+    for (size_t bit = 0; bit < numFoldGains && ch < kMaxFoldChannels; bit++) {
+        if ((mask >> bit) & 1) {
+            matrix[ch][0] = kFoldGains[bit][0];
+            matrix[ch][1] = kFoldGains[bit][1];
+            ch++;
+        }
+    }
+}
+
+// Applies the precomputed fold matrix to the whole buffer. The inner loop is a
+// plain multiply-accumulate over contiguous samples, which the compiler turns
+// into NEON FMA on arm targets.
+static void Downmix_foldByMatrix(const float *src, float *dst, size_t numFrames,
+        bool accumulate, const float (*matrix)[2], size_t inputChannelCount)
+{
+    for (size_t i = 0; i < numFrames; i++) {
+        float left = 0.f;
+        float right = 0.f;
+        for (size_t ch = 0; ch < inputChannelCount; ch++) {
+            left += matrix[ch][0] * src[ch];
+            right += matrix[ch][1] * src[ch];
+        }
+        if (accumulate) {
+            left += dst[0];
+            right += dst[1];
+        }
+        dst[0] = clamp_float(left);
+        dst[1] = clamp_float(right);
+        src += inputChannelCount;
+        dst += 2;
+    }
+}
+
 static bool Downmix_validChannelMask(uint32_t mask)
 {
     if (!mask) {
@@ -371,9 +451,10 @@ static int32_t Downmix_Process(effect_handle_t self,
       case DOWNMIX_TYPE_FOLD: {
             if (!pDownmixer->channelMix.process(
                     pSrc, pDst, numFrames, accumulate, downmixInputChannelMask)) {
-                ALOGE("Multichannel configuration %#x is not supported",
-                      downmixInputChannelMask);
-                return -EINVAL;
+                // layouts ChannelMix does not handle fold through the
+                // precomputed matrix built at configure time.
+                Downmix_foldByMatrix(pSrc, pDst, numFrames, accumulate,
+                        pDownmixer->fold_matrix, pDownmixer->input_channel_count);
             }
         }
         break;
@@ -668,6 +749,7 @@ static int Downmix_Configure(downmix_module_t *pDwmModule, effect_config_t *pCon
         pDownmixer->input_channel_count =
                 audio_channel_count_from_out_mask(pConfig->inputCfg.channels);
     }
+    Downmix_computeFoldMatrix(pConfig->inputCfg.channels, pDownmixer->fold_matrix);
 
     Downmix_Reset(pDownmixer, init);
 
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <vector>
+
+#include <audio_effects/effect_dynamicsprocessing.h>
+#include <benchmark/benchmark.h>
+#include <log/log.h>
+#include <system/audio.h>
+
+extern audio_effect_library_t AUDIO_EFFECT_LIBRARY_INFO_SYM;
+
+// Benchmarks the full MBC/limiter chain of the dynamics processing effect,
+// including the FFT round trip per block, at standard and hi-res rates.
+
+static constexpr effect_uuid_t dynamicsprocessing_uuid = {
+    0xe0e6539b, 0x1781, 0x7261, 0x676f, {0x6d, 0x75, 0x73, 0x69, 0x63, 0x40}};
+
+static constexpr size_t kFrameCount = 1000;
+
+static constexpr int kSampleRates[] = {
+    44100,
+    48000,
+    96000,
+    192000,
+};
+
+static int setEngineArchitecture(effect_handle_t handle) {
+    // effect_param_t carrying { DP_PARAM_ENGINE_ARCHITECTURE } and the nine
+    // 32-bit architecture values (see EffectDynamicsProcessing.cpp).
+    struct {
+        effect_param_t param;
+        int32_t command;
+        int32_t variant;
+        float preferredFrameDurationMs;
+        int32_t preEqInUse;
+        int32_t preEqBandCount;
+        int32_t mbcInUse;
+        int32_t mbcBandCount;
+        int32_t postEqInUse;
+        int32_t postEqBandCount;
+        int32_t limiterInUse;
+    } p{};
+    p.param.psize = sizeof(int32_t);
+    p.param.vsize = 9 * sizeof(int32_t);
+    p.command = DP_PARAM_ENGINE_ARCHITECTURE;
+    p.variant = VARIANT_FAVOR_FREQUENCY_RESOLUTION;
+    p.preferredFrameDurationMs = 10.f;
+    p.preEqInUse = 1;
+    p.preEqBandCount = 2;
+    p.mbcInUse = 1;
+    p.mbcBandCount = 6;
+    p.postEqInUse = 1;
+    p.postEqBandCount = 2;
+    p.limiterInUse = 1;
+
+    int32_t reply = 0;
+    uint32_t replySize = sizeof(reply);
+    int status = (*handle)->command(handle, EFFECT_CMD_SET_PARAM, sizeof(p), &p,
+            &replySize, &reply);
+    return status != 0 ? status : reply;
+}
+
+static void BM_DynamicsProcessing(benchmark::State& state) {
+    const int sampleRate = kSampleRates[state.range(0)];
+    constexpr audio_channel_mask_t channelMask = AUDIO_CHANNEL_OUT_STEREO;
+    constexpr size_t channelCount = FCC_2;
+
+    // Initialize input buffer with deterministic pseudo-random values
+    std::minstd_rand gen(sampleRate);
+    std::uniform_real_distribution<> dis(-1.0f, 1.0f);
+    std::vector<float> input(kFrameCount * channelCount);
+    std::vector<float> output(kFrameCount * channelCount);
+    for (auto& in : input) {
+        in = dis(gen);
+    }
+
+    effect_handle_t effectHandle = nullptr;
+    if (int status = AUDIO_EFFECT_LIBRARY_INFO_SYM.create_effect(
+            &dynamicsprocessing_uuid, 1, 1, &effectHandle);
+        status != 0) {
+        ALOGE("create_effect returned an error = %d\n", status);
+        return;
+    }
+
+    effect_config_t config{};
+    config.inputCfg.accessMode = EFFECT_BUFFER_ACCESS_READ;
+    config.inputCfg.format = AUDIO_FORMAT_PCM_FLOAT;
+    config.inputCfg.samplingRate = sampleRate;
+    config.inputCfg.channels = channelMask;
+    config.inputCfg.mask = EFFECT_CONFIG_ALL;
+
+    config.outputCfg.accessMode = EFFECT_BUFFER_ACCESS_WRITE;
+    config.outputCfg.format = AUDIO_FORMAT_PCM_FLOAT;
+    config.outputCfg.samplingRate = sampleRate;
+    config.outputCfg.channels = channelMask;
+    config.outputCfg.mask = EFFECT_CONFIG_ALL;
+
+    int reply = 0;
+    uint32_t replySize = sizeof(reply);
+    if (int status = (*effectHandle)
+            ->command(effectHandle, EFFECT_CMD_SET_CONFIG, sizeof(effect_config_t),
+                    &config, &replySize, &reply);
+        status != 0) {
+        ALOGE("command returned an error = %d\n", status);
+        return;
+    }
+
+    if (int status = setEngineArchitecture(effectHandle); status != 0) {
+        ALOGE("set engine architecture returned an error = %d\n", status);
+        return;
+    }
+
+    if (int status = (*effectHandle)
+            ->command(effectHandle, EFFECT_CMD_ENABLE, 0, nullptr, &replySize, &reply);
+        status != 0) {
+        ALOGE("Command enable call returned error %d\n", reply);
+        return;
+    }
+
+    // Run the test
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(input.data());
+        benchmark::DoNotOptimize(output.data());
+
+        audio_buffer_t inBuffer = {.frameCount = kFrameCount, .f32 = input.data()};
+        audio_buffer_t outBuffer = {.frameCount = kFrameCount, .f32 = output.data()};
+        (*effectHandle)->process(effectHandle, &inBuffer, &outBuffer);
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(std::to_string(sampleRate) + " Hz");
+
+    if (int status = AUDIO_EFFECT_LIBRARY_INFO_SYM.release_effect(effectHandle); status != 0) {
+        ALOGE("release_effect returned an error = %d\n", status);
+        return;
+    }
+}
+
+static void DynamicsProcessingArgs(benchmark::internal::Benchmark* b) {
+    for (int i = 0; i < (int)std::size(kSampleRates); i++) {
+        b->Args({i});
+    }
+}
+
+BENCHMARK(BM_DynamicsProcessing)->Apply(DynamicsProcessingArgs);
+
+BENCHMARK_MAIN();
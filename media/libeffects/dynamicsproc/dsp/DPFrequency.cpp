@@ -178,6 +178,9 @@ void DPFrequency::configure(size_t blockSize, size_t overlapSize,
 
     //Making sure window rms is not zero.
     mWindowRms = std::max(sqrt(mWindowRms / mVWindow.size()), MIN_ENVELOPE);
+
+    //preallocate the windowing workspace shared by all channels.
+    mWindowedTemp.resize(mVWindow.size());
 }
 
 void DPFrequency::updateParameters(ChannelBuffer &cb, int channelIndex) {
@@ -476,17 +479,17 @@ size_t DPFrequency::processChannelBuffers(CBufferVector &channelBuffers) {
 }
 size_t DPFrequency::processFirstStages(ChannelBuffer &cb) {
 
-    //##apply window
+    //##apply window, into the preallocated workspace (no per-block allocation)
     Eigen::Map<Eigen::VectorXf> eWindow(&mVWindow[0], mVWindow.size());
     Eigen::Map<Eigen::VectorXf> eInput(&cb.input[0], cb.input.size());
 
-    Eigen::VectorXf eWin = eInput.cwiseProduct(eWindow); //apply window
+    mWindowedTemp = eInput.cwiseProduct(eWindow); //apply window
 
     //##fft
     //Note: we are using eigen with the default scaling, which ensures that
     //  IFFT( FFT(x) ) = x.
     // TODO: optimize by using the noscale option, and compensate with dB scale offsets
-    mFftServer.fwd(cb.complexTemp, eWin);
+    mFftServer.fwd(cb.complexTemp, mWindowedTemp);
 
     size_t cSize = cb.complexTemp.size();
     size_t maxBin = std::min(cSize/2, mHalfFFTSize);
@@ -506,9 +509,12 @@ size_t DPFrequency::processFirstStages(ChannelBuffer &cb) {
             float preGainFactor = dBtoLinear(pMbcBandParams->gainPreDb);
             float preGainSquared = preGainFactor * preGainFactor;
 
+            // plain reduction over the band (pre gain applied once after the
+            // sum) so the compiler can vectorize the loop.
             for (size_t k = pMbcBandParams->binStart; k <= pMbcBandParams->binStop; k++) {
-                fEnergySum += std::norm(cb.complexTemp[k]) * preGainSquared; //mag squared
+                fEnergySum += std::norm(cb.complexTemp[k]); //mag squared
             }
+            fEnergySum *= preGainSquared;
 
             //Eigen FFT is full spectrum, even if the source was real data.
             // Each half spectrum has half the energy. This is taken into account with the * 2
@@ -153,6 +153,9 @@ private:
     FloatVec mVWindow;  //window class.
     float mWindowRms;
     Eigen::FFT<float> mFftServer;
+    // shared windowing workspace, sized once at configure time and reused for
+    // every channel and block so process() does not allocate.
+    Eigen::VectorXf mWindowedTemp;
 };
 
 } //namespace dp_fx
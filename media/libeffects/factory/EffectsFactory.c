@@ -181,6 +181,14 @@ int EffectQueryNumberEffects(uint32_t *pNumEffects)
         return -EINVAL;
     }
 
+    // enumeration needs the descriptors of every configured effect, so complete any
+    // loading deferred by the lazy mode before counting
+    if (EffectLoadAllDeferredLibraries() > 0) {
+        pthread_mutex_lock(&gLibLock);
+        updateNumEffects();
+        pthread_mutex_unlock(&gLibLock);
+    }
+
     pthread_mutex_lock(&gLibLock);
     *pNumEffects = gNumEffects;
     gCanQueryEffect = 1;
@@ -251,6 +259,15 @@ int EffectGetDescriptor(const effect_uuid_t *uuid, effect_descriptor_t *pDescrip
         *pDescriptor = *d;
     }
     pthread_mutex_unlock(&gLibLock);
+    if (ret != 0 && EffectLoadDeferredLibrary(uuid) == 0) {
+        // the uuid belongs to a library deferred by the lazy mode, retry now it is loaded
+        pthread_mutex_lock(&gLibLock);
+        ret = findEffect(NULL, uuid, &l, &d);
+        if (ret == 0) {
+            *pDescriptor = *d;
+        }
+        pthread_mutex_unlock(&gLibLock);
+    }
     return ret;
 }
 
@@ -288,7 +305,17 @@ int doEffectCreate(const effect_uuid_t *uuid, int32_t sessionId, int32_t ioId, i
         // so, findEffect will fail. Search for the effect in gSubEffectList.
         ret = findSubEffect(uuid, &l, &d);
         if (ret < 0) {
-            goto exit;
+            // the uuid may belong to a library deferred by the lazy mode; the loader must
+            // be called without gLibLock held
+            pthread_mutex_unlock(&gLibLock);
+            if (EffectLoadDeferredLibrary(uuid) != 0) {
+                return ret;
+            }
+            pthread_mutex_lock(&gLibLock);
+            ret = findEffect(NULL, uuid, &l, &d);
+            if (ret < 0) {
+                goto exit;
+            }
         }
     }
 
@@ -580,7 +607,9 @@ int EffectDumpEffects(int fd) {
         list_elem_t *efx = l->effects;
         dprintf(fd, " Library %s\n", l->name);
         dprintf(fd, "  path: %s\n", l->path);
-        if (!efx) {
+        if (l->handle == NULL) {
+            dprintf(fd, "  (deferred, not yet opened)\n");
+        } else if (!efx) {
             dprintf(fd, "  (no effects)\n");
         }
         while (efx) {
@@ -31,6 +31,12 @@ extern "C" {
 
 #define PROPERTY_IGNORE_EFFECTS "ro.audio.ignore_effects"
 
+// When true, libraries listed in the XML configuration are not dlopened at init time but
+// only when one of their effects is first queried or created, saving boot time and RSS on
+// devices where part of the configured effects is never used. Only supported by the XML
+// configuration loader.
+#define PROPERTY_LAZY_EFFECTS_LOAD "ro.audio.lazy_effects_load"
+
 typedef struct list_elem_s {
     void *object;
     struct list_elem_s *next;
@@ -17,11 +17,16 @@
 #define LOG_TAG "EffectsFactoryConfigLoader"
 //#define LOG_NDEBUG 0
 
+#include <algorithm>
 #include <dlfcn.h>
+#include <errno.h>
+#include <mutex>
 #include <set>
 #include <stdlib.h>
 #include <string>
+#include <vector>
 
+#include <cutils/properties.h>
 #include <log/log.h>
 
 #include <media/EffectsConfig.h>
@@ -310,6 +315,94 @@ size_t loadEffects(const Effects& effects, list_elem_t* libList, list_elem_t** s
     return nbSkippedElement;
 }
 
+/** A library whose dlopen is deferred until one of its effects is first needed,
+ * together with the effects the configuration assigns to it.  The placeholder
+ * lib_entry_t is already pushed on gLibraryList, with handle and desc left null.
+ */
+struct DeferredLibrary {
+    lib_entry_t* libEntry;
+    std::shared_ptr<const effectsConfig::Library> library;
+    std::vector<std::shared_ptr<const effectsConfig::Effect>> effects;
+    bool loaded = false;
+};
+
+/** Serializes deferred loading; taken before gLibLock. */
+std::mutex& getDeferredMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<DeferredLibrary>& getDeferredLibraries() {
+    static std::vector<DeferredLibrary> deferred;
+    return deferred;
+}
+
+/** Registers placeholder lib entries for the given libraries without dlopening them,
+ * remembering which effects each one provides so it can be completed on first use.
+ */
+void deferLibraries(const effectsConfig::Libraries& libs, const effectsConfig::Effects& effects) {
+    for (auto& library : libs) {
+        auto libEntry = makeUniqueC<lib_entry_t>();
+        libEntry->name = strdup(library->name.c_str());
+        libEntry->effects = nullptr;
+        // resolve the path eagerly so dumpsys shows where the library will come from
+        std::string absolutePath;
+        libEntry->path = strdup(resolveLibrary(library->path, &absolutePath)
+                ? absolutePath.c_str() : library->path.c_str());
+        pthread_mutex_init(&libEntry->lock, nullptr);
+
+        DeferredLibrary deferred;
+        deferred.libEntry = libEntry.get();
+        deferred.library = library;
+        for (auto& effect : effects) {
+            if (effect != nullptr && effect->library == library) {
+                deferred.effects.push_back(effect);
+            }
+        }
+        listPush(std::move(libEntry), &gLibraryList, &gLibLock);
+        getDeferredLibraries().push_back(std::move(deferred));
+    }
+}
+
+/** Loads the deferred library providing uuid, or all deferred libraries if uuid is null.
+ * @return the number of libraries loaded by this call.
+ */
+size_t loadDeferred(const effect_uuid_t* uuid) {
+    const std::lock_guard<std::mutex> guard(getDeferredMutex());
+    size_t nbLoaded = 0;
+    for (auto& deferred : getDeferredLibraries()) {
+        if (deferred.loaded) {
+            continue;
+        }
+        if (uuid != nullptr &&
+            std::none_of(deferred.effects.begin(), deferred.effects.end(),
+                         [uuid](const auto& effect) {
+                             return memcmp(&effect->uuid, uuid, sizeof(effect_uuid_t)) == 0;
+                         })) {
+            continue;
+        }
+        deferred.loaded = true;
+        ALOGV("%s loading deferred library %s", __func__, deferred.library->name.c_str());
+        // dlopen and fill the placeholder entry created at configuration time
+        free(deferred.libEntry->path);
+        deferred.libEntry->path = nullptr;
+        if (!loadLibrary(deferred.library->path.c_str(), deferred.libEntry)) {
+            ALOGE("%s could not load deferred library %s", __func__,
+                  deferred.library->name.c_str());
+            continue;
+        }
+        // attach the descriptors of its effects, as done at init time on the eager path
+        pthread_mutex_lock(&gLibLock);
+        loadEffects(deferred.effects, gLibraryList, &gSkippedEffects, &gSubEffectList);
+        pthread_mutex_unlock(&gLibLock);
+        ++nbLoaded;
+        if (uuid != nullptr) {
+            break;
+        }
+    }
+    return nbLoaded;
+}
+
 } // namespace
 
 /////////////////////////////////////////////////
@@ -324,10 +417,48 @@ extern "C" ssize_t EffectLoadXmlEffectConfig(const char* path)
         ALOGE("Failed to parse XML configuration file");
         return -1;
     }
-    result.nbSkippedElement += loadLibraries(result.parsedConfig->libraries,
-                                             &gLibraryList, &gLibLock, &gLibraryFailedList) +
-                               loadEffects(result.parsedConfig->effects, gLibraryList,
-                                           &gSkippedEffects, &gSubEffectList);
+
+    if (property_get_bool(PROPERTY_LAZY_EFFECTS_LOAD, false)) {
+        // Lazy mode: dlopen a library only when one of its effects is first requested.
+        // Proxy effects need their sub effect descriptors patched at load time, so every
+        // library referenced by a proxy stays on the eager path.
+        std::set<std::shared_ptr<const effectsConfig::Library>> eagerLibs;
+        for (auto& effect : result.parsedConfig->effects) {
+            if (effect != nullptr && effect->isProxy) {
+                eagerLibs.insert(effect->library);
+                if (effect->libSw != nullptr) eagerLibs.insert(effect->libSw->library);
+                if (effect->libHw != nullptr) eagerLibs.insert(effect->libHw->library);
+            }
+        }
+        effectsConfig::Libraries eagerLibraries;
+        effectsConfig::Libraries deferredLibraries;
+        for (auto& library : result.parsedConfig->libraries) {
+            (eagerLibs.count(library) != 0 ? eagerLibraries : deferredLibraries)
+                    .push_back(library);
+        }
+        effectsConfig::Effects eagerEffects;
+        effectsConfig::Effects deferredEffects;
+        for (auto& effect : result.parsedConfig->effects) {
+            if (effect == nullptr) {
+                continue;
+            }
+            (effect->isProxy || eagerLibs.count(effect->library) != 0 ? eagerEffects
+                                                                      : deferredEffects)
+                    .push_back(effect);
+        }
+        ALOGI("%s lazy effects load: %zu libraries eager, %zu deferred", __func__,
+              eagerLibraries.size(), deferredLibraries.size());
+        result.nbSkippedElement += loadLibraries(eagerLibraries,
+                                                 &gLibraryList, &gLibLock, &gLibraryFailedList) +
+                                   loadEffects(eagerEffects, gLibraryList,
+                                               &gSkippedEffects, &gSubEffectList);
+        deferLibraries(deferredLibraries, deferredEffects);
+    } else {
+        result.nbSkippedElement += loadLibraries(result.parsedConfig->libraries,
+                                                 &gLibraryList, &gLibLock, &gLibraryFailedList) +
+                                   loadEffects(result.parsedConfig->effects, gLibraryList,
+                                               &gSkippedEffects, &gSubEffectList);
+    }
 
     ALOGE_IF(result.nbSkippedElement != 0, "%s %zu errors during loading of configuration: %s",
              __func__, result.nbSkippedElement,
@@ -336,4 +467,14 @@ extern "C" ssize_t EffectLoadXmlEffectConfig(const char* path)
     return result.nbSkippedElement;
 }
 
+extern "C" int EffectLoadDeferredLibrary(const effect_uuid_t* uuid)
+{
+    return loadDeferred(uuid) > 0 ? 0 : -ENOENT;
+}
+
+extern "C" size_t EffectLoadAllDeferredLibraries(void)
+{
+    return loadDeferred(nullptr);
+}
+
 } // namespace android
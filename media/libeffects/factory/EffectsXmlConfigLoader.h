@@ -37,6 +37,21 @@ extern "C" {
 ANDROID_API
 ssize_t EffectLoadXmlEffectConfig(const char* path);
 
+/** Loads the library deferred by the lazy loading mode (see PROPERTY_LAZY_EFFECTS_LOAD)
+ * that provides the given effect uuid, if any.
+ * Must be called without gLibLock held.
+ * @return 0 if a deferred library was loaded for this uuid, -ENOENT otherwise.
+ */
+ANDROID_API
+int EffectLoadDeferredLibrary(const effect_uuid_t* uuid);
+
+/** Loads all libraries whose loading was deferred by the lazy loading mode.
+ * Must be called without gLibLock held.
+ * @return the number of libraries loaded by this call.
+ */
+ANDROID_API
+size_t EffectLoadAllDeferredLibraries(void);
+
 #if __cplusplus
 } // extern "C"
 #endif
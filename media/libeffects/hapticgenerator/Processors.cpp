@@ -79,6 +79,16 @@ void Ramp::process(float *out, const float *in, size_t frameCount) {
 
 // Implementation of SlowEnvelope
 
+// Relative envelope change below which the cached normalization gain is
+// reused. The envelope comes out of a 5 Hz low pass filter, so at audio rates
+// it rarely moves this much between samples and pow() is only recomputed a
+// handful of times per block.
+static constexpr float kEnvelopeTolerance = 0.001f;
+
+// Sentinel that can never match a real envelope (envelope + offset is > 0),
+// forcing a gain recomputation on the next sample.
+static constexpr float kInvalidEnvelope = -1.0f;
+
 SlowEnvelope::SlowEnvelope(
         float cornerFrequency,
         float sampleRate,
@@ -88,7 +98,9 @@ SlowEnvelope::SlowEnvelope(
         : mLpf(createLPF(cornerFrequency, sampleRate, channelCount)),
           mNormalizationPower(normalizationPower),
           mEnvOffset(envOffset),
-          mChannelCount(channelCount) {}
+          mChannelCount(channelCount),
+          mLastEnv(channelCount, kInvalidEnvelope),
+          mLastGain(channelCount, 0.0f) {}
 
 void SlowEnvelope::process(float* out, const float* in, size_t frameCount) {
     size_t sampleCount = frameCount * mChannelCount;
@@ -96,21 +108,44 @@ void SlowEnvelope::process(float* out, const float* in, size_t frameCount) {
         mLpfOutBuffer.resize(sampleCount);
         mLpfInBuffer.resize(sampleCount);
     }
-    for (size_t i = 0; i < sampleCount; ++i) {
+    size_t i = 0;
+#if USE_NEON
+    {
+        const float *rectIn = in;
+        float *rectOut = mLpfInBuffer.data();
+        while (i + 1 < sampleCount) {
+            vst1_f32(rectOut, vabs_f32(vld1_f32(rectIn)));
+            rectIn += 2;
+            rectOut += 2;
+            i += 2;
+        }
+    }
+#endif // USE_NEON
+    for (; i < sampleCount; ++i) {
         mLpfInBuffer[i] = fabs(in[i]);
     }
     mLpf->process(mLpfOutBuffer.data(), mLpfInBuffer.data(), frameCount);
-    for (size_t i = 0; i < sampleCount; ++i) {
-        out[i] = in[i] * pow(mLpfOutBuffer[i] + mEnvOffset, mNormalizationPower);
+    const size_t channelCount = mLastEnv.size();
+    for (size_t frame = 0, index = 0; frame < frameCount; ++frame) {
+        for (size_t channel = 0; channel < channelCount; ++channel, ++index) {
+            const float env = mLpfOutBuffer[index] + mEnvOffset;
+            if (fabs(env - mLastEnv[channel]) > kEnvelopeTolerance * env) {
+                mLastGain[channel] = pow(env, mNormalizationPower);
+                mLastEnv[channel] = env;
+            }
+            out[index] = in[index] * mLastGain[channel];
+        }
     }
 }
 
 void SlowEnvelope::setNormalizationPower(float normalizationPower) {
     mNormalizationPower = normalizationPower;
+    mLastEnv.assign(mLastEnv.size(), kInvalidEnvelope);
 }
 
 void SlowEnvelope::clear() {
     mLpf->clear();
+    mLastEnv.assign(mLastEnv.size(), kInvalidEnvelope);
 }
 
 // Implementation of distortion
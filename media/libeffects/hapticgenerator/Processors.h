@@ -60,6 +60,11 @@ private:
     float mNormalizationPower;
     const float mEnvOffset;
     const float mChannelCount;
+    // Per-channel cache of the last envelope value for which the normalization
+    // gain was computed, and that gain. The envelope moves slowly so most
+    // samples can reuse the cached gain instead of calling pow().
+    std::vector<float> mLastEnv;
+    std::vector<float> mLastGain;
 };
 
 
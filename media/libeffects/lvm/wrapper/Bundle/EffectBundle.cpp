@@ -666,9 +666,8 @@ int LvmBundle_process(effect_buffer_t* pIn, effect_buffer_t* pOut, int frameCoun
     if (LvmStatus != LVM_SUCCESS) return -EINVAL;
 
     if (pContext->config.outputCfg.accessMode == EFFECT_BUFFER_ACCESS_ACCUMULATE) {
-        for (int i = 0; i < frameCount * NrChannels; i++) {
-            pOut[i] = pOut[i] + pOutTmp[i];
-        }
+        // vectorized accumulate over the whole buffer instead of a per-sample loop
+        accumulate_float(pOut, pOutTmp, frameCount * NrChannels);
     }
     return 0;
 } /* end LvmBundle_process */
@@ -3043,9 +3042,7 @@ int Effect_process(effect_handle_t self, audio_buffer_t* inBuffer, audio_buffer_
         // pContext->pBundledContext->NumberEffectsCalled, pContext->EffectType);
 
         if (pContext->config.outputCfg.accessMode == EFFECT_BUFFER_ACCESS_ACCUMULATE) {
-            for (size_t i = 0; i < outBuffer->frameCount * NrChannels; ++i) {
-                outBuffer->f32[i] += inBuffer->f32[i];
-            }
+            accumulate_float(outBuffer->f32, inBuffer->f32, outBuffer->frameCount * NrChannels);
         } else if (outBuffer->raw != inBuffer->raw) {
             memcpy(outBuffer->raw, inBuffer->raw,
                    outBuffer->frameCount * sizeof(effect_buffer_t) * FCC_2);
@@ -822,8 +822,6 @@ int Effect_Release(preproc_effect_t* effect) {
 // Session functions
 //------------------------------------------------------------------------------
 
-#define RESAMPLER_QUALITY SPEEX_RESAMPLER_QUALITY_VOIP
-
 static const int kPreprocDefaultSr = 16000;
 static const int kPreProcDefaultCnl = 1;
 
@@ -1079,6 +1077,10 @@ int PreProcessingFx_Process(effect_handle_t self, audio_buffer_t* inBuffer,
 
     //    ALOGV("PreProcessingFx_Process In %d frames enabledMsk %08x processedMsk %08x",
     //         inBuffer->frameCount, session->enabledMsk, session->processedMsk);
+
+    // All enabled pre processors in the session share a single webRTC APM instance,
+    // so the stream is processed (and converted at the APM boundary) exactly once
+    // per 10 ms round, on the last enabled effect of the chain.
     if ((session->processedMsk & session->enabledMsk) == session->enabledMsk) {
         effect->session->processedMsk = 0;
         if (int status = effect->session->apm->ProcessStream(
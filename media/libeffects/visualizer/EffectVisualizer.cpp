@@ -25,6 +25,7 @@
 #include <time.h>
 
 #include <algorithm> // max
+#include <atomic>
 #include <new>
 
 #include <log/log.h>
@@ -95,6 +96,11 @@ struct VisualizerContext {
     uint32_t mLastCaptureIdx;
     uint32_t mLatency;
     struct timespec mBufferUpdateTime;
+    // Seqlock over the capture ring: odd while the audio thread is writing.
+    // The capture command retries its copy until it observes a stable even
+    // value, so it returns a consistent snapshot without ever making the
+    // audio thread block.
+    std::atomic<uint32_t> mCaptureSeq;
     uint8_t mCaptureBuf[CAPTURE_BUF_SIZE];
     // for measurements
     uint8_t mChannelCount; // to avoid recomputing it every time a buffer is processed
@@ -131,6 +137,7 @@ void Visualizer_reset(VisualizerContext *pContext)
     pContext->mLastCaptureIdx = 0;
     pContext->mBufferUpdateTime.tv_sec = 0;
     pContext->mLatency = 0;
+    pContext->mCaptureSeq.store(0, std::memory_order_relaxed);
     memset(pContext->mCaptureBuf, 0x80, CAPTURE_BUF_SIZE);
 }
 
@@ -427,6 +434,9 @@ int Visualizer_process(
 #endif // BUILD_FLOAT
     }
 
+    // seqlock write: odd sequence marks the ring as being updated.
+    pContext->mCaptureSeq.fetch_add(1, std::memory_order_acquire);
+
     uint32_t captIdx;
     uint32_t inIdx;
     uint8_t *buf = pContext->mCaptureBuf;
@@ -448,14 +458,15 @@ int Visualizer_process(
 #endif // BUILD_FLOAT
     }
 
-    // XXX the following two should really be atomic, though it probably doesn't
-    // matter much for visualization purposes
     pContext->mCaptureIdx = captIdx;
     // update last buffer update time stamp
     if (clock_gettime(CLOCK_MONOTONIC, &pContext->mBufferUpdateTime) < 0) {
         pContext->mBufferUpdateTime.tv_sec = 0;
     }
 
+    // seqlock write end: sequence is even again, ring and index are published.
+    pContext->mCaptureSeq.fetch_add(1, std::memory_order_release);
+
     if (inBuffer->raw != outBuffer->raw) {
 #ifdef BUILD_FLOAT
         if (pContext->mConfig.outputCfg.accessMode == EFFECT_BUFFER_ACCESS_ACCUMULATE) {
@@ -661,25 +672,42 @@ int Visualizer_command(effect_handle_t self, uint32_t cmdCode, uint32_t cmdSize,
                     deltaSmpl = CAPTURE_BUF_SIZE;
                 }
 
-                int32_t capturePoint;
-                //capturePoint = (int32_t)pContext->mCaptureIdx - deltaSmpl;
-                __builtin_sub_overflow((int32_t)pContext->mCaptureIdx, deltaSmpl, &capturePoint);
-                // a negative capturePoint means we wrap the buffer.
-                if (capturePoint < 0) {
-                    uint32_t size = -capturePoint;
-                    if (size > captureSize) {
-                        size = captureSize;
+                // seqlock read: retry until the copy observes a stable even
+                // sequence, so the reply is a consistent snapshot while the
+                // audio thread never blocks. Give up after a few attempts -
+                // a torn waveform is acceptable for display and better than
+                // spinning against a busy writer.
+                for (int retry = 0; retry < 3; retry++) {
+                    const uint32_t seqBegin =
+                            pContext->mCaptureSeq.load(std::memory_order_acquire);
+                    char *reply = (char *)pReplyData;
+                    uint32_t remaining = captureSize;
+
+                    int32_t capturePoint;
+                    //capturePoint = (int32_t)pContext->mCaptureIdx - deltaSmpl;
+                    __builtin_sub_overflow(
+                            (int32_t)pContext->mCaptureIdx, deltaSmpl, &capturePoint);
+                    // a negative capturePoint means we wrap the buffer.
+                    if (capturePoint < 0) {
+                        uint32_t size = -capturePoint;
+                        if (size > remaining) {
+                            size = remaining;
+                        }
+                        memcpy(reply,
+                               pContext->mCaptureBuf + CAPTURE_BUF_SIZE + capturePoint,
+                               size);
+                        reply += size;
+                        remaining -= size;
+                        capturePoint = 0;
+                    }
+                    memcpy(reply,
+                           pContext->mCaptureBuf + capturePoint,
+                           remaining);
+                    if ((seqBegin & 1) == 0 &&
+                            pContext->mCaptureSeq.load(std::memory_order_acquire) == seqBegin) {
+                        break;
                     }
-                    memcpy(pReplyData,
-                           pContext->mCaptureBuf + CAPTURE_BUF_SIZE + capturePoint,
-                           size);
-                    pReplyData = (char *)pReplyData + size;
-                    captureSize -= size;
-                    capturePoint = 0;
                 }
-                memcpy(pReplyData,
-                       pContext->mCaptureBuf + capturePoint,
-                       captureSize);
             }
 
             pContext->mLastCaptureIdx = pContext->mCaptureIdx;
@@ -104,6 +104,28 @@ TEST(HeadTrackingProcessor, Prediction) {
     EXPECT_EQ(processor->getHeadToStagePose(), Pose3f());
 }
 
+TEST(HeadTrackingProcessor, ForwardPrediction) {
+    const Pose3f worldToHead{{1, 2, 3}, Quaternionf::UnitRandom()};
+    const Twist3f headTwist{{4, 5, 6}, quaternionToRotationVector(Quaternionf::UnitRandom()) / 10};
+
+    std::unique_ptr<HeadTrackingProcessor> processor = createHeadTrackingProcessor(
+            Options{.maxForwardPredictionDuration = 3.f}, HeadTrackingMode::WORLD_RELATIVE);
+
+    // Establish a baseline for the drift compensators.
+    processor->setWorldToHeadPose(0, Pose3f(), Twist3f());
+    processor->setWorldToScreenPose(0, Pose3f());
+
+    // The pose is extrapolated from the last sample time to the output time.
+    processor->setWorldToHeadPose(0, worldToHead, headTwist);
+    processor->calculate(2);
+    ASSERT_EQ(processor->getActualMode(), HeadTrackingMode::WORLD_RELATIVE);
+    EXPECT_EQ(processor->getHeadToStagePose(), (worldToHead * integrate(headTwist, 2.f)).inverse());
+
+    // Beyond the cap, prediction saturates.
+    processor->calculate(5);
+    EXPECT_EQ(processor->getHeadToStagePose(), (worldToHead * integrate(headTwist, 3.f)).inverse());
+}
+
 TEST(HeadTrackingProcessor, SmoothModeSwitch) {
     const Pose3f targetHeadToWorld = Pose3f({4, 0, 0}, rotateZ(M_PI / 2));
 
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include <inttypes.h>
 
 #include <android-base/stringprintf.h>
@@ -64,6 +65,7 @@ class HeadTrackingProcessorImpl : public HeadTrackingProcessor {
         mHeadPoseBias.setInput(predictedWorldToHead);
         mHeadStillnessDetector.setInput(timestamp, predictedWorldToHead);
         mWorldToHeadTimestamp = timestamp;
+        mHeadTwist = headTwist;
     }
 
     void setWorldToScreenPose(int64_t timestamp, const Pose3f& worldToScreen) override {
@@ -113,6 +115,17 @@ class HeadTrackingProcessorImpl : public HeadTrackingProcessor {
                 worldToHead = mHeadPoseBias.getOutput();
             }
 
+            // Extrapolate the head pose forward to the output time, so that it reflects where the
+            // head will be when the audio is presented, rather than where it was when last
+            // sampled. Capped, so that a stalled sensor doesn't make us extrapolate indefinitely.
+            if (mOptions.maxForwardPredictionDuration > 0 &&
+                timestamp > mWorldToHeadTimestamp.value()) {
+                const float dt =
+                        std::min(static_cast<float>(timestamp - mWorldToHeadTimestamp.value()),
+                                 mOptions.maxForwardPredictionDuration);
+                worldToHead = worldToHead * integrate(mHeadTwist, dt);
+            }
+
             mScreenHeadFusion.setWorldToHeadPose(mWorldToHeadTimestamp.value(), worldToHead);
             mModeSelector.setWorldToHeadPose(mWorldToHeadTimestamp.value(), worldToHead);
         }
@@ -172,6 +185,8 @@ class HeadTrackingProcessorImpl : public HeadTrackingProcessor {
                       media::nsToFloatMs(mOptions.freshnessTimeout));
         StringAppendF(&ss, "%s predictionDuration: %0.4f ms\n", prefixSpace.c_str(),
                       media::nsToFloatMs(mOptions.predictionDuration));
+        StringAppendF(&ss, "%s maxForwardPredictionDuration: %0.4f ms\n", prefixSpace.c_str(),
+                      media::nsToFloatMs(mOptions.maxForwardPredictionDuration));
         StringAppendF(&ss, "%s autoRecenterWindowDuration: %0.4f ms\n", prefixSpace.c_str(),
                       media::nsToFloatMs(mOptions.autoRecenterWindowDuration));
         StringAppendF(&ss, "%s autoRecenterTranslationalThreshold: %f meter\n", prefixSpace.c_str(),
@@ -198,6 +213,7 @@ class HeadTrackingProcessorImpl : public HeadTrackingProcessor {
     // applies to arrives.
     float mPendingPhysicalToLogicalAngle = 0;
     std::optional<int64_t> mWorldToHeadTimestamp;
+    Twist3f mHeadTwist;
     std::optional<int64_t> mWorldToScreenTimestamp;
     Pose3f mHeadToStagePose;
     PoseBias mHeadPoseBias;
@@ -40,6 +40,7 @@ class HeadTrackingProcessor {
         float maxRotationalVelocity = std::numeric_limits<float>::infinity();
         int64_t freshnessTimeout = std::numeric_limits<int64_t>::max();
         float predictionDuration = 0;
+        float maxForwardPredictionDuration = 0;
         int64_t autoRecenterWindowDuration = std::numeric_limits<int64_t>::max();
         float autoRecenterTranslationalThreshold = std::numeric_limits<float>::infinity();
         float autoRecenterRotationalThreshold = std::numeric_limits<float>::infinity();
@@ -78,6 +79,10 @@ class HeadTrackingProcessor {
 
     /**
      * Process all the previous inputs and update the outputs.
+     * timestamp is the time for which the output pose is desired, typically the time at which the
+     * audio being rendered will be presented. When maxForwardPredictionDuration is non-zero, the
+     * head pose is extrapolated from the last sensor sample up to this time (capped at
+     * maxForwardPredictionDuration), using the last reported head twist.
      */
     virtual void calculate(int64_t timestamp) = 0;
 
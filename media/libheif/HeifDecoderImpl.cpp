@@ -318,11 +318,18 @@ HeifDecoderImpl::HeifDecoderImpl() :
     mAvailableLines(0),
     mNumSlices(1),
     mSliceHeight(0),
-    mAsyncDecodeDone(false) {
+    mAsyncDecodeDone(false),
+    mStopDecoding(false) {
 }
 
 HeifDecoderImpl::~HeifDecoderImpl() {
     if (mThread != nullptr) {
+        {
+            // Stop the decode thread at the next slice boundary rather than
+            // decoding the rest of the image nobody is going to read.
+            Mutex::Autolock autolock(mLock);
+            mStopDecoding = true;
+        }
         mThread->join();
     }
 }
@@ -520,6 +527,21 @@ bool HeifDecoderImpl::decodeAsync() {
         if (bottom > mImageInfo.mHeight) {
             bottom = mImageInfo.mHeight;
         }
+        {
+            Mutex::Autolock autolock(mLock);
+
+            if (mStopDecoding) {
+                break;
+            }
+            // If the client already skipped past this entire slice (e.g. decoding
+            // a cropped or subsampled region), don't decode its tiles at all.
+            if (mCurScanline >= bottom) {
+                ALOGV("decodeAsync(): skipping slice %zu", i);
+                mAvailableLines = bottom;
+                mScanlineReady.signal();
+                continue;
+            }
+        }
         sp<IMemory> frameMemory = mRetriever->getImageRectAtIndex(
                 -1, mOutputColor, 0, top, mImageInfo.mWidth, bottom);
         {
@@ -725,6 +747,17 @@ bool HeifDecoderImpl::getScanline(uint8_t* dst) {
 }
 
 size_t HeifDecoderImpl::skipScanlines(size_t count) {
+    if (mNumSlices > 1) {
+        // Take the lock so the decode thread sees the new position and can
+        // skip slices that fall entirely above it.
+        Mutex::Autolock autolock(mLock);
+        return skipScanlinesInner(count);
+    }
+
+    return skipScanlinesInner(count);
+}
+
+size_t HeifDecoderImpl::skipScanlinesInner(size_t count) {
     uint32_t oldScanline = mCurScanline;
     mCurScanline += count;
     if (mCurScanline > mTotalScanline) {
@@ -80,9 +80,11 @@ private:
     size_t mNumSlices;
     uint32_t mSliceHeight;
     bool mAsyncDecodeDone;
+    bool mStopDecoding;
 
     bool decodeAsync();
     bool getScanlineInner(uint8_t* dst);
+    size_t skipScanlinesInner(size_t count);
     bool reinit(HeifFrameInfo* frameInfo);
 };
 
@@ -25,13 +25,16 @@ namespace android {
 
 BufferingSettings::BufferingSettings()
         : mInitialMarkMs(kNoMark),
-          mResumePlaybackMarkMs(kNoMark) { }
+          mResumePlaybackMarkMs(kNoMark),
+          mInitialMarkKB(kNoMark),
+          mResumePlaybackMarkKB(kNoMark) { }
 
 String8 BufferingSettings::toString() const {
     String8 s;
     s.appendFormat(
-            "initialMarks(%d ms), resumePlaybackMarks(%d ms)",
-            mInitialMarkMs, mResumePlaybackMarkMs);
+            "initialMarks(%d ms, %d KB), resumePlaybackMarks(%d ms, %d KB)",
+            mInitialMarkMs, mInitialMarkKB,
+            mResumePlaybackMarkMs, mResumePlaybackMarkKB);
     return s;
 }
 
@@ -19,6 +19,7 @@
 #include <stdint.h>
 
 #include <android/IDataSource.h>
+#include <binder/IMemory.h>
 #include <binder/IPCThreadState.h>
 #include <binder/Parcel.h>
 #include <gui/IGraphicBufferProducer.h>
@@ -166,6 +167,8 @@ public:
         data.writeInterfaceToken(IMediaPlayer::getInterfaceDescriptor());
         data.writeInt32(buffering.mInitialMarkMs);
         data.writeInt32(buffering.mResumePlaybackMarkMs);
+        data.writeInt32(buffering.mInitialMarkKB);
+        data.writeInt32(buffering.mResumePlaybackMarkKB);
         remote()->transact(SET_BUFFERING_SETTINGS, data, &reply);
         return reply.readInt32();
     }
@@ -182,6 +185,8 @@ public:
         if (err == OK) {
             buffering->mInitialMarkMs = reply.readInt32();
             buffering->mResumePlaybackMarkMs = reply.readInt32();
+            buffering->mInitialMarkKB = reply.readInt32();
+            buffering->mResumePlaybackMarkKB = reply.readInt32();
         }
         return err;
     }
@@ -312,6 +317,24 @@ public:
         return reply.readInt32();
     }
 
+    status_t getPlaybackStatePage(sp<IMemory>* page)
+    {
+        Parcel data, reply;
+        data.writeInterfaceToken(IMediaPlayer::getInterfaceDescriptor());
+        status_t status = remote()->transact(GET_PLAYBACK_STATE_PAGE, data, &reply);
+        if (status != NO_ERROR) {
+            return status;
+        }
+        status = reply.readInt32();
+        if (status == NO_ERROR) {
+            *page = interface_cast<IMemory>(reply.readStrongBinder());
+            if (*page == NULL) {
+                status = UNKNOWN_ERROR;
+            }
+        }
+        return status;
+    }
+
     status_t reset()
     {
         Parcel data, reply;
@@ -691,6 +714,8 @@ status_t BnMediaPlayer::onTransact(
             BufferingSettings buffering;
             buffering.mInitialMarkMs = data.readInt32();
             buffering.mResumePlaybackMarkMs = data.readInt32();
+            buffering.mInitialMarkKB = data.readInt32();
+            buffering.mResumePlaybackMarkKB = data.readInt32();
             reply->writeInt32(setBufferingSettings(buffering));
             return NO_ERROR;
         } break;
@@ -702,6 +727,8 @@ status_t BnMediaPlayer::onTransact(
             if (err == OK) {
                 reply->writeInt32(buffering.mInitialMarkMs);
                 reply->writeInt32(buffering.mResumePlaybackMarkMs);
+                reply->writeInt32(buffering.mInitialMarkKB);
+                reply->writeInt32(buffering.mResumePlaybackMarkKB);
             }
             return NO_ERROR;
         } break;
@@ -803,6 +830,16 @@ status_t BnMediaPlayer::onTransact(
             reply->writeInt32(ret);
             return NO_ERROR;
         } break;
+        case GET_PLAYBACK_STATE_PAGE: {
+            CHECK_INTERFACE(IMediaPlayer, data, reply);
+            sp<IMemory> page;
+            status_t ret = getPlaybackStatePage(&page);
+            reply->writeInt32(ret);
+            if (ret == NO_ERROR) {
+                reply->writeStrongBinder(IInterface::asBinder(page));
+            }
+            return NO_ERROR;
+        } break;
         case RESET: {
             CHECK_INTERFACE(IMediaPlayer, data, reply);
             reply->writeInt32(reset());
@@ -359,8 +359,6 @@ status_t BnMediaSource::onTransact(
                 // sizes it's faster to copy data through the Binder transaction
                 // On the other hand, if the data size is large enough, it's better to use shared
                 // memory. When data is too large, binder can't handle it.
-                //
-                // TODO: reduce MediaBuffer::kSharedMemThreshold
                 MediaBuffer *transferBuf = nullptr;
                 const size_t length = buf->range_length();
                 size_t offset = buf->range_offset();
@@ -30,6 +30,14 @@ struct BufferingSettings {
     // due to low cached data.
     int mResumePlaybackMarkMs;
 
+    // Byte counterparts of the time marks above. A mark is reached when
+    // either its time or its byte watermark is satisfied, so the byte marks
+    // bound how much memory buffering may use while chasing a time target on
+    // variable bitrate content. kNoMark leaves the byte watermark to the
+    // player, which derives one from the measured bitrate.
+    int mInitialMarkKB;
+    int mResumePlaybackMarkKB;
+
     BufferingSettings();
 
     String8 toString() const;
@@ -33,6 +33,7 @@ struct sockaddr_in;
 
 namespace android {
 
+class IMemory;
 class Parcel;
 class Surface;
 class IDataSource;
@@ -80,6 +81,10 @@ public:
             MediaPlayerSeekMode mode = MediaPlayerSeekMode::SEEK_PREVIOUS_SYNC) = 0;
     virtual status_t        getCurrentPosition(int* msec) = 0;
     virtual status_t        getDuration(int* msec) = 0;
+    // Returns the shared memory page holding this player's playback state
+    // (see PlaybackStatePage.h). The client maps it read-only and answers
+    // position/duration/play state polls from it without further IPC.
+    virtual status_t        getPlaybackStatePage(sp<IMemory>* page /* nonnull */) = 0;
     virtual status_t        notifyAt(int64_t mediaTimeUs) = 0;
     virtual status_t        reset() = 0;
     virtual status_t        setAudioStreamType(audio_stream_type_t type) = 0;
@@ -186,6 +191,7 @@ protected:
         SET_OUTPUT_DEVICE,
         GET_ROUTED_DEVICE_ID,
         ENABLE_AUDIO_DEVICE_CALLBACK,
+        GET_PLAYBACK_STATE_PAGE,
     };
 };
 
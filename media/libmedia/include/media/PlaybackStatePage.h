@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_PLAYBACKSTATEPAGE_H
+#define ANDROID_PLAYBACKSTATEPAGE_H
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace android {
+
+// Playback state shared between MediaPlayerService and its clients through a
+// memory page the client maps read-only, so steady-state polling of position,
+// duration and play state (e.g. a scrubber redrawn every frame) costs no
+// binder calls.
+//
+// The service is the only writer. It publishes updates under a seqlock:
+// |sequence| is bumped to an odd value before the state is written and to an
+// even value afterwards. Readers snapshot |state| and retry if the sequence
+// was odd or changed across the read.
+struct PlaybackStatePage {
+    enum : uint32_t {
+        // The state fields have been populated at least once; until then
+        // clients must fall back to the binder getters.
+        kFlagValid = 0x1,
+        kFlagPlaying = 0x2,
+    };
+
+    struct State {
+        uint32_t flags;
+        // Media position when the page was last updated and the
+        // CLOCK_MONOTONIC time of that update. While kFlagPlaying is set the
+        // current position is extrapolated as
+        //   anchorPositionMs + (nowUs - anchorRealtimeUs) * playbackSpeed.
+        int32_t anchorPositionMs;
+        int64_t anchorRealtimeUs;
+        float playbackSpeed;
+        int32_t durationMs;  // -1 if not (yet) known
+    };
+
+    std::atomic<uint32_t> sequence;
+    State state;
+};
+
+}  // namespace android
+
+#endif  // ANDROID_PLAYBACKSTATEPAGE_H
@@ -29,6 +29,7 @@
 #include <media/IMediaPlayer.h>
 #include <media/IMediaDeathNotifier.h>
 #include <media/IStreamSource.h>
+#include <media/PlaybackStatePage.h>
 #include <android/content/AttributionSourceState.h>
 
 #include <utils/KeyedVector.h>
@@ -292,7 +293,15 @@ private:
             status_t        doSetRetransmitEndpoint(const sp<IMediaPlayer>& player);
             status_t        checkStateForKeySet_l(int key);
 
+            // Takes a consistent snapshot of the playback state page shared by
+            // the service, fetching the page on first use. Returns false if
+            // the page is unavailable or not yet valid, in which case the
+            // caller falls back to the binder getters.
+            bool            readPlaybackStatePage_l(PlaybackStatePage::State* state);
+
     sp<IMediaPlayer>            mPlayer;
+    sp<IMemory>                 mStatePageMemory;
+    bool                        mStatePageRequested;
     thread_id_t                 mLockThreadId;
     Mutex                       mLock;
     Mutex                       mNotifyLock;
@@ -34,6 +34,7 @@
 #include <media/AVSyncSettings.h>
 #include <utils/KeyedVector.h>
 #include <utils/String8.h>
+#include <utils/Timers.h>
 #include <system/audio.h>
 #include <system/window.h>
 
@@ -42,6 +43,10 @@ namespace android {
 using media::VolumeShaper;
 using content::AttributionSourceState;
 
+// Oldest playback state anchor we still extrapolate from while playing;
+// beyond this we go back to the binder getter (which re-anchors the page).
+static const int64_t kMaxStateAnchorAgeUs = 5000000LL;
+
 MediaPlayer::MediaPlayer(const AttributionSourceState& attributionSource)
         : mAttributionSource(attributionSource)
 {
@@ -55,6 +60,7 @@ MediaPlayer::MediaPlayer(const AttributionSourceState& attributionSource)
     mSeekPosition = -1;
     mSeekMode = MediaPlayerSeekMode::SEEK_PREVIOUS_SYNC;
     mCurrentState = MEDIA_PLAYER_IDLE;
+    mStatePageRequested = false;
     mPrepareSync = false;
     mPrepareStatus = NO_ERROR;
     mLoop = false;
@@ -87,6 +93,8 @@ void MediaPlayer::disconnect()
         Mutex::Autolock _l(mLock);
         p = mPlayer;
         mPlayer.clear();
+        mStatePageMemory.clear();
+        mStatePageRequested = false;
     }
 
     if (p != 0) {
@@ -130,6 +138,8 @@ status_t MediaPlayer::attachNewPlayer(const sp<IMediaPlayer>& player)
         clear_l();
         p = mPlayer;
         mPlayer = player;
+        mStatePageMemory.clear();
+        mStatePageRequested = false;
         if (player != 0) {
             mCurrentState = MEDIA_PLAYER_INITIALIZED;
             err = NO_ERROR;
@@ -403,12 +413,49 @@ status_t MediaPlayer::pause()
     return INVALID_OPERATION;
 }
 
+bool MediaPlayer::readPlaybackStatePage_l(PlaybackStatePage::State* state)
+{
+    if (mStatePageMemory == NULL) {
+        if (mPlayer == NULL || mStatePageRequested) {
+            return false;
+        }
+        // Ask the service only once per attached player; a service without
+        // the page keeps getting the plain binder getters.
+        mStatePageRequested = true;
+        if (mPlayer->getPlaybackStatePage(&mStatePageMemory) != NO_ERROR
+                || mStatePageMemory == NULL) {
+            return false;
+        }
+    }
+    const PlaybackStatePage *page =
+            static_cast<const PlaybackStatePage *>(mStatePageMemory->unsecurePointer());
+    if (page == NULL) {
+        return false;
+    }
+    // seqlock read: retry while the service is mid-update.
+    for (int attempt = 0; attempt < 3; attempt++) {
+        const uint32_t seqBegin = page->sequence.load(std::memory_order_acquire);
+        *state = page->state;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((seqBegin & 1) == 0
+                && page->sequence.load(std::memory_order_relaxed) == seqBegin) {
+            return (state->flags & PlaybackStatePage::kFlagValid) != 0;
+        }
+    }
+    return false;
+}
+
 bool MediaPlayer::isPlaying()
 {
     Mutex::Autolock _l(mLock);
     if (mPlayer != 0) {
         bool temp = false;
-        mPlayer->isPlaying(&temp);
+        PlaybackStatePage::State state;
+        if (readPlaybackStatePage_l(&state)) {
+            temp = (state.flags & PlaybackStatePage::kFlagPlaying) != 0;
+        } else {
+            mPlayer->isPlaying(&temp);
+        }
         ALOGV("isPlaying: %d", temp);
         if ((mCurrentState & MEDIA_PLAYER_STARTED) && ! temp) {
             ALOGE("internal/external state mismatch corrected");
@@ -510,6 +557,32 @@ status_t MediaPlayer::getCurrentPosition(int *msec)
             *msec = mCurrentPosition;
             return NO_ERROR;
         }
+        PlaybackStatePage::State state;
+        if (readPlaybackStatePage_l(&state)) {
+            // Extrapolate from the anchor the service published; no IPC in
+            // the steady state. An anchor that has not been rewritten for a
+            // while can no longer be trusted while playing - extrapolation
+            // error (and any stall the service did not report) grows with
+            // its age - so fall back to the binder getter, which also makes
+            // the service re-anchor the page.
+            const int64_t elapsedUs =
+                    systemTime(SYSTEM_TIME_MONOTONIC) / 1000 - state.anchorRealtimeUs;
+            const bool playing = (state.flags & PlaybackStatePage::kFlagPlaying) != 0;
+            if (!playing || elapsedUs <= kMaxStateAnchorAgeUs) {
+                int64_t positionMs = state.anchorPositionMs;
+                if (playing) {
+                    positionMs += (int64_t)(elapsedUs * state.playbackSpeed) / 1000;
+                    if (state.durationMs >= 0 && positionMs > state.durationMs) {
+                        positionMs = state.durationMs;
+                    }
+                }
+                if (positionMs < 0) {
+                    positionMs = 0;
+                }
+                *msec = (int)positionMs;
+                return NO_ERROR;
+            }
+        }
         return mPlayer->getCurrentPosition(msec);
     }
     return INVALID_OPERATION;
@@ -521,6 +594,13 @@ status_t MediaPlayer::getDuration_l(int *msec)
     bool isValidState = (mCurrentState & (MEDIA_PLAYER_PREPARED | MEDIA_PLAYER_STARTED |
             MEDIA_PLAYER_PAUSED | MEDIA_PLAYER_STOPPED | MEDIA_PLAYER_PLAYBACK_COMPLETE));
     if (mPlayer != 0 && isValidState) {
+        PlaybackStatePage::State state;
+        if (readPlaybackStatePage_l(&state) && state.durationMs >= 0) {
+            if (msec) {
+                *msec = state.durationMs;
+            }
+            return NO_ERROR;
+        }
         int durationMs;
         status_t ret = mPlayer->getDuration(&durationMs);
 
@@ -911,6 +991,9 @@ void MediaPlayer::notify(int msg, int ext1, int ext2, const Parcel *obj)
         // ext2: Implementation dependant error code.
         ALOGE("error (%d, %d)", ext1, ext2);
         mCurrentState = MEDIA_PLAYER_STATE_ERROR;
+        // Stop extrapolating from a page the service may no longer update.
+        mStatePageMemory.clear();
+        mStatePageRequested = false;
         if (mPrepareSync)
         {
             ALOGV("signal application thread");
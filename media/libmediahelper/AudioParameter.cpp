@@ -64,22 +64,19 @@ const char * const AudioParameter::keyMaxAdditionalOutputDeviceDelay =
 
 AudioParameter::AudioParameter(const String8& keyValuePairs)
 {
-    char *str = new char[keyValuePairs.length()+1];
     mKeyValuePairs = keyValuePairs;
-    char *last;
-
-    strcpy(str, keyValuePairs.string());
-    char *pair = strtok_r(str, ";", &last);
-    while (pair != NULL) {
-        if (strlen(pair) != 0) {
-            size_t eqIdx = strcspn(pair, "=");
-            String8 key = String8(pair, eqIdx);
-            String8 value;
-            if (eqIdx == strlen(pair)) {
-                value = String8("");
-            } else {
-                value = String8(pair + eqIdx + 1);
-            }
+
+    // Parse in place: this runs on every setParameters() call, so avoid the
+    // scratch copy that strtok_r would require.
+    const char *pair = keyValuePairs.string();
+    while (true) {
+        const size_t pairLen = strcspn(pair, ";");
+        if (pairLen != 0) {
+            const char *eq = (const char *)memchr(pair, '=', pairLen);
+            String8 key = (eq != NULL) ?
+                    String8(pair, eq - pair) : String8(pair, pairLen);
+            String8 value = (eq != NULL) ?
+                    String8(eq + 1, pairLen - (eq - pair) - 1) : String8("");
             if (mParameters.indexOfKey(key) < 0) {
                 mParameters.add(key, value);
             } else {
@@ -88,10 +85,9 @@ AudioParameter::AudioParameter(const String8& keyValuePairs)
         } else {
             ALOGV("AudioParameter() cstor empty key value pair");
         }
-        pair = strtok_r(NULL, ";", &last);
+        if (pair[pairLen] == '\0') break;
+        pair += pairLen + 1;
     }
-
-    delete[] str;
 }
 
 AudioParameter::~AudioParameter()
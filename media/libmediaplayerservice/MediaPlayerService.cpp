@@ -23,6 +23,7 @@
 
 #include <chrono>
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <dirent.h>
@@ -58,6 +59,7 @@
 #include <media/mediarecorder.h>
 #include <media/MediaMetadataRetrieverInterface.h>
 #include <media/Metadata.h>
+#include <media/PlaybackStatePage.h>
 #include <media/AudioTrack.h>
 #include <media/stagefright/InterfaceUtils.h>
 #include <media/stagefright/MediaCodecConstants.h>
@@ -783,6 +785,17 @@ MediaPlayerService::Client::Client(
     mAudioAttributes = NULL;
     mListener = new Listener(this);
 
+    // The read-only heap makes remote mappings of the state page read-only
+    // while this process keeps write access.
+    sp<MemoryHeapBase> heap = new MemoryHeapBase(sizeof(PlaybackStatePage),
+            MemoryHeapBase::READ_ONLY, "PlaybackStatePage");
+    if (heap->getBase() != MAP_FAILED) {
+        memset(heap->getBase(), 0, sizeof(PlaybackStatePage));
+        mStatePageMemory = new MemoryBase(heap, 0, sizeof(PlaybackStatePage));
+    } else {
+        ALOGW("Client(%d) failed to allocate playback state page", connId);
+    }
+
 #if CALLBACK_ANTAGONIZER
     ALOGD("create Antagonizer");
     mAntagonizer = new Antagonizer(mListener);
@@ -1293,7 +1306,9 @@ status_t MediaPlayerService::Client::start()
     sp<MediaPlayerBase> p = getPlayer();
     if (p == 0) return UNKNOWN_ERROR;
     p->setLooping(mLoop);
-    return p->start();
+    status_t ret = p->start();
+    updatePlaybackStatePage();
+    return ret;
 }
 
 status_t MediaPlayerService::Client::stop()
@@ -1301,7 +1316,9 @@ status_t MediaPlayerService::Client::stop()
     ALOGV("[%d] stop", mConnId);
     sp<MediaPlayerBase> p = getPlayer();
     if (p == 0) return UNKNOWN_ERROR;
-    return p->stop();
+    status_t ret = p->stop();
+    updatePlaybackStatePage();
+    return ret;
 }
 
 status_t MediaPlayerService::Client::pause()
@@ -1309,7 +1326,9 @@ status_t MediaPlayerService::Client::pause()
     ALOGV("[%d] pause", mConnId);
     sp<MediaPlayerBase> p = getPlayer();
     if (p == 0) return UNKNOWN_ERROR;
-    return p->pause();
+    status_t ret = p->pause();
+    updatePlaybackStatePage();
+    return ret;
 }
 
 status_t MediaPlayerService::Client::isPlaying(bool* state)
@@ -1328,7 +1347,9 @@ status_t MediaPlayerService::Client::setPlaybackSettings(const AudioPlaybackRate
             mConnId, rate.mSpeed, rate.mPitch, rate.mFallbackMode, rate.mStretchMode);
     sp<MediaPlayerBase> p = getPlayer();
     if (p == 0) return UNKNOWN_ERROR;
-    return p->setPlaybackSettings(rate);
+    status_t ret = p->setPlaybackSettings(rate);
+    updatePlaybackStatePage();
+    return ret;
 }
 
 status_t MediaPlayerService::Client::getPlaybackSettings(AudioPlaybackRate* rate /* nonnull */)
@@ -1378,6 +1399,9 @@ status_t MediaPlayerService::Client::getCurrentPosition(int *msec)
     status_t ret = p->getCurrentPosition(msec);
     if (ret == NO_ERROR) {
         ALOGV("[%d] getCurrentPosition = %d", mConnId, *msec);
+        // Clients come back to this getter once their mapped anchor goes
+        // stale; rewrite the page so they return to the lock-free path.
+        updatePlaybackStatePage();
     } else {
         ALOGE("getCurrentPosition returned %d", ret);
     }
@@ -1398,6 +1422,58 @@ status_t MediaPlayerService::Client::getDuration(int *msec)
     return ret;
 }
 
+status_t MediaPlayerService::Client::getPlaybackStatePage(sp<IMemory>* page)
+{
+    ALOGV("[%d] getPlaybackStatePage", mConnId);
+    Mutex::Autolock l(mLock);
+    if (mStatePageMemory == NULL) {
+        return NO_MEMORY;
+    }
+    *page = mStatePageMemory;
+    return NO_ERROR;
+}
+
+void MediaPlayerService::Client::updatePlaybackStatePage()
+{
+    sp<MediaPlayerBase> p = getPlayer();
+    if (p == NULL || mStatePageMemory == NULL) {
+        return;
+    }
+
+    // Gather the new anchor before taking mLock; the player getters may call
+    // back into the player's own locks.
+    PlaybackStatePage::State state = {};
+    state.durationMs = -1;
+    int positionMs = 0;
+    if (p->getCurrentPosition(&positionMs) == NO_ERROR) {
+        state.flags |= PlaybackStatePage::kFlagValid;
+        if (p->isPlaying()) {
+            state.flags |= PlaybackStatePage::kFlagPlaying;
+        }
+    }
+    state.anchorPositionMs = positionMs;
+    state.anchorRealtimeUs = systemTime(SYSTEM_TIME_MONOTONIC) / 1000;
+    AudioPlaybackRate rate = AUDIO_PLAYBACK_RATE_DEFAULT;
+    (void)p->getPlaybackSettings(&rate);
+    state.playbackSpeed = rate.mSpeed;
+    int durationMs = -1;
+    if (p->getDuration(&durationMs) == NO_ERROR) {
+        state.durationMs = durationMs;
+    }
+
+    // mLock serializes the writers; readers in the client processes rely on
+    // the seqlock alone.
+    Mutex::Autolock l(mLock);
+    PlaybackStatePage *page =
+            static_cast<PlaybackStatePage *>(mStatePageMemory->unsecurePointer());
+    const uint32_t seq = page->sequence.load(std::memory_order_relaxed);
+    page->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page->state = state;
+    std::atomic_thread_fence(std::memory_order_release);
+    page->sequence.store(seq + 2, std::memory_order_release);
+}
+
 status_t MediaPlayerService::Client::setNextPlayer(const sp<IMediaPlayer>& player) {
     ALOGV("setNextPlayer");
     Mutex::Autolock l(mLock);
@@ -1464,7 +1540,10 @@ status_t MediaPlayerService::Client::seekTo(int msec, MediaPlayerSeekMode mode)
     ALOGV("[%d] seekTo(%d, %d)", mConnId, msec, mode);
     sp<MediaPlayerBase> p = getPlayer();
     if (p == 0) return UNKNOWN_ERROR;
-    return p->seekTo(msec, mode);
+    // The anchor is refreshed again on MEDIA_SEEK_COMPLETE.
+    status_t ret = p->seekTo(msec, mode);
+    updatePlaybackStatePage();
+    return ret;
 }
 
 status_t MediaPlayerService::Client::reset()
@@ -1473,7 +1552,9 @@ status_t MediaPlayerService::Client::reset()
     mRetransmitEndpointValid = false;
     sp<MediaPlayerBase> p = getPlayer();
     if (p == 0) return UNKNOWN_ERROR;
-    return p->reset();
+    status_t ret = p->reset();
+    updatePlaybackStatePage();
+    return ret;
 }
 
 status_t MediaPlayerService::Client::notifyAt(int64_t mediaTimeUs)
@@ -1635,6 +1716,27 @@ status_t MediaPlayerService::Client::getRetransmitEndpoint(
 void MediaPlayerService::Client::notify(
         int msg, int ext1, int ext2, const Parcel *obj)
 {
+    switch (msg) {
+        case MEDIA_PREPARED:
+        case MEDIA_PLAYBACK_COMPLETE:
+        case MEDIA_STARTED:
+        case MEDIA_PAUSED:
+        case MEDIA_STOPPED:
+        case MEDIA_SEEK_COMPLETE:
+            updatePlaybackStatePage();
+            break;
+        case MEDIA_INFO:
+            // Rebuffering stalls the position while the player still reports
+            // itself as playing; refresh the anchor so clients stop
+            // extrapolating across the stall.
+            if (ext1 == MEDIA_INFO_BUFFERING_START || ext1 == MEDIA_INFO_BUFFERING_END) {
+                updatePlaybackStatePage();
+            }
+            break;
+        default:
+            break;
+    }
+
     sp<IMediaPlayerClient> c;
     sp<Client> nextClient;
     status_t errStartNext = NO_ERROR;
@@ -345,6 +345,7 @@ private:
                 MediaPlayerSeekMode mode = MediaPlayerSeekMode::SEEK_PREVIOUS_SYNC);
         virtual status_t        getCurrentPosition(int* msec);
         virtual status_t        getDuration(int* msec);
+        virtual status_t        getPlaybackStatePage(sp<IMemory>* page);
         virtual status_t        reset();
         virtual status_t        notifyAt(int64_t mediaTimeUs);
         virtual status_t        setAudioStreamType(audio_stream_type_t type);
@@ -446,6 +447,13 @@ private:
         // Disconnect from the currently connected ANativeWindow.
         void disconnectNativeWindow_l();
 
+        // Refreshes the shared playback state page from the current player
+        // state. Called on the transitions that move the position anchor
+        // (start/pause/seek/rate change and the corresponding player
+        // notifications); between refreshes clients extrapolate the position
+        // locally from the anchor.
+        void updatePlaybackStatePage();
+
         status_t setAudioAttributes_l(const Parcel &request);
 
         class Listener : public MediaPlayerBase::Listener {
@@ -479,6 +487,9 @@ private:
                     bool                          mRetransmitEndpointValid;
                     sp<Client>                    mNextClient;
                     sp<MediaPlayerBase::Listener> mListener;
+                    // Shared playback state page; remote clients map the
+                    // underlying heap read-only.
+                    sp<IMemory>                   mStatePageMemory;
 
         // Metadata filters.
         media::Metadata::Filter mMetadataAllow;  // protected by mLock
@@ -20,6 +20,7 @@
 #include <datasource/PlayerServiceDataSourceFactory.h>
 #include <datasource/PlayerServiceFileSource.h>
 #include <datasource/PlayerServiceMediaHTTP.h>
+#include <media/IMediaHTTPService.h>
 #include <media/MediaHTTPConnection.h>
 #include <media/MediaHTTPService.h>
 
@@ -54,6 +55,62 @@ sp<DataSource> PlayerServiceDataSourceFactory::CreateMediaHTTP(
     }
 }
 
+sp<DataSource> PlayerServiceDataSourceFactory::CreateMediaHTTP(
+        const sp<IMediaHTTPService> &httpService) {
+    if (httpService == NULL) {
+        return NULL;
+    }
+
+    // The service binder identifies the client across the Bp wrappers that
+    // get recreated on every binder call, so it doubles as the pool key.
+    sp<IBinder> serviceBinder = IInterface::asBinder(httpService);
+
+    sp<MediaHTTPConnection> conn;
+    {
+        Mutex::Autolock l(mPoolLock);
+        for (size_t i = 0; i < mIdleConnections.size(); ++i) {
+            if (mIdleConnections[i].serviceBinder == serviceBinder) {
+                conn = mIdleConnections[i].connection;
+                mIdleConnections.removeAt(i);
+                break;
+            }
+        }
+    }
+
+    if (conn == NULL) {
+        conn = httpService->makeHTTPConnection();
+        if (conn == NULL) {
+            ALOGE("Failed to make http connection from http service!");
+            return NULL;
+        }
+    } else {
+        ALOGV("reusing pooled http connection");
+    }
+
+    return new PlayerServiceMediaHTTP(conn, serviceBinder);
+}
+
+void PlayerServiceDataSourceFactory::recycleHTTPConnection(
+        const sp<IBinder> &serviceBinder, const sp<MediaHTTPConnection> &conn) {
+    if (serviceBinder == NULL || conn == NULL || !serviceBinder->isBinderAlive()) {
+        return;
+    }
+
+    Mutex::Autolock l(mPoolLock);
+    // drop entries whose client has since died
+    for (size_t i = mIdleConnections.size(); i > 0;) {
+        --i;
+        if (!mIdleConnections[i].serviceBinder->isBinderAlive()) {
+            mIdleConnections.removeAt(i);
+        }
+    }
+    if (mIdleConnections.size() >= kMaxIdleConnections) {
+        // evict the oldest entry
+        mIdleConnections.removeAt(0);
+    }
+    mIdleConnections.push_back({serviceBinder, conn});
+}
+
 sp<DataSource> PlayerServiceDataSourceFactory::CreateFileSource(const char *uri) {
     return new PlayerServiceFileSource(uri);
 }
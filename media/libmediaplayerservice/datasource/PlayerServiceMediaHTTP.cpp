@@ -18,6 +18,7 @@
 #define LOG_TAG "PlayerServiceMediaHTTP"
 #include <utils/Log.h>
 
+#include <datasource/PlayerServiceDataSourceFactory.h>
 #include <datasource/PlayerServiceMediaHTTP.h>
 
 #include <binder/IServiceManager.h>
@@ -35,8 +36,25 @@ PlayerServiceMediaHTTP::PlayerServiceMediaHTTP(const sp<MediaHTTPConnection> &co
     (void) DrmInitialization(nullptr);
 }
 
+PlayerServiceMediaHTTP::PlayerServiceMediaHTTP(
+        const sp<MediaHTTPConnection> &conn, const sp<IBinder> &serviceBinder)
+    : MediaHTTP(conn),
+      mPooledConnection(conn),
+      mServiceBinder(serviceBinder),
+      mDrmManagerClient(NULL) {
+    (void) DrmInitialization(nullptr);
+}
+
 PlayerServiceMediaHTTP::~PlayerServiceMediaHTTP() {
     clearDRMState_l();
+
+    if (mServiceBinder != NULL && mPooledConnection != NULL) {
+        // Tear down any outstanding request before the connection goes
+        // back into the pool; disconnect() is idempotent client-side.
+        mPooledConnection->disconnect();
+        PlayerServiceDataSourceFactory::getInstance()->recycleHTTPConnection(
+                mServiceBinder, mPooledConnection);
+    }
 }
 
 // DRM...
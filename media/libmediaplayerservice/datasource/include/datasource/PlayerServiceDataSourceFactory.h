@@ -22,9 +22,13 @@
 #include <media/DataSource.h>
 #include <sys/types.h>
 #include <utils/RefBase.h>
+#include <utils/Vector.h>
 
 namespace android {
 
+class IBinder;
+struct IMediaHTTPService;
+struct MediaHTTPConnection;
 struct MediaHTTPService;
 class String8;
 struct HTTPBase;
@@ -34,12 +38,36 @@ public:
     static sp<PlayerServiceDataSourceFactory> getInstance();
     virtual sp<DataSource> CreateMediaHTTP(const sp<MediaHTTPService> &httpService);
 
+    // Like the base CreateMediaHTTP, but first tries to reuse an idle
+    // MediaHTTPConnection handed back by a torn-down data source of the
+    // same client. Reuse skips the synchronous makeHTTPConnection() round
+    // trip into the client process on every track change, and whatever
+    // socket and TLS session state the client's HTTP stack keeps on the
+    // connection object stays warm across items.
+    sp<DataSource> CreateMediaHTTP(const sp<IMediaHTTPService> &httpService);
+
+    // Called by PlayerServiceMediaHTTP on teardown to offer its connection
+    // back for reuse.
+    void recycleHTTPConnection(
+            const sp<IBinder> &serviceBinder, const sp<MediaHTTPConnection> &conn);
+
 protected:
     virtual sp<DataSource> CreateFileSource(const char *uri);
 
 private:
+    // Idle connections are keyed by the client's IMediaHTTPService binder
+    // so one client's cookies and auth state never leak into another's.
+    struct IdleConnection {
+        sp<IBinder> serviceBinder;
+        sp<MediaHTTPConnection> connection;
+    };
+
+    enum { kMaxIdleConnections = 4 };
+
     static sp<PlayerServiceDataSourceFactory> sInstance;
     static Mutex sInstanceLock;
+    Mutex mPoolLock;
+    Vector<IdleConnection> mIdleConnections;
     PlayerServiceDataSourceFactory() {};
 };
 
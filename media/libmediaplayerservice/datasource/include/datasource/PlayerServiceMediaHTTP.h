@@ -24,6 +24,7 @@
 
 namespace android {
 
+class IBinder;
 struct MediaHTTPConnection;
 
 // MediaHTTP implementation which works on MediaPlayerService.
@@ -31,10 +32,18 @@ struct MediaHTTPConnection;
 struct PlayerServiceMediaHTTP : public MediaHTTP {
     PlayerServiceMediaHTTP(const sp<MediaHTTPConnection> &conn);
 
+    // Pooled variant: on teardown the connection is offered back to
+    // PlayerServiceDataSourceFactory for reuse by the same client,
+    // identified by its IMediaHTTPService binder.
+    PlayerServiceMediaHTTP(
+            const sp<MediaHTTPConnection> &conn, const sp<IBinder> &serviceBinder);
+
 protected:
     virtual ~PlayerServiceMediaHTTP();
 
 private:
+    sp<MediaHTTPConnection> mPooledConnection;
+    sp<IBinder> mServiceBinder;
     sp<DecryptHandle> mDecryptHandle;
     DrmManagerClient *mDrmManagerClient;
 
@@ -20,6 +20,8 @@
 #include "GenericSource.h"
 #include "NuPlayerDrm.h"
 
+#include <math.h>
+
 #include <binder/IServiceManager.h>
 #include <cutils/properties.h>
 #include <datasource/PlayerServiceDataSourceFactory.h>
@@ -52,6 +54,27 @@ static const int kInitialMarkMs        = 5000;  // 5secs
 //static const int kPausePlaybackMarkMs  = 2000;  // 2secs
 static const int kResumePlaybackMarkMs = 15000;  // 15secs
 
+// readahead target per A/V track for non-streaming sources; the decoders
+// should never have to wait on extractor I/O
+static const int64_t kLocalReadaheadMarkUs = 2000000LL;  // 2secs
+
+struct NuPlayer::GenericSource::ReaderHandler : public AHandler {
+    explicit ReaderHandler(const wp<GenericSource> &source)
+        : mSource(source) {
+    }
+
+protected:
+    virtual void onMessageReceived(const sp<AMessage> &msg) {
+        sp<GenericSource> source = mSource.promote();
+        if (source != NULL) {
+            source->onMessageReceived(msg);
+        }
+    }
+
+private:
+    wp<GenericSource> mSource;
+};
+
 NuPlayer::GenericSource::GenericSource(
         const sp<AMessage> &notify,
         bool uidValid,
@@ -76,6 +99,9 @@ NuPlayer::GenericSource::GenericSource(
       mUIDValid(uidValid),
       mUID(uid),
       mMediaClock(mediaClock),
+      mLastSeekSyncTimeUs(-1LL),
+      mNoSyncUntilTimeUs(-1LL),
+      mSeekCoverageValid(false),
       mBitrate(-1LL),
       mPendingReadBufferTypes(0) {
     ALOGV("GenericSource");
@@ -346,6 +372,14 @@ NuPlayer::GenericSource::~GenericSource() {
         mLooper->unregisterHandler(id());
         mLooper->stop();
     }
+    if (mAudioReaderLooper != NULL) {
+        mAudioReaderLooper->unregisterHandler(mAudioReaderHandler->id());
+        mAudioReaderLooper->stop();
+    }
+    if (mVideoReaderLooper != NULL) {
+        mVideoReaderLooper->unregisterHandler(mVideoReaderHandler->id());
+        mVideoReaderLooper->stop();
+    }
     resetDataSource();
 }
 
@@ -359,6 +393,18 @@ void NuPlayer::GenericSource::prepareAsync() {
         mLooper->start();
 
         mLooper->registerHandler(this);
+
+        mAudioReaderLooper = new ALooper;
+        mAudioReaderLooper->setName("generic:aread");
+        mAudioReaderLooper->start();
+        mAudioReaderHandler = new ReaderHandler(this);
+        mAudioReaderLooper->registerHandler(mAudioReaderHandler);
+
+        mVideoReaderLooper = new ALooper;
+        mVideoReaderLooper->setName("generic:vread");
+        mVideoReaderLooper->start();
+        mVideoReaderHandler = new ReaderHandler(this);
+        mVideoReaderLooper->registerHandler(mVideoReaderHandler);
     }
 
     sp<AMessage> msg = new AMessage(kWhatPrepareAsync, this);
@@ -544,6 +590,8 @@ void NuPlayer::GenericSource::start() {
     }
 
     mStarted = true;
+    mLastSeekSyncTimeUs = -1;
+    mSeekCoverageValid = false;
 }
 
 void NuPlayer::GenericSource::stop() {
@@ -559,6 +607,9 @@ void NuPlayer::GenericSource::pause() {
 void NuPlayer::GenericSource::resume() {
     Mutex::Autolock _l(mLock);
     mStarted = true;
+    // playback advances past the last seek position, the scrub index is stale
+    mLastSeekSyncTimeUs = -1;
+    mSeekCoverageValid = false;
 }
 
 void NuPlayer::GenericSource::disconnect() {
@@ -801,24 +852,32 @@ void NuPlayer::GenericSource::sendGlobalTextData(
         return;
     }
 
-    uint32_t textType;
-    const void *data;
-    size_t size = 0;
-    if (mTimedTextTrack.mSource->getFormat()->findData(
-                    kKeyTextFormatData, &textType, &data, &size)) {
-        mGlobalTimedText = new ABuffer(size);
-        if (mGlobalTimedText->data()) {
-            memcpy(mGlobalTimedText->data(), data, size);
-            sp<AMessage> globalMeta = mGlobalTimedText->meta();
-            globalMeta->setInt64("timeUs", 0);
-            globalMeta->setString("mime", MEDIA_MIMETYPE_TEXT_3GPP);
-            globalMeta->setInt32("global", 1);
-            sp<AMessage> notify = dupNotify();
-            notify->setInt32("what", what);
-            notify->setBuffer("buffer", mGlobalTimedText);
-            notify->post();
+    // The global descriptor is constant for a given track; rebuild the
+    // buffer only when a track switch dropped the cached copy.
+    if (mGlobalTimedText == NULL) {
+        uint32_t textType;
+        const void *data;
+        size_t size = 0;
+        if (mTimedTextTrack.mSource->getFormat()->findData(
+                        kKeyTextFormatData, &textType, &data, &size)) {
+            sp<ABuffer> buffer = new ABuffer(size);
+            if (buffer->data()) {
+                memcpy(buffer->data(), data, size);
+                sp<AMessage> globalMeta = buffer->meta();
+                globalMeta->setInt64("timeUs", 0);
+                globalMeta->setString("mime", MEDIA_MIMETYPE_TEXT_3GPP);
+                globalMeta->setInt32("global", 1);
+                mGlobalTimedText = buffer;
+            }
         }
     }
+
+    if (mGlobalTimedText != NULL) {
+        sp<AMessage> notify = dupNotify();
+        notify->setInt32("what", what);
+        notify->setBuffer("buffer", mGlobalTimedText);
+        notify->post();
+    }
 }
 
 sp<MetaData> NuPlayer::GenericSource::getFormatMeta(bool audio) {
@@ -867,7 +926,8 @@ status_t NuPlayer::GenericSource::dequeueAccessUnit(
     // start pulling in more buffers if cache is running low
     // so that decoder has less chance of being starved
     if (!mIsStreaming) {
-        if (track->mPackets->getAvailableBufferCount(&finalResult) < 2) {
+        if (track->mPackets->getBufferedDurationUs(&finalResult) < kLocalReadaheadMarkUs / 2
+                || track->mPackets->getAvailableBufferCount(&finalResult) < 2) {
             postReadBuffer(audio? MEDIA_TRACK_TYPE_AUDIO : MEDIA_TRACK_TYPE_VIDEO);
         }
     } else {
@@ -878,7 +938,19 @@ status_t NuPlayer::GenericSource::dequeueAccessUnit(
              mBufferingSettings.mResumePlaybackMarkMs * 1000LL / 2;
         if (finalResult == OK) {
             if (durationUs < restartBufferingMarkUs) {
-                postReadBuffer(audio? MEDIA_TRACK_TYPE_AUDIO : MEDIA_TRACK_TYPE_VIDEO);
+                // Only refill if the hybrid byte watermark isn't already
+                // occupied: on a bitrate spike, half the resume time target
+                // can cost several times the intended memory.
+                int resumeMarkKB = mBufferingSettings.mResumePlaybackMarkKB;
+                int64_t restartMarkBytes = getMarkBytes(
+                        resumeMarkKB > 0 ? resumeMarkKB / 2 : BufferingSettings::kNoMark,
+                        restartBufferingMarkUs);
+                status_t ignored;
+                if (restartMarkBytes <= 0
+                        || (int64_t)track->mPackets->getBufferedSizeBytes(&ignored)
+                                < restartMarkBytes) {
+                    postReadBuffer(audio? MEDIA_TRACK_TYPE_AUDIO : MEDIA_TRACK_TYPE_VIDEO);
+                }
             }
             if (track->mPackets->getAvailableBufferCount(&finalResult) < 2
                 && !mSentPauseOnBuffering && !mPreparing) {
@@ -1040,6 +1112,7 @@ status_t NuPlayer::GenericSource::selectTrack(size_t trackIndex, bool select, in
         } else if (mTimedTextTrack.mSource != NULL && trackIndex == mTimedTextTrack.mIndex) {
             track = &mTimedTextTrack;
             mFetchTimedTextDataGeneration++;
+            mGlobalTimedText.clear();
         }
         if (track == NULL) {
             return INVALID_OPERATION;
@@ -1078,6 +1151,8 @@ status_t NuPlayer::GenericSource::selectTrack(size_t trackIndex, bool select, in
             mFetchSubtitleDataGeneration++;
         } else {
             mFetchTimedTextDataGeneration++;
+            // cached global descriptor belongs to the previous text track
+            mGlobalTimedText.clear();
         }
 
         status_t eosResult; // ignored
@@ -1136,6 +1211,19 @@ status_t NuPlayer::GenericSource::seekTo(int64_t seekTimeUs, MediaPlayerSeekMode
     return err;
 }
 
+bool NuPlayer::GenericSource::isSeekRedundant(
+        int64_t seekTimeUs, MediaPlayerSeekMode mode) {
+    Mutex::Autolock _l(mLock);
+    if (mode != MediaPlayerSeekMode::SEEK_PREVIOUS_SYNC
+            || mVideoTrack.mSource == NULL
+            || mLastSeekSyncTimeUs < 0) {
+        return false;
+    }
+    // No sync sample exists in (mLastSeekSyncTimeUs, mNoSyncUntilTimeUs], so
+    // any target in that range seeks to the same sync sample as last time.
+    return seekTimeUs >= mLastSeekSyncTimeUs && seekTimeUs <= mNoSyncUntilTimeUs;
+}
+
 void NuPlayer::GenericSource::onSeek(const sp<AMessage>& msg) {
     int64_t seekTimeUs;
     int32_t mode;
@@ -1156,8 +1244,20 @@ status_t NuPlayer::GenericSource::doSeek(int64_t seekTimeUs, MediaPlayerSeekMode
         ++mVideoDataGeneration;
 
         int64_t actualTimeUs;
+        mSeekCoverageValid = false;
         readBuffer(MEDIA_TRACK_TYPE_VIDEO, seekTimeUs, mode, &actualTimeUs);
 
+        // Remember which sync sample this seek landed on; targets that
+        // provably map to the same sync sample can be skipped while
+        // scrubbing, see isSeekRedundant().
+        if (mode == MediaPlayerSeekMode::SEEK_PREVIOUS_SYNC && actualTimeUs >= 0) {
+            mLastSeekSyncTimeUs = actualTimeUs;
+            mNoSyncUntilTimeUs = std::max(seekTimeUs, actualTimeUs);
+            mSeekCoverageValid = true;
+        } else {
+            mLastSeekSyncTimeUs = -1;
+        }
+
         if (mode != MediaPlayerSeekMode::SEEK_CLOSEST) {
             seekTimeUs = std::max<int64_t>(0, actualTimeUs);
         }
@@ -1307,7 +1407,18 @@ int32_t NuPlayer::GenericSource::getDataGeneration(media_track_type type) const
 void NuPlayer::GenericSource::postReadBuffer(media_track_type trackType) {
     if ((mPendingReadBufferTypes & (1 << trackType)) == 0) {
         mPendingReadBufferTypes |= (1 << trackType);
-        sp<AMessage> msg = new AMessage(kWhatReadBuffer, this);
+        // Steady-state A/V refills go to the per-track reader looper so a
+        // slow extractor read on one track can't stall refilling the other;
+        // everything else (text tracks, and the seek/track-change reads that
+        // call readBuffer directly) stays on |mLooper|.
+        sp<AMessage> msg;
+        if (trackType == MEDIA_TRACK_TYPE_AUDIO && mAudioReaderHandler != NULL) {
+            msg = new AMessage(kWhatReadBuffer, mAudioReaderHandler);
+        } else if (trackType == MEDIA_TRACK_TYPE_VIDEO && mVideoReaderHandler != NULL) {
+            msg = new AMessage(kWhatReadBuffer, mVideoReaderHandler);
+        } else {
+            msg = new AMessage(kWhatReadBuffer, this);
+        }
         msg->setInt32("trackType", trackType);
         msg->post();
     }
@@ -1326,14 +1437,17 @@ void NuPlayer::GenericSource::readBuffer(
         int64_t *actualTimeUs, bool formatChange) {
     Track *track;
     size_t maxBuffers = 1;
+    Mutex *readLock = NULL;
     switch (trackType) {
         case MEDIA_TRACK_TYPE_VIDEO:
             track = &mVideoTrack;
             maxBuffers = 8;  // too large of a number may influence seeks
+            readLock = &mVideoReadLock;
             break;
         case MEDIA_TRACK_TYPE_AUDIO:
             track = &mAudioTrack;
             maxBuffers = 64;
+            readLock = &mAudioReadLock;
             break;
         case MEDIA_TRACK_TYPE_SUBTITLE:
             track = &mSubtitleTrack;
@@ -1374,6 +1488,12 @@ void NuPlayer::GenericSource::readBuffer(
 
         sp<IMediaSource> source = track->mSource;
         mLock.unlock();
+        // IMediaSource::read* is not thread safe; A/V refills run on the
+        // per-track reader loopers while seeks and track changes read on
+        // |mLooper|, so serialize readers of the same track.
+        if (readLock != NULL) {
+            readLock->lock();
+        }
         if (couldReadMultiple) {
             err = source->readMultiple(
                     &mediaBuffers, maxBuffers - numBuffers, &options);
@@ -1384,6 +1504,9 @@ void NuPlayer::GenericSource::readBuffer(
                 mediaBuffers.push_back(mbuf);
             }
         }
+        if (readLock != NULL) {
+            readLock->unlock();
+        }
         mLock.lock();
 
         options.clearNonPersistent();
@@ -1411,6 +1534,19 @@ void NuPlayer::GenericSource::readBuffer(
                 mAudioTimeUs = timeUs;
             } else if (trackType == MEDIA_TRACK_TYPE_VIDEO) {
                 mVideoTimeUs = timeUs;
+
+                // Grow the no-sync-sample coverage of the scrub seek index
+                // while the reads still belong to the last seek's sync-sample
+                // group; the first sample of the next group freezes it.
+                if (mSeekCoverageValid) {
+                    int32_t isSync = 0;
+                    mbuf->meta_data().findInt32(kKeyIsSyncFrame, &isSync);
+                    if (isSync && timeUs != mLastSeekSyncTimeUs) {
+                        mSeekCoverageValid = false;
+                    } else if (!isSync && timeUs > mNoSyncUntilTimeUs) {
+                        mNoSyncUntilTimeUs = timeUs;
+                    }
+                }
             }
 
             queueDiscontinuityIfNeeded(seeking, formatChange, trackType, track);
@@ -1458,23 +1594,40 @@ void NuPlayer::GenericSource::readBuffer(
         }
     }
 
-    if (mIsStreaming
+    if (!mIsStreaming && mStarted && seekTimeUs < 0
         && (trackType == MEDIA_TRACK_TYPE_VIDEO || trackType == MEDIA_TRACK_TYPE_AUDIO)) {
+        // Local playback: keep reading ahead until the track holds
+        // kLocalReadaheadMarkUs of demuxed samples, so decoders dequeue from
+        // the packet source instead of waiting on extractor I/O. Backpressure
+        // is the mark itself; dequeueAccessUnit restarts the chain once the
+        // queue drains below it.
         status_t finalResult;
         int64_t durationUs = track->mPackets->getBufferedDurationUs(&finalResult);
+        if (finalResult == OK && durationUs < kLocalReadaheadMarkUs) {
+            postReadBuffer(trackType);
+        }
+    }
+
+    if (mIsStreaming
+        && (trackType == MEDIA_TRACK_TYPE_VIDEO || trackType == MEDIA_TRACK_TYPE_AUDIO)) {
+        status_t finalResult;
 
         // TODO: maxRebufferingMarkMs could be larger than
         // mBufferingSettings.mResumePlaybackMarkMs
         int64_t markUs = (mPreparing ? mBufferingSettings.mInitialMarkMs
             : mBufferingSettings.mResumePlaybackMarkMs) * 1000LL;
-        if (finalResult == ERROR_END_OF_STREAM || durationUs >= markUs) {
+        int markKB = mPreparing ? mBufferingSettings.mInitialMarkKB
+            : mBufferingSettings.mResumePlaybackMarkKB;
+        if (isBufferingMarkReached(track, markUs, markKB, &finalResult)) {
             if (mPreparing || mSentPauseOnBuffering) {
                 Track *counterTrack =
                     (trackType == MEDIA_TRACK_TYPE_VIDEO ? &mAudioTrack : &mVideoTrack);
+                bool counterReached = true;
                 if (counterTrack->mSource != NULL) {
-                    durationUs = counterTrack->mPackets->getBufferedDurationUs(&finalResult);
+                    counterReached = isBufferingMarkReached(
+                            counterTrack, markUs, markKB, &finalResult);
                 }
-                if (finalResult == ERROR_END_OF_STREAM || durationUs >= markUs) {
+                if (counterReached) {
                     if (mPreparing) {
                         notifyPrepared();
                         mPreparing = false;
@@ -1494,6 +1647,69 @@ void NuPlayer::GenericSource::readBuffer(
     }
 }
 
+void NuPlayer::GenericSource::BitrateEstimate::update(double bps) {
+    if (bps <= 0.) {
+        return;
+    }
+    if (!mValid) {
+        mMeanBps = bps;
+        mVarBps = 0.;
+        mValid = true;
+        return;
+    }
+    // Exponential moving mean and variance; the weight keeps a few tens of
+    // seconds of history at the 1 sec poll / readahead cadence.
+    static const double kAlpha = 0.25;
+    const double delta = bps - mMeanBps;
+    mMeanBps += kAlpha * delta;
+    mVarBps = (1. - kAlpha) * (mVarBps + kAlpha * delta * delta);
+}
+
+double NuPlayer::GenericSource::BitrateEstimate::headroomFactor() const {
+    if (!mValid || mMeanBps <= 0.) {
+        return 1.;
+    }
+    // Headroom tracks the coefficient of variation: 1x on constant bitrate
+    // streams, capped at 2x on very spiky ones.
+    const double cv = sqrt(mVarBps) / mMeanBps;
+    return 1. + (cv < 1. ? cv : 1.);
+}
+
+int64_t NuPlayer::GenericSource::getMarkBytes(int markKB, int64_t markUs) const {
+    if (markKB != BufferingSettings::kNoMark && markKB > 0) {
+        return markKB * 1024LL;
+    }
+    if (!mBitrateEstimate.mValid) {
+        // No explicit byte mark and nothing measured yet; keep the
+        // historical time-only behavior.
+        return -1;
+    }
+    return (int64_t)(markUs / 8E6 * mBitrateEstimate.mMeanBps
+            * mBitrateEstimate.headroomFactor());
+}
+
+bool NuPlayer::GenericSource::isBufferingMarkReached(
+        Track *track, int64_t markUs, int markKB, status_t *finalResult) {
+    int64_t durationUs = track->mPackets->getBufferedDurationUs(finalResult);
+    if (*finalResult == ERROR_END_OF_STREAM || durationUs >= markUs) {
+        return true;
+    }
+
+    status_t ignored;
+    int64_t bufferedBytes = (int64_t)track->mPackets->getBufferedSizeBytes(&ignored);
+    if (durationUs > 0 && bufferedBytes > 0) {
+        mBitrateEstimate.update(bufferedBytes * 8E6 / durationUs);
+    }
+
+    int64_t markBytes = getMarkBytes(markKB, markUs);
+    if (markBytes > 0 && bufferedBytes >= markBytes) {
+        ALOGV("byte watermark reached: %lld bytes buffered at %.2f secs (mark %.2f secs)",
+                (long long)bufferedBytes, durationUs / 1E6, markUs / 1E6);
+        return true;
+    }
+    return false;
+}
+
 void NuPlayer::GenericSource::queueDiscontinuityIfNeeded(
         bool seeking, bool formatChange, media_track_type trackType, Track *track) {
     // formatChange && seeking: track whose source is changed during selection
@@ -186,6 +186,7 @@ NuPlayer::NuPlayer(pid_t pid, const sp<MediaClock> &mediaClock)
       mLastStartedPlayingTimeNs(0),
       mLastStartedRebufferingTimeNs(0),
       mPreviousSeekTimeUs(0),
+      mScrubAnchorValid(false),
       mAudioEOS(false),
       mVideoEOS(false),
       mScanSourcesPending(false),
@@ -200,6 +201,7 @@ NuPlayer::NuPlayer(pid_t pid, const sp<MediaClock> &mediaClock)
       mVideoFpsHint(-1.f),
       mStarted(false),
       mPrepared(false),
+      mWarmPrepare(false),
       mResetting(false),
       mSourceStarted(false),
       mAudioDecoderError(false),
@@ -387,6 +389,12 @@ void NuPlayer::prepareAsync() {
     (new AMessage(kWhatPrepare, this))->post();
 }
 
+void NuPlayer::warmPrepareAsync() {
+    ALOGV("warmPrepareAsync");
+
+    (new AMessage(kWhatWarmPrepare, this))->post();
+}
+
 void NuPlayer::setVideoSurfaceTextureAsync(
         const sp<IGraphicBufferProducer> &bufferProducer) {
     sp<AMessage> msg = new AMessage(kWhatSetVideoSurface, this);
@@ -634,6 +642,24 @@ void NuPlayer::onMessageReceived(const sp<AMessage> &msg) {
             break;
         }
 
+        case kWhatWarmPrepare:
+        {
+            ALOGV("onMessageReceived kWhatWarmPrepare");
+
+            if (mSource == NULL || mStarted) {
+                ALOGW("warm prepare %s, ignoring",
+                        mSource == NULL ? "without a source" : "after start");
+                break;
+            }
+
+            mWarmPrepare = true;
+            if (mPrepared) {
+                onWarmPrepare();
+            }
+            // otherwise warm-up runs when Source::kWhatPrepared arrives
+            break;
+        }
+
         case kWhatGetTrackInfo:
         {
             sp<AReplyToken> replyID;
@@ -792,8 +818,11 @@ void NuPlayer::onMessageReceived(const sp<AMessage> &msg) {
 
             // Need to check mStarted before calling mSource->getFormat because NuPlayer might
             // be in preparing state and it could take long time.
-            // When mStarted is true, mSource must have been set.
-            if (mSource == NULL || !mStarted || mSource->getFormat(false /* audio */) == NULL
+            // When mStarted is true, mSource must have been set. A video decoder
+            // instantiated by warm prepare (source prepared but not started yet)
+            // switches surfaces the same way a started one does.
+            if (mSource == NULL || (!mStarted && mVideoDecoder == NULL)
+                    || mSource->getFormat(false /* audio */) == NULL
                     // NOTE: mVideoDecoder's mSurface is always non-null
                     || (mVideoDecoder != NULL && mVideoDecoder->setVideoSurface(surface) == OK)) {
                 performSetSurface(surface);
@@ -1405,6 +1434,20 @@ void NuPlayer::onMessageReceived(const sp<AMessage> &msg) {
                 break;
             }
 
+            if (mPaused && mScrubAnchorValid
+                    && mSource->isSeekRedundant(seekTimeUs, (MediaPlayerSeekMode)mode)) {
+                // Scrubbing within one sync-sample group: the previous seek
+                // already decoded and displays this exact frame, so skip the
+                // flush/seek/decode round trip.
+                ALOGV("kWhatSeek skipping redundant scrub seek to %lld us",
+                        (long long)seekTimeUs);
+                mPreviousSeekTimeUs = seekTimeUs;
+                if (needNotify) {
+                    notifyDriverSeekComplete();
+                }
+                break;
+            }
+
             mDeferredActions.push_back(
                     new FlushDecoderAction(FLUSH_CMD_FLUSH /* audio */,
                                            FLUSH_CMD_FLUSH /* video */));
@@ -1495,6 +1538,7 @@ void NuPlayer::onResume() {
         return;
     }
     mPaused = false;
+    mScrubAnchorValid = false;
     if (mSource != NULL) {
         mSource->resume();
     } else {
@@ -1543,6 +1587,25 @@ status_t NuPlayer::onInstantiateSecureDecoders() {
     return OK;
 }
 
+void NuPlayer::onWarmPrepare() {
+    ALOGV("onWarmPrepare");
+
+    // Overlap the expensive parts of starting playback with the time the app
+    // spends between prepare and start: start the source and instantiate the
+    // decoders now, so the codecs get configured and begin fetching and
+    // decoding the first access units. There is no renderer yet; decoded
+    // output is parked in the decoders (see Decoder::onSetRenderer) until
+    // onStart() creates one and attaches it. With no renderer the audio
+    // decoder is instantiated in non-offload mode (determineAudioModeChange
+    // falls back to non-offload), which onStart() takes into account.
+    if (!mSourceStarted) {
+        mSourceStarted = true;
+        mSource->start();
+    }
+
+    postScanSources();
+}
+
 void NuPlayer::onStart(int64_t startPositionUs, MediaPlayerSeekMode mode) {
     ALOGV("onStart: mCrypto: %p (%d)", mCrypto.get(),
             (mCrypto != NULL ? mCrypto->getStrongCount() : 0));
@@ -1562,6 +1625,7 @@ void NuPlayer::onStart(int64_t startPositionUs, MediaPlayerSeekMode mode) {
     mAudioEOS = false;
     mVideoEOS = false;
     mStarted = true;
+    mWarmPrepare = false;
     mPaused = false;
 
     uint32_t flags = 0;
@@ -1598,6 +1662,13 @@ void NuPlayer::onStart(int64_t startPositionUs, MediaPlayerSeekMode mode) {
         ALOGV("onStart: Disabling mOffloadAudio now that the source is protected.");
     }
 
+    // A warm-prepared audio decoder was created in non-offload mode; keep it
+    // rather than tearing it down, which would defeat the warm-up.
+    if (mOffloadAudio && mAudioDecoder != NULL) {
+        mOffloadAudio = false;
+        ALOGV("onStart: Disabling mOffloadAudio to keep the warm-prepared decoder.");
+    }
+
     if (mOffloadAudio) {
         flags |= Renderer::FLAG_OFFLOAD_AUDIO;
     }
@@ -2361,6 +2432,10 @@ void NuPlayer::performSeek(int64_t seekTimeUs, MediaPlayerSeekMode mode) {
     mSource->seekTo(seekTimeUs, mode);
     ++mTimedTextGeneration;
 
+    // While paused the displayed frame is now the seek's sync sample, which
+    // allows skipping later scrub seeks that map to the same sync sample.
+    mScrubAnchorValid = mPaused;
+
     // everything's flushed, continue playback.
 }
 
@@ -2418,8 +2493,10 @@ void NuPlayer::performReset() {
 
     mStarted = false;
     mPrepared = false;
+    mWarmPrepare = false;
     mResetting = false;
     mSourceStarted = false;
+    mScrubAnchorValid = false;
 
     // Modular DRM
     if (mCrypto != NULL) {
@@ -2543,6 +2620,9 @@ void NuPlayer::onSourceNotify(const sp<AMessage> &msg) {
                 processDeferredActions();
             } else {
                 mPrepared = true;
+                if (mWarmPrepare && !mStarted) {
+                    onWarmPrepare();
+                }
             }
 
             sp<NuPlayerDriver> driver = mDriver.promote();
@@ -68,6 +68,7 @@ NuPlayer::Decoder::Decoder(
       mSource(source),
       mRenderer(renderer),
       mCCDecoder(ccDecoder),
+      mPendingQueueEOS(false),
       mPid(pid),
       mUid(uid),
       mSkipRenderingUntilMediaTimeUs(-1LL),
@@ -473,6 +474,32 @@ void NuPlayer::Decoder::onSetParameters(const sp<AMessage> &params) {
 
 void NuPlayer::Decoder::onSetRenderer(const sp<Renderer> &renderer) {
     mRenderer = renderer;
+    if (mRenderer == NULL) {
+        return;
+    }
+
+    // Replay whatever the codec produced during preroll warm-up, while there
+    // was no renderer to deliver to. The audio format change must go first so
+    // the sink is opened before buffers are queued; ordering is preserved
+    // since both run through the renderer's looper.
+    if (mPendingAudioFormatChange != NULL) {
+        sp<AMessage> format = mPendingAudioFormatChange;
+        mPendingAudioFormatChange.clear();
+        handleOutputFormatChange(format);
+    }
+    while (!mPendingRendererMessages.empty()) {
+        sp<AMessage> reply = *mPendingRendererMessages.begin();
+        mPendingRendererMessages.erase(mPendingRendererMessages.begin());
+
+        sp<RefBase> obj;
+        CHECK(reply->findObject("buffer", &obj));
+        mRenderer->queueBuffer(
+                mIsAudio, static_cast<MediaCodecBuffer *>(obj.get()), reply);
+    }
+    if (mPendingQueueEOS) {
+        mPendingQueueEOS = false;
+        mRenderer->queueEOS(mIsAudio, ERROR_END_OF_STREAM);
+    }
 }
 
 void NuPlayer::Decoder::onResume(bool notifyComplete) {
@@ -809,6 +836,15 @@ bool NuPlayer::Decoder::handleAnOutputBuffer(
         if (eos && !isDiscontinuityPending()) {
             mRenderer->queueEOS(mIsAudio, ERROR_END_OF_STREAM);
         }
+    } else {
+        // Decoded during preroll warm-up, before a renderer is attached.
+        // Hold on to the buffer; onSetRenderer() queues it once playback
+        // actually starts.
+        reply->setObject("buffer", buffer);
+        mPendingRendererMessages.push_back(reply);
+        if (eos && !isDiscontinuityPending()) {
+            mPendingQueueEOS = true;
+        }
     }
 
     return true;
@@ -827,7 +863,11 @@ void NuPlayer::Decoder::handleOutputFormatChange(const sp<AMessage> &format) {
         notify->setInt32("what", kWhatVideoSizeChanged);
         notify->setMessage("format", format);
         notify->post();
-    } else if (mRenderer != NULL) {
+    } else if (mRenderer == NULL) {
+        // Preroll warm-up: remember the format change and replay it once a
+        // renderer is attached, see onSetRenderer().
+        mPendingAudioFormatChange = format;
+    } else {
         uint32_t flags;
         int64_t durationUs;
         bool hasVideo = (mSource->getFormat(false /* audio */) != NULL);
@@ -865,6 +905,11 @@ void NuPlayer::Decoder::releaseAndResetMediaBuffers() {
     }
 
     mPendingInputMessages.clear();
+    // buffers held for a not-yet-attached renderer are reclaimed by the
+    // codec flush/release that brought us here
+    mPendingRendererMessages.clear();
+    mPendingAudioFormatChange.clear();
+    mPendingQueueEOS = false;
     mDequeuedInputBuffers.clear();
     mSkipRenderingUntilMediaTimeUs = -1;
 }
@@ -960,7 +1005,7 @@ status_t NuPlayer::Decoder::fetchInputData(sp<AMessage> &reply) {
 
             int32_t layerId = 0;
             bool haveLayerId = accessUnit->meta()->findInt32("temporal-layer-id", &layerId);
-            if (mRenderer->getVideoLateByUs() > 100000LL
+            if (mRenderer != NULL && mRenderer->getVideoLateByUs() > 100000LL
                     && mIsVideoAVC
                     && !IsAVCReferenceFrame(accessUnit)) {
                 dropAccessUnit = true;
@@ -350,6 +350,23 @@ status_t NuPlayerDriver::prepareAsync() {
     };
 }
 
+status_t NuPlayerDriver::warmPrepare() {
+    ALOGV("warmPrepare(%p)", this);
+    Mutex::Autolock autoLock(mLock);
+
+    switch (mState) {
+        case STATE_PREPARING:
+        case STATE_PREPARED:
+            // Warm up the pipeline so the upcoming start() renders its first
+            // frame sooner. Safe to issue while still preparing; NuPlayer
+            // defers the warm-up until the source is prepared.
+            mPlayer->warmPrepareAsync();
+            return OK;
+        default:
+            return INVALID_OPERATION;
+    }
+}
+
 status_t NuPlayerDriver::start() {
     ALOGV("start(%p), state is %d, eos is %d", this, mState, mAtEOS);
     Mutex::Autolock autoLock(mLock);
@@ -1386,10 +1386,58 @@ void NuPlayer::Renderer::onDrainVideoQueue() {
         return;
     }
 
-    QueueEntry *entry = &*mVideoQueue.begin();
+    // Release in one pass every queued frame whose release time falls within
+    // the vsync window started by the frame at the head of the queue. At frame
+    // rates above the display refresh rate (or when we're catching up after
+    // falling behind) this collapses what used to be one wakeup per frame into
+    // one wakeup per vsync; postDrainVideoQueue() then arms a single timer for
+    // the first frame of the next window.
+    int64_t vsyncPeriodUs = mVideoScheduler->getVsyncPeriod() / 1000;
+
+    // Collect the run of frames in the head frame's vsync window, then assign
+    // all of their release times in a single scheduler pass.
+    static const size_t kMaxFramesPerDrain = 32;
+    nsecs_t renderTimes[kMaxFramesPerDrain];
+    nsecs_t scheduledTimes[kMaxFramesPerDrain];
+    size_t numFrames = 0;
+    int64_t collectNowUs = ALooper::GetNowUs();
+    for (List<QueueEntry>::iterator it = mVideoQueue.begin();
+            it != mVideoQueue.end() && numFrames < kMaxFramesPerDrain; ++it) {
+        if (it->mBuffer == NULL) {
+            // EOS; let postDrainVideoQueue() repost so it's handled on its
+            // own wakeup once the frames before it are released.
+            break;
+        }
+
+        int64_t realTimeUs;
+        if (mFlags & FLAG_REAL_TIME) {
+            CHECK(it->mBuffer->meta()->findInt64("timeUs", &realTimeUs));
+        } else {
+            int64_t mediaTimeUs;
+            CHECK(it->mBuffer->meta()->findInt64("timeUs", &mediaTimeUs));
+
+            realTimeUs = getRealTimeUs(mediaTimeUs, collectNowUs);
+        }
+
+        if (numFrames > 0
+                && realTimeUs >= renderTimes[0] / 1000 + vsyncPeriodUs) {
+            // This frame belongs to a later vsync window; leave it for the
+            // timer postDrainVideoQueue() arms.
+            break;
+        }
+
+        renderTimes[numFrames++] = realTimeUs * 1000;
 
-    if (entry->mBuffer == NULL) {
-        // EOS
+        if (mPaused) {
+            // While paused we only release the frame that was already
+            // scheduled; don't run ahead of the clock.
+            break;
+        }
+    }
+
+    if (numFrames == 0) {
+        // EOS at the head of the queue.
+        QueueEntry *entry = &*mVideoQueue.begin();
 
         notifyEOS(false /* audio */, entry->mFinalResult);
 
@@ -1400,72 +1448,73 @@ void NuPlayer::Renderer::onDrainVideoQueue() {
         return;
     }
 
-    int64_t nowUs = ALooper::GetNowUs();
-    int64_t realTimeUs;
-    int64_t mediaTimeUs = -1;
-    if (mFlags & FLAG_REAL_TIME) {
-        CHECK(entry->mBuffer->meta()->findInt64("timeUs", &realTimeUs));
-    } else {
-        CHECK(entry->mBuffer->meta()->findInt64("timeUs", &mediaTimeUs));
+    mVideoScheduler->scheduleBatch(renderTimes, scheduledTimes, numFrames);
 
-        realTimeUs = getRealTimeUs(mediaTimeUs, nowUs);
-    }
-    realTimeUs = mVideoScheduler->schedule(realTimeUs * 1000) / 1000;
+    for (size_t i = 0; i < numFrames; ++i) {
+        QueueEntry *entry = &*mVideoQueue.begin();
 
-    bool tooLate = false;
+        int64_t nowUs = ALooper::GetNowUs();
+        int64_t realTimeUs = scheduledTimes[i] / 1000;
+        int64_t mediaTimeUs = -1;
+        if (!(mFlags & FLAG_REAL_TIME)) {
+            CHECK(entry->mBuffer->meta()->findInt64("timeUs", &mediaTimeUs));
+        }
 
-    if (!mPaused) {
-        setVideoLateByUs(nowUs - realTimeUs);
-        tooLate = (mVideoLateByUs > 40000);
+        bool tooLate = false;
+
+        if (!mPaused) {
+            setVideoLateByUs(nowUs - realTimeUs);
+            tooLate = (mVideoLateByUs > 40000);
 
-        if (tooLate) {
-            ALOGV("video late by %lld us (%.2f secs)",
-                 (long long)mVideoLateByUs, mVideoLateByUs / 1E6);
+            if (tooLate) {
+                ALOGV("video late by %lld us (%.2f secs)",
+                     (long long)mVideoLateByUs, mVideoLateByUs / 1E6);
+            } else {
+                int64_t mediaUs = 0;
+                mMediaClock->getMediaTime(realTimeUs, &mediaUs);
+                ALOGV("rendering video at media time %.2f secs",
+                        (mFlags & FLAG_REAL_TIME ? realTimeUs :
+                        mediaUs) / 1E6);
+
+                if (!(mFlags & FLAG_REAL_TIME)
+                        && mLastAudioMediaTimeUs != -1
+                        && mediaTimeUs > mLastAudioMediaTimeUs) {
+                    // If audio ends before video, video continues to drive media clock.
+                    // Also smooth out videos >= 10fps.
+                    mMediaClock->updateMaxTimeMedia(mediaTimeUs + kDefaultVideoFrameIntervalUs);
+                }
+            }
         } else {
-            int64_t mediaUs = 0;
-            mMediaClock->getMediaTime(realTimeUs, &mediaUs);
-            ALOGV("rendering video at media time %.2f secs",
-                    (mFlags & FLAG_REAL_TIME ? realTimeUs :
-                    mediaUs) / 1E6);
-
-            if (!(mFlags & FLAG_REAL_TIME)
-                    && mLastAudioMediaTimeUs != -1
-                    && mediaTimeUs > mLastAudioMediaTimeUs) {
-                // If audio ends before video, video continues to drive media clock.
-                // Also smooth out videos >= 10fps.
-                mMediaClock->updateMaxTimeMedia(mediaTimeUs + kDefaultVideoFrameIntervalUs);
+            setVideoLateByUs(0);
+            if (!mVideoSampleReceived && !mHasAudio) {
+                // This will ensure that the first frame after a flush won't be used as anchor
+                // when renderer is in paused state, because resume can happen any time after seek.
+                clearAnchorTime();
             }
         }
-    } else {
-        setVideoLateByUs(0);
-        if (!mVideoSampleReceived && !mHasAudio) {
-            // This will ensure that the first frame after a flush won't be used as anchor
-            // when renderer is in paused state, because resume can happen any time after seek.
-            clearAnchorTime();
-        }
-    }
 
-    // Always render the first video frame while keeping stats on A/V sync.
-    if (!mVideoSampleReceived) {
-        realTimeUs = nowUs;
-        tooLate = false;
-    }
+        // Always render the first video frame while keeping stats on A/V sync.
+        if (!mVideoSampleReceived) {
+            realTimeUs = nowUs;
+            tooLate = false;
+        }
 
-    entry->mNotifyConsumed->setInt64("timestampNs", realTimeUs * 1000LL);
-    entry->mNotifyConsumed->setInt32("render", !tooLate);
-    entry->mNotifyConsumed->post();
-    mVideoQueue.erase(mVideoQueue.begin());
-    entry = NULL;
+        entry->mNotifyConsumed->setInt64("timestampNs", realTimeUs * 1000LL);
+        entry->mNotifyConsumed->setInt32("render", !tooLate);
+        entry->mNotifyConsumed->post();
+        mVideoQueue.erase(mVideoQueue.begin());
+        entry = NULL;
 
-    mVideoSampleReceived = true;
+        mVideoSampleReceived = true;
 
-    if (!mPaused) {
-        if (!mVideoRenderingStarted) {
-            mVideoRenderingStarted = true;
-            notifyVideoRenderingStart();
+        if (!mPaused) {
+            if (!mVideoRenderingStarted) {
+                mVideoRenderingStarted = true;
+                notifyVideoRenderingStart();
+            }
+            Mutex::Autolock autoLock(mLock);
+            notifyIfMediaRenderingStarted_l();
         }
-        Mutex::Autolock autoLock(mLock);
-        notifyIfMediaRenderingStarted_l();
     }
 }
 
@@ -83,6 +83,9 @@ struct NuPlayer::GenericSource : public NuPlayer::Source,
         int64_t seekTimeUs,
         MediaPlayerSeekMode mode = MediaPlayerSeekMode::SEEK_PREVIOUS_SYNC) override;
 
+    virtual bool isSeekRedundant(
+        int64_t seekTimeUs, MediaPlayerSeekMode mode) override;
+
     virtual bool isStreaming() const;
 
     // Modular DRM
@@ -124,6 +127,10 @@ private:
         sp<AnotherPacketSource> mPackets;
     };
 
+    // forwards kWhatReadBuffer posted on a per-track reader looper back to
+    // onMessageReceived, see postReadBuffer()
+    struct ReaderHandler;
+
     Vector<sp<IMediaSource> > mSources;
     Track mAudioTrack;
     int64_t mAudioTimeUs;
@@ -135,6 +142,23 @@ private:
     Track mTimedTextTrack;
 
     BufferingSettings mBufferingSettings;
+
+    // Running estimate of the demuxed stream bitrate and its variance, fed
+    // from the packet queues as they fill. Byte watermarks that the app left
+    // at kNoMark are derived from it: close to mean bitrate x time mark on
+    // steady streams, with headroom growing up to 2x as the measured
+    // variance does, so a VBR spike can't balloon the queues to a multiple
+    // of the intended memory use.
+    struct BitrateEstimate {
+        double mMeanBps = 0.;
+        double mVarBps = 0.;
+        bool mValid = false;
+
+        void update(double bps);
+        double headroomFactor() const;
+    };
+    BitrateEstimate mBitrateEstimate;
+
     int32_t mPrevBufferPercentage;
     int32_t mPollBufferingGeneration;
     bool mSentPauseOnBuffering;
@@ -165,6 +189,15 @@ private:
     sp<MetaData> mFileMeta;
     bool mStarted;
     bool mPreparing;
+
+    // Seek index for scrubbing: the sync sample the last video seek landed
+    // on, and the highest video timestamp proven to have no sync sample
+    // between it and that sync sample (grown as the GOP is read). A new seek
+    // target inside [mLastSeekSyncTimeUs, mNoSyncUntilTimeUs] provably maps
+    // to the same sync sample, see isSeekRedundant().
+    int64_t mLastSeekSyncTimeUs;
+    int64_t mNoSyncUntilTimeUs;
+    bool mSeekCoverageValid;
     int64_t mBitrate;
     uint32_t mPendingReadBufferTypes;
     sp<ABuffer> mGlobalTimedText;
@@ -174,6 +207,18 @@ private:
 
     sp<ALooper> mLooper;
 
+    // Dedicated readahead loopers for the audio and video tracks, so that
+    // extractor I/O on one track can't stall refilling the other. Only
+    // steady-state refills run here; seeks and track changes still read on
+    // |mLooper|. The read locks serialize IMediaSource::read* per track
+    // across the two loopers, since MediaSource is not thread safe.
+    sp<ALooper> mAudioReaderLooper;
+    sp<ALooper> mVideoReaderLooper;
+    sp<ReaderHandler> mAudioReaderHandler;
+    sp<ReaderHandler> mVideoReaderHandler;
+    mutable Mutex mAudioReadLock;
+    mutable Mutex mVideoReadLock;
+
     void resetDataSource();
 
     status_t initFromDataSource();
@@ -221,6 +266,18 @@ private:
     void queueDiscontinuityIfNeeded(
             bool seeking, bool formatChange, media_track_type trackType, Track *track);
 
+    // Effective byte watermark for a buffering mark: |markKB| if the app set
+    // one, otherwise derived from |markUs| and the bitrate estimate; -1 when
+    // no byte bound applies (yet).
+    int64_t getMarkBytes(int markKB, int64_t markUs) const;
+
+    // Returns true when |track| holds enough demuxed data to cross the given
+    // buffering mark, either by time or by the hybrid byte watermark. Also
+    // feeds the bitrate estimate. |finalResult| receives the queue's final
+    // result, as with getBufferedDurationUs().
+    bool isBufferingMarkReached(
+            Track *track, int64_t markUs, int markKB, status_t *finalResult);
+
     void schedulePollBuffering();
     void onPollBuffering();
     void notifyBufferingUpdate(int32_t percentage);
@@ -58,6 +58,14 @@ struct NuPlayer : public AHandler {
 
     void prepareAsync();
 
+    // Warms up the playback pipeline ahead of start(): once the source is
+    // prepared, it is started and decoders are instantiated so the codecs
+    // are configured and the first access units fetched and decoded while
+    // the app is still deciding when (or whether) to play. May be issued
+    // right after prepareAsync(), e.g. speculatively for the next item in a
+    // playlist; start() then only has to create the renderer and attach it.
+    void warmPrepareAsync();
+
     void setVideoSurfaceTextureAsync(
             const sp<IGraphicBufferProducer> &bufferProducer);
 
@@ -135,6 +143,7 @@ private:
     enum {
         kWhatSetDataSource              = '=DaS',
         kWhatPrepare                    = 'prep',
+        kWhatWarmPrepare                = 'wmPr',
         kWhatSetVideoSurface            = '=VSu',
         kWhatSetAudioSink               = '=AuS',
         kWhatMoreDataQueued             = 'more',
@@ -197,6 +206,11 @@ private:
 
     int64_t mPreviousSeekTimeUs;
 
+    // True if the last completed seek ran while paused and nothing has
+    // played since, i.e. the displayed frame is that seek's sync sample.
+    // Only then can a redundant scrub seek be skipped, see kWhatSeek.
+    bool mScrubAnchorValid;
+
     List<sp<Action> > mDeferredActions;
 
     bool mAudioEOS;
@@ -239,6 +253,8 @@ private:
     float mVideoFpsHint;
     bool mStarted;
     bool mPrepared;
+    // pipeline warm-up requested, see warmPrepareAsync()
+    bool mWarmPrepare;
     bool mResetting;
     bool mSourceStarted;
     bool mAudioDecoderError;
@@ -307,6 +323,7 @@ private:
     void onStart(
             int64_t startPositionUs = -1,
             MediaPlayerSeekMode mode = MediaPlayerSeekMode::SEEK_PREVIOUS_SYNC);
+    void onWarmPrepare();
     void onResume();
     void onPause();
 
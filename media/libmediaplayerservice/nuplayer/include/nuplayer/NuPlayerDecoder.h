@@ -80,6 +80,13 @@ private:
 
     List<sp<AMessage> > mPendingInputMessages;
 
+    // Output decoded while no renderer is attached (preroll warm-up); each
+    // entry is a kWhatRenderBuffer reply carrying its output buffer. Drained
+    // to the renderer by onSetRenderer().
+    List<sp<AMessage> > mPendingRendererMessages;
+    sp<AMessage> mPendingAudioFormatChange;
+    bool mPendingQueueEOS;
+
     Vector<sp<MediaCodecBuffer> > mInputBuffers;
     Vector<sp<MediaCodecBuffer> > mOutputBuffers;
     Vector<sp<ABuffer> > mCSDsForCurrentFormat;
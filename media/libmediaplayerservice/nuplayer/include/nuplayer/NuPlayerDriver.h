@@ -54,6 +54,9 @@ struct NuPlayerDriver : public MediaPlayerInterface {
 
     virtual status_t prepare();
     virtual status_t prepareAsync();
+    // speculative pipeline warm-up between prepare and start,
+    // see NuPlayer::warmPrepareAsync()
+    status_t warmPrepare();
     virtual status_t start();
     virtual status_t stop();
     virtual status_t pause();
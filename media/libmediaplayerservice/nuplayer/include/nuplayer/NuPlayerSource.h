@@ -122,6 +122,15 @@ struct NuPlayer::Source : public AHandler {
         return INVALID_OPERATION;
     }
 
+    // Returns true if seeking to |seekTimeUs| with |mode| would land on the
+    // same sync sample as the previous seek, i.e. decoding would produce the
+    // exact frames the previous seek already produced. Lets the player skip
+    // the flush/seek round trip while scrubbing within one sync-sample group.
+    virtual bool isSeekRedundant(
+            int64_t /* seekTimeUs */, MediaPlayerSeekMode /* mode */) {
+        return false;
+    }
+
     virtual bool isRealTime() const {
         return false;
     }
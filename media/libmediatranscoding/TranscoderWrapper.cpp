@@ -59,12 +59,15 @@ static TranscodingErrorCode toTranscodingError(media_status_t status) {
 }
 
 static std::shared_ptr<AMediaFormat> getVideoFormat(
-        const char* originalMime,
+        AMediaFormat* sourceFormat,
         const std::optional<TranscodingVideoTrackFormat>& requestedFormat) {
     if (requestedFormat == std::nullopt) {
         return nullptr;
     }
 
+    const char* originalMime = nullptr;
+    AMediaFormat_getString(sourceFormat, AMEDIAFORMAT_KEY_MIME, &originalMime);
+
     std::shared_ptr<AMediaFormat> format =
             std::shared_ptr<AMediaFormat>(AMediaFormat_new(), &AMediaFormat_delete);
     bool changed = false;
@@ -78,8 +81,19 @@ static std::shared_ptr<AMediaFormat> getVideoFormat(
         changed = true;
     }
     if (requestedFormat->bitrateBps > 0) {
-        AMediaFormat_setInt32(format.get(), AMEDIAFORMAT_KEY_BIT_RATE, requestedFormat->bitrateBps);
-        changed = true;
+        // Passthrough negotiation: if the codec is kept and the source bitrate is already at or
+        // below the requested bitrate, re-encoding can only lose quality. Leave the format
+        // unchanged so pure trims and container rewrites go through sample copy instead of a
+        // decode/encode round trip. If the source bitrate is unknown, be conservative and
+        // re-encode to guarantee the requested bitrate.
+        int32_t sourceBitrateBps = 0;
+        if (changed || !AMediaFormat_getInt32(sourceFormat, AMEDIAFORMAT_KEY_BIT_RATE,
+                                              &sourceBitrateBps) ||
+            sourceBitrateBps > requestedFormat->bitrateBps) {
+            AMediaFormat_setInt32(format.get(), AMEDIAFORMAT_KEY_BIT_RATE,
+                                  requestedFormat->bitrateBps);
+            changed = true;
+        }
     }
     // TODO: translate other fields from requestedFormat to the format for MediaTranscoder.
     // Also need to determine more settings to expose in TranscodingVideoTrackFormat.
@@ -442,7 +456,7 @@ media_status_t TranscoderWrapper::setupTranscoder(
         AMediaFormat_getString(trackFormats[i].get(), AMEDIAFORMAT_KEY_MIME, &mime);
 
         if (!strncmp(mime, "video/", 6)) {
-            format = getVideoFormat(mime, request.requestedVideoTrackFormat);
+            format = getVideoFormat(trackFormats[i].get(), request.requestedVideoTrackFormat);
 
             mSrcFormat = trackFormats[i];
             mDstFormat = format;
@@ -461,17 +461,30 @@ void TranscodingSessionController::setSessionState_l(Session* session, Session::
         return;
     }
 
-    // Currently we only have 1 running session, and we always put the previous
-    // session in non-running state before we run the new session, so it's okay
-    // to start/stop the watchdog here. If this assumption changes, we need to
-    // track the number of running sessions and start/stop watchdog based on that.
+    // The watchdog runs while at least one session is running. It's armed with the first
+    // session that starts running; heartbeats from any running session keep it alive, which
+    // is sufficient since all concurrent sessions share the same process and codec stack.
     if (isRunning) {
+        ++mRunningSessionCount;
+        // No-op if the watchdog is already active; also re-arms it after a timeout
+        // deactivated it while other sessions are still running.
         mWatchdog->start(session->key);
     } else {
-        mWatchdog->stop();
+        if (--mRunningSessionCount == 0) {
+            mWatchdog->stop();
+        }
     }
 }
 
+std::shared_ptr<TranscoderInterface> TranscodingSessionController::transcoderForSession_l(
+        const SessionKeyType& sessionKey) {
+    auto it = mAuxTranscoders.find(sessionKey);
+    if (it != mAuxTranscoders.end()) {
+        return it->second;
+    }
+    return mTranscoder;
+}
+
 void TranscodingSessionController::Session::setState(Session::State newState) {
     if (state == newState) {
         return;
@@ -523,7 +536,8 @@ void TranscodingSessionController::updateCurrentSession_l() {
         // cases: 1) Top session is changing to another session, or 2) Top session is
         // changing to null (which means we should be globally paused).
         if (curSession != nullptr && curSession->getState() == Session::RUNNING) {
-            mTranscoder->pause(curSession->key.first, curSession->key.second);
+            transcoderForSession_l(curSession->key)
+                    ->pause(curSession->key.first, curSession->key.second);
             setSessionState_l(curSession, Session::PAUSED);
         }
 
@@ -560,13 +574,97 @@ void TranscodingSessionController::updateCurrentSession_l() {
                                topSession->callingUid, topSession->callback.lock());
             setSessionState_l(topSession, Session::RUNNING);
         } else if (topSession->getState() == Session::PAUSED) {
-            mTranscoder->resume(topSession->key.first, topSession->key.second, topSession->request,
-                                topSession->callingUid, topSession->callback.lock());
+            transcoderForSession_l(topSession->key)
+                    ->resume(topSession->key.first, topSession->key.second, topSession->request,
+                             topSession->callingUid, topSession->callback.lock());
             setSessionState_l(topSession, Session::RUNNING);
         }
         break;
     }
     mCurrentSession = topSession;
+
+    updateConcurrentSessions_l();
+}
+
+/*
+ * Schedules auxiliary sessions next to the top session when concurrent scheduling is
+ * enabled. Only offline sessions are eligible for auxiliary slots; the top session always
+ * keeps the primary transcoder so real-time work is unaffected. On thermal throttling or
+ * resource loss all auxiliary sessions are paused along with the top session.
+ */
+void TranscodingSessionController::updateConcurrentSessions_l() {
+    if (mConfig.maxConcurrentSessions <= 1) {
+        return;
+    }
+
+    const bool globallyPaused = (mResourcePolicy != nullptr && mResourceLost) ||
+                                (mThermalPolicy != nullptr && mThermalThrottling);
+    if (globallyPaused) {
+        for (auto& entry : mAuxTranscoders) {
+            Session* session = &mSessionMap[entry.first];
+            if (session != mCurrentSession && session->getState() == Session::RUNNING) {
+                entry.second->pause(entry.first.first, entry.first.second);
+                setSessionState_l(session, Session::PAUSED);
+            }
+        }
+        return;
+    }
+
+    // Resume auxiliary sessions that were previously throttled back.
+    for (auto& entry : mAuxTranscoders) {
+        if (mRunningSessionCount >= mConfig.maxConcurrentSessions) {
+            return;
+        }
+        Session* session = &mSessionMap[entry.first];
+        if (session != mCurrentSession && session->getState() == Session::PAUSED) {
+            entry.second->resume(entry.first.first, entry.first.second, session->request,
+                                 session->callingUid, session->callback.lock());
+            setSessionState_l(session, Session::RUNNING);
+        }
+    }
+
+    // Start additional offline sessions, each on its own transcoder instance. Iterate over a
+    // snapshot since dropping an out-of-quota session mutates the queue.
+    std::vector<SessionKeyType> offlineSessions(mSessionQueues[OFFLINE_UID].begin(),
+                                                mSessionQueues[OFFLINE_UID].end());
+    for (const SessionKeyType& sessionKey : offlineSessions) {
+        if (mRunningSessionCount >= mConfig.maxConcurrentSessions) {
+            return;
+        }
+        Session* session = &mSessionMap[sessionKey];
+        if (session == mCurrentSession || session->getState() != Session::NOT_STARTED) {
+            continue;
+        }
+
+        // Check if at least one client has quota to start the session.
+        bool keepForClient = false;
+        for (uid_t uid : session->allClientUids) {
+            if (mPacer->onSessionStarted(uid, session->callingUid)) {
+                keepForClient = true;
+                // DO NOT break here, because book-keeping still needs to happen
+                // for the other uids.
+            }
+        }
+        if (!keepForClient) {
+            auto clientCallback = session->callback.lock();
+            if (clientCallback != nullptr) {
+                clientCallback->onTranscodingFailed(sessionKey.second,
+                                                    TranscodingErrorCode::kDroppedByService);
+            }
+            removeSession_l(sessionKey, Session::DROPPED_BY_PACER);
+            continue;
+        }
+
+        std::shared_ptr<TranscoderInterface> transcoder = mTranscoderFactory(shared_from_this());
+        if (transcoder == nullptr) {
+            ALOGE("%s: failed to create auxiliary transcoder", __FUNCTION__);
+            return;
+        }
+        mAuxTranscoders.emplace(sessionKey, transcoder);
+        transcoder->start(sessionKey.first, sessionKey.second, session->request,
+                          session->callingUid, session->callback.lock());
+        setSessionState_l(session, Session::RUNNING);
+    }
 }
 
 void TranscodingSessionController::addUidToSession_l(uid_t clientUid,
@@ -653,6 +751,9 @@ void TranscodingSessionController::removeSession_l(
         mCurrentSession = nullptr;
     }
 
+    // Release the session's auxiliary transcoder, if any.
+    mAuxTranscoders.erase(sessionKey);
+
     setSessionState_l(&mSessionMap[sessionKey], finalState);
 
     // We can use onSessionCompleted() even for CANCELLED, because runningTime is
@@ -801,7 +902,7 @@ bool TranscodingSessionController::cancel(ClientIdType clientId, SessionIdType s
         // the transcoder to discard any states for the session, otherwise the states may
         // never be discarded.
         if (mSessionMap[*it].getState() != Session::NOT_STARTED) {
-            mTranscoder->stop(it->first, it->second);
+            transcoderForSession_l(*it)->stop(it->first, it->second);
         }
 
         // Remove the session.
@@ -961,10 +1062,18 @@ void TranscodingSessionController::onError(ClientIdType clientId, SessionIdType
         if (err == TranscodingErrorCode::kWatchdogTimeout) {
             // Abandon the transcoder, as its handler thread might be stuck in some call to
             // MediaTranscoder altogether, and may not be able to handle any new tasks.
-            mTranscoder->stop(clientId, sessionId, true /*abandon*/);
-            // Clear the last ref count before we create new transcoder.
-            mTranscoder = nullptr;
-            mTranscoder = mTranscoderFactory(shared_from_this());
+            auto auxIt = mAuxTranscoders.find(sessionKey);
+            if (auxIt != mAuxTranscoders.end()) {
+                // Auxiliary transcoders are per-session; drop this one and a fresh instance
+                // will be created for the next auxiliary session.
+                auxIt->second->stop(clientId, sessionId, true /*abandon*/);
+                mAuxTranscoders.erase(auxIt);
+            } else {
+                mTranscoder->stop(clientId, sessionId, true /*abandon*/);
+                // Clear the last ref count before we create new transcoder.
+                mTranscoder = nullptr;
+                mTranscoder = mTranscoderFactory(shared_from_this());
+            }
         }
 
         {
@@ -1082,7 +1191,7 @@ void TranscodingSessionController::onUidGone(uid_t goneUid) {
         // the transcoder to discard any states for the session, otherwise the states may
         // never be discarded.
         if (mSessionMap[*it].getState() != Session::NOT_STARTED) {
-            mTranscoder->stop(it->first, it->second);
+            transcoderForSession_l(*it)->stop(it->first, it->second);
         }
 
         {
@@ -108,6 +108,11 @@ private:
         int32_t pacerBurstCountQuota = 10;
         // Maximum allowed back-to-back running time.
         int32_t pacerBurstTimeQuotaSeconds = 120;  // 2-min
+        // Maximum number of sessions allowed to run concurrently. When greater than 1,
+        // offline sessions beyond the top session are scheduled onto their own transcoder
+        // instances so batch transcodes can use idle codec engines. All concurrent sessions
+        // are throttled back together on thermal or resource events.
+        int32_t maxConcurrentSessions = 1;
     };
 
     struct Session {
@@ -178,6 +183,13 @@ private:
     std::shared_ptr<Watchdog> mWatchdog;
     std::shared_ptr<Pacer> mPacer;
 
+    // Transcoder instances for auxiliary sessions running concurrently with the top
+    // session (only used when mConfig.maxConcurrentSessions > 1). A session started on
+    // an auxiliary transcoder stays on it for its whole lifetime.
+    std::map<SessionKeyType, std::shared_ptr<TranscoderInterface>> mAuxTranscoders;
+    // Number of sessions currently in RUNNING state, maintained by setSessionState_l.
+    int32_t mRunningSessionCount = 0;
+
     // Only allow MediaTranscodingService and unit tests to instantiate.
     TranscodingSessionController(const TranscoderFactoryType& transcoderFactory,
                                  const std::shared_ptr<UidPolicyInterface>& uidPolicy,
@@ -188,6 +200,8 @@ private:
     void dumpSession_l(const Session& session, String8& result, bool closedSession = false);
     Session* getTopSession_l();
     void updateCurrentSession_l();
+    void updateConcurrentSessions_l();
+    std::shared_ptr<TranscoderInterface> transcoderForSession_l(const SessionKeyType& sessionKey);
     void addUidToSession_l(uid_t uid, const SessionKeyType& sessionKey);
     void removeSession_l(const SessionKeyType& sessionKey, Session::State finalState,
                          const std::shared_ptr<std::function<bool(uid_t uid)>>& keepUid = nullptr);
@@ -1344,4 +1344,57 @@ TEST_F(TranscodingSessionControllerTest, TestTranscoderPacerSelfUid) {
                                12 /*expectedSuccess*/);
 }
 
+TEST_F(TranscodingSessionControllerTest, TestConcurrentOfflineSessions) {
+    ALOGD("TestConcurrentOfflineSessions");
+
+    // Recreate the controller with concurrent scheduling enabled. The factory hands out the
+    // same test transcoder for auxiliary sessions, which is fine since it only logs events.
+    TranscodingSessionController::ControllerConfig config = {
+            .pacerBurstThresholdMs = 500,
+            .pacerBurstCountQuota = 10,
+            .pacerBurstTimeQuotaSeconds = 3,
+            .maxConcurrentSessions = 2,
+    };
+    mController.reset(new TranscodingSessionController(
+            [this](const std::shared_ptr<TranscoderCallbackInterface>& /*cb*/) {
+                mTranscoder->onCreated();
+                return mTranscoder;
+            },
+            mUidPolicy, mResourcePolicy, mThermalPolicy, &config));
+    mUidPolicy->setCallback(mController);
+
+    // Submit offline session SESSION(0), should start immediately as the top session.
+    mController->submit(CLIENT(0), SESSION(0), UID(0), UID(0), mOfflineRequest, mClientCallback0);
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Start(CLIENT(0), SESSION(0)));
+
+    // Submit offline session SESSION(1), should start concurrently on an auxiliary slot.
+    mController->submit(CLIENT(0), SESSION(1), UID(0), UID(0), mOfflineRequest, mClientCallback0);
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Start(CLIENT(0), SESSION(1)));
+
+    // Submit offline session SESSION(2), should be queued since the cap is reached.
+    mController->submit(CLIENT(0), SESSION(2), UID(0), UID(0), mOfflineRequest, mClientCallback0);
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::NoEvent);
+
+    // Thermal throttling should pause both running sessions.
+    mController->onThrottlingStarted();
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Pause(CLIENT(0), SESSION(0)));
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Pause(CLIENT(0), SESSION(1)));
+
+    // When throttling stops, both sessions should resume.
+    mController->onThrottlingStopped();
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Resume(CLIENT(0), SESSION(0)));
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Resume(CLIENT(0), SESSION(1)));
+
+    // Finishing a session should free its slot for the queued session.
+    mController->onFinish(CLIENT(0), SESSION(0));
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Finished(CLIENT(0), SESSION(0)));
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Start(CLIENT(0), SESSION(2)));
+
+    mController->onFinish(CLIENT(0), SESSION(1));
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Finished(CLIENT(0), SESSION(1)));
+
+    mController->onFinish(CLIENT(0), SESSION(2));
+    EXPECT_EQ(mTranscoder->popEvent(), TestTranscoder::Finished(CLIENT(0), SESSION(2)));
+}
+
 }  // namespace android
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace android {
 
@@ -53,6 +54,7 @@ MediaSampleReaderNDK::MediaSampleReaderNDK(AMediaExtractor* extractor)
       : mExtractor(extractor), mTrackCount(AMediaExtractor_getTrackCount(mExtractor)) {
     if (mTrackCount > 0) {
         mTrackCursors.resize(mTrackCount);
+        mTrackCaches.resize(mTrackCount);
     }
 }
 
@@ -63,6 +65,33 @@ MediaSampleReaderNDK::~MediaSampleReaderNDK() {
 }
 
 void MediaSampleReaderNDK::advanceTrack_l(int trackIndex) {
+    SampleCursor& cursor = mTrackCursors[trackIndex];
+    TrackCache& cache = mTrackCaches[trackIndex];
+
+    if (!cache.samples.empty()) {
+        // The consumed sample came out of the readahead cache so the extractor does not need to
+        // move. Keep the cursor coherent with the cache since the extractor is ahead of it.
+        CachedSample& consumed = cache.samples.front();
+        cursor.previous.set(consumed.index, consumed.info.presentationTimeUs);
+        cache.totalBytes -= consumed.info.size;
+        recycleBuffer_l(std::move(consumed.buffer));
+        cache.samples.pop_front();
+
+        if (!cache.samples.empty()) {
+            const CachedSample& next = cache.samples.front();
+            cursor.current.set(next.index, next.info.presentationTimeUs);
+        } else {
+            cursor.current = cursor.next;
+        }
+        cursor.next.reset();
+
+        if (mEnforceSequentialAccess) {
+            // Draining below the budget may unpark the extractor; refill and signal waiters.
+            pumpReadahead_l();
+        }
+        return;
+    }
+
     if (!mEnforceSequentialAccess) {
         // Note: Positioning the extractor before advancing the track is needed for two reasons:
         // 1. To enable multiple advances without explicitly letting the extractor catch up.
@@ -70,21 +99,17 @@ void MediaSampleReaderNDK::advanceTrack_l(int trackIndex) {
         (void)moveToTrack_l(trackIndex);
     }
 
-    SampleCursor& cursor = mTrackCursors[trackIndex];
+    // Record the consumed sample so the readahead pump never caches it again.
+    if (cursor.current.isSet && cache.nextIndexToCache <= cursor.current.index) {
+        cache.nextIndexToCache = cursor.current.index + 1;
+    }
+
     cursor.previous = cursor.current;
     cursor.current = cursor.next;
     cursor.next.reset();
 
     if (mEnforceSequentialAccess && trackIndex == mExtractorTrackIndex) {
-        while (advanceExtractor_l()) {
-            SampleCursor& cursor = mTrackCursors[mExtractorTrackIndex];
-            if (cursor.current.isSet && cursor.current.index == mExtractorSampleIndex) {
-                if (mExtractorTrackIndex != trackIndex) {
-                    mTrackSignals[mExtractorTrackIndex].notify_all();
-                }
-                break;
-            }
-        }
+        pumpReadahead_l();
     }
     return;
 }
@@ -177,21 +202,115 @@ media_status_t MediaSampleReaderNDK::moveToTrack_l(int trackIndex) {
     return moveToSample_l(mTrackCursors[trackIndex].current, trackIndex);
 }
 
-media_status_t MediaSampleReaderNDK::waitForTrack_l(int trackIndex,
-                                                    std::unique_lock<std::mutex>& lockHeld) {
-    while (trackIndex != mExtractorTrackIndex && !mEosReached && mEnforceSequentialAccess) {
-        mTrackSignals[trackIndex].wait(lockHeld);
+bool MediaSampleReaderNDK::cacheCurrentSample_l() {
+    const int trackIndex = mExtractorTrackIndex;
+    if (mTrackSignals.find(trackIndex) == mTrackSignals.end()) {
+        // Unselected tracks are skipped over.
+        return true;
+    }
+
+    TrackCache& cache = mTrackCaches[trackIndex];
+    if (mExtractorSampleIndex < cache.nextIndexToCache) {
+        // The sample was already cached or consumed.
+        return true;
+    } else if (!cache.samples.empty() && (cache.totalBytes >= kTrackReadaheadBudgetBytes ||
+                                          cache.samples.size() >= kTrackReadaheadMaxSamples)) {
+        // At budget; the track's consumer needs to drain the cache before the extractor can
+        // move past this sample.
+        return false;
     }
 
-    if (mEosReached) {
-        return AMEDIA_ERROR_END_OF_STREAM;
+    const ssize_t sampleSize = AMediaExtractor_getSampleSize(mExtractor);
+    CachedSample sample;
+    ssize_t bytesRead = -1;
+    if (sampleSize >= 0) {
+        sample.buffer = obtainBuffer_l(static_cast<size_t>(sampleSize));
+        bytesRead = AMediaExtractor_readSampleData(mExtractor, sample.buffer.data(),
+                                                   sample.buffer.size());
+    }
+    if (bytesRead < sampleSize || sampleSize < 0) {
+        LOG(ERROR) << "Unable to read sample into cache, " << bytesRead << " vs " << sampleSize;
+        recycleBuffer_l(std::move(sample.buffer));
+        mCachedReadError = AMEDIA_ERROR_UNKNOWN;
+        for (auto it = mTrackSignals.begin(); it != mTrackSignals.end(); ++it) {
+            it->second.notify_all();
+        }
+        return false;
     }
 
-    if (!mEnforceSequentialAccess) {
-        return moveToTrack_l(trackIndex);
+    sample.info.presentationTimeUs = AMediaExtractor_getSampleTime(mExtractor);
+    sample.info.flags = AMediaExtractor_getSampleFlags(mExtractor);
+    sample.info.size = static_cast<size_t>(sampleSize);
+    sample.index = mExtractorSampleIndex;
+
+    cache.totalBytes += sample.info.size;
+    cache.nextIndexToCache = mExtractorSampleIndex + 1;
+    cache.samples.push_back(std::move(sample));
+
+    if (cache.samples.size() == 1) {
+        // The track's next unconsumed sample is now the front of its cache; keep the cursor
+        // coherent and wake a consumer that may be waiting for it.
+        SampleCursor& cursor = mTrackCursors[trackIndex];
+        const CachedSample& front = cache.samples.front();
+        if (!cursor.current.isSet) {
+            cursor.current.set(front.index, front.info.presentationTimeUs);
+        }
+        mTrackSignals[trackIndex].notify_all();
+    }
+    return true;
+}
+
+void MediaSampleReaderNDK::pumpReadahead_l() {
+    while (!mEosReached && mCachedReadError == AMEDIA_OK) {
+        if (mExtractorTrackIndex >= 0 && !cacheCurrentSample_l()) {
+            // The extractor is parked on a sample whose track cache is at its budget. The
+            // track's consumer resumes the pump when it drains the cache.
+            break;
+        }
+        if (!advanceExtractor_l()) {
+            break;
+        }
     }
+}
 
-    return AMEDIA_OK;
+media_status_t MediaSampleReaderNDK::ensureCachedSample_l(int trackIndex,
+                                                          std::unique_lock<std::mutex>& lockHeld) {
+    for (;;) {
+        if (!mTrackCaches[trackIndex].samples.empty()) {
+            return AMEDIA_OK;
+        } else if (mCachedReadError != AMEDIA_OK) {
+            return mCachedReadError;
+        } else if (mEosReached) {
+            return AMEDIA_ERROR_END_OF_STREAM;
+        } else if (!mEnforceSequentialAccess) {
+            // Sequential access was turned off while waiting; seek the extractor directly.
+            return moveToTrack_l(trackIndex);
+        }
+
+        pumpReadahead_l();
+
+        if (mTrackCaches[trackIndex].samples.empty() && !mEosReached &&
+            mCachedReadError == AMEDIA_OK && mEnforceSequentialAccess) {
+            // The extractor is parked on a sample that another track needs to consume first.
+            mTrackSignals[trackIndex].wait(lockHeld);
+        }
+    }
+}
+
+std::vector<uint8_t> MediaSampleReaderNDK::obtainBuffer_l(size_t size) {
+    std::vector<uint8_t> buffer;
+    if (!mBufferPool.empty()) {
+        buffer = std::move(mBufferPool.back());
+        mBufferPool.pop_back();
+    }
+    buffer.resize(size);
+    return buffer;
+}
+
+void MediaSampleReaderNDK::recycleBuffer_l(std::vector<uint8_t>&& buffer) {
+    if (mBufferPool.size() < kMaxPooledBuffers) {
+        mBufferPool.push_back(std::move(buffer));
+    }
 }
 
 media_status_t MediaSampleReaderNDK::primeExtractorForTrack_l(
@@ -205,8 +324,8 @@ media_status_t MediaSampleReaderNDK::primeExtractorForTrack_l(
                                                         AMediaExtractor_getSampleTime(mExtractor));
     }
 
-    if (mEnforceSequentialAccess) {
-        return waitForTrack_l(trackIndex, lockHeld);
+    if (mEnforceSequentialAccess || !mTrackCaches[trackIndex].samples.empty()) {
+        return ensureCachedSample_l(trackIndex, lockHeld);
     } else {
         return moveToTrack_l(trackIndex);
     }
@@ -401,9 +520,14 @@ media_status_t MediaSampleReaderNDK::getSampleInfoForTrack(int trackIndex, Media
 
     media_status_t status = primeExtractorForTrack_l(trackIndex, lock);
     if (status == AMEDIA_OK) {
-        info->presentationTimeUs = AMediaExtractor_getSampleTime(mExtractor);
-        info->flags = AMediaExtractor_getSampleFlags(mExtractor);
-        info->size = AMediaExtractor_getSampleSize(mExtractor);
+        const TrackCache& cache = mTrackCaches[trackIndex];
+        if (!cache.samples.empty()) {
+            *info = cache.samples.front().info;
+        } else {
+            info->presentationTimeUs = AMediaExtractor_getSampleTime(mExtractor);
+            info->flags = AMediaExtractor_getSampleFlags(mExtractor);
+            info->size = AMediaExtractor_getSampleSize(mExtractor);
+        }
     } else if (status == AMEDIA_ERROR_END_OF_STREAM) {
         info->presentationTimeUs = 0;
         info->flags = SAMPLE_FLAG_END_OF_STREAM;
@@ -433,6 +557,20 @@ media_status_t MediaSampleReaderNDK::readSampleDataForTrack(int trackIndex, uint
         return status;
     }
 
+    TrackCache& cache = mTrackCaches[trackIndex];
+    if (!cache.samples.empty()) {
+        const CachedSample& sample = cache.samples.front();
+        if (bufferSize < sample.info.size) {
+            LOG(ERROR) << "Buffer is too small for sample, " << bufferSize << " vs "
+                       << sample.info.size;
+            return AMEDIA_ERROR_INVALID_PARAMETER;
+        }
+
+        memcpy(buffer, sample.buffer.data(), sample.info.size);
+        advanceTrack_l(trackIndex);
+        return AMEDIA_OK;
+    }
+
     ssize_t sampleSize = AMediaExtractor_getSampleSize(mExtractor);
     if (bufferSize < sampleSize) {
         LOG(ERROR) << "Buffer is too small for sample, " << bufferSize << " vs " << sampleSize;
@@ -20,6 +20,7 @@
 #include <media/MediaSampleReader.h>
 #include <media/NdkMediaExtractor.h>
 
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -30,6 +31,11 @@ namespace android {
 /**
  * MediaSampleReaderNDK is a concrete implementation of the MediaSampleReader interface based on the
  * media NDK extractor.
+ *
+ * When sequential access is enforced the reader batches contiguous samples per track into pooled
+ * readahead caches as the extractor advances over the combined timeline. Tracks are then served
+ * from their caches so that track consumers can run in parallel on a single forward pass over the
+ * source instead of being interleaved sample by sample on the shared extractor cursor.
  */
 class MediaSampleReaderNDK : public MediaSampleReader {
 public:
@@ -89,6 +95,27 @@ private:
         SamplePosition next;
     };
 
+    /**
+     * CachedSample holds one sample read ahead of its consumer: its metadata, its global sample
+     * index and its payload in a buffer recycled through the reader's buffer pool.
+     */
+    struct CachedSample {
+        MediaSampleInfo info;
+        uint64_t index = 0;
+        std::vector<uint8_t> buffer;
+    };
+
+    /**
+     * TrackCache is the per-track readahead queue. Samples are appended in extractor order and
+     * consumed front to back. nextIndexToCache tracks the first sample index that has neither been
+     * cached nor consumed, so that backward extractor seeks never duplicate samples in the cache.
+     */
+    struct TrackCache {
+        std::deque<CachedSample> samples;
+        size_t totalBytes = 0;
+        uint64_t nextIndexToCache = 0;
+    };
+
     /**
      * Creates a new MediaSampleReaderNDK object from an AMediaExtractor. The extractor needs to be
      * initialized with a valid data source before attempting to create a MediaSampleReaderNDK.
@@ -112,11 +139,33 @@ private:
     /** Moves the extractor to the next sample of the specified track. */
     media_status_t moveToTrack_l(int trackIndex);
 
-    /** In sequential mode, waits for the extractor to reach the next sample for the track. */
-    media_status_t waitForTrack_l(int trackIndex, std::unique_lock<std::mutex>& lockHeld);
+    /**
+     * Reads the sample the extractor currently points to into its track's readahead cache.
+     * Returns true if the extractor is free to advance past the sample, i.e. the sample was
+     * cached now or earlier, or belongs to an unselected track. Returns false if the track's
+     * cache is at its readahead budget or the sample could not be read.
+     */
+    bool cacheCurrentSample_l();
 
     /**
-     * Ensures the extractor is ready for the next sample of the track regardless of access mode.
+     * In sequential mode, advances the extractor on a single forward pass, batching the samples
+     * it passes into the per-track readahead caches, until it reaches end of stream or is parked
+     * on a sample whose track cache is at its budget. Waiting tracks are signaled as their caches
+     * become non-empty.
+     */
+    void pumpReadahead_l();
+
+    /** Blocks until the track's readahead cache holds at least one sample, or end of stream. */
+    media_status_t ensureCachedSample_l(int trackIndex, std::unique_lock<std::mutex>& lockHeld);
+
+    /** Takes a buffer of the requested size from the pool, allocating if the pool is empty. */
+    std::vector<uint8_t> obtainBuffer_l(size_t size);
+
+    /** Returns a cache buffer to the pool for reuse. */
+    void recycleBuffer_l(std::vector<uint8_t>&& buffer);
+
+    /**
+     * Ensures the next sample of the track is ready to be served regardless of access mode.
      */
     media_status_t primeExtractorForTrack_l(int trackIndex, std::unique_lock<std::mutex>& lockHeld);
 
@@ -135,6 +184,23 @@ private:
 
     // Samples cursor for each track in the file.
     std::vector<SampleCursor> mTrackCursors;
+
+    // Per-track readahead budget. A track's cache always admits at least one sample so that
+    // samples larger than the budget cannot stall the pump indefinitely.
+    static constexpr size_t kTrackReadaheadBudgetBytes = 2 * 1024 * 1024;
+    static constexpr size_t kTrackReadaheadMaxSamples = 64;
+
+    // Upper bound on the number of idle buffers retained for reuse.
+    static constexpr size_t kMaxPooledBuffers = 32;
+
+    // Readahead cache for each track in the file.
+    std::vector<TrackCache> mTrackCaches;
+
+    // Pool of idle cache buffers, recycled to avoid per-sample allocations.
+    std::vector<std::vector<uint8_t>> mBufferPool;
+
+    // Sticky error from a failed readahead, reported to all tracks.
+    media_status_t mCachedReadError = AMEDIA_OK;
 };
 
 }  // namespace android
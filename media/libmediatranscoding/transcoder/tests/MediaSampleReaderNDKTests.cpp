@@ -315,6 +315,45 @@ TEST_F(MediaSampleReaderNDKTests, TestSequentialSampleAccess) {
     compareSamples(tester.getSamples());
 }
 
+/**
+ * Reads samples from all tracks in lockstep from a single thread in sequential mode. This pattern
+ * relies on the readahead caches since the extractor itself can only serve the track it is
+ * positioned on.
+ */
+TEST_F(MediaSampleReaderNDKTests, TestSequentialSingleThreadInterleaved) {
+    LOG(DEBUG) << "TestSequentialSingleThreadInterleaved Starts";
+    initExtractorSamples();
+
+    static constexpr int kInterleavedSampleCount = 16;
+    for (int trackIndex = 0; trackIndex < mTrackCount; ++trackIndex) {
+        ASSERT_GT((int)mExtractorSamples[trackIndex].size(), kInterleavedSampleCount);
+    }
+
+    SampleAccessTester tester{mSourceFd, mFileSize};
+    tester.setEnforceSequentialAccess(true);
+
+    MediaSampleInfo info;
+    for (int i = 0; i < kInterleavedSampleCount; ++i) {
+        for (int trackIndex = 0; trackIndex < mTrackCount; ++trackIndex) {
+            media_status_t status = tester.mSampleReader->getSampleInfoForTrack(trackIndex, &info);
+            EXPECT_EQ(status, AMEDIA_OK);
+
+            auto buffer = std::make_unique<uint8_t[]>(info.size);
+            status = tester.mSampleReader->readSampleDataForTrack(trackIndex, buffer.get(),
+                                                                  info.size);
+            EXPECT_EQ(status, AMEDIA_OK);
+
+            tester.mSamples[trackIndex].emplace_back(info.flags, info.presentationTimeUs, info.size,
+                                                     buffer.get());
+        }
+    }
+
+    // Drain the remainder of all tracks in parallel and verify sample integrity.
+    tester.readSamplesAsync(SAMPLE_COUNT_ALL);
+    tester.waitForTracks();
+    compareSamples(tester.getSamples());
+}
+
 /** Reads all samples from one track in parallel mode before switching to sequential mode. */
 TEST_F(MediaSampleReaderNDKTests, TestMixedSampleAccessTrackEOS) {
     LOG(DEBUG) << "TestMixedSampleAccessTrackEOS Starts";
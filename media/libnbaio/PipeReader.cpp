@@ -76,6 +76,64 @@ ssize_t PipeReader::read(void *buffer, size_t count)
     return actual;
 }
 
+ssize_t PipeReader::readVia(readVia_t via, size_t total, void *user, size_t block)
+{
+    if (CC_UNLIKELY(!mNegotiated)) {
+        return NEGOTIATE;
+    }
+    if (CC_UNLIKELY(block == 0)) {
+        block = ~0;
+    }
+    const size_t frameSize = Format_frameSize(mFormat);
+    size_t accumulator = 0;
+    while (accumulator < total) {
+        size_t count = total - accumulator;
+        if (CC_LIKELY(count > block)) {
+            count = block;
+        }
+        // obtain a window directly into the pipe buffer, avoiding the bounce buffer
+        // that the default NBAIO_Source::readVia() would copy through
+        audio_utils_iovec iovec[2];
+        size_t lost;
+        ssize_t avail = mFifoReader.obtain(iovec, count, NULL /*timeout*/, &lost);
+        if (avail == -EOVERFLOW || lost > 0) {
+            mFramesOverrun += lost;
+            ++mOverruns;
+            avail = OVERRUN;
+        }
+        if (avail <= 0) {
+            return accumulator > 0 ? (ssize_t) accumulator : avail;
+        }
+        // present each contiguous part of the window to the callback in place
+        size_t consumed = 0;
+        ssize_t ret = 0;
+        for (int i = 0; i < 2 && iovec[i].mLength > 0; ++i) {
+            ret = via(user, (char *) mPipe.mBuffer + iovec[i].mOffset * frameSize,
+                    iovec[i].mLength);
+            if (ret <= 0) {
+                break;
+            }
+            ALOG_ASSERT((size_t) ret <= iovec[i].mLength);
+            consumed += (size_t) ret;
+            if ((size_t) ret < iovec[i].mLength) {
+                break;
+            }
+        }
+        // advance only this reader's cursor; other readers of the same Pipe are unaffected
+        mFifoReader.release(consumed);
+        if (consumed == 0) {
+            return accumulator > 0 ? (ssize_t) accumulator : ret;
+        }
+        mFramesRead += consumed;
+        accumulator += consumed;
+        if (consumed < (size_t) avail) {
+            // the callback did not consume the whole window, so don't offer more
+            break;
+        }
+    }
+    return accumulator;
+}
+
 ssize_t PipeReader::flush()
 {
     if (CC_UNLIKELY(!mNegotiated)) {
@@ -25,6 +25,9 @@ namespace android {
 // Pipe is multi-thread safe for readers (see PipeReader), but safe for only a single writer thread.
 // It cannot UNDERRUN on write, unless we allow designation of a primary reader that provides the
 // time-base. Readers can be added and removed dynamically, and it's OK to have no readers.
+// Since each reader tracks its own cursor into the shared ring, several consumers
+// (e.g. an echo reference and a sound trigger sidechain) can tap the same stream without
+// duplicating buffers through separate pipes; see PipeReader::readVia() for zero-copy access.
 class Pipe : public NBAIO_Sink {
 
     friend class PipeReader;
@@ -47,6 +47,12 @@ public:
 
     virtual ssize_t read(void *buffer, size_t count);
 
+    // Zero-copy variant: presents the ring buffer contents to the callback in place,
+    // rather than through the intermediate buffer of the default implementation.
+    // Multiple PipeReaders can tap the same Pipe this way, as each reader only
+    // advances its own cursor.
+    virtual ssize_t readVia(readVia_t via, size_t total, void *user, size_t block);
+
     virtual ssize_t flush();
 
     // NBAIO_Source end
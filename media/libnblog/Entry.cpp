@@ -20,6 +20,7 @@
 #include <memory>
 #include <stddef.h>
 #include <stdint.h>
+#include <unistd.h>
 
 #include <audio_utils/fifo.h>
 #include <media/nblog/Entry.h>
@@ -222,6 +223,36 @@ EntryIterator FormatEntry::copyWithAuthor(
     return it;
 }
 
+// writes the raw bytes of the entry at it to fd, for offline analysis tools
+static void writeEntryTo(int fd, const EntryIterator &it)
+{
+    (void) TEMP_FAILURE_RETRY(write(fd, (const uint8_t *) it, it->length + Entry::kOverhead));
+}
+
+EntryIterator FormatEntry::dumpWithAuthor(int fd, int author) const
+{
+    auto it = begin();
+    writeEntryTo(fd, it);       // write fmt start entry
+    writeEntryTo(fd, ++it);     // write timestamp
+    writeEntryTo(fd, ++it);     // write hash
+    // insert author entry
+    size_t authorEntrySize = Entry::kOverhead + sizeof(author);
+    uint8_t authorEntry[authorEntrySize];
+    authorEntry[offsetof(entry, type)] = EVENT_FMT_AUTHOR;
+    authorEntry[offsetof(entry, length)] =
+        authorEntry[authorEntrySize + Entry::kPreviousLengthOffset] =
+        sizeof(author);
+    *(int*) (&authorEntry[offsetof(entry, data)]) = author;
+    (void) TEMP_FAILURE_RETRY(write(fd, authorEntry, authorEntrySize));
+    // write rest of entries
+    while ((++it)->type != EVENT_FMT_END) {
+        writeEntryTo(fd, it);
+    }
+    writeEntryTo(fd, it);
+    ++it;
+    return it;
+}
+
 int64_t HistogramEntry::timestamp() const
 {
     return EntryIterator(mEntry).payload<HistTsEntry>().ts;
@@ -258,5 +289,18 @@ EntryIterator HistogramEntry::copyWithAuthor(
     return EntryIterator(mEntry).next();
 }
 
+EntryIterator HistogramEntry::dumpWithAuthor(int fd, int author) const
+{
+    // Same author insertion as copyWithAuthor(), but written to fd.
+    uint8_t buffer[Entry::kOverhead + sizeof(HistTsEntryWithAuthor)];
+    memcpy(buffer, mEntry, sizeof(entry) + sizeof(HistTsEntry));
+    *(int*) (buffer + sizeof(entry) + sizeof(HistTsEntry)) = author;
+    buffer[offsetof(entry, length)] = sizeof(HistTsEntryWithAuthor);
+    buffer[offsetof(entry, data) + sizeof(HistTsEntryWithAuthor) + offsetof(ending, length)]
+        = sizeof(HistTsEntryWithAuthor);
+    (void) TEMP_FAILURE_RETRY(write(fd, buffer, sizeof(buffer)));
+    return EntryIterator(mEntry).next();
+}
+
 }   // namespace NBLog
 }   // namespace android
@@ -115,6 +115,56 @@ void Merger::merge()
     }
 }
 
+// Advances it to the next entry that carries a timestamp and can take part in the
+// merge, i.e. one for which AbstractEntry::buildEntry() has a concrete class.
+// Returns false if the end of the snapshot is reached first.
+static bool advanceToTimestamped(EntryIterator &it, const EntryIterator &end)
+{
+    while (it != end) {
+        switch (it->type) {
+        case EVENT_FMT_START:
+        case EVENT_AUDIO_STATE:
+        case EVENT_HISTOGRAM_ENTRY_TS:
+            return true;
+        default:
+            ++it;
+            break;
+        }
+    }
+    return false;
+}
+
+// Merge the given readers, sorted by timestamp, and write the data to fd in the
+// binary wire format for offline analysis. Unlike merge(), the readers' buffers are
+// not consumed, and entries without a timestamp are skipped since they have no
+// position in the merged order.
+void Merger::dump(int fd, const std::vector<sp<Reader>> &readers)
+{
+    const int nLogs = readers.size();
+    std::vector<std::unique_ptr<Snapshot>> snapshots(nLogs);
+    std::vector<EntryIterator> offsets;
+    offsets.reserve(nLogs);
+    for (int i = 0; i < nLogs; ++i) {
+        snapshots[i] = readers[i]->getSnapshot(false /*flush*/);
+        offsets.push_back(snapshots[i]->begin());
+    }
+    std::priority_queue<MergeItem, std::vector<MergeItem>, std::greater<MergeItem>> timestamps;
+    for (int i = 0; i < nLogs; ++i) {
+        if (advanceToTimestamped(offsets[i], snapshots[i]->end())) {
+            timestamps.emplace(AbstractEntry::buildEntry(offsets[i])->timestamp(), i);
+        }
+    }
+
+    while (!timestamps.empty()) {
+        const int index = timestamps.top().index;   // find minimum timestamp
+        offsets[index] = AbstractEntry::buildEntry(offsets[index])->dumpWithAuthor(fd, index);
+        timestamps.pop();
+        if (advanceToTimestamped(offsets[index], snapshots[index]->end())) {
+            timestamps.emplace(AbstractEntry::buildEntry(offsets[index])->timestamp(), index);
+        }
+    }
+}
+
 const std::vector<sp<Reader>>& Merger::getReaders() const
 {
     //AutoMutex _l(mLock);
@@ -166,7 +166,13 @@ void Writer::log(const Entry &etr, bool trusted)
         temp[i] = etr.copyEntryDataAt(i);
     }
     // write to circular buffer
-    mFifoWriter->write(temp, need);
+    // the Writer:: is needed to avoid re-taking the lock under LockedWriter::log()
+    Writer::flush(temp, need);
+}
+
+void Writer::flush(const uint8_t *data, size_t size)
+{
+    mFifoWriter->write(data, size);
 }
 
 void Writer::log(Event event, const void *data, size_t length)
@@ -205,29 +211,29 @@ void Writer::logvf(const char *fmt, va_list ap)
     }
 }
 
-void Writer::logStart(const char *fmt)
+void Writer::stageEntry(uint8_t *stage, size_t &used, Event event, const void *data, size_t length)
 {
-    if (!mEnabled) {
+    if (length > Entry::kMaxLength || (data == NULL && length != 0)) {
         return;
     }
-    size_t length = strlen(fmt);
-    if (length > Entry::kMaxLength) {
-        length = Entry::kMaxLength;
-    }
-    log(EVENT_FMT_START, fmt, length);
-}
-
-void Writer::logTimestampFormat()
-{
-    if (!mEnabled) {
+    // Ignore if invalid event
+    if (event == EVENT_RESERVED || event >= EVENT_UPPER_BOUND) {
         return;
     }
-    const nsecs_t ts = systemTime();
-    if (ts > 0) {
-        log(EVENT_FMT_TIMESTAMP, &ts, sizeof(ts));
-    } else {
-        ALOGE("Failed to get timestamp");
+    const size_t need = length + Entry::kOverhead;
+    if (used + need > kStageSizeBytes) {
+        // the sequence doesn't fit in the staging buffer; commit what we have to make
+        // room, degrading to more than one FIFO write for this sequence
+        flush(stage, used);
+        used = 0;
     }
+    stage[used++] = (uint8_t) event;
+    stage[used++] = (uint8_t) length;
+    if (length > 0) {
+        memcpy(&stage[used], data, length);
+        used += length;
+    }
+    stage[used++] = (uint8_t) length;
 }
 
 void Writer::logVFormat(const char *fmt, log_hash_t hash, va_list argp)
@@ -235,15 +241,30 @@ void Writer::logVFormat(const char *fmt, log_hash_t hash, va_list argp)
     if (!mEnabled) {
         return;
     }
-    Writer::logStart(fmt);
+    // Stage the whole sequence of entries forming this formatted log locally, then
+    // commit it to the FIFO with a single write. This makes one release-store of the
+    // rear pointer per formatted log rather than one per part, and the reader can
+    // never observe a partially written sequence.
+    uint8_t stage[kStageSizeBytes];
+    size_t used = 0;
     int i;
     double d;
     float f;
     char* s;
     size_t length;
     int64_t t;
-    Writer::logTimestampFormat();
-    log(EVENT_FMT_HASH, &hash, sizeof(hash));
+    length = strlen(fmt);
+    if (length > Entry::kMaxLength) {
+        length = Entry::kMaxLength;
+    }
+    stageEntry(stage, used, EVENT_FMT_START, fmt, length);
+    const nsecs_t ts = systemTime();
+    if (ts > 0) {
+        stageEntry(stage, used, EVENT_FMT_TIMESTAMP, &ts, sizeof(ts));
+    } else {
+        ALOGE("Failed to get timestamp");
+    }
+    stageEntry(stage, used, EVENT_FMT_HASH, &hash, sizeof(hash));
     for (const char *p = fmt; *p != '\0'; p++) {
         // TODO: implement more complex formatting such as %.3f
         if (*p != '%') {
@@ -256,27 +277,27 @@ void Writer::logVFormat(const char *fmt, log_hash_t hash, va_list argp)
             if (length > Entry::kMaxLength) {
                 length = Entry::kMaxLength;
             }
-            log(EVENT_FMT_STRING, s, length);
+            stageEntry(stage, used, EVENT_FMT_STRING, s, length);
             break;
 
         case 't': // timestamp
             t = va_arg(argp, int64_t);
-            log(EVENT_FMT_TIMESTAMP, &t, sizeof(t));
+            stageEntry(stage, used, EVENT_FMT_TIMESTAMP, &t, sizeof(t));
             break;
 
         case 'd': // integer
             i = va_arg(argp, int);
-            log(EVENT_FMT_INTEGER, &i, sizeof(i));
+            stageEntry(stage, used, EVENT_FMT_INTEGER, &i, sizeof(i));
             break;
 
         case 'f': // float
             d = va_arg(argp, double); // float arguments are promoted to double in vararg lists
             f = (float)d;
-            log(EVENT_FMT_FLOAT, &f, sizeof(f));
+            stageEntry(stage, used, EVENT_FMT_FLOAT, &f, sizeof(f));
             break;
 
         case 'p': // pid
-            log(EVENT_FMT_PID, mPidTag, mPidTagSize);
+            stageEntry(stage, used, EVENT_FMT_PID, mPidTag, mPidTagSize);
             break;
 
         // the "%\0" case finishes parsing
@@ -292,8 +313,8 @@ void Writer::logVFormat(const char *fmt, log_hash_t hash, va_list argp)
             break;
         }
     }
-    Entry etr(EVENT_FMT_END, nullptr, 0);
-    log(etr, true);
+    stageEntry(stage, used, EVENT_FMT_END, nullptr, 0);
+    flush(stage, used);
 }
 
 // ---------------------------------------------------------------------------
@@ -320,5 +341,10 @@ void LockedWriter::log(const Entry &entry, bool trusted) {
     Writer::log(entry, trusted);
 }
 
+void LockedWriter::flush(const uint8_t *data, size_t size) {
+    Mutex::Autolock _l(mLock);
+    Writer::flush(data, size);
+}
+
 }   // namespace NBLog
 }   // namespace android
@@ -159,6 +159,10 @@ public:
     virtual EntryIterator copyWithAuthor(std::unique_ptr<audio_utils_fifo_writer> &dst,
                                             int author) const = 0;
 
+    // write entry to fd in the binary wire format, adding author as copyWithAuthor
+    // does, returns iterator to end of entry
+    virtual EntryIterator dumpWithAuthor(int fd, int author) const = 0;
+
 protected:
     // Entry starting in the given pointer, which shall not be nullptr.
     explicit AbstractEntry(const uint8_t *entry) : mEntry(entry) {}
@@ -209,6 +213,8 @@ public:
     // copy entry, adding author before timestamp, returns size of original entry
     EntryIterator copyWithAuthor(std::unique_ptr<audio_utils_fifo_writer> &dst,
                                  int author) const override;
+
+    EntryIterator dumpWithAuthor(int fd, int author) const override;
 };
 
 class HistogramEntry : public AbstractEntry {
@@ -224,6 +230,8 @@ public:
 
     EntryIterator copyWithAuthor(std::unique_ptr<audio_utils_fifo_writer> &dst,
                                  int author) const override;
+
+    EntryIterator dumpWithAuthor(int fd, int author) const override;
 };
 
 }   // namespace NBLog
@@ -55,6 +55,14 @@ public:
     // TODO add removeReader
     void merge();
 
+    // Writes the timestamped entries of the given readers' buffers to fd in the
+    // binary wire format, merge-sorted by timestamp and tagged with author entries
+    // identifying the originating thread, without consuming the buffers.
+    // Static because the merger's own readers are consumed by the merge thread;
+    // callers pass readers they own, e.g. MediaLogService's dump readers.
+    // Intended for offline analysis tools; see MediaLogService::dump().
+    static void dump(int fd, const std::vector<sp<Reader>> &readers);
+
     // FIXME This is returning a reference to a shared variable that needs a lock
     const std::vector<sp<Reader>>& getReaders() const;
 
@@ -87,6 +87,12 @@ protected:
     // writing to the FIFO before writing to this function.
     virtual void log(const Entry &entry, bool trusted = false);
 
+    // Commits a contiguous sequence of serialized entry bytes to the FIFO with a
+    // single write, i.e. a single release-store of the rear pointer.
+    // This is protected and virtual because LockedWriter overrides it to hold its
+    // lock once per batch rather than once per entry.
+    virtual void flush(const uint8_t *data, size_t size);
+
 private:
     // 0 <= length <= kMaxLength
     // Log a single Entry with corresponding event, data, and length.
@@ -94,11 +100,18 @@ private:
 
     void    logvf(const char *fmt, va_list ap);
 
-    // helper functions for logging parts of a formatted entry
-    void    logStart(const char *fmt);
-    void    logTimestampFormat();
+    // helper function for logging a formatted entry
     void    logVFormat(const char *fmt, log_hash_t hash, va_list ap);
 
+    // Serializes a single entry into the staging buffer used by logVFormat(),
+    // flushing the staged bytes first if the entry does not fit.
+    void    stageEntry(uint8_t *stage, size_t &used, Event event, const void *data, size_t length);
+
+    // size of the staging buffer used by logVFormat() to commit the parts of a
+    // formatted entry with a single FIFO write; large enough for typical sequences,
+    // oversized ones degrade to more than one write
+    static constexpr size_t kStageSizeBytes = 1024;
+
     Shared* const   mShared{};          // raw pointer to shared memory
     sp<IMemory>     mIMemory{};         // ref-counted version, initialized in constructor
                                         // and then const
@@ -129,6 +142,7 @@ public:
 private:
     // Lock needs to be obtained before writing to FIFO.
     void log(const Entry &entry, bool trusted = false) override;
+    void flush(const uint8_t *data, size_t size) override;
 
     mutable Mutex   mLock;
 };
@@ -38,6 +38,7 @@ namespace android {
 
 AACWriter::AACWriter(int fd)
     : mFd(dup(fd)),
+      mSink(mFd),
       mInitCheck(mFd < 0? NO_INIT: OK),
       mStarted(false),
       mPaused(false),
@@ -236,49 +237,47 @@ static bool getSampleRateTableIndex(int sampleRate, uint8_t* tableIndex) {
  * 2 bits of frames count in one packet. Set to 0.
  */
 status_t AACWriter::writeAdtsHeader(uint32_t frameLength) {
-    uint8_t data = 0xFF;
-    write(mFd, &data, 1);
+    uint8_t header[kAdtsHeaderLength];
+    header[0] = 0xFF;
 
     const uint8_t kFieldId = 0;
     const uint8_t kMpegLayer = 0;
     const uint8_t kProtectionAbsense = 1;  // 1: kAdtsHeaderLength = 7
-    data = 0xF0;
-    data |= (kFieldId << 3);
-    data |= (kMpegLayer << 1);
-    data |= kProtectionAbsense;
-    write(mFd, &data, 1);
+    header[1] = 0xF0;
+    header[1] |= (kFieldId << 3);
+    header[1] |= (kMpegLayer << 1);
+    header[1] |= kProtectionAbsense;
 
     const uint8_t kProfileCode = mAACProfile - 1;
     uint8_t kSampleFreqIndex;
     CHECK(getSampleRateTableIndex(mSampleRate, &kSampleFreqIndex));
     const uint8_t kPrivateStream = 0;
     const uint8_t kChannelConfigCode = mChannelCount;
-    data = (kProfileCode << 6);
-    data |= (kSampleFreqIndex << 2);
-    data |= (kPrivateStream << 1);
-    data |= (kChannelConfigCode >> 2);
-    write(mFd, &data, 1);
+    header[2] = (kProfileCode << 6);
+    header[2] |= (kSampleFreqIndex << 2);
+    header[2] |= (kPrivateStream << 1);
+    header[2] |= (kChannelConfigCode >> 2);
 
     // 4 bits from originality to copyright start
     const uint8_t kCopyright = 0;
     const uint32_t kFrameLength = frameLength;
-    data = ((kChannelConfigCode & 3) << 6);
-    data |= (kCopyright << 2);
-    data |= ((kFrameLength & 0x1800) >> 11);
-    write(mFd, &data, 1);
+    header[3] = ((kChannelConfigCode & 3) << 6);
+    header[3] |= (kCopyright << 2);
+    header[3] |= ((kFrameLength & 0x1800) >> 11);
 
-    data = ((kFrameLength & 0x07F8) >> 3);
-    write(mFd, &data, 1);
+    header[4] = ((kFrameLength & 0x07F8) >> 3);
 
     const uint32_t kBufferFullness = 0x7FF;  // VBR
-    data = ((kFrameLength & 0x07) << 5);
-    data |= ((kBufferFullness & 0x07C0) >> 6);
-    write(mFd, &data, 1);
+    header[5] = ((kFrameLength & 0x07) << 5);
+    header[5] |= ((kBufferFullness & 0x07C0) >> 6);
 
     const uint8_t kFrameCount = 0;
-    data = ((kBufferFullness & 0x03F) << 2);
-    data |= kFrameCount;
-    write(mFd, &data, 1);
+    header[6] = ((kBufferFullness & 0x03F) << 2);
+    header[6] |= kFrameCount;
+
+    if (mSink.write(header, sizeof(header)) != (ssize_t)sizeof(header)) {
+        return ERROR_IO;
+    }
 
     return OK;
 }
@@ -352,7 +351,7 @@ status_t AACWriter::threadFunc() {
         ssize_t dataLength = buffer->range_length();
         uint8_t *data = (uint8_t *)buffer->data() + buffer->range_offset();
         if (writeAdtsHeader(kAdtsHeaderLength + dataLength) != OK ||
-            dataLength != write(mFd, data, dataLength)) {
+            dataLength != mSink.write(data, dataLength)) {
             err = ERROR_IO;
         }
 
@@ -372,6 +371,9 @@ status_t AACWriter::threadFunc() {
         err = ERROR_MALFORMED;
     }
 
+    if (mSink.flush() != OK && err == OK) {
+        err = ERROR_IO;
+    }
     close(mFd);
     mFd = -1;
     mReachedEOS = true;
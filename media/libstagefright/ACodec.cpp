@@ -264,7 +264,8 @@ private:
 ////////////////////////////////////////////////////////////////////////////////
 
 struct ACodec::BaseState : public AState {
-    explicit BaseState(ACodec *codec, const sp<AState> &parentState = NULL);
+    explicit BaseState(ACodec *codec, const sp<AState> &parentState = NULL,
+            const char *name = "Base");
 
 protected:
     enum PortMode {
@@ -978,28 +979,36 @@ status_t ACodec::allocateBuffersOnPort(OMX_U32 portIndex) {
                             : new SecureBuffer(format, native_handle, bufSize);
                     info.mCodecData = info.mData;
                 } else {
-                    bool success;
-                    auto transStatus = mAllocator[portIndex]->allocate(
-                            bufSize,
-                            [&success, &hidlMemToken](
-                                    bool s,
-                                    hidl_memory const& m) {
-                                success = s;
-                                hidlMemToken = m;
-                            });
-
-                    if (!transStatus.isOk()) {
-                        ALOGE("hidl's AshmemAllocator failed at the "
-                                "transport: %s",
-                                transStatus.description().c_str());
-                        return NO_MEMORY;
-                    }
-                    if (!success) {
-                        return NO_MEMORY;
-                    }
-                    hidlMem = mapMemory(hidlMemToken);
-                    if (hidlMem == nullptr) {
-                        return NO_MEMORY;
+                    bool recycled = (portIndex == kPortIndexOutput)
+                            && reuseRecycledOutputMemory(
+                                    bufSize, &hidlMemToken, &hidlMem);
+                    if (!recycled) {
+                        bool success;
+                        auto transStatus = mAllocator[portIndex]->allocate(
+                                bufSize,
+                                [&success, &hidlMemToken](
+                                        bool s,
+                                        hidl_memory const& m) {
+                                    success = s;
+                                    hidlMemToken = m;
+                                });
+
+                        if (!transStatus.isOk()) {
+                            ALOGE("hidl's AshmemAllocator failed at the "
+                                    "transport: %s",
+                                    transStatus.description().c_str());
+                            return NO_MEMORY;
+                        }
+                        if (!success) {
+                            return NO_MEMORY;
+                        }
+                        hidlMem = mapMemory(hidlMemToken);
+                        if (hidlMem == nullptr) {
+                            return NO_MEMORY;
+                        }
+                        if (portIndex == kPortIndexOutput) {
+                            stashRecycledOutputMemory(hidlMemToken, hidlMem);
+                        }
                     }
                     err = mOMXNode->useBuffer(
                             portIndex, hidlMemToken, &info.mBufferID);
@@ -1066,6 +1075,67 @@ status_t ACodec::allocateBuffersOnPort(OMX_U32 portIndex) {
     return OK;
 }
 
+// Cap on retained backings: enough for two buffer sets of a typical decoder,
+// bounding how much memory an unusual resolution ladder can pin.
+static const size_t kMaxRecycledOutputMemories = 32;
+
+bool ACodec::reuseRecycledOutputMemory(
+        size_t size, hardware::hidl_memory *token, sp<TMemory> *mem) {
+    // Best fit, so a small request does not pin a large backing.
+    ssize_t best = -1;
+    for (size_t i = 0; i < mRecycledOutputMemory.size(); ++i) {
+        const RecycledOutputMemory &entry = mRecycledOutputMemory[i];
+        if (entry.mInUse || entry.mToken.size() < size) {
+            continue;
+        }
+        if (best < 0 || entry.mToken.size()
+                < mRecycledOutputMemory[best].mToken.size()) {
+            best = i;
+        }
+    }
+    if (best < 0) {
+        return false;
+    }
+    RecycledOutputMemory &entry = mRecycledOutputMemory[best];
+    entry.mInUse = true;
+    *token = entry.mToken;
+    *mem = entry.mMemory;
+    ALOGV("[%s] reusing %zu byte output backing for %zu byte buffer",
+            mComponentName.c_str(), (size_t)entry.mToken.size(), size);
+    return true;
+}
+
+void ACodec::stashRecycledOutputMemory(
+        const hardware::hidl_memory &token, const sp<TMemory> &mem) {
+    if (mRecycledOutputMemory.size() >= kMaxRecycledOutputMemories) {
+        // Evict an unused entry; if all are in use, simply don't retain this
+        // backing -- it just won't be reusable after the next reconfiguration.
+        for (auto it = mRecycledOutputMemory.begin();
+                it != mRecycledOutputMemory.end(); ++it) {
+            if (!it->mInUse) {
+                mRecycledOutputMemory.erase(it);
+                break;
+            }
+        }
+        if (mRecycledOutputMemory.size() >= kMaxRecycledOutputMemories) {
+            return;
+        }
+    }
+    mRecycledOutputMemory.push_back({token, mem, true /* inUse */});
+}
+
+void ACodec::releaseRecycledOutputMemory(const sp<RefBase> &memRef) {
+    if (memRef == NULL) {
+        return;
+    }
+    for (RecycledOutputMemory &entry : mRecycledOutputMemory) {
+        if (entry.mInUse && memRef == entry.mMemory) {
+            entry.mInUse = false;
+            return;
+        }
+    }
+}
+
 status_t ACodec::setupNativeWindowSizeFormatAndUsage(
         ANativeWindow *nativeWindow /* nonnull */, int *finalUsage /* nonnull */,
         bool reconnect) {
@@ -1604,6 +1674,10 @@ status_t ACodec::freeBuffersOnPort(OMX_U32 portIndex) {
     }
 
     mAllocator[portIndex].clear();
+    if (portIndex == kPortIndexOutput) {
+        // Full teardown, not a reconfiguration: drop the retained backings.
+        mRecycledOutputMemory.clear();
+    }
     return err;
 }
 
@@ -1666,6 +1740,9 @@ status_t ACodec::freeBuffer(OMX_U32 portIndex, size_t i) {
     if (portIndex == kPortIndexOutput) {
         mRenderTracker.untrackFrame(info->mRenderInfo, i);
         info->mRenderInfo = NULL;
+        // The backing itself stays retained for reuse after a port
+        // reconfiguration.
+        releaseRecycledOutputMemory(info->mCodecRef);
     }
 
     // remove buffer even if mOMXNode->freeBuffer fails
@@ -5962,8 +6039,9 @@ status_t ACodec::requestIDRFrame() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-ACodec::BaseState::BaseState(ACodec *codec, const sp<AState> &parentState)
-    : AState(parentState),
+ACodec::BaseState::BaseState(
+        ACodec *codec, const sp<AState> &parentState, const char *name)
+    : AState(parentState, name),
       mCodec(codec),
       mPendingExtraOutputMetadataBufferRequest(false) {
 }
@@ -6961,7 +7039,7 @@ void ACodec::BaseState::onOutputBufferDrained(const sp<AMessage> &msg) {
 ////////////////////////////////////////////////////////////////////////////////
 
 ACodec::UninitializedState::UninitializedState(ACodec *codec)
-    : BaseState(codec) {
+    : BaseState(codec, NULL, "Uninitialized") {
 }
 
 void ACodec::UninitializedState::stateEntered() {
@@ -7130,7 +7208,7 @@ bool ACodec::UninitializedState::onAllocateComponent(const sp<AMessage> &msg) {
 ////////////////////////////////////////////////////////////////////////////////
 
 ACodec::LoadedState::LoadedState(ACodec *codec)
-    : BaseState(codec) {
+    : BaseState(codec, NULL, "Loaded") {
 }
 
 void ACodec::LoadedState::stateEntered() {
@@ -7454,7 +7532,7 @@ void ACodec::LoadedState::onStart() {
 ////////////////////////////////////////////////////////////////////////////////
 
 ACodec::LoadedToIdleState::LoadedToIdleState(ACodec *codec)
-    : BaseState(codec) {
+    : BaseState(codec, NULL, "LoadedToIdle") {
 }
 
 void ACodec::LoadedToIdleState::stateEntered() {
@@ -7573,7 +7651,7 @@ bool ACodec::LoadedToIdleState::onOMXEvent(
 ////////////////////////////////////////////////////////////////////////////////
 
 ACodec::IdleToExecutingState::IdleToExecutingState(ACodec *codec)
-    : BaseState(codec) {
+    : BaseState(codec, NULL, "IdleToExecuting") {
 }
 
 void ACodec::IdleToExecutingState::stateEntered() {
@@ -7648,7 +7726,7 @@ bool ACodec::IdleToExecutingState::onOMXEvent(
 ////////////////////////////////////////////////////////////////////////////////
 
 ACodec::ExecutingState::ExecutingState(ACodec *codec)
-    : BaseState(codec),
+    : BaseState(codec, NULL, "Executing"),
       mActive(false) {
 }
 
@@ -8614,7 +8692,7 @@ bool ACodec::ExecutingState::onOMXEvent(
 
 ACodec::OutputPortSettingsChangedState::OutputPortSettingsChangedState(
         ACodec *codec)
-    : BaseState(codec) {
+    : BaseState(codec, NULL, "OutputPortSettingsChanged") {
 }
 
 ACodec::BaseState::PortMode ACodec::OutputPortSettingsChangedState::getPortMode(
@@ -8813,7 +8891,7 @@ bool ACodec::OutputPortSettingsChangedState::onOMXEvent(
 ////////////////////////////////////////////////////////////////////////////////
 
 ACodec::ExecutingToIdleState::ExecutingToIdleState(ACodec *codec)
-    : BaseState(codec),
+    : BaseState(codec, NULL, "ExecutingToIdle"),
       mComponentNowIdle(false) {
 }
 
@@ -8931,7 +9009,7 @@ void ACodec::ExecutingToIdleState::onOutputBufferDrained(
 ////////////////////////////////////////////////////////////////////////////////
 
 ACodec::IdleToLoadedState::IdleToLoadedState(ACodec *codec)
-    : BaseState(codec) {
+    : BaseState(codec, NULL, "IdleToLoaded") {
 }
 
 bool ACodec::IdleToLoadedState::onMessageReceived(const sp<AMessage> &msg) {
@@ -8992,7 +9070,7 @@ bool ACodec::IdleToLoadedState::onOMXEvent(
 ////////////////////////////////////////////////////////////////////////////////
 
 ACodec::FlushingState::FlushingState(ACodec *codec)
-    : BaseState(codec) {
+    : BaseState(codec, NULL, "Flushing") {
 }
 
 void ACodec::FlushingState::stateEntered() {
@@ -27,6 +27,7 @@
 #include <android/hardware/cas/native/1.0/IDescrambler.h>
 #include <android/hardware/drm/1.0/types.h>
 #include <binder/MemoryDealer.h>
+#include <cutils/properties.h>
 #include <hidlmemory/FrameworkUtils.h>
 #include <media/openmax/OMX_Core.h>
 #include <media/stagefright/foundation/ABuffer.h>
@@ -90,7 +91,8 @@ ACodecBufferChannel::ACodecBufferChannel(
         const sp<AMessage> &inputBufferFilled, const sp<AMessage> &outputBufferDrained)
     : mInputBufferFilled(inputBufferFilled),
       mOutputBufferDrained(outputBufferDrained),
-      mHeapSeqNum(-1) {
+      mHeapSeqNum(-1),
+      mInPlaceDecrypt(property_get_bool("media.acodec.inplace_decrypt", false)) {
 }
 
 status_t ACodecBufferChannel::queueInputBuffer(const sp<MediaCodecBuffer> &buffer) {
@@ -155,19 +157,25 @@ status_t ACodecBufferChannel::queueSecureInputBuffer(
         // We don't need to go through crypto or descrambler if the input is empty.
         result = 0;
     } else if (mCrypto != NULL) {
+        hardware::drm::V1_0::SharedBuffer source;
+        IMemoryToSharedBuffer(it->mSharedEncryptedBuffer, mHeapSeqNum, &source);
+
         hardware::drm::V1_0::DestinationBuffer destination;
         if (secure) {
             destination.type = DrmBufferType::NATIVE_HANDLE;
             destination.secureMemory = hidl_handle(secureHandle);
+        } else if (mInPlaceDecrypt) {
+            // Decrypt in place into the per-buffer shared source memory, like the
+            // descrambler path below, instead of bouncing every access unit through
+            // the single shared staging destination.
+            destination.type = DrmBufferType::SHARED_MEMORY;
+            destination.nonsecureMemory = source;
         } else {
             destination.type = DrmBufferType::SHARED_MEMORY;
             IMemoryToSharedBuffer(
                     mDecryptDestination, mHeapSeqNum, &destination.nonsecureMemory);
         }
 
-        hardware::drm::V1_0::SharedBuffer source;
-        IMemoryToSharedBuffer(it->mSharedEncryptedBuffer, mHeapSeqNum, &source);
-
         result = mCrypto->decrypt(key, iv, mode, pattern,
                 source, it->mClientBuffer->offset(),
                 subSamples, numSubSamples, destination, errorDetailMsg);
@@ -177,7 +185,11 @@ status_t ACodecBufferChannel::queueSecureInputBuffer(
         }
 
         if (destination.type == DrmBufferType::SHARED_MEMORY) {
-            memcpy(it->mCodecBuffer->base(), mDecryptDestination->unsecurePointer(), result);
+            memcpy(it->mCodecBuffer->base(),
+                    mInPlaceDecrypt
+                            ? (uint8_t *)it->mSharedEncryptedBuffer->unsecurePointer()
+                            : (uint8_t *)mDecryptDestination->unsecurePointer(),
+                    result);
         }
     } else {
         // Here we cast CryptoPlugin::SubSample to hardware::cas::native::V1_0::SubSample
@@ -16,18 +16,26 @@
 
 //#define LOG_NDEBUG 0
 #define LOG_TAG "AHierarchicalStateMachine"
+#define ATRACE_TAG ATRACE_TAG_VIDEO
 #include <utils/Log.h>
+#include <utils/Trace.h>
+
+#include <inttypes.h>
+#include <stdio.h>
 
 #include <media/stagefright/AHierarchicalStateMachine.h>
 
 #include <media/stagefright/foundation/ADebug.h>
+#include <media/stagefright/foundation/ALooper.h>
 #include <media/stagefright/foundation/AMessage.h>
+#include <media/stagefright/foundation/AString.h>
 #include <utils/Vector.h>
 
 namespace android {
 
-AState::AState(const sp<AState> &parentState)
-    : mParentState(parentState) {
+AState::AState(const sp<AState> &parentState, const char *name)
+    : mParentState(parentState),
+      mName(name) {
 }
 
 AState::~AState() {
@@ -37,6 +45,10 @@ sp<AState> AState::parentState() {
     return mParentState;
 }
 
+const char *AState::stateName() const {
+    return mName;
+}
+
 void AState::stateEntered() {
 }
 
@@ -52,8 +64,16 @@ AHierarchicalStateMachine::~AHierarchicalStateMachine() {
 }
 
 void AHierarchicalStateMachine::handleMessage(const sp<AMessage> &msg) {
+    int64_t startUs = ALooper::GetNowUs();
+    ++mMessageCount;
+
     sp<AState> save = mState;
 
+    bool traced = ATRACE_ENABLED();
+    if (traced) {
+        ATRACE_BEGIN(save != NULL ? save->stateName() : "(no state)");
+    }
+
     sp<AState> cur = mState;
     while (cur != NULL && !cur->onMessageReceived(msg)) {
         // If you claim not to have handled the message you shouldn't
@@ -63,12 +83,22 @@ void AHierarchicalStateMachine::handleMessage(const sp<AMessage> &msg) {
         cur = cur->parentState();
     }
 
-    if (cur != NULL) {
-        return;
+    if (traced) {
+        ATRACE_END();
     }
 
-    ALOGW("Warning message %s unhandled in root state.",
-         msg->debugString().c_str());
+    if (cur == NULL) {
+        ALOGW("Warning message %s unhandled in root state.",
+             msg->debugString().c_str());
+    }
+
+    // Track the slowest single dispatch and the state it happened in; a
+    // stalled codec usually shows up here as one pathological transition.
+    int64_t elapsedUs = ALooper::GetNowUs() - startUs;
+    if (elapsedUs > mMaxDispatchUs) {
+        mMaxDispatchUs = elapsedUs;
+        mMaxDispatchState = save != NULL ? save->stateName() : "(no state)";
+    }
 }
 
 void AHierarchicalStateMachine::changeState(const sp<AState> &state) {
@@ -77,6 +107,19 @@ void AHierarchicalStateMachine::changeState(const sp<AState> &state) {
         return;
     }
 
+    int64_t nowUs = ALooper::GetNowUs();
+    const char *fromName = mState != NULL ? mState->stateName() : "(none)";
+    const char *toName = state != NULL ? state->stateName() : "(none)";
+
+    // The trace slice spans the stateExited/stateEntered callbacks below, so
+    // an expensive entry/exit handler is directly visible in systrace.
+    bool traced = ATRACE_ENABLED();
+    if (traced) {
+        char traceName[64];
+        snprintf(traceName, sizeof(traceName), "%s->%s", fromName, toName);
+        ATRACE_BEGIN(traceName);
+    }
+
     Vector<sp<AState> > A;
     sp<AState> cur = mState;
     for (;;) {
@@ -113,6 +156,45 @@ void AHierarchicalStateMachine::changeState(const sp<AState> &state) {
         i--;
         B.editItemAt(i)->stateEntered();
     }
+
+    if (traced) {
+        ATRACE_END();
+    }
+
+    TransitionRecord &rec =
+        mTransitionHistory[mTransitionCount % kTransitionHistorySize];
+    rec.mWhenUs = nowUs;
+    rec.mTimeInFromStateUs = mLastTransitionUs >= 0 ? nowUs - mLastTransitionUs : 0;
+    rec.mFrom = fromName;
+    rec.mTo = toName;
+    ++mTransitionCount;
+    mLastTransitionUs = nowUs;
+}
+
+void AHierarchicalStateMachine::dumpStateMachine(AString *out) const {
+    out->append(AStringPrintf(
+            "  current state: %s\n",
+            mState != NULL ? mState->stateName() : "(none)"));
+    out->append(AStringPrintf(
+            "  messages handled: %" PRId64
+            ", slowest dispatch: %" PRId64 " us (in %s)\n",
+            mMessageCount, mMaxDispatchUs, mMaxDispatchState));
+
+    size_t n = mTransitionCount < kTransitionHistorySize
+            ? mTransitionCount : kTransitionHistorySize;
+    if (n == 0) {
+        return;
+    }
+    out->append("  recent state transitions (oldest first):\n");
+    size_t first = mTransitionCount - n;
+    for (size_t i = 0; i < n; ++i) {
+        const TransitionRecord &rec =
+            mTransitionHistory[(first + i) % kTransitionHistorySize];
+        out->append(AStringPrintf(
+                "    %" PRId64 " us: %s -> %s (spent %" PRId64 " us in %s)\n",
+                rec.mWhenUs, rec.mFrom, rec.mTo,
+                rec.mTimeInFromStateUs, rec.mFrom));
+    }
 }
 
 }  // namespace android
@@ -33,6 +33,7 @@ namespace android {
 
 AMRWriter::AMRWriter(int fd)
     : mFd(dup(fd)),
+      mSink(mFd),
       mInitCheck(mFd < 0? NO_INIT: OK),
       mStarted(false),
       mPaused(false),
@@ -236,7 +237,7 @@ status_t AMRWriter::threadFunc() {
             notify(MEDIA_RECORDER_EVENT_INFO, MEDIA_RECORDER_INFO_MAX_DURATION_REACHED, 0);
             break;
         }
-        ssize_t n = write(mFd,
+        ssize_t n = mSink.write(
                         (const uint8_t *)buffer->data() + buffer->range_offset(),
                         buffer->range_length());
 
@@ -263,6 +264,9 @@ status_t AMRWriter::threadFunc() {
         err = ERROR_MALFORMED;
     }
 
+    if (mSink.flush() != OK && err == OK) {
+        err = ERROR_IO;
+    }
     close(mFd);
     mFd = -1;
     mReachedEOS = true;
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "BufferedWriteSink"
+#include <utils/Log.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <media/stagefright/BufferedWriteSink.h>
+#include <media/stagefright/MediaErrors.h>
+#include <utils/Timers.h>
+
+namespace android {
+
+BufferedWriteSink::BufferedWriteSink(int fd, size_t capacity, int64_t maxHoldUs)
+    : mFd(fd),
+      mCapacity(capacity),
+      mMaxHoldUs(maxHoldUs),
+      mSyncOnFlush(false),
+      mBuffer(new uint8_t[capacity]),
+      mUsed(0),
+      mOldestByteTimeUs(0) {
+}
+
+BufferedWriteSink::~BufferedWriteSink() {
+    ALOGW_IF(mUsed > 0, "destroyed with %zu unflushed bytes", mUsed);
+    delete[] mBuffer;
+}
+
+void BufferedWriteSink::setSyncOnFlush(bool syncOnFlush) {
+    mSyncOnFlush = syncOnFlush;
+}
+
+ssize_t BufferedWriteSink::writeFully(const void *data, size_t size) {
+    const uint8_t *src = (const uint8_t *)data;
+    size_t remaining = size;
+    while (remaining > 0) {
+        ssize_t n = ::write(mFd, src, remaining);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        src += n;
+        remaining -= n;
+    }
+    return size;
+}
+
+ssize_t BufferedWriteSink::write(const void *data, size_t size) {
+    if (size >= mCapacity) {
+        // Too large to benefit from buffering; preserve ordering by flushing
+        // what we have, then write it straight through.
+        if (flush() != OK) {
+            return -1;
+        }
+        return writeFully(data, size);
+    }
+
+    if (mUsed + size > mCapacity && flush() != OK) {
+        return -1;
+    }
+
+    if (mUsed == 0) {
+        mOldestByteTimeUs = systemTime(SYSTEM_TIME_MONOTONIC) / 1000;
+    }
+    memcpy(mBuffer + mUsed, data, size);
+    mUsed += size;
+
+    // Timed flush: do not hold buffered frames longer than the hold window,
+    // so a crash or abrupt stop loses at most that much audio.
+    int64_t nowUs = systemTime(SYSTEM_TIME_MONOTONIC) / 1000;
+    if (nowUs - mOldestByteTimeUs >= mMaxHoldUs && flush() != OK) {
+        return -1;
+    }
+    return size;
+}
+
+status_t BufferedWriteSink::flush() {
+    if (mUsed > 0) {
+        ssize_t n = writeFully(mBuffer, mUsed);
+        if (n < 0) {
+            ALOGE("flush of %zu bytes failed; errno = %d", mUsed, errno);
+            mUsed = 0;
+            return ERROR_IO;
+        }
+        mUsed = 0;
+    }
+    if (mSyncOnFlush) {
+        fdatasync(mFd);
+    }
+    return OK;
+}
+
+}  // namespace android
@@ -804,6 +804,10 @@ status_t CameraSource::reset() {
         mBufferQueueListener.clear();
     }
 
+    // The memory slots (and hence the pointers the pooled buffers wrap) are
+    // recreated on the next start, so the pool must not outlive them.
+    freeMediaBufferPool();
+
     mVideoBufferConsumer.clear();
     mVideoBufferProducer.clear();
     releaseCamera();
@@ -860,6 +864,43 @@ void CameraSource::releaseOneRecordingFrame(const sp<IMemory>& frame) {
     releaseRecordingFrame(frame);
 }
 
+MediaBuffer *CameraSource::acquireMediaBufferLocked(const sp<IMemory>& frame) {
+    // TODO: Using unsecurePointer() has some associated security pitfalls
+    //       (see declaration for details).
+    //       Either document why it is safe in this case or address the
+    //       issue (e.g. by copying).
+    void *pointer = frame->unsecurePointer();
+
+    MediaBuffer *buffer;
+    ssize_t index = mMediaBufferPool.indexOfKey(pointer);
+    if (index >= 0) {
+        buffer = mMediaBufferPool.valueAt(index);
+        buffer->reset();
+    } else {
+        // One buffer per memory slot, so the pool stops growing once every
+        // slot has been seen.
+        buffer = new MediaBuffer(pointer, frame->size());
+        mMediaBufferPool.add(pointer, buffer);
+    }
+
+    buffer->setObserver(this);
+    return buffer;
+}
+
+void CameraSource::freeMediaBufferPool() {
+    for (size_t i = 0; i < mMediaBufferPool.size(); i++) {
+        MediaBuffer *buffer = mMediaBufferPool.valueAt(i);
+        if (buffer->refcount() == 0) {
+            buffer->setObserver(NULL);
+            buffer->release();
+        }
+        // Otherwise the encoder never returned the buffer; it leaks along
+        // with the frame it wraps, just as it did when buffers were
+        // allocated per frame.
+    }
+    mMediaBufferPool.clear();
+}
+
 void CameraSource::signalBufferReturned(MediaBufferBase *buffer) {
     ALOGV("signalBufferReturned: %p", buffer->data());
     Mutex::Autolock autoLock(mLock);
@@ -869,8 +910,9 @@ void CameraSource::signalBufferReturned(MediaBufferBase *buffer) {
             releaseOneRecordingFrame((*it));
             mFramesBeingEncoded.erase(it);
             ++mNumFramesEncoded;
+            // The buffer stays in mMediaBufferPool and will be handed out
+            // again by the next read() of the same memory slot.
             buffer->setObserver(0);
-            buffer->release();
             mFrameCompleteCondition.signal();
             return;
         }
@@ -920,12 +962,7 @@ status_t CameraSource::read(
         frameTime = *mFrameTimes.begin();
         mFrameTimes.erase(mFrameTimes.begin());
         mFramesBeingEncoded.push_back(frame);
-        // TODO: Using unsecurePointer() has some associated security pitfalls
-        //       (see declaration for details).
-        //       Either document why it is safe in this case or address the
-        //       issue (e.g. by copying).
-        *buffer = new MediaBuffer(frame->unsecurePointer(), frame->size());
-        (*buffer)->setObserver(this);
+        *buffer = acquireMediaBufferLocked(frame);
         (*buffer)->add_ref();
         (*buffer)->meta_data().setInt64(kKeyTime, frameTime);
         if (mBufferDataSpace != mEncoderDataSpace) {
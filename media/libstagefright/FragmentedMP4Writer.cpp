@@ -0,0 +1,731 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "FragmentedMP4Writer"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include <utils/Log.h>
+
+#include <media/stagefright/FragmentedMP4Writer.h>
+#include <media/stagefright/MediaBuffer.h>
+#include <media/stagefright/MediaDefs.h>
+#include <media/stagefright/MediaErrors.h>
+#include <media/stagefright/MediaSource.h>
+#include <media/stagefright/MetaData.h>
+#include <media/stagefright/foundation/ADebug.h>
+
+#include "include/ESDS.h"
+
+namespace android {
+
+namespace {
+
+constexpr int64_t kDefaultFragmentDurationUs = 2000000;
+// media timescale; sample timestamps are in microseconds already
+constexpr uint32_t kMediaTimescale = 1000000;
+constexpr uint32_t kMovieTimescale = 1000;
+// trun sample_flags for sync and non-sync samples
+constexpr uint32_t kSyncSampleFlags = 0x02000000;
+constexpr uint32_t kNonSyncSampleFlags = 0x01010000;
+// fallback duration for a fragment's only sample before any delta is known
+constexpr uint32_t kDefaultSampleDurationUs = 33333;
+
+// Serializes ISO-BMFF boxes into a reusable in-memory buffer. clear() keeps
+// the allocation, so a buffer reused across fragments reaches a steady-state
+// capacity and stops allocating.
+struct BoxWriter {
+    void clear() { mData.clear(); mStack.clear(); }
+    size_t size() const { return mData.size(); }
+    const uint8_t *data() const { return mData.data(); }
+
+    void writeU8(uint8_t v) { mData.push_back(v); }
+    void writeU16(uint16_t v) {
+        writeU8(v >> 8); writeU8(v & 0xFF);
+    }
+    void writeU32(uint32_t v) {
+        writeU16(v >> 16); writeU16(v & 0xFFFF);
+    }
+    void writeU64(uint64_t v) {
+        writeU32(v >> 32); writeU32(v & 0xFFFFFFFF);
+    }
+    void writeFourcc(const char *fourcc) {
+        mData.insert(mData.end(), fourcc, fourcc + 4);
+    }
+    void write(const void *data, size_t size) {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        mData.insert(mData.end(), p, p + size);
+    }
+    void writeZeros(size_t count) {
+        mData.insert(mData.end(), count, 0);
+    }
+
+    void beginBox(const char *fourcc) {
+        mStack.push_back(mData.size());
+        writeU32(0);  // size, patched in endBox()
+        writeFourcc(fourcc);
+    }
+    void endBox() {
+        CHECK(!mStack.empty());
+        size_t offset = mStack.back();
+        mStack.pop_back();
+        uint32_t size = mData.size() - offset;
+        mData[offset] = size >> 24;
+        mData[offset + 1] = (size >> 16) & 0xFF;
+        mData[offset + 2] = (size >> 8) & 0xFF;
+        mData[offset + 3] = size & 0xFF;
+    }
+
+    // patches a previously written u32 in place (e.g. trun data_offset)
+    void patchU32(size_t offset, uint32_t v) {
+        CHECK_LE(offset + 4, mData.size());
+        mData[offset] = v >> 24;
+        mData[offset + 1] = (v >> 16) & 0xFF;
+        mData[offset + 2] = (v >> 8) & 0xFF;
+        mData[offset + 3] = v & 0xFF;
+    }
+
+private:
+    std::vector<uint8_t> mData;
+    std::vector<size_t> mStack;
+};
+
+// Appends one video sample to |out| with 4-byte NAL length prefixes,
+// converting from Annex-B start codes when present.
+void appendLengthPrefixed(const uint8_t *data, size_t size, BoxWriter *out) {
+    bool annexB = (size >= 4 && data[0] == 0 && data[1] == 0
+                   && (data[2] == 1 || (data[2] == 0 && data[3] == 1)));
+    if (!annexB) {
+        out->write(data, size);
+        return;
+    }
+    size_t pos = 0;
+    while (pos < size) {
+        // find the start code beginning this NAL
+        size_t start = pos;
+        while (start + 3 <= size
+                && !(data[start] == 0 && data[start + 1] == 0 && data[start + 2] == 1)) {
+            ++start;
+        }
+        if (start + 3 > size) {
+            break;
+        }
+        start += 3;
+        // find the next start code (or end of sample)
+        size_t end = start;
+        while (end + 3 <= size
+                && !(data[end] == 0 && data[end + 1] == 0 && data[end + 2] == 1)) {
+            ++end;
+        }
+        if (end + 3 > size) {
+            end = size;
+        } else if (end > start && data[end - 1] == 0) {
+            --end;  // 4-byte start code
+        }
+        out->writeU32(end - start);
+        out->write(data + start, end - start);
+        pos = end;
+    }
+}
+
+}  // namespace
+
+struct FragmentedMP4Writer::Track {
+    sp<MediaSource> mSource;
+    uint32_t mTrackId;
+    bool mIsAudio;
+    bool mIsAvc;
+    bool mIsHevc;
+    pthread_t mThread;
+    bool mThreadStarted = false;
+    volatile bool mDone = false;
+    volatile bool mReachedEOS = false;
+
+    struct Sample {
+        uint32_t size;
+        int64_t timeUs;
+        bool sync;
+    };
+
+    // current fragment; both vectors are reused across fragments
+    BoxWriter mSampleData;
+    std::vector<Sample> mSamples;
+    BoxWriter mBoxBuffer;  // moof + mdat header scratch
+
+    int64_t mBaseTimeUs = -1;   // timestamp of the very first sample
+    uint32_t mLastDurationUs = kDefaultSampleDurationUs;
+};
+
+FragmentedMP4Writer::FragmentedMP4Writer(int fd)
+    : mFd(dup(fd)),
+      mInitCheck(mFd < 0 ? NO_INIT : OK),
+      mStarted(false),
+      mFragmentDurationUs(kDefaultFragmentDurationUs),
+      mNextSequenceNumber(1) {
+}
+
+FragmentedMP4Writer::~FragmentedMP4Writer() {
+    if (mStarted) {
+        stop();
+    }
+    for (Track *track : mTracks) {
+        delete track;
+    }
+    mTracks.clear();
+    if (mFd != -1) {
+        close(mFd);
+        mFd = -1;
+    }
+}
+
+void FragmentedMP4Writer::setFragmentDurationUs(int64_t durationUs) {
+    CHECK(!mStarted);
+    if (durationUs > 0) {
+        mFragmentDurationUs = durationUs;
+    }
+}
+
+status_t FragmentedMP4Writer::addSource(const sp<MediaSource> &source) {
+    if (mInitCheck != OK) {
+        return mInitCheck;
+    }
+    if (mStarted) {
+        return INVALID_OPERATION;
+    }
+    const char *mime = nullptr;
+    if (!source->getFormat()->findCString(kKeyMIMEType, &mime) || mime == nullptr) {
+        return BAD_VALUE;
+    }
+    bool isAvc = !strcasecmp(mime, MEDIA_MIMETYPE_VIDEO_AVC);
+    bool isHevc = !strcasecmp(mime, MEDIA_MIMETYPE_VIDEO_HEVC);
+    bool isAac = !strcasecmp(mime, MEDIA_MIMETYPE_AUDIO_AAC);
+    if (!isAvc && !isHevc && !isAac) {
+        ALOGE("Track of type %s is not supported in fragmented output", mime);
+        return ERROR_UNSUPPORTED;
+    }
+
+    Track *track = new Track;
+    track->mSource = source;
+    track->mTrackId = mTracks.size() + 1;
+    track->mIsAudio = isAac;
+    track->mIsAvc = isAvc;
+    track->mIsHevc = isHevc;
+    mTracks.push_back(track);
+    return OK;
+}
+
+status_t FragmentedMP4Writer::start(MetaData * /* params */) {
+    if (mInitCheck != OK) {
+        return mInitCheck;
+    }
+    if (mTracks.empty()) {
+        return INVALID_OPERATION;
+    }
+    if (mStarted) {
+        return OK;
+    }
+
+    status_t err = writeInitSegment();
+    if (err != OK) {
+        return err;
+    }
+
+    for (Track *track : mTracks) {
+        err = track->mSource->start();
+        if (err != OK) {
+            return err;
+        }
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+    for (Track *track : mTracks) {
+        track->mDone = false;
+        track->mReachedEOS = false;
+        // the thread argument doubles as {writer, track}; pack via a small
+        // heap pair owned by the thread
+        auto *arg = new std::pair<FragmentedMP4Writer *, Track *>(this, track);
+        pthread_create(&track->mThread, &attr, ThreadWrapper, arg);
+        track->mThreadStarted = true;
+    }
+    pthread_attr_destroy(&attr);
+
+    mStarted = true;
+    return OK;
+}
+
+status_t FragmentedMP4Writer::pause() {
+    // Pausing is handled by the caller simply not feeding samples; fragments
+    // are cut on the timestamps of the samples that do arrive.
+    return OK;
+}
+
+status_t FragmentedMP4Writer::stop() {
+    if (!mStarted) {
+        return OK;
+    }
+    mStarted = false;
+
+    status_t err = OK;
+    for (Track *track : mTracks) {
+        track->mDone = true;
+        status_t status = track->mSource->stop();
+        if (err == OK && status != OK && status != ERROR_END_OF_STREAM) {
+            err = status;
+        }
+    }
+    for (Track *track : mTracks) {
+        if (track->mThreadStarted) {
+            void *res = nullptr;
+            pthread_join(track->mThread, &res);
+            track->mThreadStarted = false;
+            status_t status = static_cast<status_t>(reinterpret_cast<uintptr_t>(res));
+            if (err == OK && status != OK && status != ERROR_END_OF_STREAM) {
+                err = status;
+            }
+        }
+    }
+    if (mFd != -1) {
+        close(mFd);
+        mFd = -1;
+    }
+    return err;
+}
+
+bool FragmentedMP4Writer::reachedEOS() {
+    for (Track *track : mTracks) {
+        if (!track->mReachedEOS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// static
+void *FragmentedMP4Writer::ThreadWrapper(void *me) {
+    auto *arg = static_cast<std::pair<FragmentedMP4Writer *, Track *> *>(me);
+    FragmentedMP4Writer *writer = arg->first;
+    Track *track = arg->second;
+    delete arg;
+    return (void *)(uintptr_t)writer->threadFunc(track);
+}
+
+status_t FragmentedMP4Writer::threadFunc(Track *track) {
+    prctl(PR_SET_NAME, (unsigned long)"FragmentedMP4Writer", 0, 0, 0);
+    status_t err = OK;
+
+    while (!track->mDone) {
+        MediaBufferBase *buffer = nullptr;
+        err = track->mSource->read(&buffer);
+        if (err != OK) {
+            break;
+        }
+
+        int32_t isEos = 0;
+        if (buffer->meta_data().findInt32(kKeyIsEndOfStream, &isEos) && isEos) {
+            buffer->release();
+            err = ERROR_END_OF_STREAM;
+            break;
+        }
+        int32_t isMuxerData = 0;
+        if (buffer->meta_data().findInt32(kKeyIsMuxerData, &isMuxerData) && isMuxerData) {
+            // metadata samples (e.g. exif) have no place in the fragment
+            // stream
+            buffer->release();
+            continue;
+        }
+        if (buffer->range_length() == 0) {
+            buffer->release();
+            continue;
+        }
+
+        int64_t timeUs = 0;
+        CHECK(buffer->meta_data().findInt64(kKeyTime, &timeUs));
+        int32_t isSync = 0;
+        buffer->meta_data().findInt32(kKeyIsSyncFrame, &isSync);
+        if (track->mIsAudio) {
+            isSync = 1;
+        }
+
+        if (track->mBaseTimeUs < 0) {
+            track->mBaseTimeUs = timeUs;
+        }
+
+        // cut the fragment before a sample that both exceeds the target
+        // duration and (for video) starts a new sync run
+        if (!track->mSamples.empty()
+                && timeUs - track->mSamples.front().timeUs >= mFragmentDurationUs
+                && (track->mIsAudio || isSync)) {
+            status_t werr = writeFragment(track);
+            if (werr != OK) {
+                buffer->release();
+                err = werr;
+                break;
+            }
+        }
+
+        const uint8_t *data =
+                static_cast<const uint8_t *>(buffer->data()) + buffer->range_offset();
+        size_t size = buffer->range_length();
+        size_t before = track->mSampleData.size();
+        if (track->mIsAvc || track->mIsHevc) {
+            appendLengthPrefixed(data, size, &track->mSampleData);
+        } else {
+            track->mSampleData.write(data, size);
+        }
+        track->mSamples.push_back(
+                {(uint32_t)(track->mSampleData.size() - before), timeUs, isSync != 0});
+        buffer->release();
+    }
+
+    // flush whatever is left
+    if (!track->mSamples.empty()) {
+        status_t werr = writeFragment(track);
+        if (err == OK || err == ERROR_END_OF_STREAM) {
+            err = (werr == OK) ? err : werr;
+        }
+    }
+    track->mReachedEOS = true;
+    return err == ERROR_END_OF_STREAM ? OK : err;
+}
+
+status_t FragmentedMP4Writer::writeFragment(Track *track) {
+    BoxWriter &out = track->mBoxBuffer;
+    out.clear();
+
+    Mutex::Autolock autoLock(mWriteLock);
+    uint32_t sequenceNumber = mNextSequenceNumber++;
+
+    out.beginBox("moof");
+    out.beginBox("mfhd");
+    out.writeU32(0);  // version + flags
+    out.writeU32(sequenceNumber);
+    out.endBox();  // mfhd
+    out.beginBox("traf");
+    out.beginBox("tfhd");
+    out.writeU32(0x020000);  // default-base-is-moof
+    out.writeU32(track->mTrackId);
+    out.endBox();  // tfhd
+    out.beginBox("tfdt");
+    out.writeU8(1);  // version
+    out.writeU8(0); out.writeU16(0);  // flags
+    out.writeU64(track->mSamples.front().timeUs - track->mBaseTimeUs);
+    out.endBox();  // tfdt
+    out.beginBox("trun");
+    out.writeU8(0);
+    // flags: data-offset, sample-duration, sample-size, sample-flags
+    out.writeU8(0); out.writeU16(0x701);
+    out.writeU32(track->mSamples.size());
+    size_t dataOffsetPos = out.size();
+    out.writeU32(0);  // data_offset, patched below
+    for (size_t i = 0; i < track->mSamples.size(); ++i) {
+        const Track::Sample &sample = track->mSamples[i];
+        uint32_t durationUs;
+        if (i + 1 < track->mSamples.size()) {
+            durationUs = track->mSamples[i + 1].timeUs - sample.timeUs;
+            track->mLastDurationUs = durationUs;
+        } else {
+            // last sample in the fragment: repeat the previous delta
+            durationUs = track->mLastDurationUs;
+        }
+        out.writeU32(durationUs);
+        out.writeU32(sample.size);
+        out.writeU32(sample.sync ? kSyncSampleFlags : kNonSyncSampleFlags);
+    }
+    out.endBox();  // trun
+    out.endBox();  // traf
+    out.endBox();  // moof
+
+    // samples start right after the mdat header
+    out.patchU32(dataOffsetPos, out.size() + 8);
+    out.writeU32(track->mSampleData.size() + 8);
+    out.writeFourcc("mdat");
+
+    status_t err = writeAll(out.data(), out.size());
+    if (err == OK) {
+        err = writeAll(track->mSampleData.data(), track->mSampleData.size());
+    }
+
+    // keep the capacity; the next fragment reuses the allocations
+    track->mSampleData.clear();
+    track->mSamples.clear();
+    return err;
+}
+
+status_t FragmentedMP4Writer::writeInitSegment() {
+    BoxWriter out;
+
+    out.beginBox("ftyp");
+    out.writeFourcc("iso5");
+    out.writeU32(512);  // minor version
+    out.writeFourcc("iso5");
+    out.writeFourcc("iso6");
+    out.writeFourcc("mp41");
+    out.endBox();  // ftyp
+
+    out.beginBox("moov");
+
+    out.beginBox("mvhd");
+    out.writeU32(0);  // version + flags
+    out.writeU32(0);  // creation time
+    out.writeU32(0);  // modification time
+    out.writeU32(kMovieTimescale);
+    out.writeU32(0);  // duration: unknown, this is a live stream
+    out.writeU32(0x00010000);  // rate 1.0
+    out.writeU16(0x0100);  // volume 1.0
+    out.writeU16(0);  // reserved
+    out.writeU32(0); out.writeU32(0);  // reserved
+    // identity matrix
+    out.writeU32(0x00010000); out.writeU32(0); out.writeU32(0);
+    out.writeU32(0); out.writeU32(0x00010000); out.writeU32(0);
+    out.writeU32(0); out.writeU32(0); out.writeU32(0x40000000);
+    out.writeZeros(24);  // pre_defined
+    out.writeU32(mTracks.size() + 1);  // next track id
+    out.endBox();  // mvhd
+
+    for (Track *track : mTracks) {
+        sp<MetaData> meta = track->mSource->getFormat();
+        int32_t width = 0, height = 0, channelCount = 0, sampleRate = 0;
+        if (track->mIsAudio) {
+            if (!meta->findInt32(kKeyChannelCount, &channelCount)
+                    || !meta->findInt32(kKeySampleRate, &sampleRate)) {
+                ALOGE("Missing audio format keys");
+                return BAD_VALUE;
+            }
+        } else {
+            if (!meta->findInt32(kKeyWidth, &width)
+                    || !meta->findInt32(kKeyHeight, &height)) {
+                ALOGE("Missing video format keys");
+                return BAD_VALUE;
+            }
+        }
+
+        out.beginBox("trak");
+
+        out.beginBox("tkhd");
+        out.writeU32(0x7);  // version 0, flags: enabled | in movie | in preview
+        out.writeU32(0);  // creation time
+        out.writeU32(0);  // modification time
+        out.writeU32(track->mTrackId);
+        out.writeU32(0);  // reserved
+        out.writeU32(0);  // duration
+        out.writeU32(0); out.writeU32(0);  // reserved
+        out.writeU16(0);  // layer
+        out.writeU16(0);  // alternate group
+        out.writeU16(track->mIsAudio ? 0x0100 : 0);  // volume
+        out.writeU16(0);  // reserved
+        out.writeU32(0x00010000); out.writeU32(0); out.writeU32(0);
+        out.writeU32(0); out.writeU32(0x00010000); out.writeU32(0);
+        out.writeU32(0); out.writeU32(0); out.writeU32(0x40000000);
+        out.writeU32(width << 16);
+        out.writeU32(height << 16);
+        out.endBox();  // tkhd
+
+        out.beginBox("mdia");
+
+        out.beginBox("mdhd");
+        out.writeU32(0);  // version + flags
+        out.writeU32(0);  // creation time
+        out.writeU32(0);  // modification time
+        out.writeU32(kMediaTimescale);
+        out.writeU32(0);  // duration
+        out.writeU16(0x55C4);  // language: und
+        out.writeU16(0);  // pre_defined
+        out.endBox();  // mdhd
+
+        out.beginBox("hdlr");
+        out.writeU32(0);  // version + flags
+        out.writeU32(0);  // pre_defined
+        out.writeFourcc(track->mIsAudio ? "soun" : "vide");
+        out.writeZeros(12);  // reserved
+        const char *name = track->mIsAudio ? "SoundHandle" : "VideoHandle";
+        out.write(name, strlen(name) + 1);
+        out.endBox();  // hdlr
+
+        out.beginBox("minf");
+
+        if (track->mIsAudio) {
+            out.beginBox("smhd");
+            out.writeU32(0);  // version + flags
+            out.writeU16(0);  // balance
+            out.writeU16(0);  // reserved
+            out.endBox();  // smhd
+        } else {
+            out.beginBox("vmhd");
+            out.writeU32(1);  // version 0, flags 1
+            out.writeZeros(8);  // graphics mode + op color
+            out.endBox();  // vmhd
+        }
+
+        out.beginBox("dinf");
+        out.beginBox("dref");
+        out.writeU32(0);  // version + flags
+        out.writeU32(1);  // entry count
+        out.beginBox("url ");
+        out.writeU32(1);  // flags: self-contained
+        out.endBox();  // url
+        out.endBox();  // dref
+        out.endBox();  // dinf
+
+        out.beginBox("stbl");
+
+        out.beginBox("stsd");
+        out.writeU32(0);  // version + flags
+        out.writeU32(1);  // entry count
+        if (track->mIsAudio) {
+            out.beginBox("mp4a");
+            out.writeZeros(6);  // reserved
+            out.writeU16(1);  // data reference index
+            out.writeZeros(8);  // reserved
+            out.writeU16(channelCount);
+            out.writeU16(16);  // sample size
+            out.writeU32(0);  // pre_defined + reserved
+            out.writeU32((uint32_t)sampleRate << 16);
+
+            uint32_t type;
+            const void *esdsData = nullptr;
+            size_t esdsSize = 0;
+            const void *csd = nullptr;
+            size_t csdSize = 0;
+            if (meta->findData(kKeyESDS, &type, &esdsData, &esdsSize)) {
+                ESDS esds(esdsData, esdsSize);
+                if (esds.getCodecSpecificInfo(&csd, &csdSize) != OK) {
+                    csd = nullptr;
+                    csdSize = 0;
+                }
+            }
+            if (csd == nullptr || csdSize == 0 || csdSize >= 100) {
+                ALOGE("Missing or oversized AAC codec specific data");
+                return BAD_VALUE;
+            }
+            out.beginBox("esds");
+            out.writeU32(0);  // version + flags
+            out.writeU8(0x03);  // ES_DescrTag
+            out.writeU8(csdSize + 23);
+            out.writeU16(0);  // ES_ID
+            out.writeU8(0);  // flags
+            out.writeU8(0x04);  // DecoderConfigDescrTag
+            out.writeU8(csdSize + 15);
+            out.writeU8(0x40);  // objectTypeIndication: MPEG-4 audio
+            out.writeU8(0x15);  // streamType AudioStream
+            out.writeU8(0); out.writeU16(0x0300);  // buffer size
+            out.writeU32(0);  // max bitrate
+            out.writeU32(0);  // avg bitrate
+            out.writeU8(0x05);  // DecoderSpecificInfoTag
+            out.writeU8(csdSize);
+            out.write(csd, csdSize);
+            out.writeU8(0x06);  // SLConfigDescriptorTag
+            out.writeU8(0x01);
+            out.writeU8(0x02);
+            out.endBox();  // esds
+            out.endBox();  // mp4a
+        } else {
+            uint32_t type;
+            const void *config = nullptr;
+            size_t configSize = 0;
+            if (track->mIsAvc) {
+                if (!meta->findData(kKeyAVCC, &type, &config, &configSize)) {
+                    ALOGE("Missing avcC");
+                    return BAD_VALUE;
+                }
+            } else if (!meta->findData(kKeyHVCC, &type, &config, &configSize)) {
+                ALOGE("Missing hvcC");
+                return BAD_VALUE;
+            }
+            out.beginBox(track->mIsAvc ? "avc1" : "hvc1");
+            out.writeZeros(6);  // reserved
+            out.writeU16(1);  // data reference index
+            out.writeZeros(16);  // pre_defined + reserved
+            out.writeU16(width);
+            out.writeU16(height);
+            out.writeU32(0x00480000);  // horizontal resolution: 72 dpi
+            out.writeU32(0x00480000);  // vertical resolution: 72 dpi
+            out.writeU32(0);  // reserved
+            out.writeU16(1);  // frame count
+            out.writeZeros(32);  // compressor name
+            out.writeU16(0x0018);  // depth
+            out.writeU16(0xFFFF);  // pre_defined
+            out.beginBox(track->mIsAvc ? "avcC" : "hvcC");
+            out.write(config, configSize);
+            out.endBox();  // avcC / hvcC
+            out.endBox();  // avc1 / hvc1
+        }
+        out.endBox();  // stsd
+
+        // empty sample tables: all samples live in movie fragments
+        out.beginBox("stts");
+        out.writeU32(0); out.writeU32(0);
+        out.endBox();
+        out.beginBox("stsc");
+        out.writeU32(0); out.writeU32(0);
+        out.endBox();
+        out.beginBox("stsz");
+        out.writeU32(0); out.writeU32(0); out.writeU32(0);
+        out.endBox();
+        out.beginBox("stco");
+        out.writeU32(0); out.writeU32(0);
+        out.endBox();
+
+        out.endBox();  // stbl
+        out.endBox();  // minf
+        out.endBox();  // mdia
+        out.endBox();  // trak
+    }
+
+    out.beginBox("mvex");
+    for (Track *track : mTracks) {
+        out.beginBox("trex");
+        out.writeU32(0);  // version + flags
+        out.writeU32(track->mTrackId);
+        out.writeU32(1);  // default sample description index
+        out.writeU32(0);  // default sample duration
+        out.writeU32(0);  // default sample size
+        out.writeU32(0);  // default sample flags
+        out.endBox();  // trex
+    }
+    out.endBox();  // mvex
+
+    out.endBox();  // moov
+
+    return writeAll(out.data(), out.size());
+}
+
+status_t FragmentedMP4Writer::writeAll(const uint8_t *data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(mFd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ALOGE("write failed: %s", strerror(errno));
+            return -errno;
+        }
+        data += written;
+        size -= written;
+    }
+    return OK;
+}
+
+}  // namespace android
@@ -167,19 +167,29 @@ status_t FrameCaptureLayer::capture(const ui::PixelFormat reqPixelFormat,
         return err;
     }
 
-    // create out buffer
-    const uint32_t usage =
-            GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN |
-            GRALLOC_USAGE_HW_RENDER | GRALLOC_USAGE_HW_TEXTURE;
-    sp<GraphicBuffer> buffer = new GraphicBuffer(
-            sourceCrop.getWidth(), sourceCrop.getHeight(),
-            static_cast<android_pixel_format>(reqPixelFormat),
-            1, usage, std::string("thumbnail"));
+    // Reuse the out buffer across captures while the size and format match.
+    // The capture processor caches the render target's EGLImage by buffer id,
+    // so reuse lets repeated captures skip the per-frame image create and
+    // destroy. The caller only borrows the buffer to copy out of before the
+    // next capture.
+    if (mCaptureBuffer == nullptr
+            || mCaptureBuffer->getWidth() != (uint32_t)sourceCrop.getWidth()
+            || mCaptureBuffer->getHeight() != (uint32_t)sourceCrop.getHeight()
+            || mCaptureBuffer->getPixelFormat()
+                    != static_cast<android_pixel_format>(reqPixelFormat)) {
+        const uint32_t usage =
+                GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN |
+                GRALLOC_USAGE_HW_RENDER | GRALLOC_USAGE_HW_TEXTURE;
+        mCaptureBuffer = new GraphicBuffer(
+                sourceCrop.getWidth(), sourceCrop.getHeight(),
+                static_cast<android_pixel_format>(reqPixelFormat),
+                1, usage, std::string("thumbnail"));
+    }
 
     err = FrameCaptureProcessor::getInstance()->capture(
-            new BufferLayer(bi), sourceCrop, buffer);
+            new BufferLayer(bi), sourceCrop, mCaptureBuffer);
     if (err == OK) {
-        *outBuffer = buffer;
+        *outBuffer = mCaptureBuffer;
     }
 
     (void)releaseBuffer(bi);
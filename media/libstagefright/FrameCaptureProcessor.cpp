@@ -71,7 +71,7 @@ void FrameCaptureProcessor::PostReplyWithError(
 }
 
 FrameCaptureProcessor::FrameCaptureProcessor()
-    : mInitStatus(NO_INIT), mTextureName(0) {}
+    : mInitStatus(NO_INIT), mTextureName(0), mCleanupGeneration(0) {}
 
 FrameCaptureProcessor::~FrameCaptureProcessor() {
     if (mLooper != nullptr) {
@@ -158,7 +158,7 @@ status_t FrameCaptureProcessor::onCapture(const sp<Layer> &layer,
     base::unique_fd drawFence;
     mRE->useProtectedContext(false);
     status_t err = mRE->drawLayers(clientCompositionDisplay, clientCompositionLayers, buffer.get(),
-            /*useFramebufferCache=*/false, std::move(bufferFence), &drawFence);
+            /*useFramebufferCache=*/true, std::move(bufferFence), &drawFence);
 
     sp<Fence> fence = new Fence(std::move(drawFence));
 
@@ -171,7 +171,16 @@ status_t FrameCaptureProcessor::onCapture(const sp<Layer> &layer,
             err = OK;
         }
     }
-    mRE->cleanupPostRender(renderengine::RenderEngine::CleanupMode::CLEAN_ALL);
+
+    // Defer releasing GL resources until captures go idle. A thumbnailing
+    // burst reuses the cached images and texture bindings from one call to
+    // the next, so scrubbing them after every frame would make each capture
+    // pay the full setup cost again. The delayed message is dropped whenever
+    // a newer capture bumps the generation.
+    sp<AMessage> cleanupMsg = new AMessage(kWhatCleanup, this);
+    cleanupMsg->setInt32("generation", ++mCleanupGeneration);
+    cleanupMsg->post(kCleanupDelayUs);
+
     return err;
 }
 
@@ -206,6 +215,19 @@ void FrameCaptureProcessor::onMessageReceived(const sp<AMessage> &msg) {
 
             break;
         }
+        case kWhatCleanup:
+        {
+            int32_t generation;
+            CHECK(msg->findInt32("generation", &generation));
+
+            if (generation != mCleanupGeneration) {
+                // a newer capture is in flight and scheduled its own cleanup
+                break;
+            }
+
+            mRE->cleanupPostRender(renderengine::RenderEngine::CleanupMode::CLEAN_ALL);
+            break;
+        }
         default:
             TRESPASS();
     }
@@ -336,6 +336,33 @@ status_t FrameDecoder::init(
     return OK;
 }
 
+status_t FrameDecoder::extractFrames(
+        const std::vector<int64_t> &timesUs, std::vector<sp<IMemory>> *frames) {
+    frames->clear();
+    for (size_t i = 0; i < timesUs.size(); ++i) {
+        if (i > 0) {
+            // Rewind the pipeline for the next target: flush the codec and
+            // re-arm the seek; the codec instance, its buffers and the
+            // source stay warm across iterations.
+            status_t err = onSeekTo(timesUs[i], &mReadOptions);
+            if (err != OK) {
+                return err;
+            }
+            err = mDecoder->flush();
+            if (err != OK) {
+                ALOGW("decoder flush returned error %d (%s)", err, asString(err));
+                return err;
+            }
+            mHaveMoreInputs = true;
+            mFirstSample = true;
+            setFrame(NULL);
+        }
+        status_t err = extractInternal();
+        frames->push_back(err == OK ? mFrameMemory : NULL);
+    }
+    return OK;
+}
+
 sp<IMemory> FrameDecoder::extractFrame(FrameRect *rect) {
     status_t err = onExtractRect(rect);
     if (err == OK) {
@@ -497,6 +524,15 @@ VideoFrameDecoder::VideoFrameDecoder(
       mDefaultSampleDurationUs(0) {
 }
 
+status_t VideoFrameDecoder::onSeekTo(
+        int64_t frameTimeUs, MediaSource::ReadOptions *options) {
+    options->setSeekTo(frameTimeUs < 0 ? 0 : frameTimeUs, mSeekMode);
+    mTargetTimeUs = -1LL;
+    mFrame = NULL;
+    mSampleDurations.clear();
+    return OK;
+}
+
 sp<AMessage> VideoFrameDecoder::onGetFormatAndSeekOptions(
         int64_t frameTimeUs, int seekMode,
         MediaSource::ReadOptions *options,
@@ -26,6 +26,7 @@
 #include <sys/prctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <utils/Log.h>
@@ -41,6 +42,7 @@
 #include <media/stagefright/foundation/ByteUtils.h>
 #include <media/stagefright/foundation/ColorUtils.h>
 #include <media/stagefright/foundation/avc_utils.h>
+#include <media/stagefright/GaplessTimeline.h>
 #include <media/stagefright/MPEG4Writer.h>
 #include <media/stagefright/MediaBuffer.h>
 #include <media/stagefright/MetaData.h>
@@ -73,6 +75,10 @@ static const int64_t kInitialDelayTimeUs     = 700000LL;
 static const int64_t kMaxMetadataSize = 0x4000000LL;   // 64MB max per-frame metadata size
 static const int64_t kMaxCttsOffsetTimeUs = 30 * 60 * 1000000LL;  // 30 minutes
 static const size_t kESDSScratchBufferSize = 10;  // kMaxAtomSize in Mpeg4Extractor 64MB
+// In-memory budget for chunks buffered ahead of the writer thread; track threads
+// are throttled in bufferChunk() beyond this point so that memory stays bounded
+// when storage falls behind. Configurable via "media.recorder.chunk_budget_mb".
+static const int32_t kDefaultChunkBudgetMb = 32;
 
 static const char kMetaKey_Version[]    = "com.android.version";
 static const char kMetaKey_Manufacturer[]      = "com.android.manufacturer";
@@ -1108,6 +1114,7 @@ status_t MPEG4Writer::stopWriterThread() {
         Mutex::Autolock autolock(mLock);
         mDone = true;
         mChunkReadyCondition.signal();
+        mChunkFlushedCondition.broadcast();
     }
 
     void *dummy;
@@ -1362,21 +1369,27 @@ status_t MPEG4Writer::reset(bool stopSource, bool waitForAnyPreviousCallToComple
     seekOrPostError(mFd, mOffset, SEEK_SET);
     mMdatEndOffset = mOffset;
 
-    // Construct file-level meta and moov box now
+    // Construct file-level meta and moov box now.
+    // The boxes are serialized into the in-memory cache even when the file is not
+    // streamable (i.e. no free box was reserved at the beginning of the file), and
+    // then appended with a single large write. Serializing straight to the fd would
+    // issue one small write per field, making stop() latency grow with the number
+    // of table entries accumulated during recording.
     mInMemoryCacheOffset = 0;
-    mWriteBoxToMemory = mStreamableFile;
-    if (mWriteBoxToMemory) {
-        // There is no need to allocate in-memory cache
-        // if the file is not streamable.
-
-        mInMemoryCache = (uint8_t *) malloc(mInMemoryCacheSize);
-        CHECK(mInMemoryCache != NULL);
-    }
+    mWriteBoxToMemory = true;
+    mInMemoryCache = (uint8_t *) malloc(mInMemoryCacheSize);
+    CHECK(mInMemoryCache != NULL);
 
     if (mHasFileLevelMeta) {
         writeFileLevelMetaBox();
+        // mWriteBoxToMemory could be set to false in
+        // MPEG4Writer::write() method
         if (mWriteBoxToMemory) {
-            writeCachedBoxToFile("meta");
+            if (mStreamableFile) {
+                writeCachedBoxToFile("meta");
+            } else {
+                appendCachedBoxToFile("meta");
+            }
         } else {
             ALOGI("The file meta box is written at the end.");
         }
@@ -1387,7 +1400,11 @@ status_t MPEG4Writer::reset(bool stopSource, bool waitForAnyPreviousCallToComple
         // mWriteBoxToMemory could be set to false in
         // MPEG4Writer::write() method
         if (mWriteBoxToMemory) {
-            writeCachedBoxToFile("moov");
+            if (mStreamableFile) {
+                writeCachedBoxToFile("moov");
+            } else {
+                appendCachedBoxToFile("moov");
+            }
         } else {
             ALOGI("The mp4 file will not be streamable.");
         }
@@ -1449,6 +1466,31 @@ void MPEG4Writer::writeCachedBoxToFile(const char *type) {
             type, (long long)mInMemoryCacheSize);
 }
 
+/*
+ * Appends the currently cached box at the current end of the file with a single
+ * write, for files without a reserved free box at the beginning.
+ *
+ * Must be called while mWriteBoxToMemory is true, and will not modify
+ * mWriteBoxToMemory. After the call, remaining cache size will be
+ * reduced and buffer offset will be set to the beginning of the cache.
+ */
+void MPEG4Writer::appendCachedBoxToFile(const char *type) {
+    CHECK(mWriteBoxToMemory);
+
+    mWriteBoxToMemory = false;
+
+    seekOrPostError(mFd, mOffset, SEEK_SET);
+    write(mInMemoryCache, 1, mInMemoryCacheOffset);
+
+    // Rewind buffering to the beginning, and restore mWriteBoxToMemory flag
+    mInMemoryCacheSize -= mInMemoryCacheOffset;
+    mInMemoryCacheOffset = 0;
+    mWriteBoxToMemory = true;
+
+    ALOGV("appended %s box, estimated size remaining %lld",
+            type, (long long)mInMemoryCacheSize);
+}
+
 uint32_t MPEG4Writer::getMpeg4Time() {
     time_t now = time(NULL);
     // MP4 file uses time counting seconds since midnight, Jan. 1, 1904
@@ -1659,6 +1701,11 @@ static void StripStartcode(MediaBuffer *buffer) {
     }
 }
 
+// Access units at high bitrates carry many NAL units; emitting them in
+// batches keeps the writer thread at one gathered write per batch instead
+// of two write syscalls (and a MediaBuffer allocation) per NAL.
+static const size_t kMaxNalsPerBatch = 32;
+
 void MPEG4Writer::addMultipleLengthPrefixedSamples_l(MediaBuffer *buffer) {
     const uint8_t *dataStart = (const uint8_t *)buffer->data() + buffer->range_offset();
     const uint8_t *currentNalStart = dataStart;
@@ -1667,46 +1714,74 @@ void MPEG4Writer::addMultipleLengthPrefixedSamples_l(MediaBuffer *buffer) {
     size_t nextNalSize;
     size_t searchSize = buffer->range_length();
 
+    const uint8_t *nalStarts[kMaxNalsPerBatch];
+    size_t nalSizes[kMaxNalsPerBatch];
+    size_t numNals = 0;
+
     while (getNextNALUnit(&data, &searchSize, &nextNalStart,
             &nextNalSize, true) == OK) {
-        size_t currentNalSize = nextNalStart - currentNalStart - 4 /* strip start-code */;
-        MediaBuffer *nalBuf = new MediaBuffer((void *)currentNalStart, currentNalSize);
-        addLengthPrefixedSample_l(nalBuf);
-        nalBuf->release();
+        if (numNals == kMaxNalsPerBatch) {
+            writeLengthPrefixedNals_l(nalStarts, nalSizes, numNals);
+            numNals = 0;
+        }
+        nalStarts[numNals] = currentNalStart;
+        nalSizes[numNals] = nextNalStart - currentNalStart - 4 /* strip start-code */;
+        ++numNals;
 
         currentNalStart = nextNalStart;
     }
 
+    // the last NAL unit runs to the end of the access unit
+    if (numNals == kMaxNalsPerBatch) {
+        writeLengthPrefixedNals_l(nalStarts, nalSizes, numNals);
+        numNals = 0;
+    }
     size_t currentNalOffset = currentNalStart - dataStart;
-    buffer->set_range(buffer->range_offset() + currentNalOffset,
-            buffer->range_length() - currentNalOffset);
-    addLengthPrefixedSample_l(buffer);
+    nalStarts[numNals] = currentNalStart;
+    nalSizes[numNals] = buffer->range_length() - currentNalOffset;
+    ++numNals;
+
+    writeLengthPrefixedNals_l(nalStarts, nalSizes, numNals);
 }
 
 void MPEG4Writer::addLengthPrefixedSample_l(MediaBuffer *buffer) {
     ALOGV("alp:buffer->range_length:%lld", (long long)buffer->range_length());
-    size_t length = buffer->range_length();
-    if (mUse4ByteNalLength) {
-        ALOGV("mUse4ByteNalLength");
-        uint8_t x[4];
-        x[0] = length >> 24;
-        x[1] = (length >> 16) & 0xff;
-        x[2] = (length >> 8) & 0xff;
-        x[3] = length & 0xff;
-        writeOrPostError(mFd, &x, 4);
-        writeOrPostError(mFd, (const uint8_t*)buffer->data() + buffer->range_offset(), length);
-        mOffset += length + 4;
-    } else {
-        ALOGV("mUse2ByteNalLength");
-        CHECK_LT(length, 65536u);
+    const uint8_t *nalStart = (const uint8_t *)buffer->data() + buffer->range_offset();
+    size_t nalSize = buffer->range_length();
+    writeLengthPrefixedNals_l(&nalStart, &nalSize, 1);
+}
+
+void MPEG4Writer::writeLengthPrefixedNals_l(
+        const uint8_t *const *nalStarts, const size_t *nalSizes, size_t count) {
+    CHECK_LE(count, kMaxNalsPerBatch);
+
+    const size_t prefixSize = mUse4ByteNalLength ? 4 : 2;
+    uint8_t prefixes[kMaxNalsPerBatch][4];
+    struct iovec iov[2 * kMaxNalsPerBatch];
+    size_t totalBytes = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t length = nalSizes[i];
+        if (mUse4ByteNalLength) {
+            prefixes[i][0] = length >> 24;
+            prefixes[i][1] = (length >> 16) & 0xff;
+            prefixes[i][2] = (length >> 8) & 0xff;
+            prefixes[i][3] = length & 0xff;
+        } else {
+            CHECK_LT(length, 65536u);
+            prefixes[i][0] = length >> 8;
+            prefixes[i][1] = length & 0xff;
+        }
 
-        uint8_t x[2];
-        x[0] = length >> 8;
-        x[1] = length & 0xff;
-        writeOrPostError(mFd, &x, 2);
-        writeOrPostError(mFd, (const uint8_t*)buffer->data() + buffer->range_offset(), length);
-        mOffset += length + 2;
+        iov[2 * i].iov_base = prefixes[i];
+        iov[2 * i].iov_len = prefixSize;
+        iov[2 * i + 1].iov_base = const_cast<uint8_t *>(nalStarts[i]);
+        iov[2 * i + 1].iov_len = length;
+        totalBytes += prefixSize + length;
     }
+
+    writevOrPostError(mFd, iov, 2 * count, totalBytes);
+    mOffset += totalBytes;
 }
 
 size_t MPEG4Writer::write(
@@ -1774,6 +1849,34 @@ void MPEG4Writer::writeOrPostError(int fd, const void* buf, size_t count) {
     WARN_UNLESS(msg->post() == OK, "writeOrPostError:error posting ERROR_IO");
 }
 
+void MPEG4Writer::writevOrPostError(
+        int fd, const struct iovec *iov, int iovcnt, size_t totalBytes) {
+    if (mWriteSeekErr == true)
+        return;
+
+    auto beforeTP = std::chrono::high_resolution_clock::now();
+    ssize_t bytesWritten = ::writev(fd, iov, iovcnt);
+    auto afterTP = std::chrono::high_resolution_clock::now();
+    auto writeDuration =
+            std::chrono::duration_cast<std::chrono::microseconds>(afterTP - beforeTP).count();
+    mWriteDurationPQ.emplace(writeDuration);
+    if (mWriteDurationPQ.size() > kWriteDurationsCount) {
+        mWriteDurationPQ.pop();
+    }
+
+    if (bytesWritten == (ssize_t)totalBytes)
+        return;
+    mWriteSeekErr = true;
+    // Note that errno is not changed even when bytesWritten < totalBytes.
+    ALOGE("writevOrPostError bytesWritten:%zd, totalBytes:%zu, error:%s(%d)", bytesWritten,
+          totalBytes, std::strerror(errno), errno);
+
+    // Can't guarantee that file is usable or write would succeed anymore, hence signal to stop.
+    sp<AMessage> msg = new AMessage(kWhatIOError, mReflector);
+    msg->setInt32("err", ERROR_IO);
+    WARN_UNLESS(msg->post() == OK, "writevOrPostError:error posting ERROR_IO");
+}
+
 void MPEG4Writer::seekOrPostError(int fd, off64_t offset, int whence) {
     if (mWriteSeekErr == true)
         return;
@@ -2722,16 +2825,37 @@ void *MPEG4Writer::ThreadWrapper(void *me) {
     return NULL;
 }
 
+// static
+size_t MPEG4Writer::chunkDataSize(const Chunk& chunk) {
+    size_t size = 0;
+    for (List<MediaBuffer *>::const_iterator it = chunk.mSamples.begin();
+         it != chunk.mSamples.end(); ++it) {
+        size += (*it)->range_length();
+    }
+    return size;
+}
+
 void MPEG4Writer::bufferChunk(const Chunk& chunk) {
     ALOGV("bufferChunk: %p", chunk.mTrack);
     Mutex::Autolock autolock(mLock);
     CHECK_EQ(mDone, false);
 
+    const size_t chunkSize = chunkDataSize(chunk);
+    // Throttle the track thread if the chunks buffered ahead of the writer thread
+    // exceed the in-memory budget. The writer thread broadcasts after each batch it
+    // writes, and there is always at least one pending chunk while we wait, so this
+    // cannot deadlock. A single chunk larger than the budget is still accepted.
+    while (!mDone && mBufferedChunkSize != 0
+            && mBufferedChunkSize + chunkSize > mChunkBudgetBytes) {
+        mChunkFlushedCondition.wait(mLock);
+    }
+
     for (List<ChunkInfo>::iterator it = mChunkInfos.begin();
          it != mChunkInfos.end(); ++it) {
 
         if (chunk.mTrack == it->mTrack) {  // Found owner
             it->mChunks.push_back(chunk);
+            mBufferedChunkSize += chunkSize;
             mChunkReadyCondition.signal();
             return;
         }
@@ -2785,6 +2909,7 @@ void MPEG4Writer::writeAllChunks() {
     sendSessionSummary();
 
     mChunkInfos.clear();
+    mBufferedChunkSize = 0;
     ALOGD("%zu chunks are written in the last batch", outstandingChunks);
 }
 
@@ -2851,18 +2976,26 @@ void MPEG4Writer::threadFunc() {
             mChunkReadyCondition.wait(mLock);
         }
 
-        // In real time recording mode, write without holding the lock in order
-        // to reduce the blocking time for media track threads.
-        // Otherwise, hold the lock until the existing chunks get written to the
-        // file.
+        // Drain all currently pending chunks into a local batch, then write the
+        // batch without holding the lock. Track threads can thus block at most on
+        // the brief list operations above, never on storage, and the batch costs a
+        // single lock round trip no matter how many chunks have accumulated.
         if (chunkFound) {
-            if (mIsRealTimeRecording) {
-                mLock.unlock();
-            }
-            writeChunkToFile(&chunk);
-            if (mIsRealTimeRecording) {
-                mLock.lock();
+            List<Chunk> batch;
+            size_t batchSize = 0;
+            do {
+                batchSize += chunkDataSize(chunk);
+                batch.push_back(chunk);
+            } while (findChunkToWrite(&chunk));
+
+            mLock.unlock();
+            for (List<Chunk>::iterator it = batch.begin(); it != batch.end(); ++it) {
+                writeChunkToFile(&*it);
             }
+            mLock.lock();
+
+            mBufferedChunkSize -= batchSize;
+            mChunkFlushedCondition.broadcast();
         }
     }
 
@@ -2878,6 +3011,9 @@ status_t MPEG4Writer::startWriterThread() {
     mDone = false;
     mIsFirstChunk = true;
     mDriftTimeUs = 0;
+    mBufferedChunkSize = 0;
+    mChunkBudgetBytes = (size_t)property_get_int32(
+            "media.recorder.chunk_budget_mb", kDefaultChunkBudgetMb) * 1024 * 1024;
     for (List<Track *>::iterator it = mTracks.begin();
          it != mTracks.end(); ++it) {
         ChunkInfo info;
@@ -3456,7 +3592,7 @@ status_t MPEG4Writer::Track::threadEntry() {
     int64_t lastDurationTicks = 0;    // Timescale based ticks
     int32_t sampleCount = 1;          // Sample count in the current stts table entry
     uint32_t previousSampleSize = 0;  // Size of the previous sample
-    int64_t previousPausedDurationUs = 0;
+    GaplessTimeline gaplessTimeline;
     int64_t timestampUs = 0;
     int64_t cttsOffsetTimeUs = 0;
     int64_t currCttsOffsetTimeTicks = 0;   // Timescale based ticks
@@ -3495,9 +3631,9 @@ status_t MPEG4Writer::Track::threadEntry() {
                 int64_t eosSampleTimestampUs = -1;
                 CHECK(buffer->meta_data().findInt64(kKeyTime, &eosSampleTimestampUs));
                 if (eosSampleTimestampUs > 0) {
-                    lastSampleDurationUs = eosSampleTimestampUs -
-                                           previousSampleTimestampWithoutFudgeUs -
-                                           previousPausedDurationUs;
+                    lastSampleDurationUs =
+                            gaplessTimeline.rebase(eosSampleTimestampUs) -
+                            previousSampleTimestampWithoutFudgeUs;
                     if (lastSampleDurationUs >= 0) {
                         lastSampleDurationTicks = (lastSampleDurationUs * mTimeScale + 500000LL) /
                                                   1000000LL;
@@ -3724,31 +3860,23 @@ status_t MPEG4Writer::Track::threadEntry() {
                 }
                 mOwner->setStartTimestampUs(timestampUs);
                 mStartTimestampUs = timestampUs;
-                previousPausedDurationUs = mStartTimestampUs;
+                gaplessTimeline.setStartTimeUs(mStartTimestampUs);
             }
 
             if (mResumed) {
-                int64_t durExcludingEarlierPausesUs = timestampUs - previousPausedDurationUs;
-                if (WARN_UNLESS(durExcludingEarlierPausesUs >= 0LL, "for %s track", trackName)) {
-                    copy->release();
-                    mSource->stop();
-                    mIsMalformed = true;
-                    break;
-                }
-
-                int64_t pausedDurationUs = durExcludingEarlierPausesUs - mTrackDurationUs;
-                if (WARN_UNLESS(pausedDurationUs >= lastDurationUs, "for %s track", trackName)) {
+                status_t rebaseErr = gaplessTimeline.onResume(
+                        timestampUs, mTrackDurationUs, lastDurationUs);
+                if (WARN_UNLESS(rebaseErr == OK, "for %s track", trackName)) {
                     copy->release();
                     mSource->stop();
                     mIsMalformed = true;
                     break;
                 }
 
-                previousPausedDurationUs += pausedDurationUs - lastDurationUs;
                 mResumed = false;
             }
             TimestampDebugHelperEntry timestampDebugEntry;
-            timestampUs -= previousPausedDurationUs;
+            timestampUs = gaplessTimeline.rebase(timestampUs);
             timestampDebugEntry.pts = timestampUs;
             if (WARN_UNLESS(timestampUs >= 0LL, "for %s track", trackName)) {
                 copy->release();
@@ -3765,7 +3893,7 @@ status_t MPEG4Writer::Track::threadEntry() {
                  */
                 int64_t decodingTimeUs;
                 CHECK(meta_data->findInt64(kKeyDecodingTime, &decodingTimeUs));
-                decodingTimeUs -= previousPausedDurationUs;
+                decodingTimeUs = gaplessTimeline.rebase(decodingTimeUs);
 
                 // ensure non-negative, monotonic decoding time
                 if (mLastDecodingTimeUs < 0) {
@@ -3855,7 +3983,7 @@ status_t MPEG4Writer::Track::threadEntry() {
             }
 
             ALOGV("%s media time stamp: %" PRId64 " and previous paused duration %" PRId64,
-                    trackName, timestampUs, previousPausedDurationUs);
+                    trackName, timestampUs, gaplessTimeline.pausedDurationUs());
             if (timestampUs > mTrackDurationUs) {
                 mTrackDurationUs = timestampUs;
             }
@@ -24,6 +24,11 @@
 // TODO : check if this works for NDK apps without JVM
 // #include <media/ndk/NdkJavaVMHelperPriv.h>
 
+#include <sys/stat.h>
+
+#include <deque>
+#include <tuple>
+
 namespace android {
 
 struct MediaAppender::sampleDataInfo {
@@ -33,6 +38,97 @@ struct MediaAppender::sampleDataInfo {
     sp<MetaData> meta;
 };
 
+// Everything init() learns about the destination by scanning it, snapshotted
+// so a later session can resume without re-scanning.  The sample metadata is
+// immutable after the scan and may be shared between sessions; the track
+// formats are mutated per session (sample-time-before-append) so they are
+// dup()ed on both store and restore.
+struct MediaAppender::TailState : public RefBase {
+    MediaMuxer::OutputFormat format;
+    size_t trackCount;
+    std::map<size_t, sp<AMessage>> fmtIndexMap;
+    std::vector<size_t> sampleCountVect;
+    std::vector<int64_t> maxTimestampVect;
+    std::vector<int64_t> lastSyncSampleTimeVect;
+    std::vector<sampleDataInfo> sdi;
+};
+
+namespace {
+
+// Tail-resume cache.
+//
+// The per-sample scan in init() is linear in the number of samples already
+// in the destination, so appending a short clip to a large dashcam file is
+// dominated by re-parsing content that was parsed by the previous session.
+// The cache keys a TailState on the destination's identity (dev/ino), size,
+// mtime and the append mode (the mode determines how the tail GOP was
+// trimmed); any modification of the file changes size or mtime and makes
+// stale entries unreachable until they age out.
+//
+// MediaAppender only receives a file descriptor, so the cache is in-process
+// rather than a sidecar file; it serves apps that append to the same
+// destination repeatedly, or open it several times before writing.
+struct TailStateKey {
+    dev_t dev;
+    ino_t ino;
+    off64_t size;
+    int64_t mtimeNs;
+    int mode;
+
+    bool operator<(const TailStateKey& other) const {
+        return std::tie(dev, ino, size, mtimeNs, mode) <
+                std::tie(other.dev, other.ino, other.size, other.mtimeNs, other.mode);
+    }
+};
+
+constexpr size_t kMaxCachedTailStates = 4;
+
+std::mutex gTailStateMutex;
+std::map<TailStateKey, sp<MediaAppender::TailState>> gTailStates;  // GUARDED_BY(gTailStateMutex)
+std::deque<TailStateKey> gTailStateOrder;                          // GUARDED_BY(gTailStateMutex)
+
+bool makeTailStateKey(int fd, int mode, TailStateKey* key) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    key->dev = st.st_dev;
+    key->ino = st.st_ino;
+    key->size = st.st_size;
+    key->mtimeNs = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    key->mode = mode;
+    return true;
+}
+
+}  // namespace
+
+// static
+sp<MediaAppender::TailState> MediaAppender::getTailState(int fd, AppendMode mode) {
+    TailStateKey key;
+    if (!makeTailStateKey(fd, mode, &key)) {
+        return nullptr;
+    }
+    std::scoped_lock lock(gTailStateMutex);
+    auto it = gTailStates.find(key);
+    return it != gTailStates.end() ? it->second : nullptr;
+}
+
+// static
+void MediaAppender::putTailState(int fd, AppendMode mode, const sp<TailState>& state) {
+    TailStateKey key;
+    if (!makeTailStateKey(fd, mode, &key)) {
+        return;
+    }
+    std::scoped_lock lock(gTailStateMutex);
+    if (gTailStates.emplace(key, state).second) {
+        gTailStateOrder.emplace_back(key);
+        if (gTailStateOrder.size() > kMaxCachedTailStates) {
+            gTailStates.erase(gTailStateOrder.front());
+            gTailStateOrder.pop_front();
+        }
+    }
+}
+
 sp<MediaAppender> MediaAppender::create(int fd, AppendMode mode) {
     if (fd < 0) {
         ALOGE("invalid file descriptor");
@@ -69,6 +165,26 @@ MediaAppender::MediaAppender(int fd, AppendMode mode)
 status_t MediaAppender::init() {
     std::scoped_lock lock(mMutex);
     ALOGV("MediaAppender::init");
+
+    // Tail resume: if a previous session parsed this destination and the
+    // file is unchanged since, restore its state instead of re-scanning
+    // every sample.
+    if (sp<TailState> state = getTailState(mFd, mMode); state != nullptr) {
+        ALOGV("MediaAppender::init tail resume, %zu samples", state->sdi.size());
+        mFormat = state->format;
+        mTrackCount = state->trackCount;
+        for (const auto& [exTrackIndex, fmt] : state->fmtIndexMap) {
+            mFmtIndexMap.emplace(exTrackIndex, fmt->dup());
+        }
+        mSampleCountVect = state->sampleCountVect;
+        mMaxTimestampVect = state->maxTimestampVect;
+        mLastSyncSampleTimeVect = state->lastSyncSampleTimeVect;
+        mSDI = state->sdi;
+        mExtractor.clear();
+        mState = INITIALIZED;
+        return OK;
+    }
+
     status_t status = mExtractor->setDataSource(mFd, 0, lseek(mFd, 0, SEEK_END));
     if (status != OK) {
         ALOGE("extractor_setDataSource failed, status :%d", status);
@@ -291,6 +407,23 @@ status_t MediaAppender::init() {
     for (size_t i = 0; i < mSampleCountVect.size(); ++i) {
         ALOGV("SampleCountVect[%zu]:%zu", i, mSampleCountVect[i]);
     }
+
+    // Snapshot the parsed tail state so a later session on this (still
+    // unmodified) destination can skip the scan above.
+    sp<TailState> state = new (std::nothrow) TailState();
+    if (state != nullptr) {
+        state->format = mFormat;
+        state->trackCount = mTrackCount;
+        for (const auto& [trackIndex, fmt] : mFmtIndexMap) {
+            state->fmtIndexMap.emplace(trackIndex, fmt->dup());
+        }
+        state->sampleCountVect = mSampleCountVect;
+        state->maxTimestampVect = mMaxTimestampVect;
+        state->lastSyncSampleTimeVect = mLastSyncSampleTimeVect;
+        state->sdi = mSDI;
+        putTailState(mFd, mMode, state);
+    }
+
     mState = INITIALIZED;
     return OK;
 }
@@ -79,6 +79,7 @@ void MediaClock::reset() {
 void MediaClock::setStartingTimeMedia(int64_t startingTimeMediaUs) {
     Mutex::Autolock autoLock(mLock);
     mStartingTimeMediaUs = startingTimeMediaUs;
+    publishTimeline_l();
 }
 
 void MediaClock::clearAnchor() {
@@ -112,6 +113,7 @@ void MediaClock::updateAnchor(
             mAnchorTimeMediaUs + (nowUs - mAnchorTimeRealUs) * (double)mPlaybackRate;
         if (nowMediaUs < oldNowMediaUs + kAnchorFluctuationAllowedUs
                 && nowMediaUs > oldNowMediaUs - kAnchorFluctuationAllowedUs) {
+            publishTimeline_l(); // mMaxTimeMediaUs above may have changed.
             return;
         }
     }
@@ -124,6 +126,7 @@ void MediaClock::updateAnchor(
 void MediaClock::updateMaxTimeMedia(int64_t maxTimeMediaUs) {
     Mutex::Autolock autoLock(mLock);
     mMaxTimeMediaUs = maxTimeMediaUs;
+    publishTimeline_l();
 }
 
 void MediaClock::setPlaybackRate(float rate) {
@@ -159,10 +162,66 @@ status_t MediaClock::getMediaTime(
         return BAD_VALUE;
     }
 
+    // The snapshot mirrors the locked state, so the common case pays a few
+    // loads instead of contending with timer processing under mLock. Take
+    // the lock only when an update is in flight for longer than a few
+    // retries, or before the first anchor is published.
+    status_t status = getMediaTimeLockless(realUs, outMediaUs, allowPastMaxTime);
+    if (status != WOULD_BLOCK) {
+        return status;
+    }
+
     Mutex::Autolock autoLock(mLock);
     return getMediaTime_l(realUs, outMediaUs, allowPastMaxTime);
 }
 
+status_t MediaClock::getMediaTimeLockless(
+        int64_t realUs, int64_t *outMediaUs, bool allowPastMaxTime) const {
+    if (outMediaUs == NULL) {
+        return BAD_VALUE;
+    }
+
+    for (int attempt = 0; attempt < 3; attempt++) {
+        const uint32_t seq = mTimelineSeq.load(std::memory_order_acquire);
+        if (seq & 1) {
+            continue; // an update is in flight; it is only a few stores away.
+        }
+        const int64_t anchorTimeMediaUs =
+                mSnapAnchorTimeMediaUs.load(std::memory_order_relaxed);
+        const int64_t anchorTimeRealUs =
+                mSnapAnchorTimeRealUs.load(std::memory_order_relaxed);
+        const int64_t maxTimeMediaUs =
+                mSnapMaxTimeMediaUs.load(std::memory_order_relaxed);
+        const int64_t startingTimeMediaUs =
+                mSnapStartingTimeMediaUs.load(std::memory_order_relaxed);
+        const float playbackRate = mSnapPlaybackRate.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (mTimelineSeq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+
+        // same computation as getMediaTime_l(), on the snapshot.
+        if (anchorTimeRealUs == -1) {
+            return NO_INIT;
+        }
+
+        int64_t mediaUs = anchorTimeMediaUs
+                + (realUs - anchorTimeRealUs) * (double)playbackRate;
+        if (mediaUs > maxTimeMediaUs && !allowPastMaxTime) {
+            mediaUs = maxTimeMediaUs;
+        }
+        if (mediaUs < startingTimeMediaUs) {
+            mediaUs = startingTimeMediaUs;
+        }
+        if (mediaUs < 0) {
+            mediaUs = 0;
+        }
+        *outMediaUs = mediaUs;
+        return OK;
+    }
+    return WOULD_BLOCK;
+}
+
 status_t MediaClock::getMediaTime_l(
         int64_t realUs, int64_t *outMediaUs, bool allowPastMaxTime) const {
     if (mAnchorTimeRealUs == -1) {
@@ -318,6 +377,9 @@ void MediaClock::updateAnchorTimesAndPlaybackRate_l(int64_t anchorTimeMediaUs,
         mPlaybackRate = playbackRate;
         notifyDiscontinuity_l();
     }
+    // republish even when the anchor is unchanged, as the caller may have
+    // modified the max or starting time before getting here.
+    publishTimeline_l();
 }
 
 void MediaClock::setNotificationMessage(const sp<AMessage> &msg) {
@@ -325,6 +387,18 @@ void MediaClock::setNotificationMessage(const sp<AMessage> &msg) {
     mNotify = msg;
 }
 
+void MediaClock::publishTimeline_l() {
+    const uint32_t seq = mTimelineSeq.load(std::memory_order_relaxed);
+    mTimelineSeq.store(seq + 1, std::memory_order_relaxed); // odd: update in flight
+    std::atomic_thread_fence(std::memory_order_release);
+    mSnapAnchorTimeMediaUs.store(mAnchorTimeMediaUs, std::memory_order_relaxed);
+    mSnapAnchorTimeRealUs.store(mAnchorTimeRealUs, std::memory_order_relaxed);
+    mSnapMaxTimeMediaUs.store(mMaxTimeMediaUs, std::memory_order_relaxed);
+    mSnapStartingTimeMediaUs.store(mStartingTimeMediaUs, std::memory_order_relaxed);
+    mSnapPlaybackRate.store(mPlaybackRate, std::memory_order_relaxed);
+    mTimelineSeq.store(seq + 2, std::memory_order_release);
+}
+
 void MediaClock::notifyDiscontinuity_l() {
     if (mNotify != nullptr) {
         sp<AMessage> msg = mNotify->dup();
@@ -73,6 +73,7 @@
 #include <media/stagefright/MediaCodecConstants.h>
 #include <media/stagefright/MediaCodecList.h>
 #include <media/stagefright/MediaCodecConstants.h>
+#include <media/stagefright/MediaCodecPool.h>
 #include <media/stagefright/MediaDefs.h>
 #include <media/stagefright/MediaErrors.h>
 #include <media/stagefright/MediaFilter.h>
@@ -156,6 +157,9 @@ static const char *kCodecLatencyMax = "android.media.mediacodec.latency.max";
 static const char *kCodecLatencyMin = "android.media.mediacodec.latency.min";   /* in us */
 static const char *kCodecLatencyAvg = "android.media.mediacodec.latency.avg";   /* in us */
 static const char *kCodecLatencyCount = "android.media.mediacodec.latency.n";
+static const char *kCodecLatencyP50 = "android.media.mediacodec.latency.p50";   /* in us */
+static const char *kCodecLatencyP95 = "android.media.mediacodec.latency.p95";   /* in us */
+static const char *kCodecLatencyP99 = "android.media.mediacodec.latency.p99";   /* in us */
 static const char *kCodecLatencyHist = "android.media.mediacodec.latency.hist"; /* in us */
 static const char *kCodecLatencyUnknown = "android.media.mediacodec.latency.unknown";
 static const char *kCodecQueueSecureInputBufferError = "android.media.mediacodec.queueSecureInputBufferError";
@@ -739,8 +743,15 @@ sp<MediaCodec> MediaCodec::CreateByType(
         *err = NAME_NOT_FOUND;
     }
     for (size_t i = 0; i < matchingCodecs.size(); ++i) {
-        sp<MediaCodec> codec = new MediaCodec(looper, pid, uid);
         AString componentName = matchingCodecs[i];
+        sp<MediaCodec> codec = MediaCodecPool::obtain(componentName);
+        if (codec != NULL) {
+            if (err != NULL) {
+                *err = OK;
+            }
+            return codec;
+        }
+        codec = new MediaCodec(looper, pid, uid);
         status_t ret = codec->init(componentName);
         if (err != NULL) {
             *err = ret;
@@ -757,7 +768,14 @@ sp<MediaCodec> MediaCodec::CreateByType(
 // static
 sp<MediaCodec> MediaCodec::CreateByComponentName(
         const sp<ALooper> &looper, const AString &name, status_t *err, pid_t pid, uid_t uid) {
-    sp<MediaCodec> codec = new MediaCodec(looper, pid, uid);
+    sp<MediaCodec> codec = MediaCodecPool::obtain(name);
+    if (codec != NULL) {
+        if (err != NULL) {
+            *err = OK;
+        }
+        return codec;
+    }
+    codec = new MediaCodec(looper, pid, uid);
 
     const status_t ret = codec->init(name);
     if (err != NULL) {
@@ -892,7 +910,8 @@ void MediaCodec::initMediametrics() {
         mMetricsHandle = mediametrics_create(kCodecKeyName);
     }
 
-    mLatencyHist.setup(kLatencyHistBuckets, kLatencyHistWidth, kLatencyHistFloor);
+    mLatencyHist.setupLogLinear(kLatencyHistLogBuckets, kLatencyHistLogOctave,
+                                kLatencyHistLogFirstWidth, kLatencyHistLogFloor);
 
     {
         Mutex::Autolock al(mRecentLock);
@@ -927,6 +946,9 @@ void MediaCodec::updateMediametrics() {
         mediametrics_setInt64(mMetricsHandle, kCodecLatencyMin, mLatencyHist.getMin());
         mediametrics_setInt64(mMetricsHandle, kCodecLatencyAvg, mLatencyHist.getAvg());
         mediametrics_setInt64(mMetricsHandle, kCodecLatencyCount, mLatencyHist.getCount());
+        mediametrics_setInt64(mMetricsHandle, kCodecLatencyP50, mLatencyHist.getPercentile(50));
+        mediametrics_setInt64(mMetricsHandle, kCodecLatencyP95, mLatencyHist.getPercentile(95));
+        mediametrics_setInt64(mMetricsHandle, kCodecLatencyP99, mLatencyHist.getPercentile(99));
 
         if (kEmitHistogram) {
             // and the histogram itself
@@ -1303,6 +1325,12 @@ bool MediaCodec::Histogram::setup(int nbuckets, int64_t width, int64_t floor)
         mBuckets = newbuckets;
     }
 
+    if (mBounds != NULL) {
+        // switching (back) to linear bucketing
+        free(mBounds);
+        mBounds = NULL;
+    }
+
     mWidth = width;
     mFloor = floor;
     mCeiling = floor + nbuckets * width;
@@ -1325,6 +1353,34 @@ bool MediaCodec::Histogram::setup(int nbuckets, int64_t width, int64_t floor)
     return false;
 }
 
+bool MediaCodec::Histogram::setupLogLinear(
+        int nbuckets, int octave, int64_t firstWidth, int64_t floor)
+{
+    if (octave <= 0 || !setup(nbuckets, firstWidth, floor)) {
+        return false;
+    }
+
+    // precompute the per-bucket upper bounds; the width doubles every
+    // octave buckets
+    int64_t *bounds = (int64_t *)malloc(nbuckets * sizeof(*bounds));
+    if (bounds == NULL) {
+        return false;
+    }
+    int64_t bound = floor;
+    int64_t width = firstWidth;
+    for (int i = 0; i < nbuckets; i++) {
+        if (i != 0 && (i % octave) == 0) {
+            width *= 2;
+        }
+        bound += width;
+        bounds[i] = bound;
+    }
+    mBounds = bounds;
+    mCeiling = bound;
+
+    return true;
+}
+
 void MediaCodec::Histogram::insert(int64_t sample)
 {
     // histogram is not set up
@@ -1341,6 +1397,19 @@ void MediaCodec::Histogram::insert(int64_t sample)
         mBelow++;
     } else if (sample >= mCeiling) {
         mAbove++;
+    } else if (mBounds != NULL) {
+        // log-linear: find the first bucket whose upper bound exceeds sample
+        int lo = 0;
+        int hi = mBucketCount - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (sample < mBounds[mid]) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        mBuckets[lo]++;
     } else {
         int64_t slot = (sample - mFloor) / mWidth;
         CHECK(slot < mBucketCount);
@@ -1349,12 +1418,42 @@ void MediaCodec::Histogram::insert(int64_t sample)
     return;
 }
 
+int64_t MediaCodec::Histogram::getPercentile(int percentile) const
+{
+    if (mBuckets == NULL || mCount == 0) {
+        return -1;
+    }
+
+    // the rank of the sample we're looking for, 1-based
+    int64_t target = (mCount * percentile + 99) / 100;
+    if (target <= mBelow) {
+        return mFloor;
+    }
+
+    int64_t seen = mBelow;
+    int64_t lower = mFloor;
+    for (int i = 0; i < mBucketCount; i++) {
+        int64_t upper = mBounds != NULL ? mBounds[i] : lower + mWidth;
+        if (seen + mBuckets[i] >= target) {
+            // interpolate within the bucket, clamped to the largest sample
+            int64_t value = lower + (upper - lower) * (target - seen) / mBuckets[i];
+            return value < mMax ? value : mMax;
+        }
+        seen += mBuckets[i];
+        lower = upper;
+    }
+
+    // target falls in the overflow bucket
+    return mMax;
+}
+
 std::string MediaCodec::Histogram::emit()
 {
     std::string value;
     char buffer[64];
 
-    // emits:  width,Below{bucket0,bucket1,...., bucketN}above
+    // emits:  floor,width,Below{bucket0,bucket1,...., bucketN}above
+    // for log-linear histograms 'width' is the first bucket's width
     // unconfigured will emit: 0,0{}0
     // XXX: is this best representation?
     snprintf(buffer, sizeof(buffer), "%" PRId64 ",%" PRId64 ",%" PRId64 "{",
@@ -2677,6 +2776,31 @@ status_t MediaCodec::queueInputBuffer(
     return PostAndAwaitResponse(msg, &response);
 }
 
+status_t MediaCodec::queueInputBuffers(
+        const std::vector<QueueBufferInfo> &infos,
+        size_t *numQueued,
+        AString *errorDetailMsg) {
+    if (errorDetailMsg != NULL) {
+        errorDetailMsg->clear();
+    }
+    if (numQueued != NULL) {
+        *numQueued = 0;
+    }
+    if (infos.empty()) {
+        return OK;
+    }
+
+    sp<AMessage> msg = new AMessage(kWhatQueueInputBuffers, this);
+    // Raw pointers are safe here for the same reason errorDetailMsg is:
+    // PostAndAwaitResponse keeps the caller alive until the reply arrives.
+    msg->setPointer("infos", (void *)&infos);
+    msg->setPointer("numQueued", numQueued);
+    msg->setPointer("errorDetailMsg", errorDetailMsg);
+
+    sp<AMessage> response;
+    return PostAndAwaitResponse(msg, &response);
+}
+
 status_t MediaCodec::queueSecureInputBuffer(
         size_t index,
         size_t offset,
@@ -2826,6 +2950,22 @@ status_t MediaCodec::dequeueOutputBuffer(
     return OK;
 }
 
+status_t MediaCodec::dequeueOutputBuffers(
+        std::vector<QueueBufferInfo> *infos,
+        size_t maxBuffers) {
+    if (infos == NULL || maxBuffers == 0) {
+        return BAD_VALUE;
+    }
+    infos->clear();
+
+    sp<AMessage> msg = new AMessage(kWhatDequeueOutputBuffers, this);
+    msg->setPointer("infos", infos);
+    msg->setSize("maxBuffers", maxBuffers);
+
+    sp<AMessage> response;
+    return PostAndAwaitResponse(msg, &response);
+}
+
 status_t MediaCodec::renderOutputBufferAndRelease(size_t index) {
     sp<AMessage> msg = new AMessage(kWhatReleaseOutputBuffer, this);
     msg->setSize("index", index);
@@ -4537,6 +4677,58 @@ void MediaCodec::onMessageReceived(const sp<AMessage> &msg) {
             break;
         }
 
+        case kWhatQueueInputBuffers:
+        {
+            sp<AReplyToken> replyID;
+            CHECK(msg->senderAwaitsResponse(&replyID));
+
+            if (!isExecuting()) {
+                PostReplyWithError(replyID, INVALID_OPERATION);
+                break;
+            } else if (mFlags & kFlagStickyError) {
+                PostReplyWithError(replyID, getStickyError());
+                break;
+            }
+
+            std::vector<QueueBufferInfo> *infos;
+            size_t *numQueued;
+            void *errorDetailMsg;
+            CHECK(msg->findPointer("infos", (void **)&infos));
+            CHECK(msg->findPointer("numQueued", (void **)&numQueued));
+            CHECK(msg->findPointer("errorDetailMsg", &errorDetailMsg));
+
+            status_t err = OK;
+            size_t queued = 0;
+            for (const QueueBufferInfo &info : *infos) {
+                // Synthesize the equivalent single-buffer message so the
+                // leftover machinery and onQueueInputBuffer() are shared
+                // with kWhatQueueInputBuffer.
+                sp<AMessage> entry = new AMessage;
+                entry->setSize("index", info.index);
+                entry->setSize("offset", info.offset);
+                entry->setSize("size", info.size);
+                entry->setInt64("timeUs", info.presentationTimeUs);
+                entry->setInt32("flags", info.flags);
+                entry->setPointer("errorDetailMsg", errorDetailMsg);
+                if (!mLeftover.empty()) {
+                    mLeftover.push_back(entry);
+                    err = handleLeftover(info.index);
+                } else {
+                    err = onQueueInputBuffer(entry);
+                }
+                if (err != OK) {
+                    break;
+                }
+                ++queued;
+            }
+            if (numQueued != NULL) {
+                *numQueued = queued;
+            }
+
+            PostReplyWithError(replyID, err);
+            break;
+        }
+
         case kWhatDequeueOutputBuffer:
         {
             sp<AReplyToken> replyID;
@@ -4573,6 +4765,86 @@ void MediaCodec::onMessageReceived(const sp<AMessage> &msg) {
             break;
         }
 
+        case kWhatDequeueOutputBuffers:
+        {
+            sp<AReplyToken> replyID;
+            CHECK(msg->senderAwaitsResponse(&replyID));
+
+            if (mFlags & kFlagIsAsync) {
+                ALOGE("dequeueOutputBuffers can't be used in async mode");
+                PostReplyWithError(replyID, INVALID_OPERATION);
+                break;
+            }
+            if (!isExecuting() || (mFlags & kFlagDequeueOutputPending)) {
+                PostReplyWithError(replyID, INVALID_OPERATION);
+                break;
+            }
+            if (mFlags & kFlagStickyError) {
+                PostReplyWithError(replyID, getStickyError());
+                break;
+            }
+            if (mFlags & kFlagOutputBuffersChanged) {
+                PostReplyWithError(replyID, INFO_OUTPUT_BUFFERS_CHANGED);
+                mFlags &= ~kFlagOutputBuffersChanged;
+                break;
+            }
+
+            std::vector<QueueBufferInfo> *infos;
+            size_t maxBuffers;
+            CHECK(msg->findPointer("infos", (void **)&infos));
+            CHECK(msg->findSize("maxBuffers", &maxBuffers));
+
+            bool replied = false;
+            while (infos->size() < maxBuffers) {
+                BufferInfo *info = peekNextPortBuffer(kPortIndexOutput);
+                if (!info) {
+                    break;
+                }
+
+                const sp<MediaCodecBuffer> &buffer = info->mData;
+                handleOutputFormatChangeIfNeeded(buffer);
+                if (mFlags & kFlagOutputFormatChanged) {
+                    if (infos->empty()) {
+                        // Same ordering as dequeueOutputBuffer: the format
+                        // change is reported before the buffer carrying it.
+                        PostReplyWithError(replyID, INFO_FORMAT_CHANGED);
+                        mFlags &= ~kFlagOutputFormatChanged;
+                        replied = true;
+                    }
+                    // Otherwise end the batch and leave the flag set, so
+                    // the next dequeue call reports the change in order.
+                    break;
+                }
+
+                QueueBufferInfo entry;
+                entry.index = dequeuePortBuffer(kPortIndexOutput);
+                entry.offset = buffer->offset();
+                entry.size = buffer->size();
+
+                int64_t timeUs;
+                CHECK(buffer->meta()->findInt64("timeUs", &timeUs));
+                entry.presentationTimeUs = timeUs;
+
+                int32_t flags;
+                CHECK(buffer->meta()->findInt32("flags", &flags));
+                entry.flags = flags;
+
+                statsBufferReceived(timeUs, buffer);
+
+                infos->push_back(entry);
+            }
+
+            if (!replied) {
+                if (infos->empty()) {
+                    PostReplyWithError(replyID, -EAGAIN);
+                } else {
+                    sp<AMessage> response = new AMessage;
+                    response->postReply(replyID);
+                }
+            }
+            break;
+        }
+
         case kWhatDequeueOutputTimedOut:
         {
             int32_t generation;
@@ -37,7 +37,13 @@
 #include <media/stagefright/OmxInfoBuilder.h>
 #include <media/stagefright/PersistentSurface.h>
 
+#include <binder/Parcel.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <utils/threads.h>
 
 #include <cutils/properties.h>
@@ -56,6 +62,32 @@ Mutex sRemoteInitMutex;
 constexpr const char* kProfilingResults =
         MediaCodecsXmlParser::defaultProfilingResultsXmlPath;
 
+// On-disk cache of the built codec list, written by the first process that
+// builds it (media.player's local instance) and read by later cold starts.
+constexpr const char* kCodecListCachePath = "/data/misc/media/codec_list_cache.bin";
+constexpr int32_t kCodecListCacheVersion = 1;
+
+// The cache key covers the system image and the set of media_codecs xml
+// files the builders parse, so an OTA or a vendor xml update invalidates it.
+std::string getCodecListCacheKey() {
+    char fingerprint[PROPERTY_VALUE_MAX];
+    property_get("ro.build.fingerprint", fingerprint, "");
+    std::string key = fingerprint;
+    for (const std::string &dir : MediaCodecsXmlParser::getDefaultSearchDirs()) {
+        for (const std::string &name : MediaCodecsXmlParser::getDefaultXmlNames()) {
+            const std::string path = dir + "/" + name;
+            struct stat s;
+            if (stat(path.c_str(), &s) == 0) {
+                char entry[PATH_MAX + 64];
+                snprintf(entry, sizeof(entry), ";%s:%lld:%lld", path.c_str(),
+                        (long long)s.st_mtime, (long long)s.st_size);
+                key += entry;
+            }
+        }
+    }
+    return key;
+}
+
 bool isProfilingNeeded() {
     int8_t value = property_get_bool("debug.stagefright.profilecodec", 0);
     if (value == 0) {
@@ -147,7 +179,13 @@ sp<IMediaCodecList> MediaCodecList::getLocalInstance() {
     Mutex::Autolock autoLock(sInitMutex);
 
     if (sCodecList == nullptr) {
-        MediaCodecList *codecList = new MediaCodecList(GetBuilders());
+        sp<MediaCodecList> codecList = readFromCache();
+        if (codecList == nullptr) {
+            codecList = new MediaCodecList(GetBuilders());
+            if (codecList->initCheck() == OK) {
+                codecList->writeToCache();
+            }
+        }
         if (codecList->initCheck() == OK) {
             sCodecList = codecList;
 
@@ -158,15 +196,100 @@ sp<IMediaCodecList> MediaCodecList::getLocalInstance() {
                     ALOGW("Failed to create thread for codec profiling.");
                 }
             }
-        } else {
-            // failure to initialize may be temporary. retry on next call.
-            delete codecList;
         }
+        // else failure to initialize may be temporary. retry on next call.
     }
 
     return sCodecList;
 }
 
+// static
+sp<MediaCodecList> MediaCodecList::readFromCache() {
+    if (!property_get_bool("debug.stagefright.codeclist-cache", true)) {
+        return nullptr;
+    }
+    int fd = open(kCodecListCachePath, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat s;
+    std::vector<uint8_t> data;
+    if (fstat(fd, &s) == 0 && s.st_size > 0) {
+        data.resize(s.st_size);
+        if (read(fd, data.data(), data.size()) != (ssize_t)data.size()) {
+            data.clear();
+        }
+    }
+    close(fd);
+    if (data.empty()) {
+        return nullptr;
+    }
+
+    Parcel parcel;
+    if (parcel.setData(data.data(), data.size()) != OK) {
+        return nullptr;
+    }
+    if (parcel.readInt32() != kCodecListCacheVersion) {
+        return nullptr;
+    }
+    const char *key = parcel.readCString();
+    if (key == nullptr || getCodecListCacheKey() != key) {
+        ALOGV("codec list cache is stale, rebuilding");
+        return nullptr;
+    }
+
+    sp<MediaCodecList> codecList = new MediaCodecList();
+    codecList->mGlobalSettings = AMessage::FromParcel(parcel);
+    if (codecList->mGlobalSettings == nullptr) {
+        return nullptr;
+    }
+    const int32_t count = parcel.readInt32();
+    if (count < 0 || parcel.errorCheck() != OK) {
+        return nullptr;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        sp<MediaCodecInfo> info = MediaCodecInfo::FromParcel(parcel);
+        if (info == nullptr || parcel.errorCheck() != OK) {
+            return nullptr;
+        }
+        codecList->mCodecInfos.push_back(info);
+    }
+    codecList->mInitCheck = OK;
+    ALOGV("read %d codecs from cache", count);
+    return codecList;
+}
+
+void MediaCodecList::writeToCache() const {
+    if (!property_get_bool("debug.stagefright.codeclist-cache", true)) {
+        return;
+    }
+    Parcel parcel;
+    parcel.writeInt32(kCodecListCacheVersion);
+    parcel.writeCString(getCodecListCacheKey().c_str());
+    mGlobalSettings->writeToParcel(&parcel);
+    parcel.writeInt32(mCodecInfos.size());
+    for (const sp<MediaCodecInfo> &info : mCodecInfos) {
+        if (info->writeToParcel(&parcel) != OK) {
+            return;
+        }
+    }
+
+    // Write to a temp file and rename so readers never see a partial cache.
+    // Failure (e.g. no write access to the directory) is not an error; the
+    // next privileged process to build the list will populate the cache.
+    std::string tmpPath = std::string(kCodecListCachePath) + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        ALOGV("cannot write codec list cache: %s", strerror(errno));
+        return;
+    }
+    const bool ok = write(fd, parcel.data(), parcel.dataSize()) == (ssize_t)parcel.dataSize();
+    close(fd);
+    if (!ok || rename(tmpPath.c_str(), kCodecListCachePath) != 0) {
+        unlink(tmpPath.c_str());
+    }
+}
+
 sp<IMediaCodecList> MediaCodecList::sRemoteList;
 
 sp<MediaCodecList::BinderDeathObserver> MediaCodecList::sBinderDeathObserver;
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2021, The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "MediaCodecPool"
+#include <utils/Log.h>
+
+#include <cutils/properties.h>
+#include <media/stagefright/MediaCodec.h>
+#include <media/stagefright/MediaCodecPool.h>
+
+namespace android {
+
+MediaCodecPool::MediaCodecPool()
+    : mMaxSize(property_get_int32("media.codec.pool.size", 0)) {
+}
+
+// static
+MediaCodecPool &MediaCodecPool::getInstance() {
+    static MediaCodecPool pool;
+    return pool;
+}
+
+// static
+sp<MediaCodec> MediaCodecPool::obtain(const AString &name) {
+    MediaCodecPool &pool = getInstance();
+    if (pool.mMaxSize == 0) {
+        return NULL;
+    }
+    sp<MediaCodec> codec;
+    {
+        Mutex::Autolock _l(pool.mLock);
+        for (auto it = pool.mEntries.begin(); it != pool.mEntries.end(); ++it) {
+            if (it->mName == name) {
+                codec = it->mCodec;
+                pool.mEntries.erase(it);
+                break;
+            }
+        }
+    }
+    if (codec == NULL) {
+        return NULL;
+    }
+    // A pooled codec stays registered with the resource manager and may have
+    // been reclaimed while it sat in the pool. getName() fails once the
+    // component has been released, so use it as a liveness probe.
+    AString currentName;
+    if (codec->getName(&currentName) != OK) {
+        ALOGV("dropping reclaimed pooled codec '%s'", name.c_str());
+        return NULL;
+    }
+    ALOGV("reusing warm codec '%s'", name.c_str());
+    return codec;
+}
+
+// static
+bool MediaCodecPool::recycle(const sp<MediaCodec> &codec) {
+    MediaCodecPool &pool = getInstance();
+    if (pool.mMaxSize == 0 || codec == NULL) {
+        return false;
+    }
+    AString name;
+    if (codec->getName(&name) != OK) {
+        // Released or never initialized; nothing worth keeping.
+        return false;
+    }
+    std::list<Entry> evicted;
+    {
+        Mutex::Autolock _l(pool.mLock);
+        pool.mEntries.push_front({name, codec});
+        while (pool.mEntries.size() > pool.mMaxSize) {
+            evicted.splice(evicted.end(), pool.mEntries, --pool.mEntries.end());
+        }
+    }
+    // Release evicted codecs outside the lock.
+    for (const Entry &entry : evicted) {
+        ALOGV("evicting pooled codec '%s'", entry.mName.c_str());
+        entry.mCodec->release();
+    }
+    return true;
+}
+
+// static
+void MediaCodecPool::clear() {
+    MediaCodecPool &pool = getInstance();
+    std::list<Entry> entries;
+    {
+        Mutex::Autolock _l(pool.mLock);
+        entries.swap(pool.mEntries);
+    }
+    for (const Entry &entry : entries) {
+        entry.mCodec->release();
+    }
+}
+
+}  // namespace android
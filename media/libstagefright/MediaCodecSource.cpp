@@ -51,6 +51,12 @@ const int kStopTimeoutUs = 300000; // allow 1 sec for shutting down encoder
 // input source.
 const int kMaxStopTimeOffsetUs = 1000000;
 
+// Maximum number of pulled buffers allowed to wait for an encoder input slot
+// before the pull loop pauses itself. Pulling faster than the encoder consumes
+// just grows the queue (and drops everything on the next pause/flush), so the
+// puller is paced by encoder input availability instead.
+const size_t kMaxOutstandingPulledBuffers = 4;
+
 struct MediaCodecSource::Puller : public AHandler {
     explicit Puller(const sp<MediaSource> &source);
 
@@ -84,10 +90,15 @@ private:
         Queue()
             : mReadPendingSince(0),
               mPaused(false),
-              mPulling(false) { }
+              mPulling(false),
+              mPullStalled(false) { }
         int64_t mReadPendingSince;
         bool mPaused;
         bool mPulling;
+        // true when the pull loop stopped reposting because too many pulled
+        // buffers were waiting for encoder input slots; readBuffer() restarts
+        // the loop once the encoder catches up.
+        bool mPullStalled;
         Vector<MediaBufferBase *> mReadBuffers;
 
         void flush();
@@ -149,7 +160,15 @@ void MediaCodecSource::Puller::Queue::flush() {
 
 bool MediaCodecSource::Puller::readBuffer(MediaBufferBase **mbuf) {
     Mutexed<Queue>::Locked queue(mQueue);
-    return queue->readBuffer(mbuf);
+    bool result = queue->readBuffer(mbuf);
+    // The encoder freed up an input slot; grant the pull loop a credit if it
+    // stalled on queue depth.
+    if (queue->mPullStalled
+            && queue->mReadBuffers.size() < kMaxOutstandingPulledBuffers) {
+        queue->mPullStalled = false;
+        schedulePull();
+    }
+    return result;
 }
 
 status_t MediaCodecSource::Puller::postSynchronouslyAndReturnError(
@@ -192,6 +211,12 @@ void MediaCodecSource::Puller::stop() {
     Mutexed<Queue>::Locked queue(mQueue);
     queue->mPulling = false;
     queue->flush(); // flush any unprocessed pulled buffers
+    // EOS is detected by the pull loop; restart it if it stalled on queue
+    // depth, or it would only end via the stop-stalled timeout.
+    if (queue->mPullStalled) {
+        queue->mPullStalled = false;
+        schedulePull();
+    }
 }
 
 void MediaCodecSource::Puller::interruptSource() {
@@ -214,6 +239,10 @@ void MediaCodecSource::Puller::resume() {
     Mutexed<Queue>::Locked queue(mQueue);
     queue->flush();
     queue->mPaused = false;
+    if (queue->mPullStalled) {
+        queue->mPullStalled = false;
+        schedulePull();
+    }
 }
 
 void MediaCodecSource::Puller::schedulePull() {
@@ -316,11 +345,23 @@ void MediaCodecSource::Puller::onMessageReceived(const sp<AMessage> &msg) {
                 queue->pushBuffer(mbuf);
             }
 
+            // Stop reposting once enough pulled buffers are waiting for an
+            // encoder input slot; readBuffer() reschedules the pull when the
+            // encoder consumes one.
+            bool stalled = false;
+            if (mbuf != NULL
+                    && queue->mReadBuffers.size() >= kMaxOutstandingPulledBuffers) {
+                queue->mPullStalled = true;
+                stalled = true;
+            }
+
             queue.unlock();
 
             if (mbuf != NULL) {
                 mNotify->post();
-                msg->post();
+                if (!stalled) {
+                    msg->post();
+                }
             } else {
                 handleEOS();
             }
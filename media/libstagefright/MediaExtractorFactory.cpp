@@ -128,6 +128,58 @@ std::shared_ptr<std::list<sp<ExtractorPlugin>>> MediaExtractorFactory::gPlugins;
 bool MediaExtractorFactory::gPluginsRegistered = false;
 bool MediaExtractorFactory::gIgnoreVersion = false;
 
+namespace {
+
+// Every registered sniffer starts by reading the same first bytes of the
+// file; without this wrapper, probing N extractors costs N separate reads
+// of the prefix (each a binder round trip for remote data sources). Reads
+// that fall entirely within the prefix are served from one up-front read,
+// anything else goes through to the wrapped source.
+class SniffPrefixSource : public DataSource {
+public:
+    explicit SniffPrefixSource(const sp<DataSource> &source)
+        : mSource(source),
+          mPrefixLength(0) {
+        ssize_t n = mSource->readAt(0, mPrefix, kPrefixSize);
+        if (n > 0) {
+            mPrefixLength = n;
+        }
+    }
+
+    status_t initCheck() const override {
+        return mSource->initCheck();
+    }
+
+    ssize_t readAt(off64_t offset, void *data, size_t size) override {
+        if (offset >= 0 && (uint64_t)offset + size <= mPrefixLength) {
+            memcpy(data, mPrefix + offset, size);
+            return size;
+        }
+        return mSource->readAt(offset, data, size);
+    }
+
+    status_t getSize(off64_t *size) override {
+        return mSource->getSize(size);
+    }
+
+    uint32_t flags() override {
+        return mSource->flags();
+    }
+
+    String8 getUri() override {
+        return mSource->getUri();
+    }
+
+private:
+    static constexpr size_t kPrefixSize = 64 * 1024;
+
+    const sp<DataSource> mSource;
+    size_t mPrefixLength;
+    uint8_t mPrefix[kPrefixSize];
+};
+
+}  // anonymous namespace
+
 // static
 void *MediaExtractorFactory::sniff(
         const sp<DataSource> &source, float *confidence, void **meta,
@@ -144,6 +196,9 @@ void *MediaExtractorFactory::sniff(
         plugins = gPlugins;
     }
 
+    // Serve the sniffers' reads of the file prefix from a single read.
+    sp<DataSource> sniffSource = new SniffPrefixSource(source);
+
     void *bestCreator = NULL;
     for (auto it = plugins->begin(); it != plugins->end(); ++it) {
         ALOGV("sniffing %s", (*it)->def.extractor_name);
@@ -154,10 +209,10 @@ void *MediaExtractorFactory::sniff(
         void *curCreator = NULL;
         if ((*it)->def.def_version == EXTRACTORDEF_VERSION_NDK_V1) {
             curCreator = (void*) (*it)->def.u.v2.sniff(
-                    source->wrap(), &newConfidence, &newMeta, &newFreeMeta);
+                    sniffSource->wrap(), &newConfidence, &newMeta, &newFreeMeta);
         } else if ((*it)->def.def_version == EXTRACTORDEF_VERSION_NDK_V2) {
             curCreator = (void*) (*it)->def.u.v3.sniff(
-                    source->wrap(), &newConfidence, &newMeta, &newFreeMeta);
+                    sniffSource->wrap(), &newConfidence, &newMeta, &newFreeMeta);
         }
 
         if (curCreator) {
@@ -34,6 +34,7 @@
 #include <media/stagefright/MediaDefs.h>
 #include <media/stagefright/MediaErrors.h>
 #include <media/stagefright/MetaData.h>
+#include <media/stagefright/FragmentedMP4Writer.h>
 #include <media/stagefright/MPEG4Writer.h>
 #include <media/stagefright/OggWriter.h>
 #include <media/stagefright/Utils.h>
@@ -55,6 +56,8 @@ MediaMuxer::MediaMuxer(int fd, OutputFormat format)
         mWriter = new WebmWriter(fd);
     } else if (format == OUTPUT_FORMAT_OGG) {
         mWriter = new OggWriter(fd);
+    } else if (format == OUTPUT_FORMAT_FRAGMENTED_MP4) {
+        mWriter = new FragmentedMP4Writer(fd);
     }
 
     if (mWriter != NULL) {
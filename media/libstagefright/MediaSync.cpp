@@ -17,6 +17,7 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "MediaSync"
 #include <inttypes.h>
+#include <math.h>
 
 #include <gui/BufferQueue.h>
 #include <gui/IGraphicBufferConsumer.h>
@@ -38,8 +39,38 @@
 // frame arrives later than this number, it will be discarded without rendering.
 static const int64_t kMaxAllowedVideoLateTimeUs = 40000LL;
 
+// Weight denominator for the drift moving average; roughly the last 8 frames.
+static const int64_t kDriftEmaWeight = 8;
+
+// Average drift beyond this engages the micro-resampling correction; it
+// disengages again below kDriftCorrectionReleaseUs. 20ms is the commonly
+// cited lip sync perceptual threshold; correct well before it.
+static const int64_t kDriftCorrectionThresholdUs = 10000LL;
+static const int64_t kDriftCorrectionReleaseUs = 2000LL;
+
+// Largest audio rate trim applied by the drift correction. 0.1% is well
+// below the audibility threshold for a pitch change.
+static const float kMaxRateTrimRatio = 0.001f;
+
+// key for media statistics
+static const char *kKeyMediaSync = "mediasync";
+
+// attrs for media statistics
+static const char *kSyncFramesRendered = "android.media.mediasync.frames-rendered";
+static const char *kSyncFramesDropped = "android.media.mediasync.frames-dropped";
+static const char *kSyncDriftMeanUs = "android.media.mediasync.drift-mean-us";
+static const char *kSyncDriftMinUs = "android.media.mediasync.drift-min-us";
+static const char *kSyncDriftMaxUs = "android.media.mediasync.drift-max-us";
+static const char *kSyncDriftHistogram = "android.media.mediasync.drift-histogram";
+
 namespace android {
 
+// Histogram bucket boundaries, chosen around the 20ms perceptual limit.
+// Buckets: < -40ms, -40..-20, -20..-10, -10..10, 10..20, 20..40, >= 40ms.
+const int64_t MediaSync::kDriftBinLimitsUs[MediaSync::kNumDriftBins - 1] = {
+    -40000, -20000, -10000, 10000, 20000, 40000
+};
+
 // static
 sp<MediaSync> MediaSync::create() {
     sp<MediaSync> sync = new MediaSync();
@@ -59,7 +90,17 @@ MediaSync::MediaSync()
         mNumFramesWritten(0),
         mHasAudio(false),
         mNextBufferItemMediaUs(-1),
-        mPlaybackRate(0.0) {
+        mPlaybackRate(0.0),
+        mDriftCount(0),
+        mDriftSumUs(0),
+        mDriftMinUs(INT64_MAX),
+        mDriftMaxUs(INT64_MIN),
+        mDriftEmaUs(0),
+        mFramesDropped(0),
+        mRateTrimRatio(0.0f) {
+    memset(mDriftHistogram, 0, sizeof(mDriftHistogram));
+    mMetricsItem = mediametrics::Item::create(kKeyMediaSync);
+
     mMediaClock = new MediaClock;
     mMediaClock->init();
 
@@ -73,6 +114,26 @@ MediaSync::MediaSync()
 }
 
 MediaSync::~MediaSync() {
+    // log the drift statistics, provided at least one frame was rendered
+    if (mMetricsItem != NULL) {
+        if (mDriftCount > 0) {
+            mMetricsItem->setInt64(kSyncFramesRendered, mDriftCount);
+            mMetricsItem->setInt64(kSyncFramesDropped, mFramesDropped);
+            mMetricsItem->setInt64(kSyncDriftMeanUs, mDriftSumUs / mDriftCount);
+            mMetricsItem->setInt64(kSyncDriftMinUs, mDriftMinUs);
+            mMetricsItem->setInt64(kSyncDriftMaxUs, mDriftMaxUs);
+            AString histogram;
+            for (size_t i = 0; i < kNumDriftBins; ++i) {
+                histogram.append(i == 0 ? "" : ",");
+                histogram.append((long long)mDriftHistogram[i]);
+            }
+            mMetricsItem->setCString(kSyncDriftHistogram, histogram.c_str());
+            mMetricsItem->selfrecord();
+        }
+        delete mMetricsItem;
+        mMetricsItem = NULL;
+    }
+
     if (mInput != NULL) {
         mInput->consumerDisconnect();
     }
@@ -249,6 +310,9 @@ void MediaSync::updatePlaybackRate_l(float rate) {
         mNextBufferItemMediaUs = -1;
     }
     mPlaybackRate = rate;
+    // the audio track was just set to the new base rate; re-converge from zero
+    mRateTrimRatio = 0.0f;
+    mDriftEmaUs = 0;
     // TODO: update frame scheduler with this info
     mMediaClock->setPlaybackRate(rate);
     onDrainVideo_l();
@@ -532,6 +596,68 @@ int64_t MediaSync::getPlayedOutAudioDurationMedia_l(int64_t nowUs) {
     return durationUs;
 }
 
+void MediaSync::recordVideoDriftSample_l(int64_t driftUs) {
+    size_t bin = 0;
+    while (bin < kNumDriftBins - 1 && driftUs >= kDriftBinLimitsUs[bin]) {
+        ++bin;
+    }
+    ++mDriftHistogram[bin];
+    ++mDriftCount;
+    mDriftSumUs += driftUs;
+    if (driftUs < mDriftMinUs) {
+        mDriftMinUs = driftUs;
+    }
+    if (driftUs > mDriftMaxUs) {
+        mDriftMaxUs = driftUs;
+    }
+    mDriftEmaUs += (driftUs - mDriftEmaUs) / kDriftEmaWeight;
+
+    updateDriftCorrection_l();
+}
+
+void MediaSync::updateDriftCorrection_l() {
+    if (mAudioTrack == NULL || !isPlaying()
+            || mSyncSettings.mAudioAdjustMode != AVSYNC_AUDIO_ADJUST_MODE_RESAMPLE) {
+        return;
+    }
+
+    // Proportional trim against the average drift with hysteresis: a late
+    // video (positive drift) means audio needs to play slightly slower for
+    // video to catch up. Quantize the trim so the audio track rate is only
+    // touched when the correction meaningfully changes.
+    float trim = mRateTrimRatio;
+    int64_t absDriftUs = mDriftEmaUs < 0 ? -mDriftEmaUs : mDriftEmaUs;
+    if (absDriftUs >= kDriftCorrectionThresholdUs
+            || (mRateTrimRatio != 0.0f && absDriftUs > kDriftCorrectionReleaseUs)) {
+        trim = -(float)mDriftEmaUs / (float)(10 * kDriftCorrectionThresholdUs)
+                * kMaxRateTrimRatio;
+        if (trim > kMaxRateTrimRatio) {
+            trim = kMaxRateTrimRatio;
+        } else if (trim < -kMaxRateTrimRatio) {
+            trim = -kMaxRateTrimRatio;
+        }
+        trim = roundf(trim / (kMaxRateTrimRatio / 10)) * (kMaxRateTrimRatio / 10);
+    } else if (absDriftUs <= kDriftCorrectionReleaseUs) {
+        trim = 0.0f;
+    }
+
+    if (trim == mRateTrimRatio) {
+        return;
+    }
+
+    AudioPlaybackRate trimmedRate = mPlaybackSettings;
+    trimmedRate.mSpeed = mPlaybackRate * (1.0f + trim);
+    if (mAudioTrack->setPlaybackRate(trimmedRate) != OK) {
+        ALOGV("updateDriftCorrection_l: audio track rejected trimmed rate");
+        return;
+    }
+    ALOGV("updateDriftCorrection_l: drift %lld us, rate trim %.4f",
+            (long long)mDriftEmaUs, trim);
+    mRateTrimRatio = trim;
+    // The media clock follows the audio position, so video naturally tracks
+    // the trimmed rate; no clock adjustment is needed here.
+}
+
 void MediaSync::onDrainVideo_l() {
     if (!isPlaying()) {
         return;
@@ -541,10 +667,10 @@ void MediaSync::onDrainVideo_l() {
         int64_t nowUs = ALooper::GetNowUs();
         BufferItem *bufferItem = &*mBufferItems.begin();
         int64_t itemMediaUs = bufferItem->mTimestamp / 1000;
-        int64_t itemRealUs = getRealTime(itemMediaUs, nowUs);
+        int64_t idealRealUs = getRealTime(itemMediaUs, nowUs);
 
         // adjust video frame PTS based on vsync
-        itemRealUs = mFrameScheduler->schedule(itemRealUs * 1000) / 1000;
+        int64_t itemRealUs = mFrameScheduler->schedule(idealRealUs * 1000) / 1000;
         int64_t twoVsyncsUs = 2 * (mFrameScheduler->getVsyncPeriod() / 1000);
 
         // post 2 display refreshes before rendering is due
@@ -557,11 +683,17 @@ void MediaSync::onDrainVideo_l() {
             if (mHasAudio) {
                 if (nowUs - itemRealUs <= kMaxAllowedVideoLateTimeUs) {
                     renderOneBufferItem_l(*bufferItem);
+
+                    // The frame reaches the display at the scheduled vsync,
+                    // or at the next one after now if it is already late.
+                    int64_t presentUs = itemRealUs > nowUs ? itemRealUs : nowUs;
+                    recordVideoDriftSample_l(presentUs - idealRealUs);
                 } else {
                     // too late.
                     returnBufferToInput_l(
                             bufferItem->mGraphicBuffer, bufferItem->mFence);
                     mFrameScheduler->restart();
+                    ++mFramesDropped;
                 }
             } else {
                 // always render video buffer in video-only mode.
@@ -25,6 +25,7 @@
 #include <datasource/DataSourceFactory.h>
 #include <datasource/FileSource.h>
 #include <media/DataSource.h>
+#include <media/MediaBufferHolder.h>
 #include <media/stagefright/MediaSource.h>
 #include <media/stagefright/foundation/ABuffer.h>
 #include <media/stagefright/foundation/ADebug.h>
@@ -600,6 +601,27 @@ status_t NuMediaExtractor::seekTo(
 status_t NuMediaExtractor::advance() {
     Mutex::Autolock autoLock(mLock);
 
+    return advance_l();
+}
+
+status_t NuMediaExtractor::advanceBatch(size_t count, size_t *advanced) {
+    Mutex::Autolock autoLock(mLock);
+
+    *advanced = 0;
+    while (*advanced < count) {
+        status_t err = advance_l();
+        if (err != OK) {
+            // A short batch is fine as long as something was consumed; the
+            // next call reports the error.
+            return *advanced > 0 ? OK : err;
+        }
+        ++*advanced;
+    }
+
+    return OK;
+}
+
+status_t NuMediaExtractor::advance_l() {
     ssize_t minIndex = fetchAllTrackSamples();
 
     if (minIndex < 0) {
@@ -727,6 +749,54 @@ status_t NuMediaExtractor::readSampleData(const sp<ABuffer> &buffer) {
     return err;
 }
 
+status_t NuMediaExtractor::getSampleBuffer(sp<ABuffer> *outBuffer) {
+    Mutex::Autolock autoLock(mLock);
+
+    *outBuffer = NULL;
+
+    ssize_t minIndex = fetchAllTrackSamples();
+
+    if (minIndex < 0) {
+        return ERROR_END_OF_STREAM;
+    }
+
+    TrackInfo *info = &mSelectedTracks.editItemAt(minIndex);
+
+    auto it = info->mSamples.begin();
+    MediaBufferBase *mbuf = it->mBuffer;
+
+    if (info->mTrackFlags & kIsVorbis) {
+        // The numPageSamples suffix has to be appended, so a copy is
+        // unavoidable for vorbis tracks.
+        size_t sampleSize = mbuf->range_length() + sizeof(int32_t);
+        sp<ABuffer> copy = new ABuffer(sampleSize);
+        if (copy->data() == NULL) {
+            return -ENOMEM;
+        }
+        memcpy(copy->data(),
+               (const uint8_t *)mbuf->data() + mbuf->range_offset(),
+               mbuf->range_length());
+        status_t err = appendVorbisNumPageSamples(mbuf, copy);
+        if (err != OK) {
+            return err;
+        }
+        copy->setRange(0, sampleSize);
+        *outBuffer = copy;
+        return OK;
+    }
+
+    // Hand out a view of the extractor's buffer; the holder keeps the
+    // MediaBuffer referenced until the last view goes away, even after
+    // advance() drops the extractor's own reference.
+    sp<ABuffer> view = new ABuffer(
+            (uint8_t *)mbuf->data() + mbuf->range_offset(),
+            mbuf->range_length());
+    view->meta()->setObject("mediaBufferHolder", new MediaBufferHolder(mbuf));
+    *outBuffer = view;
+
+    return OK;
+}
+
 status_t NuMediaExtractor::getSampleSize(size_t *sampleSize) {
     Mutex::Autolock autoLock(mLock);
 
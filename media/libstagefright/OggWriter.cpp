@@ -52,6 +52,7 @@ namespace android {
 
 OggWriter::OggWriter(int fd)
       : mFd(dup(fd)),
+        mSink(mFd),
         mHaveAllCodecSpecificData(false),
         mInitCheck(mFd < 0 ? NO_INIT : OK) {
     // empty
@@ -150,8 +151,8 @@ status_t OggWriter::writeOggHeaderPackets(unsigned char *buf, size_t size) {
     int ret;
     while ((ret = ogg_stream_flush((ogg_stream_state*)mOs, &og))) {
         if (!ret) break;
-        write(mFd, og.header, og.header_len);
-        write(mFd, og.body, og.body_len);
+        mSink.write(og.header, og.header_len);
+        mSink.write(og.body, og.body_len);
     }
 
 
@@ -180,11 +181,14 @@ status_t OggWriter::writeOggHeaderPackets(unsigned char *buf, size_t size) {
 
     while ((ret = ogg_stream_flush((ogg_stream_state*)mOs, &og))) {
         if (!ret) break;
-        write(mFd, og.header, og.header_len);
-        write(mFd, og.body, og.body_len);
+        mSink.write(og.header, og.header_len);
+        mSink.write(og.body, og.body_len);
     }
 
     free(comments);
+    // Header packets may be written before the writer thread runs (from
+    // addSource); push them out so the file is well-formed from the start.
+    mSink.flush();
     mHaveAllCodecSpecificData = true;
     return OK;
 }
@@ -391,8 +395,8 @@ status_t OggWriter::threadFunc() {
         size_t n = 0;
 
         while (ogg_stream_flush((ogg_stream_state*)mOs, &og) > 0) {
-            write(mFd, og.header, og.header_len);
-            write(mFd, og.body, og.body_len);
+            mSink.write(og.header, og.header_len);
+            mSink.write(og.body, og.body_len);
             n = n + og.header_len + og.body_len;
         }
 
@@ -422,6 +426,9 @@ status_t OggWriter::threadFunc() {
         err = ERROR_MALFORMED;
     }
 
+    if (mSink.flush() != OK && err == OK) {
+        err = ERROR_IO;
+    }
     close(mFd);
     mFd = -1;
     mReachedEOS = true;
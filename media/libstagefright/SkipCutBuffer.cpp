@@ -75,6 +75,12 @@ void SkipCutBuffer::submit(MediaBuffer *buffer) {
         mFrontPadding -= to_drop;
     }
 
+    // try to trim in place before paying for a round trip through the ring
+    int32_t newOffset;
+    if (trimInPlace((char*) buffer->data(), offset, buflen, &newOffset)) {
+        buffer->set_range(newOffset, buflen);
+        return;
+    }
 
     // append data to cutbuffer
     char *src = ((char*) buffer->data()) + offset;
@@ -108,6 +114,12 @@ void SkipCutBuffer::submitInternal(const sp<T>& buffer) {
         mFrontPadding -= to_drop;
     }
 
+    // try to trim in place before paying for a round trip through the ring
+    int32_t newOffset;
+    if (trimInPlace((char*) buffer->base(), offset, buflen, &newOffset)) {
+        buffer->setRange(newOffset, buflen);
+        return;
+    }
 
     // append data to cutbuffer
     char *src = (char*) buffer->data();
@@ -129,6 +141,37 @@ void SkipCutBuffer::submit(const sp<MediaCodecBuffer>& buffer) {
     submitInternal(buffer);
 }
 
+bool SkipCutBuffer::trimInPlace(char *data, int32_t offset, int32_t buflen, int32_t *outOffset) {
+    // Nothing left to skip and nothing to hold back: the ring round trip
+    // would reproduce the payload unchanged, so leave it where it is.
+    if (mBackPadding == 0 && mReadHead == mWriteHead) {
+        *outOffset = offset;
+        return true;
+    }
+
+    // Steady state: the ring holds exactly the back padding retained from
+    // the previous buffer. Swap just the paddings instead of spooling the
+    // whole payload through the ring: retain this buffer's tail, then
+    // prepend the previously retained one. With enough headroom in front of
+    // the payload the prepend is a pure range adjustment and the payload
+    // bytes aren't touched at all.
+    if (mBackPadding > 0 && buflen >= mBackPadding
+            && (int32_t)size() == mBackPadding) {
+        write(data + offset + buflen - mBackPadding, mBackPadding);
+        if (offset >= mBackPadding) {
+            read(data + offset - mBackPadding, mBackPadding);
+            *outOffset = offset - mBackPadding;
+        } else {
+            memmove(data + offset + mBackPadding, data + offset, buflen - mBackPadding);
+            read(data + offset, mBackPadding);
+            *outOffset = offset;
+        }
+        return true;
+    }
+
+    return false;
+}
+
 void SkipCutBuffer::clear() {
     mWriteHead = mReadHead = 0;
     mFrontPadding = mSkip;
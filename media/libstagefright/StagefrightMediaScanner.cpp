@@ -22,12 +22,17 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 
+#include <cutils/properties.h>
+#include <datasource/FileSource.h>
 #include <media/stagefright/MediaExtractorFactory.h>
 #include <media/stagefright/StagefrightMediaScanner.h>
 
+#include <ID3.h>
 #include <media/IMediaHTTPService.h>
+#include <media/MediaExtractorPluginHelper.h>
 #include <media/mediametadataretriever.h>
 #include <private/media/VideoFrame.h>
+#include <utils/String8.h>
 
 namespace android {
 
@@ -69,6 +74,73 @@ MediaScanResult StagefrightMediaScanner::processFile(
     return result;
 }
 
+// Looks up an ID3 text frame by its v2.3+ id, falling back to the
+// corresponding v2.2 id.
+static bool GetID3String(
+        const ID3 &tag, const char *v23id, const char *v22id, String8 *value) {
+    ID3::Iterator it(tag, v23id);
+    if (!it.done()) {
+        it.getString(value);
+        return value->length() > 0;
+    }
+    if (v22id != nullptr) {
+        ID3::Iterator it22(tag, v22id);
+        if (!it22.done()) {
+            it22.getString(value);
+            return value->length() > 0;
+        }
+    }
+    return false;
+}
+
+MediaScanResult StagefrightMediaScanner::fastScanID3(
+        const char *path, MediaScannerClient &client) {
+    sp<FileSource> source = new FileSource(path);
+    if (source->initCheck() != OK) {
+        return MEDIA_SCAN_RESULT_SKIPPED;
+    }
+
+    DataSourceHelper helper(source->wrap());
+    // Only the text frames are wanted, so don't load embedded album art.
+    ID3 tag(&helper, false /* ignoreV1 */, 0 /* offset */, true /* skipImages */);
+    if (!tag.isValid()) {
+        return MEDIA_SCAN_RESULT_SKIPPED;
+    }
+
+    if (client.setMimeType("audio/mpeg") != OK) {
+        return MEDIA_SCAN_RESULT_ERROR;
+    }
+
+    struct ID3Map {
+        const char *tag;
+        const char *v23id;
+        const char *v22id;
+    };
+    static const ID3Map kID3Map[] = {
+        { "title", "TIT2", "TT2" },
+        { "artist", "TPE1", "TP1" },
+        { "albumartist", "TPE2", "TP2" },
+        { "album", "TALB", "TAL" },
+        { "composer", "TCOM", "TCM" },
+        { "genre", "TCON", "TCO" },
+        { "year", "TYER", "TYE" },
+        { "date", "TDRC", nullptr },
+        { "tracknumber", "TRCK", "TRK" },
+        { "discnumber", "TPOS", "TPA" },
+        { "compilation", "TCMP", "TCP" },
+    };
+
+    for (size_t i = 0; i < sizeof(kID3Map) / sizeof(kID3Map[0]); ++i) {
+        String8 value;
+        if (GetID3String(tag, kID3Map[i].v23id, kID3Map[i].v22id, &value)
+                && client.addStringTag(kID3Map[i].tag, value.string()) != OK) {
+            return MEDIA_SCAN_RESULT_ERROR;
+        }
+    }
+
+    return MEDIA_SCAN_RESULT_OK;
+}
+
 MediaScanResult StagefrightMediaScanner::processFileInternal(
         const char *path, const char * /* mimeType */,
         MediaScannerClient &client) {
@@ -82,6 +154,19 @@ MediaScanResult StagefrightMediaScanner::processFileInternal(
         return MEDIA_SCAN_RESULT_SKIPPED;
     }
 
+    // Metadata-only fast scan: parse the ID3 tag in-process instead of
+    // instantiating a full remote extractor (and its frame scan) through
+    // MediaMetadataRetriever. ID3 carries no duration, so the mode is
+    // opt-in for clients that don't need one during the bulk scan.
+    if (property_get_bool("media.mediascanner.fastscan", false)
+            && !strcasecmp(extension, ".mp3")) {
+        MediaScanResult result = fastScanID3(path, client);
+        if (result != MEDIA_SCAN_RESULT_SKIPPED) {
+            return result;
+        }
+        // No usable tag; fall through to the full scan.
+    }
+
     sp<MediaMetadataRetriever> mRetriever(new MediaMetadataRetriever);
 
     int fd = open(path, O_RDONLY | O_LARGEFILE);
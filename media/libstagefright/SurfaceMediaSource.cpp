@@ -50,7 +50,9 @@ SurfaceMediaSource::SurfaceMediaSource(uint32_t bufferWidth, uint32_t bufferHeig
     mNumFramesEncoded(0),
     mFirstFrameTimestamp(0),
     mMaxAcquiredBufferCount(4),  // XXX double-check the default
-    mUseAbsoluteTimestamps(false) {
+    mUseAbsoluteTimestamps(false),
+    mDropStaleFrames(false),
+    mNumFramesDropped(0) {
     ALOGV("SurfaceMediaSource");
 
     if (bufferWidth == 0 || bufferHeight == 0) {
@@ -199,6 +201,14 @@ status_t SurfaceMediaSource::setUseAbsoluteTimestamps() {
     return OK;
 }
 
+status_t SurfaceMediaSource::setDropStaleFrames() {
+    ALOGV("setDropStaleFrames");
+    Mutex::Autolock lock(mMutex);
+    mDropStaleFrames = true;
+
+    return OK;
+}
+
 status_t SurfaceMediaSource::stop()
 {
     ALOGV("stop");
@@ -211,6 +221,11 @@ status_t SurfaceMediaSource::stop()
     mStarted = false;
     mFrameAvailableCondition.signal();
 
+    if (mNumFramesDropped > 0) {
+        ALOGI("Frames received/encoded/dropped: %d/%d/%d",
+                mNumFramesReceived, mNumFramesEncoded, mNumFramesDropped);
+    }
+
     while (mNumPendingBuffers > 0) {
         ALOGI("Still waiting for %zu buffers to be returned.",
                 mNumPendingBuffers);
@@ -269,102 +284,128 @@ void SurfaceMediaSource::passMetadataBuffer_l(MediaBufferBase **buffer,
 status_t SurfaceMediaSource::read(
         MediaBufferBase **buffer, const ReadOptions * /* options */) {
     ALOGV("read");
-    Mutex::Autolock lock(mMutex);
 
     *buffer = NULL;
 
-    while (mStarted && mNumPendingBuffers == mMaxAcquiredBufferCount) {
-        mMediaBuffersAvailableCondition.wait(mMutex);
-    }
+    BufferItem item;
 
-    // Update the current buffer info
-    // TODO: mCurrentSlot can be made a bufferstate since there
-    // can be more than one "current" slots.
+    {
+        Mutex::Autolock lock(mMutex);
 
-    BufferItem item;
-    // If the recording has started and the queue is empty, then just
-    // wait here till the frames come in from the client side
-    while (mStarted) {
-
-        status_t err = mConsumer->acquireBuffer(&item, 0);
-        if (err == BufferQueue::NO_BUFFER_AVAILABLE) {
-            // wait for a buffer to be queued
-            mFrameAvailableCondition.wait(mMutex);
-        } else if (err == OK) {
-            err = item.mFence->waitForever("SurfaceMediaSource::read");
-            if (err) {
-                ALOGW("read: failed to wait for buffer fence: %d", err);
-            }
+        while (mStarted && mNumPendingBuffers == mMaxAcquiredBufferCount) {
+            mMediaBuffersAvailableCondition.wait(mMutex);
+        }
 
-            // First time seeing the buffer?  Added it to the SMS slot
-            if (item.mGraphicBuffer != NULL) {
-                mSlots[item.mSlot].mGraphicBuffer = item.mGraphicBuffer;
-            }
-            mSlots[item.mSlot].mFrameNumber = item.mFrameNumber;
-
-            // check for the timing of this buffer
-            if (mNumFramesReceived == 0 && !mUseAbsoluteTimestamps) {
-                mFirstFrameTimestamp = item.mTimestamp;
-                // Initial delay
-                if (mStartTimeNs > 0) {
-                    if (item.mTimestamp < mStartTimeNs) {
-                        // This frame predates start of record, discard
+        // Update the current buffer info
+        // TODO: mCurrentSlot can be made a bufferstate since there
+        // can be more than one "current" slots.
+
+        // If the recording has started and the queue is empty, then just
+        // wait here till the frames come in from the client side
+        while (mStarted) {
+
+            status_t err = mConsumer->acquireBuffer(&item, 0);
+            if (err == BufferQueue::NO_BUFFER_AVAILABLE) {
+                // wait for a buffer to be queued
+                mFrameAvailableCondition.wait(mMutex);
+            } else if (err == OK) {
+                if (mDropStaleFrames) {
+                    // More frames may have queued up behind this one while
+                    // the encoder was busy; hand the stale ones straight
+                    // back and encode only the newest so the producer never
+                    // stalls on a full queue.
+                    BufferItem next;
+                    while (mConsumer->acquireBuffer(&next, 0) == OK) {
+                        if (item.mGraphicBuffer != NULL) {
+                            mSlots[item.mSlot].mGraphicBuffer = item.mGraphicBuffer;
+                        }
+                        mSlots[item.mSlot].mFrameNumber = item.mFrameNumber;
+                        // forward the acquire fence as the release fence: the
+                        // producer's rendering may still be in flight and it
+                        // must not overwrite the buffer before that finishes
                         mConsumer->releaseBuffer(
                                 item.mSlot, item.mFrameNumber, EGL_NO_DISPLAY,
-                                EGL_NO_SYNC_KHR, Fence::NO_FENCE);
-                        continue;
+                                EGL_NO_SYNC_KHR, item.mFence);
+                        ++mNumFramesDropped;
+                        item = next;
                     }
-                    mStartTimeNs = item.mTimestamp - mStartTimeNs;
                 }
-            }
-            item.mTimestamp = mStartTimeNs + (item.mTimestamp - mFirstFrameTimestamp);
 
-            mNumFramesReceived++;
+                // First time seeing the buffer?  Added it to the SMS slot
+                if (item.mGraphicBuffer != NULL) {
+                    mSlots[item.mSlot].mGraphicBuffer = item.mGraphicBuffer;
+                }
+                mSlots[item.mSlot].mFrameNumber = item.mFrameNumber;
+
+                // check for the timing of this buffer
+                if (mNumFramesReceived == 0 && !mUseAbsoluteTimestamps) {
+                    mFirstFrameTimestamp = item.mTimestamp;
+                    // Initial delay
+                    if (mStartTimeNs > 0) {
+                        if (item.mTimestamp < mStartTimeNs) {
+                            // This frame predates start of record, discard.
+                            // The fence was never waited on, forward it so
+                            // the producer does before rendering again.
+                            mConsumer->releaseBuffer(
+                                    item.mSlot, item.mFrameNumber, EGL_NO_DISPLAY,
+                                    EGL_NO_SYNC_KHR, item.mFence);
+                            continue;
+                        }
+                        mStartTimeNs = item.mTimestamp - mStartTimeNs;
+                    }
+                }
+                item.mTimestamp = mStartTimeNs + (item.mTimestamp - mFirstFrameTimestamp);
 
-            break;
-        } else {
-            ALOGE("read: acquire failed with error code %d", err);
-            return ERROR_END_OF_STREAM;
-        }
+                mNumFramesReceived++;
 
-    }
+                break;
+            } else {
+                ALOGE("read: acquire failed with error code %d", err);
+                return ERROR_END_OF_STREAM;
+            }
 
-    // If the loop was exited as a result of stopping the recording,
-    // it is OK
-    if (!mStarted) {
-        ALOGV("Read: SurfaceMediaSource is stopped. Returning ERROR_END_OF_STREAM.");
-        return ERROR_END_OF_STREAM;
-    }
+        }
 
-    mCurrentSlot = item.mSlot;
+        // If the loop was exited as a result of stopping the recording,
+        // it is OK
+        if (!mStarted) {
+            ALOGV("Read: SurfaceMediaSource is stopped. Returning ERROR_END_OF_STREAM.");
+            return ERROR_END_OF_STREAM;
+        }
 
-    // First time seeing the buffer?  Added it to the SMS slot
-    if (item.mGraphicBuffer != NULL) {
-        mSlots[item.mSlot].mGraphicBuffer = item.mGraphicBuffer;
-    }
-    mSlots[item.mSlot].mFrameNumber = item.mFrameNumber;
+        mCurrentSlot = item.mSlot;
 
-    mCurrentBuffers.push_back(mSlots[mCurrentSlot].mGraphicBuffer);
-    int64_t prevTimeStamp = mCurrentTimestamp;
-    mCurrentTimestamp = item.mTimestamp;
+        mCurrentBuffers.push_back(mSlots[mCurrentSlot].mGraphicBuffer);
+        int64_t prevTimeStamp = mCurrentTimestamp;
+        mCurrentTimestamp = item.mTimestamp;
 
-    mNumFramesEncoded++;
-    // Pass the data to the MediaBuffer. Pass in only the metadata
+        mNumFramesEncoded++;
+        // Pass the data to the MediaBuffer. Pass in only the metadata
 
-    passMetadataBuffer_l(buffer, mSlots[mCurrentSlot].mGraphicBuffer->getNativeBuffer());
+        passMetadataBuffer_l(buffer, mSlots[mCurrentSlot].mGraphicBuffer->getNativeBuffer());
 
-    (*buffer)->setObserver(this);
-    (*buffer)->add_ref();
-    (*buffer)->meta_data().setInt64(kKeyTime, mCurrentTimestamp / 1000);
-    ALOGV("Frames encoded = %d, timestamp = %" PRId64 ", time diff = %" PRId64,
-            mNumFramesEncoded, mCurrentTimestamp / 1000,
-            mCurrentTimestamp / 1000 - prevTimeStamp / 1000);
+        (*buffer)->setObserver(this);
+        (*buffer)->add_ref();
+        (*buffer)->meta_data().setInt64(kKeyTime, mCurrentTimestamp / 1000);
+        ALOGV("Frames encoded = %d, timestamp = %" PRId64 ", time diff = %" PRId64,
+                mNumFramesEncoded, mCurrentTimestamp / 1000,
+                mCurrentTimestamp / 1000 - prevTimeStamp / 1000);
 
-    ++mNumPendingBuffers;
+        ++mNumPendingBuffers;
 
 #if DEBUG_PENDING_BUFFERS
-    mPendingBuffers.push_back(*buffer);
+        mPendingBuffers.push_back(*buffer);
 #endif
+    }
+
+    // Wait for the producer's rendering into the buffer to finish outside
+    // the lock: queueBuffer's onFrameAvailable callback takes mMutex, so
+    // waiting under the lock would stall the producer for the whole
+    // composition time of the frame.
+    status_t err = item.mFence->waitForever("SurfaceMediaSource::read");
+    if (err) {
+        ALOGW("read: failed to wait for buffer fence: %d", err);
+    }
 
     ALOGV("returning mbuf %p", *buffer);
 
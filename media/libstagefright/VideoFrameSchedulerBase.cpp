@@ -366,12 +366,44 @@ float VideoFrameSchedulerBase::getFrameRate() {
 }
 
 nsecs_t VideoFrameSchedulerBase::schedule(nsecs_t renderTime) {
-    nsecs_t origRenderTime = renderTime;
+    nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    refreshVsync(now);
+    return scheduleFrame(renderTime, now);
+}
 
+void VideoFrameSchedulerBase::scheduleBatch(
+        const nsecs_t *renderTimes, nsecs_t *scheduledTimes, size_t count) {
     nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
-    if (now >= mVsyncRefreshAt) {
-        updateVsync();
+    refreshVsync(now);
+    for (size_t i = 0; i < count; ++i) {
+        scheduledTimes[i] = scheduleFrame(renderTimes[i], now);
     }
+}
+
+void VideoFrameSchedulerBase::refreshVsync(nsecs_t now) {
+    if (now < mVsyncRefreshAt) {
+        return;
+    }
+
+    const nsecs_t oldVsyncPeriod = mVsyncPeriod;
+    updateVsync();
+
+    // A display refresh switch (e.g. 60Hz <-> 120Hz) invalidates the running
+    // correction, which is expressed in units of the old vsync period. Drop
+    // it -- but keep the video PLL, as the content cadence didn't change --
+    // so we lock onto the new timing within a couple of frames instead of
+    // drifting until the correction limit trips a full restart.
+    if (oldVsyncPeriod > 0 && mVsyncPeriod > 0
+            && abs(mVsyncPeriod - oldVsyncPeriod) > oldVsyncPeriod / 100) {
+        ALOGV("vsync period changed: %lld => %lld",
+                (long long)oldVsyncPeriod, (long long)mVsyncPeriod);
+        mLastVsyncTime = -1;
+        mTimeCorrection = 0;
+    }
+}
+
+nsecs_t VideoFrameSchedulerBase::scheduleFrame(nsecs_t renderTime, nsecs_t now) {
+    nsecs_t origRenderTime = renderTime;
 
     // without VSYNC info, there is nothing to do
     if (mVsyncPeriod == 0) {
@@ -447,6 +479,10 @@ nsecs_t VideoFrameSchedulerBase::schedule(nsecs_t renderTime) {
                         " restarting. render=%lld",
                         (long long)mTimeCorrection, (long long)correctionLimit,
                         vsyncsForLastFrame, minVsyncsPerFrame, (long long)origRenderTime);
+                // drift like this often means the display refresh rate
+                // changed; re-poll the timing right away instead of waiting
+                // out the rest of the refresh interval
+                mVsyncRefreshAt = 0;
                 restart();
                 return origRenderTime;
             }
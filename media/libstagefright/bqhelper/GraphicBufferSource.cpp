@@ -430,13 +430,7 @@ status_t GraphicBufferSource::start() {
     // one codec buffer simultaneously.  (We could instead try to submit
     // all BQ buffers whenever any codec buffer is freed, but if we get the
     // initial conditions right that will never be useful.)
-    while (haveAvailableBuffers_l()) {
-        if (!fillCodecBuffer_l()) {
-            ALOGV("stop load with available=%zu+%d",
-                    mAvailableBuffers.size(), mNumAvailableUnacquiredBuffers);
-            break;
-        }
-    }
+    fillAvailableCodecBuffers_l();
 
     ALOGV("done loading initial frames, available=%zu+%d",
             mAvailableBuffers.size(), mNumAvailableUnacquiredBuffers);
@@ -566,11 +560,12 @@ status_t GraphicBufferSource::onInputBufferEmptied(codec_buffer_id bufferId, int
     buffer.reset();
 
     if (haveAvailableBuffers_l()) {
-        // Fill this codec buffer.
+        // Fill codec buffers from the whole backlog, not just the one just freed; more than one
+        // codec buffer can be free if earlier wakeups ran out of available frames.
         CHECK(!mEndOfStreamSent);
         ALOGV("onInputBufferEmptied: buffer freed, feeding codec (available=%zu+%d, eos=%d)",
                 mAvailableBuffers.size(), mNumAvailableUnacquiredBuffers, mEndOfStream);
-        fillCodecBuffer_l();
+        fillAvailableCodecBuffers_l();
     } else if (mEndOfStream && mStopTimeUs == -1) {
         // No frames available, but EOS is pending and no stop time, so use this buffer to
         // send that.
@@ -743,6 +738,35 @@ bool GraphicBufferSource::fillCodecBuffer_l() {
     return true;
 }
 
+void GraphicBufferSource::fillAvailableCodecBuffers_l() {
+    while (haveAvailableBuffers_l()) {
+        if (!fillCodecBuffer_l()) {
+            ALOGV("stop filling with available=%zu+%d",
+                    mAvailableBuffers.size(), mNumAvailableUnacquiredBuffers);
+            break;
+        }
+    }
+}
+
+void GraphicBufferSource::dropOldestPendingBuffer_l() {
+    if (!mAvailableBuffers.empty()) {
+        ALOGV("dropping oldest available buffer, available=%zu+%d",
+                mAvailableBuffers.size(), mNumAvailableUnacquiredBuffers);
+        // releasing the last reference returns the buffer to the producer
+        mAvailableBuffers.erase(mAvailableBuffers.begin());
+        return;
+    }
+    if (mNumAvailableUnacquiredBuffers > 0) {
+        ALOGV("dropping oldest unacquired buffer, available=%zu+%d",
+                mAvailableBuffers.size(), mNumAvailableUnacquiredBuffers);
+        VideoBuffer item;
+        if (acquireBuffer_l(&item) != OK) {
+            ALOGW("dropOldestPendingBuffer_l: failed to acquire available unacquired buffer");
+        }
+        // item going out of scope releases the buffer back to the producer
+    }
+}
+
 bool GraphicBufferSource::repeatLatestBuffer_l() {
     CHECK(mExecuting && !haveAvailableBuffers_l());
 
@@ -1026,6 +1050,15 @@ void GraphicBufferSource::onFrameAvailable(const BufferItem& item __unused) {
         ALOGV("onFrameAvailable: cannot acquire buffer right now, do it later");
 
         ++mRepeatLastFrameGeneration; // cancel any pending frame repeat
+
+        // If the client allows frame dropping, bound the backlog by the codec's real queue
+        // depth: pending frames beyond the number of codec buffers in flight could only ever
+        // be encoded late, so drop the oldest one now instead of stalling the producer.
+        if (mFrameDropper != nullptr && !mFrameDropper->disabled()
+                && mAvailableBuffers.size() + mNumAvailableUnacquiredBuffers
+                        > mSubmittedCodecBuffers.size()) {
+            dropOldestPendingBuffer_l();
+        }
         return;
     }
 
@@ -1059,7 +1092,9 @@ void GraphicBufferSource::onBufferAcquired_l(const VideoBuffer &buffer) {
         ++mRepeatLastFrameGeneration; // cancel any pending frame repeat
         mAvailableBuffers.push_back(buffer);
         if (mExecuting) {
-            fillCodecBuffer_l();
+            // drain the whole backlog in one pass; there may be older unacquired frames
+            // from wakeups when the codec had no free buffer
+            fillAvailableCodecBuffers_l();
         }
     }
 }
@@ -327,6 +327,16 @@ private:
     // \returns true if acquired (and handled) the next frame. Otherwise, false.
     bool fillCodecBuffer_l();
 
+    // Repeatedly calls fillCodecBuffer_l until either the available frames or the free codec
+    // buffers run out, so that one wakeup drains the whole backlog instead of feeding a single
+    // frame per event.
+    void fillAvailableCodecBuffers_l();
+
+    // Acquires and immediately releases the oldest pending frame (preferring one already
+    // acquired). Used to keep the backlog bounded by the codec queue depth when the codec has
+    // no free input buffers and the client allows frame dropping.
+    void dropOldestPendingBuffer_l();
+
     // Calculates the media timestamp for |item| and on success it submits the buffer to the codec,
     // while also keeping a reference for it in mSubmittedCodecBuffers.
     // Returns UNKNOWN_ERROR if the buffer was not submitted due to buffer timestamp. Otherwise,
@@ -30,6 +30,10 @@
 #include "libyuv/convert_argb.h"
 #include "libyuv/planar_functions.h"
 #include "libyuv/video_common.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include <functional>
 #include <sys/time.h>
 
@@ -365,6 +369,49 @@ status_t ColorConverter::convert(
         return ERROR_UNSUPPORTED;
     }
 
+    // Large frames are split into row tiles converted on worker threads; the
+    // per-format kernels only touch rows within the crop rect, so each tile
+    // is an independent conversion with an adjusted vertical crop.  Tile
+    // boundaries stay even to respect 4:2:0 chroma subsampling.
+    static constexpr size_t kMinRowsPerTile = 256;
+    size_t numTiles = std::min<size_t>(
+            std::max(1u, std::thread::hardware_concurrency()),
+            src.cropHeight() / kMinRowsPerTile);
+    numTiles = std::min<size_t>(numTiles, 4);
+
+    if (numTiles > 1) {
+        std::vector<std::thread> workers;
+        std::vector<status_t> results(numTiles, OK);
+        const size_t cropHeight = src.cropHeight();
+        for (size_t i = 0; i < numTiles; ++i) {
+            const size_t top = (cropHeight * i / numTiles) & ~1;
+            const size_t bottom = (i == numTiles - 1)
+                    ? cropHeight : ((cropHeight * (i + 1) / numTiles) & ~1);
+            BitmapParams tileSrc = src;
+            tileSrc.mCropTop = src.mCropTop + top;
+            tileSrc.mCropBottom = src.mCropTop + bottom - 1;
+            BitmapParams tileDst = dst;
+            tileDst.mCropTop = dst.mCropTop + top;
+            tileDst.mCropBottom = dst.mCropTop + bottom - 1;
+            workers.emplace_back([this, tileSrc, tileDst, &results, i] {
+                results[i] = convertInternal(tileSrc, tileDst);
+            });
+        }
+        status_t err = OK;
+        for (size_t i = 0; i < numTiles; ++i) {
+            workers[i].join();
+            if (results[i] != OK) {
+                err = results[i];
+            }
+        }
+        return err;
+    }
+
+    return convertInternal(src, dst);
+}
+
+status_t ColorConverter::convertInternal(
+        const BitmapParams &src, const BitmapParams &dst) {
     status_t err;
 
     switch ((int32_t)mSrcFormat) {
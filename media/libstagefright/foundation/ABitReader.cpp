@@ -16,6 +16,8 @@
 
 #include "ABitReader.h"
 
+#include <string.h>
+
 #include <media/stagefright/foundation/ADebug.h>
 
 namespace android {
@@ -37,9 +39,26 @@ bool ABitReader::fillReservoir() {
         return false;
     }
 
+    if (mSize >= sizeof(uint64_t)) {
+        // Word-at-a-time refill: a single unaligned load plus byte swap
+        // instead of a byte-serial loop.  memcpy keeps the load legal on
+        // strict-alignment targets and compiles to a plain load.
+        uint64_t word;
+        memcpy(&word, mData, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        mReservoir = __builtin_bswap64(word);
+#else
+        mReservoir = word;
+#endif
+        mData += sizeof(uint64_t);
+        mSize -= sizeof(uint64_t);
+        mNumBitsLeft = 64;
+        return true;
+    }
+
     mReservoir = 0;
     size_t i;
-    for (i = 0; mSize > 0 && i < 4; ++i) {
+    for (i = 0; mSize > 0 && i < 8; ++i) {
         mReservoir = (mReservoir << 8) | *mData;
 
         ++mData;
@@ -47,7 +66,7 @@ bool ABitReader::fillReservoir() {
     }
 
     mNumBitsLeft = 8 * i;
-    mReservoir <<= 32 - mNumBitsLeft;
+    mReservoir <<= 64 - mNumBitsLeft;
     return true;
 }
 
@@ -81,7 +100,7 @@ bool ABitReader::getBitsGraceful(size_t n, uint32_t *out) {
             m = mNumBitsLeft;
         }
 
-        result = (result << m) | (mReservoir >> (32 - m));
+        result = (result << m) | (uint32_t)(mReservoir >> (64 - m));
         mReservoir <<= m;
         mNumBitsLeft -= m;
 
@@ -114,13 +133,17 @@ void ABitReader::putBits(uint32_t x, size_t n) {
 
     CHECK_LE(n, 32u);
 
-    while (mNumBitsLeft + n > 32) {
+    if (n == 0) {
+        return;
+    }
+
+    while (mNumBitsLeft + n > 64) {
         mNumBitsLeft -= 8;
         --mData;
         ++mSize;
     }
 
-    mReservoir = (mReservoir >> n) | (x << (32 - n));
+    mReservoir = (mReservoir >> n) | ((uint64_t)x << (64 - n));
     mNumBitsLeft += n;
 }
 
@@ -177,7 +200,7 @@ bool NALBitReader::fillReservoir() {
 
     mReservoir = 0;
     size_t i = 0;
-    while (mSize > 0 && i < 4) {
+    while (mSize > 0 && i < 8) {
         bool isEmulationPreventionByte = (mNumZeros >= 2 && *mData == 3);
 
         if (*mData == 0) {
@@ -196,8 +219,14 @@ bool NALBitReader::fillReservoir() {
         --mSize;
     }
 
+    if (i == 0) {
+        // every remaining byte was an emulation prevention byte.
+        mOverRead = true;
+        return false;
+    }
+
     mNumBitsLeft = 8 * i;
-    mReservoir <<= 32 - mNumBitsLeft;
+    mReservoir <<= 64 - mNumBitsLeft;
     return true;
 }
 
@@ -20,13 +20,48 @@
 #include "ALooper.h"
 #include "AMessage.h"
 
+#include <utils/Mutex.h>
+
 namespace android {
 
+// Small codec-config payloads, NAL headers and the like churn through tiny
+// ABuffers constantly, so allocations up to kSmallBufferSize are served from
+// a freelist of fixed-size blocks instead of malloc. Whether a buffer came
+// from the pool is implied by its capacity: every owning buffer with
+// mCapacity <= kSmallBufferSize holds a kSmallBufferSize block.
+static const size_t kSmallBufferSize = 256;
+static const size_t kMaxPooledBuffers = 32;
+
+static Mutex gSmallBufferLock;
+static void *gSmallBuffers[kMaxPooledBuffers];
+static size_t gSmallBufferCount = 0;
+
+static void *acquireSmallBuffer() {
+    {
+        Mutex::Autolock autoLock(gSmallBufferLock);
+        if (gSmallBufferCount > 0) {
+            return gSmallBuffers[--gSmallBufferCount];
+        }
+    }
+    return malloc(kSmallBufferSize);
+}
+
+static void recycleSmallBuffer(void *data) {
+    {
+        Mutex::Autolock autoLock(gSmallBufferLock);
+        if (gSmallBufferCount < kMaxPooledBuffers) {
+            gSmallBuffers[gSmallBufferCount++] = data;
+            return;
+        }
+    }
+    free(data);
+}
+
 ABuffer::ABuffer(size_t capacity)
     : mRangeOffset(0),
       mInt32Data(0),
       mOwnsData(true) {
-    mData = malloc(capacity);
+    mData = (capacity <= kSmallBufferSize) ? acquireSmallBuffer() : malloc(capacity);
     if (mData == NULL) {
         mCapacity = 0;
         mRangeLength = 0;
@@ -59,7 +94,11 @@ sp<ABuffer> ABuffer::CreateAsCopy(const void *data, size_t capacity)
 ABuffer::~ABuffer() {
     if (mOwnsData) {
         if (mData != NULL) {
-            free(mData);
+            if (mCapacity <= kSmallBufferSize) {
+                recycleSmallBuffer(mData);
+            } else {
+                free(mData);
+            }
             mData = NULL;
         }
     }
@@ -23,6 +23,8 @@
 
 #include <sys/time.h>
 
+#include <vector>
+
 #include "ALooper.h"
 
 #include "AHandler.h"
@@ -85,6 +87,14 @@ void ALooper::setName(const char *name) {
     mName = name;
 }
 
+void ALooper::setTimerSlackUs(int64_t slackUs) {
+    Mutex::Autolock autoLock(mLock);
+    CHECK_GE(slackUs, 0);
+    mTimerSlackUs = slackUs;
+    // Wake the loop so an armed precise deadline is re-armed with slack.
+    mQueueChangedCondition.signal();
+}
+
 ALooper::handler_id ALooper::registerHandler(const sp<AHandler> &handler) {
     return gLooperRoster.registerHandler(this, handler);
 }
@@ -177,16 +187,28 @@ void ALooper::post(const sp<AMessage> &msg, int64_t delayUs) {
         whenUs = GetNowUs();
     }
 
-    List<Event>::iterator it = mEventQueue.begin();
-    while (it != mEventQueue.end() && (*it).mWhenUs <= whenUs) {
-        ++it;
+    // Messages are typically posted in deadline order, so search for the
+    // insertion position from the back of the queue; the common append case
+    // is then O(1) instead of a walk over every queued event.
+    List<Event>::iterator it = mEventQueue.end();
+    while (it != mEventQueue.begin()) {
+        List<Event>::iterator prev = it;
+        --prev;
+        if ((*prev).mWhenUs <= whenUs) {
+            break;
+        }
+        it = prev;
     }
 
     Event event;
     event.mWhenUs = whenUs;
     event.mMessage = msg;
 
-    if (it == mEventQueue.begin()) {
+    // Only wake the looper when this event needs to run before the wakeup it
+    // is currently armed for; posts behind an already armed wakeup (or while
+    // the looper is busy delivering, which rechecks the queue anyway) skip
+    // the futex syscall.
+    if (it == mEventQueue.begin() && whenUs < mNextWakeupUs) {
         mQueueChangedCondition.signal();
     }
 
@@ -194,7 +216,11 @@ void ALooper::post(const sp<AMessage> &msg, int64_t delayUs) {
 }
 
 bool ALooper::loop() {
-    Event event;
+    // All events that are already due are drained under a single lock
+    // acquisition and delivered back to back, so a burst of posts costs one
+    // wakeup instead of one lock/unlock (and potentially one futex wait)
+    // per message.
+    std::vector<Event> events;
 
     {
         Mutex::Autolock autoLock(mLock);
@@ -202,27 +228,44 @@ bool ALooper::loop() {
             return false;
         }
         if (mEventQueue.empty()) {
+            mNextWakeupUs = INT64_MAX;
             mQueueChangedCondition.wait(mLock);
+            mNextWakeupUs = -1;
             return true;
         }
         int64_t whenUs = (*mEventQueue.begin()).mWhenUs;
         int64_t nowUs = GetNowUs();
 
         if (whenUs > nowUs) {
-            int64_t delayUs = whenUs - nowUs;
+            // Let the head fire up to mTimerSlackUs late, so later messages
+            // falling inside the slack window ride on the same wakeup.
+            int64_t slackUs = mTimerSlackUs;
+            int64_t armedUs =
+                (whenUs > INT64_MAX - slackUs ? INT64_MAX : whenUs + slackUs);
+            int64_t delayUs = armedUs - nowUs;
             if (delayUs > INT64_MAX / 1000) {
                 delayUs = INT64_MAX / 1000;
             }
+            mNextWakeupUs = armedUs;
             mQueueChangedCondition.waitRelative(mLock, delayUs * 1000ll);
+            mNextWakeupUs = -1;
 
             return true;
         }
 
-        event = *mEventQueue.begin();
-        mEventQueue.erase(mEventQueue.begin());
+        // Deliver everything due within the slack window in this batch.
+        int64_t dueUs =
+            (nowUs > INT64_MAX - mTimerSlackUs ? INT64_MAX : nowUs + mTimerSlackUs);
+        do {
+            events.push_back(*mEventQueue.begin());
+            mEventQueue.erase(mEventQueue.begin());
+        } while (!mEventQueue.empty() && (*mEventQueue.begin()).mWhenUs <= dueUs);
     }
 
-    event.mMessage->deliver();
+    for (auto &event : events) {
+        event.mMessage->deliver();
+        event.mMessage.clear();
+    }
 
     // NOTE: It's important to note that at this point our "ALooper" object
     // may no longer exist (its final reference may have gone away while
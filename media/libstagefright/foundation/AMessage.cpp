@@ -39,6 +39,29 @@
 
 namespace android {
 
+namespace {
+
+// Per-thread freelist of AMessage-sized blocks.  Thread-local storage keeps
+// it lock-free; alloc/free pairs on the same thread (the common looper and
+// codec patterns) recycle without touching the heap allocator, and anything
+// else falls through to the global operator new/delete.
+constexpr size_t kMessageFreeListMaxItems = 64;
+
+struct MessageFreeList {
+    void *mItems[kMessageFreeListMaxItems];
+    size_t mCount = 0;
+
+    ~MessageFreeList() {
+        while (mCount > 0) {
+            ::operator delete(mItems[--mCount]);
+        }
+    }
+};
+
+thread_local MessageFreeList gMessageFreeList;
+
+}  // namespace
+
 extern ALooperRoster gLooperRoster;
 
 status_t AReplyToken::setReply(const sp<AMessage> &reply) {
@@ -52,6 +75,25 @@ status_t AReplyToken::setReply(const sp<AMessage> &reply) {
     return OK;
 }
 
+// static
+void *AMessage::operator new(size_t size) {
+    MessageFreeList &fl = gMessageFreeList;
+    if (size == sizeof(AMessage) && fl.mCount > 0) {
+        return fl.mItems[--fl.mCount];
+    }
+    return ::operator new(size);
+}
+
+// static
+void AMessage::operator delete(void *ptr, size_t size) {
+    MessageFreeList &fl = gMessageFreeList;
+    if (size == sizeof(AMessage) && fl.mCount < kMessageFreeListMaxItems) {
+        fl.mItems[fl.mCount++] = ptr;
+        return;
+    }
+    ::operator delete(ptr);
+}
+
 AMessage::AMessage(void)
     : mWhat(0),
       mTarget(0) {
@@ -89,8 +131,7 @@ void AMessage::setTarget(const sp<const AHandler> &handler) {
 void AMessage::clear() {
     // Item needs to be handled delicately
     for (Item &item : mItems) {
-        delete[] item.mName;
-        item.mName = NULL;
+        item.clearName();
         freeItemValue(&item);
     }
     mItems.clear();
@@ -182,16 +223,47 @@ inline size_t AMessage::findItemIndex(const char *name, size_t len) const {
 // assumes item's name was uninitialized or NULL
 void AMessage::Item::setName(const char *name, size_t len) {
     mNameLength = len;
-    mName = new char[len + 1];
+    if (len <= kInlineNameLength) {
+        mName = mInlineName;
+    } else {
+        mName = new char[len + 1];
+    }
     memcpy((void*)mName, name, len + 1);
 }
 
+void AMessage::Item::clearName() {
+    if (mName != mInlineName) {
+        delete[] mName;
+    }
+    mName = nullptr;
+}
+
 AMessage::Item::Item(const char *name, size_t len)
     : mType(kTypeInt32) {
     // mName and mNameLength are initialized by setName
     setName(name, len);
 }
 
+AMessage::Item::Item(const Item &other) {
+    *this = other;
+}
+
+AMessage::Item &AMessage::Item::operator=(const Item &other) {
+    // Values are copied shallowly, preserving the historic trivially-copyable
+    // semantics the callers rely on for ownership transfer.  Only an inline
+    // name needs fixing up so that mName points into this item's storage.
+    u = other.u;
+    mNameLength = other.mNameLength;
+    mType = other.mType;
+    if (other.mName == other.mInlineName) {
+        memcpy(mInlineName, other.mInlineName, other.mNameLength + 1);
+        mName = mInlineName;
+    } else {
+        mName = other.mName;
+    }
+    return *this;
+}
+
 AMessage::Item *AMessage::allocateItem(const char *name) {
     size_t len = strlen(name);
     size_t i = findItemIndex(name, len);
@@ -1010,8 +1082,7 @@ status_t AMessage::setEntryNameAt(size_t index, const char *name) {
     if (findItemIndex(name, len) < mItems.size()) {
         return ALREADY_EXISTS;
     }
-    delete[] mItems[index].mName;
-    mItems[index].mName = nullptr;
+    mItems[index].clearName();
     mItems[index].setName(name, len);
     return OK;
 }
@@ -1075,8 +1146,7 @@ status_t AMessage::removeEntryAt(size_t index) {
         return BAD_INDEX;
     }
     // delete entry data and objects
-    delete[] mItems[index].mName;
-    mItems[index].mName = nullptr;
+    mItems[index].clearName();
     freeItemValue(&mItems[index]);
 
     // swap entry with last entry and clear last entry's data
@@ -386,10 +386,29 @@ AString AStringPrintf(const char *format, ...) {
     va_list ap;
     va_start(ap, format);
 
+    // Most formatted strings (component names, mime types, debug state) are
+    // short; format into a stack buffer first so they cost one allocation
+    // (the AString's own) instead of also paying for vasprintf's.
+    char stackBuffer[128];
+    va_list ap2;
+    va_copy(ap2, ap);
+    int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, ap);
+    va_end(ap);
+
+    if (len < 0) {
+        va_end(ap2);
+        return AString();
+    }
+
+    if ((size_t)len < sizeof(stackBuffer)) {
+        va_end(ap2);
+        return AString(stackBuffer, len);
+    }
+
     char *buffer;
-    int bufferSize = vasprintf(&buffer, format, ap);
+    int bufferSize = vasprintf(&buffer, format, ap2);
 
-    va_end(ap);
+    va_end(ap2);
 
     if(bufferSize < 0) {
         return AString();
@@ -18,6 +18,7 @@
 #include <utils/Log.h>
 
 #include <list>
+#include <vector>
 
 #include <binder/MemoryDealer.h>
 #include <media/stagefright/foundation/ADebug.h>
@@ -36,11 +37,105 @@ constexpr T MIN(const T &a, const T &b) { return a <= b ? a : b; }
 static const size_t kSharedMemoryThreshold = MIN(
         (size_t)MediaBuffer::kSharedMemThreshold, (size_t)(4 * 1024));
 
+// Free buffers are indexed by power-of-two size class so acquire_buffer can
+// pop a fitting buffer in O(1) instead of scanning every buffer (in-use ones
+// included) under the lock.  Buffers in class c have size in [2^c, 2^(c+1)).
+static const size_t kNumSizeClasses = 32;
+
+static inline size_t sizeClassFor(size_t size) {
+    if (size < 2) {
+        return 0;
+    }
+    const size_t msb = (sizeof(unsigned long long) * 8 - 1) - __builtin_clzll(size);
+    return MIN(msb, kNumSizeClasses - 1);
+}
+
 struct MediaBufferGroup::InternalData {
     Mutex mLock;
     Condition mCondition;
     size_t mGrowthLimit;  // Do not automatically grow group larger than this.
     std::list<MediaBufferBase *> mBuffers;
+
+    // Per-size-class lists of buffers known to be free (returned through
+    // signalBufferReturned and not yet re-acquired).  Remotely released
+    // shared memory buffers do not pass through the observer, so an empty
+    // free list is not proof that no buffer is free - acquire_buffer falls
+    // back to the legacy scan in that case.
+    std::vector<MediaBufferBase *> mFreeLists[kNumSizeClasses];
+
+    size_t mWaiters = 0;       // threads blocked in acquire_buffer.
+    size_t mBaseBuffers = 0;   // explicitly added buffers; trimming never
+                               // shrinks the group below this population.
+    size_t mFreeRetention = SIZE_MAX;  // SIZE_MAX disables automatic trimming.
+
+    void pushFree_l(MediaBufferBase *buffer) {
+        mFreeLists[sizeClassFor(buffer->size())].emplace_back(buffer);
+    }
+
+    // Removes a buffer from its free list, if present.  Required whenever a
+    // free buffer is taken or destroyed outside of dequeueFree_l.
+    void removeFree_l(MediaBufferBase *buffer) {
+        std::vector<MediaBufferBase *> &freeList = mFreeLists[sizeClassFor(buffer->size())];
+        for (auto it = freeList.begin(); it != freeList.end(); ++it) {
+            if (*it == buffer) {
+                freeList.erase(it);
+                return;
+            }
+        }
+    }
+
+    MediaBufferBase *dequeueFree_l(size_t requestedSize) {
+        const size_t startClass = sizeClassFor(requestedSize);
+        for (size_t c = startClass; c < kNumSizeClasses; ++c) {
+            std::vector<MediaBufferBase *> &freeList = mFreeLists[c];
+            if (requestedSize > 0 && c == startClass) {
+                // the requested size falls inside this class, so members
+                // may still be too small - check.
+                for (auto it = freeList.begin(); it != freeList.end(); ++it) {
+                    if ((*it)->size() >= requestedSize) {
+                        MediaBufferBase *buffer = *it;
+                        freeList.erase(it);
+                        return buffer;
+                    }
+                }
+            } else if (!freeList.empty()) {
+                MediaBufferBase *buffer = freeList.back();
+                freeList.pop_back();
+                return buffer;
+            }
+        }
+        return nullptr;
+    }
+
+    // Applies the trim policy: while the group has grown beyond its base
+    // population and more than mFreeRetention buffers sit unused, releases
+    // free buffers back to the system.
+    size_t trim_l() {
+        if (mFreeRetention == SIZE_MAX) {
+            return 0;
+        }
+        size_t freeCount = 0;
+        for (size_t c = 0; c < kNumSizeClasses; ++c) {
+            freeCount += mFreeLists[c].size();
+        }
+        size_t trimmed = 0;
+        // free the largest buffers first to return the most memory.
+        for (size_t c = kNumSizeClasses; c-- > 0;) {
+            std::vector<MediaBufferBase *> &freeList = mFreeLists[c];
+            while (!freeList.empty()
+                    && freeCount > mFreeRetention
+                    && mBuffers.size() > mBaseBuffers) {
+                MediaBufferBase *buffer = freeList.back();
+                freeList.pop_back();
+                --freeCount;
+                mBuffers.remove(buffer);
+                buffer->setObserver(nullptr);
+                buffer->release();
+                ++trimmed;
+            }
+        }
+        return trimmed;
+    }
 };
 
 MediaBufferGroup::MediaBufferGroup(size_t growthLimit)
@@ -137,6 +232,7 @@ void MediaBufferGroup::add_buffer(MediaBufferBase *buffer) {
             && mInternal->mBuffers.size() >= mInternal->mGrowthLimit
             && it != mInternal->mBuffers.end();) {
         if ((*it)->refcount() == 0) {
+            mInternal->removeFree_l(*it);
             (*it)->setObserver(nullptr);
             (*it)->release();
             it = mInternal->mBuffers.erase(it);
@@ -147,6 +243,18 @@ void MediaBufferGroup::add_buffer(MediaBufferBase *buffer) {
 
     buffer->setObserver(this);
     mInternal->mBuffers.emplace_back(buffer);
+    mInternal->pushFree_l(buffer);
+    ++mInternal->mBaseBuffers;
+}
+
+void MediaBufferGroup::setFreeBufferRetention(size_t retain) {
+    Mutex::Autolock autoLock(mInternal->mLock);
+    mInternal->mFreeRetention = retain;
+}
+
+size_t MediaBufferGroup::trim() {
+    Mutex::Autolock autoLock(mInternal->mLock);
+    return mInternal->trim_l();
 }
 
 bool MediaBufferGroup::has_buffers() {
@@ -165,9 +273,18 @@ status_t MediaBufferGroup::acquire_buffer(
         MediaBufferBase **out, bool nonBlocking, size_t requestedSize) {
     Mutex::Autolock autoLock(mInternal->mLock);
     for (;;) {
+        // Fast path: pop a fitting buffer from the size-classed free lists.
+        MediaBufferBase *buffer = mInternal->dequeueFree_l(requestedSize);
+        if (buffer != nullptr) {
+            buffer->add_ref();
+            buffer->reset();
+            *out = buffer;
+            return OK;
+        }
+        // Slow path: scan for buffers freed without notification (remote
+        // release), or grow the group / reallocate a too-small free buffer.
         size_t smallest = requestedSize;
         size_t biggest = requestedSize;
-        MediaBufferBase *buffer = nullptr;
         auto free = mInternal->mBuffers.end();
         for (auto it = mInternal->mBuffers.begin(); it != mInternal->mBuffers.end(); ++it) {
             const size_t size = (*it)->size();
@@ -185,6 +302,9 @@ status_t MediaBufferGroup::acquire_buffer(
                 }
             }
         }
+        if (buffer != nullptr) {
+            mInternal->removeFree_l(buffer);
+        }
         if (buffer == nullptr
                 && (free != mInternal->mBuffers.end()
                     || mInternal->mBuffers.size() < mInternal->mGrowthLimit)) {
@@ -202,6 +322,7 @@ status_t MediaBufferGroup::acquire_buffer(
                 if (free != mInternal->mBuffers.end()) {
                     ALOGV("reallocate buffer, requested size %zu vs available %zu",
                             requestedSize, (*free)->size());
+                    mInternal->removeFree_l(*free);
                     (*free)->setObserver(nullptr);
                     (*free)->release();
                     *free = buffer; // in-place replace
@@ -222,7 +343,9 @@ status_t MediaBufferGroup::acquire_buffer(
             return WOULD_BLOCK;
         }
         // All buffers are in use, block until one of them is returned.
+        ++mInternal->mWaiters;
         mInternal->mCondition.wait(mInternal->mLock);
+        --mInternal->mWaiters;
     }
     // Never gets here.
 }
@@ -231,9 +354,21 @@ size_t MediaBufferGroup::buffers() const {
     return mInternal->mBuffers.size();
 }
 
-void MediaBufferGroup::signalBufferReturned(MediaBufferBase *) {
+void MediaBufferGroup::signalBufferReturned(MediaBufferBase *buffer) {
     Mutex::Autolock autoLock(mInternal->mLock);
-    mInternal->mCondition.signal();
+    if (buffer != nullptr) {
+        mInternal->pushFree_l(buffer);
+        if (mInternal->mWaiters == 0) {
+            // nobody to wake; shed memory grown during a burst, per policy.
+            mInternal->trim_l();
+            return;
+        }
+    }
+    // Targeted wake: only issue the (syscall-backed) signal when a thread is
+    // actually blocked in acquire_buffer; one buffer unblocks one waiter.
+    if (mInternal->mWaiters > 0) {
+        mInternal->mCondition.signal();
+    }
 }
 
 }  // namespace android
@@ -53,7 +53,11 @@ private:
 
     union {
         void *ext_data;
-        float reservoir;
+        int64_t alignment;  // forces 8-byte alignment of the reservoir
+        // Inline storage for small values: int32/int64/float/pointer/Rect and
+        // short strings all fit without a per-item heap allocation.  This
+        // matters in demux hot loops that set e.g. kKeyTime on every sample.
+        char reservoir[16];
     } u;
 
     bool usesReservoir() const {
@@ -79,15 +83,57 @@ struct MetaDataBase::Rect {
 
 struct MetaDataBase::MetaDataInternal {
     KeyedVector<uint32_t, MetaDataBase::typed_data> mItems;
+
+    // Extractors create and destroy a MetaData per sample in some paths, so
+    // cleared internal tables are recycled through a small per-thread freelist
+    // rather than returned to the heap.  Thread-local storage keeps this
+    // lock-free; alloc/free pairs on the same thread recycle, and anything
+    // else falls through to the global new/delete.
+    static MetaDataInternal *obtain() {
+        FreeList &fl = gFreeList;
+        if (fl.mCount > 0) {
+            return fl.mSlots[--fl.mCount];
+        }
+        return new MetaDataInternal();
+    }
+
+    void release() {
+        FreeList &fl = gFreeList;
+        if (fl.mCount < kFreeListMaxItems) {
+            mItems.clear();
+            fl.mSlots[fl.mCount++] = this;
+            return;
+        }
+        delete this;
+    }
+
+private:
+    static constexpr size_t kFreeListMaxItems = 16;
+
+    struct FreeList {
+        MetaDataInternal *mSlots[kFreeListMaxItems];
+        size_t mCount = 0;
+
+        ~FreeList() {
+            while (mCount > 0) {
+                delete mSlots[--mCount];
+            }
+        }
+    };
+
+    static thread_local FreeList gFreeList;
 };
 
+thread_local MetaDataBase::MetaDataInternal::FreeList
+        MetaDataBase::MetaDataInternal::gFreeList;
+
 
 MetaDataBase::MetaDataBase()
-    : mInternalData(new MetaDataInternal()) {
+    : mInternalData(MetaDataInternal::obtain()) {
 }
 
 MetaDataBase::MetaDataBase(const MetaDataBase &from)
-    : mInternalData(new MetaDataInternal()) {
+    : mInternalData(MetaDataInternal::obtain()) {
     mInternalData->mItems = from.mInternalData->mItems;
 }
 
@@ -98,7 +144,7 @@ MetaDataBase& MetaDataBase::operator = (const MetaDataBase &rhs) {
 
 MetaDataBase::~MetaDataBase() {
     clear();
-    delete mInternalData;
+    mInternalData->release();
 }
 
 void MetaDataBase::clear() {
@@ -18,6 +18,8 @@
 #define LOG_TAG "avc_utils"
 #include <utils/Log.h>
 
+#include <string.h>
+
 
 #include <media/stagefright/foundation/ABitReader.h>
 #include <media/stagefright/foundation/ADebug.h>
@@ -302,12 +304,19 @@ status_t getNextNALUnit(
         return -EAGAIN;
     }
 
-    size_t offset = 0;
-
     // A valid startcode consists of at least two 0x00 bytes followed by 0x01.
-    for (; offset + 2 < size; ++offset) {
-        if (data[offset + 2] == 0x01 && data[offset] == 0x00
-                && data[offset + 1] == 0x00) {
+    // Scan with memchr for the 0x01 and verify the two preceding zero bytes;
+    // the libc memchr runs a vector register wide instead of byte-serial,
+    // which matters at high ingest bitrates.
+    size_t offset = size - 2;
+    for (size_t pos = 2; pos < size; ++pos) {
+        const uint8_t *one = (const uint8_t *)memchr(data + pos, 0x01, size - pos);
+        if (one == NULL) {
+            break;
+        }
+        pos = one - data;
+        if (data[pos - 1] == 0x00 && data[pos - 2] == 0x00) {
+            offset = pos - 2;
             break;
         }
     }
@@ -321,9 +330,8 @@ status_t getNextNALUnit(
     size_t startOffset = offset;
 
     for (;;) {
-        while (offset < size && data[offset] != 0x01) {
-            ++offset;
-        }
+        const uint8_t *one = (const uint8_t *)memchr(data + offset, 0x01, size - offset);
+        offset = (one == NULL) ? size : (size_t)(one - data);
 
         if (offset == size) {
             if (startCodeFollows) {
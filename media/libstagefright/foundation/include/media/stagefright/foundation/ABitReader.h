@@ -63,7 +63,7 @@ protected:
     const uint8_t *mData;
     size_t mSize;
 
-    uint32_t mReservoir;  // left-aligned bits
+    uint64_t mReservoir;  // left-aligned bits, refilled a word at a time
     size_t mNumBitsLeft;
     bool mOverRead;
 
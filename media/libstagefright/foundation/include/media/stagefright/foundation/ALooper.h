@@ -52,6 +52,13 @@ struct ALooper : public RefBase {
 
     status_t stop();
 
+    // Allows timed messages to fire up to slackUs late so that nearby
+    // deadlines are delivered on one wakeup instead of one wakeup each.
+    // Zero (the default) keeps precise per-message delivery; loopers whose
+    // timed messages tolerate jitter (e.g. periodic polling) can set a few
+    // milliseconds to cut idle wakeups. May be called at any time.
+    void setTimerSlackUs(int64_t slackUs);
+
     static int64_t GetNowUs();
 
     const char *getName() const {
@@ -76,6 +83,14 @@ private:
 
     List<Event> mEventQueue;
 
+    // Time the looper is armed to wake up at, INT64_MAX while waiting with no
+    // deadline, or -1 while not waiting (the queue is rechecked each loop).
+    // Guarded by mLock; lets post() skip redundant signals.
+    int64_t mNextWakeupUs = -1;
+
+    // see setTimerSlackUs(); guarded by mLock
+    int64_t mTimerSlackUs = 0;
+
     struct LooperThread;
     sp<LooperThread> mThread;
     bool mRunningLocally;
@@ -65,6 +65,12 @@ struct AMessage : public RefBase {
     AMessage();
     AMessage(uint32_t what, const sp<const AHandler> &handler);
 
+    // AMessages are allocated and freed at a very high rate on codec data
+    // paths, so recycle their storage through a small per-thread freelist
+    // instead of hitting the heap allocator each time.
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
 #if !defined(__ANDROID_VNDK__) && !defined(__ANDROID_APEX__)
     // Construct an AMessage from a parcel.
     // nestingAllowed determines how many levels AMessage can be nested inside
@@ -304,9 +310,18 @@ private:
         const char *mName;
         size_t      mNameLength;
         Type mType;
+        // Short names are stored inline to avoid a heap allocation per item;
+        // mName points at mInlineName in that case. Note that an inline name
+        // pointer is only valid while the item stays at its current address,
+        // so the copy operations below re-point it at the destination.
+        enum { kInlineNameLength = 31 };
+        char mInlineName[kInlineNameLength + 1];
         void setName(const char *name, size_t len);
+        void clearName();
         Item() : mName(nullptr), mNameLength(0), mType(kTypeInt32) { }
         Item(const char *name, size_t length);
+        Item(const Item &other);
+        Item &operator=(const Item &other);
     };
 
     enum {
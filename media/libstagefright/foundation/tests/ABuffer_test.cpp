@@ -0,0 +1,88 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "ABuffer_test"
+
+#include <gtest/gtest.h>
+
+#include <media/stagefright/foundation/ABuffer.h>
+
+namespace android {
+
+class ABufferTest : public ::testing::Test {
+};
+
+TEST_F(ABufferTest, SmallAllocationsAreRecycled) {
+    // Small allocations come from a process-wide freelist; releasing a small
+    // buffer and allocating another one of any small size must reuse the
+    // block instead of hitting the allocator again. The freelist is LIFO, so
+    // this holds regardless of what earlier tests left in the pool.
+    uint8_t *base;
+    {
+        sp<ABuffer> buf = new ABuffer(64);
+        ASSERT_TRUE(buf->base() != NULL);
+        base = buf->base();
+    }
+    sp<ABuffer> again = new ABuffer(200);
+    EXPECT_EQ(base, again->base());
+}
+
+TEST_F(ABufferTest, SmallBufferKeepsRequestedCapacity) {
+    // Pooled blocks are larger than most requests; the buffer must still
+    // report the capacity the caller asked for.
+    sp<ABuffer> buf = new ABuffer(7);
+    EXPECT_EQ(7u, buf->capacity());
+    EXPECT_EQ(7u, buf->size());
+    EXPECT_EQ(0u, buf->offset());
+
+    buf->setRange(2, 3);
+    EXPECT_EQ(3u, buf->size());
+    EXPECT_EQ(2u, buf->offset());
+    EXPECT_EQ(buf->base() + 2, buf->data());
+}
+
+TEST_F(ABufferTest, CreateAsCopySmallAndLarge) {
+    uint8_t pattern[512];
+    for (size_t i = 0; i < sizeof(pattern); ++i) {
+        pattern[i] = i & 0xff;
+    }
+
+    sp<ABuffer> small = ABuffer::CreateAsCopy(pattern, 100);
+    ASSERT_TRUE(small != NULL);
+    EXPECT_EQ(100u, small->capacity());
+    EXPECT_EQ(0, memcmp(small->data(), pattern, 100));
+
+    sp<ABuffer> large = ABuffer::CreateAsCopy(pattern, sizeof(pattern));
+    ASSERT_TRUE(large != NULL);
+    EXPECT_EQ(sizeof(pattern), large->capacity());
+    EXPECT_EQ(0, memcmp(large->data(), pattern, sizeof(pattern)));
+}
+
+TEST_F(ABufferTest, DoesNotOwnExternalData) {
+    // Buffers wrapping caller-owned memory must neither free nor recycle it.
+    uint8_t external[32];
+    {
+        sp<ABuffer> buf = new ABuffer(external, sizeof(external));
+        EXPECT_EQ(external, buf->base());
+        EXPECT_EQ(sizeof(external), buf->capacity());
+    }
+    // A subsequent small allocation must not hand back the external block.
+    sp<ABuffer> pooled = new ABuffer(32);
+    EXPECT_NE(external, pooled->base());
+}
+
+}  // namespace android
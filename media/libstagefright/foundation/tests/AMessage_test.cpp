@@ -17,10 +17,13 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "AData_test"
 
+#include <string>
+
 #include <gtest/gtest.h>
 #include <utils/RefBase.h>
 
 #include <media/stagefright/foundation/AMessage.h>
+#include <media/stagefright/foundation/AString.h>
 
 using namespace android;
 
@@ -123,3 +126,41 @@ TEST(AMessage_tests, item_manipulation) {
 
 }
 
+TEST(AMessage_tests, name_storage) {
+  // names on both sides of the inline storage boundary survive vector growth,
+  // dup() and entry renaming.
+  const std::string shortName = "short";
+  const std::string longName(48, 'x');
+
+  sp<AMessage> m1 = new AMessage();
+  m1->setInt32(shortName.c_str(), 7);
+  m1->setInt64(longName.c_str(), INT64_MAX);
+  for (int i = 0; i < 40; ++i) {  // force mItems reallocation
+    m1->setInt32(AStringPrintf("filler-%d", i).c_str(), i);
+  }
+
+  int32_t i32;
+  int64_t i64;
+  EXPECT_TRUE(m1->findInt32(shortName.c_str(), &i32));
+  EXPECT_EQ(7, i32);
+  EXPECT_TRUE(m1->findInt64(longName.c_str(), &i64));
+  EXPECT_EQ(INT64_MAX, i64);
+
+  sp<AMessage> m2 = m1->dup();
+  m1.clear();
+  EXPECT_TRUE(m2->findInt32(shortName.c_str(), &i32));
+  EXPECT_EQ(7, i32);
+  EXPECT_TRUE(m2->findInt64(longName.c_str(), &i64));
+  EXPECT_EQ(INT64_MAX, i64);
+
+  // rename across the inline/heap boundary in both directions.
+  const std::string longName2(40, 'y');
+  EXPECT_EQ(OK, m2->setEntryNameAt(m2->findEntryByName(shortName.c_str()), longName2.c_str()));
+  EXPECT_EQ(OK, m2->setEntryNameAt(m2->findEntryByName(longName2.c_str()), "renamed"));
+  EXPECT_TRUE(m2->findInt32("renamed", &i32));
+  EXPECT_EQ(7, i32);
+
+  EXPECT_EQ(OK, m2->removeEntryByName("renamed"));
+  EXPECT_FALSE(m2->findInt32("renamed", &i32));
+}
+
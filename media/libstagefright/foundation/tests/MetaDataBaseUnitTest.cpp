@@ -285,4 +285,36 @@ TEST_F(MetaDataBaseUnitTest, ConvertToStringTest) {
     delete (metaData);
 }
 
+TEST_F(MetaDataBaseUnitTest, StorageBoundaryTest) {
+    MetaDataBase *metaData = new MetaDataBase();
+    ASSERT_NE(metaData, nullptr) << "Failed to create meta data";
+
+    // Strings on both sides of the inline reservoir boundary, including
+    // overwriting an inline value with an allocated one and back again.
+    const char *shortString = "0123456789abcde";                 // 16 bytes with terminator
+    const char *longString = "0123456789abcdef0123456789abcdef"; // 33 bytes with terminator
+
+    bool status = metaData->setCString(kKeyMIMEType, shortString);
+    ASSERT_FALSE(status) << "Initializing kKeyMIMEType, overwrite is expected to be false";
+
+    const char *value;
+    status = metaData->findCString(kKeyMIMEType, &value);
+    ASSERT_TRUE(status) << "kKeyMIMEType key does not exists in metadata";
+    ASSERT_STREQ(value, shortString) << "Incorrect short string returned";
+
+    status = metaData->setCString(kKeyMIMEType, longString);
+    ASSERT_TRUE(status) << "Overwriting kKeyMIMEType, overwrite is expected to be true";
+    status = metaData->findCString(kKeyMIMEType, &value);
+    ASSERT_TRUE(status) << "kKeyMIMEType key does not exists in metadata";
+    ASSERT_STREQ(value, longString) << "Incorrect long string returned";
+
+    status = metaData->setCString(kKeyMIMEType, shortString);
+    ASSERT_TRUE(status) << "Overwriting kKeyMIMEType, overwrite is expected to be true";
+    status = metaData->findCString(kKeyMIMEType, &value);
+    ASSERT_TRUE(status) << "kKeyMIMEType key does not exists in metadata";
+    ASSERT_STREQ(value, shortString) << "Incorrect short string returned";
+
+    delete (metaData);
+}
+
 }  // namespace android
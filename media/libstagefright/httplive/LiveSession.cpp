@@ -65,7 +65,7 @@ struct LiveSession::BandwidthEstimator : public RefBase {
 
 private:
     // Bandwidth estimation parameters
-    static const int32_t kShortTermBandwidthItems = 3;
+    static const int64_t kEwmaTimeConstantUs = 3000000LL; // 3 sec
     static const int32_t kMinBandwidthHistoryItems = 20;
     static const int64_t kMinBandwidthHistoryWindowUs = 5000000LL; // 5 sec
     static const int64_t kMaxBandwidthHistoryWindowUs = 30000000LL; // 30 sec
@@ -85,6 +85,7 @@ private:
     bool mIsStable;
     int64_t mTotalTransferTimeUs;
     size_t mTotalTransferBytes;
+    double mEwmaBps;
 
     DISALLOW_EVIL_CONSTRUCTORS(BandwidthEstimator);
 };
@@ -94,7 +95,8 @@ LiveSession::BandwidthEstimator::BandwidthEstimator() :
     mHasNewSample(false),
     mIsStable(true),
     mTotalTransferTimeUs(0),
-    mTotalTransferBytes(0) {
+    mTotalTransferBytes(0),
+    mEwmaBps(0.0) {
 }
 
 void LiveSession::BandwidthEstimator::addBandwidthMeasurement(
@@ -111,6 +113,21 @@ void LiveSession::BandwidthEstimator::addBandwidthMeasurement(
     mBandwidthHistory.push_back(entry);
     mHasNewSample = true;
 
+    if (delayUs > 0) {
+        // Time-weighted EWMA over per-chunk throughput: a chunk only moves
+        // the estimate in proportion to how long it took, so the many small
+        // chunks of a fast link and the few big stalls of a congested one
+        // get a fair say. This reacts within a segment, unlike the windowed
+        // average below.
+        double sampleBps = (double)numBytes * 8E6 / delayUs;
+        double alpha = (double)delayUs / (double)(delayUs + kEwmaTimeConstantUs);
+        if (mEwmaBps <= 0.0) {
+            mEwmaBps = sampleBps;
+        } else {
+            mEwmaBps += alpha * (sampleBps - mEwmaBps);
+        }
+    }
+
     // Remove no more than 10% of total transfer time at a time
     // to avoid sudden jump on bandwidth estimation. There might
     // be long blocking reads that takes up signification time,
@@ -156,24 +173,23 @@ bool LiveSession::BandwidthEstimator::estimateBandwidth(
         return true;
     }
 
-    *bandwidthBps = ((double)mTotalTransferBytes * 8E6 / mTotalTransferTimeUs);
+    // Fuse the two estimators: the windowed bytes/time ratio is a
+    // time-weighted (harmonic-style) mean that is robust but reacts at
+    // segment granularity, while the EWMA tracks sub-segment throughput
+    // changes. Report the smaller of the two so a dropping link is seen
+    // quickly but a single fast burst cannot trigger an up-switch.
+    int32_t longTermBps = ((double)mTotalTransferBytes * 8E6 / mTotalTransferTimeUs);
+    *bandwidthBps = longTermBps;
+    if (mEwmaBps > 0.0 && (int32_t)mEwmaBps < longTermBps) {
+        *bandwidthBps = (int32_t)mEwmaBps;
+    }
     mPrevEstimates.push_back(*bandwidthBps);
     while (mPrevEstimates.size() > 3) {
         mPrevEstimates.erase(mPrevEstimates.begin());
     }
     mHasNewSample = false;
 
-    int64_t totalTimeUs = 0;
-    size_t totalBytes = 0;
-    if (mBandwidthHistory.size() >= kShortTermBandwidthItems) {
-        List<BandwidthEntry>::iterator it = --mBandwidthHistory.end();
-        for (size_t i = 0; i < kShortTermBandwidthItems; i++, it--) {
-            totalTimeUs += it->mDelayUs;
-            totalBytes += it->mNumBytes;
-        }
-    }
-    mShortTermEstimate = totalTimeUs > 0 ?
-            (totalBytes * 8E6 / totalTimeUs) : *bandwidthBps;
+    mShortTermEstimate = mEwmaBps > 0.0 ? (int32_t)mEwmaBps : *bandwidthBps;
     if (shortTermBps) {
         *shortTermBps = mShortTermEstimate;
     }
@@ -177,6 +177,8 @@ PlaylistFetcher::PlaylistFetcher(
       mSampleAesKeyItemChanged(false),
       mThresholdRatio(-1.0f),
       mDownloadState(new DownloadState()),
+      mPrefetchedSeqNumber(-1),
+      mPrefetchedOffset(0),
       mHasMetadata(false) {
     memset(mPlaylistHash, 0, sizeof(mPlaylistHash));
     mHTTPDownloader = mSession->getHTTPDownloader();
@@ -696,6 +698,20 @@ void PlaylistFetcher::onMessageReceived(const sp<AMessage> &msg) {
             break;
         }
 
+        case kWhatPrefetch:
+        {
+            int32_t generation;
+            CHECK(msg->findInt32("generation", &generation));
+
+            if (generation != mMonitorQueueGeneration) {
+                // Stale event
+                break;
+            }
+
+            onPrefetchSegment();
+            break;
+        }
+
         default:
             TRESPASS();
     }
@@ -779,6 +795,7 @@ status_t PlaylistFetcher::onStart(const sp<AMessage> &msg) {
         mSeqNumber = -1;
         mTimeChangeSignaled = false;
         mDownloadState->resetState();
+        clearPrefetchedSegment();
     }
 
     postMonitorQueue();
@@ -806,6 +823,7 @@ void PlaylistFetcher::onStop(const sp<AMessage> &msg) {
     }
 
     mDownloadState->resetState();
+    clearPrefetchedSegment();
     mPacketSources.clear();
     mStreamTypeMask = 0;
 
@@ -930,7 +948,135 @@ void PlaylistFetcher::onMonitorQueue() {
                 (long long)kMinBufferedDurationUs);
 
         postMonitorQueue(delayUs);
+
+        // The connection would otherwise sit idle while we're paused; use
+        // it to pull the next segment into the lookahead cache.
+        schedulePrefetch();
+    }
+}
+
+void PlaylistFetcher::schedulePrefetch() {
+    if (mStreamTypeMask == LiveSession::STREAMTYPE_SUBTITLES) {
+        // subtitle segments are tiny; not worth prefetching
+        return;
     }
+    if (mPrefetchedBuffer != NULL && mPrefetchedSeqNumber == mSeqNumber) {
+        // already have the next segment
+        return;
+    }
+    if (mPlaylist == NULL || mDownloadState->hasSavedState()) {
+        // mid-segment pause: the next download resumes from saved state
+        return;
+    }
+
+    sp<AMessage> msg = new AMessage(kWhatPrefetch, this);
+    msg->setInt32("generation", mMonitorQueueGeneration);
+    msg->post();
+}
+
+void PlaylistFetcher::onPrefetchSegment() {
+    if (mPlaylist == NULL
+            || mDownloadState->hasSavedState()
+            || (mPrefetchedBuffer != NULL && mPrefetchedSeqNumber == mSeqNumber)) {
+        return;
+    }
+
+    int32_t firstSeqNumberInPlaylist, lastSeqNumberInPlaylist;
+    mPlaylist->getSeqNumberRange(
+            &firstSeqNumberInPlaylist, &lastSeqNumberInPlaylist);
+
+    if (mSeqNumber < firstSeqNumberInPlaylist
+            || mSeqNumber > lastSeqNumberInPlaylist) {
+        // the next download will refresh the playlist first
+        return;
+    }
+
+    AString uri;
+    sp<AMessage> itemMeta;
+    if (!mPlaylist->itemAt(
+                mSeqNumber - firstSeqNumberInPlaylist, &uri, &itemMeta)) {
+        return;
+    }
+
+    int64_t range_offset, range_length;
+    if (!itemMeta->findInt64("range-offset", &range_offset)
+            || !itemMeta->findInt64("range-length", &range_length)) {
+        range_offset = 0;
+        range_length = -1;
+    }
+
+    FLOGV("prefetching segment %d: '%s'", mSeqNumber, uriDebugString(uri).c_str());
+
+    sp<ABuffer> buffer;
+    int64_t startUs = ALooper::GetNowUs();
+    ssize_t bytesRead = mHTTPDownloader->fetchBlock(
+            uri.c_str(), &buffer, range_offset, range_length,
+            0 /* block_size: whole segment */,
+            NULL /* actualURL */, true /* reconnect */);
+    int64_t delayUs = ALooper::GetNowUs() - startUs;
+
+    if (bytesRead < 0) {
+        // Prefetch is best effort; the regular download will retry and
+        // surface any persistent error.
+        FLOGV("segment prefetch failed w/ error %zd", bytesRead);
+        return;
+    }
+
+    // the prefetch is a real full-rate transfer, so let the bandwidth
+    // estimator see it
+    if (!mStartup && mStopParams == NULL && bytesRead > 0
+            && (mStreamTypeMask
+                    & (LiveSession::STREAMTYPE_AUDIO
+                    | LiveSession::STREAMTYPE_VIDEO))) {
+        mSession->addBandwidthMeasurement(bytesRead, delayUs);
+    }
+
+    mPrefetchedBuffer = buffer;
+    mPrefetchedSeqNumber = mSeqNumber;
+    mPrefetchedUri = uri;
+    mPrefetchedOffset = 0;
+}
+
+bool PlaylistFetcher::hasPrefetchedSegment(const AString &uri) const {
+    return mPrefetchedBuffer != NULL
+            && mPrefetchedSeqNumber == mSeqNumber
+            && mPrefetchedUri == uri;
+}
+
+ssize_t PlaylistFetcher::readPrefetchedBlock(sp<ABuffer> *out) {
+    size_t avail = mPrefetchedBuffer->size() - mPrefetchedOffset;
+    if (avail == 0) {
+        clearPrefetchedSegment();
+        return 0;
+    }
+    size_t copy =
+            avail < (size_t)kDownloadBlockSize ? avail : (size_t)kDownloadBlockSize;
+
+    sp<ABuffer> buffer = *out != NULL ? *out : new ABuffer(mPrefetchedBuffer->size());
+    if (*out == NULL) {
+        buffer->setRange(0, 0);
+    }
+    if (buffer->capacity() - buffer->size() < copy) {
+        sp<ABuffer> grown = new ABuffer(
+                buffer->size() + mPrefetchedBuffer->size() - mPrefetchedOffset);
+        memcpy(grown->data(), buffer->data(), buffer->size());
+        grown->setRange(0, buffer->size());
+        buffer = grown;
+    }
+    memcpy(buffer->data() + buffer->size(),
+            mPrefetchedBuffer->data() + mPrefetchedOffset, copy);
+    buffer->setRange(0, buffer->size() + copy);
+    mPrefetchedOffset += copy;
+
+    *out = buffer;
+    return copy;
+}
+
+void PlaylistFetcher::clearPrefetchedSegment() {
+    mPrefetchedBuffer.clear();
+    mPrefetchedSeqNumber = -1;
+    mPrefetchedUri.clear();
+    mPrefetchedOffset = 0;
 }
 
 status_t PlaylistFetcher::refreshPlaylist() {
@@ -1369,9 +1515,14 @@ void PlaylistFetcher::onDownloadNext() {
     ssize_t bytesRead;
     do {
         int64_t startUs = ALooper::GetNowUs();
-        bytesRead = mHTTPDownloader->fetchBlock(
-                uri.c_str(), &buffer, range_offset, range_length, kDownloadBlockSize,
-                NULL /* actualURL */, connectHTTP);
+        bool fromPrefetch = hasPrefetchedSegment(uri);
+        if (fromPrefetch) {
+            bytesRead = readPrefetchedBlock(&buffer);
+        } else {
+            bytesRead = mHTTPDownloader->fetchBlock(
+                    uri.c_str(), &buffer, range_offset, range_length, kDownloadBlockSize,
+                    NULL /* actualURL */, connectHTTP);
+        }
         int64_t delayUs = ALooper::GetNowUs() - startUs;
 
         if (bytesRead == ERROR_NOT_CONNECTED) {
@@ -1387,7 +1538,9 @@ void PlaylistFetcher::onDownloadNext() {
         // add sample for bandwidth estimation, excluding samples from subtitles (as
         // its too small), or during startup/resumeUntil (when we could have more than
         // one connection open which affects bandwidth)
-        if (!mStartup && mStopParams == NULL && bytesRead > 0
+        // (prefetched blocks come out of memory; their transfer was already
+        // measured when the prefetch downloaded them)
+        if (!fromPrefetch && !mStartup && mStopParams == NULL && bytesRead > 0
                 && (mStreamTypeMask
                         & (LiveSession::STREAMTYPE_AUDIO
                         | LiveSession::STREAMTYPE_VIDEO))) {
@@ -1741,17 +1894,12 @@ status_t PlaylistFetcher::extractAndQueueAccessUnitsFromTs(const sp<ABuffer> &bu
     }
 
     size_t offset = 0;
-    while (offset + 188 <= buffer->size()) {
-        status_t err = mTSParser->feedTSPacket(buffer->data() + offset, 188);
-
-        if (err != OK) {
-            return err;
-        }
-
-        offset += 188;
-    }
+    status_t feedErr = mTSParser->feedTSPackets(buffer->data(), buffer->size(), &offset);
     // setRange to indicate consumed bytes.
     buffer->setRange(buffer->offset() + offset, buffer->size() - offset);
+    if (feedErr != OK) {
+        return feedErr;
+    }
 
     if (mSegmentFirstPTS < 0LL) {
         // get the smallest first PTS from all streams present in this parser
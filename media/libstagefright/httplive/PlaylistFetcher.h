@@ -102,7 +102,8 @@ private:
         kWhatMonitorQueue   = 'moni',
         kWhatResumeUntil    = 'rsme',
         kWhatDownloadNext   = 'dlnx',
-        kWhatFetchPlaylist  = 'flst'
+        kWhatFetchPlaylist  = 'flst',
+        kWhatPrefetch       = 'pref'
     };
 
     struct DownloadState;
@@ -187,6 +188,15 @@ private:
 
     sp<DownloadState> mDownloadState;
 
+    // Lookahead segment prefetch: while the fetcher is paused on a full
+    // buffer, the next segment is downloaded into this single-slot cache
+    // over the existing connection, so resuming doesn't pay the
+    // segment-boundary RTT. Consumed block-wise by onDownloadNext().
+    sp<ABuffer> mPrefetchedBuffer;
+    int32_t mPrefetchedSeqNumber;
+    AString mPrefetchedUri;
+    size_t mPrefetchedOffset;
+
     bool mHasMetadata;
 
     // Set first to true if decrypting the first segment of a playlist segment. When
@@ -209,6 +219,13 @@ private:
     float getStoppingThreshold();
     bool shouldPauseDownload();
 
+    // segment lookahead prefetch, see mPrefetchedBuffer
+    void schedulePrefetch();
+    void onPrefetchSegment();
+    bool hasPrefetchedSegment(const AString &uri) const;
+    ssize_t readPrefetchedBlock(sp<ABuffer> *out);
+    void clearPrefetchedSegment();
+
     int64_t delayUsToRefreshPlaylist() const;
     status_t refreshPlaylist();
 
@@ -92,13 +92,14 @@ private:
 };
 
 
-ID3::ID3(DataSourceHelper *sourcehelper, bool ignoreV1, off64_t offset)
+ID3::ID3(DataSourceHelper *sourcehelper, bool ignoreV1, off64_t offset, bool skipImages)
     : mIsValid(false),
       mData(NULL),
       mSize(0),
       mFirstFrameOffset(0),
       mVersion(ID3_UNKNOWN),
-      mRawSize(0) {
+      mRawSize(0),
+      mSkipImages(skipImages) {
     DataSourceUnwrapper source(sourcehelper);
     mIsValid = parseV2(&source, offset);
 
@@ -113,7 +114,8 @@ ID3::ID3(const uint8_t *data, size_t size, bool ignoreV1)
       mSize(0),
       mFirstFrameOffset(0),
       mVersion(ID3_UNKNOWN),
-      mRawSize(0) {
+      mRawSize(0),
+      mSkipImages(false) {
     MemorySource *source = new (std::nothrow) MemorySource(data, size);
 
     if (source == NULL)
@@ -226,7 +228,20 @@ struct id3_header {
     mSize = size;
     mRawSize = mSize + sizeof(header);
 
-    if (source->readAt(offset + sizeof(header), mData, mSize) != (ssize_t)mSize) {
+    // A metadata-only caller has no use for the picture frames, which tend
+    // to dominate the tag, so walk the body frame by frame and seek past
+    // them instead of pulling the whole tag off the source. With global
+    // unsynchronization the stored frame sizes can't be used for seeking,
+    // so such tags (and any tag the walk can't follow) take the full read.
+    bool framesFiltered = false;
+    if (mSkipImages && !(header.flags & 0x80)) {
+        framesFiltered = copyFramesSkippingImages(
+                source, offset + sizeof(header), size, header.version_major,
+                header.flags);
+    }
+
+    if (!framesFiltered
+            && source->readAt(offset + sizeof(header), mData, mSize) != (ssize_t)mSize) {
         free(mData);
         mData = NULL;
 
@@ -250,9 +265,12 @@ struct id3_header {
         }
     }
 
-    // handle extended header, if present
-    mFirstFrameOffset = 0;
-    if (header.version_major == 3 && (header.flags & 0x40)) {
+    // handle extended header, if present. The filtered walk above has
+    // already consumed it and set mFirstFrameOffset.
+    if (!framesFiltered) {
+        mFirstFrameOffset = 0;
+    }
+    if (!framesFiltered && header.version_major == 3 && (header.flags & 0x40)) {
         // Version 2.3 has an optional extended header.
 
         if (mSize < 4) {
@@ -388,6 +406,114 @@ struct id3_header {
     return true;
 }
 
+// Reads the tag body one frame at a time, copying everything except the
+// payload of picture frames (APIC/PIC) into mData. The copied frames keep
+// the layout of a regular tag, so Iterator and the V2.4 unsynchronizer walk
+// the buffer unchanged; embedded album art routinely dwarfs the text frames,
+// so skipping it saves most of the tag's I/O and touched memory.
+// Returns false if the body can't be followed frame by frame (the caller
+// then falls back to reading the whole tag); mData must already hold room
+// for "size" bytes.
+bool ID3::copyFramesSkippingImages(
+        DataSourceBase *source, off64_t bodyOffset, size_t size,
+        uint8_t versionMajor, uint8_t flags) {
+    size_t readOffset = 0;
+    size_t writeOffset = 0;
+
+    mFirstFrameOffset = 0;
+    if (flags & 0x40) {
+        // Copy the extended header verbatim. It's never present here for
+        // v2.2, which rejects this flag bit up front.
+        uint8_t enc[4];
+        if (source->readAt(bodyOffset, enc, sizeof(enc)) != (ssize_t)sizeof(enc)) {
+            return false;
+        }
+
+        size_t extendedHeaderSize;
+        if (versionMajor == 3) {
+            // v2.3 does not have syncsafe integers
+            extendedHeaderSize = U32_AT(enc);
+            if (extendedHeaderSize > SIZE_MAX - 4) {
+                ALOGE("b/24623447, extendedHeaderSize is too large");
+                return false;
+            }
+            extendedHeaderSize += 4;
+        } else {
+            if (!ParseSyncsafeInteger(enc, &extendedHeaderSize)
+                    || extendedHeaderSize < 6) {
+                return false;
+            }
+        }
+
+        if (extendedHeaderSize > size) {
+            return false;
+        }
+
+        if (source->readAt(bodyOffset, mData, extendedHeaderSize)
+                != (ssize_t)extendedHeaderSize) {
+            return false;
+        }
+
+        readOffset = writeOffset = mFirstFrameOffset = extendedHeaderSize;
+    }
+
+    const size_t frameHeaderSize = (versionMajor == 2) ? 6 : 10;
+    const size_t idSize = (versionMajor == 2) ? 3 : 4;
+    while (size - readOffset >= frameHeaderSize) {
+        uint8_t frameHeader[10];
+        if (source->readAt(bodyOffset + readOffset, frameHeader, frameHeaderSize)
+                != (ssize_t)frameHeaderSize) {
+            return false;
+        }
+
+        if (!memcmp(frameHeader, "\0\0\0\0", idSize)) {
+            // Reached the padding.
+            break;
+        }
+
+        size_t dataSize;
+        if (versionMajor == 2) {
+            dataSize = (frameHeader[3] << 16) | (frameHeader[4] << 8) | frameHeader[5];
+        } else if (versionMajor == 4) {
+            // Strictly syncsafe; a tag with iTunes-style plain sizes makes
+            // this walk bail out to the full read, whose unsynchronizer
+            // knows how to retry with that interpretation.
+            if (!ParseSyncsafeInteger(&frameHeader[4], &dataSize)) {
+                return false;
+            }
+        } else {
+            dataSize = U32_AT(&frameHeader[4]);
+        }
+
+        if (dataSize > size - readOffset - frameHeaderSize) {
+            return false;
+        }
+
+        if (!memcmp(frameHeader, (versionMajor == 2) ? "PIC" : "APIC", idSize)) {
+            // Seek past the picture payload without reading it.
+            readOffset += frameHeaderSize + dataSize;
+            continue;
+        }
+
+        memcpy(&mData[writeOffset], frameHeader, frameHeaderSize);
+        if (source->readAt(
+                    bodyOffset + readOffset + frameHeaderSize,
+                    &mData[writeOffset + frameHeaderSize], dataSize)
+                != (ssize_t)dataSize) {
+            return false;
+        }
+
+        readOffset += frameHeaderSize + dataSize;
+        writeOffset += frameHeaderSize + dataSize;
+    }
+
+    // The zeroed tail doubles as padding, so frame walks terminate there.
+    memset(&mData[writeOffset], 0, size - writeOffset);
+    mSize = writeOffset;
+
+    return true;
+}
+
 void ID3::removeUnsynchronization() {
 
     // This file has "unsynchronization", so we have to replace occurrences
@@ -39,6 +39,7 @@ class ID3versionTest : public ::testing::TestWithParam<pair<string, int>> {};
 class ID3textTagTest : public ::testing::TestWithParam<pair<string, int>> {};
 class ID3albumArtTest : public ::testing::TestWithParam<pair<string, bool>> {};
 class ID3multiAlbumArtTest : public ::testing::TestWithParam<pair<string, int>> {};
+class ID3skipImagesTest : public ::testing::TestWithParam<pair<string, int>> {};
 
 TEST_P(ID3tagTest, TagTest) {
     string path = gEnv->getRes() + GetParam();
@@ -181,6 +182,43 @@ TEST_P(ID3multiAlbumArtTest, MultiAlbumArtTest) {
                                   << " album arts! \n";
 }
 
+TEST_P(ID3skipImagesTest, SkipImagesTest) {
+    int numTextFrames = GetParam().second;
+    string path = gEnv->getRes() + GetParam().first;
+    ALOGV(" =====   SkipImagesTest for %s", path.c_str());
+    sp<android::FileSource> file = new FileSource(path.c_str());
+    ASSERT_EQ(file->initCheck(), (status_t)OK) << "File initialization failed! \n";
+
+    DataSourceHelper helper(file->wrap());
+    ID3 tag(&helper, false /* ignoreV1 */, 0 /* offset */, true /* skipImages */);
+    ASSERT_TRUE(tag.isValid()) << "No valid ID3 tag found for " << path.c_str() << "\n";
+
+    // The text frames must survive the filtered read unchanged.
+    int countTextFrames = 0;
+    ID3::Iterator it(tag, nullptr);
+    while (!it.done()) {
+        String8 id;
+        it.getID(&id);
+        ASSERT_GT(id.length(), 0) << "Found an ID3 tag of 0 size";
+        ASSERT_NE(String8(id), "APIC") << "Found a picture frame with skipImages set!";
+        ASSERT_NE(String8(id), "PIC") << "Found a picture frame with skipImages set!";
+        if (id[0] == 'T') {
+            String8 text;
+            countTextFrames++;
+            it.getString(&text);
+            ALOGV("Found text frame %s : %s \n", id.string(), text.string());
+        }
+        it.next();
+    }
+    ASSERT_EQ(countTextFrames, numTextFrames)
+            << "Expected " << numTextFrames << " text frames, found " << countTextFrames;
+
+    size_t dataSize;
+    String8 mime;
+    ASSERT_EQ(tag.getAlbumArt(&dataSize, &mime), nullptr)
+            << "Found album art with skipImages set!";
+}
+
 // we have a test asset with large album art -- which is larger than our 3M cap
 // that we inserted intentionally in the ID3 parsing routine.
 // Rather than have it fail all the time, we have wrapped it under an #ifdef
@@ -266,6 +304,16 @@ INSTANTIATE_TEST_SUITE_P(id3TestAll, ID3multiAlbumArtTest,
                                            make_pair("bbb_2sec_2_image.mp3", 2)
                                            ));
 
+INSTANTIATE_TEST_SUITE_P(id3TestAll, ID3skipImagesTest,
+                         ::testing::Values(make_pair("bbb_1sec_v23.mp3", 1),
+                                           make_pair("bbb_1sec_1_image.mp3", 1),
+                                           make_pair("bbb_1sec_2_image.mp3", 1),
+                                           make_pair("bbb_2sec_v24.mp3", 1),
+                                           make_pair("bbb_2sec_1_image.mp3", 1),
+                                           make_pair("bbb_2sec_2_image.mp3", 1),
+                                           make_pair("bbb_1sec_v23_3tags.mp3", 3)
+                                           ));
+
 int main(int argc, char **argv) {
     gEnv = new ID3TestEnvironment();
     ::testing::AddGlobalTestEnvironment(gEnv);
@@ -140,6 +140,11 @@ private:
     sp<MemoryDealer> mDealer;
     sp<IMemory> mDecryptDestination;
     int32_t mHeapSeqNum;
+    // When true, non-secure decrypt writes back into the per-buffer shared source
+    // memory (like the descrambler path always does) instead of bouncing through
+    // mDecryptDestination. Initialized from "media.acodec.inplace_decrypt"; opt-in
+    // since not every CryptoPlugin supports overlapping source and destination.
+    const bool mInPlaceDecrypt;
     std::map<wp<HidlMemory>, int32_t> mHeapSeqNumMap;
     sp<HidlMemory> mHidlMemory;
 
@@ -61,6 +61,8 @@ private:
     sp<IGraphicBufferConsumer> mConsumer;
     sp<Surface> mSurface;
     std::map<int32_t, sp<GraphicBuffer> > mSlotToBufferMap;
+    // output buffer reused across captures while the size and format match
+    sp<GraphicBuffer> mCaptureBuffer;
 
     Mutex mLock;
     Condition mCondition;
@@ -49,6 +49,13 @@ struct FrameDecoder : public RefBase {
 
     sp<IMemory> extractFrame(FrameRect *rect = NULL);
 
+    // Extract several frames in one pass, reusing the configured decoder
+    // instance across seeks instead of paying codec create/configure/start
+    // per frame.  init() must have been called with the first entry of
+    // timesUs.  Entries that fail decode produce NULL in *frames.
+    status_t extractFrames(
+            const std::vector<int64_t> &timesUs, std::vector<sp<IMemory>> *frames);
+
     static sp<IMemory> getMetadataOnly(
             const sp<MetaData> &trackMeta, int colorFormat,
             bool thumbnail = false, uint32_t bitDepth = 0);
@@ -64,6 +71,14 @@ protected:
 
     virtual status_t onExtractRect(FrameRect *rect) = 0;
 
+    // Re-arm the read options (and any per-extraction output state) for a
+    // subsequent seek when the decoder is reused by extractFrames().
+    virtual status_t onSeekTo(
+            int64_t frameTimeUs __unused,
+            MediaSource::ReadOptions *options __unused) {
+        return ERROR_UNSUPPORTED;
+    }
+
     virtual status_t onInputReceived(
             const sp<MediaCodecBuffer> &codecBuffer,
             MetaDataBase &sampleMeta,
@@ -121,6 +136,9 @@ protected:
         return (rect == NULL) ? OK : ERROR_UNSUPPORTED;
     }
 
+    virtual status_t onSeekTo(
+            int64_t frameTimeUs, MediaSource::ReadOptions *options) override;
+
     virtual status_t onInputReceived(
             const sp<MediaCodecBuffer> &codecBuffer,
             MetaDataBase &sampleMeta,
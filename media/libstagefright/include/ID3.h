@@ -36,7 +36,11 @@ struct ID3 {
         ID3_V2_4,
     };
 
-    explicit ID3(DataSourceHelper *source, bool ignoreV1 = false, off64_t offset = 0);
+    // With "skipImages" set, picture frames (APIC/PIC) are dropped while the
+    // tag is read, so metadata-only callers never load embedded album art off
+    // the source; getAlbumArt() then reports none.
+    explicit ID3(DataSourceHelper *source, bool ignoreV1 = false, off64_t offset = 0,
+            bool skipImages = false);
     ID3(const uint8_t *data, size_t size, bool ignoreV1 = false);
     ~ID3();
 
@@ -88,8 +92,13 @@ private:
     // only valid for IDV2+
     size_t mRawSize;
 
+    bool mSkipImages;
+
     bool parseV1(DataSourceBase *source);
     bool parseV2(DataSourceBase *source, off64_t offset);
+    bool copyFramesSkippingImages(
+            DataSourceBase *source, off64_t bodyOffset, size_t size,
+            uint8_t versionMajor, uint8_t flags);
     void removeUnsynchronization();
     bool removeUnsynchronizationV2_4(bool iTunesHack, bool hasGlobalUnsync);
 
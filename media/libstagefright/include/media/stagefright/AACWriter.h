@@ -18,6 +18,7 @@
 #define AAC_WRITER_H_
 
 #include "media/stagefright/foundation/ABase.h"
+#include <media/stagefright/BufferedWriteSink.h>
 #include <media/stagefright/MediaWriter.h>
 #include <utils/threads.h>
 
@@ -46,6 +47,7 @@ private:
     };
 
     int   mFd;
+    BufferedWriteSink mSink;
     status_t mInitCheck;
     sp<MediaSource> mSource;
     bool mStarted;
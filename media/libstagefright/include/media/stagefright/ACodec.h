@@ -18,6 +18,7 @@
 #define A_CODEC_H_
 
 #include <stdint.h>
+#include <vector>
 #include <android/native_window.h>
 #include <media/hardware/MetadataBufferType.h>
 #include <media/MediaCodecInfo.h>
@@ -266,6 +267,20 @@ private:
 
     FrameRenderTracker mRenderTracker; // render information for buffers rendered by ACodec
     Vector<BufferInfo> mBuffers[2];
+
+    // Shared-memory backings of non-secure output buffers, retained across
+    // output port reconfigurations. Allocating and mapping ashmem for a whole
+    // buffer set is a large part of the cost of a mid-stream resolution
+    // switch, and adaptive streams switch within a small resolution ladder,
+    // so freed backings are handed out again whenever the new buffer size
+    // fits. Cleared when the output port is torn down for good.
+    struct RecycledOutputMemory {
+        hardware::hidl_memory mToken;
+        sp<TMemory> mMemory;
+        bool mInUse;
+    };
+    std::vector<RecycledOutputMemory> mRecycledOutputMemory;
+
     bool mPortEOS[2];
     status_t mInputEOSResult;
 
@@ -328,6 +343,17 @@ private:
     status_t freeBuffersOnPort(OMX_U32 portIndex);
     status_t freeBuffer(OMX_U32 portIndex, size_t i);
 
+    // Hands out a retained output-buffer backing of at least |size| bytes, if
+    // one is available; returns false when the caller needs to allocate.
+    bool reuseRecycledOutputMemory(
+            size_t size, hardware::hidl_memory *token, sp<TMemory> *mem);
+    // Remembers a freshly allocated output-buffer backing for reuse after a
+    // future port reconfiguration.
+    void stashRecycledOutputMemory(
+            const hardware::hidl_memory &token, const sp<TMemory> &mem);
+    // Marks the backing of a freed output buffer as available again.
+    void releaseRecycledOutputMemory(const sp<RefBase> &memRef);
+
     status_t handleSetSurface(const sp<Surface> &surface);
     status_t setPortMode(int32_t portIndex, IOMX::PortMode mode);
     status_t setupNativeWindowSizeFormatAndUsage(
@@ -22,11 +22,17 @@
 
 namespace android {
 
+struct AString;
+
 struct AState : public RefBase {
-    AState(const sp<AState> &parentState = NULL);
+    AState(const sp<AState> &parentState = NULL, const char *name = "AState");
 
     sp<AState> parentState();
 
+    // Name used in trace events and state machine dumps; expected to be a
+    // string literal.
+    const char *stateName() const;
+
 protected:
     virtual ~AState();
 
@@ -39,6 +45,7 @@ private:
     friend struct AHierarchicalStateMachine;
 
     sp<AState> mParentState;
+    const char *mName;
 
     DISALLOW_EVIL_CONSTRUCTORS(AState);
 };
@@ -54,9 +61,31 @@ protected:
     // Only to be called in response to a message.
     void changeState(const sp<AState> &state);
 
+    // Appends the current state, message dispatch statistics and a table of
+    // recent state transitions to |out|, for inclusion in a subclass's
+    // dumpsys output. Only to be called from the handler's thread.
+    void dumpStateMachine(AString *out) const;
+
 private:
     sp<AState> mState;
 
+    // Lightweight always-on instrumentation, reported by dumpStateMachine()
+    // and mirrored as atrace events while tracing is enabled. All fields are
+    // only touched from the handler's thread.
+    struct TransitionRecord {
+        int64_t mWhenUs;
+        int64_t mTimeInFromStateUs;
+        const char *mFrom;
+        const char *mTo;
+    };
+    enum { kTransitionHistorySize = 16 };
+    TransitionRecord mTransitionHistory[kTransitionHistorySize];
+    size_t mTransitionCount = 0;
+    int64_t mLastTransitionUs = -1;
+    int64_t mMessageCount = 0;
+    int64_t mMaxDispatchUs = 0;
+    const char *mMaxDispatchState = "(none)";
+
     DISALLOW_EVIL_CONSTRUCTORS(AHierarchicalStateMachine);
 };
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BUFFERED_WRITE_SINK_H_
+
+#define BUFFERED_WRITE_SINK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <media/stagefright/foundation/ABase.h>
+#include <utils/Errors.h>
+
+namespace android {
+
+// Aggregates small writes into larger ones for the simple single-track
+// writers (AMR, AAC/ADTS, Ogg). Speech recording emits a frame every 20 ms,
+// and a write syscall per frame keeps storage awake for no benefit; this
+// sink batches frames until the buffer fills or the oldest buffered byte
+// exceeds the hold window, then writes them out in one call.
+//
+// The sink borrows the file descriptor; the owning writer must call flush()
+// before closing it. Not thread safe: meant to be used from a single writer
+// thread, like the writers themselves.
+struct BufferedWriteSink {
+    explicit BufferedWriteSink(
+            int fd,
+            size_t capacity = kDefaultCapacity,
+            int64_t maxHoldUs = kDefaultMaxHoldUs);
+    ~BufferedWriteSink();
+
+    // When enabled, fdatasync() after each flush so buffered data does not
+    // linger dirty in the page cache. Off by default.
+    void setSyncOnFlush(bool syncOnFlush);
+
+    // Same contract as ::write(): returns size on success, -1 with errno set
+    // on failure. Data larger than the buffer capacity bypasses the buffer.
+    ssize_t write(const void *data, size_t size);
+
+    // Writes out any buffered data. Returns OK or ERROR_IO.
+    status_t flush();
+
+private:
+    enum {
+        // ~1 s of frames at typical speech bitrates.
+        kDefaultCapacity = 64 * 1024,
+    };
+    static const int64_t kDefaultMaxHoldUs = 1000000LL;
+
+    int mFd;
+    const size_t mCapacity;
+    const int64_t mMaxHoldUs;
+    bool mSyncOnFlush;
+    uint8_t *mBuffer;
+    size_t mUsed;
+    // When the oldest byte currently in the buffer arrived.
+    int64_t mOldestByteTimeUs;
+
+    ssize_t writeFully(const void *data, size_t size);
+
+    DISALLOW_EVIL_CONSTRUCTORS(BufferedWriteSink);
+};
+
+}  // namespace android
+
+#endif  // BUFFERED_WRITE_SINK_H_
@@ -230,6 +230,12 @@ private:
     // A mapping from ANativeWindowBuffer sent to encoder to BufferItem received from camera.
     // This is protected by mLock.
     KeyedVector<ANativeWindowBuffer*, BufferItem> mReceivedBufferItemMap;
+    // MediaBuffers wrapping the payload pointers of the mMemoryBases slots.
+    // The slot pointers are stable, so each buffer is created on the slot's
+    // first use and then reused for every frame handed to the encoder,
+    // keeping the steady-state read path free of allocations.
+    // This is protected by mLock.
+    KeyedVector<void*, MediaBuffer*> mMediaBufferPool;
     sp<BufferQueueListener> mBufferQueueListener;
 
     Mutex mBatchLock; // protecting access to mInflightXXXXX members below
@@ -242,6 +248,8 @@ private:
     void releaseQueuedFrames();
     void releaseOneRecordingFrame(const sp<IMemory>& frame);
     void createVideoBufferMemoryHeap(size_t size, uint32_t bufferCount);
+    MediaBuffer *acquireMediaBufferLocked(const sp<IMemory>& frame);
+    void freeMediaBufferPool();
 
     status_t init(const sp<hardware::ICamera>& camera, const sp<ICameraRecordingProxy>& proxy,
                   int32_t cameraId, const String16& clientName, uid_t clientUid, pid_t clientPid,
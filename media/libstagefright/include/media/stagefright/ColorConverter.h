@@ -92,6 +92,10 @@ private:
     // returns the YUV2RGB matrix coefficients according to the color aspects and bit depth
     const struct Coeffs *getMatrix() const;
 
+    // Dispatches one (possibly row-tiled) region to the per-format kernel.
+    status_t convertInternal(
+            const BitmapParams &src, const BitmapParams &dst);
+
     status_t convertCbYCrY(
             const BitmapParams &src, const BitmapParams &dst);
 
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAGMENTED_MP4_WRITER_H_
+
+#define FRAGMENTED_MP4_WRITER_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include <vector>
+
+#include <media/stagefright/MediaWriter.h>
+#include <utils/Mutex.h>
+
+namespace android {
+
+class MetaData;
+
+// Writes CMAF-style fragmented MP4: an init segment (ftyp + moov with empty
+// sample tables and an mvex) up front, then self-contained moof/mdat
+// fragments emitted incrementally, so the output fd can be a socket or pipe
+// and memory use stays bounded by the fragment duration rather than the
+// session length. Each fragment carries samples of a single track; video
+// fragments start on a sync sample. Per-track sample and index buffers are
+// reused across fragments, so steady-state memory is constant.
+//
+// Supported tracks: one or more of AVC or HEVC video (Annex-B or
+// length-prefixed input) and AAC audio. Sample timestamps are used as decode
+// times; streams with B-frame reordering are not supported.
+struct FragmentedMP4Writer : public MediaWriter {
+    explicit FragmentedMP4Writer(int fd);
+
+    // MediaWriter
+    virtual status_t addSource(const sp<MediaSource> &source);
+    virtual bool reachedEOS();
+    virtual status_t start(MetaData *params = NULL);
+    virtual status_t stop();
+    virtual status_t pause();
+
+    // Target duration of each emitted fragment; must be called before
+    // start(). Defaults to 2 seconds.
+    void setFragmentDurationUs(int64_t durationUs);
+
+protected:
+    virtual ~FragmentedMP4Writer();
+
+private:
+    struct Track;
+
+    int mFd;
+    status_t mInitCheck;
+    bool mStarted;
+    int64_t mFragmentDurationUs;
+    uint32_t mNextSequenceNumber;
+    Mutex mWriteLock;  // serializes fragment writes between track threads
+    std::vector<Track *> mTracks;
+
+    static void *ThreadWrapper(void *me);
+    status_t threadFunc(Track *track);
+
+    status_t writeInitSegment();
+    status_t writeFragment(Track *track);
+    status_t writeAll(const uint8_t *data, size_t size);
+
+    DISALLOW_EVIL_CONSTRUCTORS(FragmentedMP4Writer);
+};
+
+}  // namespace android
+
+#endif  // FRAGMENTED_MP4_WRITER_H_
@@ -65,6 +65,7 @@ private:
     enum {
         kWhatCreate,
         kWhatCapture,
+        kWhatCleanup,
     };
 
     static Mutex sLock;
@@ -72,10 +73,15 @@ private:
 
     constexpr static float sDefaultMaxLumiance = 500.0f;
 
+    // how long captures must be idle before GL resources are released
+    constexpr static int64_t kCleanupDelayUs = 1000000;
+
     status_t mInitStatus;
     sp<ALooper> mLooper;
     std::unique_ptr<renderengine::RenderEngine> mRE;
     uint32_t mTextureName;
+    // bumped by every capture; stale cleanup messages are dropped
+    int32_t mCleanupGeneration;
 
     static status_t PostAndAwaitResponse(
             const sp<AMessage> &msg, sp<AMessage> *response);
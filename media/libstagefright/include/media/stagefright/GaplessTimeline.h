@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GAPLESS_TIMELINE_H_
+
+#define GAPLESS_TIMELINE_H_
+
+#include <media/stagefright/MediaErrors.h>
+#include <utils/Errors.h>
+
+namespace android {
+
+// Maps source timestamps onto a gapless output timeline across pause/resume
+// cycles, as used by the MediaWriter track threads. The accumulated pause
+// offset is extended once per resume and applied as a single subtraction per
+// sample, so resuming after an arbitrarily long pause is constant time.
+//
+// Not thread safe; meant to live on a single track thread.
+struct GaplessTimeline {
+    GaplessTimeline()
+        : mPausedDurationUs(0) {
+    }
+
+    // Sets the initial offset so the first written sample maps to time zero.
+    void setStartTimeUs(int64_t startTimeUs) {
+        mPausedDurationUs = startTimeUs;
+    }
+
+    // Closes the pause gap ending at |timestampUs|, the first source
+    // timestamp seen after resume. |trackDurationUs| is the duration of the
+    // media written so far and |lastSampleDurationUs| the duration of the
+    // sample preceding the gap; the gap is assumed to begin one sample
+    // duration after the last written sample. Returns ERROR_MALFORMED if the
+    // source timestamps went backwards across the pause.
+    status_t onResume(
+            int64_t timestampUs, int64_t trackDurationUs,
+            int64_t lastSampleDurationUs) {
+        int64_t durExcludingEarlierPausesUs = timestampUs - mPausedDurationUs;
+        if (durExcludingEarlierPausesUs < 0) {
+            return ERROR_MALFORMED;
+        }
+        int64_t pausedDurationUs = durExcludingEarlierPausesUs - trackDurationUs;
+        if (pausedDurationUs < lastSampleDurationUs) {
+            return ERROR_MALFORMED;
+        }
+        mPausedDurationUs += pausedDurationUs - lastSampleDurationUs;
+        return OK;
+    }
+
+    // Maps a source timestamp onto the gapless output timeline.
+    int64_t rebase(int64_t timestampUs) const {
+        return timestampUs - mPausedDurationUs;
+    }
+
+    // Total source time excised from the output timeline so far.
+    int64_t pausedDurationUs() const {
+        return mPausedDurationUs;
+    }
+
+private:
+    int64_t mPausedDurationUs;
+};
+
+}  // namespace android
+
+#endif  // GAPLESS_TIMELINE_H_
@@ -35,10 +35,20 @@ struct JPEGSource : public MediaSource {
     virtual status_t read(
             MediaBufferBase **buffer, const ReadOptions *options = NULL);
 
+    // Re-targets this source at another JPEG so batch workloads can reuse
+    // one source object (and its output buffer) across many files instead
+    // of constructing and tearing one down per file. Only valid while
+    // stopped.
+    status_t reset(const sp<DataSource> &source);
+
 protected:
     virtual ~JPEGSource();
 
 private:
+    enum {
+        kParseCacheSize = 1024,
+    };
+
     sp<DataSource> mSource;
     MediaBufferGroup *mGroup;
     bool mStarted;
@@ -46,7 +56,14 @@ private:
     int32_t mWidth, mHeight;
     off64_t mOffset;
 
+    // Block cache for header parsing; see readAtCached().
+    uint8_t mParseCache[kParseCacheSize];
+    off64_t mParseCacheOffset;
+    size_t mParseCacheLength;
+
     status_t parseJPEG();
+    bool readAtCached(off64_t offset, void *data, size_t size);
+    bool getUInt16Cached(off64_t offset, uint16_t *value);
 
     JPEGSource(const JPEGSource &);
     JPEGSource &operator=(const JPEGSource &);
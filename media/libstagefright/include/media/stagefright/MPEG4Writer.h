@@ -19,6 +19,7 @@
 #define MPEG4_WRITER_H_
 
 #include <stdio.h>
+#include <sys/uio.h>
 
 #include <media/stagefright/MediaWriter.h>
 #include <utils/List.h>
@@ -63,6 +64,8 @@ public:
     inline size_t write(const void *ptr, size_t size, size_t nmemb);
     // Write to file system by calling ::write() or post error message to looper on failure.
     void writeOrPostError(int fd, const void *buf, size_t count);
+    // Gathered variant of writeOrPostError; totalBytes must be the sum of the iov lengths.
+    void writevOrPostError(int fd, const struct iovec *iov, int iovcnt, size_t totalBytes);
     // Seek in the file by calling ::lseek64() or post error message to looper on failure.
     void seekOrPostError(int fd, off64_t offset, int whence);
     void endBox();
@@ -159,6 +162,7 @@ private:
     int64_t estimateMoovBoxSize(int32_t bitRate);
     int64_t estimateFileLevelMetaSize(MetaData *params);
     void writeCachedBoxToFile(const char *type);
+    void appendCachedBoxToFile(const char *type);
     void printWriteDurations();
 
     struct Chunk {
@@ -191,6 +195,9 @@ private:
     pthread_t       mThread;                // Thread id for the writer
     List<ChunkInfo> mChunkInfos;            // Chunk infos
     Condition       mChunkReadyCondition;   // Signal that chunks are available
+    Condition       mChunkFlushedCondition; // Signal that buffered chunks were written
+    size_t          mBufferedChunkSize;     // Total sample bytes of buffered chunks
+    size_t          mChunkBudgetBytes;      // In-memory budget for buffered chunks
 
     // HEIF writing
     typedef key_value_pair_t< const char *, Vector<uint16_t> > ItemRefs;
@@ -247,8 +254,13 @@ private:
     void stopAndReleaseLooper();
 
     // Buffer a single chunk to be written out later.
+    // May block the calling track thread if the buffered chunks exceed
+    // the in-memory chunk budget.
     void bufferChunk(const Chunk& chunk);
 
+    // Total bytes of sample data carried by the given chunk.
+    static size_t chunkDataSize(const Chunk& chunk);
+
     // Write all buffered chunks from all tracks
     void writeAllChunks();
 
@@ -294,6 +306,10 @@ private:
             uint32_t tiffHdrOffset, size_t *bytesWritten);
     void addLengthPrefixedSample_l(MediaBuffer *buffer);
     void addMultipleLengthPrefixedSamples_l(MediaBuffer *buffer);
+    // Emits length prefix plus payload for a batch of NAL spans with a single
+    // gathered write.
+    void writeLengthPrefixedNals_l(
+            const uint8_t *const *nalStarts, const size_t *nalSizes, size_t count);
     uint16_t addProperty_l(const ItemProperty &);
     status_t reserveItemId_l(size_t numItems, uint16_t *itemIdBase);
     uint16_t addItem_l(const ItemInfo &);
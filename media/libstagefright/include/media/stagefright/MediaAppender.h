@@ -55,6 +55,10 @@ public:
 
     sp<AMessage> getTrackFormat(size_t idx);
 
+    // Opaque snapshot of a parsed destination, kept by the tail-resume
+    // cache (see MediaAppender.cpp).
+    struct TailState;
+
 private:
     MediaAppender(int fd, AppendMode mode);
 
@@ -87,6 +91,12 @@ private:
     struct sampleDataInfo;
     std::vector<sampleDataInfo> mSDI;
 
+    // Tail-resume support: a later session on the same unmodified
+    // destination restores the cached TailState and skips the per-sample
+    // scan in init().
+    static sp<TailState> getTailState(int fd, AppendMode mode);
+    static void putTailState(int fd, AppendMode mode, const sp<TailState>& state);
+
     enum : int {
         UNINITIALIZED,
         INITIALIZED,
@@ -37,8 +37,13 @@ class MetaDataBase;
 
 class MediaBuffer : public MediaBufferBase {
 public:
-    // allocations larger than or equal to this will use shared memory.
-    static const size_t kSharedMemThreshold = 64 * 1024;
+    // Allocations larger than or equal to this will use shared memory (only
+    // in processes that opted in via useSharedMemory, i.e. the extractor
+    // service). Matches IMediaSource::kTransferInlineAsSharedThreshold, so
+    // any standalone buffer big enough to transfer as shared memory is
+    // already backed by it instead of being copied into a shared buffer at
+    // transfer time.
+    static const size_t kSharedMemThreshold = 8 * 1024;
 
     // The underlying data remains the responsibility of the caller!
     MediaBuffer(void *data, size_t size);
@@ -56,6 +56,16 @@ public:
 
     size_t buffers() const;
 
+    // Growth/trim policy: retain at most |retain| free buffers beyond the
+    // explicitly added base population; buffers grown dynamically inside
+    // acquire_buffer above that are released back to the system when a buffer
+    // is returned (i.e. after bursty use).  The default (SIZE_MAX) never
+    // trims, preserving historic behavior.
+    void setFreeBufferRetention(size_t retain);
+
+    // Applies the trim policy immediately, returns the number of buffers freed.
+    size_t trim();
+
     // If buffer is nullptr, have acquire_buffer() check for remote release.
     virtual void signalBufferReturned(MediaBufferBase *buffer);
 
@@ -18,6 +18,7 @@
 
 #define MEDIA_CLOCK_H_
 
+#include <atomic>
 #include <list>
 #include <media/stagefright/foundation/AHandler.h>
 #include <utils/Mutex.h>
@@ -52,11 +53,22 @@ struct MediaClock : public AHandler {
     float getPlaybackRate() const;
 
     // query media time corresponding to real time |realUs|, and save the
-    // result in |outMediaUs|.
+    // result in |outMediaUs|. Served from the seqlock-published timeline
+    // snapshot in the common case - a few loads, no lock and no looper
+    // hop - so readers (A/V sync, subtitles, app callbacks all sampling
+    // the clock per frame) never contend with timer processing under the
+    // clock lock. Falls back to the locked path if the snapshot is
+    // unavailable.
     status_t getMediaTime(
             int64_t realUs,
             int64_t *outMediaUs,
             bool allowPastMaxTime = false) const;
+    // Lock-free snapshot read behind getMediaTime(). Returns WOULD_BLOCK
+    // if concurrent timeline updates kept the snapshot unstable.
+    status_t getMediaTimeLockless(
+            int64_t realUs,
+            int64_t *outMediaUs,
+            bool allowPastMaxTime = false) const;
     // query real time corresponding to media time |targetMediaUs|.
     // The result is saved in |outRealUs|.
     status_t getRealTimeFor(int64_t targetMediaUs, int64_t *outRealUs) const;
@@ -99,6 +111,8 @@ private:
 
     void notifyDiscontinuity_l();
 
+    void publishTimeline_l();
+
     sp<ALooper> mLooper;
     mutable Mutex mLock;
 
@@ -113,6 +127,17 @@ private:
     std::list<Timer> mTimers;
     sp<AMessage> mNotify;
 
+    // Timeline snapshot published with a seqlock: written under mLock,
+    // readable without it.  The sequence is odd while an update is in
+    // flight; the fields are atomics only to make the racy reads defined,
+    // consistency comes from the sequence check.
+    std::atomic<uint32_t> mTimelineSeq{0};
+    std::atomic<int64_t> mSnapAnchorTimeMediaUs{-1};
+    std::atomic<int64_t> mSnapAnchorTimeRealUs{-1};
+    std::atomic<int64_t> mSnapMaxTimeMediaUs{INT64_MAX};
+    std::atomic<int64_t> mSnapStartingTimeMediaUs{-1};
+    std::atomic<float> mSnapPlaybackRate{1.0f};
+
     DISALLOW_EVIL_CONSTRUCTORS(MediaClock);
 };
 
@@ -174,6 +174,24 @@ struct MediaCodec : public AHandler {
             uint32_t flags,
             AString *errorDetailMsg = NULL);
 
+    // Describes one buffer for the batch queue/dequeue APIs below.
+    struct QueueBufferInfo {
+        size_t index;
+        size_t offset;
+        size_t size;
+        int64_t presentationTimeUs;
+        uint32_t flags;
+    };
+
+    // Batch variant of queueInputBuffer(): queues all entries with a single
+    // round trip to the looper, which matters for small-buffer audio codecs.
+    // Entries are queued in order; on error, *numQueued reports how many
+    // entries were queued successfully before the failure.
+    status_t queueInputBuffers(
+            const std::vector<QueueBufferInfo> &infos,
+            size_t *numQueued = NULL,
+            AString *errorDetailMsg = NULL);
+
     status_t queueSecureInputBuffer(
             size_t index,
             size_t offset,
@@ -229,6 +247,16 @@ struct MediaCodec : public AHandler {
             uint32_t *flags,
             int64_t timeoutUs = 0ll);
 
+    // Batch variant of dequeueOutputBuffer(): drains up to maxBuffers output
+    // buffers that are already available, with a single round trip to the
+    // looper. Does not wait; returns -EAGAIN if no buffer is available.
+    // INFO_FORMAT_CHANGED and INFO_OUTPUT_BUFFERS_CHANGED are reported as in
+    // dequeueOutputBuffer(); a format change encountered mid-batch ends the
+    // batch and is reported by the next dequeue call, preserving event order.
+    status_t dequeueOutputBuffers(
+            std::vector<QueueBufferInfo> *infos,
+            size_t maxBuffers);
+
     status_t renderOutputBufferAndRelease(size_t index, int64_t timestampNs);
     status_t renderOutputBufferAndRelease(size_t index);
     status_t releaseOutputBuffer(size_t index);
@@ -337,7 +365,9 @@ private:
         kWhatRelease                        = 'rele',
         kWhatDequeueInputBuffer             = 'deqI',
         kWhatQueueInputBuffer               = 'queI',
+        kWhatQueueInputBuffers              = 'queB',
         kWhatDequeueOutputBuffer            = 'deqO',
+        kWhatDequeueOutputBuffers           = 'deqB',
         kWhatReleaseOutputBuffer            = 'relO',
         kWhatSignalEndOfInputStream         = 'eois',
         kWhatGetBuffers                     = 'getB',
@@ -646,6 +676,15 @@ private:
         kLatencyHistWidth = 2000,
         kLatencyHistFloor = 2000,
 
+        // the log-linear histogram used for the lifetime latency stats:
+        // bucket width doubles every kLatencyHistLogOctave buckets, so
+        // 64 buckets cover 500us .. ~510ms while keeping sub-millisecond
+        // resolution at the low end.
+        kLatencyHistLogBuckets = 64,
+        kLatencyHistLogOctave = 8,
+        kLatencyHistLogFirstWidth = 250,
+        kLatencyHistLogFloor = 500,
+
         // how many samples are in the 'recent latency' histogram
         // 300 frames = 5 sec @ 60fps or ~12 sec @ 24fps
         kRecentLatencyFrames = 300,
@@ -662,11 +701,22 @@ private:
       public:
         Histogram() : mFloor(0), mWidth(0), mBelow(0), mAbove(0),
                       mMin(INT64_MAX), mMax(INT64_MIN), mSum(0), mCount(0),
-                      mBucketCount(0), mBuckets(NULL) {};
+                      mBucketCount(0), mBuckets(NULL), mBounds(NULL) {};
         ~Histogram() { clear(); };
-        void clear() { if (mBuckets != NULL) free(mBuckets); mBuckets = NULL; };
+        void clear() {
+            if (mBuckets != NULL) free(mBuckets);
+            mBuckets = NULL;
+            if (mBounds != NULL) free(mBounds);
+            mBounds = NULL;
+        };
         bool setup(int nbuckets, int64_t width, int64_t floor = 0);
+        // log-linear bucketing: the bucket width starts at firstWidth and
+        // doubles every octave buckets
+        bool setupLogLinear(int nbuckets, int octave, int64_t firstWidth, int64_t floor = 0);
         void insert(int64_t sample);
+        // value below which the given percentage (0..100) of the inserted
+        // samples fall, interpolated within its bucket
+        int64_t getPercentile(int percentile) const;
         int64_t getMin() const { return mMin; }
         int64_t getMax() const { return mMax; }
         int64_t getCount() const { return mCount; }
@@ -680,6 +730,8 @@ private:
 
         int mBucketCount;
         int64_t *mBuckets;
+        // per-bucket upper bounds when log-linear, NULL when linear
+        int64_t *mBounds;
     };
 
     Histogram mLatencyHist;
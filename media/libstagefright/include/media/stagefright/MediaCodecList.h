@@ -109,6 +109,19 @@ private:
      */
     MediaCodecList(std::vector<MediaCodecListBuilderBase*> builders);
 
+    /**
+     * This constructor is used when deserializing a previously built list
+     * from the on-disk cache; see readFromCache().
+     */
+    MediaCodecList() = default;
+
+    // Persistent cache of the built codec list, so that later cold starts
+    // become a single file read instead of re-querying every component.
+    // readFromCache() returns nullptr when the cache is absent, stale
+    // (different build or media_codecs xml set) or unreadable.
+    static sp<MediaCodecList> readFromCache();
+    void writeToCache() const;
+
     ~MediaCodecList();
 
     status_t initCheck() const;
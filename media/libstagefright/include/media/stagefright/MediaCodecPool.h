@@ -0,0 +1,88 @@
+/*
+ * Copyright 2021, The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEDIA_CODEC_POOL_H_
+
+#define MEDIA_CODEC_POOL_H_
+
+#include <list>
+
+#include <media/stagefright/foundation/ADebug.h>
+#include <media/stagefright/foundation/AString.h>
+#include <utils/Mutex.h>
+#include <utils/RefBase.h>
+
+namespace android {
+
+struct MediaCodec;
+
+/**
+ * Process-level pool of warm MediaCodec instances.
+ *
+ * Allocating a codec component takes tens of milliseconds; apps that
+ * repeatedly tear down and re-create the same codec (e.g. toggling between
+ * photo and video capture) can recycle() a stopped codec instead of releasing
+ * it and get it back from the MediaCodec::Create* factories without paying
+ * the allocation cost again.
+ *
+ * Pooling is opt-in: set the "media.codec.pool.size" property to the maximum
+ * number of instances to keep warm (default 0, disabled). Pooled codecs stay
+ * allocated and therefore remain registered with the resource manager; an
+ * instance reclaimed while pooled is discarded on the next obtain(). A reused
+ * instance keeps the looper it was originally created with.
+ */
+struct MediaCodecPool {
+    /**
+     * Returns a warm, stopped-but-allocated codec previously recycled under
+     * component name |name|, or NULL if the pool has none.
+     */
+    static sp<MediaCodec> obtain(const AString &name);
+
+    /**
+     * Offers a codec for later reuse. The codec must be stopped, i.e. the
+     * caller has successfully called stop(). Returns true if the codec was
+     * pooled, false if pooling is disabled or the codec is not reusable.
+     * The least recently recycled instance is released when the pool is over
+     * capacity.
+     */
+    static bool recycle(const sp<MediaCodec> &codec);
+
+    /**
+     * Releases all pooled codecs.
+     */
+    static void clear();
+
+private:
+    MediaCodecPool();
+
+    static MediaCodecPool &getInstance();
+
+    struct Entry {
+        AString mName;
+        sp<MediaCodec> mCodec;
+    };
+
+    const size_t mMaxSize;
+    Mutex mLock;
+    // Most recently recycled entries first.
+    std::list<Entry> mEntries;
+
+    DISALLOW_EVIL_CONSTRUCTORS(MediaCodecPool);
+};
+
+}  // namespace android
+
+#endif  // MEDIA_CODEC_POOL_H_
@@ -41,6 +41,7 @@ public:
         OUTPUT_FORMAT_THREE_GPP   = 2,
         OUTPUT_FORMAT_HEIF        = 3,
         OUTPUT_FORMAT_OGG         = 4,
+        OUTPUT_FORMAT_FRAGMENTED_MP4 = 5, // streaming fMP4, incremental moof/mdat output
         OUTPUT_FORMAT_LIST_END // must be last - used to validate format type
     };
 
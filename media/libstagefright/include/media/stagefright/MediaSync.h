@@ -22,6 +22,7 @@
 
 #include <media/AudioResamplerPublic.h>
 #include <media/AVSyncSettings.h>
+#include <media/MediaMetricsItem.h>
 #include <media/stagefright/foundation/AHandler.h>
 
 #include <utils/Condition.h>
@@ -228,6 +229,24 @@ private:
 
     sp<MediaClock> mMediaClock;
 
+    // A/V drift statistics, sampled once per rendered video frame when audio
+    // serves as the clock source. Drift is the delta between the frame's
+    // actual presentation time and the time the media clock asked for;
+    // positive means video is late relative to audio.
+    static const size_t kNumDriftBins = 7;
+    static const int64_t kDriftBinLimitsUs[kNumDriftBins - 1];
+
+    int64_t mDriftHistogram[kNumDriftBins];
+    int64_t mDriftCount;
+    int64_t mDriftSumUs;
+    int64_t mDriftMinUs;
+    int64_t mDriftMaxUs;
+    int64_t mDriftEmaUs;      // moving average of recent drift samples
+    int64_t mFramesDropped;
+    float mRateTrimRatio;     // current micro-resampling trim, 0 when inactive
+
+    mediametrics::Item *mMetricsItem;
+
     MediaSync();
 
     // Must be accessed through RefBase
@@ -274,6 +293,15 @@ private:
     // between 0.0 and 1.0 -- slower than normal speed
     void updatePlaybackRate_l(float rate);
 
+    // Record one drift sample for a rendered video frame and update the
+    // micro-resampling correction.
+    void recordVideoDriftSample_l(int64_t driftUs);
+
+    // Trim the audio track rate by a tiny, inaudible amount to pull the
+    // average drift back below the perceptual threshold. Only active when
+    // the audio adjust mode is AVSYNC_AUDIO_ADJUST_MODE_RESAMPLE.
+    void updateDriftCorrection_l();
+
     // apply new sync settings
     void resync_l();
 
@@ -87,8 +87,19 @@ struct NuMediaExtractor : public RefBase {
     // Each selected track has a read pointer.
     // advance() advances the read pointer with the lowest timestamp.
     status_t advance();
+    // advanceBatch() consumes up to |count| samples (each time the one with
+    // the lowest timestamp across the selected tracks, as with advance())
+    // under a single lock acquisition. *advanced is set to the number of
+    // samples actually consumed; when the stream ends mid-batch this returns
+    // OK with a short count and the next call reports ERROR_END_OF_STREAM.
+    status_t advanceBatch(size_t count, size_t *advanced);
     // readSampleData() reads the sample with the lowest timestamp.
     status_t readSampleData(const sp<ABuffer> &buffer);
+    // getSampleBuffer() returns a refcounted view of the sample with the
+    // lowest timestamp without copying it; the view stays valid across
+    // advance() and seekTo(). Vorbis tracks need a numPageSamples suffix
+    // appended and therefore still return a copy.
+    status_t getSampleBuffer(sp<ABuffer> *outBuffer);
 
     status_t getSampleSize(size_t *sampleSize);
     status_t getSampleTrackIndex(size_t *trackIndex);
@@ -163,6 +174,8 @@ private:
     void releaseTrackSamples(TrackInfo *info);
     void releaseAllTrackSamples();
 
+    status_t advance_l();
+
     bool getTotalBitrate(int64_t *bitRate) const;
     status_t updateDurationAndBitrate();
     status_t appendVorbisNumPageSamples(MediaBufferBase *mbuf, const sp<ABuffer> &buffer);
@@ -20,6 +20,7 @@
 
 #include <stdio.h>
 
+#include <media/stagefright/BufferedWriteSink.h>
 #include <media/stagefright/MediaWriter.h>
 #include <utils/threads.h>
 
@@ -43,6 +44,7 @@ protected:
 
 private:
     int mFd;
+    BufferedWriteSink mSink;
     bool mHaveAllCodecSpecificData;
     status_t mInitCheck;
     sp<MediaSource> mSource;
@@ -50,6 +50,11 @@ class SkipCutBuffer: public RefBase {
  private:
     void write(const char *src, size_t num);
     size_t read(char *dst, size_t num);
+    // Trims the payload at |data| + |offset| without spooling it through the
+    // ring, when the current state allows it; returns false when the caller
+    // must fall back to the ring. On success the payload length is unchanged
+    // and *outOffset receives the (possibly moved) payload offset.
+    bool trimInPlace(char *data, int32_t offset, int32_t buflen, int32_t *outOffset);
     template <typename T>
     void submitInternal(const sp<T>& buffer);
     int32_t mSkip;
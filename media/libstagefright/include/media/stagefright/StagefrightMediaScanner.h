@@ -39,6 +39,11 @@ private:
     MediaScanResult processFileInternal(
             const char *path, const char *mimeType,
             MediaScannerClient &client);
+
+    // Metadata-only fast scan: parses the file's ID3 tag in-process without
+    // instantiating an extractor. Returns MEDIA_SCAN_RESULT_SKIPPED if the
+    // file has no usable tag, in which case the caller runs the full scan.
+    MediaScanResult fastScanID3(const char *path, MediaScannerClient &client);
 };
 
 }  // namespace android
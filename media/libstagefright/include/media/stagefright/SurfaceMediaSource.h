@@ -122,6 +122,13 @@ public:
     // To be called before start()
     status_t setUseAbsoluteTimestamps();
 
+    // To be called before start(). When the encoder falls behind, every
+    // read() then hands stale queued frames straight back to the buffer
+    // queue and encodes only the newest one, so the producer never stalls
+    // on a full queue. Off by default: recording normally wants every
+    // frame, while live paths (e.g. wifi display) prefer latency.
+    status_t setDropStaleFrames();
+
 protected:
 
     // Implementation of the BufferQueue::ConsumerListener interface.  These
@@ -229,6 +236,11 @@ private:
 
     bool mUseAbsoluteTimestamps;
 
+    // see setDropStaleFrames()
+    bool mDropStaleFrames;
+    // frames dropped because a newer one was already queued
+    int mNumFramesDropped;
+
     // mFrameAvailableCondition condition used to indicate whether there
     // is a frame available for dequeuing
     Condition mFrameAvailableCondition;
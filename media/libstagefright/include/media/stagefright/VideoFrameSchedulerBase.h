@@ -34,6 +34,12 @@ struct VideoFrameSchedulerBase : public RefBase {
     // get adjusted nanotime for a video frame render at renderTime
     nsecs_t schedule(nsecs_t renderTime);
 
+    // assign adjusted nanotimes to a run of queued frames in one pass.
+    // The display timing is refreshed at most once for the whole run and
+    // each frame then goes through the same model as schedule().
+    void scheduleBatch(
+            const nsecs_t *renderTimes, nsecs_t *scheduledTimes, size_t count);
+
     // returns the vsync period for the main display
     nsecs_t getVsyncPeriod();
 
@@ -88,6 +94,12 @@ private:
 
     virtual void updateVsync() = 0;
 
+    // refresh display timing if due, dropping the correction state when the
+    // vsync period changed (e.g. a display refresh switch)
+    void refreshVsync(nsecs_t now);
+    // schedule a single frame against the current display timing
+    nsecs_t scheduleFrame(nsecs_t renderTime, nsecs_t now);
+
     nsecs_t mLastVsyncTime;    // estimated vsync time for last frame
     nsecs_t mTimeCorrection;   // running adjustment
     PLL mPll;                  // PLL for video frame rate based on render time
@@ -44,6 +44,7 @@
 #include <utils/Vector.h>
 
 #include <inttypes.h>
+#include <string.h>
 
 namespace android {
 using hardware::hidl_string;
@@ -1016,10 +1017,20 @@ bool ATSParser::Stream::ensureBufferCapacity(size_t neededSize) {
 
         newScrambledBuffer = new ABuffer(newMem->getPointer(), newMem->getSize());
 
-        if (mDescrambledBuffer != NULL) {
+        // When the output stream is clear, the descrambler operates in place
+        // on the non-secure shared memory, so use the shared buffer directly
+        // for accumulating TS payloads. This avoids copying each PES into the
+        // shared buffer before descrambling and copying the descrambled
+        // result back out afterwards. When the output stream remains
+        // scrambled we still need the original scrambled bytes after
+        // descrambling the PES header, so keep the two buffers separate.
+        bool descrambleInPlace = (mQueue != NULL && !mQueue->isScrambled());
+        const sp<ABuffer> &oldBuffer =
+                descrambleInPlace ? mBuffer : mDescrambledBuffer;
+        if (oldBuffer != NULL) {
             memcpy(newScrambledBuffer->data(),
-                    mDescrambledBuffer->data(), mDescrambledBuffer->size());
-            newScrambledBuffer->setRange(0, mDescrambledBuffer->size());
+                    oldBuffer->data(), oldBuffer->size());
+            newScrambledBuffer->setRange(0, oldBuffer->size());
         } else {
             newScrambledBuffer->setRange(0, 0);
         }
@@ -1032,6 +1043,11 @@ bool ATSParser::Stream::ensureBufferCapacity(size_t neededSize) {
 
         ALOGD("[stream %d] created shared buffer for descrambling, size %zu",
                 mElementaryPID, neededSize);
+
+        if (descrambleInPlace) {
+            mBuffer = newScrambledBuffer;
+            return true;
+        }
     } else {
         // Align to multiples of 64K.
         neededSize = (neededSize + 65535) & ~65535;
@@ -1564,9 +1580,15 @@ status_t ATSParser::Stream::flushScrambled(SyncEvent *event) {
         sctrl |= DescramblerPlugin::kScrambling_Flag_PesHeader;
     }
 
+    // When mBuffer is the shared memory itself (clear output stream), the
+    // descrambler operates in place and no staging copies are needed.
+    const bool descrambleInPlace = (mBuffer->data() == mDescrambledBuffer->data());
+
     // Perform the 1st pass descrambling if needed
     if (descrambleBytes > 0) {
-        memcpy(mDescrambledBuffer->data(), mBuffer->data(), descrambleBytes);
+        if (!descrambleInPlace) {
+            memcpy(mDescrambledBuffer->data(), mBuffer->data(), descrambleBytes);
+        }
         mDescrambledBuffer->setRange(0, mBuffer->size());
 
         hidl_vec<SubSample> subSamples;
@@ -1633,8 +1655,9 @@ status_t ATSParser::Stream::flushScrambled(SyncEvent *event) {
     // When the output stream is scrambled, it points to mDescrambledBuffer
     // (unless all packets in this PES are actually clear, in which case,
     // it points to mBuffer since we never copied into mDescrambledBuffer).
-    // When the output stream is clear, it points to mBuffer, and we'll
-    // copy all descrambled data back to mBuffer.
+    // When the output stream is clear, it points to mBuffer, which either
+    // is the shared memory itself (descrambled in place), or receives a
+    // copy of the descrambled data below.
     sp<ABuffer> buffer = mBuffer;
     if (mQueue->isScrambled()) {
         // Queue subSample info for scrambled queue
@@ -1674,7 +1697,7 @@ status_t ATSParser::Stream::flushScrambled(SyncEvent *event) {
         if (descrambleBytes > 0) {
             buffer = mDescrambledBuffer;
         }
-    } else {
+    } else if (!descrambleInPlace) {
         memcpy(mBuffer->data(), mDescrambledBuffer->data(), descrambleBytes);
     }
 
@@ -1875,6 +1898,7 @@ ATSParser::ATSParser(uint32_t flags)
       mLastRecoveredPTS(-1LL),
       mNumTSPacketsParsed(0),
       mNumPCRs(0) {
+    memset(mPIDDispatch, kPIDDispatchUnknown, sizeof(mPIDDispatch));
     mPSISections.add(0 /* PID */, new PSISection);
     mCasManager = new CasManager();
 }
@@ -1893,11 +1917,66 @@ status_t ATSParser::feedTSPacket(const void *data, size_t size,
     return parseTS(&br, event);
 }
 
+status_t ATSParser::feedTSPackets(
+        const void *data, size_t size, size_t *bytesConsumed,
+        SyncEvent *event) {
+    const uint8_t *packets = (const uint8_t *)data;
+    const off64_t baseOffset = (event != NULL) ? event->getOffset() : 0;
+    size_t offset = 0;
+    status_t err = OK;
+
+    while (size - offset >= kTSPacketSize) {
+        if (packets[offset] != 0x47u) {
+            // Lost sync. memchr compiles to the platform's vectorized byte
+            // scan; a candidate sync byte is only accepted if 0x47 repeats
+            // at the packet stride (or there is no next packet to check).
+            const uint8_t *end = packets + size;
+            const uint8_t *sync = packets + offset;
+            while ((sync = (const uint8_t *)memchr(
+                            sync, 0x47, end - sync)) != NULL) {
+                if (end - sync <= (ssize_t)kTSPacketSize
+                        || sync[kTSPacketSize] == 0x47u) {
+                    break;
+                }
+                ++sync;
+            }
+            if (sync == NULL || end - sync < (ssize_t)kTSPacketSize) {
+                // no packet start in the remaining input
+                offset = size;
+                break;
+            }
+            ALOGW("skipped %zu bytes resyncing transport stream",
+                    (size_t)(sync - packets) - offset);
+            offset = sync - packets;
+        }
+
+        SyncEvent packetEvent(baseOffset + offset);
+        err = feedTSPacket(
+                &packets[offset], kTSPacketSize,
+                (event != NULL) ? &packetEvent : NULL);
+        offset += kTSPacketSize;
+        if (err != OK) {
+            break;
+        }
+        if (event != NULL && packetEvent.hasReturnedData()) {
+            *event = packetEvent;
+            break;
+        }
+    }
+
+    if (bytesConsumed != NULL) {
+        *bytesConsumed = offset;
+    }
+    return err;
+}
+
 status_t ATSParser::setMediaCas(const sp<ICas> &cas) {
     status_t err = mCasManager->setMediaCas(cas);
     if (err != OK) {
         return err;
     }
+    // CAS setup can register new ECM PIDs.
+    memset(mPIDDispatch, kPIDDispatchUnknown, sizeof(mPIDDispatch));
     for (size_t i = 0; i < mPrograms.size(); ++i) {
         mPrograms.editItemAt(i)->updateCasSessions();
     }
@@ -2036,6 +2115,30 @@ status_t ATSParser::parsePID(
         unsigned transport_scrambling_control,
         unsigned random_access_indicator,
         SyncEvent *event) {
+    // Steady state: the dispatch cache routes the packet straight to its
+    // owner without searching mPSISections or walking mPrograms.
+    uint8_t dispatch = mPIDDispatch[PID];
+    if (dispatch == kPIDDispatchUnhandled) {
+        return OK;
+    } else if (dispatch == kPIDDispatchCas) {
+        mCasManager->parsePID(br, PID);
+        return OK;
+    } else if (dispatch >= kPIDDispatchProgramBase) {
+        size_t index = dispatch - kPIDDispatchProgramBase;
+        status_t err;
+        if (index < mPrograms.size()
+                && mPrograms.editItemAt(index)->parsePID(
+                        PID, continuity_counter,
+                        payload_unit_start_indicator,
+                        transport_scrambling_control,
+                        random_access_indicator,
+                        br, &err, event)) {
+            return err;
+        }
+        // stale entry; re-resolve below
+        mPIDDispatch[PID] = kPIDDispatchUnknown;
+    }
+
     ssize_t sectionIndex = mPSISections.indexOfKey(PID);
 
     if (sectionIndex >= 0) {
@@ -2099,6 +2202,9 @@ status_t ATSParser::parsePID(
             section->clear();
         }
 
+        // A consumed PSI section may have remapped PIDs; re-resolve lazily.
+        memset(mPIDDispatch, kPIDDispatchUnknown, sizeof(mPIDDispatch));
+
         return OK;
     }
 
@@ -2111,6 +2217,10 @@ status_t ATSParser::parsePID(
                     transport_scrambling_control,
                     random_access_indicator,
                     br, &err, event)) {
+            if (kPIDDispatchProgramBase + i <= 0xFF) {
+                mPIDDispatch[PID] = kPIDDispatchProgramBase + i;
+            }
+
             if (err != OK) {
                 return err;
             }
@@ -2122,10 +2232,14 @@ status_t ATSParser::parsePID(
 
     if (!handled) {
         handled = mCasManager->parsePID(br, PID);
+        if (handled) {
+            mPIDDispatch[PID] = kPIDDispatchCas;
+        }
     }
 
     if (!handled) {
         ALOGV("PID 0x%04x not handled.", PID);
+        mPIDDispatch[PID] = kPIDDispatchUnhandled;
     }
 
     return OK;
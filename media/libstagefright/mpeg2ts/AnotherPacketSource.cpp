@@ -477,6 +477,20 @@ int64_t AnotherPacketSource::getBufferedDurationUs(status_t *finalResult) {
     return durationUs;
 }
 
+size_t AnotherPacketSource::getBufferedSizeBytes(status_t *finalResult) {
+    Mutex::Autolock autoLock(mLock);
+    *finalResult = mEOSResult;
+
+    size_t totalSize = 0;
+    for (List<sp<ABuffer> >::iterator it = mBuffers.begin();
+            it != mBuffers.end();
+            ++it) {
+        totalSize += (*it)->size();
+    }
+
+    return totalSize;
+}
+
 int64_t AnotherPacketSource::getEstimatedBufferDurationUs() {
     Mutex::Autolock autoLock(mLock);
     if (mEstimatedBufferDurationUs >= 0) {
@@ -35,6 +35,7 @@
 
 #include <inttypes.h>
 #include <netinet/in.h>
+#include <stdlib.h>
 
 #ifdef ENABLE_CRYPTO
 #include "HlsSampleDecryptor.h"
@@ -63,6 +64,108 @@ ElementaryStreamQueue::ElementaryStreamQueue(Mode mode, uint32_t flags)
         : NULL;
 }
 
+// Wraps a BufferPool slab; hands the slab back to the pool when the last
+// reference to the access unit goes away.
+struct ElementaryStreamQueue::BufferPool::PooledBuffer : public ABuffer {
+    PooledBuffer(const sp<BufferPool> &pool, void *slab, size_t capacity)
+        : ABuffer(slab, capacity),
+          mPool(pool),
+          mSlab(slab),
+          mSlabCapacity(capacity) {
+    }
+
+protected:
+    virtual ~PooledBuffer() {
+        mPool->recycle(mSlab, mSlabCapacity);
+    }
+
+private:
+    sp<BufferPool> mPool;
+    void *mSlab;
+    size_t mSlabCapacity;
+
+    DISALLOW_EVIL_CONSTRUCTORS(PooledBuffer);
+};
+
+ElementaryStreamQueue::BufferPool::BufferPool() {
+    memset(mSlabs, 0, sizeof(mSlabs));
+}
+
+ElementaryStreamQueue::BufferPool::~BufferPool() {
+    for (size_t i = 0; i < kNumSlots; ++i) {
+        free(mSlabs[i].mData);
+    }
+}
+
+sp<ABuffer> ElementaryStreamQueue::BufferPool::fetch(size_t size) {
+    void *slab = NULL;
+    size_t capacity = 0;
+    {
+        Mutex::Autolock autoLock(mLock);
+        // reuse the smallest retained slab that fits
+        ssize_t best = -1;
+        for (size_t i = 0; i < kNumSlots; ++i) {
+            if (mSlabs[i].mData != NULL && mSlabs[i].mCapacity >= size
+                    && (best < 0 || mSlabs[i].mCapacity < mSlabs[best].mCapacity)) {
+                best = i;
+            }
+        }
+        if (best >= 0) {
+            slab = mSlabs[best].mData;
+            capacity = mSlabs[best].mCapacity;
+            mSlabs[best].mData = NULL;
+        }
+    }
+    if (slab == NULL) {
+        // round up so slightly larger future access units still fit
+        capacity = (size + 4095) & ~(size_t)4095;
+        slab = malloc(capacity);
+        if (slab == NULL) {
+            return NULL;
+        }
+    }
+    sp<ABuffer> accessUnit = new PooledBuffer(this, slab, capacity);
+    accessUnit->setRange(0, size);
+    return accessUnit;
+}
+
+void ElementaryStreamQueue::BufferPool::recycle(void *slab, size_t capacity) {
+    Mutex::Autolock autoLock(mLock);
+    ssize_t slot = -1;
+    for (size_t i = 0; i < kNumSlots; ++i) {
+        if (mSlabs[i].mData == NULL) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        // no empty slot: evict the smallest retained slab if ours is larger
+        size_t smallest = 0;
+        for (size_t i = 1; i < kNumSlots; ++i) {
+            if (mSlabs[i].mCapacity < mSlabs[smallest].mCapacity) {
+                smallest = i;
+            }
+        }
+        if (mSlabs[smallest].mCapacity < capacity) {
+            free(mSlabs[smallest].mData);
+            slot = smallest;
+        }
+    }
+    if (slot < 0) {
+        free(slab);
+        return;
+    }
+    mSlabs[slot].mData = slab;
+    mSlabs[slot].mCapacity = capacity;
+}
+
+sp<ABuffer> ElementaryStreamQueue::allocAccessUnit(size_t size) {
+    if (mBufferPool == NULL) {
+        mBufferPool = new BufferPool;
+    }
+    return mBufferPool->fetch(size);
+}
+
 sp<MetaData> ElementaryStreamQueue::getFormat() {
     return mFormat;
 }
@@ -890,7 +993,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnit() {
         RangeInfo info = *mRangeInfos.begin();
         mRangeInfos.erase(mRangeInfos.begin());
 
-        sp<ABuffer> accessUnit = new ABuffer(info.mLength);
+        sp<ABuffer> accessUnit = allocAccessUnit(info.mLength);
         memcpy(accessUnit->data(), mBuffer->data(), info.mLength);
         accessUnit->meta()->setInt64("timeUs", info.mTimestampUs);
 
@@ -993,7 +1096,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitEAC3() {
     }
     mAUIndex++;
 
-    sp<ABuffer> accessUnit = new ABuffer(syncStartPos + payloadSize);
+    sp<ABuffer> accessUnit = allocAccessUnit(syncStartPos + payloadSize);
     memcpy(accessUnit->data(), mBuffer->data(), syncStartPos + payloadSize);
 
     accessUnit->meta()->setInt64("timeUs", timeUs);
@@ -1057,7 +1160,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitAC4() {
     }
     mAUIndex++;
 
-    sp<ABuffer> accessUnit = new ABuffer(syncStartPos + payloadSize);
+    sp<ABuffer> accessUnit = allocAccessUnit(syncStartPos + payloadSize);
     memcpy(accessUnit->data(), mBuffer->data(), syncStartPos + payloadSize);
 
     accessUnit->meta()->setInt64("timeUs", timeUs);
@@ -1114,7 +1217,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitPCMAudio() {
         return NULL;
     }
 
-    sp<ABuffer> accessUnit = new ABuffer(payloadSize);
+    sp<ABuffer> accessUnit = allocAccessUnit(payloadSize);
     memcpy(accessUnit->data(), mBuffer->data() + 4, payloadSize);
 
     int64_t timeUs = fetchTimestamp(payloadSize + 4);
@@ -1276,7 +1379,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitAAC() {
 
     int64_t timeUs = fetchTimestamp(offset);
 
-    sp<ABuffer> accessUnit = new ABuffer(offset);
+    sp<ABuffer> accessUnit = allocAccessUnit(offset);
     memcpy(accessUnit->data(), mBuffer->data(), offset);
 
     memmove(mBuffer->data(), mBuffer->data() + offset,
@@ -1386,7 +1489,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitH264() {
             // the current one, separated by 0x00 0x00 0x00 0x01 startcodes.
 
             size_t auSize = 4 * nals.size() + totalSize;
-            sp<ABuffer> accessUnit = new ABuffer(auSize);
+            sp<ABuffer> accessUnit = allocAccessUnit(auSize);
             sp<ABuffer> sei;
 
             if (seiCount > 0) {
@@ -1549,7 +1652,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitMPEGAudio() {
 
     unsigned layer = 4 - ((header >> 17) & 3);
 
-    sp<ABuffer> accessUnit = new ABuffer(frameSize);
+    sp<ABuffer> accessUnit = allocAccessUnit(frameSize);
     memcpy(accessUnit->data(), data, frameSize);
 
     memmove(mBuffer->data(),
@@ -1752,7 +1855,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitMPEGVideo() {
             if (!sawPictureStart) {
                 sawPictureStart = true;
             } else {
-                sp<ABuffer> accessUnit = new ABuffer(offset);
+                sp<ABuffer> accessUnit = allocAccessUnit(offset);
                 memcpy(accessUnit->data(), data, offset);
 
                 memmove(mBuffer->data(),
@@ -1951,7 +2054,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitMPEG4Video() {
 
                     offset += chunkSize;
 
-                    sp<ABuffer> accessUnit = new ABuffer(offset);
+                    sp<ABuffer> accessUnit = allocAccessUnit(offset);
                     memcpy(accessUnit->data(), data, offset);
 
                     memmove(data, &data[offset], size - offset);
@@ -2022,7 +2125,7 @@ sp<ABuffer> ElementaryStreamQueue::dequeueAccessUnitMetadata() {
         return NULL;
     }
 
-    sp<ABuffer> accessUnit = new ABuffer(size);
+    sp<ABuffer> accessUnit = allocAccessUnit(size);
     int64_t timeUs = fetchTimestamp(size);
     accessUnit->meta()->setInt64("timeUs", timeUs);
 
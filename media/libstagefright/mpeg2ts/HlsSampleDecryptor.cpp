@@ -109,19 +109,21 @@ size_t HlsSampleDecryptor::processNal(uint8_t *nalData, size_t nalSize) {
         size_t offset = VIDEO_CLEAR_LEAD;
         size_t remainingBytes = nalSize - VIDEO_CLEAR_LEAD;
 
-        // a copy of initVec as decryptBlock updates it
-        unsigned char AESInitVec[AES_BLOCK_SIZE];
-        memcpy(AESInitVec, mAESInitVec, AES_BLOCK_SIZE);
-
+        // The protected blocks use 10% skip encryption: one encrypted block
+        // followed by up to nine clear ones.  The CBC chain runs across the
+        // encrypted blocks only, and CBC decryption has no dependency on the
+        // produced plaintext, so gathering the ciphertext into a contiguous
+        // scratch buffer keeps the chaining intact while decrypting the whole
+        // NAL with a single AES_cbc_encrypt call.  Hardware AES pipelines
+        // across the blocks of one call, where the previous block-at-a-time
+        // loop serialized on the per-call overhead.
+        mEncryptedScratch.clear();
         while (remainingBytes > 0) {
             // encrypted_block: protected block uses 10% skip encryption
             if (remainingBytes > AES_BLOCK_SIZE) {
-                uint8_t *encrypted = nalData + offset;
-                status_t ret = decryptBlock(encrypted, AES_BLOCK_SIZE, AESInitVec);
-                if (ret != OK) {
-                    ALOGE("processNal failed with %d", ret);
-                    return nalSize; // revisit this
-                }
+                const uint8_t *encrypted = nalData + offset;
+                mEncryptedScratch.insert(mEncryptedScratch.end(),
+                        encrypted, encrypted + AES_BLOCK_SIZE);
 
                 offset += AES_BLOCK_SIZE;
                 remainingBytes -= AES_BLOCK_SIZE;
@@ -134,6 +136,36 @@ size_t HlsSampleDecryptor::processNal(uint8_t *nalData, size_t nalSize) {
             remainingBytes -= clearBytes;
         } // while
 
+        if (!mEncryptedScratch.empty()) {
+            // a copy of initVec as decryptBlock updates it
+            unsigned char AESInitVec[AES_BLOCK_SIZE];
+            memcpy(AESInitVec, mAESInitVec, AES_BLOCK_SIZE);
+
+            status_t ret = decryptBlock(mEncryptedScratch.data(), mEncryptedScratch.size(),
+                    AESInitVec);
+            if (ret != OK) {
+                ALOGE("processNal failed with %d", ret);
+                return nalSize; // the NAL is left encrypted.
+            }
+
+            // Scatter the plaintext back into the skip encryption pattern.
+            const uint8_t *decrypted = mEncryptedScratch.data();
+            offset = VIDEO_CLEAR_LEAD;
+            remainingBytes = nalSize - VIDEO_CLEAR_LEAD;
+            while (remainingBytes > 0) {
+                if (remainingBytes > AES_BLOCK_SIZE) {
+                    memcpy(nalData + offset, decrypted, AES_BLOCK_SIZE);
+                    decrypted += AES_BLOCK_SIZE;
+                    offset += AES_BLOCK_SIZE;
+                    remainingBytes -= AES_BLOCK_SIZE;
+                }
+
+                size_t clearBytes = std::min(remainingBytes, (size_t)(9 * AES_BLOCK_SIZE));
+                offset += clearBytes;
+                remainingBytes -= clearBytes;
+            } // while
+        }
+
     } else { // isEncrypted == false
         ALOGV("processNal[%d]: Unencrypted NALU  (%p)/%zu", nalType, nalData, nalSize);
     }
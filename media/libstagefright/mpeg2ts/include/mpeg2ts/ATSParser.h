@@ -122,6 +122,18 @@ struct ATSParser : public RefBase {
     status_t feedTSPacket(
             const void *data, size_t size, SyncEvent *event = NULL);
 
+    // Feed a buffer holding multiple TS packets at once, amortizing the
+    // per-call overhead for high-bitrate sources. The buffer does not have
+    // to start on a packet boundary: the parser scans for the next sync byte
+    // and confirms it by checking that 0x47 repeats at the packet stride.
+    // Parsing stops as soon as event is initialized with a sync point so no
+    // events are lost; *bytesConsumed reports how much input was used and
+    // any tail shorter than one packet is left unconsumed for the caller to
+    // prepend to the next buffer.
+    status_t feedTSPackets(
+            const void *data, size_t size, size_t *bytesConsumed,
+            SyncEvent *event = NULL);
+
     void signalDiscontinuity(
             DiscontinuityType type, const sp<AMessage> &extra);
 
@@ -252,6 +264,21 @@ private:
     int64_t mSystemTimeUs[2];
     size_t mNumPCRs;
 
+    enum {
+        kPIDDispatchUnknown = 0,
+        kPIDDispatchUnhandled = 1,
+        kPIDDispatchCas = 2,
+        kPIDDispatchProgramBase = 3,
+    };
+
+    // Flat dispatch cache indexed by the 13-bit PID, so the steady-state
+    // per-packet path reaches the owning program without walking mPrograms
+    // or searching mPSISections. Entries resolve lazily to one of the
+    // kPIDDispatch* values (program entries store kPIDDispatchProgramBase +
+    // program index) and the whole table is invalidated whenever a PSI
+    // section is consumed or the CAS setup changes, as those can remap PIDs.
+    uint8_t mPIDDispatch[8192];
+
     DISALLOW_EVIL_CONSTRUCTORS(ATSParser);
 };
 
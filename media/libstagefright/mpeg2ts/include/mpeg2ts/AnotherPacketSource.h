@@ -60,6 +60,9 @@ struct AnotherPacketSource : public MediaSource {
     // Returns the difference between the two largest timestamps queued
     int64_t getEstimatedBufferDurationUs();
 
+    // Returns the total payload size of the queued access units, in bytes.
+    size_t getBufferedSizeBytes(status_t *finalResult);
+
     status_t nextBufferTime(int64_t *timeUs);
 
     void queueAccessUnit(const sp<ABuffer> &buffer);
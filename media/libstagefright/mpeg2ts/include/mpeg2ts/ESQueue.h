@@ -22,6 +22,7 @@
 #include <media/stagefright/foundation/AMessage.h>
 #include <utils/Errors.h>
 #include <utils/List.h>
+#include <utils/Mutex.h>
 #include <utils/RefBase.h>
 #include <vector>
 
@@ -95,6 +96,36 @@ private:
         sp<ABuffer> mEncSizes;
     };
 
+    // Recycles the backing stores of dequeued access units: a released
+    // access unit hands its slab back here instead of to the allocator, and
+    // the next access unit of similar size reuses it, so steady-state
+    // dequeueAccessUnit() stops allocating. Refcounted by the access units
+    // it backs, so it outlives the queue while a consumer still holds one.
+    struct BufferPool : public RefBase {
+        BufferPool();
+
+        sp<ABuffer> fetch(size_t size);
+        void recycle(void *slab, size_t capacity);
+
+    protected:
+        virtual ~BufferPool();
+
+    private:
+        struct PooledBuffer;
+
+        struct Slab {
+            void *mData;
+            size_t mCapacity;
+        };
+
+        enum { kNumSlots = 4 };
+
+        Mutex mLock;
+        Slab mSlabs[kNumSlots];
+
+        DISALLOW_EVIL_CONSTRUCTORS(BufferPool);
+    };
+
     Mode mMode;
     uint32_t mFlags;
     bool mEOSReached;
@@ -112,6 +143,8 @@ private:
     sp<SampleDecryptor> mSampleDecryptor;
     int mAUIndex;
 
+    sp<BufferPool> mBufferPool;
+
     bool isSampleEncrypted() const {
         return (mFlags & kFlag_SampleEncryptedData) != 0;
     }
@@ -134,6 +167,10 @@ private:
 
     sp<ABuffer> dequeueScrambledAccessUnit();
 
+    // allocates the backing store for a dequeued access unit from
+    // mBufferPool (creating the pool on first use).
+    sp<ABuffer> allocAccessUnit(size_t size);
+
     DISALLOW_EVIL_CONSTRUCTORS(ElementaryStreamQueue);
 };
 
@@ -28,6 +28,8 @@
 #include <utils/RefBase.h>
 #include <utils/Vector.h>
 
+#include <vector>
+
 #include "SampleDecryptor.h"
 
 namespace android {
@@ -57,6 +59,11 @@ private:
     uint8_t mAESInitVec[AES_BLOCK_SIZE];
     bool mValidKeyInfo;
 
+    // Scratch buffer that gathers the encrypted blocks of a NAL so they
+    // decrypt in a single AES_cbc_encrypt call; reused across NALs to
+    // avoid a per-sample allocation.
+    std::vector<uint8_t> mEncryptedScratch;
+
     DISALLOW_EVIL_CONSTRUCTORS(HlsSampleDecryptor);
 };
 
@@ -38,8 +38,12 @@
 #include <android/multinetwork.h>
 
 #include <arpa/inet.h>
+#include <stdlib.h>
 #include <sys/socket.h>
 
+#include <utils/Mutex.h>
+#include <utils/Vector.h>
+
 namespace android {
 
 static const size_t kMaxUDPSize = 1500;
@@ -86,6 +90,81 @@ struct ARTPConnection::StreamInfo {
     int mCVOExtMap; // will be set to 0 if cvo is not negotiated in sdp
 };
 
+// receive buffer size; must hold any UDP datagram
+static const size_t kDatagramSlabSize = 65536;
+
+// Recycles datagram receive buffers between the socket reader and the
+// packet assemblers. A buffer handed out by obtain() returns its slab here
+// when the assembler drops its last reference, so the steady-state receive
+// path makes no allocations. The pool is refcounted by the buffers it
+// backs, so in-flight packets stay valid if the connection goes away first.
+struct ARTPConnection::DatagramPool : public RefBase {
+    sp<ABuffer> obtain();
+    void recycle(void *slab);
+
+protected:
+    virtual ~DatagramPool();
+
+private:
+    struct PooledBuffer;
+
+    // bounds idle memory to kMaxRetainedSlabs * kDatagramSlabSize
+    static const size_t kMaxRetainedSlabs = 32;
+
+    Mutex mLock;
+    Vector<void *> mSlabs;
+};
+
+struct ARTPConnection::DatagramPool::PooledBuffer : public ABuffer {
+    PooledBuffer(const sp<DatagramPool> &pool, void *slab)
+        : ABuffer(slab, kDatagramSlabSize),
+          mPool(pool),
+          mSlab(slab) {
+    }
+
+protected:
+    virtual ~PooledBuffer() {
+        mPool->recycle(mSlab);
+    }
+
+private:
+    sp<DatagramPool> mPool;
+    void *mSlab;
+};
+
+ARTPConnection::DatagramPool::~DatagramPool() {
+    for (size_t i = 0; i < mSlabs.size(); ++i) {
+        free(mSlabs[i]);
+    }
+}
+
+sp<ABuffer> ARTPConnection::DatagramPool::obtain() {
+    void *slab = NULL;
+    {
+        Mutex::Autolock autoLock(mLock);
+        if (!mSlabs.empty()) {
+            slab = mSlabs.top();
+            mSlabs.pop();
+        }
+    }
+    if (slab == NULL) {
+        slab = malloc(kDatagramSlabSize);
+        if (slab == NULL) {
+            return NULL;
+        }
+    }
+    return new PooledBuffer(this, slab);
+}
+
+void ARTPConnection::DatagramPool::recycle(void *slab) {
+    Mutex::Autolock autoLock(mLock);
+    if (mSlabs.size() < kMaxRetainedSlabs) {
+        mSlabs.push(slab);
+    } else {
+        free(slab);
+    }
+}
+
 ARTPConnection::ARTPConnection(uint32_t flags)
     : mFlags(flags),
       mPollEventPending(false),
@@ -95,7 +174,8 @@ ARTPConnection::ARTPConnection(uint32_t flags)
       mTargetBitrate(-1),
       mRtpSockOptEcn(0),
       mIsIPv6(false),
-      mStaticJitterTimeMs(kStaticJitterTimeMs) {
+      mStaticJitterTimeMs(kStaticJitterTimeMs),
+      mDatagramPool(new DatagramPool) {
 }
 
 ARTPConnection::~ARTPConnection() {
@@ -617,7 +697,7 @@ status_t ARTPConnection::receive(StreamInfo *s, bool receiveRTP) {
 
     CHECK(!s->mIsInjected);
 
-    sp<ABuffer> buffer = new ABuffer(65536);
+    sp<ABuffer> buffer = mDatagramPool->obtain();
 
     struct msghdr sMsg = {};
     struct iovec sIov[1] = {};
@@ -663,6 +743,10 @@ status_t ARTPConnection::receive(StreamInfo *s, bool receiveRTP) {
     status_t err;
     if (receiveRTP) {
         err = parseRTP(s, buffer);
+        if (err == OK) {
+            // drain whatever else is queued on the socket in batches
+            err = receiveRTPBatch(s);
+        }
     } else {
         err = parseRTCP(s, buffer);
     }
@@ -670,6 +754,59 @@ status_t ARTPConnection::receive(StreamInfo *s, bool receiveRTP) {
     return err;
 }
 
+status_t ARTPConnection::receiveRTPBatch(StreamInfo *s) {
+    // Pulls follow-up datagrams with single recvmmsg() calls instead of one
+    // syscall + allocation per packet; at 4K bitrates dozens of packets pile
+    // up between polls.
+    static const unsigned kRecvBatchSize = 8;
+
+    for (;;) {
+        sp<ABuffer> buffers[kRecvBatchSize];
+        struct mmsghdr msgs[kRecvBatchSize] = {};
+        struct iovec iovs[kRecvBatchSize] = {};
+        int cMsgSize = sizeof(struct cmsghdr) + sizeof(uint8_t);
+        char controls[kRecvBatchSize][CMSG_SPACE(sizeof(struct cmsghdr) + sizeof(uint8_t))];
+
+        for (unsigned i = 0; i < kRecvBatchSize; ++i) {
+            buffers[i] = mDatagramPool->obtain();
+            if (buffers[i] == NULL) {
+                return -ENOMEM;
+            }
+            iovs[i].iov_base = buffers[i]->data();
+            iovs[i].iov_len = buffers[i]->capacity();
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_control = controls[i];
+            msgs[i].msg_hdr.msg_controllen = CMSG_SPACE(cMsgSize);
+        }
+
+        int n;
+        do {
+            n = recvmmsg(s->mRTPSocket, msgs, kRecvBatchSize, MSG_DONTWAIT, NULL);
+        } while (n < 0 && errno == EINTR);
+
+        if (n <= 0) {
+            // nothing further queued; unused buffers go back to the pool
+            return OK;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            mCumulativeBytes += msgs[i].msg_len;
+            handleIpHeadersIfReceived(s, msgs[i].msg_hdr);
+            buffers[i]->setRange(0, msgs[i].msg_len);
+
+            status_t err = parseRTP(s, buffers[i]);
+            if (err != OK) {
+                return err;
+            }
+        }
+
+        if ((unsigned)n < kRecvBatchSize) {
+            return OK;
+        }
+    }
+}
+
 /* This function will check if TOS is present or not in received IP packet.
  * After that if it is present then it will notify about congestion to upper
  * layer if CE bit is set in TOS header.
@@ -103,6 +103,10 @@ private:
 
     int32_t mCumulativeBytes;
 
+    // recycles datagram receive buffers, see obtain() in the implementation
+    struct DatagramPool;
+    sp<DatagramPool> mDatagramPool;
+
     void onAddStream(const sp<AMessage> &msg);
     void onSeekStream(const sp<AMessage> &msg);
     void onRemoveStream(const sp<AMessage> &msg);
@@ -115,6 +119,7 @@ private:
     void handleIpHeadersIfReceived(StreamInfo *s, struct msghdr sMsg);
 
     status_t receive(StreamInfo *info, bool receiveRTP);
+    status_t receiveRTPBatch(StreamInfo *info);
     ssize_t send(const StreamInfo *info, const sp<ABuffer> buffer);
 
     status_t parseRTP(StreamInfo *info, const sp<ABuffer> &buffer);
@@ -132,6 +132,37 @@ int WebmElement::write(int fd, uint64_t& size) {
     }
 }
 
+// Serializes this element into scratch and appends it to fd with a single
+// write call at the current file offset. Unlike write(), this neither remaps
+// file pages nor forces synchronous writeback, so the caller can go on
+// assembling the next element while the kernel flushes this one in the
+// background. scratch is grown as needed and reused across calls; the sink
+// thread passes the same buffer for every cluster so steady-state writing
+// allocates nothing.
+int WebmElement::writeBuffered(int fd, sp<ABuffer>& scratch, uint64_t& size) {
+    size = totalSize();
+    if (scratch == NULL || scratch->capacity() < size) {
+        scratch = new ABuffer(size);
+    }
+    serializeInto(scratch->data());
+
+    uint8_t *src = scratch->data();
+    uint64_t remaining = size;
+    while (remaining > 0) {
+        ssize_t n = ::write(fd, src, remaining);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ALOGE("write failed; errno = %d", errno);
+            return errno;
+        }
+        src += n;
+        remaining -= n;
+    }
+    return 0;
+}
+
 //=================================================================================================
 
 WebmUnsigned::WebmUnsigned(uint64_t id, uint64_t value)
@@ -20,6 +20,7 @@
 #include "WebmConstants.h"
 #include "WebmFrameThread.h"
 
+#include <media/stagefright/GaplessTimeline.h>
 #include <media/stagefright/MetaData.h>
 #include <media/stagefright/foundation/ADebug.h>
 
@@ -130,7 +131,11 @@ void WebmFrameSinkThread::writeCluster(List<sp<WebmElement> >& children) {
 
     uint64_t size;
     sp<WebmElement> cluster = new WebmMaster(kMkvCluster, children);
-    cluster->write(mFd, size);
+    // Serialize into the reused scratch buffer and append with a plain write
+    // instead of WebmElement::write()'s mmap + msync(MS_SYNC) path, which
+    // stalled this thread on storage writeback for every cluster. The next
+    // cluster is assembled while the kernel flushes this one.
+    cluster->writeBuffered(mFd, mClusterScratch, size);
     children.clear();
 }
 
@@ -340,7 +345,7 @@ void WebmFrameMediaSourceThread::run() {
     int64_t timestampUs = 0xdeadbeef;
     int64_t lastTimestampUs = 0; // Previous sample time stamp
     int64_t lastDurationUs = 0; // Previous sample duration
-    int64_t previousPausedDurationUs = 0;
+    GaplessTimeline gaplessTimeline;
 
     const uint64_t kUninitialized = 0xffffffffffffffffL;
     mStartTimeUs = kUninitialized;
@@ -371,14 +376,11 @@ void WebmFrameMediaSourceThread::run() {
 
         // adjust time-stamps after pause/resume
         if (mResumed) {
-            int64_t durExcludingEarlierPausesUs = timestampUs - previousPausedDurationUs;
-            CHECK_GE(durExcludingEarlierPausesUs, 0LL);
-            int64_t pausedDurationUs = durExcludingEarlierPausesUs - mTrackDurationUs;
-            CHECK_GE(pausedDurationUs, lastDurationUs);
-            previousPausedDurationUs += pausedDurationUs - lastDurationUs;
+            CHECK_EQ((status_t)OK,
+                    gaplessTimeline.onResume(timestampUs, mTrackDurationUs, lastDurationUs));
             mResumed = false;
         }
-        timestampUs -= previousPausedDurationUs;
+        timestampUs = gaplessTimeline.rebase(timestampUs);
         CHECK_GE(timestampUs, 0LL);
 
         int32_t isSync = false;
@@ -38,6 +38,7 @@ struct WebmElement : public LightRefBase<WebmElement> {
     uint64_t serializeInto(uint8_t *buf);
     uint8_t *serialize(uint64_t& size);
     int write(int fd, uint64_t& size);
+    int writeBuffered(int fd, sp<ABuffer>& scratch, uint64_t& size);
 
     static sp<WebmElement> EbmlHeader(
             int ver = 1,
@@ -85,6 +85,10 @@ private:
     List<sp<WebmElement> >& mCues;
     uint64_t mStartOffsetTimecode;
 
+    // Scratch buffer that clusters are serialized into before being written
+    // out; reused across clusters so steady-state muxing does not allocate.
+    sp<ABuffer> mClusterScratch;
+
     volatile bool mDone;
 
     static void initCluster(
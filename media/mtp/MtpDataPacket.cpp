@@ -349,6 +349,14 @@ void MtpDataPacket::putUInt128(uint64_t value) {
     putUInt64(0);
 }
 
+void MtpDataPacket::putData(const void* data, size_t length) {
+    allocate(mOffset + length);
+    memcpy(mBuffer + mOffset, data, length);
+    mOffset += length;
+    if (mPacketSize < mOffset)
+        mPacketSize = mOffset;
+}
+
 void MtpDataPacket::putAInt8(const int8_t* values, int count) {
     putUInt32(count);
     for (int i = 0; i < count; i++)
@@ -88,6 +88,7 @@ public:
     void                putAUInt32(const UInt32List* list);
     void                putAInt64(const int64_t* values, int count);
     void                putAUInt64(const uint64_t* values, int count);
+    void                putData(const void* data, size_t length);
     void                putString(const MtpStringBuffer& string);
     void                putString(const char* string);
     void                putString(const uint16_t* string);
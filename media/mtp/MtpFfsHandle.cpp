@@ -75,6 +75,15 @@ int MtpFfsHandle::getPacketSize(int ffs_fd) {
 MtpFfsHandle::MtpFfsHandle(int controlFd) {
     mControl.reset(controlFd);
     mBatchCancel = android::base::GetBoolProperty("sys.usb.mtp.batchcancel", false);
+
+    // Allow devices to tune how much file data is kept in flight per pipeline
+    // stage. Smaller chunks start overlapping USB and storage io sooner on
+    // small files; the default keeps the historical maximum chunk size.
+    size_t chunkSize = android::base::GetUintProperty<size_t>(
+            "sys.usb.mtp.chunk_size", static_cast<size_t>(MAX_FILE_CHUNK_SIZE));
+    chunkSize -= chunkSize % AIO_BUF_LEN;
+    mChunkSize = std::min(std::max(chunkSize, static_cast<size_t>(AIO_BUF_LEN)),
+            static_cast<size_t>(MAX_FILE_CHUNK_SIZE));
 }
 
 MtpFfsHandle::~MtpFfsHandle() {}
@@ -136,7 +145,7 @@ int MtpFfsHandle::doAsync(void* data, size_t len, bool read, bool zero_packet) {
     size_t total = 0;
 
     while (total < len) {
-        size_t this_len = std::min(len - total, static_cast<size_t>(AIO_BUF_LEN * AIO_BUFS_MAX));
+        size_t this_len = std::min(len - total, mChunkSize);
         int num_bufs = this_len / AIO_BUF_LEN + (this_len % AIO_BUF_LEN == 0 ? 0 : 1);
         for (int i = 0; i < num_bufs; i++) {
             mIobuf[0].buf[i] = reinterpret_cast<unsigned char*>(data) + total + i * AIO_BUF_LEN;
@@ -466,7 +475,7 @@ int MtpFfsHandle::receiveFile(mtp_file_range mfr, bool zero_packet) {
     while (file_length > 0 || has_write) {
         // Queue an asynchronous read from USB.
         if (file_length > 0) {
-            length = std::min(static_cast<uint32_t>(MAX_FILE_CHUNK_SIZE), file_length);
+            length = std::min(static_cast<uint32_t>(mChunkSize), file_length);
             if (iobufSubmit(&mIobuf[i], mBulkOut, length, true) == -1)
                 error = true;
         }
@@ -608,7 +617,7 @@ int MtpFfsHandle::sendFile(mtp_file_range mfr) {
     while(file_length > 0 || has_write) {
         if (file_length > 0) {
             // Queue up a read from disk.
-            length = std::min(static_cast<uint64_t>(MAX_FILE_CHUNK_SIZE), file_length);
+            length = std::min(static_cast<uint64_t>(mChunkSize), file_length);
             aio_prepare(&aio, mIobuf[i].bufs.data(), length, offset);
             aio_read(&aio);
         }
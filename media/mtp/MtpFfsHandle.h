@@ -59,6 +59,10 @@ protected:
 
     bool mCanceled;
     bool mBatchCancel;
+    // Size of the file chunk transferred per iteration of the pipelined
+    // file transfer loops, in bytes. Configurable with the property
+    // sys.usb.mtp.chunk_size; always a multiple of the aio buffer length.
+    size_t mChunkSize;
 
     android::base::unique_fd mControl;
     // "in" from the host's perspective => sink for mtp server
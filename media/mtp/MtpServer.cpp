@@ -120,7 +120,14 @@ MtpServer::MtpServer(IMtpDatabase* database, int controlFd, bool ptp,
         mSendObjectHandle(kInvalidObjectHandle),
         mSendObjectFormat(0),
         mSendObjectFileSize(0),
-        mSendObjectModifiedTime(0)
+        mSendObjectModifiedTime(0),
+        mPropListCacheParent(kInvalidObjectHandle),
+        mPropListCacheFormat(0),
+        mPropListCacheProperty(0),
+        mPropListCacheGroup(0),
+        mPropListCacheValid(false),
+        mPropListPrefetchUnsupported(false),
+        mPropListCacheDirty(false)
 {
     bool ffs_ok = access(FFS_MTP_EP0, W_OK) == 0;
     if (ffs_ok) {
@@ -143,6 +150,7 @@ void MtpServer::addStorage(MtpStorage* storage) {
 
 void MtpServer::removeStorage(MtpStorage* storage) {
     std::lock_guard<std::mutex> lg(mMutex);
+    invalidatePropListCache();
     auto iter = std::find(mStorages.begin(), mStorages.end(), storage);
     if (iter != mStorages.end()) {
         sendStoreRemoved(storage->getStorageID());
@@ -254,16 +262,19 @@ void MtpServer::run() {
 
 void MtpServer::sendObjectAdded(MtpObjectHandle handle) {
     ALOGV("sendObjectAdded %d\n", handle);
+    mPropListCacheDirty = true;
     sendEvent(MTP_EVENT_OBJECT_ADDED, handle);
 }
 
 void MtpServer::sendObjectRemoved(MtpObjectHandle handle) {
     ALOGV("sendObjectRemoved %d\n", handle);
+    mPropListCacheDirty = true;
     sendEvent(MTP_EVENT_OBJECT_REMOVED, handle);
 }
 
 void MtpServer::sendObjectInfoChanged(MtpObjectHandle handle) {
     ALOGV("sendObjectInfoChanged %d\n", handle);
+    mPropListCacheDirty = true;
     sendEvent(MTP_EVENT_OBJECT_INFO_CHANGED, handle);
 }
 
@@ -679,6 +690,7 @@ MtpResponseCode MtpServer::doSetObjectPropValue() {
     ALOGV("SetObjectPropValue %d %s\n", handle,
             MtpDebug::getObjectPropCodeName(property));
 
+    invalidatePropListCache();
     return mDatabase->setObjectPropertyValue(handle, property, mData);
 }
 
@@ -712,6 +724,112 @@ MtpResponseCode MtpServer::doResetDevicePropValue() {
     return mDatabase->resetDeviceProperty(property);
 }
 
+void MtpServer::invalidatePropListCache() {
+    mPropListCacheValid = false;
+    mPropListCacheParent = kInvalidObjectHandle;
+    mPropListCache.clear();
+}
+
+bool MtpServer::cachePropListForParent(MtpObjectHandle parent, uint32_t format,
+        uint32_t property, int groupCode) {
+    MtpDataPacket data;
+    MtpResponseCode result = mDatabase->getObjectPropertyList(
+            parent, format, property, groupCode, 1, data);
+    if (result == MTP_RESPONSE_SPECIFICATION_BY_DEPTH_UNSUPPORTED) {
+        mPropListPrefetchUnsupported = true;
+        return false;
+    }
+    if (result != MTP_RESPONSE_OK)
+        return false;
+
+    int length = 0;
+    uint8_t* buffer = static_cast<uint8_t*>(data.getData(&length));
+    if (!buffer)
+        return false;
+
+    invalidatePropListCache();
+
+    // Split the ObjectPropList dataset into per-handle runs of raw elements.
+    // Each element is handle (u32), property code (u16), datatype (u16),
+    // followed by a value whose size depends on the datatype.
+    size_t size = length;
+    size_t offset = 0;
+    uint32_t count = 0;
+    bool ok = size >= sizeof(uint32_t);
+    if (ok) {
+        count = buffer[0] | (buffer[1] << 8) | (buffer[2] << 16)
+                | ((uint32_t)buffer[3] << 24);
+        offset = sizeof(uint32_t);
+    }
+    for (uint32_t i = 0; ok && i < count; i++) {
+        size_t elementStart = offset;
+        if (size - offset < 8) {
+            ok = false;
+            break;
+        }
+        MtpObjectHandle elementHandle = buffer[offset] | (buffer[offset + 1] << 8)
+                | (buffer[offset + 2] << 16) | ((uint32_t)buffer[offset + 3] << 24);
+        uint16_t type = buffer[offset + 6] | (buffer[offset + 7] << 8);
+        offset += 8;
+        size_t valueSize = 0;
+        switch (type) {
+            case MTP_TYPE_INT8:
+            case MTP_TYPE_UINT8:
+                valueSize = 1;
+                break;
+            case MTP_TYPE_INT16:
+            case MTP_TYPE_UINT16:
+                valueSize = 2;
+                break;
+            case MTP_TYPE_INT32:
+            case MTP_TYPE_UINT32:
+                valueSize = 4;
+                break;
+            case MTP_TYPE_INT64:
+            case MTP_TYPE_UINT64:
+                valueSize = 8;
+                break;
+            case MTP_TYPE_INT128:
+            case MTP_TYPE_UINT128:
+                valueSize = 16;
+                break;
+            case MTP_TYPE_STR:
+                // length byte followed by 16-bit characters
+                if (size - offset < 1) {
+                    ok = false;
+                    break;
+                }
+                valueSize = 1 + buffer[offset] * 2;
+                break;
+            default:
+                // Array values aren't used for object properties; don't
+                // try to cache datasets we can't parse.
+                ok = false;
+                break;
+        }
+        if (!ok || size - offset < valueSize) {
+            ok = false;
+            break;
+        }
+        offset += valueSize;
+        PropListEntry& entry = mPropListCache[elementHandle];
+        entry.count++;
+        entry.data.insert(entry.data.end(), buffer + elementStart, buffer + offset);
+    }
+    free(buffer);
+
+    if (!ok) {
+        invalidatePropListCache();
+        return false;
+    }
+    mPropListCacheParent = parent;
+    mPropListCacheFormat = format;
+    mPropListCacheProperty = property;
+    mPropListCacheGroup = groupCode;
+    mPropListCacheValid = true;
+    return true;
+}
+
 MtpResponseCode MtpServer::doGetObjectPropList() {
     if (!hasStorage())
         return MTP_RESPONSE_INVALID_OBJECT_HANDLE;
@@ -728,6 +846,32 @@ MtpResponseCode MtpServer::doGetObjectPropList() {
             handle, MtpDebug::getFormatCodeName(format),
             MtpDebug::getObjectPropCodeName(property), groupCode, depth);
 
+    if (mPropListCacheDirty.exchange(false))
+        invalidatePropListCache();
+
+    // For single-object queries, prefetch the object's whole directory with
+    // one depth-1 query and serve this object and its siblings from memory.
+    if (depth == 0 && handle != 0 && handle != 0xFFFFFFFF
+            && !mPropListPrefetchUnsupported) {
+        bool cacheMatches = mPropListCacheValid && format == mPropListCacheFormat
+                && property == mPropListCacheProperty && groupCode == mPropListCacheGroup;
+        if (!cacheMatches || mPropListCache.find(handle) == mPropListCache.end()) {
+            MtpObjectInfo info(handle);
+            if (mDatabase->getObjectInfo(handle, info) == MTP_RESPONSE_OK
+                    && !(cacheMatches && info.mParent == mPropListCacheParent)) {
+                cacheMatches = cachePropListForParent(info.mParent, format, property, groupCode);
+            }
+        }
+        if (cacheMatches) {
+            auto entry = mPropListCache.find(handle);
+            if (entry != mPropListCache.end()) {
+                mData.putUInt32(entry->second.count);
+                mData.putData(entry->second.data.data(), entry->second.data.size());
+                return MTP_RESPONSE_OK;
+            }
+        }
+    }
+
     return mDatabase->getObjectPropertyList(handle, format, property, groupCode, depth, mData);
 }
 
@@ -929,6 +1073,7 @@ MtpResponseCode MtpServer::doGetPartialObject(MtpOperationCode operation) {
 }
 
 MtpResponseCode MtpServer::doSendObjectInfo() {
+    invalidatePropListCache();
     MtpStringBuffer path;
     uint16_t temp16;
     uint32_t temp32;
@@ -1051,6 +1196,7 @@ MtpResponseCode MtpServer::doSendObjectInfo() {
 }
 
 MtpResponseCode MtpServer::doMoveObject() {
+    invalidatePropListCache();
     if (!hasStorage())
         return MTP_RESPONSE_GENERAL_ERROR;
     if (mRequest.getParameterCount() < 3)
@@ -1129,6 +1275,7 @@ MtpResponseCode MtpServer::doMoveObject() {
 }
 
 MtpResponseCode MtpServer::doCopyObject() {
+    invalidatePropListCache();
     if (!hasStorage())
         return MTP_RESPONSE_GENERAL_ERROR;
     MtpResponseCode result = MTP_RESPONSE_OK;
@@ -1198,6 +1345,7 @@ MtpResponseCode MtpServer::doCopyObject() {
 }
 
 MtpResponseCode MtpServer::doSendObject() {
+    invalidatePropListCache();
     if (!hasStorage())
         return MTP_RESPONSE_GENERAL_ERROR;
     MtpResponseCode result = MTP_RESPONSE_OK;
@@ -1310,6 +1458,7 @@ done:
 }
 
 MtpResponseCode MtpServer::doDeleteObject() {
+    invalidatePropListCache();
     if (!hasStorage())
         return MTP_RESPONSE_INVALID_OBJECT_HANDLE;
     if (mRequest.getParameterCount() < 1)
@@ -1440,6 +1589,7 @@ MtpResponseCode MtpServer::doSendPartialObject() {
 }
 
 MtpResponseCode MtpServer::doTruncateObject() {
+    invalidatePropListCache();
     if (mRequest.getParameterCount() < 3)
         return MTP_RESPONSE_INVALID_PARAMETER;
     MtpObjectHandle handle = mRequest.getParameter(1);
@@ -1487,6 +1637,7 @@ MtpResponseCode MtpServer::doBeginEditObject() {
 }
 
 MtpResponseCode MtpServer::doEndEditObject() {
+    invalidatePropListCache();
     if (mRequest.getParameterCount() < 1)
         return MTP_RESPONSE_INVALID_PARAMETER;
     MtpObjectHandle handle = mRequest.getParameter(1);
@@ -26,9 +26,12 @@
 #include "MtpUtils.h"
 #include "IMtpHandle.h"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 namespace android {
 
@@ -100,6 +103,27 @@ private:
     };
     std::vector<ObjectEdit*>  mObjectEditList;
 
+    // Cached GetObjectPropList results for the children of one directory,
+    // fetched with a single depth-1 database query when the host asks for
+    // the properties of one of them. Hosts enumerate large directories by
+    // walking sibling handles one GetObjectPropList at a time; serving the
+    // siblings from this cache turns one database query per object into one
+    // per directory.
+    struct PropListEntry {
+        uint32_t            count;
+        std::vector<uint8_t> data;  // raw dataset elements for one handle
+    };
+    MtpObjectHandle     mPropListCacheParent;
+    uint32_t            mPropListCacheFormat;
+    uint32_t            mPropListCacheProperty;
+    int                 mPropListCacheGroup;
+    bool                mPropListCacheValid;
+    // set when the database rejects depth-1 queries, to stop prefetching
+    bool                mPropListPrefetchUnsupported;
+    // set by the object change notifiers, which run without mMutex held
+    std::atomic<bool>   mPropListCacheDirty;
+    std::unordered_map<MtpObjectHandle, PropListEntry> mPropListCache;
+
 public:
                         MtpServer(IMtpDatabase* database, int controlFd, bool ptp,
                                     const char *deviceInfoManufacturer,
@@ -134,6 +158,10 @@ private:
 
     bool                handleRequest();
 
+    bool                cachePropListForParent(MtpObjectHandle parent, uint32_t format,
+                                uint32_t property, int groupCode);
+    void                invalidatePropListCache();
+
     MtpResponseCode     doGetDeviceInfo();
     MtpResponseCode     doOpenSession();
     MtpResponseCode     doCloseSession();
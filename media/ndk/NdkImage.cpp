@@ -636,6 +636,44 @@ AImage::getPlaneData(int planeIdx,/*out*/uint8_t** data, /*out*/int* dataLength)
     return AMEDIA_OK;
 }
 
+media_status_t
+AImage::isTightlyPacked(/*out*/bool* tightlyPacked) const {
+    if (mLockedBuffer == nullptr) {
+        ALOGE("%s: buffer not locked.", __FUNCTION__);
+        return AMEDIA_IMGREADER_IMAGE_NOT_LOCKED;
+    }
+    if (tightlyPacked == nullptr) {
+        return AMEDIA_ERROR_INVALID_PARAMETER;
+    }
+    if (isClosed()) {
+        ALOGE("%s: image %p has been closed!", __FUNCTION__, this);
+        return AMEDIA_ERROR_INVALID_OBJECT;
+    }
+
+    const int32_t width = mLockedBuffer->width;
+    *tightlyPacked = true;
+    for (int planeIdx = 0; planeIdx < mNumPlanes; planeIdx++) {
+        int32_t pixelStride = 0;
+        int32_t rowStride = 0;
+        media_status_t ret = getPlanePixelStride(planeIdx, &pixelStride);
+        if (ret != AMEDIA_OK) {
+            return ret;
+        }
+        ret = getPlaneRowStride(planeIdx, &rowStride);
+        if (ret != AMEDIA_OK) {
+            return ret;
+        }
+        // Chroma planes of the supported multi-planar formats are subsampled
+        // by two horizontally, so they carry half as many samples per row.
+        int32_t samplesPerRow = (planeIdx == 0) ? width : (width + 1) / 2;
+        if (rowStride != pixelStride * samplesPerRow) {
+            *tightlyPacked = false;
+            return AMEDIA_OK;
+        }
+    }
+    return AMEDIA_OK;
+}
+
 media_status_t
 AImage::getHardwareBuffer(/*out*/AHardwareBuffer** buffer) const {
     if (mBuffer == nullptr || mBuffer->mGraphicBuffer == nullptr) {
@@ -806,6 +844,24 @@ media_status_t AImage_getPlaneData(
     return image->getPlaneData(planeIdx, data, dataLength);
 }
 
+EXPORT
+media_status_t AImage_isTightlyPacked(
+        const AImage* image, /*out*/bool* tightlyPacked) {
+    ALOGV("%s", __FUNCTION__);
+    if (image == nullptr || tightlyPacked == nullptr) {
+        ALOGE("%s: bad argument. image %p tightlyPacked %p",
+                __FUNCTION__, image, tightlyPacked);
+        return AMEDIA_ERROR_INVALID_PARAMETER;
+    }
+    media_status_t ret = const_cast<AImage*>(image)->lockImage();
+    if (ret != AMEDIA_OK) {
+        ALOGE("%s: failed to lock buffer for CPU access. image %p, error=%d.",
+              __FUNCTION__, image, ret);
+        return ret;
+    }
+    return image->isTightlyPacked(tightlyPacked);
+}
+
 EXPORT
 media_status_t AImage_getHardwareBuffer(
     const AImage* image, /*out*/AHardwareBuffer** buffer) {
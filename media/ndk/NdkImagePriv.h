@@ -81,6 +81,7 @@ struct AImage {
     media_status_t getPlanePixelStride(int planeIdx, /*out*/int32_t* pixelStride) const;
     media_status_t getPlaneRowStride(int planeIdx, /*out*/int32_t* rowStride) const;
     media_status_t getPlaneData(int planeIdx,/*out*/uint8_t** data, /*out*/int* dataLength) const;
+    media_status_t isTightlyPacked(/*out*/bool* tightlyPacked) const;
     media_status_t getHardwareBuffer(/*out*/AHardwareBuffer** buffer) const;
 
   private:
@@ -648,6 +648,40 @@ AImageReader::acquireLatestImage(/*out*/AImage** image, /*out*/int* acquireFence
     }
 }
 
+media_status_t
+AImageReader::acquireLatestImages(/*out*/AImage** images, int32_t maxCount,
+        /*out*/int32_t* acquiredCount) {
+    Mutex::Autolock _l(mLock);
+    *acquiredCount = 0;
+    media_status_t ret = AMEDIA_IMGREADER_NO_BUFFER_AVAILABLE;
+    List<AImage*> acquired;
+    for (;;) {
+        AImage* image = nullptr;
+        ret = acquireImageLocked(&image, /*acquireFenceFd*/nullptr);
+        if (image == nullptr) {
+            break;
+        }
+        acquired.push_back(image);
+        if ((int32_t)acquired.size() > maxCount) {
+            // Keep only the latest maxCount images; return the oldest one to
+            // the queue so the producer can refill it. No need for a release
+            // fence since acquireImageLocked has already waited for the
+            // acquire fence and the image was never used.
+            AImage* oldest = *acquired.begin();
+            acquired.erase(acquired.begin());
+            oldest->close();
+            oldest->free();
+        }
+    }
+    if (acquired.empty()) {
+        return ret;
+    }
+    for (AImage* image : acquired) {
+        images[(*acquiredCount)++] = image;
+    }
+    return AMEDIA_OK;
+}
+
 static native_handle_t *convertHalTokenToNativeHandle(
         const HalToken &halToken) {
     // We attempt to store halToken in the ints of the native_handle_t after its
@@ -855,6 +889,19 @@ media_status_t AImageReader_acquireLatestImageAsync(
     return reader->acquireLatestImage(image, acquireFenceFd);
 }
 
+EXPORT
+media_status_t AImageReader_acquireLatestImages(
+    AImageReader* reader, /*out*/AImage** images, int32_t maxCount,
+    /*out*/int32_t* acquiredCount) {
+    ALOGV("%s", __FUNCTION__);
+    if (reader == nullptr || images == nullptr || acquiredCount == nullptr || maxCount < 1) {
+        ALOGE("%s: invalid argument. reader %p, images %p, maxCount %d, acquiredCount %p",
+                __FUNCTION__, reader, images, maxCount, acquiredCount);
+        return AMEDIA_ERROR_INVALID_PARAMETER;
+    }
+    return reader->acquireLatestImages(images, maxCount, acquiredCount);
+}
+
 EXPORT
 media_status_t AImageReader_setImageListener(
         AImageReader* reader, AImageReader_ImageListener* listener) {
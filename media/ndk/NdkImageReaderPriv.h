@@ -68,6 +68,8 @@ struct AImageReader : public RefBase {
 
     media_status_t acquireNextImage(/*out*/AImage** image, /*out*/int* fenceFd);
     media_status_t acquireLatestImage(/*out*/AImage** image, /*out*/int* fenceFd);
+    media_status_t acquireLatestImages(/*out*/AImage** images, int32_t maxCount,
+            /*out*/int32_t* acquiredCount);
 
     media_status_t getWindowNativeHandle(/*out*/native_handle_t **handle);
 
@@ -15,6 +15,7 @@
  */
 
 #include <charconv>
+#include <deque>
 #include <inttypes.h>
 #include <mutex>
 #include <set>
@@ -116,6 +117,15 @@ struct AMediaCodec {
     AMediaCodecOnAsyncNotifyCallback mAsyncCallback;
     void *mAsyncCallbackUserData;
 
+    // Coalesced asynchronous notifications. When enabled, available buffers
+    // are queued here and announced through mAsyncBuffersAvailableCallback,
+    // which is re-armed only once both queues have been drained.
+    bool mAsyncCallbacksCoalesced;
+    AMediaCodecOnAsyncBuffersAvailable mAsyncBuffersAvailableCallback;
+    bool mAsyncBuffersNotifyArmed;
+    std::deque<int32_t> mPendingAsyncInputs;
+    std::deque<std::pair<int32_t, AMediaCodecBufferInfo>> mPendingAsyncOutputs;
+
     sp<AMessage> mFrameRenderedNotify;
     mutable Mutex mFrameRenderedCallbackLock;
     AMediaCodecOnFrameRendered mFrameRenderedCallback;
@@ -126,6 +136,30 @@ CodecHandler::CodecHandler(AMediaCodec *codec) {
     mCodec = codec;
 }
 
+// Fires the coalesced buffers-available callback if it is armed. The callback
+// itself is invoked without holding mAsyncCallbackLock so that the client may
+// drain the pending queues (which take the same lock) from within it.
+static void notifyBuffersAvailable(AMediaCodec *codec) {
+    AMediaCodecOnAsyncBuffersAvailable callback;
+    void *userdata;
+    int32_t numInputBuffers;
+    int32_t numOutputBuffers;
+    {
+        Mutex::Autolock _l(codec->mAsyncCallbackLock);
+        if (!codec->mAsyncCallbacksCoalesced || !codec->mAsyncBuffersNotifyArmed) {
+            return;
+        }
+        codec->mAsyncBuffersNotifyArmed = false;
+        callback = codec->mAsyncBuffersAvailableCallback;
+        userdata = codec->mAsyncCallbackUserData;
+        numInputBuffers = (int32_t)codec->mPendingAsyncInputs.size();
+        numOutputBuffers = (int32_t)codec->mPendingAsyncOutputs.size();
+    }
+    if (callback != NULL) {
+        callback(codec, userdata, numInputBuffers, numOutputBuffers);
+    }
+}
+
 void CodecHandler::onMessageReceived(const sp<AMessage> &msg) {
 
     switch (msg->what()) {
@@ -179,13 +213,18 @@ void CodecHandler::onMessageReceived(const sp<AMessage> &msg) {
                          break;
                      }
 
-                     Mutex::Autolock _l(mCodec->mAsyncCallbackLock);
-                     if (mCodec->mAsyncCallback.onAsyncInputAvailable != NULL) {
-                         mCodec->mAsyncCallback.onAsyncInputAvailable(
-                                 mCodec,
-                                 mCodec->mAsyncCallbackUserData,
-                                 index);
+                     {
+                         Mutex::Autolock _l(mCodec->mAsyncCallbackLock);
+                         if (mCodec->mAsyncCallbacksCoalesced) {
+                             mCodec->mPendingAsyncInputs.push_back(index);
+                         } else if (mCodec->mAsyncCallback.onAsyncInputAvailable != NULL) {
+                             mCodec->mAsyncCallback.onAsyncInputAvailable(
+                                     mCodec,
+                                     mCodec->mAsyncCallbackUserData,
+                                     index);
+                         }
                      }
+                     notifyBuffersAvailable(mCodec);
 
                      break;
                  }
@@ -225,14 +264,19 @@ void CodecHandler::onMessageReceived(const sp<AMessage> &msg) {
                          timeUs,
                          (uint32_t)flags};
 
-                     Mutex::Autolock _l(mCodec->mAsyncCallbackLock);
-                     if (mCodec->mAsyncCallback.onAsyncOutputAvailable != NULL) {
-                         mCodec->mAsyncCallback.onAsyncOutputAvailable(
-                                 mCodec,
-                                 mCodec->mAsyncCallbackUserData,
-                                 index,
-                                 &bufferInfo);
+                     {
+                         Mutex::Autolock _l(mCodec->mAsyncCallbackLock);
+                         if (mCodec->mAsyncCallbacksCoalesced) {
+                             mCodec->mPendingAsyncOutputs.emplace_back(index, bufferInfo);
+                         } else if (mCodec->mAsyncCallback.onAsyncOutputAvailable != NULL) {
+                             mCodec->mAsyncCallback.onAsyncOutputAvailable(
+                                     mCodec,
+                                     mCodec->mAsyncCallbackUserData,
+                                     index,
+                                     &bufferInfo);
+                         }
                      }
+                     notifyBuffersAvailable(mCodec);
 
                      break;
                  }
@@ -444,6 +488,9 @@ static AMediaCodec * createAMediaCodec(const char *name,
 
     mData->mAsyncCallback = {};
     mData->mAsyncCallbackUserData = NULL;
+    mData->mAsyncCallbacksCoalesced = false;
+    mData->mAsyncBuffersAvailableCallback = NULL;
+    mData->mAsyncBuffersNotifyArmed = false;
 
     return mData;
 }
@@ -572,6 +619,11 @@ media_status_t AMediaCodec_setAsyncNotifyCallback(
         // success.
         mData->mAsyncCallback = callback;
         mData->mAsyncCallbackUserData = userdata;
+        mData->mAsyncCallbacksCoalesced = false;
+        mData->mAsyncBuffersAvailableCallback = NULL;
+        mData->mAsyncBuffersNotifyArmed = false;
+        mData->mPendingAsyncInputs.clear();
+        mData->mPendingAsyncOutputs.clear();
     }
 
     // always call, codec may have been reset/re-configured since last call.
@@ -590,6 +642,86 @@ media_status_t AMediaCodec_setAsyncNotifyCallback(
     return AMEDIA_OK;
 }
 
+EXPORT
+media_status_t AMediaCodec_setAsyncNotifyCallbackCoalesced(
+        AMediaCodec *mData,
+        AMediaCodecOnAsyncNotifyCallback callback,
+        AMediaCodecOnAsyncBuffersAvailable buffersCallback,
+        void *userdata) {
+
+    {
+        Mutex::Autolock _l(mData->mAsyncCallbackLock);
+        if (mData->mAsyncNotify == NULL) {
+            mData->mAsyncNotify = new AMessage(kWhatAsyncNotify, mData->mHandler);
+        }
+        // we set this ahead so that we can be ready
+        // to receive callbacks as soon as the next call is a
+        // success.
+        mData->mAsyncCallback = callback;
+        mData->mAsyncCallbackUserData = userdata;
+        mData->mAsyncCallbacksCoalesced = (buffersCallback != NULL);
+        mData->mAsyncBuffersAvailableCallback = buffersCallback;
+        mData->mAsyncBuffersNotifyArmed = (buffersCallback != NULL);
+        mData->mPendingAsyncInputs.clear();
+        mData->mPendingAsyncOutputs.clear();
+    }
+
+    // always call, codec may have been reset/re-configured since last call.
+    status_t err = mData->mCodec->setCallback(mData->mAsyncNotify);
+    if (err != OK) {
+        {
+            //The setup gone wrong. clean up the pointers.
+            Mutex::Autolock _l(mData->mAsyncCallbackLock);
+            mData->mAsyncCallback = {};
+            mData->mAsyncCallbackUserData = nullptr;
+            mData->mAsyncCallbacksCoalesced = false;
+            mData->mAsyncBuffersAvailableCallback = NULL;
+            mData->mAsyncBuffersNotifyArmed = false;
+        }
+        ALOGE("setAsyncNotifyCallbackCoalesced: err(%d), failed to set async callback", err);
+        return translate_error(err);
+    }
+
+    return AMEDIA_OK;
+}
+
+EXPORT
+ssize_t AMediaCodec_popPendingInputBuffer(AMediaCodec *mData) {
+    Mutex::Autolock _l(mData->mAsyncCallbackLock);
+    if (mData->mPendingAsyncInputs.empty()) {
+        if (mData->mAsyncCallbacksCoalesced && mData->mPendingAsyncOutputs.empty()) {
+            mData->mAsyncBuffersNotifyArmed = true;
+        }
+        return AMEDIACODEC_INFO_TRY_AGAIN_LATER;
+    }
+    int32_t index = mData->mPendingAsyncInputs.front();
+    mData->mPendingAsyncInputs.pop_front();
+    if (mData->mPendingAsyncInputs.empty() && mData->mPendingAsyncOutputs.empty()) {
+        mData->mAsyncBuffersNotifyArmed = true;
+    }
+    return index;
+}
+
+EXPORT
+ssize_t AMediaCodec_popPendingOutputBuffer(AMediaCodec *mData, AMediaCodecBufferInfo *info) {
+    Mutex::Autolock _l(mData->mAsyncCallbackLock);
+    if (mData->mPendingAsyncOutputs.empty()) {
+        if (mData->mAsyncCallbacksCoalesced && mData->mPendingAsyncInputs.empty()) {
+            mData->mAsyncBuffersNotifyArmed = true;
+        }
+        return AMEDIACODEC_INFO_TRY_AGAIN_LATER;
+    }
+    int32_t index = mData->mPendingAsyncOutputs.front().first;
+    if (info != NULL) {
+        *info = mData->mPendingAsyncOutputs.front().second;
+    }
+    mData->mPendingAsyncOutputs.pop_front();
+    if (mData->mPendingAsyncInputs.empty() && mData->mPendingAsyncOutputs.empty()) {
+        mData->mAsyncBuffersNotifyArmed = true;
+    }
+    return index;
+}
+
 EXPORT
 media_status_t AMediaCodec_setOnFrameRenderedCallback(
         AMediaCodec *mData,
@@ -628,6 +760,17 @@ media_status_t AMediaCodec_start(AMediaCodec *mData) {
     return AMEDIA_OK;
 }
 
+// Drops buffer indices queued for coalesced asynchronous notifications; they
+// are no longer valid once the codec has been stopped or flushed.
+static void clearPendingAsyncBuffers(AMediaCodec *mData) {
+    Mutex::Autolock _l(mData->mAsyncCallbackLock);
+    mData->mPendingAsyncInputs.clear();
+    mData->mPendingAsyncOutputs.clear();
+    if (mData->mAsyncCallbacksCoalesced) {
+        mData->mAsyncBuffersNotifyArmed = true;
+    }
+}
+
 EXPORT
 media_status_t AMediaCodec_stop(AMediaCodec *mData) {
     media_status_t ret = translate_error(mData->mCodec->stop());
@@ -636,13 +779,16 @@ media_status_t AMediaCodec_stop(AMediaCodec *mData) {
     sp<AMessage> response;
     msg->postAndAwaitResponse(&response);
     mData->mActivityNotification.clear();
+    clearPendingAsyncBuffers(mData);
 
     return ret;
 }
 
 EXPORT
 media_status_t AMediaCodec_flush(AMediaCodec *mData) {
-    return translate_error(mData->mCodec->flush());
+    media_status_t ret = translate_error(mData->mCodec->flush());
+    clearPendingAsyncBuffers(mData);
+    return ret;
 }
 
 EXPORT
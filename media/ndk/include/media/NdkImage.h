@@ -36,6 +36,7 @@
 #ifndef _NDK_IMAGE_H
 #define _NDK_IMAGE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <sys/cdefs.h>
 
@@ -826,6 +827,38 @@ void AImage_deleteAsync(AImage* image, int releaseFenceFd) __INTRODUCED_IN(26);
  */
 media_status_t AImage_getHardwareBuffer(const AImage* image, /*out*/AHardwareBuffer** buffer) __INTRODUCED_IN(26);
 
+/**
+ * Query whether all planes of the image are tightly packed, i.e. whether within each plane the
+ * rows are laid out contiguously with no padding between them.
+ *
+ * <p>When an image is tightly packed, consumers that need a stride-free layout — such as machine
+ * learning runtimes binding camera frames to input tensors — can hand the plane data returned by
+ * {@link AImage_getPlaneData} to the tensor directly and skip the per-row repack copy. The buffer
+ * allocator chooses the row stride based on format, dimensions and hardware alignment constraints,
+ * so whether a given configuration is packed can only be determined from an acquired image.</p>
+ *
+ * <p>Note that this method requires the image to come from an {@link AImageReader} created with
+ * the {@link AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN} usage flag. Since the allocator applies the
+ * same layout to every buffer of a queue, the result also holds for subsequent images acquired
+ * from the same {@link AImageReader} with the same dimensions and format.</p>
+ *
+ * Available since Android T.
+ *
+ * @param image the {@link AImage} of interest.
+ * @param tightlyPacked The memory area pointed to by tightlyPacked will contain true if every
+ *         plane's row stride equals its per-row payload, false otherwise.
+ * @return <ul>
+ *         <li>{@link AMEDIA_OK} if the method call succeeds.</li>
+ *         <li>{@link AMEDIA_ERROR_INVALID_PARAMETER} if image or tightlyPacked is NULL.</li>
+ *         <li>{@link AMEDIA_ERROR_INVALID_OBJECT} if the {@link AImage} has been deleted.</li>
+ *         <li>{@link AMEDIA_IMGREADER_CANNOT_LOCK_IMAGE} if the image could not be locked for CPU
+ *         access.</li>
+ *         <li>{@link AMEDIA_ERROR_UNSUPPORTED} if the image format does not define a row
+ *         stride (such as {@link AIMAGE_FORMAT_JPEG}).</li></ul>
+ */
+media_status_t AImage_isTightlyPacked(
+        const AImage* image, /*out*/bool* tightlyPacked) __INTRODUCED_IN(__ANDROID_API_T__);
+
 __END_DECLS
 
 #endif //_NDK_IMAGE_H
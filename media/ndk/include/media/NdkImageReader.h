@@ -429,6 +429,42 @@ media_status_t AImageReader_acquireNextImageAsync(
 media_status_t AImageReader_acquireLatestImageAsync(
         AImageReader* reader, /*out*/AImage** image, /*out*/int* acquireFenceFd) __INTRODUCED_IN(26);
 
+/**
+ * Acquire up to maxCount of the latest {@link AImage}s from the image reader's queue, dropping
+ * older images.
+ *
+ * <p>This is the batched form of {@link AImageReader_acquireLatestImage}: the entire pending queue
+ * is drained in one call, the latest maxCount images are returned oldest first, and any older
+ * images are released back to the queue. Consumers that process frames in batches — such as
+ * camera to neural-network inference pipelines — use this to pick up every pending frame with a
+ * single call instead of one acquire per image.</p>
+ *
+ * <p>Each returned image must be returned with {@link AImage_delete} once it is no longer needed.
+ * maxCount images count against the maxImages budget of the reader the same way individually
+ * acquired images do.</p>
+ *
+ * Available since Android T.
+ *
+ * @param reader The image reader of interest.
+ * @param images the array the acquired {@link AImage}s are written to. Must have room for at least
+ *         maxCount entries.
+ * @param maxCount the maximum number of images to acquire. Must be at least 1.
+ * @param acquiredCount The memory area pointed to by acquiredCount will contain the number of
+ *         images written to images.
+ * @return <ul>
+ *         <li>{@link AMEDIA_OK} if at least one image was acquired.</li>
+ *         <li>{@link AMEDIA_ERROR_INVALID_PARAMETER} if reader, images or acquiredCount is NULL,
+ *         or maxCount is less than 1.</li>
+ *         <li>{@link AMEDIA_IMGREADER_NO_BUFFER_AVAILABLE} if there is no buffer currently
+ *         available in the reader queue.</li>
+ *         <li>{@link AMEDIA_IMGREADER_MAX_IMAGES_ACQUIRED} if the number of concurrently acquired
+ *         images has reached the limit.</li>
+ *         <li>{@link AMEDIA_ERROR_UNKNOWN} if the method fails for some other reasons.</li></ul>
+ */
+media_status_t AImageReader_acquireLatestImages(
+        AImageReader* reader, /*out*/AImage** images, int32_t maxCount,
+        /*out*/int32_t* acquiredCount) __INTRODUCED_IN(__ANDROID_API_T__);
+
 /**
  * Signature of the callback which is called when {@link AImageReader} is about to remove a buffer.
  *
@@ -123,6 +123,24 @@ typedef struct AMediaCodecOnAsyncNotifyCallback {
       AMediaCodecOnAsyncError           onAsyncError;
 } AMediaCodecOnAsyncNotifyCallback;
 
+/**
+ * Called when input and/or output buffers become available while coalesced
+ * asynchronous notifications are in use
+ * (see AMediaCodec_setAsyncNotifyCallbackCoalesced).
+ *
+ * The specified counts are the number of buffers pending at the time of the
+ * callback; the client drains them with non-blocking
+ * AMediaCodec_popPendingInputBuffer() / AMediaCodec_popPendingOutputBuffer()
+ * loops. The callback fires once per burst of buffers: it is re-armed only
+ * after both pending queues have been drained, so high-rate codecs generate
+ * one callback per drain cycle instead of one per buffer.
+ */
+typedef void (*AMediaCodecOnAsyncBuffersAvailable)(
+        AMediaCodec *codec,
+        void *userdata,
+        int32_t numInputBuffers,
+        int32_t numOutputBuffers);
+
 /**
  * Called when an output frame has rendered on the output surface.
  *
@@ -471,6 +489,61 @@ media_status_t AMediaCodec_setAsyncNotifyCallback(
         AMediaCodecOnAsyncNotifyCallback callback,
         void *userdata) __INTRODUCED_IN(28);
 
+/**
+ * Set asynchronous callbacks with coalesced buffer notifications.
+ *
+ * This behaves like AMediaCodec_setAsyncNotifyCallback except that the
+ * per-buffer onAsyncInputAvailable and onAsyncOutputAvailable members of
+ * |callback| are ignored; instead, |buffersCallback| is invoked once per burst
+ * of available buffers with the pending counts, and the client drains the
+ * pending buffers with AMediaCodec_popPendingInputBuffer() and
+ * AMediaCodec_popPendingOutputBuffer() loops. The onAsyncFormatChanged and
+ * onAsyncError members of |callback| are still delivered individually.
+ *
+ * The |buffersCallback| is re-armed only once both pending queues have been
+ * drained, so high-rate codecs generate one callback and wakeup per drain
+ * cycle rather than one per buffer.
+ *
+ * The restrictions and lifecycle rules of AMediaCodec_setAsyncNotifyCallback
+ * apply; in particular the codec must be started after a flush, and callbacks
+ * are fired on one NDK internal thread.
+ *
+ * When called with null |buffersCallback|, this method unregisters any
+ * previously set callbacks and leaves coalesced mode.
+ *
+ * Available since Android T.
+ */
+media_status_t AMediaCodec_setAsyncNotifyCallbackCoalesced(
+        AMediaCodec*,
+        AMediaCodecOnAsyncNotifyCallback callback,
+        AMediaCodecOnAsyncBuffersAvailable buffersCallback,
+        void *userdata) __INTRODUCED_IN(__ANDROID_API_T__);
+
+/**
+ * Pop the index of the next pending input buffer while coalesced asynchronous
+ * notifications are in use. Does not block.
+ *
+ * Returns the index of an available input buffer, or
+ * AMEDIACODEC_INFO_TRY_AGAIN_LATER if no input buffer is pending.
+ *
+ * Available since Android T.
+ */
+ssize_t AMediaCodec_popPendingInputBuffer(AMediaCodec*) __INTRODUCED_IN(__ANDROID_API_T__);
+
+/**
+ * Pop the index of the next pending output buffer while coalesced asynchronous
+ * notifications are in use, filling |info| with its buffer info. Does not
+ * block.
+ *
+ * Returns the index of an available output buffer, or
+ * AMEDIACODEC_INFO_TRY_AGAIN_LATER if no output buffer is pending.
+ *
+ * Available since Android T.
+ */
+ssize_t AMediaCodec_popPendingOutputBuffer(
+        AMediaCodec*,
+        AMediaCodecBufferInfo *info) __INTRODUCED_IN(__ANDROID_API_T__);
+
 /**
  * Registers a callback to be invoked when an output frame is rendered on the output surface.
  *
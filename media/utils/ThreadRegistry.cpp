@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ThreadRegistry"
+#include <utils/Log.h>
+
+#include <mediautils/ThreadRegistry.h>
+
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include <cutils/properties.h>
+
+namespace android::mediautils {
+
+namespace {
+
+// sched_setattr() has no bionic wrapper; declare the attr structure and
+// clamp flags here (linux/sched/types.h is not in the ndk sysroot).
+struct sched_attr {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+    uint32_t sched_util_min;
+    uint32_t sched_util_max;
+};
+
+constexpr uint64_t kSchedFlagKeepAll = 0x7 << 3;  // SCHED_FLAG_KEEP_ALL
+constexpr uint64_t kSchedFlagUtilClampMin = 1 << 5;
+constexpr uint64_t kSchedFlagUtilClampMax = 1 << 6;
+
+int schedSetAttr(pid_t tid, const struct sched_attr* attr) {
+    return syscall(__NR_sched_setattr, tid, attr, 0 /* flags */);
+}
+
+std::string cpuSetToString(const cpu_set_t& cpuSet) {
+    std::stringstream ss;
+    bool first = true;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &cpuSet)) {
+            if (!first) ss << ",";
+            ss << cpu;
+            first = false;
+        }
+    }
+    return ss.str();
+}
+
+} // namespace
+
+/* static */
+ThreadRegistry& ThreadRegistry::getInstance() {
+    // Meyer's singleton, as for UidInfo in MediaMetricsService.
+    static ThreadRegistry registry;
+    return registry;
+}
+
+/* static */
+bool ThreadRegistry::parseCpuList(const std::string& list, cpu_set_t* cpuSet) {
+    CPU_ZERO(cpuSet);
+    const char* p = list.c_str();
+    while (*p != '\0') {
+        char* end;
+        const long first = strtol(p, &end, 10);
+        if (end == p || first < 0 || first >= CPU_SETSIZE) return false;
+        long last = first;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first || last >= CPU_SETSIZE) return false;
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            CPU_SET((int)cpu, cpuSet);
+        }
+        if (*end == ',') {
+            p = end + 1;
+        } else if (*end == '\0') {
+            p = end;
+        } else {
+            return false;
+        }
+    }
+    return CPU_COUNT(cpuSet) > 0;
+}
+
+ThreadRegistry::Policy ThreadRegistry::policyForRole_l(const std::string& role) const {
+    const auto it = mPolicyOverrides.find(role);
+    if (it != mPolicyOverrides.end()) {
+        return it->second;
+    }
+
+    Policy policy;
+    const std::string base = std::string("media.threadpolicy.") + role;
+    char value[PROPERTY_VALUE_MAX];
+    if (property_get((base + ".cpus").c_str(), value, "") > 0) {
+        if (parseCpuList(value, &policy.cpuSet)) {
+            policy.hasCpuSet = true;
+        } else {
+            ALOGW("%s: malformed cpu list '%s' for role %s", __func__, value, role.c_str());
+        }
+    }
+    policy.uclampMin = property_get_int32((base + ".uclamp_min").c_str(), -1);
+    policy.uclampMax = property_get_int32((base + ".uclamp_max").c_str(), -1);
+    return policy;
+}
+
+bool ThreadRegistry::registerThread(
+        const std::string& role, const std::string& name, pid_t tid) {
+    if (tid == -1) {
+        tid = gettid();
+    }
+
+    std::lock_guard lock(mLock);
+    const Policy policy = policyForRole_l(role);
+    Registration reg{role, name, "", false};
+
+    if (policy.empty()) {
+        reg.decision = "no policy for role";
+    } else {
+        std::stringstream decision;
+        bool ok = true;
+        if (policy.hasCpuSet) {
+            if (sched_setaffinity(tid, sizeof(policy.cpuSet), &policy.cpuSet) == 0) {
+                decision << "cpus(" << cpuSetToString(policy.cpuSet) << ") ";
+            } else {
+                decision << "cpus failed errno " << errno << " ";
+                ok = false;
+            }
+        }
+        if (policy.uclampMin >= 0 || policy.uclampMax >= 0) {
+            struct sched_attr attr = {};
+            attr.size = sizeof(attr);
+            attr.sched_flags = kSchedFlagKeepAll;
+            if (policy.uclampMin >= 0) {
+                attr.sched_flags |= kSchedFlagUtilClampMin;
+                attr.sched_util_min = policy.uclampMin;
+            }
+            if (policy.uclampMax >= 0) {
+                attr.sched_flags |= kSchedFlagUtilClampMax;
+                attr.sched_util_max = policy.uclampMax;
+            }
+            if (schedSetAttr(tid, &attr) == 0) {
+                decision << "uclamp(" << policy.uclampMin
+                         << "," << policy.uclampMax << ")";
+            } else {
+                // expected on kernels without util clamp; record, don't fail hard.
+                decision << "uclamp failed errno " << errno;
+                ok = false;
+            }
+        }
+        reg.decision = decision.str();
+        reg.applied = ok;
+        ALOGV_IF(ok, "%s: tid %d role %s: %s", __func__, tid, role.c_str(), reg.decision.c_str());
+        ALOGW_IF(!ok, "%s: tid %d role %s: %s", __func__, tid, role.c_str(), reg.decision.c_str());
+    }
+
+    const bool applied = reg.applied;
+    mThreads[tid] = std::move(reg);
+    return applied;
+}
+
+void ThreadRegistry::unregisterThread(pid_t tid) {
+    if (tid == -1) {
+        tid = gettid();
+    }
+    std::lock_guard lock(mLock);
+    mThreads.erase(tid);
+}
+
+void ThreadRegistry::setPolicyOverride(const std::string& role, const Policy& policy) {
+    std::lock_guard lock(mLock);
+    mPolicyOverrides[role] = policy;
+}
+
+std::string ThreadRegistry::dump() const {
+    std::stringstream ss;
+    std::lock_guard lock(mLock);
+    ss << "ThreadRegistry: " << mThreads.size() << " threads\n";
+    for (const auto& [tid, reg] : mThreads) {
+        ss << "  tid " << tid << " role(" << reg.role << ") name(" << reg.name
+           << ") applied(" << (reg.applied ? "yes" : "no")
+           << ") " << reg.decision << "\n";
+    }
+    return ss.str();
+}
+
+} // namespace android::mediautils
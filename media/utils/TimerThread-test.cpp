@@ -209,6 +209,71 @@ INSTANTIATE_TEST_CASE_P(
         ::testing::Values(0.f, 0.5f, 1.f)
         );
 
+// Timeouts of at least TimerThread::kWheelMinTimeout take the lock-free
+// TimerWheel path; the wheel sweeps periodically, so expiry may be late
+// by up to one sweep period (plus scheduling jitter).
+constexpr auto kWheelTimeout = TimerThread::kWheelMinTimeout;
+constexpr auto kWheelJitter = TimerThread::kWheelSweepPeriod + 2 * kJitter;
+
+TEST(TimerThread, WheelBasic) {
+    std::atomic<bool> taskRan = false;
+    TimerThread thread;
+    TimerThread::Handle handle =
+            thread.scheduleTask("WheelBasic", [&taskRan](TimerThread::Handle handle __unused) {
+                    taskRan = true; }, kWheelTimeout, 0ms /* secondChanceDuration */);
+    ASSERT_TRUE(TimerThread::isWheelHandle(handle));
+
+    // 1 task pending.
+    ASSERT_EQ(1, countChars(thread.pendingToString(), REQUEST_START));
+
+    std::this_thread::sleep_for(kWheelTimeout - kJitter);
+    ASSERT_FALSE(taskRan);
+    std::this_thread::sleep_for(kJitter + kWheelJitter);
+    ASSERT_TRUE(taskRan);
+    ASSERT_FALSE(thread.cancelTask(handle));  // stale, already fired.
+    ASSERT_EQ(0, countChars(thread.pendingToString(), REQUEST_START));
+    ASSERT_EQ(1, countChars(thread.timeoutToString(), REQUEST_START));
+}
+
+TEST(TimerThread, WheelCancel) {
+    std::atomic<bool> taskRan = false;
+    TimerThread thread;
+    TimerThread::Handle handle =
+            thread.scheduleTask("WheelCancel", [&taskRan](TimerThread::Handle handle __unused) {
+                    taskRan = true; }, kWheelTimeout, 0ms /* secondChanceDuration */);
+    ASSERT_TRUE(TimerThread::isWheelHandle(handle));
+
+    std::this_thread::sleep_for(kWheelTimeout / 2);
+    ASSERT_FALSE(taskRan);
+    ASSERT_TRUE(thread.cancelTask(handle));
+    std::this_thread::sleep_for(kWheelTimeout / 2 + kWheelJitter);
+    ASSERT_FALSE(taskRan);
+
+    // handle is stale, cancel returns false.
+    ASSERT_FALSE(thread.cancelTask(handle));
+    ASSERT_EQ(0, countChars(thread.pendingToString(), REQUEST_START));
+    ASSERT_EQ(1, countChars(thread.retiredToString(), REQUEST_START));
+}
+
+TEST(TimerThread, WheelSecondChance) {
+    constexpr auto kSecondChance = 500ms;
+    std::atomic<bool> taskRan = false;
+    TimerThread thread;
+    TimerThread::Handle handle =
+            thread.scheduleTask("WheelSecondChance",
+                    [&taskRan](TimerThread::Handle handle __unused) {
+                    taskRan = true; }, kWheelTimeout, kSecondChance);
+    ASSERT_TRUE(TimerThread::isWheelHandle(handle));
+
+    // The entry must not fire before timeout + second chance; the second
+    // chance countdown starts when the sweeper notices the first expiry,
+    // so allow a wheel jitter on both deadlines.
+    std::this_thread::sleep_for(kWheelTimeout + kSecondChance - kJitter);
+    ASSERT_FALSE(taskRan);
+    std::this_thread::sleep_for(kJitter + 2 * kWheelJitter);
+    ASSERT_TRUE(taskRan);
+}
+
 TEST(TimerThread, TrackedTasks) {
     TimerThread thread;
 
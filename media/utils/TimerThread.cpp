@@ -40,6 +40,13 @@ TimerThread::Handle TimerThread::scheduleTask(
     auto request = std::make_shared<const Request>(now, now +
             std::chrono::duration_cast<std::chrono::system_clock::duration>(timeoutDuration),
             secondChanceDuration, gettid(), tag);
+    // The common case - a multi-second watchdog timeout that is cancelled
+    // before it expires - is handled lock-free by the TimerWheel.
+    // tryAdd() moves from request and func only on success, so on
+    // INVALID_HANDLE both are still valid for the MonitorThread path.
+    const Handle handle = mTimerWheel.tryAdd(std::move(request), std::move(func),
+            timeoutDuration);
+    if (handle != INVALID_HANDLE) return handle;
     return mMonitorThread.add(std::move(request), std::move(func), timeoutDuration);
 }
 
@@ -51,8 +58,14 @@ TimerThread::Handle TimerThread::trackTask(std::string_view tag) {
 }
 
 bool TimerThread::cancelTask(Handle handle) {
-    std::shared_ptr<const Request> request = isNoTimeoutHandle(handle) ?
-             mNoTimeoutMap.remove(handle) : mMonitorThread.remove(handle);
+    std::shared_ptr<const Request> request;
+    if (isNoTimeoutHandle(handle)) {
+        request = mNoTimeoutMap.remove(handle);
+    } else if (isWheelHandle(handle)) {
+        request = mTimerWheel.remove(handle);
+    } else {
+        request = mMonitorThread.remove(handle);
+    }
     if (!request) return false;
     mRetiredQueue.add(std::move(request));
     return true;
@@ -90,7 +103,8 @@ std::string TimerThread::toString(size_t retiredCount) const {
     return std::string("now ")
             .append(formatTime(std::chrono::system_clock::now()))
             .append("\nsecondChanceCount ")
-            .append(std::to_string(mMonitorThread.getSecondChanceCount()))
+            .append(std::to_string(mMonitorThread.getSecondChanceCount()
+                    + mTimerWheel.getSecondChanceCount()))
             .append(analysisSummary)
             .append("\ntimeout [ ")
             .append(requestsToString(timeoutRequests))
@@ -189,6 +203,7 @@ std::vector<std::shared_ptr<const TimerThread::Request>> TimerThread::getPending
 
     // following are internally locked calls, which add to our local pendingRequests.
     mMonitorThread.copyRequests(pendingRequests);
+    mTimerWheel.copyRequests(pendingRequests);
     mNoTimeoutMap.copyRequests(pendingRequests);
 
     // Sort in order of scheduled time.
@@ -274,6 +289,167 @@ void TimerThread::NoTimeoutMap::copyRequests(
     }
 }
 
+TimerThread::TimerWheel::TimerWheel(RequestQueue& timeoutQueue)
+        : mTimeoutQueue(timeoutQueue)
+        , mThread([this] { threadFunc(); }) {
+     pthread_setname_np(mThread.native_handle(), "TimerWheel");
+     pthread_setschedprio(mThread.native_handle(), PRIORITY_URGENT_AUDIO);
+}
+
+TimerThread::TimerWheel::~TimerWheel() {
+    {
+        std::lock_guard _l(mMutex);
+        mShouldExit = true;
+        mCond.notify_all();
+    }
+    mThread.join();
+}
+
+TimerThread::Handle TimerThread::TimerWheel::tryAdd(
+        std::shared_ptr<const Request>&& request, TimerCallback&& func, Duration timeout) {
+    if (timeout < kWheelMinTimeout) return INVALID_HANDLE;
+    const size_t start = mNextSlot.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < kNumSlots; ++i) {
+        const size_t index = (start + i) & mask_from_count_v<kNumSlots>;
+        Slot& slot = mSlots[index];
+        uint64_t state = slot.state.load(std::memory_order_relaxed);
+        if ((state & kStateMask) != FREE) continue;
+        // Acquire pairs with the releasing FREE store of the previous owner.
+        if (!slot.state.compare_exchange_strong(state, (state & ~kStateMask) | CLAIMED,
+                std::memory_order_acquire, std::memory_order_relaxed)) {
+            continue;
+        }
+        // We own the slot, fill it in and publish with the ARMED store.
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        const Handle handle = makeWheelHandle(index, deadline);
+        slot.request = std::move(request);
+        slot.callback = std::move(func);
+        slot.originalHandle = handle;
+        slot.secondChanceUsed = false;
+        slot.handleCount.store(handle.time_since_epoch().count(), std::memory_order_relaxed);
+        slot.deadlineCount.store(handle.time_since_epoch().count(), std::memory_order_relaxed);
+        // The count is raised before publication so the sweeper cannot
+        // observe it going negative when this entry fires.
+        if (mArmedCount.fetch_add(1, std::memory_order_acq_rel) == 0) {
+            // Idle-to-active edge: wake the parked sweeper.  This is the
+            // only point where arming takes a lock, and under load the
+            // wheel is never empty so it is not taken at all.
+            std::lock_guard _l(mMutex);
+            mCond.notify_all();
+        }
+        slot.state.store((state & ~kStateMask) | ARMED, std::memory_order_release);
+        return handle;
+    }
+    return INVALID_HANDLE;  // ring full, the caller falls back to the MonitorThread.
+}
+
+std::shared_ptr<const TimerThread::Request> TimerThread::TimerWheel::remove(Handle handle) {
+    Slot& slot = mSlots[slotFromHandle(handle)];
+    const int64_t count = handle.time_since_epoch().count();
+    for (;;) {
+        uint64_t state = slot.state.load(std::memory_order_acquire);
+        if (slot.handleCount.load(std::memory_order_relaxed) != count) {
+            return {};  // slot was freed or reused, the entry already fired.
+        }
+        switch (state & kStateMask) {
+        case ARMED:
+            if (!slot.state.compare_exchange_strong(state, (state & ~kStateMask) | CLAIMED,
+                    std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                continue;  // raced with the sweeper or a dump, reevaluate.
+            }
+            break;  // we own the slot.
+        case CLAIMED:
+        case FIRING:
+            // A dump is briefly snapshotting the slot and will restore ARMED,
+            // or the sweeper is applying the second chance (which re-arms) or
+            // firing (which clears handleCount, failing the check above);
+            // an armer filling a reclaimed slot also fails the handleCount check.
+            std::this_thread::yield();
+            continue;
+        default:  // FREE: the slot was released, the entry already executed.
+            return {};
+        }
+        auto request = std::move(slot.request);
+        auto callback = std::move(slot.callback);  // destroyed outside slot ownership.
+        slot.handleCount.store(0, std::memory_order_relaxed);
+        slot.state.store((state & ~kStateMask) + kGenerationIncrement /* FREE, gen + 1 */,
+                std::memory_order_release);
+        mArmedCount.fetch_sub(1, std::memory_order_acq_rel);
+        return request;
+    }
+}
+
+void TimerThread::TimerWheel::copyRequests(
+        std::vector<std::shared_ptr<const Request>>& requests) const {
+    for (Slot& slot : mSlots) {
+        uint64_t state = slot.state.load(std::memory_order_acquire);
+        if ((state & kStateMask) != ARMED) continue;
+        if (!slot.state.compare_exchange_strong(state, (state & ~kStateMask) | CLAIMED,
+                std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            continue;  // the entry is being removed or fired, skip it.
+        }
+        // Brief claim to copy the shared_ptr; a concurrent remove() spins
+        // until the original ARMED state (same generation) is restored.
+        requests.emplace_back(slot.request);
+        slot.state.store(state, std::memory_order_release);
+    }
+}
+
+void TimerThread::TimerWheel::threadFunc() {
+    std::unique_lock _l(mMutex);
+    while (!mShouldExit) {
+        if (mArmedCount.load(std::memory_order_acquire) == 0) {
+            mCond.wait(_l);
+            continue;
+        }
+        mCond.wait_for(_l, kWheelSweepPeriod);
+        if (mShouldExit) break;
+        _l.unlock();
+        sweep();
+        _l.lock();
+    }
+}
+
+void TimerThread::TimerWheel::sweep() {
+    const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+    for (Slot& slot : mSlots) {
+        uint64_t state = slot.state.load(std::memory_order_acquire);
+        if ((state & kStateMask) != ARMED) continue;
+        if (slot.deadlineCount.load(std::memory_order_relaxed) >= now) continue;
+        if (!slot.state.compare_exchange_strong(state, (state & ~kStateMask) | FIRING,
+                std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            continue;  // cancelled (or dumped) just in time.
+        }
+        // We own the slot: apply the second chance, or fire the entry.
+        if (slot.request->secondChanceDuration.count() != 0 && !slot.secondChanceUsed) {
+            // As for the MonitorThread, the second chance prevents a false
+            // timeout should there be any clock monotonic advancement
+            // during suspend.  The handle is unchanged so the entry
+            // remains cancellable.
+            slot.secondChanceUsed = true;
+            slot.deadlineCount.store(now + slot.request->secondChanceDuration.count(),
+                    std::memory_order_relaxed);
+            mSecondChanceCount.fetch_add(1 /* arg */, std::memory_order_relaxed);
+            ALOGD("%s: TimeCheck second chance applied for %s",
+                    __func__, slot.request->tag.c_str()); // should be rare event.
+            slot.state.store((state & ~kStateMask) | ARMED, std::memory_order_release);
+            continue;
+        }
+        auto request = std::move(slot.request);
+        auto callback = std::move(slot.callback);
+        const Handle originalHandle = slot.originalHandle;
+        slot.handleCount.store(0, std::memory_order_relaxed);
+        slot.state.store((state & ~kStateMask) + kGenerationIncrement /* FREE, gen + 1 */,
+                std::memory_order_release);
+        mArmedCount.fetch_sub(1, std::memory_order_acq_rel);
+        // We add Request to the timeout queue early so that it can be dumped out.
+        mTimeoutQueue.add(std::move(request));
+        callback(originalHandle);
+        // Caution: as for the MonitorThread, the callback may abort in the
+        // timeout case, maybe before returning.
+    }
+}
+
 TimerThread::MonitorThread::MonitorThread(RequestQueue& timeoutQueue)
         : mTimeoutQueue(timeoutQueue)
         , mThread([this] { threadFunc(); }) {
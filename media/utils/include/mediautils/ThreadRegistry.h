@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sched.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <android-base/thread_annotations.h>
+
+namespace android::mediautils {
+
+/**
+ * ThreadRegistry tags media pipeline threads by role and applies a
+ * per-role placement policy (CPU affinity and utilization clamps).
+ *
+ * Media subsystems spawn their threads with default affinity, which
+ * lets the scheduler bounce latency-critical feeders onto little cores
+ * on asymmetric SoCs.  Subsystems register their threads here under a
+ * role string (e.g. "fastmixer", "codec_looper", "writer"); the policy
+ * for a role comes from device-profile system properties:
+ *
+ *   media.threadpolicy.<role>.cpus        e.g. "4-7" or "0,2,4"
+ *   media.threadpolicy.<role>.uclamp_min  0-1024
+ *   media.threadpolicy.<role>.uclamp_max  0-1024
+ *
+ * Roles with no properties set are recorded but left untouched, so the
+ * registry is a no-op on devices without a profile.  Every placement
+ * decision (the mask and clamps applied, or why nothing was applied)
+ * is retained for dumpsys.
+ */
+class ThreadRegistry {
+public:
+    struct Policy {
+        bool hasCpuSet = false;
+        cpu_set_t cpuSet{};
+        int32_t uclampMin = -1;  // -1: not set
+        int32_t uclampMax = -1;
+
+        bool empty() const { return !hasCpuSet && uclampMin < 0 && uclampMax < 0; }
+    };
+
+    /**
+     * Registers the thread and applies the policy for its role.
+     *
+     * \param role  policy key, lowercase by convention (e.g. "fastmixer").
+     * \param name  thread name for dumpsys.
+     * \param tid   thread to place, or -1 for the calling thread.
+     * \return true if a policy was found and fully applied.
+     */
+    bool registerThread(const std::string& role, const std::string& name, pid_t tid = -1);
+
+    /**
+     * Removes the thread's record; does not restore the default placement.
+     */
+    void unregisterThread(pid_t tid);
+
+    /**
+     * Overrides the policy for a role, taking precedence over the
+     * device-profile properties.  Used by tests and for local experiments.
+     */
+    void setPolicyOverride(const std::string& role, const Policy& policy);
+
+    /**
+     * Returns one line per registered thread with the decision taken.
+     */
+    std::string dump() const;
+
+    /**
+     * Parses a kernel-style cpu list ("0-3,6") into a cpu_set_t.
+     * Returns false on malformed input.
+     */
+    static bool parseCpuList(const std::string& list, cpu_set_t* cpuSet);
+
+    /** Returns the process-wide registry. */
+    static ThreadRegistry& getInstance();
+
+private:
+    Policy policyForRole_l(const std::string& role) const REQUIRES(mLock);
+
+    struct Registration {
+        std::string role;
+        std::string name;
+        std::string decision;  // human readable, for dumpsys.
+        bool applied = false;
+    };
+
+    mutable std::mutex mLock;
+    std::map<pid_t, Registration> mThreads GUARDED_BY(mLock);
+    std::map<std::string, Policy> mPolicyOverrides GUARDED_BY(mLock);
+};
+
+} // namespace android::mediautils
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <deque>
@@ -51,8 +52,9 @@ class TimerThread {
     // A Handle represents the timer expiration time based on std::chrono::steady_clock
     // (clock monotonic).  This Handle is computed as now() + timeout.
     //
-    // The lsb of the Handle time_point is adjusted to indicate whether there is
-    // a timeout action (1) or not (0).
+    // The lsbs of the Handle time_point are adjusted to indicate which
+    // container holds the request: the NoTimeoutMap (no timeout action),
+    // the TimerWheel (lock-free fast path) or the MonitorThread.
     //
 
     template <size_t COUNT>
@@ -61,7 +63,7 @@ class TimerThread {
     template <size_t COUNT>
     static constexpr size_t mask_from_count_v = COUNT - 1;
 
-    static constexpr size_t HANDLE_TYPES = 2;
+    static constexpr size_t HANDLE_TYPES = 4;
     // HANDLE_TYPES must be a power of 2.
     static_assert(is_power_of_2_v<HANDLE_TYPES>);
 
@@ -69,6 +71,7 @@ class TimerThread {
     enum class HANDLE_TYPE : size_t {
         NO_TIMEOUT = 0,
         TIMEOUT = 1,
+        WHEEL = 2,
     };
 
     static constexpr size_t HANDLE_TYPE_MASK = mask_from_count_v<HANDLE_TYPES>;
@@ -88,6 +91,11 @@ class TimerThread {
                 enum_as_value(HANDLE_TYPE::TIMEOUT);
     }
 
+    static inline bool isWheelHandle(Handle handle) {
+        return (handle.time_since_epoch().count() & HANDLE_TYPE_MASK) ==
+                enum_as_value(HANDLE_TYPE::WHEEL);
+    }
+
     // Returns a unique Handle that doesn't exist in the container.
     template <size_t MAX_TYPED_HANDLES, size_t HANDLE_TYPE_AS_VALUE, typename C, typename T>
     static Handle getUniqueHandleForHandleType_l(C container, T timeout) {
@@ -116,6 +124,12 @@ class TimerThread {
     // TimerCallback invoked on timeout or cancel.
     using TimerCallback = std::function<void(Handle)>;
 
+    // TimerWheel fast path constants (see TimerWheel below).  Requests with
+    // a timeout of at least kWheelMinTimeout are armed lock-free on the
+    // wheel and may expire late by up to one sweep period.
+    static constexpr Duration kWheelSweepPeriod = std::chrono::milliseconds(100);
+    static constexpr Duration kWheelMinTimeout = kWheelSweepPeriod * 10;
+
     /**
      * Schedules a task to be executed in the future (`timeout` duration from now).
      *
@@ -272,6 +286,106 @@ class TimerThread {
         void copyRequests(std::vector<std::shared_ptr<const Request>>& requests) const;
     };
 
+    // A fixed-size ring of timer slots with lock-free arm and disarm
+    // in the common non-expiring case.
+    //
+    // TimeCheck arms a watchdog around every monitored binder call, so
+    // audioserver may arm and disarm thousands of timers per second,
+    // nearly all of which are cancelled before they expire.  Funneling
+    // those through the MonitorThread mutex makes the watchdog itself
+    // visible in profiles.  The TimerWheel arms by claiming a free slot
+    // with a single compare-exchange and disarms by releasing it the
+    // same way; a sweeper thread scans the ring at a coarse period
+    // (kSweepPeriod) and fires expired entries.
+    //
+    // Because the sweep is periodic, expiry may be late by up to one
+    // sweep period.  Watchdog timeouts are seconds, so only requests
+    // with a timeout of at least kWheelMinTimeout are accepted here;
+    // shorter timeouts (and overflow, should the ring fill up) take the
+    // exact MonitorThread path.
+    // This class is thread-safe.
+    class TimerWheel {
+      public:
+        static constexpr size_t kNumSlots = 64;
+        static_assert(is_power_of_2_v<kNumSlots>);
+
+        explicit TimerWheel(RequestQueue& timeoutQueue);
+        ~TimerWheel();
+
+        // Returns INVALID_HANDLE if the timeout is below kMinTimeout or
+        // no free slot is available; request and func are moved-from only
+        // on success, so the caller may fall back to the MonitorThread.
+        Handle tryAdd(std::shared_ptr<const Request>&& request, TimerCallback&& func,
+                Duration timeout);
+        std::shared_ptr<const Request> remove(Handle handle);
+        void copyRequests(std::vector<std::shared_ptr<const Request>>& requests) const;
+        size_t getSecondChanceCount() const {
+            return mSecondChanceCount.load(std::memory_order_relaxed);
+        }
+
+      private:
+        // Slot lifecycle, kept in the low bits of Slot::state with a
+        // generation counter in the bits above to prevent A-B-A between
+        // a stale handle and a reused slot:
+        //   FREE -> CLAIMED (an armer, or briefly a dump, owns the fields)
+        //        -> ARMED   (visible to the sweeper and to remove())
+        //        -> FIRING  (the sweeper owns it; a second chance re-arms,
+        //                    otherwise the entry fires)
+        //        -> FREE    (generation + 1)
+        enum State : uint64_t { FREE, CLAIMED, ARMED, FIRING };
+        static constexpr uint64_t kStateMask = 3;
+        static constexpr uint64_t kGenerationIncrement = 4;
+
+        struct Slot {
+            std::atomic<uint64_t> state{FREE};
+            std::atomic<int64_t> handleCount{0};   // identifies the entry for remove().
+            std::atomic<int64_t> deadlineCount{0}; // steady_clock count, read by the sweeper.
+            // The fields below are written only by the owner of the slot
+            // (CLAIMED or FIRING); publication is through the state transitions.
+            std::shared_ptr<const Request> request;
+            TimerCallback callback;
+            Handle originalHandle{};  // passed to the callback, as for MonitorThread.
+            bool secondChanceUsed = false;
+        };
+
+        // The slot index is encoded in the Handle bits directly above the
+        // HANDLE_TYPE, so remove() finds its slot without searching.  This
+        // changes the deadline the Handle represents by under a microsecond,
+        // which is insignificant against watchdog timeouts.
+        static Handle makeWheelHandle(size_t slot, Handle deadline) {
+            auto count = deadline.time_since_epoch().count();
+            count = (count & ~static_cast<int64_t>(kNumSlots * HANDLE_TYPES - 1))
+                    | static_cast<int64_t>(slot * HANDLE_TYPES)
+                    | enum_as_value(HANDLE_TYPE::WHEEL);
+            return Handle(Handle::duration(count));
+        }
+        static size_t slotFromHandle(Handle handle) {
+            return (handle.time_since_epoch().count() / HANDLE_TYPES)
+                    & mask_from_count_v<kNumSlots>;
+        }
+
+        void threadFunc();
+        void sweep();
+
+        // mutable: dumping briefly claims each armed slot to copy its request.
+        mutable std::array<Slot, kNumSlots> mSlots;
+        std::atomic<size_t> mNextSlot{0};  // round robin starting slot for tryAdd().
+        std::atomic<size_t> mArmedCount{0};
+        std::atomic<size_t> mSecondChanceCount{0};
+
+        RequestQueue& mTimeoutQueue; // locked internally, added to when request times out.
+
+        // The sweeper parks here while the wheel is empty; arming an empty
+        // wheel is the only time tryAdd() takes this lock.
+        mutable std::mutex mMutex;
+        std::condition_variable mCond GUARDED_BY(mMutex);
+        bool mShouldExit GUARDED_BY(mMutex) = false;
+
+        // To avoid race with initialization,
+        // mThread should be initialized last as the thread is launched immediately.
+        std::thread mThread;
+    };
+
     // Monitor thread.
     // This thread manages shared pointers to Requests and a function to
     // call on timeout.
@@ -366,9 +480,11 @@ class TimerThread {
 
     NoTimeoutMap mNoTimeoutMap;  // locked internally
 
-    MonitorThread mMonitorThread{mTimeoutQueue};  // This should be initialized last because
-                                                  // the thread is launched immediately.
-                                                  // Locked internally.
+    // The TimerWheel and MonitorThread should be initialized last because
+    // their threads are launched immediately.
+    TimerWheel mTimerWheel{mTimeoutQueue};        // Lock-free fast path.
+
+    MonitorThread mMonitorThread{mTimeoutQueue};  // Locked internally.
 };
 
 }  // namespace android::mediautils
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mediautils/ThreadRegistry.h>
+
+#define LOG_TAG "media_threadregistry_tests"
+
+#include <gtest/gtest.h>
+#include <utils/Log.h>
+
+using namespace android;
+using namespace android::mediautils;
+
+TEST(media_threadregistry_tests, parseCpuList) {
+  cpu_set_t cpuSet;
+
+  ASSERT_TRUE(ThreadRegistry::parseCpuList("0", &cpuSet));
+  EXPECT_EQ(1, CPU_COUNT(&cpuSet));
+  EXPECT_TRUE(CPU_ISSET(0, &cpuSet));
+
+  ASSERT_TRUE(ThreadRegistry::parseCpuList("0-3,6", &cpuSet));
+  EXPECT_EQ(5, CPU_COUNT(&cpuSet));
+  EXPECT_TRUE(CPU_ISSET(2, &cpuSet));
+  EXPECT_TRUE(CPU_ISSET(6, &cpuSet));
+  EXPECT_FALSE(CPU_ISSET(4, &cpuSet));
+
+  EXPECT_FALSE(ThreadRegistry::parseCpuList("", &cpuSet));
+  EXPECT_FALSE(ThreadRegistry::parseCpuList("4-2", &cpuSet));
+  EXPECT_FALSE(ThreadRegistry::parseCpuList("cats", &cpuSet));
+}
+
+TEST(media_threadregistry_tests, registerWithoutPolicy) {
+  ThreadRegistry registry;
+
+  // no properties and no override: recorded, untouched.
+  EXPECT_FALSE(registry.registerThread("no_such_role", "worker"));
+  const std::string dump = registry.dump();
+  EXPECT_NE(dump.find("no_such_role"), std::string::npos);
+  EXPECT_NE(dump.find("no policy for role"), std::string::npos);
+
+  registry.unregisterThread(-1 /* calling thread */);
+  EXPECT_EQ(registry.dump().find("no_such_role"), std::string::npos);
+}
+
+TEST(media_threadregistry_tests, policyOverrideAffinity) {
+  ThreadRegistry registry;
+
+  // restrict the calling thread to its current CPU, which must be allowed.
+  ThreadRegistry::Policy policy;
+  CPU_ZERO(&policy.cpuSet);
+  CPU_SET(sched_getcpu(), &policy.cpuSet);
+  policy.hasCpuSet = true;
+  registry.setPolicyOverride("pinned", policy);
+
+  EXPECT_TRUE(registry.registerThread("pinned", "self"));
+  const std::string dump = registry.dump();
+  EXPECT_NE(dump.find("applied(yes)"), std::string::npos);
+
+  cpu_set_t current;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(current), &current));
+  EXPECT_EQ(1, CPU_COUNT(&current));
+}
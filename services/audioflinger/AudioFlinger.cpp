@@ -81,6 +81,7 @@
 #include <mediautils/MemoryLeakTrackUtil.h>
 #include <mediautils/MethodStatistics.h>
 #include <mediautils/ServiceUtilities.h>
+#include <mediautils/ThreadRegistry.h>
 #include <mediautils/TimeCheck.h>
 #include <private/android_filesystem_config.h>
 
@@ -162,6 +163,7 @@ static sp<os::IExternalVibratorService> getExternalVibratorService() {
 // Creates association between Binder code to name for IAudioFlinger.
 #define IAUDIOFLINGER_BINDER_METHOD_MACRO_LIST \
 BINDER_METHOD_ENTRY(createTrack) \
+BINDER_METHOD_ENTRY(createTracks) \
 BINDER_METHOD_ENTRY(createRecord) \
 BINDER_METHOD_ENTRY(sampleRate) \
 BINDER_METHOD_ENTRY(format) \
@@ -307,6 +309,7 @@ void AudioFlinger::instantiate() {
 
 AudioFlinger::AudioFlinger()
     : mMediaLogNotifier(new AudioFlinger::MediaLogNotifier()),
+      mTrackReaper(new AudioFlinger::TrackReaper()),
       mPrimaryHardwareDev(NULL),
       mAudioHwDevs(NULL),
       mHardwareStatus(AUDIO_HW_IDLE),
@@ -363,6 +366,7 @@ AudioFlinger::AudioFlinger()
     mEffectsFactoryHal = EffectsFactoryHalInterface::create();
 
     mMediaLogNotifier->run("MediaLogNotifier");
+    mTrackReaper->run("TrackReaper", PRIORITY_BACKGROUND);
     std::vector<pid_t> halPids;
     mDevicesFactoryHal->getHalPids(&halPids);
     mediautils::TimeCheck::setAudioHalPids(halPids);
@@ -757,6 +761,7 @@ void AudioFlinger::dumpClients(int fd, const Vector<String16>& args __unused)
         if (client != 0) {
             result.appendFormat("%6d %12zu\n", client->pid(),
                     client->heap()->getMemoryHeap()->getSize());
+            client->dumpTrackMemory(result);
         }
     }
 
@@ -905,6 +910,10 @@ NO_THREAD_SAFETY_ANALYSIS  // conditional try lock
                 audio_utils_get_real_time_ns() - 10 * 60 * NANOS_PER_SECOND);
         write(fd, threadLog.c_str(), threadLog.size());
 
+        // placement decisions for registered pipeline threads
+        const std::string registryDump = mediautils::ThreadRegistry::getInstance().dump();
+        write(fd, registryDump.c_str(), registryDump.size());
+
         BUFLOG_RESET;
 
         if (locked) {
@@ -1261,6 +1270,27 @@ Exit:
     return lStatus;
 }
 
+status_t AudioFlinger::createTracks(const std::vector<media::CreateTrackRequest>& inputs,
+                                    std::vector<media::CreateTrackResponse>* outputs,
+                                    std::vector<status_t>* statuses)
+{
+    // The win of the batch is a single binder transaction (and a single
+    // TimeCheck/statistics scope) for the whole group instead of one
+    // round-trip per track.  Each track still registers individually with
+    // audio policy inside createTrack(), as every client must obtain its own
+    // port handle for routing, volume and release; getOutputForAttr() itself
+    // serves repeated attribute lookups from the audio policy config cache.
+    outputs->clear();
+    outputs->resize(inputs.size());
+    statuses->assign(inputs.size(), NO_INIT);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        (*statuses)[i] = createTrack(inputs[i], (*outputs)[i]);
+        ALOGW_IF((*statuses)[i] != NO_ERROR, "%s: track %zu of %zu failed with status %d",
+                __func__, i, inputs.size(), (*statuses)[i]);
+    }
+    return NO_ERROR;
+}
+
 uint32_t AudioFlinger::sampleRate(audio_io_handle_t ioHandle) const
 {
     Mutex::Autolock _l(mLock);
@@ -2290,6 +2320,62 @@ sp<MemoryDealer> AudioFlinger::Client::heap() const
     return mMemoryDealer;
 }
 
+/* static */
+size_t AudioFlinger::Client::trackMemoryClassIndex(size_t size)
+{
+    size_t index = 0;
+    while ((kTrackMemoryMinClassSize << index) < size && index < kTrackMemoryNumClasses - 1) {
+        index++;
+    }
+    return index;
+}
+
+sp<IMemory> AudioFlinger::Client::allocateTrackMemory(size_t size)
+{
+    const size_t index = trackMemoryClassIndex(size);
+    const size_t classSize = kTrackMemoryMinClassSize << index;
+    // Requests larger than the top size class fall through to the dealer unrounded.
+    const size_t allocSize = size <= classSize ? classSize : size;
+    sp<IMemory> memory = mMemoryDealer->allocate(allocSize);
+    if (memory != 0) {
+        Mutex::Autolock _l(mTrackMemoryLock);
+        mTrackMemoryLiveCount[index]++;
+        mTrackMemoryTotalCount[index]++;
+        mTrackMemoryRequestedBytes += size;
+        mTrackMemoryAllocatedBytes += allocSize;
+    }
+    return memory;
+}
+
+void AudioFlinger::Client::releaseTrackMemory(size_t size)
+{
+    const size_t index = trackMemoryClassIndex(size);
+    Mutex::Autolock _l(mTrackMemoryLock);
+    if (mTrackMemoryLiveCount[index] > 0) {
+        mTrackMemoryLiveCount[index]--;
+    }
+}
+
+void AudioFlinger::Client::dumpTrackMemory(String8& result) const
+{
+    Mutex::Autolock _l(mTrackMemoryLock);
+    if (mTrackMemoryAllocatedBytes == 0) {
+        return;
+    }
+    result.appendFormat("    track memory: requested %llu, allocated %llu bytes (%.1f%% slack)\n",
+            (unsigned long long)mTrackMemoryRequestedBytes,
+            (unsigned long long)mTrackMemoryAllocatedBytes,
+            100.f * (mTrackMemoryAllocatedBytes - mTrackMemoryRequestedBytes)
+                    / mTrackMemoryAllocatedBytes);
+    for (size_t i = 0; i < kTrackMemoryNumClasses; ++i) {
+        if (mTrackMemoryTotalCount[i] != 0) {
+            result.appendFormat("      class %7zu bytes: live %u / total %llu\n",
+                    kTrackMemoryMinClassSize << i, mTrackMemoryLiveCount[i],
+                    (unsigned long long)mTrackMemoryTotalCount[i]);
+        }
+    }
+}
+
 // ----------------------------------------------------------------------------
 
 AudioFlinger::NotificationClient::NotificationClient(const sp<AudioFlinger>& audioFlinger,
@@ -2348,6 +2434,37 @@ void AudioFlinger::requestLogMerge() {
 
 // ----------------------------------------------------------------------------
 
+void AudioFlinger::TrackReaper::reap(Vector<sp<RefBase>> *refs) {
+    if (refs->isEmpty()) {
+        return;
+    }
+    AutoMutex _l(mMutex);
+    mRefs.appendVector(*refs);
+    refs->clear();
+    mCond.signal();
+}
+
+bool AudioFlinger::TrackReaper::threadLoop() {
+    Vector<sp<RefBase>> refs;
+    {
+        AutoMutex _l(mMutex);
+        while (mRefs.isEmpty() && !exitPending()) {
+            mCond.wait(mMutex);
+        }
+        if (exitPending()) {
+            return false;
+        }
+        refs = mRefs;
+        mRefs.clear();
+    }
+    // Releasing the references here runs the track destructors for all
+    // references that were dropped everywhere else in the meantime.
+    refs.clear();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
 status_t AudioFlinger::createRecord(const media::CreateRecordRequest& _input,
                                     media::CreateRecordResponse& _output)
 {
@@ -4718,6 +4835,7 @@ status_t AudioFlinger::onTransactWrapper(TransactionCode code,
     // TODO should select more wisely the items from the list
     switch (code) {
         case TransactionCode::CREATE_TRACK:
+        case TransactionCode::CREATE_TRACKS:
         case TransactionCode::CREATE_RECORD:
         case TransactionCode::SET_MASTER_VOLUME:
         case TransactionCode::SET_MASTER_MUTE:
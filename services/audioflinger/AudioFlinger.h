@@ -88,6 +88,7 @@
 #include "FastMixer.h"
 #include <media/nbaio/NBAIO.h>
 #include "AudioWatchdog.h"
+#include "CommandQueue.h"
 #include "AudioStreamOut.h"
 #include "SpdifStreamOut.h"
 #include "AudioHwDevice.h"
@@ -144,6 +145,10 @@ public:
     status_t createTrack(const media::CreateTrackRequest& input,
                          media::CreateTrackResponse& output) override;
 
+    status_t createTracks(const std::vector<media::CreateTrackRequest>& inputs,
+                          std::vector<media::CreateTrackResponse>* outputs,
+                          std::vector<status_t>* statuses) override;
+
     status_t createRecord(const media::CreateRecordRequest& input,
                           media::CreateRecordResponse& output) override;
 
@@ -511,15 +516,33 @@ private:
                             Client(const sp<AudioFlinger>& audioFlinger, pid_t pid);
         virtual             ~Client();
         sp<MemoryDealer>    heap() const;
+        // Track shared memory (control block + audio buffer) is carved from the
+        // client heap in power-of-two size classes, so that a slot freed by a
+        // finished track is reused exactly by a later one instead of slowly
+        // fragmenting the dealer's free list.
+        sp<IMemory>         allocateTrackMemory(size_t size);
+        // Called by ~TrackBase with the size of the IMemory being released.
+        void                releaseTrackMemory(size_t size);
+        void                dumpTrackMemory(String8& result) const;
         pid_t               pid() const { return mPid; }
         sp<AudioFlinger>    audioFlinger() const { return mAudioFlinger; }
 
     private:
         DISALLOW_COPY_AND_ASSIGN(Client);
 
+        static constexpr size_t kTrackMemoryMinClassSize = 256;
+        static constexpr size_t kTrackMemoryNumClasses = 16;   // 256 B .. 8 MiB
+        static size_t       trackMemoryClassIndex(size_t size);
+
         const sp<AudioFlinger> mAudioFlinger;
               sp<MemoryDealer> mMemoryDealer;
         const pid_t         mPid;
+
+        mutable Mutex       mTrackMemoryLock;
+        uint32_t            mTrackMemoryLiveCount[kTrackMemoryNumClasses] = {};
+        uint64_t            mTrackMemoryTotalCount[kTrackMemoryNumClasses] = {};
+        uint64_t            mTrackMemoryRequestedBytes = 0; // cumulative, before rounding
+        uint64_t            mTrackMemoryAllocatedBytes = 0; // cumulative, after rounding
     };
 
     // --- Notification Client ---
@@ -580,6 +603,35 @@ private:
     // Requests media.log to start merging log buffers
     void requestLogMerge();
 
+    // --- TrackReaper ---
+    // Low priority thread performing the final release of track references
+    // dropped by the time critical playback threads. The track destructors
+    // unmap the cblk shared memory and tear down the proxies, which is too
+    // slow for an audio cycle, notably when a client has died.
+    class TrackReaper : public Thread {
+    public:
+        TrackReaper() {}
+
+        // Transfers the references to the reaper thread, which releases them
+        // in batches. On return *refs is empty.
+        void reap(Vector<sp<RefBase>> *refs);
+    private:
+        virtual bool threadLoop() override;
+
+        // Pending references, released on the reaper thread.
+        Vector<sp<RefBase>> mRefs;
+
+        // Mutex and condition variable around mRefs
+        Mutex       mMutex;
+        Condition   mCond;
+    };
+
+    const sp<TrackReaper> mTrackReaper;
+
+    // Called by playback threads at the end of a cycle to hand off the final
+    // release of removed tracks.
+    void reapTracks(Vector<sp<RefBase>> *refs) { mTrackReaper->reap(refs); }
+
     class TrackHandle;
     class RecordHandle;
     class RecordThread;
@@ -733,6 +785,8 @@ using effect_buffer_t = int16_t;
         // MmapStreamInterface virtuals
         virtual status_t createMmapBuffer(int32_t minSizeFrames,
                                           struct audio_mmap_buffer_info *info);
+        virtual status_t resizeMmapBuffer(int32_t minSizeFrames,
+                                          struct audio_mmap_buffer_info *info);
         virtual status_t getMmapPosition(struct audio_mmap_position *position);
         virtual status_t getExternalPosition(uint64_t *position, int64_t *timeNanos);
         virtual status_t start(const AudioClient& client,
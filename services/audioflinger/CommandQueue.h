@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_COMMAND_QUEUE_H
+#define ANDROID_AUDIO_COMMAND_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <utility>
+
+// The command queue template class complements StateQueue (see StateQueue.h):
+// where StateQueue publishes a single coherent snapshot from one mutator to one
+// observer, CommandQueue carries discrete commands from many producers to the
+// thread that owns the consumer side.  It was driven by this use case:
+//  Producers are binder threads posting configuration mutations (track churn,
+//  parameter changes, effect chain changes) toward a mixer thread:
+//      must never block on a lock that can be held by the consumer,
+//        as that inverts priority against the mixer thread
+//      push() is therefore lock-free, and fails rather than waits
+//        when the ring is full; the caller falls back to its locked path
+//  Consumer is a mixer (or record) thread:
+//      drains at cycle boundaries; pop() is lock-free and never waits
+//      fixed capacity, no allocation or free after construction
+//
+// The implementation is a bounded MPMC ring buffer with per-slot sequence
+// numbers (after D. Vyukov).  Each slot's sequence number tells whether the
+// slot is free for the producers' current lap or holds data for the consumers'
+// current lap, so both sides claim slots with a single compare-exchange on
+// their own cursor and never touch a shared lock.
+
+namespace android {
+
+template <typename T, size_t N = 32>
+class CommandQueue {
+    static_assert((N & (N - 1)) == 0, "N must be a power of 2");
+
+public:
+    CommandQueue() {
+        for (size_t i = 0; i < N; i++) {
+            mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Attempt to enqueue a command without blocking.
+    // Returns true on success, or false if the queue is full.
+    bool push(const T& value) {
+        size_t pos = mPushPos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = mSlots[pos & (N - 1)];
+            const size_t seq = slot.mSequence.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (mPushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.mValue = value;
+                    slot.mSequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // CAS lost to another producer; pos was reloaded by the CAS.
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = mPushPos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Attempt to dequeue a command without blocking.
+    // Returns true and sets *value on success, or false if the queue is empty.
+    bool pop(T* value) {
+        size_t pos = mPopPos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = mSlots[pos & (N - 1)];
+            const size_t seq = slot.mSequence.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (mPopPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    *value = std::move(slot.mValue);
+                    slot.mValue = T();  // drop references held by the slot
+                    slot.mSequence.store(pos + N, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = mPopPos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate emptiness check.  Safe as a sleep predicate only if the
+    // consumer also rechecks on a periodic timeout, as the thread loops do.
+    bool empty() const {
+        return mPushPos.load(std::memory_order_acquire)
+                == mPopPos.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> mSequence;
+        T mValue;
+    };
+
+    // Cursors on separate cache lines to avoid false sharing between the
+    // producing binder threads and the owning thread.
+    alignas(64) std::atomic<size_t> mPushPos{0};
+    alignas(64) std::atomic<size_t> mPopPos{0};
+    alignas(64) Slot mSlots[N];
+};
+
+}   // namespace android
+
+#endif  // ANDROID_AUDIO_COMMAND_QUEUE_H
@@ -228,6 +228,11 @@ public:
     virtual ~EffectModule();
 
     void process();
+    // Lock-free check called by EffectChain::process_l() on the audio thread to decide
+    // whether process() would be a no-op this cycle, so idle effects cost one branch
+    // instead of a mutex acquisition per cycle.  See comment on the implementation for
+    // why the unlocked reads are safe.
+    bool processSkippable() const;
     bool updateState();
     status_t command(int32_t cmdCode,
                      const std::vector<uint8_t>& cmdData,
@@ -73,6 +73,23 @@ void FastMixerDumpState::dump(int fd) const
                 mSampleRate, mFrameCount, measuredWarmupMs, mWarmupCycles,
                 mixPeriodSec * 1e3, mLatencyMs);
     dprintf(fd, "  FastMixer Timestamp stats: %s\n", mTimestampVerifier.toString().c_str());
+    // always-on histograms of cycle wall clock time and CPU load, one line per non-empty
+    // power-of-two microsecond bucket; counters are cumulative since thread creation
+    uint64_t histTotal = 0;
+    for (uint32_t i = 0; i < kCycleHistN; ++i) {
+        histTotal += mCycleTimeHist[i];
+    }
+    if (histTotal > 0) {
+        dprintf(fd, "  Histograms of mix cycle times over %llu total cycles (us : wall / load):\n",
+                (unsigned long long)histTotal);
+        for (uint32_t i = 0; i < kCycleHistN; ++i) {
+            if (mCycleTimeHist[i] != 0 || mCycleLoadHist[i] != 0) {
+                dprintf(fd, "    [%8u, %8u) : %9u / %9u\n",
+                        i == 0 ? 0 : 1u << i, i == 31 ? UINT32_MAX : 1u << (i + 1),
+                        mCycleTimeHist[i], mCycleLoadHist[i]);
+            }
+        }
+    }
 #ifdef FAST_THREAD_STATISTICS
     // find the interval of valid samples
     const uint32_t bounds = mBounds;
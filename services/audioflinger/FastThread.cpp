@@ -54,9 +54,9 @@ FastThread::FastThread(const char *cycleMs, const char *loadUs) : Thread(false /
     mDummyDumpState(NULL),
     mDumpState(NULL),
     mIgnoreNextOverrun(true),
-#ifdef FAST_THREAD_STATISTICS
     // mOldLoad
     mOldLoadValid(false),
+#ifdef FAST_THREAD_STATISTICS
     mBounds(0),
     mFull(false),
     // mTcu
@@ -139,9 +139,7 @@ bool FastThread::threadLoop()
                 if (mCommand & FastThreadState::IDLE) {
                     onIdle();
                     mOldTsValid = false;
-#ifdef FAST_THREAD_STATISTICS
                     mOldLoadValid = false;
-#endif
                     mIgnoreNextOverrun = true;
                 }
                 mPrevious = mCurrent;
@@ -295,17 +293,7 @@ bool FastThread::threadLoop()
                         mIgnoreNextOverrun = false;
                     }
                 }
-#ifdef FAST_THREAD_STATISTICS
                 if (mIsWarm) {
-                    // advance the FIFO queue bounds
-                    size_t i = mBounds & (mDumpState->mSamplingN - 1);
-                    mBounds = (mBounds & 0xFFFF0000) | ((mBounds + 1) & 0xFFFF);
-                    if (mFull) {
-                        //mBounds += 0x10000;
-                        __builtin_add_overflow(mBounds, 0x10000, &mBounds);
-                    } else if (!(mBounds & (mDumpState->mSamplingN - 1))) {
-                        mFull = true;
-                    }
                     // compute the delta value of clock_gettime(CLOCK_MONOTONIC)
                     uint32_t monotonicNs = nsec;
                     if (sec > 0 && sec < 4) {
@@ -333,6 +321,22 @@ bool FastThread::threadLoop()
                         }
                         mOldLoad = newLoad;
                     }
+                    // update the always-on histograms; single writer, plain word-sized
+                    // increments, same access rules as the rest of the dump state
+                    mDumpState->mCycleTimeHist[
+                            FastThreadDumpState::histogramBucket(monotonicNs)]++;
+                    mDumpState->mCycleLoadHist[
+                            FastThreadDumpState::histogramBucket(loadNs)]++;
+#ifdef FAST_THREAD_STATISTICS
+                    // advance the FIFO queue bounds
+                    size_t i = mBounds & (mDumpState->mSamplingN - 1);
+                    mBounds = (mBounds & 0xFFFF0000) | ((mBounds + 1) & 0xFFFF);
+                    if (mFull) {
+                        //mBounds += 0x10000;
+                        __builtin_add_overflow(mBounds, 0x10000, &mBounds);
+                    } else if (!(mBounds & (mDumpState->mSamplingN - 1))) {
+                        mFull = true;
+                    }
 #ifdef CPU_FREQUENCY_STATISTICS
                     // get the absolute value of CPU clock frequency in kHz
                     int cpuNum = sched_getcpu();
@@ -351,10 +355,10 @@ bool FastThread::threadLoop()
                     // this store #4 is not atomic with respect to stores #1, #2, #3 above, but
                     // the newest open & oldest closed halves are atomic with respect to each other
                     mDumpState->mBounds = mBounds;
+#endif
                     ATRACE_INT(mCycleMs, monotonicNs / 1000000);
                     ATRACE_INT(mLoadUs, loadNs / 1000);
                 }
-#endif
             } else {
                 // first time through the loop
                 mOldTsValid = true;
@@ -66,9 +66,9 @@ protected:
     FastThreadDumpState* mDumpState;
     bool            mIgnoreNextOverrun;     // used to ignore initial overrun and first after an
                                             // underrun
-#ifdef FAST_THREAD_STATISTICS
     struct timespec mOldLoad;       // previous value of clock_gettime(CLOCK_THREAD_CPUTIME_ID)
     bool            mOldLoadValid;  // whether oldLoad is valid
+#ifdef FAST_THREAD_STATISTICS
     uint32_t        mBounds;
     bool            mFull;          // whether we have collected at least mSamplingN samples
 #ifdef CPU_FREQUENCY_STATISTICS
@@ -29,6 +29,8 @@ FastThreadDumpState::FastThreadDumpState() :
 {
     mMeasuredWarmupTs.tv_sec = 0;
     mMeasuredWarmupTs.tv_nsec = 0;
+    memset(mCycleTimeHist, 0, sizeof(mCycleTimeHist));
+    memset(mCycleLoadHist, 0, sizeof(mCycleLoadHist));
 #ifdef FAST_THREAD_STATISTICS
     increaseSamplingN(1);
 #endif
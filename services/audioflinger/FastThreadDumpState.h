@@ -38,6 +38,21 @@ struct FastThreadDumpState {
     struct timespec mMeasuredWarmupTs;  // measured warmup time
     uint32_t mWarmupCycles;     // number of loop cycles required to warmup
 
+    // Always-on histograms of per-cycle wall clock time and CPU load, with one bucket per
+    // power-of-two microseconds.  Unlike the sampling arrays below, these are cheap enough
+    // to maintain unconditionally in production builds.  The counters follow the same rules
+    // as the other fields: plain word-sized stores by the single fast thread writer, no
+    // barriers, so a dumpsys reader may observe slightly stale or inconsistent counts.
+    static const uint32_t kCycleHistN = 32;
+    uint32_t mCycleTimeHist[kCycleHistN];   // delta monotonic (wall clock) time per cycle
+    uint32_t mCycleLoadHist[kCycleHistN];   // delta thread CPU time per cycle
+
+    // Maps a cycle duration in nanoseconds to its histogram bucket, floor(log2(microseconds)).
+    static uint32_t histogramBucket(uint32_t ns) {
+        const uint32_t us = ns / 1000;
+        return us == 0 ? 0 : 31 - __builtin_clz(us);
+    }
+
 #ifdef FAST_THREAD_STATISTICS
     // Recently collected samples of per-cycle monotonic time, thread CPU time, and CPU frequency.
     // kSamplingN is max size of sampling frame (statistics), and must be a power of 2 <= 0x8000.
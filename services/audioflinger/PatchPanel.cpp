@@ -237,6 +237,34 @@ status_t AudioFlinger::PatchPanel::createAudioPatch(const struct audio_patch *pa
                   !audioHwDevice->supportsAudioPatches()))) {
                 audio_devices_t outputDevice = patch->sinks[0].ext.device.type;
                 String8 outputDeviceAddress = String8(patch->sinks[0].ext.device.address);
+                // When only one end of a device to device bridge requests a
+                // direct stream, mirror the request on the unconstrained end.
+                // With both endpoints direct the patch runs on a single thread
+                // in passthru mode (see Patch::createConnections()), saving
+                // the record thread to playback thread hop. If the upgraded
+                // stream fails to open, the original request is retried below.
+                bool upgradedSinkFlags = false;
+                bool upgradedSourceFlags = false;
+                if (patch->num_sources == 1 && patch->num_sinks == 1) {
+                    struct audio_patch *newP = &newPatch.mAudioPatch;
+                    const bool sourceHasFlags =
+                            (newP->sources[0].config_mask & AUDIO_PORT_CONFIG_FLAGS) != 0;
+                    const bool sinkHasFlags =
+                            (newP->sinks[0].config_mask & AUDIO_PORT_CONFIG_FLAGS) != 0;
+                    const bool sourceIsDirect = sourceHasFlags
+                            && (newP->sources[0].flags.input & AUDIO_INPUT_FLAG_DIRECT) != 0;
+                    const bool sinkIsDirect = sinkHasFlags
+                            && (newP->sinks[0].flags.output & AUDIO_OUTPUT_FLAG_DIRECT) != 0;
+                    if (sourceIsDirect && !sinkHasFlags) {
+                        newP->sinks[0].flags.output = AUDIO_OUTPUT_FLAG_DIRECT;
+                        newP->sinks[0].config_mask |= AUDIO_PORT_CONFIG_FLAGS;
+                        upgradedSinkFlags = true;
+                    } else if (sinkIsDirect && !sourceHasFlags) {
+                        newP->sources[0].flags.input = AUDIO_INPUT_FLAG_DIRECT;
+                        newP->sources[0].config_mask |= AUDIO_PORT_CONFIG_FLAGS;
+                        upgradedSourceFlags = true;
+                    }
+                }
                 if (patch->num_sources == 2) {
                     if (patch->sources[1].type != AUDIO_PORT_TYPE_MIX ||
                             (patch->num_sinks != 0 && patch->sinks[0].ext.device.hw_module !=
@@ -270,9 +298,10 @@ status_t AudioFlinger::PatchPanel::createAudioPatch(const struct audio_patch *pa
                     if (patch->sinks[0].config_mask & AUDIO_PORT_CONFIG_FORMAT) {
                         config.format = patch->sinks[0].format;
                     }
-                    if (patch->sinks[0].config_mask & AUDIO_PORT_CONFIG_FLAGS) {
-                        flags = patch->sinks[0].flags.output;
+                    if (newPatch.mAudioPatch.sinks[0].config_mask & AUDIO_PORT_CONFIG_FLAGS) {
+                        flags = newPatch.mAudioPatch.sinks[0].flags.output;
                     }
+                    const audio_config_t requestedConfig = config;
                     sp<ThreadBase> thread = mAudioFlinger.openOutput_l(
                                                             patch->sinks[0].ext.device.hw_module,
                                                             &output,
@@ -282,6 +311,24 @@ status_t AudioFlinger::PatchPanel::createAudioPatch(const struct audio_patch *pa
                                                             outputDeviceAddress,
                                                             flags);
                     ALOGV("mAudioFlinger.openOutput_l() returned %p", thread.get());
+                    if (thread == 0 && upgradedSinkFlags) {
+                        // The direct upgrade was refused, retry as requested.
+                        newPatch.mAudioPatch.sinks[0].flags.output = AUDIO_OUTPUT_FLAG_NONE;
+                        newPatch.mAudioPatch.sinks[0].config_mask &= ~AUDIO_PORT_CONFIG_FLAGS;
+                        upgradedSinkFlags = false;
+                        flags = AUDIO_OUTPUT_FLAG_NONE;
+                        config = requestedConfig;
+                        mixerConfig = AUDIO_CONFIG_BASE_INITIALIZER;
+                        output = AUDIO_IO_HANDLE_NONE;
+                        thread = mAudioFlinger.openOutput_l(
+                                                            patch->sinks[0].ext.device.hw_module,
+                                                            &output,
+                                                            &config,
+                                                            &mixerConfig,
+                                                            outputDevice,
+                                                            outputDeviceAddress,
+                                                            flags);
+                    }
                     if (thread == 0) {
                         status = NO_MEMORY;
                         goto exit;
@@ -310,8 +357,9 @@ status_t AudioFlinger::PatchPanel::createAudioPatch(const struct audio_patch *pa
                     config.format = newPatch.mPlayback.thread()->format();
                 }
                 audio_input_flags_t flags =
-                        patch->sources[0].config_mask & AUDIO_PORT_CONFIG_FLAGS ?
-                        patch->sources[0].flags.input : AUDIO_INPUT_FLAG_NONE;
+                        newPatch.mAudioPatch.sources[0].config_mask & AUDIO_PORT_CONFIG_FLAGS ?
+                        newPatch.mAudioPatch.sources[0].flags.input : AUDIO_INPUT_FLAG_NONE;
+                const audio_config_t requestedConfig = config;
                 audio_io_handle_t input = AUDIO_IO_HANDLE_NONE;
                 audio_source_t source = AUDIO_SOURCE_MIC;
                 // For telephony patches, propagate voice communication use case to record side
@@ -331,6 +379,24 @@ status_t AudioFlinger::PatchPanel::createAudioPatch(const struct audio_patch *pa
                                                                     outputDeviceAddress);
                 ALOGV("mAudioFlinger.openInput_l() returned %p inChannelMask %08x",
                       thread.get(), config.channel_mask);
+                if (thread == 0 && upgradedSourceFlags) {
+                    // The direct upgrade was refused, retry as requested.
+                    newPatch.mAudioPatch.sources[0].flags.input = AUDIO_INPUT_FLAG_NONE;
+                    newPatch.mAudioPatch.sources[0].config_mask &= ~AUDIO_PORT_CONFIG_FLAGS;
+                    upgradedSourceFlags = false;
+                    flags = AUDIO_INPUT_FLAG_NONE;
+                    config = requestedConfig;
+                    input = AUDIO_IO_HANDLE_NONE;
+                    thread = mAudioFlinger.openInput_l(srcModule,
+                                                         &input,
+                                                         &config,
+                                                         device,
+                                                         address,
+                                                         source,
+                                                         flags,
+                                                         outputDevice,
+                                                         outputDeviceAddress);
+                }
                 if (thread == 0) {
                     status = NO_MEMORY;
                     goto exit;
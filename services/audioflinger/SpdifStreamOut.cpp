@@ -105,12 +105,14 @@ status_t SpdifStreamOut::open(
 int SpdifStreamOut::flush()
 {
     mSpdifEncoder.reset();
+    mFraming = Framing::UNKNOWN;
     return AudioStreamOut::flush();
 }
 
 int SpdifStreamOut::standby()
 {
     mSpdifEncoder.reset();
+    mFraming = Framing::UNKNOWN;
     return AudioStreamOut::standby();
 }
 
@@ -119,8 +121,31 @@ ssize_t SpdifStreamOut::writeDataBurst(const void* buffer, size_t bytes)
     return AudioStreamOut::write(buffer, bytes);
 }
 
+// static
+bool SpdifStreamOut::isIec61937Framed(const void* buffer, size_t bytes)
+{
+    // A data burst starts with the Pa (0xF872) and Pb (0x4E1F) sync preamble
+    // as 16-bit little-endian words. Raw elementary streams start with their
+    // own codec sync words (e.g. 0x0B77 for AC3), so matching the full 32-bit
+    // preamble cannot misfire on unframed content.
+    if (bytes < 2 * sizeof(uint16_t)) {
+        return false;
+    }
+    const uint16_t *words = reinterpret_cast<const uint16_t *>(buffer);
+    return words[0] == 0xF872 && words[1] == 0x4E1F;
+}
+
 ssize_t SpdifStreamOut::write(const void* buffer, size_t numBytes)
 {
+    if (mFraming == Framing::UNKNOWN && numBytes > 0) {
+        mFraming = isIec61937Framed(buffer, numBytes) ? Framing::IEC61937 : Framing::RAW;
+        ALOGI("SpdifStreamOut::write() stream is %s framed",
+                mFraming == Framing::IEC61937 ? "already IEC61937" : "not");
+    }
+    if (mFraming == Framing::IEC61937) {
+        // Already wrapped in data bursts; pass through without rescanning.
+        return writeDataBurst(buffer, numBytes);
+    }
     // Write to SPDIF wrapper. It will call back to writeDataBurst().
     return mSpdifEncoder.write(buffer, numBytes);
 }
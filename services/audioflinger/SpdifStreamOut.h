@@ -106,10 +106,18 @@ private:
         SpdifStreamOut * const mSpdifStreamOut;
     };
 
+    // Some sources deliver data bursts that are already IEC61937 framed.
+    // Classify the stream from its first buffer and bypass the encoder for
+    // such content instead of rescanning every write.
+    enum class Framing { UNKNOWN, RAW, IEC61937 };
+
     MySPDIFEncoder       mSpdifEncoder;
     audio_format_t       mApplicationFormat;
     uint32_t             mApplicationSampleRate;
     audio_channel_mask_t mApplicationChannelMask;
+    Framing              mFraming = Framing::UNKNOWN;
+
+    static bool isIec61937Framed(const void* buffer, size_t bytes);
 
     ssize_t  writeDataBurst(const void* data, size_t bytes);
     ssize_t  writeInternal(const void* buffer, size_t bytes);
@@ -79,6 +79,7 @@
 #include "FastCapture.h"
 #include <mediautils/SchedulingPolicyService.h>
 #include <mediautils/ServiceUtilities.h>
+#include <mediautils/ThreadRegistry.h>
 
 #ifdef ADD_BATTERY_DATA
 #include <media/IMediaPlayerService.h>
@@ -654,6 +655,22 @@ NO_THREAD_SAFETY_ANALYSIS  // condition variable
 void AudioFlinger::ThreadBase::sendIoConfigEvent(audio_io_config_event_t event, pid_t pid,
                                                  audio_port_handle_t portId)
 {
+    // IoConfigEvents are fire-and-forget: push onto the lock-free command
+    // queue and let the thread pick the event up at its next cycle boundary,
+    // so binder threads never wait for a reply.  Fall back to the locked
+    // path if the ring is momentarily full.
+    sp<ConfigEvent> configEvent = (ConfigEvent *)new IoConfigEvent(event, pid, portId);
+    if (mAsyncConfigEvents.push(configEvent)) {
+        // The signal must be sent with mLock held: the thread loops check the
+        // queue and then wait on mWaitWorkCV under mLock, so an unlocked
+        // signal could land between the check and the wait and be lost,
+        // leaving the event stuck until an unrelated wakeup. Unlike the
+        // locked path below we still do not wait for the event to be
+        // processed.
+        Mutex::Autolock _l(mLock);
+        mWaitWorkCV.signal();
+        return;
+    }
     Mutex::Autolock _l(mLock);
     sendIoConfigEvent_l(event, pid, portId);
 }
@@ -662,16 +679,6 @@ void AudioFlinger::ThreadBase::sendIoConfigEvent(audio_io_config_event_t event,
 void AudioFlinger::ThreadBase::sendIoConfigEvent_l(audio_io_config_event_t event, pid_t pid,
                                                    audio_port_handle_t portId)
 {
-    // The audio statistics history is exponentially weighted to forget events
-    // about five or more seconds in the past.  In order to have
-    // crisper statistics for mediametrics, we reset the statistics on
-    // an IoConfigEvent, to reflect different properties for a new device.
-    mIoJitterMs.reset();
-    mLatencyMs.reset();
-    mProcessTimeMs.reset();
-    mMonopipePipeDepthStats.reset();
-    mTimestampVerifier.discontinuity(mTimestampVerifier.DISCONTINUITY_MODE_CONTINUOUS);
-
     sp<ConfigEvent> configEvent = (ConfigEvent *)new IoConfigEvent(event, pid, portId);
     sendConfigEvent_l(configEvent);
 }
@@ -776,6 +783,13 @@ void AudioFlinger::ThreadBase::processConfigEvents_l()
 {
     bool configChanged = false;
 
+    // Adopt events posted lock-free by binder threads before processing,
+    // preserving arrival order with respect to the locked path.
+    sp<ConfigEvent> asyncEvent;
+    while (mAsyncConfigEvents.pop(&asyncEvent)) {
+        mConfigEvents.add(asyncEvent);
+    }
+
     while (!mConfigEvents.isEmpty()) {
         ALOGV("processConfigEvents_l() remaining events %zu", mConfigEvents.size());
         sp<ConfigEvent> event = mConfigEvents[0];
@@ -792,6 +806,16 @@ void AudioFlinger::ThreadBase::processConfigEvents_l()
             }
         } break;
         case CFG_EVENT_IO: {
+            // The audio statistics history is exponentially weighted to forget events
+            // about five or more seconds in the past.  In order to have
+            // crisper statistics for mediametrics, we reset the statistics on
+            // an IoConfigEvent, to reflect different properties for a new device.
+            mIoJitterMs.reset();
+            mLatencyMs.reset();
+            mProcessTimeMs.reset();
+            mMonopipePipeDepthStats.reset();
+            mTimestampVerifier.discontinuity(mTimestampVerifier.DISCONTINUITY_MODE_CONTINUOUS);
+
             IoConfigEventData *data = (IoConfigEventData *)event->mData.get();
             ioConfigChanged(data->mEvent, data->mPid, data->mPortId);
         } break;
@@ -943,18 +967,38 @@ NO_THREAD_SAFETY_ANALYSIS  // conditional try lock
     dprintf(fd, "\n%s thread %p, name %s, tid %d, type %d (%s):\n", isOutput() ? "Output" : "Input",
             this, mThreadName, getTid(), type(), threadTypeToString(type()));
 
-    bool locked = AudioFlinger::dumpTryLock(mLock);
-    if (!locked) {
-        dprintf(fd, "  Thread may be deadlocked\n");
-    }
+    // Format the lock-protected state into an in-memory snapshot first, so the
+    // thread mutex is never held while writing to the dump fd: bugreport pipes
+    // drain slowly and a blocked write with mLock held stalls the audio thread
+    // for the duration, causing glitches exactly when debugging.
+    std::string snapshot;
+    {
+        constexpr int SNAPSHOT_TIMEOUT_MS = 1000;
+        audio_utils::FdToString fdToString("" /* prefix */, SNAPSHOT_TIMEOUT_MS);
+        const int snapshotFd = fdToString.fd();
+        // If the snapshot pipe could not be created, fall back to dumping
+        // directly to the caller's fd as before.
+        const int dumpFd = snapshotFd >= 0 ? snapshotFd : fd;
 
-    dumpBase_l(fd, args);
-    dumpInternals_l(fd, args);
-    dumpTracks_l(fd, args);
-    dumpEffectChains_l(fd, args);
+        bool locked = AudioFlinger::dumpTryLock(mLock);
+        if (!locked) {
+            dprintf(dumpFd, "  Thread may be deadlocked\n");
+        }
 
-    if (locked) {
-        mLock.unlock();
+        dumpBase_l(dumpFd, args);
+        dumpInternals_l(dumpFd, args);
+        dumpTracks_l(dumpFd, args);
+        dumpEffectChains_l(dumpFd, args);
+
+        if (locked) {
+            mLock.unlock();
+        }
+        if (snapshotFd >= 0) {
+            snapshot = fdToString.getStringAndClose();
+        }
+    }
+    if (!snapshot.empty()) {
+        write(fd, snapshot.c_str(), snapshot.size());
     }
 
     dprintf(fd, "  Local log:\n");
@@ -3932,7 +3976,8 @@ NO_THREAD_SAFETY_ANALYSIS  // manual locking of AudioFlinger
                     sendStatistics(false /* force */);
                 }
 
-                if (mActiveTracks.isEmpty() && mConfigEvents.isEmpty()) {
+                if (mActiveTracks.isEmpty() && mConfigEvents.isEmpty()
+                        && mAsyncConfigEvents.empty()) {
                     // we're about to wait, flush the binder command buffer
                     IPCThreadState::self()->flushCommands();
 
@@ -4360,7 +4405,8 @@ NO_THREAD_SAFETY_ANALYSIS  // manual locking of AudioFlinger
                     // update sleep time (which is >= 0)
                     mSleepTimeUs = deltaNs / 1000;
                 }
-                if (!mSignalPending && mConfigEvents.isEmpty() && !exitPending()) {
+                if (!mSignalPending && mConfigEvents.isEmpty() && mAsyncConfigEvents.empty()
+                        && !exitPending()) {
                     mWaitWorkCV.waitRelative(mLock, microseconds((nsecs_t)mSleepTimeUs));
                 }
                 ATRACE_END();
@@ -4371,7 +4417,17 @@ NO_THREAD_SAFETY_ANALYSIS  // manual locking of AudioFlinger
         // since we can't guarantee the destructors won't acquire that
         // same lock.  This will also mutate and push a new fast mixer state.
         threadLoop_removeTracks(tracksToRemove);
-        tracksToRemove.clear();
+        // Hand the final release over to the low priority reaper thread:
+        // if these are the last references, the destructors unmap cblk
+        // shared memory, which can overrun the cycle when a client died.
+        if (!tracksToRemove.isEmpty()) {
+            Vector<sp<RefBase>> refs;
+            for (const auto& track : tracksToRemove) {
+                refs.add(track);
+            }
+            tracksToRemove.clear();
+            mAudioFlinger->reapTracks(&refs);
+        }
 
         // FIXME I don't understand the need for this here;
         //       it was in the original code but maybe the
@@ -4932,6 +4988,8 @@ AudioFlinger::MixerThread::MixerThread(const sp<AudioFlinger>& audioFlinger, Aud
         mFastMixer->run("FastMixer", PRIORITY_URGENT_AUDIO);
         pid_t tid = mFastMixer->getTid();
         sendPrioConfigEvent(getpid(), tid, kPriorityFastMixer, false /*forApp*/);
+        mediautils::ThreadRegistry::getInstance().registerThread(
+                "fastmixer", "FastMixer", tid);
         stream()->setHalThreadPriority(kPriorityFastMixer);
 
 #ifdef AUDIO_WATCHDOG
@@ -7821,8 +7879,11 @@ reacquire_wakelock:
                 // exitPending() can't become true here
                 releaseWakeLock_l();
                 ALOGV("RecordThread: loop stopping");
-                // go to sleep
-                mWaitWorkCV.wait(mLock);
+                // go to sleep, unless a config event arrived since we last
+                // processed them; in that case loop around and handle it first
+                if (mConfigEvents.isEmpty() && mAsyncConfigEvents.empty()) {
+                    mWaitWorkCV.wait(mLock);
+                }
                 ALOGV("RecordThread: loop starting");
                 goto reacquire_wakelock;
             }
@@ -9604,6 +9665,12 @@ status_t AudioFlinger::MmapThreadHandle::createMmapBuffer(int32_t minSizeFrames,
     return mThread->createMmapBuffer(minSizeFrames, info);
 }
 
+status_t AudioFlinger::MmapThreadHandle::resizeMmapBuffer(int32_t minSizeFrames,
+                                  struct audio_mmap_buffer_info *info)
+{
+    return mThread->resizeMmapBuffer(minSizeFrames, info);
+}
+
 status_t AudioFlinger::MmapThreadHandle::getMmapPosition(struct audio_mmap_position *position)
 {
     return mThread->getMmapPosition(position);
@@ -9701,6 +9768,40 @@ status_t AudioFlinger::MmapThread::createMmapBuffer(int32_t minSizeFrames,
     return mHalStream->createMmapBuffer(minSizeFrames, info);
 }
 
+status_t AudioFlinger::MmapThread::resizeMmapBuffer(int32_t minSizeFrames,
+                                  struct audio_mmap_buffer_info *info)
+{
+    if (mHalStream == 0) {
+        return NO_INIT;
+    }
+    {
+        Mutex::Autolock _l(mLock);
+        if (!mActiveTracks.isEmpty()) {
+            // Renegotiation happens between the last stop() and the next
+            // start(); rejecting while clients run keeps the shared
+            // buffer from being pulled out from under them.
+            ALOGW("%s: rejected, %zu clients still active",
+                    __FUNCTION__, mActiveTracks.size());
+            return INVALID_OPERATION;
+        }
+    }
+    // The HAL only accepts createMmapBuffer() in standby, so cycle it
+    // through standby here; the stream, its routing and effect chains
+    // all stay up, which is what bounds the gap to a standby/start
+    // cycle instead of a full close/reopen.
+    mHalStream->standby();
+    if (!mStandby) {
+        mThreadMetrics.logEndInterval();
+        mThreadSnapshot.onEnd();
+        mStandby = true;
+    }
+    status_t ret = mHalStream->createMmapBuffer(minSizeFrames, info);
+    if (ret != NO_ERROR) {
+        ALOGE("%s: createMmapBuffer(%d) failed %d", __FUNCTION__, minSizeFrames, ret);
+    }
+    return ret;
+}
+
 status_t AudioFlinger::MmapThread::getMmapPosition(struct audio_mmap_position *position)
 {
     if (mHalStream == 0) {
@@ -9989,7 +10090,7 @@ bool AudioFlinger::MmapThread::threadLoop()
             // A signal was raised while we were unlocked
             mSignalPending = false;
         } else {
-            if (mConfigEvents.isEmpty()) {
+            if (mConfigEvents.isEmpty() && mAsyncConfigEvents.empty()) {
                 // we're about to wait, flush the binder command buffer
                 IPCThreadState::self()->flushCommands();
 
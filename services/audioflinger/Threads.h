@@ -653,6 +653,10 @@ protected:
                 AudioDeviceTypeAddr       mInDeviceTypeAddr;   // input device type and address
                 Vector< sp<ConfigEvent> >     mConfigEvents;
                 Vector< sp<ConfigEvent> >     mPendingConfigEvents; // events awaiting system ready
+                // Fire-and-forget events posted lock-free by binder threads and
+                // adopted into mConfigEvents by processConfigEvents_l() at cycle
+                // boundaries, so producers never block on mLock.
+                CommandQueue< sp<ConfigEvent> >       mAsyncConfigEvents;
 
                 // These fields are written and read by thread itself without lock or barrier,
                 // and read by other threads without lock or barrier via standby(), outDeviceTypes()
@@ -2075,6 +2079,8 @@ class MmapThread : public ThreadBase
     // MmapStreamInterface
     status_t createMmapBuffer(int32_t minSizeFrames,
                                       struct audio_mmap_buffer_info *info);
+    status_t resizeMmapBuffer(int32_t minSizeFrames,
+                                      struct audio_mmap_buffer_info *info);
     status_t getMmapPosition(struct audio_mmap_position *position);
     status_t start(const AudioClient& client,
                    const audio_attributes_t *attr,
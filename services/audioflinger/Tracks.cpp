@@ -163,7 +163,7 @@ AudioFlinger::ThreadBase::TrackBase::TrackBase(
     }
 
     if (client != 0) {
-        mCblkMemory = client->heap()->allocate(size);
+        mCblkMemory = client->allocateTrackMemory(size);
         if (mCblkMemory == 0 ||
                 (mCblk = static_cast<audio_track_cblk_t *>(mCblkMemory->unsecurePointer())) == NULL) {
             ALOGE("%s(%d): not enough memory for AudioTrack size=%zu", __func__, mId, size);
@@ -268,6 +268,9 @@ AudioFlinger::ThreadBase::TrackBase::~TrackBase()
     // delete the proxy before deleting the shared memory it refers to, to avoid dangling reference
     mServerProxy.clear();
     releaseCblk();
+    if (mClient != 0 && mCblkMemory != 0) {
+        mClient->releaseTrackMemory(mCblkMemory->size());
+    }
     mCblkMemory.clear();    // free the shared memory before releasing the heap it belongs to
     if (mClient != 0) {
         // Client destructor must run with AudioFlinger client mutex locked
@@ -2056,13 +2059,21 @@ ssize_t AudioFlinger::PlaybackThread::OutputTrack::write(void* data, uint32_t fr
     inBuffer.frameCount = frames;
     inBuffer.raw = data;
 
-    uint32_t waitTimeLeftMs = mSourceThread->waitTimeMs();
+    // Drain opportunistically and let the overflow queue absorb whatever the
+    // sink cannot take right now, so that one slow sink (e.g. A2DP) does not
+    // stall the distribution to the other duplicated outputs. Only block on
+    // the sink proxy when the queue is too full to absorb this write, as the
+    // alternative would be dropping frames.
+    uint32_t waitTimeLeftMs = 0;
+    if (mBufferQueue.size() + 1 >= kMaxOverFlowBuffers) {
+        waitTimeLeftMs = mSourceThread->waitTimeMs();
+    }
 
     if (!mActive && frames != 0) {
         (void) start();
     }
 
-    while (waitTimeLeftMs) {
+    while (true) {
         // First write pending buffers, then new data
         if (mBufferQueue.size()) {
             pInBuffer = mBufferQueue.itemAt(0);
@@ -2079,6 +2090,8 @@ ssize_t AudioFlinger::PlaybackThread::OutputTrack::write(void* data, uint32_t fr
             nsecs_t startTime = systemTime();
             status_t status = obtainBuffer(&mOutBuffer, waitTimeLeftMs);
             if (status != NO_ERROR && status != NOT_ENOUGH_DATA) {
+                // Includes WOULD_BLOCK when draining without a wait budget:
+                // the remainder is queued below and released on a later cycle.
                 ALOGV("%s(%d): thread %d no more output buffers; status %d",
                         __func__, mId,
                         (int)mThreadIoHandle, status);
@@ -2092,6 +2105,9 @@ ssize_t AudioFlinger::PlaybackThread::OutputTrack::write(void* data, uint32_t fr
             }
             if (status == NOT_ENOUGH_DATA) {
                 restartIfDisabled();
+                if (waitTimeLeftMs == 0) {
+                    break;  // do not spin, the queued data flows next cycle
+                }
                 continue;
             }
         }
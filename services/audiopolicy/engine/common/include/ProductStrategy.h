@@ -20,6 +20,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -167,7 +168,37 @@ public:
     void dump(String8 *dst, int spaces = 0) const;
 
 private:
+    /**
+     * @brief Resolution of client attributes to strategy, volume group and stream type,
+     * memoized so that repeated track creations with the same attributes skip the rule scan.
+     *
+     * Matching only depends on usage, content type, flags and tags
+     * (see AudioProductStrategy::attributesMatches), so those fields form the cache key and
+     * attributes differing only in other fields share an entry. The cache is bounded because
+     * applications may send arbitrary tags. It is cleared by initialize() after the strategies
+     * are (re)loaded. No lock is needed: the engine is always called with the audio policy
+     * mutex held.
+     */
+    struct AttributesLookup {
+        product_strategy_t strategy = PRODUCT_STRATEGY_NONE;
+        volume_group_t volumeGroup = VOLUME_GROUP_NONE;
+        audio_stream_type_t stream = AUDIO_STREAM_DEFAULT;
+    };
+    struct AttributesLookupKeyHash {
+        size_t operator()(const audio_attributes_t &attr) const;
+    };
+    struct AttributesLookupKeyEqual {
+        bool operator()(const audio_attributes_t &lhs, const audio_attributes_t &rhs) const;
+    };
+
+    const AttributesLookup &resolveAttributes(const audio_attributes_t &attr) const;
+
+    static constexpr size_t kMaxAttributesLookupCacheSize = 100;
+
     product_strategy_t mDefaultStrategy = PRODUCT_STRATEGY_NONE;
+
+    mutable std::unordered_map<audio_attributes_t, AttributesLookup,
+            AttributesLookupKeyHash, AttributesLookupKeyEqual> mAttributesLookupCache;
 };
 
 using ProductStrategyDevicesRoleMap =
@@ -23,7 +23,9 @@
 #include <media/TypeConverter.h>
 #include <utils/String8.h>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 
 #include <log/log.h>
 
@@ -164,14 +166,60 @@ void ProductStrategy::dump(String8 *dst, int spaces) const
     }
 }
 
-product_strategy_t ProductStrategyMap::getProductStrategyForAttributes(
-        const audio_attributes_t &attr, bool fallbackOnDefault) const
+size_t ProductStrategyMap::AttributesLookupKeyHash::operator()(
+        const audio_attributes_t &attr) const
+{
+    size_t hash = std::hash<uint32_t>{}(attr.usage);
+    hash = hash * 31 + std::hash<uint32_t>{}(attr.content_type);
+    hash = hash * 31 + std::hash<uint32_t>{}(attr.flags);
+    hash = hash * 31 + std::hash<std::string_view>{}(
+            std::string_view(attr.tags, strnlen(attr.tags, AUDIO_ATTRIBUTES_TAGS_MAX_SIZE)));
+    return hash;
+}
+
+bool ProductStrategyMap::AttributesLookupKeyEqual::operator()(
+        const audio_attributes_t &lhs, const audio_attributes_t &rhs) const
+{
+    return lhs.usage == rhs.usage && lhs.content_type == rhs.content_type &&
+            lhs.flags == rhs.flags &&
+            std::strncmp(lhs.tags, rhs.tags, AUDIO_ATTRIBUTES_TAGS_MAX_SIZE) == 0;
+}
+
+const ProductStrategyMap::AttributesLookup &ProductStrategyMap::resolveAttributes(
+        const audio_attributes_t &attr) const
 {
+    auto cached = mAttributesLookupCache.find(attr);
+    if (cached != mAttributesLookupCache.end()) {
+        return cached->second;
+    }
+    // One ordered scan of the strategies resolves all three lookups; each takes
+    // its own first match, which preserves the semantics of the separate scans.
+    AttributesLookup lookup;
     for (const auto &iter : *this) {
-        if (iter.second->matches(attr)) {
-            return iter.second->getId();
+        const auto &strategy = iter.second;
+        if (lookup.strategy == PRODUCT_STRATEGY_NONE && strategy->matches(attr)) {
+            lookup.strategy = strategy->getId();
+        }
+        if (lookup.volumeGroup == VOLUME_GROUP_NONE) {
+            lookup.volumeGroup = strategy->getVolumeGroupForAttributes(attr);
+        }
+        if (lookup.stream == AUDIO_STREAM_DEFAULT) {
+            lookup.stream = strategy->getStreamTypeForAttributes(attr);
         }
     }
+    if (mAttributesLookupCache.size() >= kMaxAttributesLookupCacheSize) {
+        mAttributesLookupCache.clear();
+    }
+    return mAttributesLookupCache.emplace(attr, lookup).first->second;
+}
+
+product_strategy_t ProductStrategyMap::getProductStrategyForAttributes(
+        const audio_attributes_t &attr, bool fallbackOnDefault) const
+{
+    const AttributesLookup &lookup = resolveAttributes(attr);
+    if (lookup.strategy != PRODUCT_STRATEGY_NONE) {
+        return lookup.strategy;
+    }
     ALOGV("%s: No matching product strategy for attributes %s, return default", __FUNCTION__,
           toString(attr).c_str());
     return fallbackOnDefault? getDefault() : PRODUCT_STRATEGY_NONE;
@@ -193,11 +241,9 @@ audio_attributes_t ProductStrategyMap::getAttributesForStreamType(audio_stream_t
 audio_stream_type_t ProductStrategyMap::getStreamTypeForAttributes(
         const audio_attributes_t &attr) const
 {
-    for (const auto &iter : *this) {
-        audio_stream_type_t stream = iter.second->getStreamTypeForAttributes(attr);
-        if (stream != AUDIO_STREAM_DEFAULT) {
-            return stream;
-        }
+    const AttributesLookup &lookup = resolveAttributes(attr);
+    if (lookup.stream != AUDIO_STREAM_DEFAULT) {
+        return lookup.stream;
     }
     ALOGV("%s: No product strategy for attributes %s, using default (aka MUSIC)", __FUNCTION__,
           toString(attr).c_str());
@@ -271,11 +317,9 @@ std::string ProductStrategyMap::getDeviceAddressForProductStrategy(product_strat
 volume_group_t ProductStrategyMap::getVolumeGroupForAttributes(
         const audio_attributes_t &attr, bool fallbackOnDefault) const
 {
-    for (const auto &iter : *this) {
-        volume_group_t group = iter.second->getVolumeGroupForAttributes(attr);
-        if (group != VOLUME_GROUP_NONE) {
-            return group;
-        }
+    const AttributesLookup &lookup = resolveAttributes(attr);
+    if (lookup.volumeGroup != VOLUME_GROUP_NONE) {
+        return lookup.volumeGroup;
     }
     return fallbackOnDefault ? getDefaultVolumeGroup() : VOLUME_GROUP_NONE;
 }
@@ -306,6 +350,8 @@ void ProductStrategyMap::initialize()
 {
     mDefaultStrategy = getDefault();
     ALOG_ASSERT(mDefaultStrategy != PRODUCT_STRATEGY_NONE, "No default product strategy found");
+    // The strategies may have been (re)loaded, so cached resolutions are stale.
+    mAttributesLookupCache.clear();
 }
 
 void ProductStrategyMap::dump(String8 *dst, int spaces) const
@@ -6440,6 +6440,26 @@ void AudioPolicyManager::checkOutputForAttributes(const audio_attributes_t &attr
     DeviceVector oldDevices = mEngine->getOutputDevicesForAttributes(attr, 0, true /*fromCache*/);
     DeviceVector newDevices = mEngine->getOutputDevicesForAttributes(attr, 0, false /*fromCache*/);
 
+    // Incremental recomputation: a strategy only depends on the change being processed if the
+    // engine now selects different devices for it, or if the set of opened outputs moved under
+    // it, or if dynamic policy mixes could re-associate one of its clients. Otherwise skip the
+    // output and client scans below so that a device connection event does not disturb
+    // strategies routed elsewhere.
+    if (oldDevices == newDevices && mPolicyMixes.isEmpty()
+            && mPreviousOutputs.size() == mOutputs.size()) {
+        bool outputsStable = true;
+        for (size_t i = 0; i < mOutputs.size(); i++) {
+            if (mPreviousOutputs.indexOfKey(mOutputs.keyAt(i)) < 0) {
+                outputsStable = false;
+                break;
+            }
+        }
+        if (outputsStable) {
+            ALOGV("%s: strategy %d devices and outputs unchanged, skipping", __func__, psId);
+            return;
+        }
+    }
+
     SortedVector<audio_io_handle_t> srcOutputs = getOutputsForDevices(oldDevices, mPreviousOutputs);
     SortedVector<audio_io_handle_t> dstOutputs = getOutputsForDevices(newDevices, mOutputs);
 
@@ -6447,7 +6467,11 @@ void AudioPolicyManager::checkOutputForAttributes(const audio_attributes_t &attr
     std::vector<sp<SwAudioOutputDescriptor>> invalidatedOutputs;
     // take into account dynamic audio policies related changes: if a client is now associated
     // to a different policy mix than at creation time, invalidate corresponding stream
-    for (size_t i = 0; i < mPreviousOutputs.size(); i++) {
+    // Only scan clients when dynamic policy mixes are registered: this check is run once per
+    // product strategy on every device connection event, and without mixes no client can have
+    // changed its mix association, so the O(outputs x clients) pass below would be pure
+    // overhead for strategies whose routing is not affected by the event.
+    for (size_t i = 0; !mPolicyMixes.isEmpty() && i < mPreviousOutputs.size(); i++) {
         const sp<SwAudioOutputDescriptor>& desc = mPreviousOutputs.valueAt(i);
         if (desc->isDuplicated()) {
             continue;
@@ -92,12 +92,6 @@ public:
     };
     static constexpr const char *kNumFramesKey = "numFrames";
     static constexpr const char *kModeKey = "mode";
-    static constexpr const char *kTranslation0Key = "translation0";
-    static constexpr const char *kTranslation1Key = "translation1";
-    static constexpr const char *kTranslation2Key = "translation2";
-    static constexpr const char *kRotation0Key = "rotation0";
-    static constexpr const char *kRotation1Key = "rotation1";
-    static constexpr const char *kRotation2Key = "rotation2";
     static constexpr const char *kLatencyModesKey = "latencyModes";
 
     class LatencyModes : public RefBase {
@@ -137,14 +131,7 @@ public:
                 }
                 } break;
             case kWhatOnHeadToStagePose: {
-                std::vector<float> headToStage(sHeadPoseKeys.size());
-                for (size_t i = 0 ; i < sHeadPoseKeys.size(); i++) {
-                    if (!msg->findFloat(sHeadPoseKeys[i], &headToStage[i])) {
-                        ALOGE("%s: Cannot find kTranslation0Key!", __func__);
-                        return;
-                    }
-                }
-                spatializer->onHeadToStagePoseMsg(headToStage);
+                spatializer->onHeadToStagePoseMsg();
                 } break;
             case kWhatOnActualModeChange: {
                 int mode;
@@ -175,15 +162,6 @@ private:
     std::once_flag mPrioritySetFlag;
 };
 
-const std::vector<const char *> Spatializer::sHeadPoseKeys = {
-    Spatializer::EngineCallbackHandler::kTranslation0Key,
-    Spatializer::EngineCallbackHandler::kTranslation1Key,
-    Spatializer::EngineCallbackHandler::kTranslation2Key,
-    Spatializer::EngineCallbackHandler::kRotation0Key,
-    Spatializer::EngineCallbackHandler::kRotation1Key,
-    Spatializer::EngineCallbackHandler::kRotation2Key,
-};
-
 // ---------------------------------------------------------------------------
 
 // Convert recorded sensor data to string with level indentation.
@@ -742,14 +720,24 @@ void Spatializer::onHeadToStagePose(const Pose3f& headToStage) {
             "onHeadToStagePose() called with no head tracking support!");
 
     auto vec = headToStage.toVector();
-    LOG_ALWAYS_FATAL_IF(vec.size() != sHeadPoseKeys.size(),
+    LOG_ALWAYS_FATAL_IF(vec.size() != kHeadPoseVectorSize,
             "%s invalid head to stage vector size %zu", __func__, vec.size());
-    sp<AMessage> msg =
-            new AMessage(EngineCallbackHandler::kWhatOnHeadToStagePose, mHandler);
-    for (size_t i = 0 ; i < sHeadPoseKeys.size(); i++) {
-        msg->setFloat(sHeadPoseKeys[i], vec[i]);
+    bool postNeeded;
+    {
+        std::lock_guard lock(mPoseLock);
+        // Later poses overwrite the stored one, so if the looper has not
+        // consumed the previous pose yet it delivers the most recent pose
+        // once instead of draining a backlog of stale ones, one engine
+        // parameter call each.
+        mLastHeadToStagePose = std::move(vec);
+        postNeeded = !mHeadToStagePosePending;
+        mHeadToStagePosePending = true;
+    }
+    if (postNeeded) {
+        sp<AMessage> msg =
+                new AMessage(EngineCallbackHandler::kWhatOnHeadToStagePose, mHandler);
+        msg->post();
     }
-    msg->post();
 }
 
 void Spatializer::resetEngineHeadPose_l() {
@@ -763,8 +751,14 @@ void Spatializer::resetEngineHeadPose_l() {
             std::vector<SpatializerHeadTrackingMode>{SpatializerHeadTrackingMode::DISABLED});
 }
 
-void Spatializer::onHeadToStagePoseMsg(const std::vector<float>& headToStage) {
+void Spatializer::onHeadToStagePoseMsg() {
     ALOGV("%s", __func__);
+    std::vector<float> headToStage;
+    {
+        std::lock_guard lock(mPoseLock);
+        headToStage = mLastHeadToStagePose;
+        mHeadToStagePosePending = false;
+    }
     sp<media::ISpatializerHeadTrackingCallback> callback;
     {
         std::lock_guard lock(mLock);
@@ -209,7 +209,7 @@ private:
     void onHeadToStagePose(const media::Pose3f& headToStage) override;
     void onActualModeChange(media::HeadTrackingMode mode) override;
 
-    void onHeadToStagePoseMsg(const std::vector<float>& headToStage);
+    void onHeadToStagePoseMsg();
     void onActualModeChangeMsg(media::HeadTrackingMode mode);
     void onSupportedLatencyModesChangedMsg(
             audio_io_handle_t output, std::vector<audio_latency_mode_t>&& modes);
@@ -415,7 +415,24 @@ private:
     size_t mNumActiveTracks GUARDED_BY(mLock) = 0;
     std::vector<audio_latency_mode_t> mSupportedLatencyModes GUARDED_BY(mLock);
 
-    static const std::vector<const char*> sHeadPoseKeys;
+    /**
+     * According to frameworks/av/media/libheadtracking/include/media/Pose.h
+     * Pose3f::toVector() has exactly 6 elements: a translation vector followed
+     * by a rotation vector.
+     */
+    static constexpr size_t kHeadPoseVectorSize = 6;
+
+    /**
+     * Latest head to stage pose from the pose controller, consumed by the
+     * looper thread which forwards it to the engine. Delivery is latest-wins:
+     * the pose thread only posts a new message when the previous pose has
+     * been consumed, so the engine sees at most one HEAD_TO_STAGE parameter
+     * call per looper wakeup no matter how fast poses are computed.
+     */
+    std::mutex mPoseLock;
+    std::vector<float> mLastHeadToStagePose GUARDED_BY(mPoseLock) =
+            std::vector<float>(kHeadPoseVectorSize, 0.f);
+    bool mHeadToStagePosePending GUARDED_BY(mPoseLock) = false;
 
     // Local log for command messages.
     static constexpr int mMaxLocalLogLine = 10;
@@ -24,6 +24,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <future>
 #include <string>
 #include <sys/types.h>
 #include <inttypes.h>
@@ -1870,6 +1871,18 @@ Status CameraService::connectHelper(const sp<CALLBACK>& cameraCb, const String8&
 
         status_t err;
 
+        // Permission and policy checks have passed; warm up the HAL device
+        // interface concurrently with eviction handling and client
+        // construction below. For lazy HALs this starts the provider process
+        // well before client->initialize() needs it, trimming cold open
+        // latency. The actual device open in initialize() serializes behind
+        // this through the provider manager's interface lock, and surfaces
+        // any failure itself, so the result here can be ignored.
+        auto primeFuture = std::async(std::launch::async,
+                [manager = mCameraProviderManager, id = std::string(cameraId.string())]() {
+                    manager->prepareDeviceOpen(id);
+                });
+
         sp<BasicClient> clientTmp = nullptr;
         std::shared_ptr<resource_policy::ClientDescriptor<String8, sp<BasicClient>>> partial;
         if ((err = handleEvictionsLocked(cameraId, originalClientPid, effectiveApiLevel,
@@ -29,6 +29,7 @@
 #include "aidl/AidlProviderInfo.h"
 #include <dlfcn.h>
 #include <future>
+#include <thread>
 #include <inttypes.h>
 #include <android/binder_manager.h>
 #include <android/hidl/manager/1.2/IServiceManager.h>
@@ -608,6 +609,48 @@ status_t CameraProviderManager::notifyDeviceStateChange(int64_t newState) {
     return res;
 }
 
+status_t CameraProviderManager::prepareDeviceOpen(const std::string &id) {
+    std::lock_guard<std::mutex> lock(mInterfaceMutex);
+
+    auto deviceInfo = findDeviceInfoLocked(id);
+    if (deviceInfo == nullptr) return NAME_NOT_FOUND;
+
+    sp<ProviderInfo> parentProvider = deviceInfo->mParentProvider.promote();
+    if (parentProvider == nullptr) {
+        return DEAD_OBJECT;
+    }
+
+    switch (parentProvider->getIPCTransport()) {
+        case IPCTransport::AIDL: {
+            if (static_cast<AidlProviderInfo *>(
+                        parentProvider.get())->startProviderInterface() == nullptr) {
+                return DEAD_OBJECT;
+            }
+            auto *aidlDeviceInfo3 =
+                    static_cast<AidlProviderInfo::AidlDeviceInfo3*>(deviceInfo);
+            if (aidlDeviceInfo3->startDeviceInterface() == nullptr) {
+                return DEAD_OBJECT;
+            }
+            break;
+        }
+        case IPCTransport::HIDL: {
+            if (static_cast<HidlProviderInfo *>(
+                        parentProvider.get())->startProviderInterface() == nullptr) {
+                return DEAD_OBJECT;
+            }
+            auto *hidlDeviceInfo3 =
+                    static_cast<HidlProviderInfo::HidlDeviceInfo3*>(deviceInfo);
+            if (hidlDeviceInfo3->startDeviceInterface() == nullptr) {
+                return DEAD_OBJECT;
+            }
+            break;
+        }
+        default:
+            return INVALID_OPERATION;
+    }
+    return OK;
+}
+
 status_t CameraProviderManager::openAidlSession(const std::string &id,
         const std::shared_ptr<
                 aidl::android::hardware::camera::device::ICameraDeviceCallback>& callback,
@@ -846,9 +889,41 @@ status_t CameraProviderManager::dump(int fd, const Vector<String16>& args) {
 
 void CameraProviderManager::ProviderInfo::initializeProviderInfoCommon(
         const std::vector<std::string> &devices) {
-    for (auto& device : devices) {
+    // The per-device HAL metadata queries dominate enumeration time and are
+    // independent of each other, so run initializeDeviceInfo for all
+    // enumerated devices concurrently, then register the results in
+    // enumeration order. Devices that fail the pre-checks here are left for
+    // addDevice to reject with its usual logging.
+    std::vector<std::unique_ptr<DeviceInfo>> deviceInfos(devices.size());
+    if (devices.size() > 1) {
+        std::vector<std::thread> initThreads;
+        initThreads.reserve(devices.size());
+        for (size_t i = 0; i < devices.size(); i++) {
+            initThreads.emplace_back([this, &devices, &deviceInfos, i]() {
+                uint16_t major, minor;
+                std::string type, id;
+                if (parseDeviceName(devices[i], &major, &minor, &type, &id) != OK ||
+                        type != mType) {
+                    return;
+                }
+                IPCTransport transport = getIPCTransport();
+                if ((transport == IPCTransport::HIDL && major != 3) ||
+                        (transport == IPCTransport::AIDL && major != 1)) {
+                    return;
+                }
+                deviceInfos[i] = initializeDeviceInfo(devices[i], mProviderTagid, id, minor);
+            });
+        }
+        for (auto& thread : initThreads) {
+            thread.join();
+        }
+    }
+
+    for (size_t i = 0; i < devices.size(); i++) {
+        const std::string& device = devices[i];
         std::string id;
-        status_t res = addDevice(device, CameraDeviceStatus::PRESENT, &id);
+        status_t res = addDevice(device, CameraDeviceStatus::PRESENT, &id,
+                std::move(deviceInfos[i]));
         if (res != OK) {
             ALOGE("%s: Unable to enumerate camera device '%s': %s (%d)",
                     __FUNCTION__, device.c_str(), strerror(-res), res);
@@ -1839,7 +1914,8 @@ const std::string& CameraProviderManager::ProviderInfo::getType() const {
 
 status_t CameraProviderManager::ProviderInfo::addDevice(
         const std::string& name, CameraDeviceStatus initialStatus,
-        /*out*/ std::string* parsedId) {
+        /*out*/ std::string* parsedId,
+        std::unique_ptr<DeviceInfo> preInitializedDeviceInfo) {
 
     ALOGI("Enumerating new camera device: %s", name.c_str());
 
@@ -1863,7 +1939,7 @@ status_t CameraProviderManager::ProviderInfo::addDevice(
         return BAD_VALUE;
     }
 
-    std::unique_ptr<DeviceInfo> deviceInfo;
+    std::unique_ptr<DeviceInfo> deviceInfo = std::move(preInitializedDeviceInfo);
     switch (transport) {
         case IPCTransport::HIDL:
             switch (major) {
@@ -1887,7 +1963,9 @@ status_t CameraProviderManager::ProviderInfo::addDevice(
             return BAD_VALUE;
     }
 
-    deviceInfo = initializeDeviceInfo(name, mProviderTagid, id, minor);
+    if (deviceInfo == nullptr) {
+        deviceInfo = initializeDeviceInfo(name, mProviderTagid, id, minor);
+    }
     if (deviceInfo == nullptr) return BAD_VALUE;
     deviceInfo->notifyDeviceStateChange(getDeviceState());
     deviceInfo->mStatus = initialStatus;
@@ -351,6 +351,17 @@ public:
         /*out*/
         std::shared_ptr<aidl::android::hardware::camera::device::ICameraInjectionSession> *session);
 
+    /**
+     * Warm up the interfaces needed to open a session to a camera device,
+     * without opening the device itself.
+     *
+     * This starts the provider process for lazy HALs and acquires the device
+     * interface so a subsequent openAidlSession/openHidlSession call only has
+     * to power on the hardware. Safe to call concurrently with the rest of
+     * the connect sequence; any failure is also surfaced by the actual open.
+     */
+    status_t prepareDeviceOpen(const std::string &id);
+
     /**
      * Open an active session to a camera device.
      *
@@ -748,9 +759,14 @@ private:
         // Generate vendor tag id
         static metadata_vendor_id_t generateVendorTagId(const std::string &name);
 
+        // Add a new device to this provider. If preInitializedDeviceInfo is
+        // non-null it is used instead of querying the HAL, allowing the
+        // expensive per-device metadata queries to be run concurrently ahead
+        // of registration (see initializeProviderInfoCommon).
         status_t addDevice(
                 const std::string& name, CameraDeviceStatus initialStatus,
-                /*out*/ std::string* parsedId);
+                /*out*/ std::string* parsedId,
+                std::unique_ptr<DeviceInfo> preInitializedDeviceInfo = nullptr);
 
         void cameraDeviceStatusChangeInternal(const std::string& cameraDeviceName,
                 CameraDeviceStatus newStatus);
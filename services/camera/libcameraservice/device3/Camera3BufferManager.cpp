@@ -18,6 +18,8 @@
 #define LOG_TAG "Camera3-BufferManager"
 #define ATRACE_TAG ATRACE_TAG_CAMERA
 
+#include <inttypes.h>
+
 #include <gui/ISurfaceComposer.h>
 #include <private/gui/ComposerService.h>
 #include <utils/Log.h>
@@ -223,9 +225,9 @@ status_t Camera3BufferManager::checkAndFreeBufferOnOtherStreamsLocked(
         // into the buffer manager in parallel to signal buffer
         // release, or acquire a new buffer.
         bool bufferFreed = false;
+        sp<GraphicBuffer> buffer;
         {
             mLock.unlock();
-            sp<GraphicBuffer> buffer;
             stream->detachBuffer(&buffer, /*fenceFd*/ nullptr);
             mLock.lock();
             if (buffer.get() != nullptr) {
@@ -236,6 +238,10 @@ status_t Camera3BufferManager::checkAndFreeBufferOnOtherStreamsLocked(
             size_t& otherAttachedBufferCount =
                     streamSet.attachedBufferCountMap.editValueFor(firstOtherStreamId);
             otherAttachedBufferCount--;
+            // Park the detached buffer in the warm buffer carousel rather than
+            // dropping the allocation, so a stream with matching parameters can
+            // pick it up later without a fresh gralloc allocation.
+            addWarmBufferLocked(streamSet.streamInfoMap.valueFor(firstOtherStreamId), buffer);
         }
     }
 
@@ -286,21 +292,29 @@ status_t Camera3BufferManager::getBufferForStream(int streamId, int streamSetId,
         const StreamInfo& info = streamSet.streamInfoMap.valueFor(streamId);
         GraphicBufferEntry buffer;
         buffer.fenceFd = -1;
-        buffer.graphicBuffer = new GraphicBuffer(
-                info.width, info.height, PixelFormat(info.format), info.combinedUsage,
-                std::string("Camera3BufferManager pid [") +
-                        std::to_string(getpid()) + "]");
-        status_t res = buffer.graphicBuffer->initCheck();
-
-        ALOGV("%s: allocating a new graphic buffer (%dx%d, format 0x%x) %p with handle %p",
-                __FUNCTION__, info.width, info.height, info.format,
-                buffer.graphicBuffer.get(), buffer.graphicBuffer->handle);
-        if (res < 0) {
-            ALOGE("%s: graphic buffer allocation failed: (error %d %s) ",
-                    __FUNCTION__, res, strerror(-res));
-            return res;
+        status_t res = OK;
+        buffer.graphicBuffer = getWarmBufferLocked(info);
+        if (buffer.graphicBuffer != nullptr) {
+            ALOGV("%s: reusing a warm graphic buffer (%dx%d, format 0x%x) %p with handle %p",
+                    __FUNCTION__, info.width, info.height, info.format,
+                    buffer.graphicBuffer.get(), buffer.graphicBuffer->handle);
+        } else {
+            buffer.graphicBuffer = new GraphicBuffer(
+                    info.width, info.height, PixelFormat(info.format), info.combinedUsage,
+                    std::string("Camera3BufferManager pid [") +
+                            std::to_string(getpid()) + "]");
+            res = buffer.graphicBuffer->initCheck();
+
+            ALOGV("%s: allocating a new graphic buffer (%dx%d, format 0x%x) %p with handle %p",
+                    __FUNCTION__, info.width, info.height, info.format,
+                    buffer.graphicBuffer.get(), buffer.graphicBuffer->handle);
+            if (res < 0) {
+                ALOGE("%s: graphic buffer allocation failed: (error %d %s) ",
+                        __FUNCTION__, res, strerror(-res));
+                return res;
+            }
+            ALOGV("%s: allocation done", __FUNCTION__);
         }
-        ALOGV("%s: allocation done", __FUNCTION__);
 
         // Increase the hand-out and attached buffer counts for tracking purposes.
         bufferCount++;
@@ -351,6 +365,7 @@ status_t Camera3BufferManager::onBufferReleased(
     Mutex::Autolock l(mLock);
     ALOGV("Stream %d set %d(%d): Buffer released", streamId, streamSetId, isMultiRes);
     *shouldFreeBuffer = false;
+    trimWarmBuffersLocked();
 
     StreamSetKey streamSetKey = {streamSetId, isMultiRes};
     if (!checkIfStreamRegisteredLocked(streamId, streamSetKey)){
@@ -451,11 +466,59 @@ status_t Camera3BufferManager::onBuffersRemoved(int streamId, int streamSetId,
     return OK;
 }
 
+void Camera3BufferManager::addWarmBufferLocked(const StreamInfo& info,
+        const sp<GraphicBuffer>& buffer) {
+    if (buffer == nullptr) {
+        return;
+    }
+    trimWarmBuffersLocked();
+    if (mWarmBuffers.size() >= kMaxWarmBuffers) {
+        // Drop the oldest entry to make room.
+        mWarmBuffers.pop_front();
+    }
+    WarmBufferEntry entry = {info.width, info.height, info.format, info.combinedUsage,
+            buffer, systemTime()};
+    mWarmBuffers.push_back(entry);
+    ALOGV("%s: parked warm buffer (%dx%d, format 0x%x), carousel size %zu",
+            __FUNCTION__, info.width, info.height, info.format, mWarmBuffers.size());
+}
+
+sp<GraphicBuffer> Camera3BufferManager::getWarmBufferLocked(const StreamInfo& info) {
+    trimWarmBuffersLocked();
+    for (auto it = mWarmBuffers.begin(); it != mWarmBuffers.end(); it++) {
+        if (it->width == info.width && it->height == info.height &&
+                it->format == info.format && it->combinedUsage == info.combinedUsage) {
+            sp<GraphicBuffer> buffer = it->graphicBuffer;
+            mWarmBuffers.erase(it);
+            return buffer;
+        }
+    }
+    return nullptr;
+}
+
+void Camera3BufferManager::trimWarmBuffersLocked() {
+    nsecs_t now = systemTime();
+    for (auto it = mWarmBuffers.begin(); it != mWarmBuffers.end();) {
+        if (now - it->entryTime > kWarmBufferTimeout) {
+            ALOGV("%s: trimming warm buffer (%dx%d, format 0x%x)", __FUNCTION__,
+                    it->width, it->height, it->format);
+            it = mWarmBuffers.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
 void Camera3BufferManager::dump(int fd, const Vector<String16>& args) const {
     Mutex::Autolock l(mLock);
 
     (void) args;
     String8 lines;
+    lines.appendFormat("      Warm buffer carousel size: %zu\n", mWarmBuffers.size());
+    for (const auto& entry : mWarmBuffers) {
+        lines.appendFormat("        Warm buffer: %dx%d, format 0x%x, usage 0x%" PRIx64 "\n",
+                entry.width, entry.height, entry.format, entry.combinedUsage);
+    }
     lines.appendFormat("      Total stream sets: %zu\n", mStreamSetMap.size());
     for (size_t i = 0; i < mStreamSetMap.size(); i++) {
         lines.appendFormat("        Stream set %d(%d) has below streams:\n",
@@ -22,6 +22,7 @@
 #include <ui/GraphicBuffer.h>
 #include <utils/RefBase.h>
 #include <utils/KeyedVector.h>
+#include <utils/Timers.h>
 #include "Camera3OutputStream.h"
 
 namespace android {
@@ -309,6 +310,53 @@ private:
     KeyedVector<StreamSetKey, StreamSet> mStreamSetMap;
     KeyedVector<StreamId, wp<Camera3OutputStream>> mStreamMap;
 
+    /**
+     * Warm buffer carousel: buffers detached from inactive streams are parked
+     * here instead of being freed outright, keyed by their allocation
+     * parameters.  When a stream (possibly registered by a later stream
+     * configuration) requests a buffer with a matching size/format/usage
+     * combination, the retained gralloc allocation is handed out instead of
+     * allocating a new one, which takes stream startup allocations off the
+     * critical path.  The carousel is bounded and idle entries are trimmed
+     * opportunistically on buffer manager calls.
+     */
+    struct WarmBufferEntry {
+        uint32_t width;
+        uint32_t height;
+        uint32_t format;
+        uint64_t combinedUsage;
+        sp<GraphicBuffer> graphicBuffer;
+        nsecs_t entryTime;
+    };
+
+    // Max number of buffers retained in the warm buffer carousel.
+    static const size_t kMaxWarmBuffers = 8;
+
+    // Warm buffers that stay unused for longer than this are freed by the
+    // next trim.
+    static const nsecs_t kWarmBufferTimeout = 3000000000LL; // 3 sec
+
+    std::list<WarmBufferEntry> mWarmBuffers;
+
+    /**
+     * Park a detached buffer in the warm buffer carousel. This method needs to be called with
+     * mLock held.
+     */
+    void addWarmBufferLocked(const StreamInfo& info, const sp<GraphicBuffer>& buffer);
+
+    /**
+     * Take a buffer matching the given stream's allocation parameters out of the warm buffer
+     * carousel, or return nullptr if there is none. This method needs to be called with mLock
+     * held.
+     */
+    sp<GraphicBuffer> getWarmBufferLocked(const StreamInfo& info);
+
+    /**
+     * Free warm buffers that have been parked for longer than kWarmBufferTimeout. This method
+     * needs to be called with mLock held.
+     */
+    void trimWarmBuffersLocked();
+
     // TODO: There is no easy way to query the Gralloc version in this code yet, we have different
     // code paths for different Gralloc versions, hardcode something here for now.
     const uint32_t mGrallocVersion = GRALLOC_DEVICE_API_VERSION_0_1;
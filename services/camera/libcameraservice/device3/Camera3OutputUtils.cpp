@@ -498,7 +498,12 @@ void processCaptureResult(CaptureOutputStates& states, const camera_capture_resu
     // all result data and shutter timestamp have been received.
     nsecs_t shutterTimestamp = 0;
     {
-        std::lock_guard<std::mutex> l(states.inflightLock);
+        // When the caller already holds the in-flight lock for a batch of
+        // results, don't re-acquire it per result.
+        std::unique_lock<std::mutex> l(states.inflightLock, std::defer_lock);
+        if (!states.holdingInflightLock) {
+            l.lock();
+        }
         ssize_t idx = states.inflightMap.indexOfKey(frameNumber);
         if (idx == NAME_NOT_FOUND) {
             SET_ERR("Unknown frame number for capture result: %d",
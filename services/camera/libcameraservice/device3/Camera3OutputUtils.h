@@ -108,6 +108,28 @@ namespace camera3 {
         nsecs_t& minFrameDuration;
         bool& isFixedFps;
         bool overrideToPortrait;
+        // Set by InflightBatchLock while the in-flight map lock is held for a
+        // whole batch of results; processCaptureResult then skips its
+        // per-result lock acquisition.
+        bool holdingInflightLock = false;
+    };
+
+    // RAII helper that acquires the in-flight map lock once for a whole batch
+    // of capture results delivered in a single HAL callback, so that a burst
+    // of N results costs one lock round-trip on the results thread instead of
+    // N acquisitions contending with the request thread.
+    class InflightBatchLock {
+      public:
+        explicit InflightBatchLock(CaptureOutputStates& states) : mStates(states) {
+            mStates.inflightLock.lock();
+            mStates.holdingInflightLock = true;
+        }
+        ~InflightBatchLock() {
+            mStates.holdingInflightLock = false;
+            mStates.inflightLock.unlock();
+        }
+      private:
+        CaptureOutputStates& mStates;
     };
 
     void processCaptureResult(CaptureOutputStates& states, const camera_capture_result *result);
@@ -143,6 +143,8 @@ void Camera3StreamSplitter::disconnect() {
     mOutputSurfaces.clear();
     mOutputSlots.clear();
     mConsumerBufferCount.clear();
+    mOutputPolicies.clear();
+    mOutputPendingBuffers.clear();
 
     if (mConsumer.get() != nullptr) {
         mConsumer->consumerDisconnect();
@@ -255,6 +257,15 @@ status_t Camera3StreamSplitter::addOutputLocked(size_t surfaceId, const sp<Surfa
         outputQueue->setDequeueTimeout(timeout);
     }
 
+    // Classify the output by its consumer usage: composer/GPU texture
+    // consumers only display the latest frame and can tolerate drops, while
+    // video encoder and CPU consumers need the full frame sequence.
+    OutputPolicy policy = OutputPolicy::FULL_SEQUENCE;
+    if ((usage & (GRALLOC_USAGE_HW_COMPOSER | GRALLOC_USAGE_HW_TEXTURE)) &&
+            !(usage & GRALLOC_USAGE_HW_VIDEO_ENCODER)) {
+        policy = OutputPolicy::LATEST_ONLY;
+    }
+
     res = gbp->allowAllocation(false);
     if (res != OK) {
         SP_LOGE("%s: Failed to turn off allocation for outputQueue", __FUNCTION__);
@@ -271,6 +282,8 @@ status_t Camera3StreamSplitter::addOutputLocked(size_t surfaceId, const sp<Surfa
     }
     mNotifiers[gbp] = listener;
     mOutputSlots[gbp] = std::make_unique<OutputSlots>(totalBufferCount);
+    mOutputPolicies[surfaceId] = policy;
+    mOutputPendingBuffers[surfaceId] = 0;
 
     mMaxConsumerBuffers += maxConsumerBuffers;
     return NO_ERROR;
@@ -343,6 +356,7 @@ status_t Camera3StreamSplitter::removeOutputLocked(size_t surfaceId) {
     mNotifiers[gbp] = nullptr;
     mMaxConsumerBuffers -= mConsumerBufferCount[surfaceId];
     mConsumerBufferCount[surfaceId] = 0;
+    mOutputPendingBuffers[surfaceId] = 0;
 
     return res;
 }
@@ -398,6 +412,8 @@ status_t Camera3StreamSplitter::outputBufferLocked(const sp<IGraphicBufferProduc
         return res;
     }
 
+    mOutputPendingBuffers[surfaceId]++;
+
     // If the queued buffer replaces a pending buffer in the async
     // queue, no onBufferReleased is called by the buffer queue.
     // Proactively trigger the callback to avoid buffer loss.
@@ -408,6 +424,22 @@ status_t Camera3StreamSplitter::outputBufferLocked(const sp<IGraphicBufferProduc
     return res;
 }
 
+bool Camera3StreamSplitter::shouldSkipOutputLocked(size_t surfaceId) {
+    auto policy = mOutputPolicies.find(surfaceId);
+    if (policy == mOutputPolicies.end() || policy->second != OutputPolicy::LATEST_ONLY) {
+        return false;
+    }
+
+    auto pending = mOutputPendingBuffers.find(surfaceId);
+    if (pending == mOutputPendingBuffers.end()) {
+        return false;
+    }
+    // The consumer may legitimately hold on to its advertised undequeued
+    // buffer count; holding more than that means it has fallen behind and
+    // the next queue attempt may block or starve the input of buffers.
+    return pending->second > mConsumerBufferCount[surfaceId];
+}
+
 String8 Camera3StreamSplitter::getUniqueConsumerName() {
     static volatile int32_t counter = 0;
     return String8::format("Camera3StreamSplitter-%d", android_atomic_inc(&counter));
@@ -545,6 +577,17 @@ void Camera3StreamSplitter::onFrameAvailable(const BufferItem& /*item*/) {
             continue;
         }
 
+        if (shouldSkipOutputLocked(id)) {
+            // Latest-only output that has fallen behind; drop this frame for
+            // it instead of letting its queue rate-limit the split. Release
+            // our reference so the buffer can return to the input once the
+            // remaining outputs are done with it.
+            SP_LOGV("%s: skipping frame %" PRIu64 " for backed up output %zu",
+                    __FUNCTION__, bufferItem.mFrameNumber, id);
+            decrementBufRefCountLocked(bufferId, id);
+            continue;
+        }
+
         res = outputBufferLocked(mOutputs[id], bufferItem, id);
         if (res != OK) {
             SP_LOGE("%s: outputBufferLocked failed %d", __FUNCTION__, res);
@@ -700,6 +743,12 @@ void Camera3StreamSplitter::returnOutputBufferLocked(const sp<Fence>& fence,
 
     auto outputSlots = *mOutputSlots[from];
     buffer = outputSlots[slot];
+
+    size_t& pendingBuffers = mOutputPendingBuffers[surfaceId];
+    if (pendingBuffers > 0) {
+        pendingBuffers--;
+    }
+
     BufferTracker& tracker = *(mBuffers[buffer->getId()]);
     // Merge the release fence of the incoming buffer so that the fence we send
     // back to the input includes all of the outputs' fences
@@ -221,6 +221,12 @@ private:
     status_t outputBufferLocked(const sp<IGraphicBufferProducer>& output,
             const BufferItem& bufferItem, size_t surfaceId);
 
+    // Whether the incoming frame should be dropped for this output instead of
+    // queued. Only latest-only outputs that have fallen behind their consumer
+    // buffer budget are skipped; full-sequence outputs always receive every
+    // frame.
+    bool shouldSkipOutputLocked(size_t surfaceId);
+
     // Get unique name for the buffer queue consumer
     String8 getUniqueConsumerName();
 
@@ -242,6 +248,17 @@ private:
     static const nsecs_t kNormalDequeueBufferTimeout    = s2ns(1);  // 1 sec
     static const nsecs_t kHalBufMgrDequeueBufferTimeout = ms2ns(1); // 1 msec
 
+    // Frame forwarding policy for an output, decided by its consumer usage
+    // when the output is added. Preview-class consumers (composer/GPU texture)
+    // only ever display the most recent frame, so the splitter may skip
+    // forwarding to them when they fall behind rather than letting them
+    // rate-limit the split. Encoder-class and CPU consumers receive the full
+    // frame sequence.
+    enum class OutputPolicy {
+        FULL_SEQUENCE,
+        LATEST_ONLY,
+    };
+
     Mutex mMutex;
 
     sp<IGraphicBufferProducer> mProducer;
@@ -261,6 +278,12 @@ private:
     //Map surface ids -> consumer buffer count
     std::unordered_map<int, size_t > mConsumerBufferCount;
 
+    //Map surface ids -> frame forwarding policy
+    std::unordered_map<int, OutputPolicy> mOutputPolicies;
+
+    //Map surface ids -> buffers queued to the output but not yet released back
+    std::unordered_map<int, size_t> mOutputPendingBuffers;
+
     // Map of GraphicBuffer IDs (GraphicBuffer::getId()) to buffer tracking
     // objects (which are mostly for counting how many outputs have released the
     // buffer, but also contain merged release fences).
@@ -260,8 +260,9 @@ status_t DistortionMapper::updateCalibration(const CameraMetadata &result, bool
     }
 
     mapperInfo->mValidMapping = true;
-    // Need to recalculate grid
+    // Need to recalculate grid and lookup table
     mapperInfo->mValidGrids = false;
+    mapperInfo->mValidLut = false;
 
     return OK;
 }
@@ -277,40 +278,53 @@ status_t DistortionMapper::mapRawToCorrected(int32_t *coordPairs, int coordCount
         if (res != OK) return res;
     }
 
+    if (!mapperInfo->mValidLut) {
+        // Best effort; if the table can't be built, points go through the
+        // full grid search below instead
+        buildInverseLut(mapperInfo);
+    }
+
     for (int i = 0; i < coordCount * 2; i += 2) {
-        const GridQuad *quad = findEnclosingQuad(coordPairs + i, mapperInfo->mDistortedGrid);
-        if (quad == nullptr) {
-            ALOGE("Raw to corrected mapping failure: No quad found for (%d, %d)",
-                    *(coordPairs + i), *(coordPairs + i + 1));
-            return INVALID_OPERATION;
-        }
-        ALOGV("src xy: %d, %d, enclosing quad: (%f, %f), (%f, %f), (%f, %f), (%f, %f)",
-                coordPairs[i], coordPairs[i+1],
-                quad->coords[0], quad->coords[1],
-                quad->coords[2], quad->coords[3],
-                quad->coords[4], quad->coords[5],
-                quad->coords[6], quad->coords[7]);
-
-        const GridQuad *corrQuad = quad->src;
-        if (corrQuad == nullptr) {
-            ALOGE("Raw to corrected mapping failure: No src quad found");
-            return INVALID_OPERATION;
-        }
-        ALOGV("              corr quad: (%f, %f), (%f, %f), (%f, %f), (%f, %f)",
-                corrQuad->coords[0], corrQuad->coords[1],
-                corrQuad->coords[2], corrQuad->coords[3],
-                corrQuad->coords[4], corrQuad->coords[5],
-                corrQuad->coords[6], corrQuad->coords[7]);
+        float corrX, corrY;
+        if (mapperInfo->mValidLut &&
+                lookupCorrectedFromLut(mapperInfo, coordPairs + i, &corrX, &corrY)) {
+            ALOGV("src xy: %d, %d mapped via LUT to: %f, %f",
+                    coordPairs[i], coordPairs[i+1], corrX, corrY);
+        } else {
+            const GridQuad *quad = findEnclosingQuad(coordPairs + i, mapperInfo->mDistortedGrid);
+            if (quad == nullptr) {
+                ALOGE("Raw to corrected mapping failure: No quad found for (%d, %d)",
+                        *(coordPairs + i), *(coordPairs + i + 1));
+                return INVALID_OPERATION;
+            }
+            ALOGV("src xy: %d, %d, enclosing quad: (%f, %f), (%f, %f), (%f, %f), (%f, %f)",
+                    coordPairs[i], coordPairs[i+1],
+                    quad->coords[0], quad->coords[1],
+                    quad->coords[2], quad->coords[3],
+                    quad->coords[4], quad->coords[5],
+                    quad->coords[6], quad->coords[7]);
+
+            const GridQuad *corrQuad = quad->src;
+            if (corrQuad == nullptr) {
+                ALOGE("Raw to corrected mapping failure: No src quad found");
+                return INVALID_OPERATION;
+            }
+            ALOGV("              corr quad: (%f, %f), (%f, %f), (%f, %f), (%f, %f)",
+                    corrQuad->coords[0], corrQuad->coords[1],
+                    corrQuad->coords[2], corrQuad->coords[3],
+                    corrQuad->coords[4], corrQuad->coords[5],
+                    corrQuad->coords[6], corrQuad->coords[7]);
 
-        float u = calculateUorV(coordPairs + i, *quad, /*calculateU*/ true);
-        float v = calculateUorV(coordPairs + i, *quad, /*calculateU*/ false);
+            float u = calculateUorV(coordPairs + i, *quad, /*calculateU*/ true);
+            float v = calculateUorV(coordPairs + i, *quad, /*calculateU*/ false);
 
-        ALOGV("uv: %f, %f", u, v);
+            ALOGV("uv: %f, %f", u, v);
 
-        // Interpolate along top edge of corrected quad (which are axis-aligned) for x
-        float corrX = corrQuad->coords[0] + u * (corrQuad->coords[2] - corrQuad->coords[0]);
-        // Interpolate along left edge of corrected quad (which are axis-aligned) for y
-        float corrY = corrQuad->coords[1] + v * (corrQuad->coords[7] - corrQuad->coords[1]);
+            // Interpolate along top edge of corrected quad (which are axis-aligned) for x
+            corrX = corrQuad->coords[0] + u * (corrQuad->coords[2] - corrQuad->coords[0]);
+            // Interpolate along left edge of corrected quad (which are axis-aligned) for y
+            corrY = corrQuad->coords[1] + v * (corrQuad->coords[7] - corrQuad->coords[1]);
+        }
 
         // Clamp to within active array
         if (clamp) {
@@ -492,44 +506,126 @@ status_t DistortionMapper::buildGrids(DistortionMapperInfo *mapperInfo) {
     return OK;
 }
 
+status_t DistortionMapper::buildInverseLut(DistortionMapperInfo *mapperInfo) {
+    if (!mapperInfo->mValidGrids) return INVALID_OPERATION;
+
+    mapperInfo->mLutSpacingX = (mapperInfo->mArrayWidth - 1) / (kLutSize - 1);
+    mapperInfo->mLutSpacingY = (mapperInfo->mArrayHeight - 1) / (kLutSize - 1);
+    mapperInfo->mLutCorrected.resize(2 * kLutSize * kLutSize);
+
+    // Consecutive nodes usually share an enclosing quad, so try the previous
+    // node's quad before falling back to the full grid search
+    const GridQuad *last = nullptr;
+    size_t index = 0;
+    for (size_t j = 0; j < kLutSize; j++) {
+        float y = j * mapperInfo->mLutSpacingY;
+        for (size_t i = 0; i < kLutSize; i++, index += 2) {
+            float x = i * mapperInfo->mLutSpacingX;
+            float pt[2] = { x, y };
+            const GridQuad *quad = (last != nullptr && quadContains(*last, x, y)) ?
+                    last : findEnclosingQuad(pt, mapperInfo->mDistortedGrid);
+            if (quad == nullptr || quad->src == nullptr) {
+                ALOGW("%s: No enclosing quad for LUT node (%f, %f); falling back to "
+                        "per-point grid search", __FUNCTION__, x, y);
+                return INVALID_OPERATION;
+            }
+            last = quad;
+
+            float u = calculateUorV(pt, *quad, /*calculateU*/ true);
+            float v = calculateUorV(pt, *quad, /*calculateU*/ false);
+
+            const GridQuad *corrQuad = quad->src;
+            // Interpolate along top edge of corrected quad (which are axis-aligned) for x
+            mapperInfo->mLutCorrected[index] =
+                    corrQuad->coords[0] + u * (corrQuad->coords[2] - corrQuad->coords[0]);
+            // Interpolate along left edge of corrected quad (which are axis-aligned) for y
+            mapperInfo->mLutCorrected[index + 1] =
+                    corrQuad->coords[1] + v * (corrQuad->coords[7] - corrQuad->coords[1]);
+        }
+    }
+
+    mapperInfo->mValidLut = true;
+    return OK;
+}
+
+bool DistortionMapper::lookupCorrectedFromLut(const DistortionMapperInfo *mapperInfo,
+        const int32_t pt[2], /*out*/float *corrX, /*out*/float *corrY) {
+    const float x = pt[0];
+    const float y = pt[1];
+    if (x < 0 || x > mapperInfo->mArrayWidth - 1 ||
+            y < 0 || y > mapperInfo->mArrayHeight - 1) {
+        return false;
+    }
+
+    float fx = x / mapperInfo->mLutSpacingX;
+    float fy = y / mapperInfo->mLutSpacingY;
+    size_t ix = std::min(static_cast<size_t>(fx), kLutSize - 2);
+    size_t iy = std::min(static_cast<size_t>(fy), kLutSize - 2);
+    float tx = fx - ix;
+    float ty = fy - iy;
+
+    const float *n00 = mapperInfo->mLutCorrected.data() + 2 * (iy * kLutSize + ix);
+    const float *n01 = n00 + 2;            // node (ix + 1, iy)
+    const float *n10 = n00 + 2 * kLutSize; // node (ix, iy + 1)
+    const float *n11 = n10 + 2;            // node (ix + 1, iy + 1)
+
+    float top    = n00[0] + tx * (n01[0] - n00[0]);
+    float bottom = n10[0] + tx * (n11[0] - n10[0]);
+    *corrX = top + ty * (bottom - top);
+
+    top    = n00[1] + tx * (n01[1] - n00[1]);
+    bottom = n10[1] + tx * (n11[1] - n10[1]);
+    *corrY = top + ty * (bottom - top);
+
+    return true;
+}
+
+bool DistortionMapper::quadContains(const GridQuad &quad, float x, float y) {
+    const float &x1 = quad.coords[0];
+    const float &y1 = quad.coords[1];
+    const float &x2 = quad.coords[2];
+    const float &y2 = quad.coords[3];
+    const float &x3 = quad.coords[4];
+    const float &y3 = quad.coords[5];
+    const float &x4 = quad.coords[6];
+    const float &y4 = quad.coords[7];
+
+    // Point-in-quad test:
+
+    // Quad has corners P1-P4; if P is within the quad, then it is on the same side of all the
+    // edges (or on top of one of the edges or corners), traversed in a consistent direction.
+    // This means that the cross product of edge En = Pn->P(n+1 mod 4) and line Ep = Pn->P must
+    // have the same sign (or be zero) for all edges.
+    // For clockwise traversal, the sign should be negative or zero for Ep x En, indicating that
+    // En is to the left of Ep, or overlapping.
+    float s1 = (x - x1) * (y2 - y1) - (y - y1) * (x2 - x1);
+    if (s1 > 0) return false;
+    float s2 = (x - x2) * (y3 - y2) - (y - y2) * (x3 - x2);
+    if (s2 > 0) return false;
+    float s3 = (x - x3) * (y4 - y3) - (y - y3) * (x4 - x3);
+    if (s3 > 0) return false;
+    float s4 = (x - x4) * (y1 - y4) - (y - y4) * (x1 - x4);
+    if (s4 > 0) return false;
+
+    return true;
+}
+
+template<typename T>
 const DistortionMapper::GridQuad* DistortionMapper::findEnclosingQuad(
-        const int32_t pt[2], const std::vector<GridQuad>& grid) {
+        const T pt[2], const std::vector<GridQuad>& grid) {
     const float x = pt[0];
     const float y = pt[1];
 
     for (const GridQuad& quad : grid) {
-        const float &x1 = quad.coords[0];
-        const float &y1 = quad.coords[1];
-        const float &x2 = quad.coords[2];
-        const float &y2 = quad.coords[3];
-        const float &x3 = quad.coords[4];
-        const float &y3 = quad.coords[5];
-        const float &x4 = quad.coords[6];
-        const float &y4 = quad.coords[7];
-
-        // Point-in-quad test:
-
-        // Quad has corners P1-P4; if P is within the quad, then it is on the same side of all the
-        // edges (or on top of one of the edges or corners), traversed in a consistent direction.
-        // This means that the cross product of edge En = Pn->P(n+1 mod 4) and line Ep = Pn->P must
-        // have the same sign (or be zero) for all edges.
-        // For clockwise traversal, the sign should be negative or zero for Ep x En, indicating that
-        // En is to the left of Ep, or overlapping.
-        float s1 = (x - x1) * (y2 - y1) - (y - y1) * (x2 - x1);
-        if (s1 > 0) continue;
-        float s2 = (x - x2) * (y3 - y2) - (y - y2) * (x3 - x2);
-        if (s2 > 0) continue;
-        float s3 = (x - x3) * (y4 - y3) - (y - y3) * (x4 - x3);
-        if (s3 > 0) continue;
-        float s4 = (x - x4) * (y1 - y4) - (y - y4) * (x1 - x4);
-        if (s4 > 0) continue;
-
-        return &quad;
+        if (quadContains(quad, x, y)) {
+            return &quad;
+        }
     }
     return nullptr;
 }
 
-float DistortionMapper::calculateUorV(const int32_t pt[2], const GridQuad& quad, bool calculateU) {
+template<typename T>
+float DistortionMapper::calculateUorV(const T pt[2], const GridQuad& quad, bool calculateU) {
     const float x = pt[0];
     const float y = pt[1];
     const float &x1 = quad.coords[0];
@@ -155,11 +155,20 @@ class DistortionMapper : public CoordinateMapper {
 
         std::vector<GridQuad> mCorrectedGrid;
         std::vector<GridQuad> mDistortedGrid;
+
+        // Dense lookup table for the raw -> corrected mapping; regenerated
+        // whenever the calibration changes. Nodes are regularly spaced over
+        // the pre-correction active array and store the corrected (x, y) of
+        // the node position; lookups bilinearly interpolate between nodes.
+        bool mValidLut = false;
+        std::vector<float> mLutCorrected; // 2 floats (x, y) per node
+        float mLutSpacingX, mLutSpacingY;
     };
 
     // Find which grid quad encloses the point; returns null if none do
+    template<typename T>
     static const GridQuad* findEnclosingQuad(
-            const int32_t pt[2], const std::vector<GridQuad>& grid);
+            const T pt[2], const std::vector<GridQuad>& grid);
 
     // Calculate 'horizontal' interpolation coordinate for the point and the quad
     // Assumes the point P is within the quad Q.
@@ -172,7 +181,8 @@ class DistortionMapper : public CoordinateMapper {
     // 0 to 1 is the one chosen.
     // If calculateU is true, then an interpolation coordinate for edges E12 and E43 is found;
     // if it is false, then an interpolation coordinate for edges E14 and E23 is found.
-    static float calculateUorV(const int32_t pt[2], const GridQuad& quad, bool calculateU);
+    template<typename T>
+    static float calculateUorV(const T pt[2], const GridQuad& quad, bool calculateU);
 
     DistortionMapperInfo *getMapperInfo(bool maxResolution = false) {
           return maxResolution ? &mDistortionMapperInfoMaximumResolution :
@@ -184,6 +194,8 @@ class DistortionMapper : public CoordinateMapper {
 
     // Number of quads in each dimension of the mapping grids
     constexpr static size_t kGridSize = 15;
+    // Number of nodes in each dimension of the inverse-mapping lookup table
+    constexpr static size_t kLutSize = 65;
     // Margin to expand the grid by to ensure it doesn't clip the domain
     constexpr static float kGridMargin = 0.05f;
     // Fuzziness for float inequality tests
@@ -209,6 +221,18 @@ class DistortionMapper : public CoordinateMapper {
     // Utility to create reverse mapping grids
     status_t buildGrids(DistortionMapperInfo *mapperInfo);
 
+    // Precompute the raw -> corrected lookup table from the mapping grids
+    status_t buildInverseLut(DistortionMapperInfo *mapperInfo);
+
+    // Bilinearly interpolate the corrected coordinates of a raw point from
+    // the lookup table; returns false if the point is outside the table's
+    // domain and must go through the full grid search instead
+    static bool lookupCorrectedFromLut(const DistortionMapperInfo *mapperInfo,
+            const int32_t pt[2], /*out*/float *corrX, /*out*/float *corrY);
+
+    // Whether the quad contains the point, or the point lies on its boundary
+    static bool quadContains(const GridQuad &quad, float x, float y);
+
     DistortionMapperInfo mDistortionMapperInfo;
     DistortionMapperInfo mDistortionMapperInfoMaximumResolution;
 
@@ -379,8 +379,11 @@ status_t AidlCamera3Device::initialize(sp<CameraProviderManager> manager,
         mOverrideToPortrait}, mResultMetadataQueue
     };
 
-    for (const auto& result : results) {
-        processOneCaptureResultLocked(states, result, result.physicalCameraMetadata);
+    {
+        InflightBatchLock batchLock(states);
+        for (const auto& result : results) {
+            processOneCaptureResultLocked(states, result, result.physicalCameraMetadata);
+        }
     }
     mProcessCaptureResultLock.unlock();
     return ::ndk::ScopedAStatus::ok();
@@ -129,8 +129,11 @@ status_t AidlCamera3OfflineSession::initialize(wp<NotificationListener> listener
     };
 
     std::lock_guard<std::mutex> lock(mProcessCaptureResultLock);
-    for (const auto& result : results) {
-        processOneCaptureResultLocked(states, result, result.physicalCameraMetadata);
+    {
+        InflightBatchLock batchLock(states);
+        for (const auto& result : results) {
+            processOneCaptureResultLocked(states, result, result.physicalCameraMetadata);
+        }
     }
     return ::ndk::ScopedAStatus::ok();
 }
@@ -384,8 +384,11 @@ hardware::Return<void> HidlCamera3Device::processCaptureResult_3_4(
     //HidlCaptureOutputStates hidlStates {
     //}
 
-    for (const auto& result : results) {
-        processOneCaptureResultLocked(states, result.v3_2, result.physicalCameraMetadata);
+    {
+        InflightBatchLock batchLock(states);
+        for (const auto& result : results) {
+            processOneCaptureResultLocked(states, result.v3_2, result.physicalCameraMetadata);
+        }
     }
     mProcessCaptureResultLock.unlock();
     return hardware::Void();
@@ -444,8 +447,11 @@ hardware::Return<void> HidlCamera3Device::processCaptureResult(
         mResultMetadataQueue
     };
 
-    for (const auto& result : results) {
-        processOneCaptureResultLocked(states, result, noPhysMetadata);
+    {
+        InflightBatchLock batchLock(states);
+        for (const auto& result : results) {
+            processOneCaptureResultLocked(states, result, noPhysMetadata);
+        }
     }
     mProcessCaptureResultLock.unlock();
     return hardware::Void();
@@ -110,8 +110,11 @@ hardware::Return<void> HidlCamera3OfflineSession::processCaptureResult_3_4(
     };
 
     std::lock_guard<std::mutex> lock(mProcessCaptureResultLock);
-    for (const auto& result : results) {
-        processOneCaptureResultLocked(states, result.v3_2, result.physicalCameraMetadata);
+    {
+        InflightBatchLock batchLock(states);
+        for (const auto& result : results) {
+            processOneCaptureResultLocked(states, result.v3_2, result.physicalCameraMetadata);
+        }
     }
     return hardware::Void();
 }
@@ -151,8 +154,11 @@ hardware::Return<void> HidlCamera3OfflineSession::processCaptureResult(
     };
 
     std::lock_guard<std::mutex> lock(mProcessCaptureResultLock);
-    for (const auto& result : results) {
-        processOneCaptureResultLocked(states, result, noPhysMetadata);
+    {
+        InflightBatchLock batchLock(states);
+        for (const auto& result : results) {
+            processOneCaptureResultLocked(states, result, noPhysMetadata);
+        }
     }
     return hardware::Void();
 }
@@ -29,8 +29,48 @@
 
 namespace android {
 
+namespace {
+
+// A tiny all-zero data source that no sniffer recognizes. Running the
+// sniffers over it once at service start faults in each plugin's code
+// pages, so the first real makeExtractor after a service (re)start does
+// not pay for them.
+class WarmUpDataSource : public DataSource {
+public:
+    status_t initCheck() const override { return OK; }
+
+    ssize_t readAt(off64_t offset, void *data, size_t size) override {
+        if (offset < 0 || offset >= (off64_t)kSize) {
+            return 0;
+        }
+        size_t avail = kSize - offset;
+        if (size > avail) {
+            size = avail;
+        }
+        memset(data, 0, size);
+        return size;
+    }
+
+    status_t getSize(off64_t *size) override {
+        *size = kSize;
+        return OK;
+    }
+
+    uint32_t flags() override {
+        return 0;
+    }
+
+private:
+    static constexpr size_t kSize = 32;
+};
+
+}  // anonymous namespace
+
 MediaExtractorService::MediaExtractorService() {
     MediaExtractorFactory::LoadExtractors();
+    // Warm up the freshly loaded plugins before the service goes live.
+    // This is expected to find no suitable extractor and return null.
+    MediaExtractorFactory::CreateFromService(new WarmUpDataSource(), nullptr);
 }
 
 MediaExtractorService::~MediaExtractorService() {
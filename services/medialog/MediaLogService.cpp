@@ -131,6 +131,25 @@ status_t MediaLogService::dump(int fd, const Vector<String16>& args __unused)
                 }
             }
             mLock.unlock();
+        } else if (!strcmp(arg0.string(), "-b")) {
+            // binary dump of all threads' timestamped entries, merge-sorted by
+            // timestamp, for offline analysis; meant to be redirected to a file
+            if (fd >= 0) {
+                // needed because the merger's readers are registered under mLock
+                bool locked = dumpTryLock(mLock);
+                if (!locked) {
+                    String8 result(kDeadlockedString);
+                    write(fd, result.string(), result.size());
+                    return NO_ERROR;
+                }
+                std::vector<sp<NBLog::Reader>> readers;
+                readers.reserve(mDumpReaders.size());
+                for (const auto &dumpReader : mDumpReaders) {
+                    readers.push_back(dumpReader);
+                }
+                NBLog::Merger::dump(fd, readers);
+                mLock.unlock();
+            }
         } else {
             mMergeReader.dump(fd, args);
         }
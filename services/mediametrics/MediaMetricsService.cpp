@@ -62,6 +62,15 @@ static constexpr size_t kMaxExpiredAtOnce = 50;
 
 // TODO: need to look at tuning kMaxRecords and friends for low-memory devices
 
+// Raw item retention is configurable for always-on devices (e.g. TVs)
+// where the default window keeps more than wanted; expired items are
+// folded into bounded per-key rollups either way, so shortening the
+// window loses per-item detail but no aggregate history.
+static nsecs_t getMaxRecordAgeNs() {
+    const int32_t ageSeconds = property_get_int32("media.metrics.record_age_seconds", 0);
+    return ageSeconds > 0 ? ageSeconds * NANOS_PER_SECOND : kMaxRecordAgeNs;
+}
+
 /* static */
 nsecs_t MediaMetricsService::roundTime(nsecs_t timeNs)
 {
@@ -105,7 +114,7 @@ MediaMetricsService::getSanitizedPackageNameAndVersionCode(uid_t uid) {
 
 MediaMetricsService::MediaMetricsService()
         : mMaxRecords(kMaxRecords),
-          mMaxRecordAgeNs(kMaxRecordAgeNs),
+          mMaxRecordAgeNs(getMaxRecordAgeNs()),
           mMaxRecordsExpiredAtOnce(kMaxExpiredAtOnce)
 {
     ALOGD("%s", __func__);
@@ -114,6 +123,8 @@ MediaMetricsService::MediaMetricsService()
 MediaMetricsService::~MediaMetricsService()
 {
     ALOGD("%s", __func__);
+    // stop the intake worker while the members it references are still valid.
+    mIntake.quit();
     // the class destructor clears anyhow, but we enforce clearing items first.
     mItemsDiscarded += (int64_t)mItems.size();
     mItems.clear();
@@ -214,13 +225,24 @@ status_t MediaMetricsService::submitInternal(mediametrics::Item *item, bool rele
         }
     }
 
-    (void)mAudioAnalytics.submit(sitem, isTrusted);
-
-    (void)dump2Statsd(sitem, mStatsdLog);  // failure should be logged in function.
-    saveItem(sitem);
+    // Hand the item to the intake ring; aggregation, statsd logging and the
+    // local queue run deferred on the intake worker thread, so this call never
+    // waits on another submitter or on a dump in progress.
+    if (!mIntake.push(sitem, isTrusted)) {
+        ++mItemsIntakeDropped; // ring full: the worker is stalled or flooded.
+    }
     return NO_ERROR;
 }
 
+void MediaMetricsService::processIntake(
+        const std::shared_ptr<const mediametrics::Item>& item, bool isTrusted)
+{
+    (void)mAudioAnalytics.submit(item, isTrusted);
+
+    (void)dump2Statsd(item, mStatsdLog);  // failure should be logged in function.
+    saveItem(item);
+}
+
 status_t MediaMetricsService::dump(int fd, const Vector<String16>& args)
 {
     if (checkCallingPermission(String16("android.permission.DUMP")) == false) {
@@ -297,6 +319,10 @@ status_t MediaMetricsService::dump(int fd, const Vector<String16>& args)
             unreachable = true;
         }
     }
+    // Drain the intake ring so the dump reflects submissions that have
+    // already returned to their callers.
+    mIntake.flush();
+
     std::stringstream result;
     {
         std::lock_guard _l(mLock);
@@ -305,12 +331,23 @@ status_t MediaMetricsService::dump(int fd, const Vector<String16>& args)
             mItemsDiscarded += (int64_t)mItems.size();
             mItems.clear();
             mAudioAnalytics.clear();
+            mRollups.clear();
         } else {
             result << StringPrintf("Dump of the %s process:\n", kServiceName);
             const char *prefixptr = prefix.size() > 0 ? prefix.c_str() : nullptr;
             result << dumpHeaders(sinceNs, prefixptr);
             result << dumpQueue(sinceNs, prefixptr);
 
+            const int32_t rollupLinesToDump = all ? INT32_MAX : 40;
+            result << StringPrintf("Expired item rollups: %zu keys gc(%lld)\n",
+                    mRollups.size(), (long long)mRollups.getGarbageCollectionCount());
+            const auto [ rollupDumpString, rollupLines ] =
+                    mRollups.dump(rollupLinesToDump, sinceNs, prefixptr);
+            result << rollupDumpString;
+            if (rollupLines == rollupLinesToDump) {
+                result << "-- some lines may be truncated --\n";
+            }
+
             // TODO: maybe consider a better way of dumping audio analytics info.
             const int32_t linesToDump = all ? INT32_MAX : 1000;
             auto [ dumpString, lines ] = mAudioAnalytics.dump(linesToDump, sinceNs, prefixptr);
@@ -388,6 +425,8 @@ std::string MediaMetricsService::dumpHeaders(int64_t sinceNs, const char* prefix
             "Records Discarded: %lld (by Count: %lld by Expiration: %lld)\n",
             (long long)mItemsDiscarded, (long long)mItemsDiscardedCount,
             (long long)mItemsDiscardedExpire);
+    result << StringPrintf(
+            "Intake Ring Drops: %lld\n", (long long)mItemsIntakeDropped.load());
     if (prefix != nullptr) {
         result << "Restricting to prefix " << prefix << "\n";
     }
@@ -469,6 +508,11 @@ bool MediaMetricsService::expirations(const std::shared_ptr<const mediametrics::
         mItemsDiscardedCount += (int64_t)overlimit;
         mItemsDiscardedExpire += (int64_t)expired;
         mItemsDiscarded += (int64_t)toErase;
+        // fold discarded items into per-key rollups before they go;
+        // the rollups are bounded, so memory stays flat however long we run.
+        for (auto it = mItems.begin(); it != mItems.begin() + (ptrdiff_t)toErase; ++it) {
+            mRollups.fold(*it);
+        }
         mItems.erase(mItems.begin(), mItems.begin() + (ptrdiff_t)toErase); // erase from front
     }
     return more;
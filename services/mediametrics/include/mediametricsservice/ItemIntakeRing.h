@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <android-base/thread_annotations.h>
+#include <log/log.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <media/MediaMetricsItem.h>
+
+namespace android::mediametrics {
+
+/**
+ * ItemIntakeRing decouples item submission from item aggregation.
+ *
+ * Submitters (binder threads servicing time-critical clients such as
+ * audioserver) push items into a bounded multi-producer single-consumer
+ * ring without ever taking a lock or waiting on the consumer; aggregation
+ * runs deferred on an internal worker thread.  This prevents priority
+ * inversion between a real-time submitter and a thread holding the
+ * aggregation locks (e.g. during dump).
+ *
+ * push() never blocks: producers claim a slot with an atomic increment
+ * (retried only when racing another producer) and publish with a
+ * release store on the slot sequence, following the classic bounded
+ * sequence-numbered ring.  If the ring is full because the consumer has
+ * stalled, the item is dropped and counted rather than waited for.
+ *
+ * The consumer side uses an ordinary mutex and condition variable - only
+ * the producer path needs to be wait-free.  Producers notify the worker
+ * without holding the lock; a missed wakeup from that benign race is
+ * bounded by the worker's poll timeout.
+ */
+class ItemIntakeRing {
+public:
+    using Consumer = std::function<void(
+            const std::shared_ptr<const mediametrics::Item>& item, bool isTrusted)>;
+
+    static constexpr size_t kDefaultCapacity = 512;  // must be a power of 2.
+
+    explicit ItemIntakeRing(Consumer consumer, size_t capacity = kDefaultCapacity)
+        : mConsumer(std::move(consumer))
+        , mMask(capacity - 1)
+        , mCells(capacity)
+    {
+        LOG_ALWAYS_FATAL_IF((capacity & mMask) != 0, "capacity %zu not a power of 2", capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mThread = std::thread([this](){ threadLoop(); });
+    }
+
+    ~ItemIntakeRing() {
+        quit();
+    }
+
+    /**
+     * Queues an item for deferred aggregation.  Never blocks.
+     *
+     * \return true if the item was accepted, false if the ring was full
+     *         and the item was dropped (see dropped()).
+     */
+    bool push(const std::shared_ptr<const mediametrics::Item>& item, bool isTrusted) {
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = mCells[pos & mMask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0) {
+                if (mEnqueuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.isTrusted = isTrusted;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    // Unlocked notify: racing past the worker's predicate check
+                    // only delays consumption until the poll timeout.
+                    mWorkCondition.notify_one();
+                    return true;
+                }
+                // lost the slot to another producer, pos was reloaded by the CAS.
+            } else if (dif < 0) {
+                mDropped.fetch_add(1, std::memory_order_relaxed);  // ring full.
+                return false;
+            } else {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Waits until every item pushed before this call has been consumed.
+     * Used to make dump() reflect submissions that have already returned.
+     */
+    void flush() {
+        const size_t target = mEnqueuePos.load(std::memory_order_acquire);
+        std::unique_lock l(mLock);
+        mWorkCondition.notify_one();
+        mDrainedCondition.wait(l, [this, target] {
+            return mQuit || mConsumed.load(std::memory_order_acquire) >= target;
+        });
+    }
+
+    void quit() {
+        {
+            std::lock_guard l(mLock);
+            if (mQuit) return;
+            mQuit = true;
+            mWorkCondition.notify_all();
+            mDrainedCondition.notify_all();
+        }
+        mThread.join();
+        // Drain stragglers on the caller's thread so no accepted item is lost.
+        drain();
+    }
+
+    /** Returns the number of items dropped because the ring was full. */
+    int64_t dropped() const {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        std::shared_ptr<const mediametrics::Item> item;
+        bool isTrusted = false;
+    };
+
+    // Single consumer only - called from the worker thread or quit().
+    bool pop(std::shared_ptr<const mediametrics::Item>& item, bool& isTrusted) {
+        Cell &cell = mCells[mDequeuePos & mMask];
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(mDequeuePos + 1) < 0) return false;  // empty.
+        item = std::move(cell.item);
+        isTrusted = cell.isTrusted;
+        cell.sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+        ++mDequeuePos;
+        return true;
+    }
+
+    void drain() {
+        std::shared_ptr<const mediametrics::Item> item;
+        bool isTrusted;
+        while (pop(item, isTrusted)) {
+            mConsumer(item, isTrusted);
+            item.reset();
+            mConsumed.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void threadLoop() NO_THREAD_SAFETY_ANALYSIS { // thread safety doesn't cover unique_lock
+        std::unique_lock l(mLock);
+        while (!mQuit) {
+            l.unlock();
+            drain();
+            l.lock();
+            mDrainedCondition.notify_all();
+            if (mQuit) break;
+            // The timeout covers the benign unlocked-notify race in push().
+            mWorkCondition.wait_for(l, std::chrono::seconds(1));
+        }
+    }
+
+    const Consumer mConsumer;
+    const size_t mMask;
+    std::vector<Cell> mCells;
+
+    std::atomic<size_t> mEnqueuePos{};  // next slot to claim (producers).
+    size_t mDequeuePos = 0;             // consumer only.
+    std::atomic<size_t> mConsumed{};    // items fully handed to mConsumer.
+    std::atomic<int64_t> mDropped{};    // items rejected with a full ring.
+
+    mutable std::mutex mLock;
+    std::condition_variable mWorkCondition GUARDED_BY(mLock);
+    std::condition_variable mDrainedCondition GUARDED_BY(mLock);
+    bool mQuit GUARDED_BY(mLock) = false;
+
+    // needs to be initialized after the variables above, done in constructor.
+    std::thread mThread;
+};
+
+} // namespace android::mediametrics
@@ -30,6 +30,8 @@
 #include <utils/String8.h>
 
 #include "AudioAnalytics.h"
+#include "ItemIntakeRing.h"
+#include "RollupLog.h"
 
 namespace android {
 
@@ -97,6 +99,9 @@ private:
     bool isRateLimited(mediametrics::Item *) const;
     void saveItem(const std::shared_ptr<const mediametrics::Item>& item);
 
+    // deferred aggregation of a submitted item, runs on the intake worker thread.
+    void processIntake(const std::shared_ptr<const mediametrics::Item>& item, bool isTrusted);
+
     bool expirations(const std::shared_ptr<const mediametrics::Item>& item) REQUIRES(mLock);
 
     // support for generating output
@@ -123,6 +128,7 @@ private:
     const size_t mMaxRecordsExpiredAtOnce;
 
     std::atomic<int64_t> mItemsSubmitted{}; // accessed outside of lock.
+    std::atomic<int64_t> mItemsIntakeDropped{}; // accessed outside of lock.
 
     // mStatsdLog is locked internally (thread-safe) and shows the last atoms logged
     static constexpr size_t STATSD_LOG_LINES_MAX = 48; // recent log lines to keep
@@ -133,6 +139,10 @@ private:
     // mAudioAnalytics is locked internally.
     mediametrics::AudioAnalytics mAudioAnalytics{mStatsdLog};
 
+    // Bounded per-key rollups of items that aged out of mItems;
+    // locked internally.
+    mediametrics::RollupLog mRollups;
+
     std::mutex mLock;
     // statistics about our analytics
     int64_t mItemsFinalized GUARDED_BY(mLock) = 0;
@@ -153,6 +163,15 @@ private:
     using ItemKey = std::string;
     using WeakItemQueue = std::deque<std::weak_ptr<const mediametrics::Item>>;
     std::unordered_map<ItemKey, WeakItemQueue> mPullableItems GUARDED_BY(mLock);
+
+    // Lock-free intake ring: submitInternal() pushes here without blocking and
+    // processIntake() aggregates on the ring's worker thread.
+    // Declared last (and stopped first in the destructor) as the worker
+    // references the members above.
+    mediametrics::ItemIntakeRing mIntake{
+            [this](const std::shared_ptr<const mediametrics::Item>& item, bool isTrusted) {
+                processIntake(item, isTrusted);
+            }};
 };
 
 } // namespace android
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include <android-base/thread_annotations.h>
+#include <media/MediaMetricsItem.h>
+
+namespace android::mediametrics {
+
+/**
+ * The RollupLog keeps per-key aggregate statistics for items that have
+ * aged out of the raw item queue.
+ *
+ * Raw items keep full fidelity while they are recent; once the expiry
+ * path folds an item in here, only its per-key rollup survives: item
+ * count, first/last timestamp, and sum/min/max/count for each numeric
+ * property.  Strings and rates are counted but not retained.
+ *
+ * Memory is bounded forever: at most maxKeys rollups, each holding at
+ * most kMaxNumericPropsPerKey fixed-size numeric statistics.  When a
+ * new key would exceed maxKeys, the rollup with the oldest last-folded
+ * timestamp is evicted (and counted as a garbage collection).
+ *
+ * The RollupLog is internally locked, following TimeMachine and
+ * TransactionLog.
+ */
+class RollupLog final {
+public:
+    // Rollup keys are item keys (e.g. "audio.track.10"), so the key
+    // population is bounded by session churn; 200 covers a busy device's
+    // retention window.  Estimated max data usage is
+    // maxKeys * kMaxNumericPropsPerKey * sizeof(NumericStats) ~ 256KB.
+    static inline constexpr size_t kDefaultMaxKeys = 200;
+    static inline constexpr size_t kMaxNumericPropsPerKey = 32;
+
+    explicit RollupLog(size_t maxKeys = kDefaultMaxKeys)
+        : mMaxKeys(maxKeys) {
+        LOG_ALWAYS_FATAL_IF(maxKeys == 0, "%s: maxKeys must be nonzero", __func__);
+    }
+
+    /**
+     * Folds an expired item into the rollup for its key.
+     *
+     * The item itself is not retained; this is called on the expiry
+     * path immediately before the raw item is erased.
+     */
+    void fold(const std::shared_ptr<const mediametrics::Item>& item) {
+        const std::string& key = item->getKey();
+        const int64_t time = item->getTimestamp();
+
+        std::lock_guard lock(mLock);
+        auto it = mRollups.find(key);
+        if (it == mRollups.end()) {
+            if (mRollups.size() >= mMaxKeys) {
+                gc_l();
+            }
+            it = mRollups.emplace(key, Rollup{}).first;
+            it->second.firstTimestamp = time;
+        }
+        Rollup& rollup = it->second;
+        ++rollup.itemCount;
+        rollup.lastTimestamp = time;
+
+        for (const auto& prop : *item) {
+            double value;
+            if (int32_t i32; prop.get(&i32)) {
+                value = i32;
+            } else if (int64_t i64; prop.get(&i64)) {
+                value = i64;
+            } else if (double d; prop.get(&d)) {
+                value = d;
+            } else {
+                ++rollup.propsNotFolded; // strings, rates, none.
+                continue;
+            }
+            auto statsIt = rollup.numeric.find(prop.getName());
+            if (statsIt == rollup.numeric.end()) {
+                if (rollup.numeric.size() >= kMaxNumericPropsPerKey) {
+                    ++rollup.propsNotFolded;
+                    continue;
+                }
+                statsIt = rollup.numeric.emplace(prop.getName(), NumericStats{}).first;
+            }
+            NumericStats& stats = statsIt->second;
+            if (stats.count == 0 || value < stats.minimum) stats.minimum = value;
+            if (stats.count == 0 || value > stats.maximum) stats.maximum = value;
+            stats.sum += value;
+            ++stats.count;
+        }
+    }
+
+    size_t size() const {
+        std::lock_guard lock(mLock);
+        return mRollups.size();
+    }
+
+    int64_t getGarbageCollectionCount() const {
+        return mGarbageCollectionCount;
+    }
+
+    /**
+     * Returns a pair consisting of the dump string and the number of lines
+     * in the string, matching the TimeMachine and TransactionLog dumps.
+     *
+     * \param lines the maximum number of lines in the string returned.
+     * \param sinceNs the nanoseconds since Unix epoch to start dump (0 shows all)
+     * \param prefix the desired key prefix to match (nullptr shows all)
+     */
+    std::pair<std::string, int32_t> dump(
+            int32_t lines = INT32_MAX, int64_t sinceNs = 0, const char *prefix = nullptr) const {
+        std::stringstream ss;
+        int32_t ll = lines;
+
+        std::lock_guard lock(mLock);
+        for (const auto& [key, rollup] : mRollups) {
+            if (ll <= 0) break;
+            if (rollup.lastTimestamp < sinceNs) continue;
+            if (prefix != nullptr && !startsWith(key, prefix)) continue;
+            ss << key << " items(" << rollup.itemCount
+               << ") first(" << rollup.firstTimestamp
+               << ") last(" << rollup.lastTimestamp
+               << ") propsNotFolded(" << rollup.propsNotFolded << ")\n";
+            --ll;
+            for (const auto& [name, stats] : rollup.numeric) {
+                if (ll <= 0) break;
+                ss << "  " << name << " count(" << stats.count
+                   << ") sum(" << stats.sum
+                   << ") min(" << stats.minimum
+                   << ") max(" << stats.maximum << ")\n";
+                --ll;
+            }
+        }
+        return { ss.str(), lines - ll };
+    }
+
+    void clear() {
+        std::lock_guard lock(mLock);
+        mRollups.clear();
+    }
+
+private:
+    struct NumericStats {
+        double sum = 0;
+        double minimum = 0;
+        double maximum = 0;
+        int64_t count = 0;
+    };
+
+    struct Rollup {
+        int64_t itemCount = 0;
+        int64_t firstTimestamp = 0;
+        int64_t lastTimestamp = 0;
+        int64_t propsNotFolded = 0;
+        std::map<std::string, NumericStats> numeric; // at most kMaxNumericPropsPerKey
+    };
+
+    // Evicts the rollup with the oldest last-folded timestamp.
+    void gc_l() REQUIRES(mLock) {
+        auto oldest = mRollups.begin();
+        for (auto it = mRollups.begin(); it != mRollups.end(); ++it) {
+            if (it->second.lastTimestamp < oldest->second.lastTimestamp) {
+                oldest = it;
+            }
+        }
+        mRollups.erase(oldest);
+        ++mGarbageCollectionCount;
+    }
+
+    const size_t mMaxKeys;
+
+    mutable std::mutex mLock;
+    std::map<std::string /* item key */, Rollup> mRollups GUARDED_BY(mLock);
+    std::atomic<int64_t> mGarbageCollectionCount{};
+};
+
+} // namespace android::mediametrics
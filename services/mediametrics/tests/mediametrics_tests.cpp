@@ -24,6 +24,8 @@
 #include <gtest/gtest.h>
 #include <media/MediaMetricsItem.h>
 #include <mediametricsservice/AudioTypes.h>
+#include <mediametricsservice/ItemIntakeRing.h>
+#include <mediametricsservice/RollupLog.h>
 #include <mediametricsservice/MediaMetricsService.h>
 #include <mediametricsservice/StringUtils.h>
 #include <mediametricsservice/ValidateId.h>
@@ -945,6 +947,59 @@ TEST(mediametrics_tests, timed_action) {
     ASSERT_EQ((size_t)1, timedAction.size());
 }
 
+TEST(mediametrics_tests, item_intake_ring) {
+    std::atomic_int consumed = 0;
+    std::atomic_int trusted = 0;
+    android::mediametrics::ItemIntakeRing ring(
+            [&](const std::shared_ptr<const mediametrics::Item>& item, bool isTrusted) {
+                ++consumed;
+                if (isTrusted) ++trusted;
+                EXPECT_EQ("audio.intake", item->getKey());
+            }, 8 /* capacity */);
+
+    for (int i = 0; i < 6; ++i) {
+        std::shared_ptr<const mediametrics::Item> item(
+                mediametrics::Item::create("audio.intake"));
+        ASSERT_TRUE(ring.push(item, i & 1 /* isTrusted */));
+    }
+    ring.flush();  // waits for the worker to consume everything pushed above.
+    ASSERT_EQ(6, consumed);
+    ASSERT_EQ(3, trusted);
+    ASSERT_EQ((int64_t)0, ring.dropped());
+}
+
+TEST(mediametrics_tests, rollup_log) {
+    android::mediametrics::RollupLog log(2 /* maxKeys */);
+
+    for (int32_t i = 1; i <= 3; ++i) {
+        auto *item = mediametrics::Item::create("audio.track.1");
+        item->setInt32("frames", i * 10).setCString("encoding", "pcm").setTimestamp(i);
+        log.fold(std::shared_ptr<const mediametrics::Item>(item));
+    }
+    ASSERT_EQ((size_t)1, log.size());
+
+    // the dump shows the folded aggregate: 3 items, frames sum 60, min 10, max 30.
+    auto [s, lines] = log.dump();
+    ASSERT_NE(s.find("items(3)"), std::string::npos);
+    ASSERT_NE(s.find("sum(60)"), std::string::npos);
+    ASSERT_NE(s.find("min(10)"), std::string::npos);
+    ASSERT_NE(s.find("max(30)"), std::string::npos);
+    // string props are counted, not retained.
+    ASSERT_NE(s.find("propsNotFolded(3)"), std::string::npos);
+    ASSERT_EQ(s.find("pcm"), std::string::npos);
+
+    // exceeding maxKeys evicts the rollup with the oldest last-folded timestamp.
+    for (int32_t i = 2; i <= 3; ++i) {
+        auto *item = mediametrics::Item::create(
+                std::string("audio.track.") + std::to_string(i));
+        item->setTimestamp(10 + i);
+        log.fold(std::shared_ptr<const mediametrics::Item>(item));
+    }
+    ASSERT_EQ((size_t)2, log.size());
+    ASSERT_EQ((int64_t)1, log.getGarbageCollectionCount());
+    ASSERT_EQ(std::get<0>(log.dump()).find("audio.track.1 "), std::string::npos);
+}
+
 // Ensure we don't introduce unexpected duplicates into our maps.
 TEST(mediametrics_tests, audio_types_tables) {
     using namespace android::mediametrics::types;
@@ -33,6 +33,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <thread>
 #include <unistd.h>
 
 #include "IMediaResourceMonitor.h"
@@ -628,84 +629,131 @@ Status ResourceManagerService::reclaimResource(int32_t callingPid,
                     callingPid, actualCallingPid);
             callingPid = actualCallingPid;
         }
-        const MediaResourceParcel *secureCodec = NULL;
-        const MediaResourceParcel *nonSecureCodec = NULL;
-        const MediaResourceParcel *graphicMemory = NULL;
-        const MediaResourceParcel *drmSession = NULL;
-        for (size_t i = 0; i < resources.size(); ++i) {
-            switch (resources[i].type) {
-                case MediaResource::Type::kSecureCodec:
-                    secureCodec = &resources[i];
-                    break;
-                case MediaResource::Type::kNonSecureCodec:
-                    nonSecureCodec = &resources[i];
-                    break;
-                case MediaResource::Type::kGraphicMemory:
-                    graphicMemory = &resources[i];
-                    break;
-                case MediaResource::Type::kDrmSession:
-                    drmSession = &resources[i];
-                    break;
-                default:
-                    break;
-            }
+        getClientsForReclaim_l(callingPid, resources, &clients);
+    }
+
+    *_aidl_return = reclaimUnconditionallyFrom(clients);
+    return Status::ok();
+}
+
+void ResourceManagerService::getClientsForReclaim_l(int callingPid,
+        const std::vector<MediaResourceParcel>& resources,
+        Vector<std::shared_ptr<IResourceManagerClient>> *clients) {
+    // Priorities may have changed since the last decision, start from a
+    // clean memoization for the candidate selection passes below.
+    mPriorityCache.clear();
+    const MediaResourceParcel *secureCodec = NULL;
+    const MediaResourceParcel *nonSecureCodec = NULL;
+    const MediaResourceParcel *graphicMemory = NULL;
+    const MediaResourceParcel *drmSession = NULL;
+    for (size_t i = 0; i < resources.size(); ++i) {
+        switch (resources[i].type) {
+            case MediaResource::Type::kSecureCodec:
+                secureCodec = &resources[i];
+                break;
+            case MediaResource::Type::kNonSecureCodec:
+                nonSecureCodec = &resources[i];
+                break;
+            case MediaResource::Type::kGraphicMemory:
+                graphicMemory = &resources[i];
+                break;
+            case MediaResource::Type::kDrmSession:
+                drmSession = &resources[i];
+                break;
+            default:
+                break;
         }
+    }
 
-        // first pass to handle secure/non-secure codec conflict
-        if (secureCodec != NULL) {
-            if (!mSupportsMultipleSecureCodecs) {
-                if (!getAllClients_l(callingPid, MediaResource::Type::kSecureCodec,
-                            secureCodec->subType, &clients)) {
-                    return Status::ok();
-                }
-            }
-            if (!mSupportsSecureWithNonSecureCodec) {
-                if (!getAllClients_l(callingPid, MediaResource::Type::kNonSecureCodec,
-                            secureCodec->subType, &clients)) {
-                    return Status::ok();
-                }
+    // first pass to handle secure/non-secure codec conflict
+    if (secureCodec != NULL) {
+        if (!mSupportsMultipleSecureCodecs) {
+            if (!getAllClients_l(callingPid, MediaResource::Type::kSecureCodec,
+                        secureCodec->subType, clients)) {
+                clients->clear();
+                return;
             }
         }
-        if (nonSecureCodec != NULL) {
-            if (!mSupportsSecureWithNonSecureCodec) {
-                if (!getAllClients_l(callingPid, MediaResource::Type::kSecureCodec,
-                        nonSecureCodec->subType, &clients)) {
-                    return Status::ok();
-                }
+        if (!mSupportsSecureWithNonSecureCodec) {
+            if (!getAllClients_l(callingPid, MediaResource::Type::kNonSecureCodec,
+                        secureCodec->subType, clients)) {
+                clients->clear();
+                return;
             }
         }
-        if (drmSession != NULL) {
-            getClientForResource_l(callingPid, drmSession, &clients);
-            if (clients.size() == 0) {
-                return Status::ok();
+    }
+    if (nonSecureCodec != NULL) {
+        if (!mSupportsSecureWithNonSecureCodec) {
+            if (!getAllClients_l(callingPid, MediaResource::Type::kSecureCodec,
+                    nonSecureCodec->subType, clients)) {
+                clients->clear();
+                return;
             }
         }
-
-        if (clients.size() == 0) {
-            // if no secure/non-secure codec conflict, run second pass to handle other resources.
-            getClientForResource_l(callingPid, graphicMemory, &clients);
+    }
+    if (drmSession != NULL) {
+        getClientForResource_l(callingPid, drmSession, clients);
+        if (clients->size() == 0) {
+            return;
         }
+    }
 
-        if (clients.size() == 0) {
-            // if we are here, run the third pass to free one codec with the same type.
-            getClientForResource_l(callingPid, secureCodec, &clients);
-            getClientForResource_l(callingPid, nonSecureCodec, &clients);
+    if (clients->size() == 0) {
+        // if no secure/non-secure codec conflict, run second pass to handle other resources.
+        getClientForResource_l(callingPid, graphicMemory, clients);
+    }
+
+    if (clients->size() == 0) {
+        // if we are here, run the third pass to free one codec with the same type.
+        getClientForResource_l(callingPid, secureCodec, clients);
+        getClientForResource_l(callingPid, nonSecureCodec, clients);
+    }
+
+    if (clients->size() == 0) {
+        // if we are here, run the fourth pass to free one codec with the different type.
+        if (secureCodec != NULL) {
+            MediaResource temp(MediaResource::Type::kNonSecureCodec, secureCodec->subType, 1);
+            getClientForResource_l(callingPid, &temp, clients);
         }
+        if (nonSecureCodec != NULL) {
+            MediaResource temp(MediaResource::Type::kSecureCodec, nonSecureCodec->subType, 1);
+            getClientForResource_l(callingPid, &temp, clients);
+        }
+    }
+}
 
-        if (clients.size() == 0) {
-            // if we are here, run the fourth pass to free one codec with the different type.
-            if (secureCodec != NULL) {
-                MediaResource temp(MediaResource::Type::kNonSecureCodec, secureCodec->subType, 1);
-                getClientForResource_l(callingPid, &temp, &clients);
-            }
-            if (nonSecureCodec != NULL) {
-                MediaResource temp(MediaResource::Type::kSecureCodec, nonSecureCodec->subType, 1);
-                getClientForResource_l(callingPid, &temp, &clients);
-            }
+Status ResourceManagerService::reserveResource(int32_t callingPid,
+        const std::vector<MediaResourceParcel>& resources, bool* _aidl_return) {
+    String8 log = String8::format("reserveResource(callingPid %d, resources %s)",
+            callingPid, getString(resources).string());
+    mServiceLog->add(log);
+    *_aidl_return = false;
+
+    Vector<std::shared_ptr<IResourceManagerClient>> clients;
+    {
+        Mutex::Autolock lock(mLock);
+        if (!mProcessInfo->isPidTrusted(callingPid)) {
+            pid_t actualCallingPid = IPCThreadState::self()->getCallingPid();
+            ALOGW("%s called with untrusted pid %d, using actual calling pid %d", __FUNCTION__,
+                    callingPid, actualCallingPid);
+            callingPid = actualCallingPid;
         }
+        getClientsForReclaim_l(callingPid, resources, &clients);
     }
 
-    *_aidl_return = reclaimUnconditionallyFrom(clients);
+    if (clients.size() == 0) {
+        return Status::ok();
+    }
+
+    // Tear the victims down on a worker thread: the caller only needs the
+    // capacity by the time its codec actually starts, so it must not block
+    // on synchronous client teardown.
+    std::shared_ptr<ResourceManagerService> service = ref<ResourceManagerService>();
+    std::thread([service, clients] {
+        service->reclaimUnconditionallyFrom(clients);
+    }).detach();
+
+    *_aidl_return = true;
     return Status::ok();
 }
 
@@ -780,6 +828,7 @@ Status ResourceManagerService::overridePid(int originalPid, int newPid) {
     {
         Mutex::Autolock lock(mLock);
         mOverridePidMap.erase(originalPid);
+        mPriorityCache.erase(originalPid);
         if (newPid != -1) {
             mOverridePidMap.emplace(originalPid, newPid);
         }
@@ -814,6 +863,7 @@ Status ResourceManagerService::overrideProcessInfo(
         // Override value is rejected by ProcessInfo.
         return Status::fromServiceSpecificError(BAD_VALUE);
     }
+    mPriorityCache.erase(pid);
 
     uintptr_t cookie = addCookieAndLink_l(client,
             new OverrideProcessInfoDeathNotifier(ref<ResourceManagerService>(), pid));
@@ -862,6 +912,7 @@ void ResourceManagerService::removeProcessInfoOverride_l(int pid) {
     }
 
     mProcessInfo->removeProcessInfoOverride(pid);
+    mPriorityCache.erase(pid);
 
     removeCookieAndUnlink_l(it->second.client, it->second.cookie);
 
@@ -951,6 +1002,12 @@ Status ResourceManagerService::reclaimResourcesFromClientsPendingRemoval(int32_t
 }
 
 bool ResourceManagerService::getPriority_l(int pid, int* priority) {
+    auto cached = mPriorityCache.find(pid);
+    if (cached != mPriorityCache.end()) {
+        *priority = cached->second;
+        return true;
+    }
+
     int newPid = pid;
 
     if (mOverridePidMap.find(pid) != mOverridePidMap.end()) {
@@ -959,7 +1016,11 @@ bool ResourceManagerService::getPriority_l(int pid, int* priority) {
                 newPid, pid);
     }
 
-    return mProcessInfo->getPriority(newPid, priority);
+    if (!mProcessInfo->getPriority(newPid, priority)) {
+        return false;
+    }
+    mPriorityCache.emplace(pid, *priority);
+    return true;
 }
 
 bool ResourceManagerService::getAllClients_l(int callingPid, MediaResource::Type type,
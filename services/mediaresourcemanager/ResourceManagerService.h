@@ -100,6 +100,12 @@ public:
     Status reclaimResource(int32_t callingPid, const std::vector<MediaResourceParcel>& resources,
             bool* _aidl_return) override;
 
+    // Same candidate selection as reclaimResource, but the selected clients are
+    // reclaimed asynchronously so the caller is not blocked on victim teardown.
+    // Returns true if an asynchronous reclaim was initiated.
+    Status reserveResource(int32_t callingPid, const std::vector<MediaResourceParcel>& resources,
+            bool* _aidl_return) override;
+
     Status overridePid(int originalPid, int newPid) override;
 
     Status overrideProcessInfo(const std::shared_ptr<IResourceManagerClient>& client, int pid,
@@ -154,6 +160,13 @@ private:
     void getClientForResource_l(int callingPid, const MediaResourceParcel *res,
             Vector<std::shared_ptr<IResourceManagerClient>> *clients);
 
+    // Selects the clients to reclaim for the requested resources according to
+    // the secure/non-secure codec policies and process priorities. Leaves
+    // |clients| empty if the request cannot be fulfilled by a reclaim.
+    void getClientsForReclaim_l(int callingPid,
+            const std::vector<MediaResourceParcel>& resources,
+            Vector<std::shared_ptr<IResourceManagerClient>> *clients);
+
     void onFirstAdded(const MediaResourceParcel& res, const ResourceInfo& clientInfo);
     void onLastRemoved(const MediaResourceParcel& res, const ResourceInfo& clientInfo);
 
@@ -185,6 +198,12 @@ private:
         std::shared_ptr<IResourceManagerClient> client;
     };
     std::map<int, int> mOverridePidMap;
+    // Memoizes process priorities for the duration of one reclaim decision, so the
+    // candidate selection passes query the process info at most once per pid while
+    // mLock is held. Priorities are dynamic (oom score moves as apps change state),
+    // so the cache is cleared before each reclaim decision and whenever a pid
+    // override changes.
+    std::map<int, int> mPriorityCache;
     std::map<pid_t, ProcessInfoOverride> mProcessInfoOverrideMap;
     static std::mutex sCookieLock;
     static uintptr_t sCookieCounter GUARDED_BY(sCookieLock);
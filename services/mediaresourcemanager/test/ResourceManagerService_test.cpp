@@ -17,6 +17,7 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "ResourceManagerService_test"
 
+#include <unistd.h>
 #include <utils/Log.h>
 
 #include "ResourceManagerServiceTestUtils.h"
@@ -679,6 +680,45 @@ public:
         }
     }
 
+    // Polls until the client has been reclaimed, since reserveResource tears
+    // victims down asynchronously.
+    static bool waitUntilReclaimed(const std::shared_ptr<IResourceManagerClient> &client) {
+        for (int i = 0; i < 100; ++i) {
+            if (toTestClient(client)->checkIfReclaimedAndReset()) {
+                return true;
+            }
+            usleep(10000);
+        }
+        return false;
+    }
+
+    void testReserveResource() {
+        bool result;
+        std::vector<MediaResourceParcel> resources;
+        resources.push_back(MediaResource(MediaResource::Type::kSecureCodec, 1));
+
+        addResource();
+        mService->mSupportsMultipleSecureCodecs = false;
+
+        // a lower priority process can't reserve a resource held by a higher
+        // priority process, and no asynchronous reclaim is started.
+        CHECK_STATUS_FALSE(mService->reserveResource(kLowPriorityPid, resources, &result));
+        EXPECT_FALSE(toTestClient(mTestClient1)->checkIfReclaimedAndReset());
+        EXPECT_FALSE(toTestClient(mTestClient3)->checkIfReclaimedAndReset());
+
+        // a higher priority process reserves the secure codec: all secure codec
+        // owners are reclaimed asynchronously.
+        CHECK_STATUS_TRUE(mService->reserveResource(kHighPriorityPid, resources, &result));
+        EXPECT_TRUE(waitUntilReclaimed(mTestClient1));
+        EXPECT_TRUE(waitUntilReclaimed(mTestClient3));
+
+        // nothing left to reserve.
+        CHECK_STATUS_FALSE(mService->reserveResource(kHighPriorityPid, resources, &result));
+
+        // clean up client 2 which is still left
+        mService->removeClient(kTestPid2, getId(mTestClient2));
+    }
+
     void testGetLowestPriorityBiggestClient() {
         MediaResource::Type type = MediaResource::Type::kGraphicMemory;
         MediaResource::SubType subType = MediaResource::SubType::kUnspecifiedSubType;
@@ -1191,6 +1231,10 @@ TEST_F(ResourceManagerServiceTest, reclaimResource) {
     testReclaimResourceNonSecure();
 }
 
+TEST_F(ResourceManagerServiceTest, reserveResource) {
+    testReserveResource();
+}
+
 TEST_F(ResourceManagerServiceTest, getAllClients_l) {
     testGetAllClients();
 }
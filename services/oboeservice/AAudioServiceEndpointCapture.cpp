@@ -84,6 +84,9 @@ void *AAudioServiceEndpointCapture::callbackLoop() {
                     streamShared->writeDataIfRoom(mmapFramesRead,
                                                   mDistributionBuffer.get(),
                                                   getFramesPerBurst());
+                    // Deliver periodic timestamps from this single per-burst wakeup
+                    // instead of waking each stream's command thread for them.
+                    streamShared->sendTimestampsIfDue();
                 }
             }
         }
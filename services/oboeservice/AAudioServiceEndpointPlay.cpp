@@ -138,6 +138,12 @@ void *AAudioServiceEndpointPlay::callbackLoop() {
                     streamShared->markTransferTime(timestamp);
                 }
 
+                if (state == AAUDIO_STREAM_STATE_STARTED) {
+                    // Deliver periodic timestamps from this single per-burst wakeup
+                    // instead of waking each stream's command thread for them.
+                    streamShared->sendTimestampsIfDue();
+                }
+
                 index++; // just used for labelling tracks in systrace
             }
         }
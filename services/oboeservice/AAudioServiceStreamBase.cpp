@@ -414,7 +414,10 @@ void AAudioServiceStreamBase::run() {
     while (mThreadEnabled.load()) {
         loopCount++;
         int64_t timeoutNanos = -1;
-        if (isRunning() || (isIdle_l() && !isStandby_l())) {
+        // When the endpoint thread delivers the timestamps there is no need to
+        // wake up periodically while running, just to handle commands.
+        if ((isRunning() && !isTimestampDrivenByEndpoint())
+                || (isIdle_l() && !isStandby_l())) {
             timeoutNanos = (isRunning() ? nextTime : standbyTime) - AudioClock::getNanoseconds();
             timeoutNanos = std::max<int64_t>(0, timeoutNanos);
         }
@@ -425,7 +428,8 @@ void AAudioServiceStreamBase::run() {
             break;
         }
 
-        if (isRunning() && AudioClock::getNanoseconds() >= nextTime) {
+        if (isRunning() && !isTimestampDrivenByEndpoint()
+                && AudioClock::getNanoseconds() >= nextTime) {
             // It is time to update timestamp.
             if (sendCurrentTimestamp_l() != AAUDIO_OK) {
                 ALOGE("Failed to send current timestamp, stop updating timestamp");
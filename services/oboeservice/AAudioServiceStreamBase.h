@@ -295,6 +295,12 @@ protected:
 
     aaudio_result_t sendCurrentTimestamp_l() REQUIRES(mLock);
 
+    /**
+     * @return true if the endpoint thread delivers periodic timestamps for this
+     *         stream, so the command thread does not need to wake up to send them.
+     */
+    virtual bool isTimestampDrivenByEndpoint() const { return false; }
+
     aaudio_result_t sendXRunCount(int32_t xRunCount);
 
     /**
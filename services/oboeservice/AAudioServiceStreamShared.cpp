@@ -230,6 +230,34 @@ void AAudioServiceStreamShared::markTransferTime(Timestamp &timestamp) {
     mAtomicStreamTimestamp.write(timestamp);
 }
 
+aaudio_result_t AAudioServiceStreamShared::startDevice() {
+    // Tell the endpoint thread to restart the timestamp schedule. The mixer
+    // only processes this stream after setState(STARTED), which happens after
+    // startDevice() returns, so the scheduler itself stays owned by the
+    // endpoint thread.
+    mRestartTimestampSchedule.store(true);
+    return AAudioServiceStreamBase::startDevice();
+}
+
+// Runs on the endpoint thread once per burst for every started stream.
+// NO_THREAD_SAFETY_ANALYSIS because sendCurrentTimestamp_l() is annotated for
+// the command thread, which holds mLock for its entire life and can never hand
+// it to us. Calling it here without the lock is safe because this class's
+// position getters only read atomics.
+void AAudioServiceStreamShared::sendTimestampsIfDue() NO_THREAD_SAFETY_ANALYSIS {
+    const int64_t nowNanos = AudioClock::getNanoseconds();
+    if (mRestartTimestampSchedule.exchange(false)) {
+        mTimestampScheduler.setBurstPeriod(getFramesPerBurst(), getSampleRate());
+        mTimestampScheduler.start(nowNanos);
+        mNextTimestampTime = mTimestampScheduler.nextAbsoluteTime();
+    }
+    if (nowNanos < mNextTimestampTime) {
+        return;
+    }
+    sendCurrentTimestamp_l();
+    mNextTimestampTime = mTimestampScheduler.nextAbsoluteTime();
+}
+
 // Get timestamp that was written by mixer or distributor.
 aaudio_result_t AAudioServiceStreamShared::getFreeRunningPosition_l(int64_t *positionFrames,
                                                                     int64_t *timeNanos) {
@@ -76,6 +76,17 @@ public:
         sendXRunCount(++mXRunCount);
     }
 
+    /**
+     * Send periodic timestamps to the client if the schedule says one is due.
+     *
+     * This is called by the endpoint thread, which already wakes once per burst
+     * to service the FIFOs of every client stream. Delivering the timestamps
+     * from that single wakeup means each stream's command thread can sleep
+     * until a command actually arrives, instead of every stream waking up on
+     * its own timestamp schedule.
+     */
+    void sendTimestampsIfDue();
+
     int32_t getXRunCount() const {
         return mXRunCount.load();
     }
@@ -88,6 +99,10 @@ public:
 
 protected:
 
+    aaudio_result_t startDevice() override;
+
+    bool isTimestampDrivenByEndpoint() const override { return true; }
+
     aaudio_result_t getAudioDataDescription_l(
             AudioEndpointParcelable* parcelable) REQUIRES(mLock) override;
 
@@ -112,6 +127,13 @@ private:
     std::atomic<int64_t>     mTimestampPositionOffset;
     std::atomic<int32_t>     mXRunCount;
 
+    // Set on the start path and consumed by the endpoint thread so the
+    // timestamp schedule restarts each time the stream is started.
+    std::atomic<bool>        mRestartTimestampSchedule{true};
+    // Only accessed by the endpoint thread.
+    TimestampScheduler       mTimestampScheduler;
+    int64_t                  mNextTimestampTime = 0;
+
 };
 
 } /* namespace aaudio */
@@ -30,9 +30,13 @@
 namespace aaudio {
 
 // Determine the placement of the counters and data in shared memory.
+// The two counters are written by opposite ends of the stream, and the first
+// data bytes by the writer, so give each its own cache line. Packing them
+// together causes the line to ping-pong between the client and service cores.
+#define SHARED_RINGBUFFER_CACHE_LINE_SIZE  64
 #define SHARED_RINGBUFFER_READ_OFFSET   0
-#define SHARED_RINGBUFFER_WRITE_OFFSET  sizeof(fifo_counter_t)
-#define SHARED_RINGBUFFER_DATA_OFFSET   (SHARED_RINGBUFFER_WRITE_OFFSET + sizeof(fifo_counter_t))
+#define SHARED_RINGBUFFER_WRITE_OFFSET  SHARED_RINGBUFFER_CACHE_LINE_SIZE
+#define SHARED_RINGBUFFER_DATA_OFFSET   (2 * SHARED_RINGBUFFER_CACHE_LINE_SIZE)
 
 /**
  * Atomic FIFO that uses shared memory.
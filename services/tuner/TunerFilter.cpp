@@ -434,6 +434,17 @@ shared_ptr<IFilter> TunerFilter::getHalFilter() {
 }
 
 /////////////// FilterCallback ///////////////////////
+TunerFilter::FilterCallback::~FilterCallback() {
+    {
+        Mutex::Autolock _l(mCallbackLock);
+        mEventThreadExit = true;
+        mEventCondition.signal();
+    }
+    if (mEventThread.joinable()) {
+        mEventThread.join();
+    }
+}
+
 ::ndk::ScopedAStatus TunerFilter::FilterCallback::onFilterStatus(DemuxFilterStatus status) {
     Mutex::Autolock _l(mCallbackLock);
     if (mTunerFilterCallback != nullptr) {
@@ -444,13 +455,39 @@ shared_ptr<IFilter> TunerFilter::getHalFilter() {
 
 ::ndk::ScopedAStatus TunerFilter::FilterCallback::onFilterEvent(
         const vector<DemuxFilterEvent>& events) {
+    // Only queue the events here so the demux callback thread never blocks on
+    // the client transaction; mEventThread forwards them in batches.
     Mutex::Autolock _l(mCallbackLock);
     if (mTunerFilterCallback != nullptr) {
-        mTunerFilterCallback->onFilterEvent(events);
+        mPendingEvents.insert(mPendingEvents.end(), events.begin(), events.end());
+        mEventCondition.signal();
     }
     return ::ndk::ScopedAStatus::ok();
 }
 
+void TunerFilter::FilterCallback::eventThreadLoop() {
+    while (true) {
+        vector<DemuxFilterEvent> events;
+        shared_ptr<ITunerFilterCallback> callback;
+        {
+            Mutex::Autolock _l(mCallbackLock);
+            while (!mEventThreadExit && mPendingEvents.empty()) {
+                mEventCondition.wait(mCallbackLock);
+            }
+            if (mEventThreadExit) {
+                return;
+            }
+            events.swap(mPendingEvents);
+            callback = mTunerFilterCallback;
+        }
+        // Deliver outside the lock: events arriving while the client handles
+        // this transaction accumulate into the next batch.
+        if (callback != nullptr) {
+            callback->onFilterEvent(events);
+        }
+    }
+}
+
 void TunerFilter::FilterCallback::sendSharedFilterStatus(int32_t status) {
     Mutex::Autolock _l(mCallbackLock);
     if (mTunerFilterCallback != nullptr && mOriginalCallback != nullptr) {
@@ -477,6 +514,7 @@ void TunerFilter::FilterCallback::detachCallbacks() {
     Mutex::Autolock _l(mCallbackLock);
     mOriginalCallback = nullptr;
     mTunerFilterCallback = nullptr;
+    mPendingEvents.clear();
 }
 
 }  // namespace tuner
@@ -27,8 +27,11 @@
 #include <aidl/android/hardware/tv/tuner/IFilter.h>
 #include <aidl/android/media/tv/tuner/BnTunerFilter.h>
 #include <aidl/android/media/tv/tuner/ITunerFilterCallback.h>
+#include <utils/Condition.h>
 #include <utils/Mutex.h>
 
+#include <thread>
+
 using ::aidl::android::hardware::common::NativeHandle;
 using ::aidl::android::hardware::common::fmq::MQDescriptor;
 using ::aidl::android::hardware::common::fmq::SynchronizedReadWrite;
@@ -41,6 +44,7 @@ using ::aidl::android::hardware::tv::tuner::DemuxFilterType;
 using ::aidl::android::hardware::tv::tuner::FilterDelayHint;
 using ::aidl::android::hardware::tv::tuner::IFilter;
 using ::aidl::android::media::tv::tuner::BnTunerFilter;
+using ::android::Condition;
 using ::android::Mutex;
 
 using namespace std;
@@ -59,7 +63,10 @@ public:
     class FilterCallback : public BnFilterCallback {
     public:
         FilterCallback(const shared_ptr<ITunerFilterCallback>& tunerFilterCallback)
-              : mTunerFilterCallback(tunerFilterCallback), mOriginalCallback(nullptr){};
+              : mTunerFilterCallback(tunerFilterCallback), mOriginalCallback(nullptr) {
+            mEventThread = std::thread(&FilterCallback::eventThreadLoop, this);
+        }
+        ~FilterCallback();
 
         ::ndk::ScopedAStatus onFilterEvent(const vector<DemuxFilterEvent>& events) override;
         ::ndk::ScopedAStatus onFilterStatus(DemuxFilterStatus status) override;
@@ -70,9 +77,19 @@ public:
         void detachCallbacks();
 
     private:
+        void eventThreadLoop();
+
         shared_ptr<ITunerFilterCallback> mTunerFilterCallback;
         shared_ptr<ITunerFilterCallback> mOriginalCallback;
         Mutex mCallbackLock;
+        // Events from the HAL are queued here and forwarded to the client in
+        // batches by mEventThread: while one onFilterEvent transaction is in
+        // flight, a burst of demux callbacks accumulates into the next batch
+        // instead of costing one binder call each.
+        vector<DemuxFilterEvent> mPendingEvents;
+        Condition mEventCondition;
+        std::thread mEventThread;
+        bool mEventThreadExit = false;
     };
 
     TunerFilter(shared_ptr<IFilter> filter, shared_ptr<FilterCallback> cb, DemuxFilterType type);